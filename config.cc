@@ -420,7 +420,24 @@ void bx_init_options()
       "Maximum amount of instructions allowed to execute before returning control to another CPU.",
       BX_SMP_QUANTUM_MIN, BX_SMP_QUANTUM_MAX,
       16);
+  static const char *smp_sched_names[] = { "adaptive", "strict", NULL };
+  new bx_param_enum_c(cpu_param,
+      "smp_sched", "SMP scheduling",
+      "Adaptive time slices per CPU or strict switching after every trace.",
+      smp_sched_names,
+      BX_SMP_SCHED_ADAPTIVE,
+      BX_SMP_SCHED_ADAPTIVE);
+  new bx_param_num_c(cpu_param,
+      "timeslice", "Time slice in SMP simulation",
+      "Maximum amount of instructions a CPU executes in one adaptive time slice.",
+      BX_SMP_QUANTUM_MIN, BX_SMP_TIMESLICE_MAX,
+      1000);
 #endif
+  new bx_param_num_c(cpu_param,
+      "icache_size", "Trace cache size (K entries)",
+      "Number of trace cache entries per CPU in units of 1024 (rounded down to power of 2).",
+      16, 1024,
+      64);
   new bx_param_bool_c(cpu_param,
       "reset_on_triple_fault", "Enable CPU reset on triple fault",
       "Enable CPU reset if triple fault occured (highly recommended)",
@@ -696,6 +713,11 @@ void bx_init_options()
       1, 2048,
       BX_DEFAULT_MEM_MEGS);
   host_ramsize->set_ask_format("Enter host memory size (MB): [%d] ");
+  new bx_param_bool_c(ram,
+      "restore_map",
+      "Map RAM image on restore",
+      "Map the saved RAM image copy-on-write instead of reading it on restore",
+      0);
   ram->set_options(ram->SERIES_ASK);
 
   path = new bx_param_filename_c(rom,
@@ -2638,6 +2660,8 @@ static int parse_line_formatted(const char *context, int num_params, char *param
         SIM->get_param_num(BXPN_HOST_MEM_SIZE)->set(atol(&params[i][5]));
       } else if (!strncmp(params[i], "guest=", 6)) {
         SIM->get_param_num(BXPN_MEM_SIZE)->set(atol(&params[i][6]));
+      } else if (!strncmp(params[i], "restore_map=", 12)) {
+        SIM->get_param_bool(BXPN_MEM_RESTORE_MAP)->set(atol(&params[i][12]));
       } else {
         PARSE_ERR(("%s: memory directive malformed.", context));
       }
@@ -3316,8 +3340,12 @@ int bx_write_configuration(const char *rc, int overwrite)
     fprintf(fp, ", options=\"%s\"\n", sparam->getptr());
   else
     fprintf(fp, "\n");
-  fprintf(fp, "memory: host=%d, guest=%d\n", SIM->get_param_num(BXPN_HOST_MEM_SIZE)->get(),
+  fprintf(fp, "memory: host=%d, guest=%d", SIM->get_param_num(BXPN_HOST_MEM_SIZE)->get(),
     SIM->get_param_num(BXPN_MEM_SIZE)->get());
+  if (SIM->get_param_bool(BXPN_MEM_RESTORE_MAP)->get())
+    fprintf(fp, ", restore_map=1\n");
+  else
+    fprintf(fp, "\n");
 
   bx_write_param_list(fp, (bx_list_c*) SIM->get_param(BXPN_ROMIMAGE), "romimage", 0);
   bx_write_param_list(fp, (bx_list_c*) SIM->get_param(BXPN_VGA_ROMIMAGE), "vgaromimage", 0);
@@ -3373,15 +3401,18 @@ int bx_write_configuration(const char *rc, int overwrite)
     SIM->get_param_num(BXPN_VGA_UPDATE_FREQUENCY)->get(),
     SIM->get_param_bool(BXPN_VGA_REALTIME)->get());
 #if BX_SUPPORT_SMP
-  fprintf(fp, "cpu: count=%u:%u:%u, ips=%u, quantum=%d, ",
+  fprintf(fp, "cpu: count=%u:%u:%u, ips=%u, quantum=%d, smp_sched=%s, timeslice=%u, ",
     SIM->get_param_num(BXPN_CPU_NPROCESSORS)->get(), SIM->get_param_num(BXPN_CPU_NCORES)->get(),
     SIM->get_param_num(BXPN_CPU_NTHREADS)->get(), SIM->get_param_num(BXPN_IPS)->get(),
-    SIM->get_param_num(BXPN_SMP_QUANTUM)->get());
+    SIM->get_param_num(BXPN_SMP_QUANTUM)->get(),
+    SIM->get_param_enum(BXPN_SMP_SCHED)->get_selected(),
+    SIM->get_param_num(BXPN_SMP_TIMESLICE)->get());
 #else
   fprintf(fp, "cpu: count=1, ips=%u, ", SIM->get_param_num(BXPN_IPS)->get());
 #endif
-  fprintf(fp, "model=%s, reset_on_triple_fault=%d, cpuid_limit_winnt=%d",
+  fprintf(fp, "model=%s, icache_size=%u, reset_on_triple_fault=%d, cpuid_limit_winnt=%d",
     SIM->get_param_enum(BXPN_CPU_MODEL)->get_selected(),
+    SIM->get_param_num(BXPN_ICACHE_SIZE)->get(),
     SIM->get_param_bool(BXPN_RESET_ON_TRIPLE_FAULT)->get(),
     SIM->get_param_bool(BXPN_CPUID_LIMIT_WINNT)->get());
 #if BX_CPU_LEVEL >= 5
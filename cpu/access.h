@@ -427,4 +427,46 @@ BX_CPU_C::read_RMW_virtual_qword(unsigned s, bx_address offset)
   return read_RMW_linear_qword(s, laddr);
 }
 
+#if BX_SUPPORT_AVX
+
+// Lookup the TLB entry for an access of 'len' bytes which does not cross a
+// page boundary. Returns NULL if the access misses the TLB, crosses the page,
+// is misaligned while alignment checking is on or is not allowed from this
+// CPL; the caller has to take the regular read_linear/write_linear path then,
+// which also raises the page fault or #AC.
+// Caller is responsible for the memory access notification and, for writes,
+// for the SMC write stamp update.
+
+  BX_CPP_INLINE bx_TLB_entry* BX_CPP_AttrRegparmN(2)
+BX_CPU_C::v2h_read_tlb_entry(bx_address laddr, unsigned len)
+{
+  bx_TLB_entry *tlbEntry = BX_TLB_ENTRY_OF(laddr, len-1);
+#if BX_SUPPORT_ALIGNMENT_CHECK && BX_CPU_LEVEL >= 4
+  bx_address lpf = AlignedAccessLPFOf(laddr, (len-1) & BX_CPU_THIS_PTR alignment_check_mask);
+#else
+  bx_address lpf = LPFOf(laddr);
+#endif
+  if (tlbEntry->lpf == lpf && isReadOK(tlbEntry, BX_CPU_THIS_PTR user_pl))
+    return tlbEntry;
+
+  return 0;
+}
+
+  BX_CPP_INLINE bx_TLB_entry* BX_CPP_AttrRegparmN(2)
+BX_CPU_C::v2h_write_tlb_entry(bx_address laddr, unsigned len)
+{
+  bx_TLB_entry *tlbEntry = BX_TLB_ENTRY_OF(laddr, len-1);
+#if BX_SUPPORT_ALIGNMENT_CHECK && BX_CPU_LEVEL >= 4
+  bx_address lpf = AlignedAccessLPFOf(laddr, (len-1) & BX_CPU_THIS_PTR alignment_check_mask);
+#else
+  bx_address lpf = LPFOf(laddr);
+#endif
+  if (tlbEntry->lpf == lpf && isWriteOK(tlbEntry, BX_CPU_THIS_PTR user_pl))
+    return tlbEntry;
+
+  return 0;
+}
+
+#endif // BX_SUPPORT_AVX
+
 #endif
@@ -289,12 +289,117 @@ BX_CPP_INLINE Bit32u AES_RotWord(Bit32u x)
   return (x >> 8) | (x << 24);
 }
 
+#if BX_HOST_CRYPTO
+BX_HOST_TARGET("aes") static void AES_HostEncryptRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+  xmm_host_store(&state, _mm_aesenc_si128(xmm_host_load(&state), xmm_host_load(&round_key)));
+}
+
+BX_HOST_TARGET("aes") static void AES_HostEncryptLastRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+  xmm_host_store(&state, _mm_aesenclast_si128(xmm_host_load(&state), xmm_host_load(&round_key)));
+}
+
+BX_HOST_TARGET("aes") static void AES_HostDecryptRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+  xmm_host_store(&state, _mm_aesdec_si128(xmm_host_load(&state), xmm_host_load(&round_key)));
+}
+
+BX_HOST_TARGET("aes") static void AES_HostDecryptLastRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+  xmm_host_store(&state, _mm_aesdeclast_si128(xmm_host_load(&state), xmm_host_load(&round_key)));
+}
+
+BX_HOST_TARGET("aes") static void AES_HostInverseMixColumns(BxPackedXmmRegister &state)
+{
+  xmm_host_store(&state, _mm_aesimc_si128(xmm_host_load(&state)));
+}
+
+BX_HOST_TARGET("pclmul") static void xmm_host_pclmulqdq(BxPackedXmmRegister *r, Bit64u a, Bit64u b)
+{
+  __m128i op1 = _mm_set_epi64x(0, (Bit64s) a), op2 = _mm_set_epi64x(0, (Bit64s) b);
+  xmm_host_store(r, _mm_clmulepi64_si128(op1, op2, 0x00));
+}
+#endif
+
+//
+// Complete AES rounds: the host AES-NI instructions are used when the host
+// supports them, otherwise the round is built from the transformations above
+//
+
+static void AES_EncryptRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_AES) {
+    AES_HostEncryptRound(state, round_key);
+    return;
+  }
+#endif
+
+  AES_ShiftRows(state);
+  AES_SubstituteBytes(state);
+  AES_MixColumns(state);
+
+  xmm_xorps(&state, &round_key);
+}
+
+static void AES_EncryptLastRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_AES) {
+    AES_HostEncryptLastRound(state, round_key);
+    return;
+  }
+#endif
+
+  AES_ShiftRows(state);
+  AES_SubstituteBytes(state);
+
+  xmm_xorps(&state, &round_key);
+}
+
+static void AES_DecryptRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_AES) {
+    AES_HostDecryptRound(state, round_key);
+    return;
+  }
+#endif
+
+  AES_InverseShiftRows(state);
+  AES_InverseSubstituteBytes(state);
+  AES_InverseMixColumns(state);
+
+  xmm_xorps(&state, &round_key);
+}
+
+static void AES_DecryptLastRound(BxPackedXmmRegister &state, const BxPackedXmmRegister &round_key)
+{
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_AES) {
+    AES_HostDecryptLastRound(state, round_key);
+    return;
+  }
+#endif
+
+  AES_InverseShiftRows(state);
+  AES_InverseSubstituteBytes(state);
+
+  xmm_xorps(&state, &round_key);
+}
+
 /* 66 0F 38 DB */
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AESIMC_VdqWdqR(bxInstruction_c *i)
 {
   BxPackedXmmRegister op = BX_READ_XMM_REG(i->src());
 
-  AES_InverseMixColumns(op);
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_AES)
+    AES_HostInverseMixColumns(op);
+  else
+#endif
+    AES_InverseMixColumns(op);
 
   BX_WRITE_XMM_REGZ(i->dst(), op, i->getVL());
 
@@ -306,11 +411,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AESENC_VdqWdqR(bxInstruction_c *i)
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  AES_ShiftRows(op1);
-  AES_SubstituteBytes(op1);
-  AES_MixColumns(op1);
-
-  xmm_xorps(&op1, &op2);
+  AES_EncryptRound(op1, op2);
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -324,11 +425,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::VAESENC_VdqHdqWdqR(bxInstruction_c
   unsigned len = i->getVL();
 
   for (unsigned n=0; n < len; n++) {
-    AES_ShiftRows(op1.vmm128(n));
-    AES_SubstituteBytes(op1.vmm128(n));
-    AES_MixColumns(op1.vmm128(n));
-
-    xmm_xorps(&op1.vmm128(n), &op2.vmm128(n));
+    AES_EncryptRound(op1.vmm128(n), op2.vmm128(n));
   }
 
   BX_WRITE_AVX_REGZ(i->dst(), op1, len);
@@ -342,10 +439,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AESENCLAST_VdqWdqR(bxInstruction_c
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  AES_ShiftRows(op1);
-  AES_SubstituteBytes(op1);
-
-  xmm_xorps(&op1, &op2);
+  AES_EncryptLastRound(op1, op2);
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -359,10 +453,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::VAESENCLAST_VdqHdqWdqR(bxInstructi
   unsigned len = i->getVL();
 
   for (unsigned n=0; n < len; n++) {
-    AES_ShiftRows(op1.vmm128(n));
-    AES_SubstituteBytes(op1.vmm128(n));
-
-    xmm_xorps(&op1.vmm128(n), &op2.vmm128(n));
+    AES_EncryptLastRound(op1.vmm128(n), op2.vmm128(n));
   }
 
   BX_WRITE_AVX_REGZ(i->dst(), op1, len);
@@ -376,11 +467,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AESDEC_VdqWdqR(bxInstruction_c *i)
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  AES_InverseShiftRows(op1);
-  AES_InverseSubstituteBytes(op1);
-  AES_InverseMixColumns(op1);
-
-  xmm_xorps(&op1, &op2);
+  AES_DecryptRound(op1, op2);
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -394,11 +481,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::VAESDEC_VdqHdqWdqR(bxInstruction_c
   unsigned len = i->getVL();
 
   for (unsigned n=0; n < len; n++) {
-    AES_InverseShiftRows(op1.vmm128(n));
-    AES_InverseSubstituteBytes(op1.vmm128(n));
-    AES_InverseMixColumns(op1.vmm128(n));
-
-    xmm_xorps(&op1.vmm128(n), &op2.vmm128(n));
+    AES_DecryptRound(op1.vmm128(n), op2.vmm128(n));
   }
 
   BX_WRITE_AVX_REGZ(i->dst(), op1, len);
@@ -412,10 +495,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AESDECLAST_VdqWdqR(bxInstruction_c
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  AES_InverseShiftRows(op1);
-  AES_InverseSubstituteBytes(op1);
-
-  xmm_xorps(&op1, &op2);
+  AES_DecryptLastRound(op1, op2);
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -429,10 +509,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::VAESDECLAST_VdqHdqWdqR(bxInstructi
   unsigned len = i->getVL();
 
   for (unsigned n=0; n < len; n++) {
-    AES_InverseShiftRows(op1.vmm128(n));
-    AES_InverseSubstituteBytes(op1.vmm128(n));
-
-    xmm_xorps(&op1.vmm128(n), &op2.vmm128(n));
+    AES_DecryptLastRound(op1.vmm128(n), op2.vmm128(n));
   }
 
   BX_WRITE_AVX_REGZ(i->dst(), op1, len);
@@ -460,6 +537,13 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AESKEYGENASSIST_VdqWdqIbR(bxInstru
 
 BX_CPP_INLINE void xmm_pclmulqdq(BxPackedXmmRegister *r, Bit64u a, Bit64u b)
 {
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_PCLMUL) {
+    xmm_host_pclmulqdq(r, a, b);
+    return;
+  }
+#endif
+
   BxPackedXmmRegister tmp;
 
   tmp.xmm64u(0) = a;
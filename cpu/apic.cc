@@ -670,6 +670,9 @@ void bx_local_apic_c::send_ipi(apic_dest_t dest, Bit32u lo_cmd)
   int vector = (lo_cmd & 0xff);
   int accepted = 0;
 
+  // let the target processors run before the sender continues
+  bx_pc_system.request_cpu_yield();
+
   if(delivery_mode == APIC_DM_INIT)
   {
     if(level == 0 && trig_mode == 1) {
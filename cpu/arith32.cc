@@ -600,3 +600,75 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPXCHG8B(bxInstruction_c *i)
 
   BX_NEXT_INSTR(i);
 }
+
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Versions of the register form handlers selected by the trace builder when
+// the next instruction in the trace overwrites all arithmetic flags
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::ADD_GdEdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32, sum_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  op2_32 = BX_READ_32BIT_REG(i->src());
+  sum_32 = op1_32 + op2_32;
+
+  BX_WRITE_32BIT_REGZ(i->dst(), sum_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_ADD_32(op1_32, op2_32, sum_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::ADD_EdIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32, sum_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  op2_32 = i->Id();
+  sum_32 = op1_32 + op2_32;
+
+  BX_WRITE_32BIT_REGZ(i->dst(), sum_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_ADD_32(op1_32, op2_32, sum_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SUB_GdEdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32, diff_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  op2_32 = BX_READ_32BIT_REG(i->src());
+  diff_32 = op1_32 - op2_32;
+  BX_WRITE_32BIT_REGZ(i->dst(), diff_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_SUB_32(op1_32, op2_32, diff_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SUB_EdIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32 = i->Id(), diff_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  diff_32 = op1_32 - op2_32;
+  BX_WRITE_32BIT_REGZ(i->dst(), diff_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_SUB_32(op1_32, op2_32, diff_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::INC_EdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u erx = ++BX_READ_32BIT_REG(i->dst());
+  BX_CLEAR_64BIT_HIGH(i->dst());
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAP_ADD_32(erx - 1, 0, erx));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::DEC_EdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u erx = --BX_READ_32BIT_REG(i->dst());
+  BX_CLEAR_64BIT_HIGH(i->dst());
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAP_SUB_32(erx + 1, 0, erx));
+}
+
+#endif
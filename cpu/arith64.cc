@@ -619,4 +619,74 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPXCHG16B(bxInstruction_c *i)
   BX_NEXT_INSTR(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Versions of the register form handlers selected by the trace builder when
+// the next instruction in the trace overwrites all arithmetic flags
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::ADD_GqEqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64, sum_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = BX_READ_64BIT_REG(i->src());
+  sum_64 = op1_64 + op2_64;
+  BX_WRITE_64BIT_REG(i->dst(), sum_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_ADD_64(op1_64, op2_64, sum_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::ADD_EqIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64, sum_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = (Bit32s) i->Id();
+  sum_64 = op1_64 + op2_64;
+  BX_WRITE_64BIT_REG(i->dst(), sum_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_ADD_64(op1_64, op2_64, sum_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SUB_GqEqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64, diff_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = BX_READ_64BIT_REG(i->src());
+  diff_64 = op1_64 - op2_64;
+
+  BX_WRITE_64BIT_REG(i->dst(), diff_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_SUB_64(op1_64, op2_64, diff_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SUB_EqIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64, diff_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = (Bit32s) i->Id();
+  diff_64 = op1_64 - op2_64;
+  BX_WRITE_64BIT_REG(i->dst(), diff_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_SUB_64(op1_64, op2_64, diff_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::INC_EqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u rrx = ++BX_READ_64BIT_REG(i->dst());
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAP_ADD_64(rrx - 1, 0, rrx));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::DEC_EqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u rrx = --BX_READ_64BIT_REG(i->dst());
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAP_SUB_64(rrx + 1, 0, rrx));
+}
+
+#endif
+
 #endif /* if BX_SUPPORT_X86_64 */
@@ -27,10 +27,54 @@
 #define LOG_THIS BX_CPU_THIS_PTR
 
 #if BX_SUPPORT_AVX
+
+// Masked vector loads and stores are done directly on the host page when
+// the whole vector lies within one page mapped by the TLB with the required
+// access rights and no segment limit check is needed. None of the elements
+// can fault in this case, otherwise the element by element path is taken.
+BX_CPP_INLINE bx_TLB_entry* BX_CPU_C::avx_masked_tlb_entry(bxInstruction_c *i, bx_address eaddr, unsigned rw, bx_address *laddr)
+{
+  unsigned vlen = i->getVL() * 16;
+
+#if BX_SUPPORT_X86_64
+  if (BX_CPU_THIS_PTR cpu_mode == BX_MODE_LONG_64) {
+    *laddr = get_laddr64(i->seg(), eaddr);
+  }
+  else
+#endif
+  {
+    if (! (BX_CPU_THIS_PTR sregs[i->seg()].cache.valid & ((rw == BX_READ) ? SegAccessROK4G : SegAccessWOK4G)))
+      return 0;
+
+    *laddr = (Bit32u) eaddr;
+  }
+
+  if (rw == BX_READ)
+    return v2h_read_tlb_entry(*laddr, vlen);
+  else
+    return v2h_write_tlb_entry(*laddr, vlen);
+}
+
 void BX_CPU_C::avx_masked_load8(bxInstruction_c *i, bx_address eaddr, BxPackedAvxRegister *op, Bit64u mask)
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_READ, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    for (int n=BYTE_ELEMENTS(len)-1; n >= 0; n--) {
+      if (mask & (BX_CONST64(1)<<n)) {
+        op->vmmubyte(n) = hostAddr[n];
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + n, (tlbEntry->ppf | pageOffset) + n, 1, tlbEntry->get_memtype(), BX_READ, (Bit8u*) &op->vmmubyte(n));
+      }
+      else
+        op->vmmubyte(n) = 0;
+    }
+    return;
+  }
+
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
     for (unsigned n=0; n < BYTE_ELEMENTS(len); n++) {
@@ -53,6 +97,22 @@ void BX_CPU_C::avx_masked_load16(bxInstruction_c *i, bx_address eaddr, BxPackedA
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_READ, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    for (int n=WORD_ELEMENTS(len)-1; n >= 0; n--) {
+      if (mask & (1<<n)) {
+        ReadHostWordFromLittleEndian((Bit16u*) (hostAddr + 2*n), op->vmm16u(n));
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + 2*n, (tlbEntry->ppf | pageOffset) + 2*n, 2, tlbEntry->get_memtype(), BX_READ, (Bit8u*) &op->vmm16u(n));
+      }
+      else
+        op->vmm16u(n) = 0;
+    }
+    return;
+  }
+
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
     for (unsigned n=0; n < WORD_ELEMENTS(len); n++) {
@@ -84,6 +144,22 @@ void BX_CPU_C::avx_masked_load32(bxInstruction_c *i, bx_address eaddr, BxPackedA
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_READ, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    for (int n=DWORD_ELEMENTS(len)-1; n >= 0; n--) {
+      if (mask & (1<<n)) {
+        ReadHostDWordFromLittleEndian((Bit32u*) (hostAddr + 4*n), op->vmm32u(n));
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + 4*n, (tlbEntry->ppf | pageOffset) + 4*n, 4, tlbEntry->get_memtype(), BX_READ, (Bit8u*) &op->vmm32u(n));
+      }
+      else
+        op->vmm32u(n) = 0;
+    }
+    return;
+  }
+
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
     for (unsigned n=0; n < DWORD_ELEMENTS(len); n++) {
@@ -115,6 +191,22 @@ void BX_CPU_C::avx_masked_load64(bxInstruction_c *i, bx_address eaddr, BxPackedA
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_READ, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    for (int n=QWORD_ELEMENTS(len)-1; n >= 0; n--) {
+      if (mask & (1<<n)) {
+        ReadHostQWordFromLittleEndian((Bit64u*) (hostAddr + 8*n), op->vmm64u(n));
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + 8*n, (tlbEntry->ppf | pageOffset) + 8*n, 8, tlbEntry->get_memtype(), BX_READ, (Bit8u*) &op->vmm64u(n));
+      }
+      else
+        op->vmm64u(n) = 0;
+    }
+    return;
+  }
+
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
     for (unsigned n=0; n < QWORD_ELEMENTS(len); n++) {
@@ -146,6 +238,22 @@ void BX_CPU_C::avx_masked_store8(bxInstruction_c *i, bx_address eaddr, const BxP
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_WRITE, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    bx_phy_address pAddr = tlbEntry->ppf | pageOffset;
+    for (unsigned n=0; n < BYTE_ELEMENTS(len); n++) {
+      if (mask & (BX_CONST64(1)<<n)) {
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + n, pAddr + n, 1, tlbEntry->get_memtype(), BX_WRITE, (Bit8u*) &op->vmmubyte(n));
+        pageWriteStampTable.decWriteStamp(pAddr + n, 1);
+        hostAddr[n] = op->vmmubyte(n);
+      }
+    }
+    return;
+  }
+
 #if BX_SUPPORT_X86_64
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
@@ -174,6 +282,22 @@ void BX_CPU_C::avx_masked_store16(bxInstruction_c *i, bx_address eaddr, const Bx
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_WRITE, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    bx_phy_address pAddr = tlbEntry->ppf | pageOffset;
+    for (unsigned n=0; n < WORD_ELEMENTS(len); n++) {
+      if (mask & (1<<n)) {
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + 2*n, pAddr + 2*n, 2, tlbEntry->get_memtype(), BX_WRITE, (Bit8u*) &op->vmm16u(n));
+        pageWriteStampTable.decWriteStamp(pAddr + 2*n, 2);
+        WriteHostWordToLittleEndian((Bit16u*) (hostAddr + 2*n), op->vmm16u(n));
+      }
+    }
+    return;
+  }
+
 #if BX_SUPPORT_X86_64
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
@@ -211,6 +335,22 @@ void BX_CPU_C::avx_masked_store32(bxInstruction_c *i, bx_address eaddr, const Bx
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_WRITE, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    bx_phy_address pAddr = tlbEntry->ppf | pageOffset;
+    for (unsigned n=0; n < DWORD_ELEMENTS(len); n++) {
+      if (mask & (1<<n)) {
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + 4*n, pAddr + 4*n, 4, tlbEntry->get_memtype(), BX_WRITE, (Bit8u*) &op->vmm32u(n));
+        pageWriteStampTable.decWriteStamp(pAddr + 4*n, 4);
+        WriteHostDWordToLittleEndian((Bit32u*) (hostAddr + 4*n), op->vmm32u(n));
+      }
+    }
+    return;
+  }
+
 #if BX_SUPPORT_X86_64
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
@@ -248,6 +388,22 @@ void BX_CPU_C::avx_masked_store64(bxInstruction_c *i, bx_address eaddr, const Bx
 {
   unsigned len = i->getVL();
 
+  bx_address laddr;
+  bx_TLB_entry *tlbEntry = avx_masked_tlb_entry(i, eaddr, BX_WRITE, &laddr);
+  if (tlbEntry) {
+    Bit32u pageOffset = PAGE_OFFSET(laddr);
+    Bit8u *hostAddr = (Bit8u*) (tlbEntry->hostPageAddr | pageOffset);
+    bx_phy_address pAddr = tlbEntry->ppf | pageOffset;
+    for (unsigned n=0; n < QWORD_ELEMENTS(len); n++) {
+      if (mask & (1<<n)) {
+        BX_NOTIFY_LIN_MEMORY_ACCESS(laddr + 8*n, pAddr + 8*n, 8, tlbEntry->get_memtype(), BX_WRITE, (Bit8u*) &op->vmm64u(n));
+        pageWriteStampTable.decWriteStamp(pAddr + 8*n, 8);
+        WriteHostQWordToLittleEndian((Bit64u*) (hostAddr + 8*n), op->vmm64u(n));
+      }
+    }
+    return;
+  }
+
 #if BX_SUPPORT_X86_64
   if (i->as64L()) {
     Bit64u laddr = get_laddr64(i->seg(), eaddr);
@@ -231,7 +231,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::VSQRTSS_MASK_VssHpsWssR(bxInstruct
 
     float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
     softfloat_status_word_rc_override(status, i);
-    op1.xmm32u(0) = float32_sqrt(op2, status);
+    op1.xmm32u(0) = xmm_sqrtss(op2, status);
     check_exceptionsSSE(get_exception_flags(status));
   }
   else {
@@ -254,7 +254,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::VSQRTSD_MASK_VsdHpdWsdR(bxInstruct
 
     float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
     softfloat_status_word_rc_override(status, i);
-    op1.xmm64u(0) = float64_sqrt(op2, status);
+    op1.xmm64u(0) = xmm_sqrtsd(op2, status);
     check_exceptionsSSE(get_exception_flags(status));
   }
   else {
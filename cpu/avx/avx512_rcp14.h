@@ -0,0 +1,137 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//   Copyright (c) 2014 Stanislav Shwartsman
+//          Written by Stanislav Shwartsman [sshwarts at sourceforge net]
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA B 02110-1301 USA
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef BX_AVX512_RCP14_H
+#define BX_AVX512_RCP14_H
+
+// VRCP14 and VRSQRT14 mantissa tables, shared with misc/test-rcp14.cc
+// which checks them against the original lookup tables
+
+//
+// The table was reverse-engineered from VRCP14SS instruction implementation available
+// in the Intel Software Development Emulator rev6.20 (released February 13, 2014)
+// http://software.intel.com/en-us/articles/intel-software-development-emulator/
+//
+// The 64K-entry table is piecewise linear: every 1024-entry segment is
+//
+//   rcp14_table[index] = (base - slope * (index & 1023)) >> 9
+//
+// so only the 64 (base, slope) pairs are kept and the entries are recomputed
+// on the fly, bit-exact with the original table.
+//
+
+static const Bit32u rcp14_base[64] = {
+  0x1fff900, 0x1f03600, 0x1e0f200, 0x1d22000, //  0
+  0x1c3bb00, 0x1b5c700, 0x1a83300, 0x19b0600, //  4
+  0x18e3200, 0x181bc00, 0x1759800, 0x169ca00, //  8
+  0x15e4c00, 0x1531b00, 0x1483100, 0x13d8c00, // 12
+  0x1332f00, 0x1291100, 0x11f3600, 0x1159300, // 16
+  0x10c2d00, 0x102ff00, 0x0fa0a00, 0x0f14500, // 20
+  0x0e8b600, 0x0e05800, 0x0d82d00, 0x0d02a00, // 24
+  0x0c85700, 0x0c0ad00, 0x0b92e00, 0x0b1d700, // 28
+  0x0aaaa00, 0x0a39f00, 0x09cbc00, 0x095f800, // 32
+  0x08f5a00, 0x088dd00, 0x0828000, 0x07c4300, // 36
+  0x0762800, 0x0702500, 0x06a4100, 0x0647b00, // 40
+  0x05ed100, 0x0593d00, 0x053c600, 0x04e6800, // 44
+  0x0492300, 0x043f500, 0x03ede00, 0x039e200, // 48
+  0x034f600, 0x0302100, 0x02b6400, 0x026b700, // 52
+  0x0222200, 0x01d9f00, 0x0192d00, 0x014d300, // 56
+  0x0108900, 0x00c4f00, 0x0082500, 0x0040b00  // 60
+};
+
+static const Bit16u rcp14_slope[64] = {
+  1009,  977,  949,  921,  893,  869,  843,  821, //  0
+   797,  777,  755,  735,  717,  699,  681,  663, //  8
+   647,  631,  617,  601,  587,  573,  561,  547, // 16
+   535,  523,  513,  501,  491,  479,  469,  459, // 24
+   451,  441,  433,  423,  415,  407,  399,  391, // 32
+   385,  377,  369,  363,  357,  349,  343,  337, // 40
+   331,  325,  319,  315,  309,  303,  299,  293, // 48
+   289,  285,  279,  275,  271,  267,  263,  259  // 56
+};
+
+BX_CPP_INLINE Bit32u rcp14_table(unsigned index)
+{
+  unsigned segment = index >> 10;
+  return (rcp14_base[segment] - rcp14_slope[segment] * (index & 1023)) >> 9;
+}
+
+//
+// The tables were reverse-engineered from VSQRT14SS instruction implementation available
+// in the Intel Software Development Emulator rev6.20 (released February 13, 2014)
+// http://software.intel.com/en-us/articles/intel-software-development-emulator/
+//
+// Both 32K-entry tables (for even and odd exponent) are piecewise linear: every
+// 1024-entry segment is
+//
+//   rsqrt14_table[index] = (base - slope * (index & 1023)) >> 9
+//
+// so only the (base, slope) pairs are kept and the entries are recomputed
+// on the fly, bit-exact with the original tables.
+//
+
+static const Bit32u rsqrt14_base[2][32] = {
+ {
+  0x0d40a80, 0x0c8fc80, 0x0be6e00, 0x0b45200, //  0
+  0x0aaa600, 0x0a15b80, 0x0987080, 0x08fdc80, //  4
+  0x0879e80, 0x07fad80, 0x0780280, 0x0709e80, //  8
+  0x0697a80, 0x0629500, 0x05be880, 0x0557580, // 12
+  0x04f3380, 0x0492180, 0x0433f80, 0x03d8c80, // 16
+  0x0380180, 0x0329f00, 0x02d6200, 0x0284c00, // 20
+  0x0235900, 0x01e8680, 0x019d380, 0x0153f00, // 24
+  0x010ca80, 0x00c6e80, 0x0083000, 0x0040b00  // 28
+ },
+ {
+  0x1fff480, 0x1f05080, 0x1e16280, 0x1d31900, //  0
+  0x1c56700, 0x1b84380, 0x1aba680, 0x19f8880, //  4
+  0x193dd00, 0x188a080, 0x17dcb80, 0x1735a00, //  8
+  0x1694100, 0x15f7d00, 0x1560f80, 0x14ced80, // 12
+  0x1441380, 0x13b8180, 0x1332f80, 0x12b1c00, // 16
+  0x1234680, 0x11ba980, 0x1144400, 0x10d1180, // 20
+  0x1060f80, 0x0ff3d80, 0x0f89b00, 0x0f21f00, // 24
+  0x0ebcf80, 0x0e5ab00, 0x0dfa780, 0x0d9cd00  // 28
+ }
+};
+
+static const Bit16u rsqrt14_slope[2][32] = {
+ {
+   707,  675,  647,  619,  595,  571,  549,  527, //  0
+   509,  491,  473,  457,  441,  427,  413,  401, //  8
+   389,  377,  365,  355,  345,  335,  325,  317, // 16
+   309,  301,  293,  285,  279,  271,  265,  259  // 24
+ },
+ {
+  1001,  955,  915,  877,  841,  807,  775,  747, //  0
+   719,  693,  669,  647,  625,  603,  585,  567, //  8
+   549,  533,  517,  501,  487,  473,  461,  449, // 16
+   437,  425,  415,  403,  393,  385,  375,  367  // 24
+ }
+};
+
+BX_CPP_INLINE Bit32u rsqrt14_table(unsigned odd_exp, unsigned index)
+{
+  unsigned segment = index >> 10;
+  return (rsqrt14_base[odd_exp][segment] - rsqrt14_slope[odd_exp][segment] * (index & 1023)) >> 9;
+}
+
+#endif
@@ -28,8211 +28,7 @@
 
 #if BX_SUPPORT_EVEX
 
-//
-// The tables were reverse-engineered from VSQRT14SS instruction implementation available
-// in the Intel Software Development Emulator rev6.20 (released February 13, 2014)
-// http://software.intel.com/en-us/articles/intel-software-development-emulator/
-//
-
-// TODO: find better way to emulate these instructions, I am sure the HW doesn't have 64K entry lookup table
-
-static const Bit16u rsqrt14_table0[32768] = {
-    0x6a05, 0x6a03, 0x6a02, 0x6a01, 0x69ff, 0x69fe, 0x69fc, 0x69fb, //     0
-    0x69fa, 0x69f8, 0x69f7, 0x69f6, 0x69f4, 0x69f3, 0x69f1, 0x69f0, //     8
-    0x69ef, 0x69ed, 0x69ec, 0x69eb, 0x69e9, 0x69e8, 0x69e6, 0x69e5, //    16
-    0x69e4, 0x69e2, 0x69e1, 0x69df, 0x69de, 0x69dd, 0x69db, 0x69da, //    24
-    0x69d9, 0x69d7, 0x69d6, 0x69d4, 0x69d3, 0x69d2, 0x69d0, 0x69cf, //    32
-    0x69ce, 0x69cc, 0x69cb, 0x69c9, 0x69c8, 0x69c7, 0x69c5, 0x69c4, //    40
-    0x69c2, 0x69c1, 0x69c0, 0x69be, 0x69bd, 0x69bc, 0x69ba, 0x69b9, //    48
-    0x69b7, 0x69b6, 0x69b5, 0x69b3, 0x69b2, 0x69b1, 0x69af, 0x69ae, //    56
-    0x69ac, 0x69ab, 0x69aa, 0x69a8, 0x69a7, 0x69a5, 0x69a4, 0x69a3, //    64
-    0x69a1, 0x69a0, 0x699f, 0x699d, 0x699c, 0x699a, 0x6999, 0x6998, //    72
-    0x6996, 0x6995, 0x6994, 0x6992, 0x6991, 0x698f, 0x698e, 0x698d, //    80
-    0x698b, 0x698a, 0x6988, 0x6987, 0x6986, 0x6984, 0x6983, 0x6982, //    88
-    0x6980, 0x697f, 0x697d, 0x697c, 0x697b, 0x6979, 0x6978, 0x6977, //    96
-    0x6975, 0x6974, 0x6972, 0x6971, 0x6970, 0x696e, 0x696d, 0x696b, //   104
-    0x696a, 0x6969, 0x6967, 0x6966, 0x6965, 0x6963, 0x6962, 0x6960, //   112
-    0x695f, 0x695e, 0x695c, 0x695b, 0x695a, 0x6958, 0x6957, 0x6955, //   120
-    0x6954, 0x6953, 0x6951, 0x6950, 0x694e, 0x694d, 0x694c, 0x694a, //   128
-    0x6949, 0x6948, 0x6946, 0x6945, 0x6943, 0x6942, 0x6941, 0x693f, //   136
-    0x693e, 0x693d, 0x693b, 0x693a, 0x6938, 0x6937, 0x6936, 0x6934, //   144
-    0x6933, 0x6931, 0x6930, 0x692f, 0x692d, 0x692c, 0x692b, 0x6929, //   152
-    0x6928, 0x6926, 0x6925, 0x6924, 0x6922, 0x6921, 0x6920, 0x691e, //   160
-    0x691d, 0x691b, 0x691a, 0x6919, 0x6917, 0x6916, 0x6914, 0x6913, //   168
-    0x6912, 0x6910, 0x690f, 0x690e, 0x690c, 0x690b, 0x6909, 0x6908, //   176
-    0x6907, 0x6905, 0x6904, 0x6903, 0x6901, 0x6900, 0x68fe, 0x68fd, //   184
-    0x68fc, 0x68fa, 0x68f9, 0x68f7, 0x68f6, 0x68f5, 0x68f3, 0x68f2, //   192
-    0x68f1, 0x68ef, 0x68ee, 0x68ec, 0x68eb, 0x68ea, 0x68e8, 0x68e7, //   200
-    0x68e6, 0x68e4, 0x68e3, 0x68e1, 0x68e0, 0x68df, 0x68dd, 0x68dc, //   208
-    0x68da, 0x68d9, 0x68d8, 0x68d6, 0x68d5, 0x68d4, 0x68d2, 0x68d1, //   216
-    0x68cf, 0x68ce, 0x68cd, 0x68cb, 0x68ca, 0x68c9, 0x68c7, 0x68c6, //   224
-    0x68c4, 0x68c3, 0x68c2, 0x68c0, 0x68bf, 0x68bd, 0x68bc, 0x68bb, //   232
-    0x68b9, 0x68b8, 0x68b7, 0x68b5, 0x68b4, 0x68b2, 0x68b1, 0x68b0, //   240
-    0x68ae, 0x68ad, 0x68ac, 0x68aa, 0x68a9, 0x68a7, 0x68a6, 0x68a5, //   248
-    0x68a3, 0x68a2, 0x68a0, 0x689f, 0x689e, 0x689c, 0x689b, 0x689a, //   256
-    0x6898, 0x6897, 0x6895, 0x6894, 0x6893, 0x6891, 0x6890, 0x688f, //   264
-    0x688d, 0x688c, 0x688a, 0x6889, 0x6888, 0x6886, 0x6885, 0x6883, //   272
-    0x6882, 0x6881, 0x687f, 0x687e, 0x687d, 0x687b, 0x687a, 0x6878, //   280
-    0x6877, 0x6876, 0x6874, 0x6873, 0x6872, 0x6870, 0x686f, 0x686d, //   288
-    0x686c, 0x686b, 0x6869, 0x6868, 0x6866, 0x6865, 0x6864, 0x6862, //   296
-    0x6861, 0x6860, 0x685e, 0x685d, 0x685b, 0x685a, 0x6859, 0x6857, //   304
-    0x6856, 0x6855, 0x6853, 0x6852, 0x6850, 0x684f, 0x684e, 0x684c, //   312
-    0x684b, 0x6849, 0x6848, 0x6847, 0x6845, 0x6844, 0x6843, 0x6841, //   320
-    0x6840, 0x683e, 0x683d, 0x683c, 0x683a, 0x6839, 0x6838, 0x6836, //   328
-    0x6835, 0x6833, 0x6832, 0x6831, 0x682f, 0x682e, 0x682c, 0x682b, //   336
-    0x682a, 0x6828, 0x6827, 0x6826, 0x6824, 0x6823, 0x6821, 0x6820, //   344
-    0x681f, 0x681d, 0x681c, 0x681b, 0x6819, 0x6818, 0x6816, 0x6815, //   352
-    0x6814, 0x6812, 0x6811, 0x680f, 0x680e, 0x680d, 0x680b, 0x680a, //   360
-    0x6809, 0x6807, 0x6806, 0x6804, 0x6803, 0x6802, 0x6800, 0x67ff, //   368
-    0x67fe, 0x67fc, 0x67fb, 0x67f9, 0x67f8, 0x67f7, 0x67f5, 0x67f4, //   376
-    0x67f3, 0x67f1, 0x67f0, 0x67ee, 0x67ed, 0x67ec, 0x67ea, 0x67e9, //   384
-    0x67e7, 0x67e6, 0x67e5, 0x67e3, 0x67e2, 0x67e1, 0x67df, 0x67de, //   392
-    0x67dc, 0x67db, 0x67da, 0x67d8, 0x67d7, 0x67d6, 0x67d4, 0x67d3, //   400
-    0x67d1, 0x67d0, 0x67cf, 0x67cd, 0x67cc, 0x67ca, 0x67c9, 0x67c8, //   408
-    0x67c6, 0x67c5, 0x67c4, 0x67c2, 0x67c1, 0x67bf, 0x67be, 0x67bd, //   416
-    0x67bb, 0x67ba, 0x67b9, 0x67b7, 0x67b6, 0x67b4, 0x67b3, 0x67b2, //   424
-    0x67b0, 0x67af, 0x67ad, 0x67ac, 0x67ab, 0x67a9, 0x67a8, 0x67a7, //   432
-    0x67a5, 0x67a4, 0x67a2, 0x67a1, 0x67a0, 0x679e, 0x679d, 0x679c, //   440
-    0x679a, 0x6799, 0x6797, 0x6796, 0x6795, 0x6793, 0x6792, 0x6790, //   448
-    0x678f, 0x678e, 0x678c, 0x678b, 0x678a, 0x6788, 0x6787, 0x6785, //   456
-    0x6784, 0x6783, 0x6781, 0x6780, 0x677f, 0x677d, 0x677c, 0x677a, //   464
-    0x6779, 0x6778, 0x6776, 0x6775, 0x6773, 0x6772, 0x6771, 0x676f, //   472
-    0x676e, 0x676d, 0x676b, 0x676a, 0x6768, 0x6767, 0x6766, 0x6764, //   480
-    0x6763, 0x6762, 0x6760, 0x675f, 0x675d, 0x675c, 0x675b, 0x6759, //   488
-    0x6758, 0x6756, 0x6755, 0x6754, 0x6752, 0x6751, 0x6750, 0x674e, //   496
-    0x674d, 0x674b, 0x674a, 0x6749, 0x6747, 0x6746, 0x6745, 0x6743, //   504
-    0x6742, 0x6740, 0x673f, 0x673e, 0x673c, 0x673b, 0x6739, 0x6738, //   512
-    0x6737, 0x6735, 0x6734, 0x6733, 0x6731, 0x6730, 0x672e, 0x672d, //   520
-    0x672c, 0x672a, 0x6729, 0x6728, 0x6726, 0x6725, 0x6723, 0x6722, //   528
-    0x6721, 0x671f, 0x671e, 0x671c, 0x671b, 0x671a, 0x6718, 0x6717, //   536
-    0x6716, 0x6714, 0x6713, 0x6711, 0x6710, 0x670f, 0x670d, 0x670c, //   544
-    0x670b, 0x6709, 0x6708, 0x6706, 0x6705, 0x6704, 0x6702, 0x6701, //   552
-    0x66ff, 0x66fe, 0x66fd, 0x66fb, 0x66fa, 0x66f9, 0x66f7, 0x66f6, //   560
-    0x66f4, 0x66f3, 0x66f2, 0x66f0, 0x66ef, 0x66ee, 0x66ec, 0x66eb, //   568
-    0x66e9, 0x66e8, 0x66e7, 0x66e5, 0x66e4, 0x66e2, 0x66e1, 0x66e0, //   576
-    0x66de, 0x66dd, 0x66dc, 0x66da, 0x66d9, 0x66d7, 0x66d6, 0x66d5, //   584
-    0x66d3, 0x66d2, 0x66d1, 0x66cf, 0x66ce, 0x66cc, 0x66cb, 0x66ca, //   592
-    0x66c8, 0x66c7, 0x66c5, 0x66c4, 0x66c3, 0x66c1, 0x66c0, 0x66bf, //   600
-    0x66bd, 0x66bc, 0x66ba, 0x66b9, 0x66b8, 0x66b6, 0x66b5, 0x66b4, //   608
-    0x66b2, 0x66b1, 0x66af, 0x66ae, 0x66ad, 0x66ab, 0x66aa, 0x66a8, //   616
-    0x66a7, 0x66a6, 0x66a4, 0x66a3, 0x66a2, 0x66a0, 0x669f, 0x669d, //   624
-    0x669c, 0x669b, 0x6699, 0x6698, 0x6697, 0x6695, 0x6694, 0x6692, //   632
-    0x6691, 0x6690, 0x668e, 0x668d, 0x668b, 0x668a, 0x6689, 0x6687, //   640
-    0x6686, 0x6685, 0x6683, 0x6682, 0x6680, 0x667f, 0x667e, 0x667c, //   648
-    0x667b, 0x667a, 0x6678, 0x6677, 0x6675, 0x6674, 0x6673, 0x6671, //   656
-    0x6670, 0x666e, 0x666d, 0x666c, 0x666a, 0x6669, 0x6668, 0x6666, //   664
-    0x6665, 0x6663, 0x6662, 0x6661, 0x665f, 0x665e, 0x665d, 0x665b, //   672
-    0x665a, 0x6658, 0x6657, 0x6656, 0x6654, 0x6653, 0x6651, 0x6650, //   680
-    0x664f, 0x664d, 0x664c, 0x664b, 0x6649, 0x6648, 0x6646, 0x6645, //   688
-    0x6644, 0x6642, 0x6641, 0x6640, 0x663e, 0x663d, 0x663b, 0x663a, //   696
-    0x6639, 0x6637, 0x6636, 0x6634, 0x6633, 0x6632, 0x6630, 0x662f, //   704
-    0x662e, 0x662c, 0x662b, 0x6629, 0x6628, 0x6627, 0x6625, 0x6624, //   712
-    0x6623, 0x6621, 0x6620, 0x661e, 0x661d, 0x661c, 0x661a, 0x6619, //   720
-    0x6617, 0x6616, 0x6615, 0x6613, 0x6612, 0x6611, 0x660f, 0x660e, //   728
-    0x660c, 0x660b, 0x660a, 0x6608, 0x6607, 0x6606, 0x6604, 0x6603, //   736
-    0x6601, 0x6600, 0x65ff, 0x65fd, 0x65fc, 0x65fa, 0x65f9, 0x65f8, //   744
-    0x65f6, 0x65f5, 0x65f4, 0x65f2, 0x65f1, 0x65ef, 0x65ee, 0x65ed, //   752
-    0x65eb, 0x65ea, 0x65e9, 0x65e7, 0x65e6, 0x65e4, 0x65e3, 0x65e2, //   760
-    0x65e0, 0x65df, 0x65dd, 0x65dc, 0x65db, 0x65d9, 0x65d8, 0x65d7, //   768
-    0x65d5, 0x65d4, 0x65d2, 0x65d1, 0x65d0, 0x65ce, 0x65cd, 0x65cc, //   776
-    0x65ca, 0x65c9, 0x65c7, 0x65c6, 0x65c5, 0x65c3, 0x65c2, 0x65c0, //   784
-    0x65bf, 0x65be, 0x65bc, 0x65bb, 0x65ba, 0x65b8, 0x65b7, 0x65b5, //   792
-    0x65b4, 0x65b3, 0x65b1, 0x65b0, 0x65af, 0x65ad, 0x65ac, 0x65aa, //   800
-    0x65a9, 0x65a8, 0x65a6, 0x65a5, 0x65a3, 0x65a2, 0x65a1, 0x659f, //   808
-    0x659e, 0x659d, 0x659b, 0x659a, 0x6598, 0x6597, 0x6596, 0x6594, //   816
-    0x6593, 0x6592, 0x6590, 0x658f, 0x658d, 0x658c, 0x658b, 0x6589, //   824
-    0x6588, 0x6586, 0x6585, 0x6584, 0x6582, 0x6581, 0x6580, 0x657e, //   832
-    0x657d, 0x657b, 0x657a, 0x6579, 0x6577, 0x6576, 0x6575, 0x6573, //   840
-    0x6572, 0x6570, 0x656f, 0x656e, 0x656c, 0x656b, 0x6569, 0x6568, //   848
-    0x6567, 0x6565, 0x6564, 0x6563, 0x6561, 0x6560, 0x655e, 0x655d, //   856
-    0x655c, 0x655a, 0x6559, 0x6558, 0x6556, 0x6555, 0x6553, 0x6552, //   864
-    0x6551, 0x654f, 0x654e, 0x654c, 0x654b, 0x654a, 0x6548, 0x6547, //   872
-    0x6546, 0x6544, 0x6543, 0x6541, 0x6540, 0x653f, 0x653d, 0x653c, //   880
-    0x653b, 0x6539, 0x6538, 0x6536, 0x6535, 0x6534, 0x6532, 0x6531, //   888
-    0x6530, 0x652e, 0x652d, 0x652b, 0x652a, 0x6529, 0x6527, 0x6526, //   896
-    0x6524, 0x6523, 0x6522, 0x6520, 0x651f, 0x651e, 0x651c, 0x651b, //   904
-    0x6519, 0x6518, 0x6517, 0x6515, 0x6514, 0x6513, 0x6511, 0x6510, //   912
-    0x650e, 0x650d, 0x650c, 0x650a, 0x6509, 0x6507, 0x6506, 0x6505, //   920
-    0x6503, 0x6502, 0x6501, 0x64ff, 0x64fe, 0x64fc, 0x64fb, 0x64fa, //   928
-    0x64f8, 0x64f7, 0x64f6, 0x64f4, 0x64f3, 0x64f1, 0x64f0, 0x64ef, //   936
-    0x64ed, 0x64ec, 0x64ea, 0x64e9, 0x64e8, 0x64e6, 0x64e5, 0x64e4, //   944
-    0x64e2, 0x64e1, 0x64df, 0x64de, 0x64dd, 0x64db, 0x64da, 0x64d9, //   952
-    0x64d7, 0x64d6, 0x64d4, 0x64d3, 0x64d2, 0x64d0, 0x64cf, 0x64cd, //   960
-    0x64cc, 0x64cb, 0x64c9, 0x64c8, 0x64c7, 0x64c5, 0x64c4, 0x64c2, //   968
-    0x64c1, 0x64c0, 0x64be, 0x64bd, 0x64bc, 0x64ba, 0x64b9, 0x64b7, //   976
-    0x64b6, 0x64b5, 0x64b3, 0x64b2, 0x64b0, 0x64af, 0x64ae, 0x64ac, //   984
-    0x64ab, 0x64aa, 0x64a8, 0x64a7, 0x64a5, 0x64a4, 0x64a3, 0x64a1, //   992
-    0x64a0, 0x649f, 0x649d, 0x649c, 0x649a, 0x6499, 0x6498, 0x6496, //  1000
-    0x6495, 0x6493, 0x6492, 0x6491, 0x648f, 0x648e, 0x648d, 0x648b, //  1008
-    0x648a, 0x6488, 0x6487, 0x6486, 0x6484, 0x6483, 0x6482, 0x6480, //  1016
-    0x647e, 0x647c, 0x647b, 0x647a, 0x6478, 0x6477, 0x6476, 0x6475, //  1024
-    0x6473, 0x6472, 0x6471, 0x646f, 0x646e, 0x646d, 0x646b, 0x646a, //  1032
-    0x6469, 0x6467, 0x6466, 0x6465, 0x6463, 0x6462, 0x6461, 0x645f, //  1040
-    0x645e, 0x645d, 0x645b, 0x645a, 0x6459, 0x6458, 0x6456, 0x6455, //  1048
-    0x6454, 0x6452, 0x6451, 0x6450, 0x644e, 0x644d, 0x644c, 0x644a, //  1056
-    0x6449, 0x6448, 0x6446, 0x6445, 0x6444, 0x6442, 0x6441, 0x6440, //  1064
-    0x643e, 0x643d, 0x643c, 0x643b, 0x6439, 0x6438, 0x6437, 0x6435, //  1072
-    0x6434, 0x6433, 0x6431, 0x6430, 0x642f, 0x642d, 0x642c, 0x642b, //  1080
-    0x6429, 0x6428, 0x6427, 0x6425, 0x6424, 0x6423, 0x6421, 0x6420, //  1088
-    0x641f, 0x641e, 0x641c, 0x641b, 0x641a, 0x6418, 0x6417, 0x6416, //  1096
-    0x6414, 0x6413, 0x6412, 0x6410, 0x640f, 0x640e, 0x640c, 0x640b, //  1104
-    0x640a, 0x6408, 0x6407, 0x6406, 0x6404, 0x6403, 0x6402, 0x6401, //  1112
-    0x63ff, 0x63fe, 0x63fd, 0x63fb, 0x63fa, 0x63f9, 0x63f7, 0x63f6, //  1120
-    0x63f5, 0x63f3, 0x63f2, 0x63f1, 0x63ef, 0x63ee, 0x63ed, 0x63eb, //  1128
-    0x63ea, 0x63e9, 0x63e7, 0x63e6, 0x63e5, 0x63e4, 0x63e2, 0x63e1, //  1136
-    0x63e0, 0x63de, 0x63dd, 0x63dc, 0x63da, 0x63d9, 0x63d8, 0x63d6, //  1144
-    0x63d5, 0x63d4, 0x63d2, 0x63d1, 0x63d0, 0x63ce, 0x63cd, 0x63cc, //  1152
-    0x63ca, 0x63c9, 0x63c8, 0x63c6, 0x63c5, 0x63c4, 0x63c3, 0x63c1, //  1160
-    0x63c0, 0x63bf, 0x63bd, 0x63bc, 0x63bb, 0x63b9, 0x63b8, 0x63b7, //  1168
-    0x63b5, 0x63b4, 0x63b3, 0x63b1, 0x63b0, 0x63af, 0x63ad, 0x63ac, //  1176
-    0x63ab, 0x63a9, 0x63a8, 0x63a7, 0x63a6, 0x63a4, 0x63a3, 0x63a2, //  1184
-    0x63a0, 0x639f, 0x639e, 0x639c, 0x639b, 0x639a, 0x6398, 0x6397, //  1192
-    0x6396, 0x6394, 0x6393, 0x6392, 0x6390, 0x638f, 0x638e, 0x638c, //  1200
-    0x638b, 0x638a, 0x6389, 0x6387, 0x6386, 0x6385, 0x6383, 0x6382, //  1208
-    0x6381, 0x637f, 0x637e, 0x637d, 0x637b, 0x637a, 0x6379, 0x6377, //  1216
-    0x6376, 0x6375, 0x6373, 0x6372, 0x6371, 0x636f, 0x636e, 0x636d, //  1224
-    0x636c, 0x636a, 0x6369, 0x6368, 0x6366, 0x6365, 0x6364, 0x6362, //  1232
-    0x6361, 0x6360, 0x635e, 0x635d, 0x635c, 0x635a, 0x6359, 0x6358, //  1240
-    0x6356, 0x6355, 0x6354, 0x6352, 0x6351, 0x6350, 0x634f, 0x634d, //  1248
-    0x634c, 0x634b, 0x6349, 0x6348, 0x6347, 0x6345, 0x6344, 0x6343, //  1256
-    0x6341, 0x6340, 0x633f, 0x633d, 0x633c, 0x633b, 0x6339, 0x6338, //  1264
-    0x6337, 0x6335, 0x6334, 0x6333, 0x6332, 0x6330, 0x632f, 0x632e, //  1272
-    0x632c, 0x632b, 0x632a, 0x6328, 0x6327, 0x6326, 0x6324, 0x6323, //  1280
-    0x6322, 0x6320, 0x631f, 0x631e, 0x631c, 0x631b, 0x631a, 0x6318, //  1288
-    0x6317, 0x6316, 0x6315, 0x6313, 0x6312, 0x6311, 0x630f, 0x630e, //  1296
-    0x630d, 0x630b, 0x630a, 0x6309, 0x6307, 0x6306, 0x6305, 0x6303, //  1304
-    0x6302, 0x6301, 0x62ff, 0x62fe, 0x62fd, 0x62fb, 0x62fa, 0x62f9, //  1312
-    0x62f8, 0x62f6, 0x62f5, 0x62f4, 0x62f2, 0x62f1, 0x62f0, 0x62ee, //  1320
-    0x62ed, 0x62ec, 0x62ea, 0x62e9, 0x62e8, 0x62e6, 0x62e5, 0x62e4, //  1328
-    0x62e2, 0x62e1, 0x62e0, 0x62de, 0x62dd, 0x62dc, 0x62db, 0x62d9, //  1336
-    0x62d8, 0x62d7, 0x62d5, 0x62d4, 0x62d3, 0x62d1, 0x62d0, 0x62cf, //  1344
-    0x62cd, 0x62cc, 0x62cb, 0x62c9, 0x62c8, 0x62c7, 0x62c5, 0x62c4, //  1352
-    0x62c3, 0x62c1, 0x62c0, 0x62bf, 0x62be, 0x62bc, 0x62bb, 0x62ba, //  1360
-    0x62b8, 0x62b7, 0x62b6, 0x62b4, 0x62b3, 0x62b2, 0x62b0, 0x62af, //  1368
-    0x62ae, 0x62ac, 0x62ab, 0x62aa, 0x62a8, 0x62a7, 0x62a6, 0x62a4, //  1376
-    0x62a3, 0x62a2, 0x62a1, 0x629f, 0x629e, 0x629d, 0x629b, 0x629a, //  1384
-    0x6299, 0x6297, 0x6296, 0x6295, 0x6293, 0x6292, 0x6291, 0x628f, //  1392
-    0x628e, 0x628d, 0x628b, 0x628a, 0x6289, 0x6287, 0x6286, 0x6285, //  1400
-    0x6284, 0x6282, 0x6281, 0x6280, 0x627e, 0x627d, 0x627c, 0x627a, //  1408
-    0x6279, 0x6278, 0x6276, 0x6275, 0x6274, 0x6272, 0x6271, 0x6270, //  1416
-    0x626e, 0x626d, 0x626c, 0x626a, 0x6269, 0x6268, 0x6266, 0x6265, //  1424
-    0x6264, 0x6263, 0x6261, 0x6260, 0x625f, 0x625d, 0x625c, 0x625b, //  1432
-    0x6259, 0x6258, 0x6257, 0x6255, 0x6254, 0x6253, 0x6251, 0x6250, //  1440
-    0x624f, 0x624d, 0x624c, 0x624b, 0x6249, 0x6248, 0x6247, 0x6246, //  1448
-    0x6244, 0x6243, 0x6242, 0x6240, 0x623f, 0x623e, 0x623c, 0x623b, //  1456
-    0x623a, 0x6238, 0x6237, 0x6236, 0x6234, 0x6233, 0x6232, 0x6230, //  1464
-    0x622f, 0x622e, 0x622c, 0x622b, 0x622a, 0x6229, 0x6227, 0x6226, //  1472
-    0x6225, 0x6223, 0x6222, 0x6221, 0x621f, 0x621e, 0x621d, 0x621b, //  1480
-    0x621a, 0x6219, 0x6217, 0x6216, 0x6215, 0x6213, 0x6212, 0x6211, //  1488
-    0x620f, 0x620e, 0x620d, 0x620c, 0x620a, 0x6209, 0x6208, 0x6206, //  1496
-    0x6205, 0x6204, 0x6202, 0x6201, 0x6200, 0x61fe, 0x61fd, 0x61fc, //  1504
-    0x61fa, 0x61f9, 0x61f8, 0x61f6, 0x61f5, 0x61f4, 0x61f2, 0x61f1, //  1512
-    0x61f0, 0x61ef, 0x61ed, 0x61ec, 0x61eb, 0x61e9, 0x61e8, 0x61e7, //  1520
-    0x61e5, 0x61e4, 0x61e3, 0x61e1, 0x61e0, 0x61df, 0x61dd, 0x61dc, //  1528
-    0x61db, 0x61d9, 0x61d8, 0x61d7, 0x61d5, 0x61d4, 0x61d3, 0x61d2, //  1536
-    0x61d0, 0x61cf, 0x61ce, 0x61cc, 0x61cb, 0x61ca, 0x61c8, 0x61c7, //  1544
-    0x61c6, 0x61c4, 0x61c3, 0x61c2, 0x61c0, 0x61bf, 0x61be, 0x61bc, //  1552
-    0x61bb, 0x61ba, 0x61b8, 0x61b7, 0x61b6, 0x61b5, 0x61b3, 0x61b2, //  1560
-    0x61b1, 0x61af, 0x61ae, 0x61ad, 0x61ab, 0x61aa, 0x61a9, 0x61a7, //  1568
-    0x61a6, 0x61a5, 0x61a3, 0x61a2, 0x61a1, 0x619f, 0x619e, 0x619d, //  1576
-    0x619b, 0x619a, 0x6199, 0x6198, 0x6196, 0x6195, 0x6194, 0x6192, //  1584
-    0x6191, 0x6190, 0x618e, 0x618d, 0x618c, 0x618a, 0x6189, 0x6188, //  1592
-    0x6186, 0x6185, 0x6184, 0x6182, 0x6181, 0x6180, 0x617e, 0x617d, //  1600
-    0x617c, 0x617b, 0x6179, 0x6178, 0x6177, 0x6175, 0x6174, 0x6173, //  1608
-    0x6171, 0x6170, 0x616f, 0x616d, 0x616c, 0x616b, 0x6169, 0x6168, //  1616
-    0x6167, 0x6165, 0x6164, 0x6163, 0x6161, 0x6160, 0x615f, 0x615e, //  1624
-    0x615c, 0x615b, 0x615a, 0x6158, 0x6157, 0x6156, 0x6154, 0x6153, //  1632
-    0x6152, 0x6150, 0x614f, 0x614e, 0x614c, 0x614b, 0x614a, 0x6148, //  1640
-    0x6147, 0x6146, 0x6144, 0x6143, 0x6142, 0x6141, 0x613f, 0x613e, //  1648
-    0x613d, 0x613b, 0x613a, 0x6139, 0x6137, 0x6136, 0x6135, 0x6133, //  1656
-    0x6132, 0x6131, 0x612f, 0x612e, 0x612d, 0x612b, 0x612a, 0x6129, //  1664
-    0x6127, 0x6126, 0x6125, 0x6123, 0x6122, 0x6121, 0x6120, 0x611e, //  1672
-    0x611d, 0x611c, 0x611a, 0x6119, 0x6118, 0x6116, 0x6115, 0x6114, //  1680
-    0x6112, 0x6111, 0x6110, 0x610e, 0x610d, 0x610c, 0x610a, 0x6109, //  1688
-    0x6108, 0x6106, 0x6105, 0x6104, 0x6103, 0x6101, 0x6100, 0x60ff, //  1696
-    0x60fd, 0x60fc, 0x60fb, 0x60f9, 0x60f8, 0x60f7, 0x60f5, 0x60f4, //  1704
-    0x60f3, 0x60f1, 0x60f0, 0x60ef, 0x60ed, 0x60ec, 0x60eb, 0x60e9, //  1712
-    0x60e8, 0x60e7, 0x60e6, 0x60e4, 0x60e3, 0x60e2, 0x60e0, 0x60df, //  1720
-    0x60de, 0x60dc, 0x60db, 0x60da, 0x60d8, 0x60d7, 0x60d6, 0x60d4, //  1728
-    0x60d3, 0x60d2, 0x60d0, 0x60cf, 0x60ce, 0x60cc, 0x60cb, 0x60ca, //  1736
-    0x60c9, 0x60c7, 0x60c6, 0x60c5, 0x60c3, 0x60c2, 0x60c1, 0x60bf, //  1744
-    0x60be, 0x60bd, 0x60bb, 0x60ba, 0x60b9, 0x60b7, 0x60b6, 0x60b5, //  1752
-    0x60b3, 0x60b2, 0x60b1, 0x60af, 0x60ae, 0x60ad, 0x60ac, 0x60aa, //  1760
-    0x60a9, 0x60a8, 0x60a6, 0x60a5, 0x60a4, 0x60a2, 0x60a1, 0x60a0, //  1768
-    0x609e, 0x609d, 0x609c, 0x609a, 0x6099, 0x6098, 0x6096, 0x6095, //  1776
-    0x6094, 0x6092, 0x6091, 0x6090, 0x608f, 0x608d, 0x608c, 0x608b, //  1784
-    0x6089, 0x6088, 0x6087, 0x6085, 0x6084, 0x6083, 0x6081, 0x6080, //  1792
-    0x607f, 0x607d, 0x607c, 0x607b, 0x6079, 0x6078, 0x6077, 0x6075, //  1800
-    0x6074, 0x6073, 0x6072, 0x6070, 0x606f, 0x606e, 0x606c, 0x606b, //  1808
-    0x606a, 0x6068, 0x6067, 0x6066, 0x6064, 0x6063, 0x6062, 0x6060, //  1816
-    0x605f, 0x605e, 0x605c, 0x605b, 0x605a, 0x6058, 0x6057, 0x6056, //  1824
-    0x6055, 0x6053, 0x6052, 0x6051, 0x604f, 0x604e, 0x604d, 0x604b, //  1832
-    0x604a, 0x6049, 0x6047, 0x6046, 0x6045, 0x6043, 0x6042, 0x6041, //  1840
-    0x603f, 0x603e, 0x603d, 0x603b, 0x603a, 0x6039, 0x6038, 0x6036, //  1848
-    0x6035, 0x6034, 0x6032, 0x6031, 0x6030, 0x602e, 0x602d, 0x602c, //  1856
-    0x602a, 0x6029, 0x6028, 0x6026, 0x6025, 0x6024, 0x6022, 0x6021, //  1864
-    0x6020, 0x601e, 0x601d, 0x601c, 0x601b, 0x6019, 0x6018, 0x6017, //  1872
-    0x6015, 0x6014, 0x6013, 0x6011, 0x6010, 0x600f, 0x600d, 0x600c, //  1880
-    0x600b, 0x6009, 0x6008, 0x6007, 0x6005, 0x6004, 0x6003, 0x6001, //  1888
-    0x6000, 0x5fff, 0x5ffe, 0x5ffc, 0x5ffb, 0x5ffa, 0x5ff8, 0x5ff7, //  1896
-    0x5ff6, 0x5ff4, 0x5ff3, 0x5ff2, 0x5ff0, 0x5fef, 0x5fee, 0x5fec, //  1904
-    0x5feb, 0x5fea, 0x5fe8, 0x5fe7, 0x5fe6, 0x5fe4, 0x5fe3, 0x5fe2, //  1912
-    0x5fe1, 0x5fdf, 0x5fde, 0x5fdd, 0x5fdb, 0x5fda, 0x5fd9, 0x5fd7, //  1920
-    0x5fd6, 0x5fd5, 0x5fd3, 0x5fd2, 0x5fd1, 0x5fcf, 0x5fce, 0x5fcd, //  1928
-    0x5fcb, 0x5fca, 0x5fc9, 0x5fc7, 0x5fc6, 0x5fc5, 0x5fc3, 0x5fc2, //  1936
-    0x5fc1, 0x5fc0, 0x5fbe, 0x5fbd, 0x5fbc, 0x5fba, 0x5fb9, 0x5fb8, //  1944
-    0x5fb6, 0x5fb5, 0x5fb4, 0x5fb2, 0x5fb1, 0x5fb0, 0x5fae, 0x5fad, //  1952
-    0x5fac, 0x5faa, 0x5fa9, 0x5fa8, 0x5fa6, 0x5fa5, 0x5fa4, 0x5fa3, //  1960
-    0x5fa1, 0x5fa0, 0x5f9f, 0x5f9d, 0x5f9c, 0x5f9b, 0x5f99, 0x5f98, //  1968
-    0x5f97, 0x5f95, 0x5f94, 0x5f93, 0x5f91, 0x5f90, 0x5f8f, 0x5f8d, //  1976
-    0x5f8c, 0x5f8b, 0x5f89, 0x5f88, 0x5f87, 0x5f86, 0x5f84, 0x5f83, //  1984
-    0x5f82, 0x5f80, 0x5f7f, 0x5f7e, 0x5f7c, 0x5f7b, 0x5f7a, 0x5f78, //  1992
-    0x5f77, 0x5f76, 0x5f74, 0x5f73, 0x5f72, 0x5f70, 0x5f6f, 0x5f6e, //  2000
-    0x5f6c, 0x5f6b, 0x5f6a, 0x5f69, 0x5f67, 0x5f66, 0x5f65, 0x5f63, //  2008
-    0x5f62, 0x5f61, 0x5f5f, 0x5f5e, 0x5f5d, 0x5f5b, 0x5f5a, 0x5f59, //  2016
-    0x5f57, 0x5f56, 0x5f55, 0x5f53, 0x5f52, 0x5f51, 0x5f4f, 0x5f4e, //  2024
-    0x5f4d, 0x5f4c, 0x5f4a, 0x5f49, 0x5f48, 0x5f46, 0x5f45, 0x5f44, //  2032
-    0x5f42, 0x5f41, 0x5f40, 0x5f3e, 0x5f3d, 0x5f3c, 0x5f3a, 0x5f39, //  2040
-    0x5f37, 0x5f35, 0x5f34, 0x5f33, 0x5f31, 0x5f30, 0x5f2f, 0x5f2e, //  2048
-    0x5f2c, 0x5f2b, 0x5f2a, 0x5f29, 0x5f27, 0x5f26, 0x5f25, 0x5f24, //  2056
-    0x5f22, 0x5f21, 0x5f20, 0x5f1e, 0x5f1d, 0x5f1c, 0x5f1b, 0x5f19, //  2064
-    0x5f18, 0x5f17, 0x5f16, 0x5f14, 0x5f13, 0x5f12, 0x5f11, 0x5f0f, //  2072
-    0x5f0e, 0x5f0d, 0x5f0c, 0x5f0a, 0x5f09, 0x5f08, 0x5f06, 0x5f05, //  2080
-    0x5f04, 0x5f03, 0x5f01, 0x5f00, 0x5eff, 0x5efe, 0x5efc, 0x5efb, //  2088
-    0x5efa, 0x5ef9, 0x5ef7, 0x5ef6, 0x5ef5, 0x5ef4, 0x5ef2, 0x5ef1, //  2096
-    0x5ef0, 0x5eee, 0x5eed, 0x5eec, 0x5eeb, 0x5ee9, 0x5ee8, 0x5ee7, //  2104
-    0x5ee6, 0x5ee4, 0x5ee3, 0x5ee2, 0x5ee1, 0x5edf, 0x5ede, 0x5edd, //  2112
-    0x5edc, 0x5eda, 0x5ed9, 0x5ed8, 0x5ed6, 0x5ed5, 0x5ed4, 0x5ed3, //  2120
-    0x5ed1, 0x5ed0, 0x5ecf, 0x5ece, 0x5ecc, 0x5ecb, 0x5eca, 0x5ec9, //  2128
-    0x5ec7, 0x5ec6, 0x5ec5, 0x5ec4, 0x5ec2, 0x5ec1, 0x5ec0, 0x5ebe, //  2136
-    0x5ebd, 0x5ebc, 0x5ebb, 0x5eb9, 0x5eb8, 0x5eb7, 0x5eb6, 0x5eb4, //  2144
-    0x5eb3, 0x5eb2, 0x5eb1, 0x5eaf, 0x5eae, 0x5ead, 0x5eab, 0x5eaa, //  2152
-    0x5ea9, 0x5ea8, 0x5ea6, 0x5ea5, 0x5ea4, 0x5ea3, 0x5ea1, 0x5ea0, //  2160
-    0x5e9f, 0x5e9e, 0x5e9c, 0x5e9b, 0x5e9a, 0x5e99, 0x5e97, 0x5e96, //  2168
-    0x5e95, 0x5e93, 0x5e92, 0x5e91, 0x5e90, 0x5e8e, 0x5e8d, 0x5e8c, //  2176
-    0x5e8b, 0x5e89, 0x5e88, 0x5e87, 0x5e86, 0x5e84, 0x5e83, 0x5e82, //  2184
-    0x5e81, 0x5e7f, 0x5e7e, 0x5e7d, 0x5e7b, 0x5e7a, 0x5e79, 0x5e78, //  2192
-    0x5e76, 0x5e75, 0x5e74, 0x5e73, 0x5e71, 0x5e70, 0x5e6f, 0x5e6e, //  2200
-    0x5e6c, 0x5e6b, 0x5e6a, 0x5e69, 0x5e67, 0x5e66, 0x5e65, 0x5e63, //  2208
-    0x5e62, 0x5e61, 0x5e60, 0x5e5e, 0x5e5d, 0x5e5c, 0x5e5b, 0x5e59, //  2216
-    0x5e58, 0x5e57, 0x5e56, 0x5e54, 0x5e53, 0x5e52, 0x5e51, 0x5e4f, //  2224
-    0x5e4e, 0x5e4d, 0x5e4b, 0x5e4a, 0x5e49, 0x5e48, 0x5e46, 0x5e45, //  2232
-    0x5e44, 0x5e43, 0x5e41, 0x5e40, 0x5e3f, 0x5e3e, 0x5e3c, 0x5e3b, //  2240
-    0x5e3a, 0x5e39, 0x5e37, 0x5e36, 0x5e35, 0x5e33, 0x5e32, 0x5e31, //  2248
-    0x5e30, 0x5e2e, 0x5e2d, 0x5e2c, 0x5e2b, 0x5e29, 0x5e28, 0x5e27, //  2256
-    0x5e26, 0x5e24, 0x5e23, 0x5e22, 0x5e20, 0x5e1f, 0x5e1e, 0x5e1d, //  2264
-    0x5e1b, 0x5e1a, 0x5e19, 0x5e18, 0x5e16, 0x5e15, 0x5e14, 0x5e13, //  2272
-    0x5e11, 0x5e10, 0x5e0f, 0x5e0e, 0x5e0c, 0x5e0b, 0x5e0a, 0x5e08, //  2280
-    0x5e07, 0x5e06, 0x5e05, 0x5e03, 0x5e02, 0x5e01, 0x5e00, 0x5dfe, //  2288
-    0x5dfd, 0x5dfc, 0x5dfb, 0x5df9, 0x5df8, 0x5df7, 0x5df6, 0x5df4, //  2296
-    0x5df3, 0x5df2, 0x5df0, 0x5def, 0x5dee, 0x5ded, 0x5deb, 0x5dea, //  2304
-    0x5de9, 0x5de8, 0x5de6, 0x5de5, 0x5de4, 0x5de3, 0x5de1, 0x5de0, //  2312
-    0x5ddf, 0x5dde, 0x5ddc, 0x5ddb, 0x5dda, 0x5dd8, 0x5dd7, 0x5dd6, //  2320
-    0x5dd5, 0x5dd3, 0x5dd2, 0x5dd1, 0x5dd0, 0x5dce, 0x5dcd, 0x5dcc, //  2328
-    0x5dcb, 0x5dc9, 0x5dc8, 0x5dc7, 0x5dc6, 0x5dc4, 0x5dc3, 0x5dc2, //  2336
-    0x5dc0, 0x5dbf, 0x5dbe, 0x5dbd, 0x5dbb, 0x5dba, 0x5db9, 0x5db8, //  2344
-    0x5db6, 0x5db5, 0x5db4, 0x5db3, 0x5db1, 0x5db0, 0x5daf, 0x5dad, //  2352
-    0x5dac, 0x5dab, 0x5daa, 0x5da8, 0x5da7, 0x5da6, 0x5da5, 0x5da3, //  2360
-    0x5da2, 0x5da1, 0x5da0, 0x5d9e, 0x5d9d, 0x5d9c, 0x5d9b, 0x5d99, //  2368
-    0x5d98, 0x5d97, 0x5d95, 0x5d94, 0x5d93, 0x5d92, 0x5d90, 0x5d8f, //  2376
-    0x5d8e, 0x5d8d, 0x5d8b, 0x5d8a, 0x5d89, 0x5d88, 0x5d86, 0x5d85, //  2384
-    0x5d84, 0x5d83, 0x5d81, 0x5d80, 0x5d7f, 0x5d7d, 0x5d7c, 0x5d7b, //  2392
-    0x5d7a, 0x5d78, 0x5d77, 0x5d76, 0x5d75, 0x5d73, 0x5d72, 0x5d71, //  2400
-    0x5d70, 0x5d6e, 0x5d6d, 0x5d6c, 0x5d6b, 0x5d69, 0x5d68, 0x5d67, //  2408
-    0x5d65, 0x5d64, 0x5d63, 0x5d62, 0x5d60, 0x5d5f, 0x5d5e, 0x5d5d, //  2416
-    0x5d5b, 0x5d5a, 0x5d59, 0x5d58, 0x5d56, 0x5d55, 0x5d54, 0x5d53, //  2424
-    0x5d51, 0x5d50, 0x5d4f, 0x5d4d, 0x5d4c, 0x5d4b, 0x5d4a, 0x5d48, //  2432
-    0x5d47, 0x5d46, 0x5d45, 0x5d43, 0x5d42, 0x5d41, 0x5d40, 0x5d3e, //  2440
-    0x5d3d, 0x5d3c, 0x5d3b, 0x5d39, 0x5d38, 0x5d37, 0x5d35, 0x5d34, //  2448
-    0x5d33, 0x5d32, 0x5d30, 0x5d2f, 0x5d2e, 0x5d2d, 0x5d2b, 0x5d2a, //  2456
-    0x5d29, 0x5d28, 0x5d26, 0x5d25, 0x5d24, 0x5d22, 0x5d21, 0x5d20, //  2464
-    0x5d1f, 0x5d1d, 0x5d1c, 0x5d1b, 0x5d1a, 0x5d18, 0x5d17, 0x5d16, //  2472
-    0x5d15, 0x5d13, 0x5d12, 0x5d11, 0x5d10, 0x5d0e, 0x5d0d, 0x5d0c, //  2480
-    0x5d0a, 0x5d09, 0x5d08, 0x5d07, 0x5d05, 0x5d04, 0x5d03, 0x5d02, //  2488
-    0x5d00, 0x5cff, 0x5cfe, 0x5cfd, 0x5cfb, 0x5cfa, 0x5cf9, 0x5cf8, //  2496
-    0x5cf6, 0x5cf5, 0x5cf4, 0x5cf2, 0x5cf1, 0x5cf0, 0x5cef, 0x5ced, //  2504
-    0x5cec, 0x5ceb, 0x5cea, 0x5ce8, 0x5ce7, 0x5ce6, 0x5ce5, 0x5ce3, //  2512
-    0x5ce2, 0x5ce1, 0x5ce0, 0x5cde, 0x5cdd, 0x5cdc, 0x5cda, 0x5cd9, //  2520
-    0x5cd8, 0x5cd7, 0x5cd5, 0x5cd4, 0x5cd3, 0x5cd2, 0x5cd0, 0x5ccf, //  2528
-    0x5cce, 0x5ccd, 0x5ccb, 0x5cca, 0x5cc9, 0x5cc8, 0x5cc6, 0x5cc5, //  2536
-    0x5cc4, 0x5cc2, 0x5cc1, 0x5cc0, 0x5cbf, 0x5cbd, 0x5cbc, 0x5cbb, //  2544
-    0x5cba, 0x5cb8, 0x5cb7, 0x5cb6, 0x5cb5, 0x5cb3, 0x5cb2, 0x5cb1, //  2552
-    0x5cb0, 0x5cae, 0x5cad, 0x5cac, 0x5caa, 0x5ca9, 0x5ca8, 0x5ca7, //  2560
-    0x5ca5, 0x5ca4, 0x5ca3, 0x5ca2, 0x5ca0, 0x5c9f, 0x5c9e, 0x5c9d, //  2568
-    0x5c9b, 0x5c9a, 0x5c99, 0x5c97, 0x5c96, 0x5c95, 0x5c94, 0x5c92, //  2576
-    0x5c91, 0x5c90, 0x5c8f, 0x5c8d, 0x5c8c, 0x5c8b, 0x5c8a, 0x5c88, //  2584
-    0x5c87, 0x5c86, 0x5c85, 0x5c83, 0x5c82, 0x5c81, 0x5c7f, 0x5c7e, //  2592
-    0x5c7d, 0x5c7c, 0x5c7a, 0x5c79, 0x5c78, 0x5c77, 0x5c75, 0x5c74, //  2600
-    0x5c73, 0x5c72, 0x5c70, 0x5c6f, 0x5c6e, 0x5c6d, 0x5c6b, 0x5c6a, //  2608
-    0x5c69, 0x5c67, 0x5c66, 0x5c65, 0x5c64, 0x5c62, 0x5c61, 0x5c60, //  2616
-    0x5c5f, 0x5c5d, 0x5c5c, 0x5c5b, 0x5c5a, 0x5c58, 0x5c57, 0x5c56, //  2624
-    0x5c55, 0x5c53, 0x5c52, 0x5c51, 0x5c4f, 0x5c4e, 0x5c4d, 0x5c4c, //  2632
-    0x5c4a, 0x5c49, 0x5c48, 0x5c47, 0x5c45, 0x5c44, 0x5c43, 0x5c42, //  2640
-    0x5c40, 0x5c3f, 0x5c3e, 0x5c3d, 0x5c3b, 0x5c3a, 0x5c39, 0x5c37, //  2648
-    0x5c36, 0x5c35, 0x5c34, 0x5c32, 0x5c31, 0x5c30, 0x5c2f, 0x5c2d, //  2656
-    0x5c2c, 0x5c2b, 0x5c2a, 0x5c28, 0x5c27, 0x5c26, 0x5c24, 0x5c23, //  2664
-    0x5c22, 0x5c21, 0x5c1f, 0x5c1e, 0x5c1d, 0x5c1c, 0x5c1a, 0x5c19, //  2672
-    0x5c18, 0x5c17, 0x5c15, 0x5c14, 0x5c13, 0x5c12, 0x5c10, 0x5c0f, //  2680
-    0x5c0e, 0x5c0c, 0x5c0b, 0x5c0a, 0x5c09, 0x5c07, 0x5c06, 0x5c05, //  2688
-    0x5c04, 0x5c02, 0x5c01, 0x5c00, 0x5bff, 0x5bfd, 0x5bfc, 0x5bfb, //  2696
-    0x5bfa, 0x5bf8, 0x5bf7, 0x5bf6, 0x5bf4, 0x5bf3, 0x5bf2, 0x5bf1, //  2704
-    0x5bef, 0x5bee, 0x5bed, 0x5bec, 0x5bea, 0x5be9, 0x5be8, 0x5be7, //  2712
-    0x5be5, 0x5be4, 0x5be3, 0x5be2, 0x5be0, 0x5bdf, 0x5bde, 0x5bdc, //  2720
-    0x5bdb, 0x5bda, 0x5bd9, 0x5bd7, 0x5bd6, 0x5bd5, 0x5bd4, 0x5bd2, //  2728
-    0x5bd1, 0x5bd0, 0x5bcf, 0x5bcd, 0x5bcc, 0x5bcb, 0x5bca, 0x5bc8, //  2736
-    0x5bc7, 0x5bc6, 0x5bc4, 0x5bc3, 0x5bc2, 0x5bc1, 0x5bbf, 0x5bbe, //  2744
-    0x5bbd, 0x5bbc, 0x5bba, 0x5bb9, 0x5bb8, 0x5bb7, 0x5bb5, 0x5bb4, //  2752
-    0x5bb3, 0x5bb2, 0x5bb0, 0x5baf, 0x5bae, 0x5bac, 0x5bab, 0x5baa, //  2760
-    0x5ba9, 0x5ba7, 0x5ba6, 0x5ba5, 0x5ba4, 0x5ba2, 0x5ba1, 0x5ba0, //  2768
-    0x5b9f, 0x5b9d, 0x5b9c, 0x5b9b, 0x5b99, 0x5b98, 0x5b97, 0x5b96, //  2776
-    0x5b94, 0x5b93, 0x5b92, 0x5b91, 0x5b8f, 0x5b8e, 0x5b8d, 0x5b8c, //  2784
-    0x5b8a, 0x5b89, 0x5b88, 0x5b87, 0x5b85, 0x5b84, 0x5b83, 0x5b81, //  2792
-    0x5b80, 0x5b7f, 0x5b7e, 0x5b7c, 0x5b7b, 0x5b7a, 0x5b79, 0x5b77, //  2800
-    0x5b76, 0x5b75, 0x5b74, 0x5b72, 0x5b71, 0x5b70, 0x5b6f, 0x5b6d, //  2808
-    0x5b6c, 0x5b6b, 0x5b69, 0x5b68, 0x5b67, 0x5b66, 0x5b64, 0x5b63, //  2816
-    0x5b62, 0x5b61, 0x5b5f, 0x5b5e, 0x5b5d, 0x5b5c, 0x5b5a, 0x5b59, //  2824
-    0x5b58, 0x5b57, 0x5b55, 0x5b54, 0x5b53, 0x5b51, 0x5b50, 0x5b4f, //  2832
-    0x5b4e, 0x5b4c, 0x5b4b, 0x5b4a, 0x5b49, 0x5b47, 0x5b46, 0x5b45, //  2840
-    0x5b44, 0x5b42, 0x5b41, 0x5b40, 0x5b3f, 0x5b3d, 0x5b3c, 0x5b3b, //  2848
-    0x5b39, 0x5b38, 0x5b37, 0x5b36, 0x5b34, 0x5b33, 0x5b32, 0x5b31, //  2856
-    0x5b2f, 0x5b2e, 0x5b2d, 0x5b2c, 0x5b2a, 0x5b29, 0x5b28, 0x5b26, //  2864
-    0x5b25, 0x5b24, 0x5b23, 0x5b21, 0x5b20, 0x5b1f, 0x5b1e, 0x5b1c, //  2872
-    0x5b1b, 0x5b1a, 0x5b19, 0x5b17, 0x5b16, 0x5b15, 0x5b14, 0x5b12, //  2880
-    0x5b11, 0x5b10, 0x5b0e, 0x5b0d, 0x5b0c, 0x5b0b, 0x5b09, 0x5b08, //  2888
-    0x5b07, 0x5b06, 0x5b04, 0x5b03, 0x5b02, 0x5b01, 0x5aff, 0x5afe, //  2896
-    0x5afd, 0x5afc, 0x5afa, 0x5af9, 0x5af8, 0x5af6, 0x5af5, 0x5af4, //  2904
-    0x5af3, 0x5af1, 0x5af0, 0x5aef, 0x5aee, 0x5aec, 0x5aeb, 0x5aea, //  2912
-    0x5ae9, 0x5ae7, 0x5ae6, 0x5ae5, 0x5ae4, 0x5ae2, 0x5ae1, 0x5ae0, //  2920
-    0x5ade, 0x5add, 0x5adc, 0x5adb, 0x5ad9, 0x5ad8, 0x5ad7, 0x5ad6, //  2928
-    0x5ad4, 0x5ad3, 0x5ad2, 0x5ad1, 0x5acf, 0x5ace, 0x5acd, 0x5acc, //  2936
-    0x5aca, 0x5ac9, 0x5ac8, 0x5ac6, 0x5ac5, 0x5ac4, 0x5ac3, 0x5ac1, //  2944
-    0x5ac0, 0x5abf, 0x5abe, 0x5abc, 0x5abb, 0x5aba, 0x5ab9, 0x5ab7, //  2952
-    0x5ab6, 0x5ab5, 0x5ab4, 0x5ab2, 0x5ab1, 0x5ab0, 0x5aae, 0x5aad, //  2960
-    0x5aac, 0x5aab, 0x5aa9, 0x5aa8, 0x5aa7, 0x5aa6, 0x5aa4, 0x5aa3, //  2968
-    0x5aa2, 0x5aa1, 0x5a9f, 0x5a9e, 0x5a9d, 0x5a9b, 0x5a9a, 0x5a99, //  2976
-    0x5a98, 0x5a96, 0x5a95, 0x5a94, 0x5a93, 0x5a91, 0x5a90, 0x5a8f, //  2984
-    0x5a8e, 0x5a8c, 0x5a8b, 0x5a8a, 0x5a89, 0x5a87, 0x5a86, 0x5a85, //  2992
-    0x5a83, 0x5a82, 0x5a81, 0x5a80, 0x5a7e, 0x5a7d, 0x5a7c, 0x5a7b, //  3000
-    0x5a79, 0x5a78, 0x5a77, 0x5a76, 0x5a74, 0x5a73, 0x5a72, 0x5a71, //  3008
-    0x5a6f, 0x5a6e, 0x5a6d, 0x5a6b, 0x5a6a, 0x5a69, 0x5a68, 0x5a66, //  3016
-    0x5a65, 0x5a64, 0x5a63, 0x5a61, 0x5a60, 0x5a5f, 0x5a5e, 0x5a5c, //  3024
-    0x5a5b, 0x5a5a, 0x5a59, 0x5a57, 0x5a56, 0x5a55, 0x5a53, 0x5a52, //  3032
-    0x5a51, 0x5a50, 0x5a4e, 0x5a4d, 0x5a4c, 0x5a4b, 0x5a49, 0x5a48, //  3040
-    0x5a47, 0x5a46, 0x5a44, 0x5a43, 0x5a42, 0x5a41, 0x5a3f, 0x5a3e, //  3048
-    0x5a3d, 0x5a3b, 0x5a3a, 0x5a39, 0x5a38, 0x5a36, 0x5a35, 0x5a34, //  3056
-    0x5a33, 0x5a31, 0x5a30, 0x5a2f, 0x5a2e, 0x5a2c, 0x5a2b, 0x5a2a, //  3064
-    0x5a29, 0x5a27, 0x5a26, 0x5a25, 0x5a24, 0x5a22, 0x5a21, 0x5a20, //  3072
-    0x5a1f, 0x5a1e, 0x5a1c, 0x5a1b, 0x5a1a, 0x5a19, 0x5a18, 0x5a16, //  3080
-    0x5a15, 0x5a14, 0x5a13, 0x5a12, 0x5a10, 0x5a0f, 0x5a0e, 0x5a0d, //  3088
-    0x5a0b, 0x5a0a, 0x5a09, 0x5a08, 0x5a07, 0x5a05, 0x5a04, 0x5a03, //  3096
-    0x5a02, 0x5a01, 0x59ff, 0x59fe, 0x59fd, 0x59fc, 0x59fb, 0x59f9, //  3104
-    0x59f8, 0x59f7, 0x59f6, 0x59f5, 0x59f3, 0x59f2, 0x59f1, 0x59f0, //  3112
-    0x59ee, 0x59ed, 0x59ec, 0x59eb, 0x59ea, 0x59e8, 0x59e7, 0x59e6, //  3120
-    0x59e5, 0x59e4, 0x59e2, 0x59e1, 0x59e0, 0x59df, 0x59de, 0x59dc, //  3128
-    0x59db, 0x59da, 0x59d9, 0x59d7, 0x59d6, 0x59d5, 0x59d4, 0x59d3, //  3136
-    0x59d1, 0x59d0, 0x59cf, 0x59ce, 0x59cd, 0x59cb, 0x59ca, 0x59c9, //  3144
-    0x59c8, 0x59c7, 0x59c5, 0x59c4, 0x59c3, 0x59c2, 0x59c1, 0x59bf, //  3152
-    0x59be, 0x59bd, 0x59bc, 0x59ba, 0x59b9, 0x59b8, 0x59b7, 0x59b6, //  3160
-    0x59b4, 0x59b3, 0x59b2, 0x59b1, 0x59b0, 0x59ae, 0x59ad, 0x59ac, //  3168
-    0x59ab, 0x59aa, 0x59a8, 0x59a7, 0x59a6, 0x59a5, 0x59a4, 0x59a2, //  3176
-    0x59a1, 0x59a0, 0x599f, 0x599d, 0x599c, 0x599b, 0x599a, 0x5999, //  3184
-    0x5997, 0x5996, 0x5995, 0x5994, 0x5993, 0x5991, 0x5990, 0x598f, //  3192
-    0x598e, 0x598d, 0x598b, 0x598a, 0x5989, 0x5988, 0x5986, 0x5985, //  3200
-    0x5984, 0x5983, 0x5982, 0x5980, 0x597f, 0x597e, 0x597d, 0x597c, //  3208
-    0x597a, 0x5979, 0x5978, 0x5977, 0x5976, 0x5974, 0x5973, 0x5972, //  3216
-    0x5971, 0x5970, 0x596e, 0x596d, 0x596c, 0x596b, 0x5969, 0x5968, //  3224
-    0x5967, 0x5966, 0x5965, 0x5963, 0x5962, 0x5961, 0x5960, 0x595f, //  3232
-    0x595d, 0x595c, 0x595b, 0x595a, 0x5959, 0x5957, 0x5956, 0x5955, //  3240
-    0x5954, 0x5953, 0x5951, 0x5950, 0x594f, 0x594e, 0x594c, 0x594b, //  3248
-    0x594a, 0x5949, 0x5948, 0x5946, 0x5945, 0x5944, 0x5943, 0x5942, //  3256
-    0x5940, 0x593f, 0x593e, 0x593d, 0x593c, 0x593a, 0x5939, 0x5938, //  3264
-    0x5937, 0x5935, 0x5934, 0x5933, 0x5932, 0x5931, 0x592f, 0x592e, //  3272
-    0x592d, 0x592c, 0x592b, 0x5929, 0x5928, 0x5927, 0x5926, 0x5925, //  3280
-    0x5923, 0x5922, 0x5921, 0x5920, 0x591f, 0x591d, 0x591c, 0x591b, //  3288
-    0x591a, 0x5918, 0x5917, 0x5916, 0x5915, 0x5914, 0x5912, 0x5911, //  3296
-    0x5910, 0x590f, 0x590e, 0x590c, 0x590b, 0x590a, 0x5909, 0x5908, //  3304
-    0x5906, 0x5905, 0x5904, 0x5903, 0x5902, 0x5900, 0x58ff, 0x58fe, //  3312
-    0x58fd, 0x58fb, 0x58fa, 0x58f9, 0x58f8, 0x58f7, 0x58f5, 0x58f4, //  3320
-    0x58f3, 0x58f2, 0x58f1, 0x58ef, 0x58ee, 0x58ed, 0x58ec, 0x58eb, //  3328
-    0x58e9, 0x58e8, 0x58e7, 0x58e6, 0x58e4, 0x58e3, 0x58e2, 0x58e1, //  3336
-    0x58e0, 0x58de, 0x58dd, 0x58dc, 0x58db, 0x58da, 0x58d8, 0x58d7, //  3344
-    0x58d6, 0x58d5, 0x58d4, 0x58d2, 0x58d1, 0x58d0, 0x58cf, 0x58ce, //  3352
-    0x58cc, 0x58cb, 0x58ca, 0x58c9, 0x58c7, 0x58c6, 0x58c5, 0x58c4, //  3360
-    0x58c3, 0x58c1, 0x58c0, 0x58bf, 0x58be, 0x58bd, 0x58bb, 0x58ba, //  3368
-    0x58b9, 0x58b8, 0x58b7, 0x58b5, 0x58b4, 0x58b3, 0x58b2, 0x58b1, //  3376
-    0x58af, 0x58ae, 0x58ad, 0x58ac, 0x58aa, 0x58a9, 0x58a8, 0x58a7, //  3384
-    0x58a6, 0x58a4, 0x58a3, 0x58a2, 0x58a1, 0x58a0, 0x589e, 0x589d, //  3392
-    0x589c, 0x589b, 0x589a, 0x5898, 0x5897, 0x5896, 0x5895, 0x5893, //  3400
-    0x5892, 0x5891, 0x5890, 0x588f, 0x588d, 0x588c, 0x588b, 0x588a, //  3408
-    0x5889, 0x5887, 0x5886, 0x5885, 0x5884, 0x5883, 0x5881, 0x5880, //  3416
-    0x587f, 0x587e, 0x587d, 0x587b, 0x587a, 0x5879, 0x5878, 0x5876, //  3424
-    0x5875, 0x5874, 0x5873, 0x5872, 0x5870, 0x586f, 0x586e, 0x586d, //  3432
-    0x586c, 0x586a, 0x5869, 0x5868, 0x5867, 0x5866, 0x5864, 0x5863, //  3440
-    0x5862, 0x5861, 0x5860, 0x585e, 0x585d, 0x585c, 0x585b, 0x5859, //  3448
-    0x5858, 0x5857, 0x5856, 0x5855, 0x5853, 0x5852, 0x5851, 0x5850, //  3456
-    0x584f, 0x584d, 0x584c, 0x584b, 0x584a, 0x5849, 0x5847, 0x5846, //  3464
-    0x5845, 0x5844, 0x5842, 0x5841, 0x5840, 0x583f, 0x583e, 0x583c, //  3472
-    0x583b, 0x583a, 0x5839, 0x5838, 0x5836, 0x5835, 0x5834, 0x5833, //  3480
-    0x5832, 0x5830, 0x582f, 0x582e, 0x582d, 0x582c, 0x582a, 0x5829, //  3488
-    0x5828, 0x5827, 0x5825, 0x5824, 0x5823, 0x5822, 0x5821, 0x581f, //  3496
-    0x581e, 0x581d, 0x581c, 0x581b, 0x5819, 0x5818, 0x5817, 0x5816, //  3504
-    0x5815, 0x5813, 0x5812, 0x5811, 0x5810, 0x580f, 0x580d, 0x580c, //  3512
-    0x580b, 0x580a, 0x5808, 0x5807, 0x5806, 0x5805, 0x5804, 0x5802, //  3520
-    0x5801, 0x5800, 0x57ff, 0x57fe, 0x57fc, 0x57fb, 0x57fa, 0x57f9, //  3528
-    0x57f8, 0x57f6, 0x57f5, 0x57f4, 0x57f3, 0x57f1, 0x57f0, 0x57ef, //  3536
-    0x57ee, 0x57ed, 0x57eb, 0x57ea, 0x57e9, 0x57e8, 0x57e7, 0x57e5, //  3544
-    0x57e4, 0x57e3, 0x57e2, 0x57e1, 0x57df, 0x57de, 0x57dd, 0x57dc, //  3552
-    0x57db, 0x57d9, 0x57d8, 0x57d7, 0x57d6, 0x57d4, 0x57d3, 0x57d2, //  3560
-    0x57d1, 0x57d0, 0x57ce, 0x57cd, 0x57cc, 0x57cb, 0x57ca, 0x57c8, //  3568
-    0x57c7, 0x57c6, 0x57c5, 0x57c4, 0x57c2, 0x57c1, 0x57c0, 0x57bf, //  3576
-    0x57be, 0x57bc, 0x57bb, 0x57ba, 0x57b9, 0x57b7, 0x57b6, 0x57b5, //  3584
-    0x57b4, 0x57b3, 0x57b1, 0x57b0, 0x57af, 0x57ae, 0x57ad, 0x57ab, //  3592
-    0x57aa, 0x57a9, 0x57a8, 0x57a7, 0x57a5, 0x57a4, 0x57a3, 0x57a2, //  3600
-    0x57a0, 0x579f, 0x579e, 0x579d, 0x579c, 0x579a, 0x5799, 0x5798, //  3608
-    0x5797, 0x5796, 0x5794, 0x5793, 0x5792, 0x5791, 0x5790, 0x578e, //  3616
-    0x578d, 0x578c, 0x578b, 0x578a, 0x5788, 0x5787, 0x5786, 0x5785, //  3624
-    0x5783, 0x5782, 0x5781, 0x5780, 0x577f, 0x577d, 0x577c, 0x577b, //  3632
-    0x577a, 0x5779, 0x5777, 0x5776, 0x5775, 0x5774, 0x5773, 0x5771, //  3640
-    0x5770, 0x576f, 0x576e, 0x576c, 0x576b, 0x576a, 0x5769, 0x5768, //  3648
-    0x5766, 0x5765, 0x5764, 0x5763, 0x5762, 0x5760, 0x575f, 0x575e, //  3656
-    0x575d, 0x575c, 0x575a, 0x5759, 0x5758, 0x5757, 0x5756, 0x5754, //  3664
-    0x5753, 0x5752, 0x5751, 0x574f, 0x574e, 0x574d, 0x574c, 0x574b, //  3672
-    0x5749, 0x5748, 0x5747, 0x5746, 0x5745, 0x5743, 0x5742, 0x5741, //  3680
-    0x5740, 0x573f, 0x573d, 0x573c, 0x573b, 0x573a, 0x5739, 0x5737, //  3688
-    0x5736, 0x5735, 0x5734, 0x5732, 0x5731, 0x5730, 0x572f, 0x572e, //  3696
-    0x572c, 0x572b, 0x572a, 0x5729, 0x5728, 0x5726, 0x5725, 0x5724, //  3704
-    0x5723, 0x5722, 0x5720, 0x571f, 0x571e, 0x571d, 0x571b, 0x571a, //  3712
-    0x5719, 0x5718, 0x5717, 0x5715, 0x5714, 0x5713, 0x5712, 0x5711, //  3720
-    0x570f, 0x570e, 0x570d, 0x570c, 0x570b, 0x5709, 0x5708, 0x5707, //  3728
-    0x5706, 0x5705, 0x5703, 0x5702, 0x5701, 0x5700, 0x56fe, 0x56fd, //  3736
-    0x56fc, 0x56fb, 0x56fa, 0x56f8, 0x56f7, 0x56f6, 0x56f5, 0x56f4, //  3744
-    0x56f2, 0x56f1, 0x56f0, 0x56ef, 0x56ee, 0x56ec, 0x56eb, 0x56ea, //  3752
-    0x56e9, 0x56e8, 0x56e6, 0x56e5, 0x56e4, 0x56e3, 0x56e1, 0x56e0, //  3760
-    0x56df, 0x56de, 0x56dd, 0x56db, 0x56da, 0x56d9, 0x56d8, 0x56d7, //  3768
-    0x56d5, 0x56d4, 0x56d3, 0x56d2, 0x56d1, 0x56cf, 0x56ce, 0x56cd, //  3776
-    0x56cc, 0x56ca, 0x56c9, 0x56c8, 0x56c7, 0x56c6, 0x56c4, 0x56c3, //  3784
-    0x56c2, 0x56c1, 0x56c0, 0x56be, 0x56bd, 0x56bc, 0x56bb, 0x56ba, //  3792
-    0x56b8, 0x56b7, 0x56b6, 0x56b5, 0x56b4, 0x56b2, 0x56b1, 0x56b0, //  3800
-    0x56af, 0x56ad, 0x56ac, 0x56ab, 0x56aa, 0x56a9, 0x56a7, 0x56a6, //  3808
-    0x56a5, 0x56a4, 0x56a3, 0x56a1, 0x56a0, 0x569f, 0x569e, 0x569d, //  3816
-    0x569b, 0x569a, 0x5699, 0x5698, 0x5697, 0x5695, 0x5694, 0x5693, //  3824
-    0x5692, 0x5690, 0x568f, 0x568e, 0x568d, 0x568c, 0x568a, 0x5689, //  3832
-    0x5688, 0x5687, 0x5686, 0x5684, 0x5683, 0x5682, 0x5681, 0x5680, //  3840
-    0x567e, 0x567d, 0x567c, 0x567b, 0x5679, 0x5678, 0x5677, 0x5676, //  3848
-    0x5675, 0x5673, 0x5672, 0x5671, 0x5670, 0x566f, 0x566d, 0x566c, //  3856
-    0x566b, 0x566a, 0x5669, 0x5667, 0x5666, 0x5665, 0x5664, 0x5663, //  3864
-    0x5661, 0x5660, 0x565f, 0x565e, 0x565c, 0x565b, 0x565a, 0x5659, //  3872
-    0x5658, 0x5656, 0x5655, 0x5654, 0x5653, 0x5652, 0x5650, 0x564f, //  3880
-    0x564e, 0x564d, 0x564c, 0x564a, 0x5649, 0x5648, 0x5647, 0x5646, //  3888
-    0x5644, 0x5643, 0x5642, 0x5641, 0x563f, 0x563e, 0x563d, 0x563c, //  3896
-    0x563b, 0x5639, 0x5638, 0x5637, 0x5636, 0x5635, 0x5633, 0x5632, //  3904
-    0x5631, 0x5630, 0x562f, 0x562d, 0x562c, 0x562b, 0x562a, 0x5628, //  3912
-    0x5627, 0x5626, 0x5625, 0x5624, 0x5622, 0x5621, 0x5620, 0x561f, //  3920
-    0x561e, 0x561c, 0x561b, 0x561a, 0x5619, 0x5618, 0x5616, 0x5615, //  3928
-    0x5614, 0x5613, 0x5612, 0x5610, 0x560f, 0x560e, 0x560d, 0x560b, //  3936
-    0x560a, 0x5609, 0x5608, 0x5607, 0x5605, 0x5604, 0x5603, 0x5602, //  3944
-    0x5601, 0x55ff, 0x55fe, 0x55fd, 0x55fc, 0x55fb, 0x55f9, 0x55f8, //  3952
-    0x55f7, 0x55f6, 0x55f5, 0x55f3, 0x55f2, 0x55f1, 0x55f0, 0x55ee, //  3960
-    0x55ed, 0x55ec, 0x55eb, 0x55ea, 0x55e8, 0x55e7, 0x55e6, 0x55e5, //  3968
-    0x55e4, 0x55e2, 0x55e1, 0x55e0, 0x55df, 0x55de, 0x55dc, 0x55db, //  3976
-    0x55da, 0x55d9, 0x55d7, 0x55d6, 0x55d5, 0x55d4, 0x55d3, 0x55d1, //  3984
-    0x55d0, 0x55cf, 0x55ce, 0x55cd, 0x55cb, 0x55ca, 0x55c9, 0x55c8, //  3992
-    0x55c7, 0x55c5, 0x55c4, 0x55c3, 0x55c2, 0x55c1, 0x55bf, 0x55be, //  4000
-    0x55bd, 0x55bc, 0x55ba, 0x55b9, 0x55b8, 0x55b7, 0x55b6, 0x55b4, //  4008
-    0x55b3, 0x55b2, 0x55b1, 0x55b0, 0x55ae, 0x55ad, 0x55ac, 0x55ab, //  4016
-    0x55aa, 0x55a8, 0x55a7, 0x55a6, 0x55a5, 0x55a4, 0x55a2, 0x55a1, //  4024
-    0x55a0, 0x559f, 0x559d, 0x559c, 0x559b, 0x559a, 0x5599, 0x5597, //  4032
-    0x5596, 0x5595, 0x5594, 0x5593, 0x5591, 0x5590, 0x558f, 0x558e, //  4040
-    0x558d, 0x558b, 0x558a, 0x5589, 0x5588, 0x5586, 0x5585, 0x5584, //  4048
-    0x5583, 0x5582, 0x5580, 0x557f, 0x557e, 0x557d, 0x557c, 0x557a, //  4056
-    0x5579, 0x5578, 0x5577, 0x5576, 0x5574, 0x5573, 0x5572, 0x5571, //  4064
-    0x5570, 0x556e, 0x556d, 0x556c, 0x556b, 0x5569, 0x5568, 0x5567, //  4072
-    0x5566, 0x5565, 0x5563, 0x5562, 0x5561, 0x5560, 0x555f, 0x555d, //  4080
-    0x555c, 0x555b, 0x555a, 0x5559, 0x5557, 0x5556, 0x5555, 0x5554, //  4088
-    0x5553, 0x5551, 0x5550, 0x554f, 0x554e, 0x554d, 0x554c, 0x554a, //  4096
-    0x5549, 0x5548, 0x5547, 0x5546, 0x5545, 0x5543, 0x5542, 0x5541, //  4104
-    0x5540, 0x553f, 0x553e, 0x553c, 0x553b, 0x553a, 0x5539, 0x5538, //  4112
-    0x5537, 0x5535, 0x5534, 0x5533, 0x5532, 0x5531, 0x5530, 0x552e, //  4120
-    0x552d, 0x552c, 0x552b, 0x552a, 0x5529, 0x5528, 0x5526, 0x5525, //  4128
-    0x5524, 0x5523, 0x5522, 0x5521, 0x551f, 0x551e, 0x551d, 0x551c, //  4136
-    0x551b, 0x551a, 0x5518, 0x5517, 0x5516, 0x5515, 0x5514, 0x5513, //  4144
-    0x5511, 0x5510, 0x550f, 0x550e, 0x550d, 0x550c, 0x550a, 0x5509, //  4152
-    0x5508, 0x5507, 0x5506, 0x5505, 0x5503, 0x5502, 0x5501, 0x5500, //  4160
-    0x54ff, 0x54fe, 0x54fd, 0x54fb, 0x54fa, 0x54f9, 0x54f8, 0x54f7, //  4168
-    0x54f6, 0x54f4, 0x54f3, 0x54f2, 0x54f1, 0x54f0, 0x54ef, 0x54ed, //  4176
-    0x54ec, 0x54eb, 0x54ea, 0x54e9, 0x54e8, 0x54e6, 0x54e5, 0x54e4, //  4184
-    0x54e3, 0x54e2, 0x54e1, 0x54df, 0x54de, 0x54dd, 0x54dc, 0x54db, //  4192
-    0x54da, 0x54d8, 0x54d7, 0x54d6, 0x54d5, 0x54d4, 0x54d3, 0x54d2, //  4200
-    0x54d0, 0x54cf, 0x54ce, 0x54cd, 0x54cc, 0x54cb, 0x54c9, 0x54c8, //  4208
-    0x54c7, 0x54c6, 0x54c5, 0x54c4, 0x54c2, 0x54c1, 0x54c0, 0x54bf, //  4216
-    0x54be, 0x54bd, 0x54bb, 0x54ba, 0x54b9, 0x54b8, 0x54b7, 0x54b6, //  4224
-    0x54b4, 0x54b3, 0x54b2, 0x54b1, 0x54b0, 0x54af, 0x54ad, 0x54ac, //  4232
-    0x54ab, 0x54aa, 0x54a9, 0x54a8, 0x54a7, 0x54a5, 0x54a4, 0x54a3, //  4240
-    0x54a2, 0x54a1, 0x54a0, 0x549e, 0x549d, 0x549c, 0x549b, 0x549a, //  4248
-    0x5499, 0x5497, 0x5496, 0x5495, 0x5494, 0x5493, 0x5492, 0x5490, //  4256
-    0x548f, 0x548e, 0x548d, 0x548c, 0x548b, 0x5489, 0x5488, 0x5487, //  4264
-    0x5486, 0x5485, 0x5484, 0x5482, 0x5481, 0x5480, 0x547f, 0x547e, //  4272
-    0x547d, 0x547c, 0x547a, 0x5479, 0x5478, 0x5477, 0x5476, 0x5475, //  4280
-    0x5473, 0x5472, 0x5471, 0x5470, 0x546f, 0x546e, 0x546c, 0x546b, //  4288
-    0x546a, 0x5469, 0x5468, 0x5467, 0x5465, 0x5464, 0x5463, 0x5462, //  4296
-    0x5461, 0x5460, 0x545e, 0x545d, 0x545c, 0x545b, 0x545a, 0x5459, //  4304
-    0x5457, 0x5456, 0x5455, 0x5454, 0x5453, 0x5452, 0x5451, 0x544f, //  4312
-    0x544e, 0x544d, 0x544c, 0x544b, 0x544a, 0x5448, 0x5447, 0x5446, //  4320
-    0x5445, 0x5444, 0x5443, 0x5441, 0x5440, 0x543f, 0x543e, 0x543d, //  4328
-    0x543c, 0x543a, 0x5439, 0x5438, 0x5437, 0x5436, 0x5435, 0x5433, //  4336
-    0x5432, 0x5431, 0x5430, 0x542f, 0x542e, 0x542c, 0x542b, 0x542a, //  4344
-    0x5429, 0x5428, 0x5427, 0x5426, 0x5424, 0x5423, 0x5422, 0x5421, //  4352
-    0x5420, 0x541f, 0x541d, 0x541c, 0x541b, 0x541a, 0x5419, 0x5418, //  4360
-    0x5416, 0x5415, 0x5414, 0x5413, 0x5412, 0x5411, 0x540f, 0x540e, //  4368
-    0x540d, 0x540c, 0x540b, 0x540a, 0x5408, 0x5407, 0x5406, 0x5405, //  4376
-    0x5404, 0x5403, 0x5401, 0x5400, 0x53ff, 0x53fe, 0x53fd, 0x53fc, //  4384
-    0x53fb, 0x53f9, 0x53f8, 0x53f7, 0x53f6, 0x53f5, 0x53f4, 0x53f2, //  4392
-    0x53f1, 0x53f0, 0x53ef, 0x53ee, 0x53ed, 0x53eb, 0x53ea, 0x53e9, //  4400
-    0x53e8, 0x53e7, 0x53e6, 0x53e4, 0x53e3, 0x53e2, 0x53e1, 0x53e0, //  4408
-    0x53df, 0x53dd, 0x53dc, 0x53db, 0x53da, 0x53d9, 0x53d8, 0x53d6, //  4416
-    0x53d5, 0x53d4, 0x53d3, 0x53d2, 0x53d1, 0x53d0, 0x53ce, 0x53cd, //  4424
-    0x53cc, 0x53cb, 0x53ca, 0x53c9, 0x53c7, 0x53c6, 0x53c5, 0x53c4, //  4432
-    0x53c3, 0x53c2, 0x53c0, 0x53bf, 0x53be, 0x53bd, 0x53bc, 0x53bb, //  4440
-    0x53b9, 0x53b8, 0x53b7, 0x53b6, 0x53b5, 0x53b4, 0x53b2, 0x53b1, //  4448
-    0x53b0, 0x53af, 0x53ae, 0x53ad, 0x53ab, 0x53aa, 0x53a9, 0x53a8, //  4456
-    0x53a7, 0x53a6, 0x53a5, 0x53a3, 0x53a2, 0x53a1, 0x53a0, 0x539f, //  4464
-    0x539e, 0x539c, 0x539b, 0x539a, 0x5399, 0x5398, 0x5397, 0x5395, //  4472
-    0x5394, 0x5393, 0x5392, 0x5391, 0x5390, 0x538e, 0x538d, 0x538c, //  4480
-    0x538b, 0x538a, 0x5389, 0x5387, 0x5386, 0x5385, 0x5384, 0x5383, //  4488
-    0x5382, 0x5380, 0x537f, 0x537e, 0x537d, 0x537c, 0x537b, 0x537a, //  4496
-    0x5378, 0x5377, 0x5376, 0x5375, 0x5374, 0x5373, 0x5371, 0x5370, //  4504
-    0x536f, 0x536e, 0x536d, 0x536c, 0x536a, 0x5369, 0x5368, 0x5367, //  4512
-    0x5366, 0x5365, 0x5363, 0x5362, 0x5361, 0x5360, 0x535f, 0x535e, //  4520
-    0x535c, 0x535b, 0x535a, 0x5359, 0x5358, 0x5357, 0x5355, 0x5354, //  4528
-    0x5353, 0x5352, 0x5351, 0x5350, 0x534f, 0x534d, 0x534c, 0x534b, //  4536
-    0x534a, 0x5349, 0x5348, 0x5346, 0x5345, 0x5344, 0x5343, 0x5342, //  4544
-    0x5341, 0x533f, 0x533e, 0x533d, 0x533c, 0x533b, 0x533a, 0x5338, //  4552
-    0x5337, 0x5336, 0x5335, 0x5334, 0x5333, 0x5331, 0x5330, 0x532f, //  4560
-    0x532e, 0x532d, 0x532c, 0x532a, 0x5329, 0x5328, 0x5327, 0x5326, //  4568
-    0x5325, 0x5324, 0x5322, 0x5321, 0x5320, 0x531f, 0x531e, 0x531d, //  4576
-    0x531b, 0x531a, 0x5319, 0x5318, 0x5317, 0x5316, 0x5314, 0x5313, //  4584
-    0x5312, 0x5311, 0x5310, 0x530f, 0x530d, 0x530c, 0x530b, 0x530a, //  4592
-    0x5309, 0x5308, 0x5306, 0x5305, 0x5304, 0x5303, 0x5302, 0x5301, //  4600
-    0x5300, 0x52fe, 0x52fd, 0x52fc, 0x52fb, 0x52fa, 0x52f9, 0x52f7, //  4608
-    0x52f6, 0x52f5, 0x52f4, 0x52f3, 0x52f2, 0x52f0, 0x52ef, 0x52ee, //  4616
-    0x52ed, 0x52ec, 0x52eb, 0x52e9, 0x52e8, 0x52e7, 0x52e6, 0x52e5, //  4624
-    0x52e4, 0x52e2, 0x52e1, 0x52e0, 0x52df, 0x52de, 0x52dd, 0x52db, //  4632
-    0x52da, 0x52d9, 0x52d8, 0x52d7, 0x52d6, 0x52d5, 0x52d3, 0x52d2, //  4640
-    0x52d1, 0x52d0, 0x52cf, 0x52ce, 0x52cc, 0x52cb, 0x52ca, 0x52c9, //  4648
-    0x52c8, 0x52c7, 0x52c5, 0x52c4, 0x52c3, 0x52c2, 0x52c1, 0x52c0, //  4656
-    0x52be, 0x52bd, 0x52bc, 0x52bb, 0x52ba, 0x52b9, 0x52b7, 0x52b6, //  4664
-    0x52b5, 0x52b4, 0x52b3, 0x52b2, 0x52b0, 0x52af, 0x52ae, 0x52ad, //  4672
-    0x52ac, 0x52ab, 0x52aa, 0x52a8, 0x52a7, 0x52a6, 0x52a5, 0x52a4, //  4680
-    0x52a3, 0x52a1, 0x52a0, 0x529f, 0x529e, 0x529d, 0x529c, 0x529a, //  4688
-    0x5299, 0x5298, 0x5297, 0x5296, 0x5295, 0x5293, 0x5292, 0x5291, //  4696
-    0x5290, 0x528f, 0x528e, 0x528c, 0x528b, 0x528a, 0x5289, 0x5288, //  4704
-    0x5287, 0x5285, 0x5284, 0x5283, 0x5282, 0x5281, 0x5280, 0x527f, //  4712
-    0x527d, 0x527c, 0x527b, 0x527a, 0x5279, 0x5278, 0x5276, 0x5275, //  4720
-    0x5274, 0x5273, 0x5272, 0x5271, 0x526f, 0x526e, 0x526d, 0x526c, //  4728
-    0x526b, 0x526a, 0x5268, 0x5267, 0x5266, 0x5265, 0x5264, 0x5263, //  4736
-    0x5261, 0x5260, 0x525f, 0x525e, 0x525d, 0x525c, 0x525a, 0x5259, //  4744
-    0x5258, 0x5257, 0x5256, 0x5255, 0x5254, 0x5252, 0x5251, 0x5250, //  4752
-    0x524f, 0x524e, 0x524d, 0x524b, 0x524a, 0x5249, 0x5248, 0x5247, //  4760
-    0x5246, 0x5244, 0x5243, 0x5242, 0x5241, 0x5240, 0x523f, 0x523d, //  4768
-    0x523c, 0x523b, 0x523a, 0x5239, 0x5238, 0x5236, 0x5235, 0x5234, //  4776
-    0x5233, 0x5232, 0x5231, 0x522f, 0x522e, 0x522d, 0x522c, 0x522b, //  4784
-    0x522a, 0x5229, 0x5227, 0x5226, 0x5225, 0x5224, 0x5223, 0x5222, //  4792
-    0x5220, 0x521f, 0x521e, 0x521d, 0x521c, 0x521b, 0x5219, 0x5218, //  4800
-    0x5217, 0x5216, 0x5215, 0x5214, 0x5212, 0x5211, 0x5210, 0x520f, //  4808
-    0x520e, 0x520d, 0x520b, 0x520a, 0x5209, 0x5208, 0x5207, 0x5206, //  4816
-    0x5204, 0x5203, 0x5202, 0x5201, 0x5200, 0x51ff, 0x51fe, 0x51fc, //  4824
-    0x51fb, 0x51fa, 0x51f9, 0x51f8, 0x51f7, 0x51f5, 0x51f4, 0x51f3, //  4832
-    0x51f2, 0x51f1, 0x51f0, 0x51ee, 0x51ed, 0x51ec, 0x51eb, 0x51ea, //  4840
-    0x51e9, 0x51e7, 0x51e6, 0x51e5, 0x51e4, 0x51e3, 0x51e2, 0x51e0, //  4848
-    0x51df, 0x51de, 0x51dd, 0x51dc, 0x51db, 0x51d9, 0x51d8, 0x51d7, //  4856
-    0x51d6, 0x51d5, 0x51d4, 0x51d3, 0x51d1, 0x51d0, 0x51cf, 0x51ce, //  4864
-    0x51cd, 0x51cc, 0x51ca, 0x51c9, 0x51c8, 0x51c7, 0x51c6, 0x51c5, //  4872
-    0x51c3, 0x51c2, 0x51c1, 0x51c0, 0x51bf, 0x51be, 0x51bc, 0x51bb, //  4880
-    0x51ba, 0x51b9, 0x51b8, 0x51b7, 0x51b5, 0x51b4, 0x51b3, 0x51b2, //  4888
-    0x51b1, 0x51b0, 0x51ae, 0x51ad, 0x51ac, 0x51ab, 0x51aa, 0x51a9, //  4896
-    0x51a8, 0x51a6, 0x51a5, 0x51a4, 0x51a3, 0x51a2, 0x51a1, 0x519f, //  4904
-    0x519e, 0x519d, 0x519c, 0x519b, 0x519a, 0x5198, 0x5197, 0x5196, //  4912
-    0x5195, 0x5194, 0x5193, 0x5191, 0x5190, 0x518f, 0x518e, 0x518d, //  4920
-    0x518c, 0x518a, 0x5189, 0x5188, 0x5187, 0x5186, 0x5185, 0x5183, //  4928
-    0x5182, 0x5181, 0x5180, 0x517f, 0x517e, 0x517d, 0x517b, 0x517a, //  4936
-    0x5179, 0x5178, 0x5177, 0x5176, 0x5174, 0x5173, 0x5172, 0x5171, //  4944
-    0x5170, 0x516f, 0x516d, 0x516c, 0x516b, 0x516a, 0x5169, 0x5168, //  4952
-    0x5166, 0x5165, 0x5164, 0x5163, 0x5162, 0x5161, 0x515f, 0x515e, //  4960
-    0x515d, 0x515c, 0x515b, 0x515a, 0x5158, 0x5157, 0x5156, 0x5155, //  4968
-    0x5154, 0x5153, 0x5152, 0x5150, 0x514f, 0x514e, 0x514d, 0x514c, //  4976
-    0x514b, 0x5149, 0x5148, 0x5147, 0x5146, 0x5145, 0x5144, 0x5142, //  4984
-    0x5141, 0x5140, 0x513f, 0x513e, 0x513d, 0x513b, 0x513a, 0x5139, //  4992
-    0x5138, 0x5137, 0x5136, 0x5134, 0x5133, 0x5132, 0x5131, 0x5130, //  5000
-    0x512f, 0x512d, 0x512c, 0x512b, 0x512a, 0x5129, 0x5128, 0x5127, //  5008
-    0x5125, 0x5124, 0x5123, 0x5122, 0x5121, 0x5120, 0x511e, 0x511d, //  5016
-    0x511c, 0x511b, 0x511a, 0x5119, 0x5117, 0x5116, 0x5115, 0x5114, //  5024
-    0x5113, 0x5112, 0x5110, 0x510f, 0x510e, 0x510d, 0x510c, 0x510b, //  5032
-    0x5109, 0x5108, 0x5107, 0x5106, 0x5105, 0x5104, 0x5102, 0x5101, //  5040
-    0x5100, 0x50ff, 0x50fe, 0x50fd, 0x50fc, 0x50fa, 0x50f9, 0x50f8, //  5048
-    0x50f7, 0x50f6, 0x50f5, 0x50f3, 0x50f2, 0x50f1, 0x50f0, 0x50ef, //  5056
-    0x50ee, 0x50ec, 0x50eb, 0x50ea, 0x50e9, 0x50e8, 0x50e7, 0x50e5, //  5064
-    0x50e4, 0x50e3, 0x50e2, 0x50e1, 0x50e0, 0x50de, 0x50dd, 0x50dc, //  5072
-    0x50db, 0x50da, 0x50d9, 0x50d7, 0x50d6, 0x50d5, 0x50d4, 0x50d3, //  5080
-    0x50d2, 0x50d1, 0x50cf, 0x50ce, 0x50cd, 0x50cc, 0x50cb, 0x50ca, //  5088
-    0x50c8, 0x50c7, 0x50c6, 0x50c5, 0x50c4, 0x50c3, 0x50c1, 0x50c0, //  5096
-    0x50bf, 0x50be, 0x50bd, 0x50bc, 0x50ba, 0x50b9, 0x50b8, 0x50b7, //  5104
-    0x50b6, 0x50b5, 0x50b3, 0x50b2, 0x50b1, 0x50b0, 0x50af, 0x50ae, //  5112
-    0x50ad, 0x50ac, 0x50ab, 0x50aa, 0x50a9, 0x50a8, 0x50a7, 0x50a5, //  5120
-    0x50a4, 0x50a3, 0x50a2, 0x50a1, 0x50a0, 0x509f, 0x509e, 0x509d, //  5128
-    0x509b, 0x509a, 0x5099, 0x5098, 0x5097, 0x5096, 0x5095, 0x5094, //  5136
-    0x5092, 0x5091, 0x5090, 0x508f, 0x508e, 0x508d, 0x508c, 0x508b, //  5144
-    0x508a, 0x5088, 0x5087, 0x5086, 0x5085, 0x5084, 0x5083, 0x5082, //  5152
-    0x5081, 0x5080, 0x507e, 0x507d, 0x507c, 0x507b, 0x507a, 0x5079, //  5160
-    0x5078, 0x5077, 0x5075, 0x5074, 0x5073, 0x5072, 0x5071, 0x5070, //  5168
-    0x506f, 0x506e, 0x506d, 0x506b, 0x506a, 0x5069, 0x5068, 0x5067, //  5176
-    0x5066, 0x5065, 0x5064, 0x5063, 0x5061, 0x5060, 0x505f, 0x505e, //  5184
-    0x505d, 0x505c, 0x505b, 0x505a, 0x5058, 0x5057, 0x5056, 0x5055, //  5192
-    0x5054, 0x5053, 0x5052, 0x5051, 0x5050, 0x504e, 0x504d, 0x504c, //  5200
-    0x504b, 0x504a, 0x5049, 0x5048, 0x5047, 0x5046, 0x5044, 0x5043, //  5208
-    0x5042, 0x5041, 0x5040, 0x503f, 0x503e, 0x503d, 0x503b, 0x503a, //  5216
-    0x5039, 0x5038, 0x5037, 0x5036, 0x5035, 0x5034, 0x5033, 0x5031, //  5224
-    0x5030, 0x502f, 0x502e, 0x502d, 0x502c, 0x502b, 0x502a, 0x5029, //  5232
-    0x5027, 0x5026, 0x5025, 0x5024, 0x5023, 0x5022, 0x5021, 0x5020, //  5240
-    0x501f, 0x501d, 0x501c, 0x501b, 0x501a, 0x5019, 0x5018, 0x5017, //  5248
-    0x5016, 0x5014, 0x5013, 0x5012, 0x5011, 0x5010, 0x500f, 0x500e, //  5256
-    0x500d, 0x500c, 0x500a, 0x5009, 0x5008, 0x5007, 0x5006, 0x5005, //  5264
-    0x5004, 0x5003, 0x5002, 0x5000, 0x4fff, 0x4ffe, 0x4ffd, 0x4ffc, //  5272
-    0x4ffb, 0x4ffa, 0x4ff9, 0x4ff7, 0x4ff6, 0x4ff5, 0x4ff4, 0x4ff3, //  5280
-    0x4ff2, 0x4ff1, 0x4ff0, 0x4fef, 0x4fed, 0x4fec, 0x4feb, 0x4fea, //  5288
-    0x4fe9, 0x4fe8, 0x4fe7, 0x4fe6, 0x4fe5, 0x4fe3, 0x4fe2, 0x4fe1, //  5296
-    0x4fe0, 0x4fdf, 0x4fde, 0x4fdd, 0x4fdc, 0x4fda, 0x4fd9, 0x4fd8, //  5304
-    0x4fd7, 0x4fd6, 0x4fd5, 0x4fd4, 0x4fd3, 0x4fd2, 0x4fd0, 0x4fcf, //  5312
-    0x4fce, 0x4fcd, 0x4fcc, 0x4fcb, 0x4fca, 0x4fc9, 0x4fc8, 0x4fc6, //  5320
-    0x4fc5, 0x4fc4, 0x4fc3, 0x4fc2, 0x4fc1, 0x4fc0, 0x4fbf, 0x4fbd, //  5328
-    0x4fbc, 0x4fbb, 0x4fba, 0x4fb9, 0x4fb8, 0x4fb7, 0x4fb6, 0x4fb5, //  5336
-    0x4fb3, 0x4fb2, 0x4fb1, 0x4fb0, 0x4faf, 0x4fae, 0x4fad, 0x4fac, //  5344
-    0x4fab, 0x4fa9, 0x4fa8, 0x4fa7, 0x4fa6, 0x4fa5, 0x4fa4, 0x4fa3, //  5352
-    0x4fa2, 0x4fa0, 0x4f9f, 0x4f9e, 0x4f9d, 0x4f9c, 0x4f9b, 0x4f9a, //  5360
-    0x4f99, 0x4f98, 0x4f96, 0x4f95, 0x4f94, 0x4f93, 0x4f92, 0x4f91, //  5368
-    0x4f90, 0x4f8f, 0x4f8e, 0x4f8c, 0x4f8b, 0x4f8a, 0x4f89, 0x4f88, //  5376
-    0x4f87, 0x4f86, 0x4f85, 0x4f83, 0x4f82, 0x4f81, 0x4f80, 0x4f7f, //  5384
-    0x4f7e, 0x4f7d, 0x4f7c, 0x4f7b, 0x4f79, 0x4f78, 0x4f77, 0x4f76, //  5392
-    0x4f75, 0x4f74, 0x4f73, 0x4f72, 0x4f71, 0x4f6f, 0x4f6e, 0x4f6d, //  5400
-    0x4f6c, 0x4f6b, 0x4f6a, 0x4f69, 0x4f68, 0x4f66, 0x4f65, 0x4f64, //  5408
-    0x4f63, 0x4f62, 0x4f61, 0x4f60, 0x4f5f, 0x4f5e, 0x4f5c, 0x4f5b, //  5416
-    0x4f5a, 0x4f59, 0x4f58, 0x4f57, 0x4f56, 0x4f55, 0x4f54, 0x4f52, //  5424
-    0x4f51, 0x4f50, 0x4f4f, 0x4f4e, 0x4f4d, 0x4f4c, 0x4f4b, 0x4f49, //  5432
-    0x4f48, 0x4f47, 0x4f46, 0x4f45, 0x4f44, 0x4f43, 0x4f42, 0x4f41, //  5440
-    0x4f3f, 0x4f3e, 0x4f3d, 0x4f3c, 0x4f3b, 0x4f3a, 0x4f39, 0x4f38, //  5448
-    0x4f37, 0x4f35, 0x4f34, 0x4f33, 0x4f32, 0x4f31, 0x4f30, 0x4f2f, //  5456
-    0x4f2e, 0x4f2c, 0x4f2b, 0x4f2a, 0x4f29, 0x4f28, 0x4f27, 0x4f26, //  5464
-    0x4f25, 0x4f24, 0x4f22, 0x4f21, 0x4f20, 0x4f1f, 0x4f1e, 0x4f1d, //  5472
-    0x4f1c, 0x4f1b, 0x4f1a, 0x4f18, 0x4f17, 0x4f16, 0x4f15, 0x4f14, //  5480
-    0x4f13, 0x4f12, 0x4f11, 0x4f0f, 0x4f0e, 0x4f0d, 0x4f0c, 0x4f0b, //  5488
-    0x4f0a, 0x4f09, 0x4f08, 0x4f07, 0x4f05, 0x4f04, 0x4f03, 0x4f02, //  5496
-    0x4f01, 0x4f00, 0x4eff, 0x4efe, 0x4efd, 0x4efb, 0x4efa, 0x4ef9, //  5504
-    0x4ef8, 0x4ef7, 0x4ef6, 0x4ef5, 0x4ef4, 0x4ef3, 0x4ef1, 0x4ef0, //  5512
-    0x4eef, 0x4eee, 0x4eed, 0x4eec, 0x4eeb, 0x4eea, 0x4ee8, 0x4ee7, //  5520
-    0x4ee6, 0x4ee5, 0x4ee4, 0x4ee3, 0x4ee2, 0x4ee1, 0x4ee0, 0x4ede, //  5528
-    0x4edd, 0x4edc, 0x4edb, 0x4eda, 0x4ed9, 0x4ed8, 0x4ed7, 0x4ed6, //  5536
-    0x4ed4, 0x4ed3, 0x4ed2, 0x4ed1, 0x4ed0, 0x4ecf, 0x4ece, 0x4ecd, //  5544
-    0x4ecb, 0x4eca, 0x4ec9, 0x4ec8, 0x4ec7, 0x4ec6, 0x4ec5, 0x4ec4, //  5552
-    0x4ec3, 0x4ec1, 0x4ec0, 0x4ebf, 0x4ebe, 0x4ebd, 0x4ebc, 0x4ebb, //  5560
-    0x4eba, 0x4eb9, 0x4eb7, 0x4eb6, 0x4eb5, 0x4eb4, 0x4eb3, 0x4eb2, //  5568
-    0x4eb1, 0x4eb0, 0x4eae, 0x4ead, 0x4eac, 0x4eab, 0x4eaa, 0x4ea9, //  5576
-    0x4ea8, 0x4ea7, 0x4ea6, 0x4ea4, 0x4ea3, 0x4ea2, 0x4ea1, 0x4ea0, //  5584
-    0x4e9f, 0x4e9e, 0x4e9d, 0x4e9c, 0x4e9a, 0x4e99, 0x4e98, 0x4e97, //  5592
-    0x4e96, 0x4e95, 0x4e94, 0x4e93, 0x4e91, 0x4e90, 0x4e8f, 0x4e8e, //  5600
-    0x4e8d, 0x4e8c, 0x4e8b, 0x4e8a, 0x4e89, 0x4e87, 0x4e86, 0x4e85, //  5608
-    0x4e84, 0x4e83, 0x4e82, 0x4e81, 0x4e80, 0x4e7f, 0x4e7d, 0x4e7c, //  5616
-    0x4e7b, 0x4e7a, 0x4e79, 0x4e78, 0x4e77, 0x4e76, 0x4e74, 0x4e73, //  5624
-    0x4e72, 0x4e71, 0x4e70, 0x4e6f, 0x4e6e, 0x4e6d, 0x4e6c, 0x4e6a, //  5632
-    0x4e69, 0x4e68, 0x4e67, 0x4e66, 0x4e65, 0x4e64, 0x4e63, 0x4e62, //  5640
-    0x4e60, 0x4e5f, 0x4e5e, 0x4e5d, 0x4e5c, 0x4e5b, 0x4e5a, 0x4e59, //  5648
-    0x4e57, 0x4e56, 0x4e55, 0x4e54, 0x4e53, 0x4e52, 0x4e51, 0x4e50, //  5656
-    0x4e4f, 0x4e4d, 0x4e4c, 0x4e4b, 0x4e4a, 0x4e49, 0x4e48, 0x4e47, //  5664
-    0x4e46, 0x4e45, 0x4e43, 0x4e42, 0x4e41, 0x4e40, 0x4e3f, 0x4e3e, //  5672
-    0x4e3d, 0x4e3c, 0x4e3a, 0x4e39, 0x4e38, 0x4e37, 0x4e36, 0x4e35, //  5680
-    0x4e34, 0x4e33, 0x4e32, 0x4e30, 0x4e2f, 0x4e2e, 0x4e2d, 0x4e2c, //  5688
-    0x4e2b, 0x4e2a, 0x4e29, 0x4e28, 0x4e26, 0x4e25, 0x4e24, 0x4e23, //  5696
-    0x4e22, 0x4e21, 0x4e20, 0x4e1f, 0x4e1d, 0x4e1c, 0x4e1b, 0x4e1a, //  5704
-    0x4e19, 0x4e18, 0x4e17, 0x4e16, 0x4e15, 0x4e13, 0x4e12, 0x4e11, //  5712
-    0x4e10, 0x4e0f, 0x4e0e, 0x4e0d, 0x4e0c, 0x4e0b, 0x4e09, 0x4e08, //  5720
-    0x4e07, 0x4e06, 0x4e05, 0x4e04, 0x4e03, 0x4e02, 0x4e00, 0x4dff, //  5728
-    0x4dfe, 0x4dfd, 0x4dfc, 0x4dfb, 0x4dfa, 0x4df9, 0x4df8, 0x4df6, //  5736
-    0x4df5, 0x4df4, 0x4df3, 0x4df2, 0x4df1, 0x4df0, 0x4def, 0x4dee, //  5744
-    0x4dec, 0x4deb, 0x4dea, 0x4de9, 0x4de8, 0x4de7, 0x4de6, 0x4de5, //  5752
-    0x4de4, 0x4de2, 0x4de1, 0x4de0, 0x4ddf, 0x4dde, 0x4ddd, 0x4ddc, //  5760
-    0x4ddb, 0x4dd9, 0x4dd8, 0x4dd7, 0x4dd6, 0x4dd5, 0x4dd4, 0x4dd3, //  5768
-    0x4dd2, 0x4dd1, 0x4dcf, 0x4dce, 0x4dcd, 0x4dcc, 0x4dcb, 0x4dca, //  5776
-    0x4dc9, 0x4dc8, 0x4dc7, 0x4dc5, 0x4dc4, 0x4dc3, 0x4dc2, 0x4dc1, //  5784
-    0x4dc0, 0x4dbf, 0x4dbe, 0x4dbc, 0x4dbb, 0x4dba, 0x4db9, 0x4db8, //  5792
-    0x4db7, 0x4db6, 0x4db5, 0x4db4, 0x4db2, 0x4db1, 0x4db0, 0x4daf, //  5800
-    0x4dae, 0x4dad, 0x4dac, 0x4dab, 0x4daa, 0x4da8, 0x4da7, 0x4da6, //  5808
-    0x4da5, 0x4da4, 0x4da3, 0x4da2, 0x4da1, 0x4d9f, 0x4d9e, 0x4d9d, //  5816
-    0x4d9c, 0x4d9b, 0x4d9a, 0x4d99, 0x4d98, 0x4d97, 0x4d95, 0x4d94, //  5824
-    0x4d93, 0x4d92, 0x4d91, 0x4d90, 0x4d8f, 0x4d8e, 0x4d8d, 0x4d8b, //  5832
-    0x4d8a, 0x4d89, 0x4d88, 0x4d87, 0x4d86, 0x4d85, 0x4d84, 0x4d82, //  5840
-    0x4d81, 0x4d80, 0x4d7f, 0x4d7e, 0x4d7d, 0x4d7c, 0x4d7b, 0x4d7a, //  5848
-    0x4d78, 0x4d77, 0x4d76, 0x4d75, 0x4d74, 0x4d73, 0x4d72, 0x4d71, //  5856
-    0x4d70, 0x4d6e, 0x4d6d, 0x4d6c, 0x4d6b, 0x4d6a, 0x4d69, 0x4d68, //  5864
-    0x4d67, 0x4d65, 0x4d64, 0x4d63, 0x4d62, 0x4d61, 0x4d60, 0x4d5f, //  5872
-    0x4d5e, 0x4d5d, 0x4d5b, 0x4d5a, 0x4d59, 0x4d58, 0x4d57, 0x4d56, //  5880
-    0x4d55, 0x4d54, 0x4d53, 0x4d51, 0x4d50, 0x4d4f, 0x4d4e, 0x4d4d, //  5888
-    0x4d4c, 0x4d4b, 0x4d4a, 0x4d48, 0x4d47, 0x4d46, 0x4d45, 0x4d44, //  5896
-    0x4d43, 0x4d42, 0x4d41, 0x4d40, 0x4d3e, 0x4d3d, 0x4d3c, 0x4d3b, //  5904
-    0x4d3a, 0x4d39, 0x4d38, 0x4d37, 0x4d36, 0x4d34, 0x4d33, 0x4d32, //  5912
-    0x4d31, 0x4d30, 0x4d2f, 0x4d2e, 0x4d2d, 0x4d2b, 0x4d2a, 0x4d29, //  5920
-    0x4d28, 0x4d27, 0x4d26, 0x4d25, 0x4d24, 0x4d23, 0x4d21, 0x4d20, //  5928
-    0x4d1f, 0x4d1e, 0x4d1d, 0x4d1c, 0x4d1b, 0x4d1a, 0x4d19, 0x4d17, //  5936
-    0x4d16, 0x4d15, 0x4d14, 0x4d13, 0x4d12, 0x4d11, 0x4d10, 0x4d0e, //  5944
-    0x4d0d, 0x4d0c, 0x4d0b, 0x4d0a, 0x4d09, 0x4d08, 0x4d07, 0x4d06, //  5952
-    0x4d04, 0x4d03, 0x4d02, 0x4d01, 0x4d00, 0x4cff, 0x4cfe, 0x4cfd, //  5960
-    0x4cfc, 0x4cfa, 0x4cf9, 0x4cf8, 0x4cf7, 0x4cf6, 0x4cf5, 0x4cf4, //  5968
-    0x4cf3, 0x4cf1, 0x4cf0, 0x4cef, 0x4cee, 0x4ced, 0x4cec, 0x4ceb, //  5976
-    0x4cea, 0x4ce9, 0x4ce7, 0x4ce6, 0x4ce5, 0x4ce4, 0x4ce3, 0x4ce2, //  5984
-    0x4ce1, 0x4ce0, 0x4cdf, 0x4cdd, 0x4cdc, 0x4cdb, 0x4cda, 0x4cd9, //  5992
-    0x4cd8, 0x4cd7, 0x4cd6, 0x4cd4, 0x4cd3, 0x4cd2, 0x4cd1, 0x4cd0, //  6000
-    0x4ccf, 0x4cce, 0x4ccd, 0x4ccc, 0x4cca, 0x4cc9, 0x4cc8, 0x4cc7, //  6008
-    0x4cc6, 0x4cc5, 0x4cc4, 0x4cc3, 0x4cc2, 0x4cc0, 0x4cbf, 0x4cbe, //  6016
-    0x4cbd, 0x4cbc, 0x4cbb, 0x4cba, 0x4cb9, 0x4cb8, 0x4cb6, 0x4cb5, //  6024
-    0x4cb4, 0x4cb3, 0x4cb2, 0x4cb1, 0x4cb0, 0x4caf, 0x4cad, 0x4cac, //  6032
-    0x4cab, 0x4caa, 0x4ca9, 0x4ca8, 0x4ca7, 0x4ca6, 0x4ca5, 0x4ca3, //  6040
-    0x4ca2, 0x4ca1, 0x4ca0, 0x4c9f, 0x4c9e, 0x4c9d, 0x4c9c, 0x4c9b, //  6048
-    0x4c99, 0x4c98, 0x4c97, 0x4c96, 0x4c95, 0x4c94, 0x4c93, 0x4c92, //  6056
-    0x4c90, 0x4c8f, 0x4c8e, 0x4c8d, 0x4c8c, 0x4c8b, 0x4c8a, 0x4c89, //  6064
-    0x4c88, 0x4c86, 0x4c85, 0x4c84, 0x4c83, 0x4c82, 0x4c81, 0x4c80, //  6072
-    0x4c7f, 0x4c7e, 0x4c7c, 0x4c7b, 0x4c7a, 0x4c79, 0x4c78, 0x4c77, //  6080
-    0x4c76, 0x4c75, 0x4c73, 0x4c72, 0x4c71, 0x4c70, 0x4c6f, 0x4c6e, //  6088
-    0x4c6d, 0x4c6c, 0x4c6b, 0x4c69, 0x4c68, 0x4c67, 0x4c66, 0x4c65, //  6096
-    0x4c64, 0x4c63, 0x4c62, 0x4c61, 0x4c5f, 0x4c5e, 0x4c5d, 0x4c5c, //  6104
-    0x4c5b, 0x4c5a, 0x4c59, 0x4c58, 0x4c56, 0x4c55, 0x4c54, 0x4c53, //  6112
-    0x4c52, 0x4c51, 0x4c50, 0x4c4f, 0x4c4e, 0x4c4c, 0x4c4b, 0x4c4a, //  6120
-    0x4c49, 0x4c48, 0x4c47, 0x4c46, 0x4c45, 0x4c44, 0x4c42, 0x4c41, //  6128
-    0x4c40, 0x4c3f, 0x4c3e, 0x4c3d, 0x4c3c, 0x4c3b, 0x4c39, 0x4c38, //  6136
-    0x4c38, 0x4c37, 0x4c36, 0x4c35, 0x4c33, 0x4c32, 0x4c31, 0x4c30, //  6144
-    0x4c2f, 0x4c2e, 0x4c2d, 0x4c2c, 0x4c2b, 0x4c2a, 0x4c29, 0x4c28, //  6152
-    0x4c27, 0x4c26, 0x4c24, 0x4c23, 0x4c22, 0x4c21, 0x4c20, 0x4c1f, //  6160
-    0x4c1e, 0x4c1d, 0x4c1c, 0x4c1b, 0x4c1a, 0x4c19, 0x4c18, 0x4c17, //  6168
-    0x4c15, 0x4c14, 0x4c13, 0x4c12, 0x4c11, 0x4c10, 0x4c0f, 0x4c0e, //  6176
-    0x4c0d, 0x4c0c, 0x4c0b, 0x4c0a, 0x4c09, 0x4c07, 0x4c06, 0x4c05, //  6184
-    0x4c04, 0x4c03, 0x4c02, 0x4c01, 0x4c00, 0x4bff, 0x4bfe, 0x4bfd, //  6192
-    0x4bfc, 0x4bfb, 0x4bfa, 0x4bf8, 0x4bf7, 0x4bf6, 0x4bf5, 0x4bf4, //  6200
-    0x4bf3, 0x4bf2, 0x4bf1, 0x4bf0, 0x4bef, 0x4bee, 0x4bed, 0x4bec, //  6208
-    0x4beb, 0x4be9, 0x4be8, 0x4be7, 0x4be6, 0x4be5, 0x4be4, 0x4be3, //  6216
-    0x4be2, 0x4be1, 0x4be0, 0x4bdf, 0x4bde, 0x4bdd, 0x4bdc, 0x4bda, //  6224
-    0x4bd9, 0x4bd8, 0x4bd7, 0x4bd6, 0x4bd5, 0x4bd4, 0x4bd3, 0x4bd2, //  6232
-    0x4bd1, 0x4bd0, 0x4bcf, 0x4bce, 0x4bcd, 0x4bcb, 0x4bca, 0x4bc9, //  6240
-    0x4bc8, 0x4bc7, 0x4bc6, 0x4bc5, 0x4bc4, 0x4bc3, 0x4bc2, 0x4bc1, //  6248
-    0x4bc0, 0x4bbf, 0x4bbe, 0x4bbc, 0x4bbb, 0x4bba, 0x4bb9, 0x4bb8, //  6256
-    0x4bb7, 0x4bb6, 0x4bb5, 0x4bb4, 0x4bb3, 0x4bb2, 0x4bb1, 0x4bb0, //  6264
-    0x4baf, 0x4bad, 0x4bac, 0x4bab, 0x4baa, 0x4ba9, 0x4ba8, 0x4ba7, //  6272
-    0x4ba6, 0x4ba5, 0x4ba4, 0x4ba3, 0x4ba2, 0x4ba1, 0x4b9f, 0x4b9e, //  6280
-    0x4b9d, 0x4b9c, 0x4b9b, 0x4b9a, 0x4b99, 0x4b98, 0x4b97, 0x4b96, //  6288
-    0x4b95, 0x4b94, 0x4b93, 0x4b92, 0x4b90, 0x4b8f, 0x4b8e, 0x4b8d, //  6296
-    0x4b8c, 0x4b8b, 0x4b8a, 0x4b89, 0x4b88, 0x4b87, 0x4b86, 0x4b85, //  6304
-    0x4b84, 0x4b83, 0x4b81, 0x4b80, 0x4b7f, 0x4b7e, 0x4b7d, 0x4b7c, //  6312
-    0x4b7b, 0x4b7a, 0x4b79, 0x4b78, 0x4b77, 0x4b76, 0x4b75, 0x4b74, //  6320
-    0x4b72, 0x4b71, 0x4b70, 0x4b6f, 0x4b6e, 0x4b6d, 0x4b6c, 0x4b6b, //  6328
-    0x4b6a, 0x4b69, 0x4b68, 0x4b67, 0x4b66, 0x4b65, 0x4b63, 0x4b62, //  6336
-    0x4b61, 0x4b60, 0x4b5f, 0x4b5e, 0x4b5d, 0x4b5c, 0x4b5b, 0x4b5a, //  6344
-    0x4b59, 0x4b58, 0x4b57, 0x4b56, 0x4b54, 0x4b53, 0x4b52, 0x4b51, //  6352
-    0x4b50, 0x4b4f, 0x4b4e, 0x4b4d, 0x4b4c, 0x4b4b, 0x4b4a, 0x4b49, //  6360
-    0x4b48, 0x4b46, 0x4b45, 0x4b44, 0x4b43, 0x4b42, 0x4b41, 0x4b40, //  6368
-    0x4b3f, 0x4b3e, 0x4b3d, 0x4b3c, 0x4b3b, 0x4b3a, 0x4b39, 0x4b37, //  6376
-    0x4b36, 0x4b35, 0x4b34, 0x4b33, 0x4b32, 0x4b31, 0x4b30, 0x4b2f, //  6384
-    0x4b2e, 0x4b2d, 0x4b2c, 0x4b2b, 0x4b2a, 0x4b28, 0x4b27, 0x4b26, //  6392
-    0x4b25, 0x4b24, 0x4b23, 0x4b22, 0x4b21, 0x4b20, 0x4b1f, 0x4b1e, //  6400
-    0x4b1d, 0x4b1c, 0x4b1b, 0x4b19, 0x4b18, 0x4b17, 0x4b16, 0x4b15, //  6408
-    0x4b14, 0x4b13, 0x4b12, 0x4b11, 0x4b10, 0x4b0f, 0x4b0e, 0x4b0d, //  6416
-    0x4b0c, 0x4b0a, 0x4b09, 0x4b08, 0x4b07, 0x4b06, 0x4b05, 0x4b04, //  6424
-    0x4b03, 0x4b02, 0x4b01, 0x4b00, 0x4aff, 0x4afe, 0x4afd, 0x4afb, //  6432
-    0x4afa, 0x4af9, 0x4af8, 0x4af7, 0x4af6, 0x4af5, 0x4af4, 0x4af3, //  6440
-    0x4af2, 0x4af1, 0x4af0, 0x4aef, 0x4aed, 0x4aec, 0x4aeb, 0x4aea, //  6448
-    0x4ae9, 0x4ae8, 0x4ae7, 0x4ae6, 0x4ae5, 0x4ae4, 0x4ae3, 0x4ae2, //  6456
-    0x4ae1, 0x4ae0, 0x4ade, 0x4add, 0x4adc, 0x4adb, 0x4ada, 0x4ad9, //  6464
-    0x4ad8, 0x4ad7, 0x4ad6, 0x4ad5, 0x4ad4, 0x4ad3, 0x4ad2, 0x4ad1, //  6472
-    0x4acf, 0x4ace, 0x4acd, 0x4acc, 0x4acb, 0x4aca, 0x4ac9, 0x4ac8, //  6480
-    0x4ac7, 0x4ac6, 0x4ac5, 0x4ac4, 0x4ac3, 0x4ac2, 0x4ac0, 0x4abf, //  6488
-    0x4abe, 0x4abd, 0x4abc, 0x4abb, 0x4aba, 0x4ab9, 0x4ab8, 0x4ab7, //  6496
-    0x4ab6, 0x4ab5, 0x4ab4, 0x4ab3, 0x4ab1, 0x4ab0, 0x4aaf, 0x4aae, //  6504
-    0x4aad, 0x4aac, 0x4aab, 0x4aaa, 0x4aa9, 0x4aa8, 0x4aa7, 0x4aa6, //  6512
-    0x4aa5, 0x4aa4, 0x4aa2, 0x4aa1, 0x4aa0, 0x4a9f, 0x4a9e, 0x4a9d, //  6520
-    0x4a9c, 0x4a9b, 0x4a9a, 0x4a99, 0x4a98, 0x4a97, 0x4a96, 0x4a94, //  6528
-    0x4a93, 0x4a92, 0x4a91, 0x4a90, 0x4a8f, 0x4a8e, 0x4a8d, 0x4a8c, //  6536
-    0x4a8b, 0x4a8a, 0x4a89, 0x4a88, 0x4a87, 0x4a85, 0x4a84, 0x4a83, //  6544
-    0x4a82, 0x4a81, 0x4a80, 0x4a7f, 0x4a7e, 0x4a7d, 0x4a7c, 0x4a7b, //  6552
-    0x4a7a, 0x4a79, 0x4a78, 0x4a76, 0x4a75, 0x4a74, 0x4a73, 0x4a72, //  6560
-    0x4a71, 0x4a70, 0x4a6f, 0x4a6e, 0x4a6d, 0x4a6c, 0x4a6b, 0x4a6a, //  6568
-    0x4a69, 0x4a67, 0x4a66, 0x4a65, 0x4a64, 0x4a63, 0x4a62, 0x4a61, //  6576
-    0x4a60, 0x4a5f, 0x4a5e, 0x4a5d, 0x4a5c, 0x4a5b, 0x4a5a, 0x4a58, //  6584
-    0x4a57, 0x4a56, 0x4a55, 0x4a54, 0x4a53, 0x4a52, 0x4a51, 0x4a50, //  6592
-    0x4a4f, 0x4a4e, 0x4a4d, 0x4a4c, 0x4a4b, 0x4a49, 0x4a48, 0x4a47, //  6600
-    0x4a46, 0x4a45, 0x4a44, 0x4a43, 0x4a42, 0x4a41, 0x4a40, 0x4a3f, //  6608
-    0x4a3e, 0x4a3d, 0x4a3b, 0x4a3a, 0x4a39, 0x4a38, 0x4a37, 0x4a36, //  6616
-    0x4a35, 0x4a34, 0x4a33, 0x4a32, 0x4a31, 0x4a30, 0x4a2f, 0x4a2e, //  6624
-    0x4a2c, 0x4a2b, 0x4a2a, 0x4a29, 0x4a28, 0x4a27, 0x4a26, 0x4a25, //  6632
-    0x4a24, 0x4a23, 0x4a22, 0x4a21, 0x4a20, 0x4a1f, 0x4a1d, 0x4a1c, //  6640
-    0x4a1b, 0x4a1a, 0x4a19, 0x4a18, 0x4a17, 0x4a16, 0x4a15, 0x4a14, //  6648
-    0x4a13, 0x4a12, 0x4a11, 0x4a10, 0x4a0e, 0x4a0d, 0x4a0c, 0x4a0b, //  6656
-    0x4a0a, 0x4a09, 0x4a08, 0x4a07, 0x4a06, 0x4a05, 0x4a04, 0x4a03, //  6664
-    0x4a02, 0x4a01, 0x49ff, 0x49fe, 0x49fd, 0x49fc, 0x49fb, 0x49fa, //  6672
-    0x49f9, 0x49f8, 0x49f7, 0x49f6, 0x49f5, 0x49f4, 0x49f3, 0x49f2, //  6680
-    0x49f0, 0x49ef, 0x49ee, 0x49ed, 0x49ec, 0x49eb, 0x49ea, 0x49e9, //  6688
-    0x49e8, 0x49e7, 0x49e6, 0x49e5, 0x49e4, 0x49e2, 0x49e1, 0x49e0, //  6696
-    0x49df, 0x49de, 0x49dd, 0x49dc, 0x49db, 0x49da, 0x49d9, 0x49d8, //  6704
-    0x49d7, 0x49d6, 0x49d5, 0x49d3, 0x49d2, 0x49d1, 0x49d0, 0x49cf, //  6712
-    0x49ce, 0x49cd, 0x49cc, 0x49cb, 0x49ca, 0x49c9, 0x49c8, 0x49c7, //  6720
-    0x49c6, 0x49c4, 0x49c3, 0x49c2, 0x49c1, 0x49c0, 0x49bf, 0x49be, //  6728
-    0x49bd, 0x49bc, 0x49bb, 0x49ba, 0x49b9, 0x49b8, 0x49b7, 0x49b5, //  6736
-    0x49b4, 0x49b3, 0x49b2, 0x49b1, 0x49b0, 0x49af, 0x49ae, 0x49ad, //  6744
-    0x49ac, 0x49ab, 0x49aa, 0x49a9, 0x49a8, 0x49a6, 0x49a5, 0x49a4, //  6752
-    0x49a3, 0x49a2, 0x49a1, 0x49a0, 0x499f, 0x499e, 0x499d, 0x499c, //  6760
-    0x499b, 0x499a, 0x4999, 0x4997, 0x4996, 0x4995, 0x4994, 0x4993, //  6768
-    0x4992, 0x4991, 0x4990, 0x498f, 0x498e, 0x498d, 0x498c, 0x498b, //  6776
-    0x498a, 0x4988, 0x4987, 0x4986, 0x4985, 0x4984, 0x4983, 0x4982, //  6784
-    0x4981, 0x4980, 0x497f, 0x497e, 0x497d, 0x497c, 0x497a, 0x4979, //  6792
-    0x4978, 0x4977, 0x4976, 0x4975, 0x4974, 0x4973, 0x4972, 0x4971, //  6800
-    0x4970, 0x496f, 0x496e, 0x496d, 0x496b, 0x496a, 0x4969, 0x4968, //  6808
-    0x4967, 0x4966, 0x4965, 0x4964, 0x4963, 0x4962, 0x4961, 0x4960, //  6816
-    0x495f, 0x495e, 0x495c, 0x495b, 0x495a, 0x4959, 0x4958, 0x4957, //  6824
-    0x4956, 0x4955, 0x4954, 0x4953, 0x4952, 0x4951, 0x4950, 0x494f, //  6832
-    0x494d, 0x494c, 0x494b, 0x494a, 0x4949, 0x4948, 0x4947, 0x4946, //  6840
-    0x4945, 0x4944, 0x4943, 0x4942, 0x4941, 0x4940, 0x493e, 0x493d, //  6848
-    0x493c, 0x493b, 0x493a, 0x4939, 0x4938, 0x4937, 0x4936, 0x4935, //  6856
-    0x4934, 0x4933, 0x4932, 0x4931, 0x492f, 0x492e, 0x492d, 0x492c, //  6864
-    0x492b, 0x492a, 0x4929, 0x4928, 0x4927, 0x4926, 0x4925, 0x4924, //  6872
-    0x4923, 0x4921, 0x4920, 0x491f, 0x491e, 0x491d, 0x491c, 0x491b, //  6880
-    0x491a, 0x4919, 0x4918, 0x4917, 0x4916, 0x4915, 0x4914, 0x4912, //  6888
-    0x4911, 0x4910, 0x490f, 0x490e, 0x490d, 0x490c, 0x490b, 0x490a, //  6896
-    0x4909, 0x4908, 0x4907, 0x4906, 0x4905, 0x4903, 0x4902, 0x4901, //  6904
-    0x4900, 0x48ff, 0x48fe, 0x48fd, 0x48fc, 0x48fb, 0x48fa, 0x48f9, //  6912
-    0x48f8, 0x48f7, 0x48f6, 0x48f4, 0x48f3, 0x48f2, 0x48f1, 0x48f0, //  6920
-    0x48ef, 0x48ee, 0x48ed, 0x48ec, 0x48eb, 0x48ea, 0x48e9, 0x48e8, //  6928
-    0x48e7, 0x48e5, 0x48e4, 0x48e3, 0x48e2, 0x48e1, 0x48e0, 0x48df, //  6936
-    0x48de, 0x48dd, 0x48dc, 0x48db, 0x48da, 0x48d9, 0x48d8, 0x48d6, //  6944
-    0x48d5, 0x48d4, 0x48d3, 0x48d2, 0x48d1, 0x48d0, 0x48cf, 0x48ce, //  6952
-    0x48cd, 0x48cc, 0x48cb, 0x48ca, 0x48c8, 0x48c7, 0x48c6, 0x48c5, //  6960
-    0x48c4, 0x48c3, 0x48c2, 0x48c1, 0x48c0, 0x48bf, 0x48be, 0x48bd, //  6968
-    0x48bc, 0x48bb, 0x48b9, 0x48b8, 0x48b7, 0x48b6, 0x48b5, 0x48b4, //  6976
-    0x48b3, 0x48b2, 0x48b1, 0x48b0, 0x48af, 0x48ae, 0x48ad, 0x48ac, //  6984
-    0x48aa, 0x48a9, 0x48a8, 0x48a7, 0x48a6, 0x48a5, 0x48a4, 0x48a3, //  6992
-    0x48a2, 0x48a1, 0x48a0, 0x489f, 0x489e, 0x489d, 0x489b, 0x489a, //  7000
-    0x4899, 0x4898, 0x4897, 0x4896, 0x4895, 0x4894, 0x4893, 0x4892, //  7008
-    0x4891, 0x4890, 0x488f, 0x488e, 0x488c, 0x488b, 0x488a, 0x4889, //  7016
-    0x4888, 0x4887, 0x4886, 0x4885, 0x4884, 0x4883, 0x4882, 0x4881, //  7024
-    0x4880, 0x487f, 0x487d, 0x487c, 0x487b, 0x487a, 0x4879, 0x4878, //  7032
-    0x4877, 0x4876, 0x4875, 0x4874, 0x4873, 0x4872, 0x4871, 0x486f, //  7040
-    0x486e, 0x486d, 0x486c, 0x486b, 0x486a, 0x4869, 0x4868, 0x4867, //  7048
-    0x4866, 0x4865, 0x4864, 0x4863, 0x4862, 0x4860, 0x485f, 0x485e, //  7056
-    0x485d, 0x485c, 0x485b, 0x485a, 0x4859, 0x4858, 0x4857, 0x4856, //  7064
-    0x4855, 0x4854, 0x4853, 0x4851, 0x4850, 0x484f, 0x484e, 0x484d, //  7072
-    0x484c, 0x484b, 0x484a, 0x4849, 0x4848, 0x4847, 0x4846, 0x4845, //  7080
-    0x4844, 0x4842, 0x4841, 0x4840, 0x483f, 0x483e, 0x483d, 0x483c, //  7088
-    0x483b, 0x483a, 0x4839, 0x4838, 0x4837, 0x4836, 0x4835, 0x4833, //  7096
-    0x4832, 0x4831, 0x4830, 0x482f, 0x482e, 0x482d, 0x482c, 0x482b, //  7104
-    0x482a, 0x4829, 0x4828, 0x4827, 0x4826, 0x4824, 0x4823, 0x4822, //  7112
-    0x4821, 0x4820, 0x481f, 0x481e, 0x481d, 0x481c, 0x481b, 0x481a, //  7120
-    0x4819, 0x4818, 0x4816, 0x4815, 0x4814, 0x4813, 0x4812, 0x4811, //  7128
-    0x4810, 0x480f, 0x480e, 0x480d, 0x480c, 0x480b, 0x480a, 0x4809, //  7136
-    0x4807, 0x4806, 0x4805, 0x4804, 0x4803, 0x4802, 0x4801, 0x4800, //  7144
-    0x47ff, 0x47fe, 0x47fd, 0x47fc, 0x47fb, 0x47fa, 0x47f8, 0x47f7, //  7152
-    0x47f6, 0x47f5, 0x47f4, 0x47f3, 0x47f2, 0x47f1, 0x47f0, 0x47ef, //  7160
-    0x47ee, 0x47ed, 0x47ec, 0x47eb, 0x47ea, 0x47e9, 0x47e8, 0x47e7, //  7168
-    0x47e6, 0x47e4, 0x47e3, 0x47e2, 0x47e1, 0x47e0, 0x47df, 0x47de, //  7176
-    0x47dd, 0x47dc, 0x47db, 0x47da, 0x47d9, 0x47d8, 0x47d7, 0x47d6, //  7184
-    0x47d5, 0x47d4, 0x47d3, 0x47d2, 0x47d1, 0x47d0, 0x47cf, 0x47ce, //  7192
-    0x47cd, 0x47cc, 0x47cb, 0x47ca, 0x47c9, 0x47c8, 0x47c7, 0x47c6, //  7200
-    0x47c5, 0x47c4, 0x47c3, 0x47c1, 0x47c0, 0x47bf, 0x47be, 0x47bd, //  7208
-    0x47bc, 0x47bb, 0x47ba, 0x47b9, 0x47b8, 0x47b7, 0x47b6, 0x47b5, //  7216
-    0x47b4, 0x47b3, 0x47b2, 0x47b1, 0x47b0, 0x47af, 0x47ae, 0x47ad, //  7224
-    0x47ac, 0x47ab, 0x47aa, 0x47a9, 0x47a8, 0x47a7, 0x47a6, 0x47a5, //  7232
-    0x47a4, 0x47a3, 0x47a2, 0x47a1, 0x47a0, 0x479e, 0x479d, 0x479c, //  7240
-    0x479b, 0x479a, 0x4799, 0x4798, 0x4797, 0x4796, 0x4795, 0x4794, //  7248
-    0x4793, 0x4792, 0x4791, 0x4790, 0x478f, 0x478e, 0x478d, 0x478c, //  7256
-    0x478b, 0x478a, 0x4789, 0x4788, 0x4787, 0x4786, 0x4785, 0x4784, //  7264
-    0x4783, 0x4782, 0x4781, 0x4780, 0x477f, 0x477e, 0x477d, 0x477b, //  7272
-    0x477a, 0x4779, 0x4778, 0x4777, 0x4776, 0x4775, 0x4774, 0x4773, //  7280
-    0x4772, 0x4771, 0x4770, 0x476f, 0x476e, 0x476d, 0x476c, 0x476b, //  7288
-    0x476a, 0x4769, 0x4768, 0x4767, 0x4766, 0x4765, 0x4764, 0x4763, //  7296
-    0x4762, 0x4761, 0x4760, 0x475f, 0x475e, 0x475d, 0x475c, 0x475b, //  7304
-    0x475a, 0x4759, 0x4757, 0x4756, 0x4755, 0x4754, 0x4753, 0x4752, //  7312
-    0x4751, 0x4750, 0x474f, 0x474e, 0x474d, 0x474c, 0x474b, 0x474a, //  7320
-    0x4749, 0x4748, 0x4747, 0x4746, 0x4745, 0x4744, 0x4743, 0x4742, //  7328
-    0x4741, 0x4740, 0x473f, 0x473e, 0x473d, 0x473c, 0x473b, 0x473a, //  7336
-    0x4739, 0x4738, 0x4737, 0x4736, 0x4734, 0x4733, 0x4732, 0x4731, //  7344
-    0x4730, 0x472f, 0x472e, 0x472d, 0x472c, 0x472b, 0x472a, 0x4729, //  7352
-    0x4728, 0x4727, 0x4726, 0x4725, 0x4724, 0x4723, 0x4722, 0x4721, //  7360
-    0x4720, 0x471f, 0x471e, 0x471d, 0x471c, 0x471b, 0x471a, 0x4719, //  7368
-    0x4718, 0x4717, 0x4716, 0x4715, 0x4714, 0x4713, 0x4711, 0x4710, //  7376
-    0x470f, 0x470e, 0x470d, 0x470c, 0x470b, 0x470a, 0x4709, 0x4708, //  7384
-    0x4707, 0x4706, 0x4705, 0x4704, 0x4703, 0x4702, 0x4701, 0x4700, //  7392
-    0x46ff, 0x46fe, 0x46fd, 0x46fc, 0x46fb, 0x46fa, 0x46f9, 0x46f8, //  7400
-    0x46f7, 0x46f6, 0x46f5, 0x46f4, 0x46f3, 0x46f2, 0x46f1, 0x46f0, //  7408
-    0x46ee, 0x46ed, 0x46ec, 0x46eb, 0x46ea, 0x46e9, 0x46e8, 0x46e7, //  7416
-    0x46e6, 0x46e5, 0x46e4, 0x46e3, 0x46e2, 0x46e1, 0x46e0, 0x46df, //  7424
-    0x46de, 0x46dd, 0x46dc, 0x46db, 0x46da, 0x46d9, 0x46d8, 0x46d7, //  7432
-    0x46d6, 0x46d5, 0x46d4, 0x46d3, 0x46d2, 0x46d1, 0x46d0, 0x46cf, //  7440
-    0x46ce, 0x46cd, 0x46cb, 0x46ca, 0x46c9, 0x46c8, 0x46c7, 0x46c6, //  7448
-    0x46c5, 0x46c4, 0x46c3, 0x46c2, 0x46c1, 0x46c0, 0x46bf, 0x46be, //  7456
-    0x46bd, 0x46bc, 0x46bb, 0x46ba, 0x46b9, 0x46b8, 0x46b7, 0x46b6, //  7464
-    0x46b5, 0x46b4, 0x46b3, 0x46b2, 0x46b1, 0x46b0, 0x46af, 0x46ae, //  7472
-    0x46ad, 0x46ac, 0x46ab, 0x46aa, 0x46a8, 0x46a7, 0x46a6, 0x46a5, //  7480
-    0x46a4, 0x46a3, 0x46a2, 0x46a1, 0x46a0, 0x469f, 0x469e, 0x469d, //  7488
-    0x469c, 0x469b, 0x469a, 0x4699, 0x4698, 0x4697, 0x4696, 0x4695, //  7496
-    0x4694, 0x4693, 0x4692, 0x4691, 0x4690, 0x468f, 0x468e, 0x468d, //  7504
-    0x468c, 0x468b, 0x468a, 0x4689, 0x4688, 0x4687, 0x4685, 0x4684, //  7512
-    0x4683, 0x4682, 0x4681, 0x4680, 0x467f, 0x467e, 0x467d, 0x467c, //  7520
-    0x467b, 0x467a, 0x4679, 0x4678, 0x4677, 0x4676, 0x4675, 0x4674, //  7528
-    0x4673, 0x4672, 0x4671, 0x4670, 0x466f, 0x466e, 0x466d, 0x466c, //  7536
-    0x466b, 0x466a, 0x4669, 0x4668, 0x4667, 0x4666, 0x4665, 0x4664, //  7544
-    0x4663, 0x4661, 0x4660, 0x465f, 0x465e, 0x465d, 0x465c, 0x465b, //  7552
-    0x465a, 0x4659, 0x4658, 0x4657, 0x4656, 0x4655, 0x4654, 0x4653, //  7560
-    0x4652, 0x4651, 0x4650, 0x464f, 0x464e, 0x464d, 0x464c, 0x464b, //  7568
-    0x464a, 0x4649, 0x4648, 0x4647, 0x4646, 0x4645, 0x4644, 0x4643, //  7576
-    0x4642, 0x4641, 0x4640, 0x463e, 0x463d, 0x463c, 0x463b, 0x463a, //  7584
-    0x4639, 0x4638, 0x4637, 0x4636, 0x4635, 0x4634, 0x4633, 0x4632, //  7592
-    0x4631, 0x4630, 0x462f, 0x462e, 0x462d, 0x462c, 0x462b, 0x462a, //  7600
-    0x4629, 0x4628, 0x4627, 0x4626, 0x4625, 0x4624, 0x4623, 0x4622, //  7608
-    0x4621, 0x4620, 0x461f, 0x461e, 0x461d, 0x461b, 0x461a, 0x4619, //  7616
-    0x4618, 0x4617, 0x4616, 0x4615, 0x4614, 0x4613, 0x4612, 0x4611, //  7624
-    0x4610, 0x460f, 0x460e, 0x460d, 0x460c, 0x460b, 0x460a, 0x4609, //  7632
-    0x4608, 0x4607, 0x4606, 0x4605, 0x4604, 0x4603, 0x4602, 0x4601, //  7640
-    0x4600, 0x45ff, 0x45fe, 0x45fd, 0x45fc, 0x45fb, 0x45fa, 0x45f8, //  7648
-    0x45f7, 0x45f6, 0x45f5, 0x45f4, 0x45f3, 0x45f2, 0x45f1, 0x45f0, //  7656
-    0x45ef, 0x45ee, 0x45ed, 0x45ec, 0x45eb, 0x45ea, 0x45e9, 0x45e8, //  7664
-    0x45e7, 0x45e6, 0x45e5, 0x45e4, 0x45e3, 0x45e2, 0x45e1, 0x45e0, //  7672
-    0x45df, 0x45de, 0x45dd, 0x45dc, 0x45db, 0x45da, 0x45d9, 0x45d8, //  7680
-    0x45d7, 0x45d5, 0x45d4, 0x45d3, 0x45d2, 0x45d1, 0x45d0, 0x45cf, //  7688
-    0x45ce, 0x45cd, 0x45cc, 0x45cb, 0x45ca, 0x45c9, 0x45c8, 0x45c7, //  7696
-    0x45c6, 0x45c5, 0x45c4, 0x45c3, 0x45c2, 0x45c1, 0x45c0, 0x45bf, //  7704
-    0x45be, 0x45bd, 0x45bc, 0x45bb, 0x45ba, 0x45b9, 0x45b8, 0x45b7, //  7712
-    0x45b6, 0x45b5, 0x45b4, 0x45b2, 0x45b1, 0x45b0, 0x45af, 0x45ae, //  7720
-    0x45ad, 0x45ac, 0x45ab, 0x45aa, 0x45a9, 0x45a8, 0x45a7, 0x45a6, //  7728
-    0x45a5, 0x45a4, 0x45a3, 0x45a2, 0x45a1, 0x45a0, 0x459f, 0x459e, //  7736
-    0x459d, 0x459c, 0x459b, 0x459a, 0x4599, 0x4598, 0x4597, 0x4596, //  7744
-    0x4595, 0x4594, 0x4593, 0x4592, 0x4591, 0x458f, 0x458e, 0x458d, //  7752
-    0x458c, 0x458b, 0x458a, 0x4589, 0x4588, 0x4587, 0x4586, 0x4585, //  7760
-    0x4584, 0x4583, 0x4582, 0x4581, 0x4580, 0x457f, 0x457e, 0x457d, //  7768
-    0x457c, 0x457b, 0x457a, 0x4579, 0x4578, 0x4577, 0x4576, 0x4575, //  7776
-    0x4574, 0x4573, 0x4572, 0x4571, 0x4570, 0x456f, 0x456e, 0x456c, //  7784
-    0x456b, 0x456a, 0x4569, 0x4568, 0x4567, 0x4566, 0x4565, 0x4564, //  7792
-    0x4563, 0x4562, 0x4561, 0x4560, 0x455f, 0x455e, 0x455d, 0x455c, //  7800
-    0x455b, 0x455a, 0x4559, 0x4558, 0x4557, 0x4556, 0x4555, 0x4554, //  7808
-    0x4553, 0x4552, 0x4551, 0x4550, 0x454f, 0x454e, 0x454d, 0x454c, //  7816
-    0x454b, 0x454a, 0x4548, 0x4547, 0x4546, 0x4545, 0x4544, 0x4543, //  7824
-    0x4542, 0x4541, 0x4540, 0x453f, 0x453e, 0x453d, 0x453c, 0x453b, //  7832
-    0x453a, 0x4539, 0x4538, 0x4537, 0x4536, 0x4535, 0x4534, 0x4533, //  7840
-    0x4532, 0x4531, 0x4530, 0x452f, 0x452e, 0x452d, 0x452c, 0x452b, //  7848
-    0x452a, 0x4529, 0x4528, 0x4527, 0x4525, 0x4524, 0x4523, 0x4522, //  7856
-    0x4521, 0x4520, 0x451f, 0x451e, 0x451d, 0x451c, 0x451b, 0x451a, //  7864
-    0x4519, 0x4518, 0x4517, 0x4516, 0x4515, 0x4514, 0x4513, 0x4512, //  7872
-    0x4511, 0x4510, 0x450f, 0x450e, 0x450d, 0x450c, 0x450b, 0x450a, //  7880
-    0x4509, 0x4508, 0x4507, 0x4506, 0x4505, 0x4504, 0x4502, 0x4501, //  7888
-    0x4500, 0x44ff, 0x44fe, 0x44fd, 0x44fc, 0x44fb, 0x44fa, 0x44f9, //  7896
-    0x44f8, 0x44f7, 0x44f6, 0x44f5, 0x44f4, 0x44f3, 0x44f2, 0x44f1, //  7904
-    0x44f0, 0x44ef, 0x44ee, 0x44ed, 0x44ec, 0x44eb, 0x44ea, 0x44e9, //  7912
-    0x44e8, 0x44e7, 0x44e6, 0x44e5, 0x44e4, 0x44e3, 0x44e2, 0x44e1, //  7920
-    0x44df, 0x44de, 0x44dd, 0x44dc, 0x44db, 0x44da, 0x44d9, 0x44d8, //  7928
-    0x44d7, 0x44d6, 0x44d5, 0x44d4, 0x44d3, 0x44d2, 0x44d1, 0x44d0, //  7936
-    0x44cf, 0x44ce, 0x44cd, 0x44cc, 0x44cb, 0x44ca, 0x44c9, 0x44c8, //  7944
-    0x44c7, 0x44c6, 0x44c5, 0x44c4, 0x44c3, 0x44c2, 0x44c1, 0x44c0, //  7952
-    0x44bf, 0x44be, 0x44bc, 0x44bb, 0x44ba, 0x44b9, 0x44b8, 0x44b7, //  7960
-    0x44b6, 0x44b5, 0x44b4, 0x44b3, 0x44b2, 0x44b1, 0x44b0, 0x44af, //  7968
-    0x44ae, 0x44ad, 0x44ac, 0x44ab, 0x44aa, 0x44a9, 0x44a8, 0x44a7, //  7976
-    0x44a6, 0x44a5, 0x44a4, 0x44a3, 0x44a2, 0x44a1, 0x44a0, 0x449f, //  7984
-    0x449e, 0x449d, 0x449c, 0x449b, 0x4499, 0x4498, 0x4497, 0x4496, //  7992
-    0x4495, 0x4494, 0x4493, 0x4492, 0x4491, 0x4490, 0x448f, 0x448e, //  8000
-    0x448d, 0x448c, 0x448b, 0x448a, 0x4489, 0x4488, 0x4487, 0x4486, //  8008
-    0x4485, 0x4484, 0x4483, 0x4482, 0x4481, 0x4480, 0x447f, 0x447e, //  8016
-    0x447d, 0x447c, 0x447b, 0x447a, 0x4479, 0x4478, 0x4476, 0x4475, //  8024
-    0x4474, 0x4473, 0x4472, 0x4471, 0x4470, 0x446f, 0x446e, 0x446d, //  8032
-    0x446c, 0x446b, 0x446a, 0x4469, 0x4468, 0x4467, 0x4466, 0x4465, //  8040
-    0x4464, 0x4463, 0x4462, 0x4461, 0x4460, 0x445f, 0x445e, 0x445d, //  8048
-    0x445c, 0x445b, 0x445a, 0x4459, 0x4458, 0x4457, 0x4456, 0x4455, //  8056
-    0x4454, 0x4452, 0x4451, 0x4450, 0x444f, 0x444e, 0x444d, 0x444c, //  8064
-    0x444b, 0x444a, 0x4449, 0x4448, 0x4447, 0x4446, 0x4445, 0x4444, //  8072
-    0x4443, 0x4442, 0x4441, 0x4440, 0x443f, 0x443e, 0x443d, 0x443c, //  8080
-    0x443b, 0x443a, 0x4439, 0x4438, 0x4437, 0x4436, 0x4435, 0x4434, //  8088
-    0x4433, 0x4432, 0x4431, 0x442f, 0x442e, 0x442d, 0x442c, 0x442b, //  8096
-    0x442a, 0x4429, 0x4428, 0x4427, 0x4426, 0x4425, 0x4424, 0x4423, //  8104
-    0x4422, 0x4421, 0x4420, 0x441f, 0x441e, 0x441d, 0x441c, 0x441b, //  8112
-    0x441a, 0x4419, 0x4418, 0x4417, 0x4416, 0x4415, 0x4414, 0x4413, //  8120
-    0x4412, 0x4411, 0x4410, 0x440f, 0x440e, 0x440c, 0x440b, 0x440a, //  8128
-    0x4409, 0x4408, 0x4407, 0x4406, 0x4405, 0x4404, 0x4403, 0x4402, //  8136
-    0x4401, 0x4400, 0x43ff, 0x43fe, 0x43fd, 0x43fc, 0x43fb, 0x43fa, //  8144
-    0x43f9, 0x43f8, 0x43f7, 0x43f6, 0x43f5, 0x43f4, 0x43f3, 0x43f2, //  8152
-    0x43f1, 0x43f0, 0x43ef, 0x43ee, 0x43ed, 0x43ec, 0x43eb, 0x43e9, //  8160
-    0x43e8, 0x43e7, 0x43e6, 0x43e5, 0x43e4, 0x43e3, 0x43e2, 0x43e1, //  8168
-    0x43e0, 0x43df, 0x43de, 0x43dd, 0x43dc, 0x43db, 0x43da, 0x43d9, //  8176
-    0x43d8, 0x43d7, 0x43d6, 0x43d5, 0x43d4, 0x43d3, 0x43d2, 0x43d1, //  8184
-    0x43cf, 0x43ce, 0x43cd, 0x43cc, 0x43cb, 0x43ca, 0x43c9, 0x43c8, //  8192
-    0x43c7, 0x43c6, 0x43c5, 0x43c4, 0x43c3, 0x43c2, 0x43c1, 0x43c0, //  8200
-    0x43bf, 0x43be, 0x43bd, 0x43bc, 0x43bb, 0x43ba, 0x43b9, 0x43b8, //  8208
-    0x43b7, 0x43b6, 0x43b5, 0x43b4, 0x43b3, 0x43b2, 0x43b1, 0x43b0, //  8216
-    0x43af, 0x43ae, 0x43ad, 0x43ac, 0x43ab, 0x43aa, 0x43a9, 0x43a8, //  8224
-    0x43a7, 0x43a6, 0x43a5, 0x43a4, 0x43a3, 0x43a2, 0x43a1, 0x43a0, //  8232
-    0x439f, 0x439e, 0x439d, 0x439c, 0x439b, 0x439a, 0x4399, 0x4398, //  8240
-    0x4397, 0x4396, 0x4395, 0x4394, 0x4393, 0x4392, 0x4391, 0x4390, //  8248
-    0x438f, 0x438e, 0x438d, 0x438c, 0x438b, 0x438a, 0x4389, 0x4388, //  8256
-    0x4387, 0x4386, 0x4385, 0x4384, 0x4383, 0x4382, 0x4381, 0x4380, //  8264
-    0x437f, 0x437e, 0x437d, 0x437c, 0x437b, 0x437a, 0x4379, 0x4378, //  8272
-    0x4377, 0x4376, 0x4375, 0x4374, 0x4373, 0x4372, 0x4371, 0x4370, //  8280
-    0x436f, 0x436e, 0x436d, 0x436c, 0x436b, 0x436a, 0x4369, 0x4368, //  8288
-    0x4367, 0x4366, 0x4365, 0x4364, 0x4363, 0x4362, 0x4361, 0x4360, //  8296
-    0x435f, 0x435e, 0x435d, 0x435c, 0x435b, 0x435a, 0x4359, 0x4358, //  8304
-    0x4357, 0x4356, 0x4355, 0x4354, 0x4353, 0x4352, 0x4351, 0x4350, //  8312
-    0x4350, 0x434f, 0x434e, 0x434d, 0x434c, 0x434b, 0x434a, 0x4349, //  8320
-    0x4348, 0x4347, 0x4346, 0x4345, 0x4344, 0x4343, 0x4342, 0x4341, //  8328
-    0x4340, 0x433f, 0x433e, 0x433d, 0x433c, 0x433b, 0x433a, 0x4339, //  8336
-    0x4338, 0x4337, 0x4336, 0x4335, 0x4334, 0x4333, 0x4332, 0x4331, //  8344
-    0x4330, 0x432f, 0x432e, 0x432d, 0x432c, 0x432b, 0x432a, 0x4329, //  8352
-    0x4328, 0x4327, 0x4326, 0x4325, 0x4324, 0x4323, 0x4322, 0x4321, //  8360
-    0x4320, 0x431f, 0x431e, 0x431d, 0x431c, 0x431b, 0x431a, 0x4319, //  8368
-    0x4318, 0x4317, 0x4316, 0x4315, 0x4314, 0x4313, 0x4312, 0x4311, //  8376
-    0x4310, 0x430f, 0x430e, 0x430d, 0x430c, 0x430b, 0x430a, 0x4309, //  8384
-    0x4308, 0x4307, 0x4306, 0x4305, 0x4304, 0x4303, 0x4302, 0x4301, //  8392
-    0x4300, 0x42ff, 0x42fe, 0x42fd, 0x42fc, 0x42fb, 0x42fa, 0x42f9, //  8400
-    0x42f8, 0x42f7, 0x42f6, 0x42f5, 0x42f4, 0x42f3, 0x42f2, 0x42f1, //  8408
-    0x42f0, 0x42ef, 0x42ee, 0x42ed, 0x42ec, 0x42eb, 0x42ea, 0x42e9, //  8416
-    0x42e8, 0x42e7, 0x42e6, 0x42e5, 0x42e4, 0x42e3, 0x42e2, 0x42e1, //  8424
-    0x42e0, 0x42df, 0x42de, 0x42dd, 0x42dc, 0x42db, 0x42da, 0x42d9, //  8432
-    0x42d8, 0x42d7, 0x42d6, 0x42d5, 0x42d4, 0x42d3, 0x42d2, 0x42d1, //  8440
-    0x42d0, 0x42cf, 0x42ce, 0x42cd, 0x42cc, 0x42cb, 0x42ca, 0x42c9, //  8448
-    0x42c8, 0x42c7, 0x42c6, 0x42c5, 0x42c4, 0x42c3, 0x42c2, 0x42c1, //  8456
-    0x42c0, 0x42bf, 0x42be, 0x42bd, 0x42bc, 0x42bb, 0x42ba, 0x42b9, //  8464
-    0x42b8, 0x42b7, 0x42b6, 0x42b5, 0x42b4, 0x42b3, 0x42b2, 0x42b1, //  8472
-    0x42b0, 0x42af, 0x42ae, 0x42ad, 0x42ac, 0x42ab, 0x42aa, 0x42a9, //  8480
-    0x42a8, 0x42a7, 0x42a6, 0x42a6, 0x42a5, 0x42a4, 0x42a3, 0x42a2, //  8488
-    0x42a1, 0x42a0, 0x429f, 0x429e, 0x429d, 0x429c, 0x429b, 0x429a, //  8496
-    0x4299, 0x4298, 0x4297, 0x4296, 0x4295, 0x4294, 0x4293, 0x4292, //  8504
-    0x4291, 0x4290, 0x428f, 0x428e, 0x428d, 0x428c, 0x428b, 0x428a, //  8512
-    0x4289, 0x4288, 0x4287, 0x4286, 0x4285, 0x4284, 0x4283, 0x4282, //  8520
-    0x4281, 0x4280, 0x427f, 0x427e, 0x427d, 0x427c, 0x427b, 0x427a, //  8528
-    0x4279, 0x4278, 0x4277, 0x4276, 0x4275, 0x4274, 0x4273, 0x4272, //  8536
-    0x4271, 0x4270, 0x426f, 0x426e, 0x426d, 0x426c, 0x426b, 0x426a, //  8544
-    0x4269, 0x4268, 0x4267, 0x4266, 0x4265, 0x4264, 0x4263, 0x4262, //  8552
-    0x4261, 0x4260, 0x425f, 0x425e, 0x425d, 0x425c, 0x425b, 0x425a, //  8560
-    0x4259, 0x4258, 0x4257, 0x4256, 0x4255, 0x4254, 0x4253, 0x4252, //  8568
-    0x4251, 0x4250, 0x424f, 0x424e, 0x424d, 0x424c, 0x424b, 0x424a, //  8576
-    0x4249, 0x4248, 0x4247, 0x4246, 0x4245, 0x4244, 0x4243, 0x4242, //  8584
-    0x4241, 0x4240, 0x423f, 0x423e, 0x423d, 0x423c, 0x423b, 0x423a, //  8592
-    0x4239, 0x4238, 0x4237, 0x4236, 0x4235, 0x4234, 0x4233, 0x4232, //  8600
-    0x4231, 0x4230, 0x422f, 0x422e, 0x422d, 0x422c, 0x422b, 0x422a, //  8608
-    0x4229, 0x4228, 0x4227, 0x4226, 0x4225, 0x4224, 0x4223, 0x4222, //  8616
-    0x4221, 0x4220, 0x421f, 0x421e, 0x421d, 0x421c, 0x421b, 0x421a, //  8624
-    0x4219, 0x4218, 0x4217, 0x4216, 0x4215, 0x4214, 0x4213, 0x4212, //  8632
-    0x4211, 0x4210, 0x420f, 0x420e, 0x420d, 0x420c, 0x420b, 0x420a, //  8640
-    0x4209, 0x4208, 0x4207, 0x4206, 0x4205, 0x4204, 0x4203, 0x4202, //  8648
-    0x4201, 0x4200, 0x41ff, 0x41fe, 0x41fd, 0x41fc, 0x41fc, 0x41fb, //  8656
-    0x41fa, 0x41f9, 0x41f8, 0x41f7, 0x41f6, 0x41f5, 0x41f4, 0x41f3, //  8664
-    0x41f2, 0x41f1, 0x41f0, 0x41ef, 0x41ee, 0x41ed, 0x41ec, 0x41eb, //  8672
-    0x41ea, 0x41e9, 0x41e8, 0x41e7, 0x41e6, 0x41e5, 0x41e4, 0x41e3, //  8680
-    0x41e2, 0x41e1, 0x41e0, 0x41df, 0x41de, 0x41dd, 0x41dc, 0x41db, //  8688
-    0x41da, 0x41d9, 0x41d8, 0x41d7, 0x41d6, 0x41d5, 0x41d4, 0x41d3, //  8696
-    0x41d2, 0x41d1, 0x41d0, 0x41cf, 0x41ce, 0x41cd, 0x41cc, 0x41cb, //  8704
-    0x41ca, 0x41c9, 0x41c8, 0x41c7, 0x41c6, 0x41c5, 0x41c4, 0x41c3, //  8712
-    0x41c2, 0x41c1, 0x41c0, 0x41bf, 0x41be, 0x41bd, 0x41bc, 0x41bb, //  8720
-    0x41ba, 0x41b9, 0x41b8, 0x41b7, 0x41b6, 0x41b5, 0x41b4, 0x41b3, //  8728
-    0x41b2, 0x41b1, 0x41b0, 0x41af, 0x41ae, 0x41ad, 0x41ac, 0x41ab, //  8736
-    0x41aa, 0x41a9, 0x41a8, 0x41a7, 0x41a6, 0x41a5, 0x41a4, 0x41a3, //  8744
-    0x41a2, 0x41a1, 0x41a0, 0x419f, 0x419e, 0x419d, 0x419c, 0x419b, //  8752
-    0x419a, 0x4199, 0x4198, 0x4197, 0x4196, 0x4195, 0x4194, 0x4193, //  8760
-    0x4192, 0x4191, 0x4190, 0x418f, 0x418e, 0x418d, 0x418c, 0x418b, //  8768
-    0x418a, 0x4189, 0x4188, 0x4187, 0x4186, 0x4185, 0x4184, 0x4183, //  8776
-    0x4182, 0x4181, 0x4180, 0x417f, 0x417e, 0x417d, 0x417c, 0x417b, //  8784
-    0x417a, 0x4179, 0x4178, 0x4177, 0x4176, 0x4175, 0x4174, 0x4173, //  8792
-    0x4172, 0x4171, 0x4170, 0x416f, 0x416e, 0x416d, 0x416c, 0x416b, //  8800
-    0x416a, 0x4169, 0x4168, 0x4167, 0x4166, 0x4165, 0x4164, 0x4163, //  8808
-    0x4162, 0x4161, 0x4160, 0x415f, 0x415e, 0x415d, 0x415c, 0x415b, //  8816
-    0x415a, 0x4159, 0x4158, 0x4157, 0x4156, 0x4155, 0x4154, 0x4153, //  8824
-    0x4153, 0x4152, 0x4151, 0x4150, 0x414f, 0x414e, 0x414d, 0x414c, //  8832
-    0x414b, 0x414a, 0x4149, 0x4148, 0x4147, 0x4146, 0x4145, 0x4144, //  8840
-    0x4143, 0x4142, 0x4141, 0x4140, 0x413f, 0x413e, 0x413d, 0x413c, //  8848
-    0x413b, 0x413a, 0x4139, 0x4138, 0x4137, 0x4136, 0x4135, 0x4134, //  8856
-    0x4133, 0x4132, 0x4131, 0x4130, 0x412f, 0x412e, 0x412d, 0x412c, //  8864
-    0x412b, 0x412a, 0x4129, 0x4128, 0x4127, 0x4126, 0x4125, 0x4124, //  8872
-    0x4123, 0x4122, 0x4121, 0x4120, 0x411f, 0x411e, 0x411d, 0x411c, //  8880
-    0x411b, 0x411a, 0x4119, 0x4118, 0x4117, 0x4116, 0x4115, 0x4114, //  8888
-    0x4113, 0x4112, 0x4111, 0x4110, 0x410f, 0x410e, 0x410d, 0x410c, //  8896
-    0x410b, 0x410a, 0x4109, 0x4108, 0x4107, 0x4106, 0x4105, 0x4104, //  8904
-    0x4103, 0x4102, 0x4101, 0x4100, 0x40ff, 0x40fe, 0x40fd, 0x40fc, //  8912
-    0x40fb, 0x40fa, 0x40f9, 0x40f8, 0x40f7, 0x40f6, 0x40f5, 0x40f4, //  8920
-    0x40f3, 0x40f2, 0x40f1, 0x40f0, 0x40ef, 0x40ee, 0x40ed, 0x40ec, //  8928
-    0x40eb, 0x40ea, 0x40e9, 0x40e8, 0x40e7, 0x40e6, 0x40e5, 0x40e4, //  8936
-    0x40e3, 0x40e2, 0x40e1, 0x40e0, 0x40df, 0x40de, 0x40dd, 0x40dc, //  8944
-    0x40db, 0x40da, 0x40d9, 0x40d8, 0x40d7, 0x40d6, 0x40d5, 0x40d4, //  8952
-    0x40d3, 0x40d2, 0x40d1, 0x40d0, 0x40cf, 0x40ce, 0x40cd, 0x40cc, //  8960
-    0x40cb, 0x40ca, 0x40c9, 0x40c8, 0x40c7, 0x40c6, 0x40c5, 0x40c4, //  8968
-    0x40c3, 0x40c2, 0x40c1, 0x40c0, 0x40bf, 0x40be, 0x40bd, 0x40bc, //  8976
-    0x40bb, 0x40ba, 0x40b9, 0x40b8, 0x40b7, 0x40b6, 0x40b5, 0x40b4, //  8984
-    0x40b3, 0x40b2, 0x40b1, 0x40b0, 0x40af, 0x40ae, 0x40ad, 0x40ac, //  8992
-    0x40ab, 0x40aa, 0x40a9, 0x40a9, 0x40a8, 0x40a7, 0x40a6, 0x40a5, //  9000
-    0x40a4, 0x40a3, 0x40a2, 0x40a1, 0x40a0, 0x409f, 0x409e, 0x409d, //  9008
-    0x409c, 0x409b, 0x409a, 0x4099, 0x4098, 0x4097, 0x4096, 0x4095, //  9016
-    0x4094, 0x4093, 0x4092, 0x4091, 0x4090, 0x408f, 0x408e, 0x408d, //  9024
-    0x408c, 0x408b, 0x408a, 0x4089, 0x4088, 0x4087, 0x4086, 0x4085, //  9032
-    0x4084, 0x4083, 0x4082, 0x4081, 0x4080, 0x407f, 0x407e, 0x407d, //  9040
-    0x407c, 0x407b, 0x407a, 0x4079, 0x4078, 0x4077, 0x4076, 0x4075, //  9048
-    0x4074, 0x4073, 0x4072, 0x4071, 0x4070, 0x406f, 0x406e, 0x406d, //  9056
-    0x406c, 0x406b, 0x406a, 0x4069, 0x4068, 0x4067, 0x4066, 0x4065, //  9064
-    0x4064, 0x4063, 0x4062, 0x4061, 0x4060, 0x405f, 0x405e, 0x405d, //  9072
-    0x405c, 0x405b, 0x405a, 0x4059, 0x4058, 0x4057, 0x4056, 0x4055, //  9080
-    0x4054, 0x4053, 0x4052, 0x4051, 0x4050, 0x404f, 0x404e, 0x404d, //  9088
-    0x404c, 0x404b, 0x404a, 0x4049, 0x4048, 0x4047, 0x4046, 0x4045, //  9096
-    0x4044, 0x4043, 0x4042, 0x4041, 0x4040, 0x403f, 0x403e, 0x403d, //  9104
-    0x403c, 0x403b, 0x403a, 0x4039, 0x4038, 0x4037, 0x4036, 0x4035, //  9112
-    0x4034, 0x4033, 0x4032, 0x4031, 0x4030, 0x402f, 0x402e, 0x402d, //  9120
-    0x402c, 0x402b, 0x402a, 0x4029, 0x4028, 0x4027, 0x4026, 0x4025, //  9128
-    0x4024, 0x4023, 0x4022, 0x4021, 0x4020, 0x401f, 0x401e, 0x401d, //  9136
-    0x401c, 0x401b, 0x401a, 0x4019, 0x4018, 0x4017, 0x4016, 0x4015, //  9144
-    0x4014, 0x4013, 0x4012, 0x4011, 0x4010, 0x400f, 0x400e, 0x400d, //  9152
-    0x400c, 0x400b, 0x400a, 0x4009, 0x4008, 0x4007, 0x4006, 0x4005, //  9160
-    0x4004, 0x4003, 0x4002, 0x4001, 0x4000, 0x3fff, 0x3fff, 0x3ffe, //  9168
-    0x3ffd, 0x3ffc, 0x3ffb, 0x3ffa, 0x3ff9, 0x3ff8, 0x3ff7, 0x3ff6, //  9176
-    0x3ff5, 0x3ff4, 0x3ff3, 0x3ff2, 0x3ff1, 0x3ff0, 0x3fef, 0x3fee, //  9184
-    0x3fed, 0x3fec, 0x3feb, 0x3fea, 0x3fe9, 0x3fe8, 0x3fe7, 0x3fe6, //  9192
-    0x3fe5, 0x3fe4, 0x3fe3, 0x3fe2, 0x3fe1, 0x3fe0, 0x3fdf, 0x3fde, //  9200
-    0x3fdd, 0x3fdc, 0x3fdb, 0x3fda, 0x3fd9, 0x3fd8, 0x3fd7, 0x3fd6, //  9208
-    0x3fd6, 0x3fd5, 0x3fd4, 0x3fd3, 0x3fd2, 0x3fd1, 0x3fd0, 0x3fd0, //  9216
-    0x3fcf, 0x3fce, 0x3fcd, 0x3fcc, 0x3fcb, 0x3fca, 0x3fc9, 0x3fc8, //  9224
-    0x3fc7, 0x3fc6, 0x3fc5, 0x3fc4, 0x3fc3, 0x3fc2, 0x3fc1, 0x3fc0, //  9232
-    0x3fbf, 0x3fbe, 0x3fbd, 0x3fbc, 0x3fbb, 0x3fba, 0x3fb9, 0x3fb9, //  9240
-    0x3fb8, 0x3fb7, 0x3fb6, 0x3fb5, 0x3fb4, 0x3fb3, 0x3fb2, 0x3fb1, //  9248
-    0x3fb0, 0x3faf, 0x3fae, 0x3fad, 0x3fac, 0x3fab, 0x3faa, 0x3fa9, //  9256
-    0x3fa8, 0x3fa7, 0x3fa6, 0x3fa5, 0x3fa4, 0x3fa3, 0x3fa2, 0x3fa2, //  9264
-    0x3fa1, 0x3fa0, 0x3f9f, 0x3f9e, 0x3f9d, 0x3f9c, 0x3f9b, 0x3f9a, //  9272
-    0x3f99, 0x3f98, 0x3f97, 0x3f96, 0x3f95, 0x3f94, 0x3f93, 0x3f92, //  9280
-    0x3f91, 0x3f90, 0x3f8f, 0x3f8e, 0x3f8d, 0x3f8c, 0x3f8b, 0x3f8a, //  9288
-    0x3f8a, 0x3f89, 0x3f88, 0x3f87, 0x3f86, 0x3f85, 0x3f84, 0x3f83, //  9296
-    0x3f82, 0x3f81, 0x3f80, 0x3f7f, 0x3f7e, 0x3f7d, 0x3f7c, 0x3f7b, //  9304
-    0x3f7a, 0x3f79, 0x3f78, 0x3f77, 0x3f76, 0x3f75, 0x3f74, 0x3f73, //  9312
-    0x3f73, 0x3f72, 0x3f71, 0x3f70, 0x3f6f, 0x3f6e, 0x3f6d, 0x3f6c, //  9320
-    0x3f6b, 0x3f6a, 0x3f69, 0x3f68, 0x3f67, 0x3f66, 0x3f65, 0x3f64, //  9328
-    0x3f63, 0x3f62, 0x3f61, 0x3f60, 0x3f5f, 0x3f5e, 0x3f5d, 0x3f5c, //  9336
-    0x3f5c, 0x3f5b, 0x3f5a, 0x3f59, 0x3f58, 0x3f57, 0x3f56, 0x3f55, //  9344
-    0x3f54, 0x3f53, 0x3f52, 0x3f51, 0x3f50, 0x3f4f, 0x3f4e, 0x3f4d, //  9352
-    0x3f4c, 0x3f4b, 0x3f4a, 0x3f49, 0x3f48, 0x3f47, 0x3f46, 0x3f45, //  9360
-    0x3f44, 0x3f44, 0x3f43, 0x3f42, 0x3f41, 0x3f40, 0x3f3f, 0x3f3e, //  9368
-    0x3f3d, 0x3f3c, 0x3f3b, 0x3f3a, 0x3f39, 0x3f38, 0x3f37, 0x3f36, //  9376
-    0x3f35, 0x3f34, 0x3f33, 0x3f32, 0x3f31, 0x3f30, 0x3f2f, 0x3f2e, //  9384
-    0x3f2d, 0x3f2d, 0x3f2c, 0x3f2b, 0x3f2a, 0x3f29, 0x3f28, 0x3f27, //  9392
-    0x3f26, 0x3f25, 0x3f24, 0x3f23, 0x3f22, 0x3f21, 0x3f20, 0x3f1f, //  9400
-    0x3f1e, 0x3f1d, 0x3f1c, 0x3f1b, 0x3f1a, 0x3f19, 0x3f18, 0x3f17, //  9408
-    0x3f16, 0x3f15, 0x3f15, 0x3f14, 0x3f13, 0x3f12, 0x3f11, 0x3f10, //  9416
-    0x3f0f, 0x3f0e, 0x3f0d, 0x3f0c, 0x3f0b, 0x3f0a, 0x3f09, 0x3f08, //  9424
-    0x3f07, 0x3f06, 0x3f05, 0x3f04, 0x3f03, 0x3f02, 0x3f01, 0x3f00, //  9432
-    0x3eff, 0x3efe, 0x3efe, 0x3efd, 0x3efc, 0x3efb, 0x3efa, 0x3ef9, //  9440
-    0x3ef8, 0x3ef7, 0x3ef6, 0x3ef5, 0x3ef4, 0x3ef3, 0x3ef2, 0x3ef1, //  9448
-    0x3ef0, 0x3eef, 0x3eee, 0x3eed, 0x3eec, 0x3eeb, 0x3eea, 0x3ee9, //  9456
-    0x3ee8, 0x3ee7, 0x3ee7, 0x3ee6, 0x3ee5, 0x3ee4, 0x3ee3, 0x3ee2, //  9464
-    0x3ee1, 0x3ee0, 0x3edf, 0x3ede, 0x3edd, 0x3edc, 0x3edb, 0x3eda, //  9472
-    0x3ed9, 0x3ed8, 0x3ed7, 0x3ed6, 0x3ed5, 0x3ed4, 0x3ed3, 0x3ed2, //  9480
-    0x3ed1, 0x3ed0, 0x3ecf, 0x3ecf, 0x3ece, 0x3ecd, 0x3ecc, 0x3ecb, //  9488
-    0x3eca, 0x3ec9, 0x3ec8, 0x3ec7, 0x3ec6, 0x3ec5, 0x3ec4, 0x3ec3, //  9496
-    0x3ec2, 0x3ec1, 0x3ec0, 0x3ebf, 0x3ebe, 0x3ebd, 0x3ebc, 0x3ebb, //  9504
-    0x3eba, 0x3eb9, 0x3eb8, 0x3eb8, 0x3eb7, 0x3eb6, 0x3eb5, 0x3eb4, //  9512
-    0x3eb3, 0x3eb2, 0x3eb1, 0x3eb0, 0x3eaf, 0x3eae, 0x3ead, 0x3eac, //  9520
-    0x3eab, 0x3eaa, 0x3ea9, 0x3ea8, 0x3ea7, 0x3ea6, 0x3ea5, 0x3ea4, //  9528
-    0x3ea3, 0x3ea2, 0x3ea1, 0x3ea0, 0x3ea0, 0x3e9f, 0x3e9e, 0x3e9d, //  9536
-    0x3e9c, 0x3e9b, 0x3e9a, 0x3e99, 0x3e98, 0x3e97, 0x3e96, 0x3e95, //  9544
-    0x3e94, 0x3e93, 0x3e92, 0x3e91, 0x3e90, 0x3e8f, 0x3e8e, 0x3e8d, //  9552
-    0x3e8c, 0x3e8b, 0x3e8a, 0x3e89, 0x3e89, 0x3e88, 0x3e87, 0x3e86, //  9560
-    0x3e85, 0x3e84, 0x3e83, 0x3e82, 0x3e81, 0x3e80, 0x3e7f, 0x3e7e, //  9568
-    0x3e7d, 0x3e7c, 0x3e7b, 0x3e7a, 0x3e79, 0x3e78, 0x3e77, 0x3e76, //  9576
-    0x3e75, 0x3e74, 0x3e73, 0x3e72, 0x3e72, 0x3e71, 0x3e70, 0x3e6f, //  9584
-    0x3e6e, 0x3e6d, 0x3e6c, 0x3e6b, 0x3e6a, 0x3e69, 0x3e68, 0x3e67, //  9592
-    0x3e66, 0x3e65, 0x3e64, 0x3e63, 0x3e62, 0x3e61, 0x3e60, 0x3e5f, //  9600
-    0x3e5e, 0x3e5d, 0x3e5c, 0x3e5b, 0x3e5a, 0x3e5a, 0x3e59, 0x3e58, //  9608
-    0x3e57, 0x3e56, 0x3e55, 0x3e54, 0x3e53, 0x3e52, 0x3e51, 0x3e50, //  9616
-    0x3e4f, 0x3e4e, 0x3e4d, 0x3e4c, 0x3e4b, 0x3e4a, 0x3e49, 0x3e48, //  9624
-    0x3e47, 0x3e46, 0x3e45, 0x3e44, 0x3e43, 0x3e43, 0x3e42, 0x3e41, //  9632
-    0x3e40, 0x3e3f, 0x3e3e, 0x3e3d, 0x3e3c, 0x3e3b, 0x3e3a, 0x3e39, //  9640
-    0x3e38, 0x3e37, 0x3e36, 0x3e35, 0x3e34, 0x3e33, 0x3e32, 0x3e31, //  9648
-    0x3e30, 0x3e2f, 0x3e2e, 0x3e2d, 0x3e2c, 0x3e2c, 0x3e2b, 0x3e2a, //  9656
-    0x3e29, 0x3e28, 0x3e27, 0x3e26, 0x3e25, 0x3e24, 0x3e23, 0x3e22, //  9664
-    0x3e21, 0x3e20, 0x3e1f, 0x3e1e, 0x3e1d, 0x3e1c, 0x3e1b, 0x3e1a, //  9672
-    0x3e19, 0x3e18, 0x3e17, 0x3e16, 0x3e15, 0x3e14, 0x3e14, 0x3e13, //  9680
-    0x3e12, 0x3e11, 0x3e10, 0x3e0f, 0x3e0e, 0x3e0d, 0x3e0c, 0x3e0b, //  9688
-    0x3e0a, 0x3e09, 0x3e08, 0x3e07, 0x3e06, 0x3e05, 0x3e04, 0x3e03, //  9696
-    0x3e02, 0x3e01, 0x3e00, 0x3dff, 0x3dfe, 0x3dfd, 0x3dfd, 0x3dfc, //  9704
-    0x3dfb, 0x3dfa, 0x3df9, 0x3df8, 0x3df7, 0x3df6, 0x3df5, 0x3df4, //  9712
-    0x3df3, 0x3df2, 0x3df1, 0x3df0, 0x3def, 0x3dee, 0x3ded, 0x3dec, //  9720
-    0x3deb, 0x3dea, 0x3de9, 0x3de8, 0x3de7, 0x3de6, 0x3de5, 0x3de5, //  9728
-    0x3de4, 0x3de3, 0x3de2, 0x3de1, 0x3de0, 0x3ddf, 0x3dde, 0x3ddd, //  9736
-    0x3ddc, 0x3ddb, 0x3dda, 0x3dd9, 0x3dd8, 0x3dd7, 0x3dd6, 0x3dd5, //  9744
-    0x3dd4, 0x3dd3, 0x3dd2, 0x3dd1, 0x3dd0, 0x3dcf, 0x3dce, 0x3dce, //  9752
-    0x3dcd, 0x3dcc, 0x3dcb, 0x3dca, 0x3dc9, 0x3dc8, 0x3dc7, 0x3dc6, //  9760
-    0x3dc5, 0x3dc4, 0x3dc3, 0x3dc2, 0x3dc1, 0x3dc0, 0x3dbf, 0x3dbe, //  9768
-    0x3dbd, 0x3dbc, 0x3dbb, 0x3dba, 0x3db9, 0x3db8, 0x3db7, 0x3db7, //  9776
-    0x3db6, 0x3db5, 0x3db4, 0x3db3, 0x3db2, 0x3db1, 0x3db0, 0x3daf, //  9784
-    0x3dae, 0x3dad, 0x3dac, 0x3dab, 0x3daa, 0x3da9, 0x3da8, 0x3da7, //  9792
-    0x3da6, 0x3da5, 0x3da4, 0x3da3, 0x3da2, 0x3da1, 0x3da0, 0x3d9f, //  9800
-    0x3d9f, 0x3d9e, 0x3d9d, 0x3d9c, 0x3d9b, 0x3d9a, 0x3d99, 0x3d98, //  9808
-    0x3d97, 0x3d96, 0x3d95, 0x3d94, 0x3d93, 0x3d92, 0x3d91, 0x3d90, //  9816
-    0x3d8f, 0x3d8e, 0x3d8d, 0x3d8c, 0x3d8b, 0x3d8a, 0x3d89, 0x3d88, //  9824
-    0x3d88, 0x3d87, 0x3d86, 0x3d85, 0x3d84, 0x3d83, 0x3d82, 0x3d81, //  9832
-    0x3d80, 0x3d7f, 0x3d7e, 0x3d7d, 0x3d7c, 0x3d7b, 0x3d7a, 0x3d79, //  9840
-    0x3d78, 0x3d77, 0x3d76, 0x3d75, 0x3d74, 0x3d73, 0x3d72, 0x3d71, //  9848
-    0x3d71, 0x3d70, 0x3d6f, 0x3d6e, 0x3d6d, 0x3d6c, 0x3d6b, 0x3d6a, //  9856
-    0x3d69, 0x3d68, 0x3d67, 0x3d66, 0x3d65, 0x3d64, 0x3d63, 0x3d62, //  9864
-    0x3d61, 0x3d60, 0x3d5f, 0x3d5e, 0x3d5d, 0x3d5c, 0x3d5b, 0x3d5a, //  9872
-    0x3d59, 0x3d59, 0x3d58, 0x3d57, 0x3d56, 0x3d55, 0x3d54, 0x3d53, //  9880
-    0x3d52, 0x3d51, 0x3d50, 0x3d4f, 0x3d4e, 0x3d4d, 0x3d4c, 0x3d4b, //  9888
-    0x3d4a, 0x3d49, 0x3d48, 0x3d47, 0x3d46, 0x3d45, 0x3d44, 0x3d43, //  9896
-    0x3d42, 0x3d42, 0x3d41, 0x3d40, 0x3d3f, 0x3d3e, 0x3d3d, 0x3d3c, //  9904
-    0x3d3b, 0x3d3a, 0x3d39, 0x3d38, 0x3d37, 0x3d36, 0x3d35, 0x3d34, //  9912
-    0x3d33, 0x3d32, 0x3d31, 0x3d30, 0x3d2f, 0x3d2e, 0x3d2d, 0x3d2c, //  9920
-    0x3d2b, 0x3d2a, 0x3d2a, 0x3d29, 0x3d28, 0x3d27, 0x3d26, 0x3d25, //  9928
-    0x3d24, 0x3d23, 0x3d22, 0x3d21, 0x3d20, 0x3d1f, 0x3d1e, 0x3d1d, //  9936
-    0x3d1c, 0x3d1b, 0x3d1a, 0x3d19, 0x3d18, 0x3d17, 0x3d16, 0x3d15, //  9944
-    0x3d14, 0x3d13, 0x3d13, 0x3d12, 0x3d11, 0x3d10, 0x3d0f, 0x3d0e, //  9952
-    0x3d0d, 0x3d0c, 0x3d0b, 0x3d0a, 0x3d09, 0x3d08, 0x3d07, 0x3d06, //  9960
-    0x3d05, 0x3d04, 0x3d03, 0x3d02, 0x3d01, 0x3d00, 0x3cff, 0x3cfe, //  9968
-    0x3cfd, 0x3cfc, 0x3cfc, 0x3cfb, 0x3cfa, 0x3cf9, 0x3cf8, 0x3cf7, //  9976
-    0x3cf6, 0x3cf5, 0x3cf4, 0x3cf3, 0x3cf2, 0x3cf1, 0x3cf0, 0x3cef, //  9984
-    0x3cee, 0x3ced, 0x3cec, 0x3ceb, 0x3cea, 0x3ce9, 0x3ce8, 0x3ce7, //  9992
-    0x3ce6, 0x3ce5, 0x3ce4, 0x3ce4, 0x3ce3, 0x3ce2, 0x3ce1, 0x3ce0, // 10000
-    0x3cdf, 0x3cde, 0x3cdd, 0x3cdc, 0x3cdb, 0x3cda, 0x3cd9, 0x3cd8, // 10008
-    0x3cd7, 0x3cd6, 0x3cd5, 0x3cd4, 0x3cd3, 0x3cd2, 0x3cd1, 0x3cd0, // 10016
-    0x3ccf, 0x3cce, 0x3ccd, 0x3ccd, 0x3ccc, 0x3ccb, 0x3cca, 0x3cc9, // 10024
-    0x3cc8, 0x3cc7, 0x3cc6, 0x3cc5, 0x3cc4, 0x3cc3, 0x3cc2, 0x3cc1, // 10032
-    0x3cc0, 0x3cbf, 0x3cbe, 0x3cbd, 0x3cbc, 0x3cbb, 0x3cba, 0x3cb9, // 10040
-    0x3cb8, 0x3cb7, 0x3cb6, 0x3cb5, 0x3cb5, 0x3cb4, 0x3cb3, 0x3cb2, // 10048
-    0x3cb1, 0x3cb0, 0x3caf, 0x3cae, 0x3cad, 0x3cac, 0x3cab, 0x3caa, // 10056
-    0x3ca9, 0x3ca8, 0x3ca7, 0x3ca6, 0x3ca5, 0x3ca4, 0x3ca3, 0x3ca2, // 10064
-    0x3ca1, 0x3ca0, 0x3c9f, 0x3c9e, 0x3c9e, 0x3c9d, 0x3c9c, 0x3c9b, // 10072
-    0x3c9a, 0x3c99, 0x3c98, 0x3c97, 0x3c96, 0x3c95, 0x3c94, 0x3c93, // 10080
-    0x3c92, 0x3c91, 0x3c90, 0x3c8f, 0x3c8e, 0x3c8d, 0x3c8c, 0x3c8b, // 10088
-    0x3c8a, 0x3c89, 0x3c88, 0x3c87, 0x3c87, 0x3c86, 0x3c85, 0x3c84, // 10096
-    0x3c83, 0x3c82, 0x3c81, 0x3c80, 0x3c7f, 0x3c7e, 0x3c7d, 0x3c7c, // 10104
-    0x3c7b, 0x3c7a, 0x3c79, 0x3c78, 0x3c77, 0x3c76, 0x3c75, 0x3c74, // 10112
-    0x3c73, 0x3c72, 0x3c71, 0x3c70, 0x3c6f, 0x3c6f, 0x3c6e, 0x3c6d, // 10120
-    0x3c6c, 0x3c6b, 0x3c6a, 0x3c69, 0x3c68, 0x3c67, 0x3c66, 0x3c65, // 10128
-    0x3c64, 0x3c63, 0x3c62, 0x3c61, 0x3c60, 0x3c5f, 0x3c5e, 0x3c5d, // 10136
-    0x3c5c, 0x3c5b, 0x3c5a, 0x3c59, 0x3c58, 0x3c58, 0x3c57, 0x3c56, // 10144
-    0x3c55, 0x3c54, 0x3c53, 0x3c52, 0x3c51, 0x3c50, 0x3c4f, 0x3c4e, // 10152
-    0x3c4d, 0x3c4c, 0x3c4b, 0x3c4a, 0x3c49, 0x3c48, 0x3c47, 0x3c46, // 10160
-    0x3c45, 0x3c44, 0x3c43, 0x3c42, 0x3c41, 0x3c41, 0x3c40, 0x3c3f, // 10168
-    0x3c3e, 0x3c3d, 0x3c3c, 0x3c3b, 0x3c3a, 0x3c39, 0x3c38, 0x3c37, // 10176
-    0x3c36, 0x3c35, 0x3c34, 0x3c33, 0x3c32, 0x3c31, 0x3c30, 0x3c2f, // 10184
-    0x3c2e, 0x3c2d, 0x3c2c, 0x3c2b, 0x3c2a, 0x3c29, 0x3c29, 0x3c28, // 10192
-    0x3c27, 0x3c26, 0x3c25, 0x3c24, 0x3c23, 0x3c22, 0x3c21, 0x3c20, // 10200
-    0x3c1f, 0x3c1e, 0x3c1d, 0x3c1c, 0x3c1b, 0x3c1a, 0x3c19, 0x3c18, // 10208
-    0x3c17, 0x3c16, 0x3c15, 0x3c14, 0x3c13, 0x3c12, 0x3c12, 0x3c11, // 10216
-    0x3c10, 0x3c0f, 0x3c0e, 0x3c0d, 0x3c0c, 0x3c0b, 0x3c0a, 0x3c09, // 10224
-    0x3c08, 0x3c07, 0x3c06, 0x3c05, 0x3c04, 0x3c03, 0x3c02, 0x3c01, // 10232
-    0x3c01, 0x3c00, 0x3bff, 0x3bfe, 0x3bfd, 0x3bfc, 0x3bfb, 0x3bfa, // 10240
-    0x3bf9, 0x3bf8, 0x3bf8, 0x3bf7, 0x3bf6, 0x3bf5, 0x3bf4, 0x3bf3, // 10248
-    0x3bf2, 0x3bf1, 0x3bf0, 0x3bef, 0x3bee, 0x3bed, 0x3bec, 0x3bec, // 10256
-    0x3beb, 0x3bea, 0x3be9, 0x3be8, 0x3be7, 0x3be6, 0x3be5, 0x3be4, // 10264
-    0x3be3, 0x3be2, 0x3be1, 0x3be0, 0x3bdf, 0x3bdf, 0x3bde, 0x3bdd, // 10272
-    0x3bdc, 0x3bdb, 0x3bda, 0x3bd9, 0x3bd8, 0x3bd7, 0x3bd6, 0x3bd5, // 10280
-    0x3bd4, 0x3bd3, 0x3bd3, 0x3bd2, 0x3bd1, 0x3bd0, 0x3bcf, 0x3bce, // 10288
-    0x3bcd, 0x3bcc, 0x3bcb, 0x3bca, 0x3bc9, 0x3bc8, 0x3bc7, 0x3bc7, // 10296
-    0x3bc6, 0x3bc5, 0x3bc4, 0x3bc3, 0x3bc2, 0x3bc1, 0x3bc0, 0x3bbf, // 10304
-    0x3bbe, 0x3bbd, 0x3bbc, 0x3bbb, 0x3bbb, 0x3bba, 0x3bb9, 0x3bb8, // 10312
-    0x3bb7, 0x3bb6, 0x3bb5, 0x3bb4, 0x3bb3, 0x3bb2, 0x3bb1, 0x3bb0, // 10320
-    0x3baf, 0x3baf, 0x3bae, 0x3bad, 0x3bac, 0x3bab, 0x3baa, 0x3ba9, // 10328
-    0x3ba8, 0x3ba7, 0x3ba6, 0x3ba5, 0x3ba4, 0x3ba3, 0x3ba3, 0x3ba2, // 10336
-    0x3ba1, 0x3ba0, 0x3b9f, 0x3b9e, 0x3b9d, 0x3b9c, 0x3b9b, 0x3b9a, // 10344
-    0x3b99, 0x3b98, 0x3b97, 0x3b97, 0x3b96, 0x3b95, 0x3b94, 0x3b93, // 10352
-    0x3b92, 0x3b91, 0x3b90, 0x3b8f, 0x3b8e, 0x3b8d, 0x3b8c, 0x3b8b, // 10360
-    0x3b8b, 0x3b8a, 0x3b89, 0x3b88, 0x3b87, 0x3b86, 0x3b85, 0x3b84, // 10368
-    0x3b83, 0x3b82, 0x3b81, 0x3b80, 0x3b7f, 0x3b7e, 0x3b7e, 0x3b7d, // 10376
-    0x3b7c, 0x3b7b, 0x3b7a, 0x3b79, 0x3b78, 0x3b77, 0x3b76, 0x3b75, // 10384
-    0x3b74, 0x3b73, 0x3b72, 0x3b72, 0x3b71, 0x3b70, 0x3b6f, 0x3b6e, // 10392
-    0x3b6d, 0x3b6c, 0x3b6b, 0x3b6a, 0x3b69, 0x3b68, 0x3b67, 0x3b66, // 10400
-    0x3b66, 0x3b65, 0x3b64, 0x3b63, 0x3b62, 0x3b61, 0x3b60, 0x3b5f, // 10408
-    0x3b5e, 0x3b5d, 0x3b5c, 0x3b5b, 0x3b5a, 0x3b5a, 0x3b59, 0x3b58, // 10416
-    0x3b57, 0x3b56, 0x3b55, 0x3b54, 0x3b53, 0x3b52, 0x3b51, 0x3b50, // 10424
-    0x3b4f, 0x3b4e, 0x3b4e, 0x3b4d, 0x3b4c, 0x3b4b, 0x3b4a, 0x3b49, // 10432
-    0x3b48, 0x3b47, 0x3b46, 0x3b45, 0x3b44, 0x3b43, 0x3b42, 0x3b42, // 10440
-    0x3b41, 0x3b40, 0x3b3f, 0x3b3e, 0x3b3d, 0x3b3c, 0x3b3b, 0x3b3a, // 10448
-    0x3b39, 0x3b38, 0x3b37, 0x3b36, 0x3b36, 0x3b35, 0x3b34, 0x3b33, // 10456
-    0x3b32, 0x3b31, 0x3b30, 0x3b2f, 0x3b2e, 0x3b2d, 0x3b2c, 0x3b2b, // 10464
-    0x3b2a, 0x3b29, 0x3b29, 0x3b28, 0x3b27, 0x3b26, 0x3b25, 0x3b24, // 10472
-    0x3b23, 0x3b22, 0x3b21, 0x3b20, 0x3b1f, 0x3b1e, 0x3b1d, 0x3b1d, // 10480
-    0x3b1c, 0x3b1b, 0x3b1a, 0x3b19, 0x3b18, 0x3b17, 0x3b16, 0x3b15, // 10488
-    0x3b14, 0x3b13, 0x3b12, 0x3b11, 0x3b11, 0x3b10, 0x3b0f, 0x3b0e, // 10496
-    0x3b0d, 0x3b0c, 0x3b0b, 0x3b0a, 0x3b09, 0x3b08, 0x3b07, 0x3b06, // 10504
-    0x3b05, 0x3b05, 0x3b04, 0x3b03, 0x3b02, 0x3b01, 0x3b00, 0x3aff, // 10512
-    0x3afe, 0x3afd, 0x3afc, 0x3afb, 0x3afa, 0x3af9, 0x3af9, 0x3af8, // 10520
-    0x3af7, 0x3af6, 0x3af5, 0x3af4, 0x3af3, 0x3af2, 0x3af1, 0x3af0, // 10528
-    0x3aef, 0x3aee, 0x3aed, 0x3aed, 0x3aec, 0x3aeb, 0x3aea, 0x3ae9, // 10536
-    0x3ae8, 0x3ae7, 0x3ae6, 0x3ae5, 0x3ae4, 0x3ae3, 0x3ae2, 0x3ae1, // 10544
-    0x3ae1, 0x3ae0, 0x3adf, 0x3ade, 0x3add, 0x3adc, 0x3adb, 0x3ada, // 10552
-    0x3ad9, 0x3ad8, 0x3ad7, 0x3ad6, 0x3ad5, 0x3ad5, 0x3ad4, 0x3ad3, // 10560
-    0x3ad2, 0x3ad1, 0x3ad0, 0x3acf, 0x3ace, 0x3acd, 0x3acc, 0x3acb, // 10568
-    0x3aca, 0x3ac9, 0x3ac8, 0x3ac8, 0x3ac7, 0x3ac6, 0x3ac5, 0x3ac4, // 10576
-    0x3ac3, 0x3ac2, 0x3ac1, 0x3ac0, 0x3abf, 0x3abe, 0x3abd, 0x3abc, // 10584
-    0x3abc, 0x3abb, 0x3aba, 0x3ab9, 0x3ab8, 0x3ab7, 0x3ab6, 0x3ab5, // 10592
-    0x3ab4, 0x3ab3, 0x3ab2, 0x3ab1, 0x3ab0, 0x3ab0, 0x3aaf, 0x3aae, // 10600
-    0x3aad, 0x3aac, 0x3aab, 0x3aaa, 0x3aa9, 0x3aa8, 0x3aa7, 0x3aa6, // 10608
-    0x3aa5, 0x3aa4, 0x3aa4, 0x3aa3, 0x3aa2, 0x3aa1, 0x3aa0, 0x3a9f, // 10616
-    0x3a9e, 0x3a9d, 0x3a9c, 0x3a9b, 0x3a9a, 0x3a99, 0x3a98, 0x3a98, // 10624
-    0x3a97, 0x3a96, 0x3a95, 0x3a94, 0x3a93, 0x3a92, 0x3a91, 0x3a90, // 10632
-    0x3a8f, 0x3a8e, 0x3a8d, 0x3a8c, 0x3a8c, 0x3a8b, 0x3a8a, 0x3a89, // 10640
-    0x3a88, 0x3a87, 0x3a86, 0x3a85, 0x3a84, 0x3a83, 0x3a82, 0x3a81, // 10648
-    0x3a80, 0x3a80, 0x3a7f, 0x3a7e, 0x3a7d, 0x3a7c, 0x3a7b, 0x3a7a, // 10656
-    0x3a79, 0x3a78, 0x3a77, 0x3a76, 0x3a75, 0x3a74, 0x3a74, 0x3a73, // 10664
-    0x3a72, 0x3a71, 0x3a70, 0x3a6f, 0x3a6e, 0x3a6d, 0x3a6c, 0x3a6b, // 10672
-    0x3a6a, 0x3a69, 0x3a68, 0x3a67, 0x3a67, 0x3a66, 0x3a65, 0x3a64, // 10680
-    0x3a63, 0x3a62, 0x3a61, 0x3a60, 0x3a5f, 0x3a5e, 0x3a5d, 0x3a5c, // 10688
-    0x3a5b, 0x3a5b, 0x3a5a, 0x3a59, 0x3a58, 0x3a57, 0x3a56, 0x3a55, // 10696
-    0x3a54, 0x3a53, 0x3a52, 0x3a51, 0x3a50, 0x3a4f, 0x3a4f, 0x3a4e, // 10704
-    0x3a4d, 0x3a4c, 0x3a4b, 0x3a4a, 0x3a49, 0x3a48, 0x3a47, 0x3a46, // 10712
-    0x3a45, 0x3a44, 0x3a43, 0x3a43, 0x3a42, 0x3a41, 0x3a40, 0x3a3f, // 10720
-    0x3a3e, 0x3a3d, 0x3a3c, 0x3a3b, 0x3a3a, 0x3a39, 0x3a38, 0x3a37, // 10728
-    0x3a37, 0x3a36, 0x3a35, 0x3a34, 0x3a33, 0x3a32, 0x3a31, 0x3a30, // 10736
-    0x3a2f, 0x3a2e, 0x3a2d, 0x3a2c, 0x3a2b, 0x3a2b, 0x3a2a, 0x3a29, // 10744
-    0x3a28, 0x3a27, 0x3a26, 0x3a25, 0x3a24, 0x3a23, 0x3a22, 0x3a21, // 10752
-    0x3a20, 0x3a1f, 0x3a1f, 0x3a1e, 0x3a1d, 0x3a1c, 0x3a1b, 0x3a1a, // 10760
-    0x3a19, 0x3a18, 0x3a17, 0x3a16, 0x3a15, 0x3a14, 0x3a13, 0x3a13, // 10768
-    0x3a12, 0x3a11, 0x3a10, 0x3a0f, 0x3a0e, 0x3a0d, 0x3a0c, 0x3a0b, // 10776
-    0x3a0a, 0x3a09, 0x3a08, 0x3a07, 0x3a06, 0x3a06, 0x3a05, 0x3a04, // 10784
-    0x3a03, 0x3a02, 0x3a01, 0x3a00, 0x39ff, 0x39fe, 0x39fd, 0x39fc, // 10792
-    0x39fb, 0x39fa, 0x39fa, 0x39f9, 0x39f8, 0x39f7, 0x39f6, 0x39f5, // 10800
-    0x39f4, 0x39f3, 0x39f2, 0x39f1, 0x39f0, 0x39ef, 0x39ee, 0x39ee, // 10808
-    0x39ed, 0x39ec, 0x39eb, 0x39ea, 0x39e9, 0x39e8, 0x39e7, 0x39e6, // 10816
-    0x39e5, 0x39e4, 0x39e3, 0x39e2, 0x39e2, 0x39e1, 0x39e0, 0x39df, // 10824
-    0x39de, 0x39dd, 0x39dc, 0x39db, 0x39da, 0x39d9, 0x39d8, 0x39d7, // 10832
-    0x39d6, 0x39d6, 0x39d5, 0x39d4, 0x39d3, 0x39d2, 0x39d1, 0x39d0, // 10840
-    0x39cf, 0x39ce, 0x39cd, 0x39cc, 0x39cb, 0x39ca, 0x39ca, 0x39c9, // 10848
-    0x39c8, 0x39c7, 0x39c6, 0x39c5, 0x39c4, 0x39c3, 0x39c2, 0x39c1, // 10856
-    0x39c0, 0x39bf, 0x39be, 0x39be, 0x39bd, 0x39bc, 0x39bb, 0x39ba, // 10864
-    0x39b9, 0x39b8, 0x39b7, 0x39b6, 0x39b5, 0x39b4, 0x39b3, 0x39b2, // 10872
-    0x39b2, 0x39b1, 0x39b0, 0x39af, 0x39ae, 0x39ad, 0x39ac, 0x39ab, // 10880
-    0x39aa, 0x39a9, 0x39a8, 0x39a7, 0x39a6, 0x39a5, 0x39a5, 0x39a4, // 10888
-    0x39a3, 0x39a2, 0x39a1, 0x39a0, 0x399f, 0x399e, 0x399d, 0x399c, // 10896
-    0x399b, 0x399a, 0x3999, 0x3999, 0x3998, 0x3997, 0x3996, 0x3995, // 10904
-    0x3994, 0x3993, 0x3992, 0x3991, 0x3990, 0x398f, 0x398e, 0x398d, // 10912
-    0x398d, 0x398c, 0x398b, 0x398a, 0x3989, 0x3988, 0x3987, 0x3986, // 10920
-    0x3985, 0x3984, 0x3983, 0x3982, 0x3981, 0x3981, 0x3980, 0x397f, // 10928
-    0x397e, 0x397d, 0x397c, 0x397b, 0x397a, 0x3979, 0x3978, 0x3977, // 10936
-    0x3976, 0x3975, 0x3975, 0x3974, 0x3973, 0x3972, 0x3971, 0x3970, // 10944
-    0x396f, 0x396e, 0x396d, 0x396c, 0x396b, 0x396a, 0x3969, 0x3969, // 10952
-    0x3968, 0x3967, 0x3966, 0x3965, 0x3964, 0x3963, 0x3962, 0x3961, // 10960
-    0x3960, 0x395f, 0x395e, 0x395d, 0x395d, 0x395c, 0x395b, 0x395a, // 10968
-    0x3959, 0x3958, 0x3957, 0x3956, 0x3955, 0x3954, 0x3953, 0x3952, // 10976
-    0x3951, 0x3950, 0x3950, 0x394f, 0x394e, 0x394d, 0x394c, 0x394b, // 10984
-    0x394a, 0x3949, 0x3948, 0x3947, 0x3946, 0x3945, 0x3944, 0x3944, // 10992
-    0x3943, 0x3942, 0x3941, 0x3940, 0x393f, 0x393e, 0x393d, 0x393c, // 11000
-    0x393b, 0x393a, 0x3939, 0x3938, 0x3938, 0x3937, 0x3936, 0x3935, // 11008
-    0x3934, 0x3933, 0x3932, 0x3931, 0x3930, 0x392f, 0x392e, 0x392d, // 11016
-    0x392c, 0x392c, 0x392b, 0x392a, 0x3929, 0x3928, 0x3927, 0x3926, // 11024
-    0x3925, 0x3924, 0x3923, 0x3922, 0x3921, 0x3920, 0x3920, 0x391f, // 11032
-    0x391e, 0x391d, 0x391c, 0x391b, 0x391a, 0x3919, 0x3918, 0x3917, // 11040
-    0x3916, 0x3915, 0x3914, 0x3914, 0x3913, 0x3912, 0x3911, 0x3910, // 11048
-    0x390f, 0x390e, 0x390d, 0x390c, 0x390b, 0x390a, 0x3909, 0x3908, // 11056
-    0x3908, 0x3907, 0x3906, 0x3905, 0x3904, 0x3903, 0x3902, 0x3901, // 11064
-    0x3900, 0x38ff, 0x38fe, 0x38fd, 0x38fc, 0x38fc, 0x38fb, 0x38fa, // 11072
-    0x38f9, 0x38f8, 0x38f7, 0x38f6, 0x38f5, 0x38f4, 0x38f3, 0x38f2, // 11080
-    0x38f1, 0x38f0, 0x38ef, 0x38ef, 0x38ee, 0x38ed, 0x38ec, 0x38eb, // 11088
-    0x38ea, 0x38e9, 0x38e8, 0x38e7, 0x38e6, 0x38e5, 0x38e4, 0x38e3, // 11096
-    0x38e3, 0x38e2, 0x38e1, 0x38e0, 0x38df, 0x38de, 0x38dd, 0x38dc, // 11104
-    0x38db, 0x38da, 0x38d9, 0x38d8, 0x38d7, 0x38d7, 0x38d6, 0x38d5, // 11112
-    0x38d4, 0x38d3, 0x38d2, 0x38d1, 0x38d0, 0x38cf, 0x38ce, 0x38cd, // 11120
-    0x38cc, 0x38cb, 0x38cb, 0x38ca, 0x38c9, 0x38c8, 0x38c7, 0x38c6, // 11128
-    0x38c5, 0x38c4, 0x38c3, 0x38c2, 0x38c1, 0x38c0, 0x38bf, 0x38bf, // 11136
-    0x38be, 0x38bd, 0x38bc, 0x38bb, 0x38ba, 0x38b9, 0x38b8, 0x38b7, // 11144
-    0x38b6, 0x38b5, 0x38b4, 0x38b3, 0x38b3, 0x38b2, 0x38b1, 0x38b0, // 11152
-    0x38af, 0x38ae, 0x38ad, 0x38ac, 0x38ab, 0x38aa, 0x38a9, 0x38a8, // 11160
-    0x38a7, 0x38a7, 0x38a6, 0x38a5, 0x38a4, 0x38a3, 0x38a2, 0x38a1, // 11168
-    0x38a0, 0x389f, 0x389e, 0x389d, 0x389c, 0x389b, 0x389b, 0x389a, // 11176
-    0x3899, 0x3898, 0x3897, 0x3896, 0x3895, 0x3894, 0x3893, 0x3892, // 11184
-    0x3891, 0x3890, 0x388f, 0x388e, 0x388e, 0x388d, 0x388c, 0x388b, // 11192
-    0x388a, 0x3889, 0x3888, 0x3887, 0x3886, 0x3885, 0x3884, 0x3883, // 11200
-    0x3882, 0x3882, 0x3881, 0x3880, 0x387f, 0x387e, 0x387d, 0x387c, // 11208
-    0x387b, 0x387a, 0x3879, 0x3878, 0x3877, 0x3876, 0x3876, 0x3875, // 11216
-    0x3874, 0x3873, 0x3872, 0x3871, 0x3870, 0x386f, 0x386e, 0x386d, // 11224
-    0x386c, 0x386b, 0x386a, 0x386a, 0x3869, 0x3868, 0x3867, 0x3866, // 11232
-    0x3865, 0x3864, 0x3863, 0x3862, 0x3861, 0x3860, 0x385f, 0x385e, // 11240
-    0x385e, 0x385d, 0x385c, 0x385b, 0x385a, 0x3859, 0x3858, 0x3857, // 11248
-    0x3856, 0x3855, 0x3854, 0x3853, 0x3852, 0x3852, 0x3851, 0x3850, // 11256
-    0x384f, 0x384e, 0x384d, 0x384c, 0x384b, 0x384a, 0x3849, 0x3849, // 11264
-    0x3848, 0x3847, 0x3846, 0x3845, 0x3844, 0x3843, 0x3842, 0x3841, // 11272
-    0x3840, 0x3840, 0x383f, 0x383e, 0x383d, 0x383c, 0x383b, 0x383a, // 11280
-    0x3839, 0x3838, 0x3838, 0x3837, 0x3836, 0x3835, 0x3834, 0x3833, // 11288
-    0x3832, 0x3831, 0x3830, 0x3830, 0x382f, 0x382e, 0x382d, 0x382c, // 11296
-    0x382b, 0x382a, 0x3829, 0x3828, 0x3827, 0x3827, 0x3826, 0x3825, // 11304
-    0x3824, 0x3823, 0x3822, 0x3821, 0x3820, 0x381f, 0x381f, 0x381e, // 11312
-    0x381d, 0x381c, 0x381b, 0x381a, 0x3819, 0x3818, 0x3817, 0x3817, // 11320
-    0x3816, 0x3815, 0x3814, 0x3813, 0x3812, 0x3811, 0x3810, 0x380f, // 11328
-    0x380e, 0x380e, 0x380d, 0x380c, 0x380b, 0x380a, 0x3809, 0x3808, // 11336
-    0x3807, 0x3806, 0x3806, 0x3805, 0x3804, 0x3803, 0x3802, 0x3801, // 11344
-    0x3800, 0x37ff, 0x37fe, 0x37fe, 0x37fd, 0x37fc, 0x37fb, 0x37fa, // 11352
-    0x37f9, 0x37f8, 0x37f7, 0x37f6, 0x37f5, 0x37f5, 0x37f4, 0x37f3, // 11360
-    0x37f2, 0x37f1, 0x37f0, 0x37ef, 0x37ee, 0x37ed, 0x37ed, 0x37ec, // 11368
-    0x37eb, 0x37ea, 0x37e9, 0x37e8, 0x37e7, 0x37e6, 0x37e5, 0x37e5, // 11376
-    0x37e4, 0x37e3, 0x37e2, 0x37e1, 0x37e0, 0x37df, 0x37de, 0x37dd, // 11384
-    0x37dd, 0x37dc, 0x37db, 0x37da, 0x37d9, 0x37d8, 0x37d7, 0x37d6, // 11392
-    0x37d5, 0x37d4, 0x37d4, 0x37d3, 0x37d2, 0x37d1, 0x37d0, 0x37cf, // 11400
-    0x37ce, 0x37cd, 0x37cc, 0x37cc, 0x37cb, 0x37ca, 0x37c9, 0x37c8, // 11408
-    0x37c7, 0x37c6, 0x37c5, 0x37c4, 0x37c4, 0x37c3, 0x37c2, 0x37c1, // 11416
-    0x37c0, 0x37bf, 0x37be, 0x37bd, 0x37bc, 0x37bb, 0x37bb, 0x37ba, // 11424
-    0x37b9, 0x37b8, 0x37b7, 0x37b6, 0x37b5, 0x37b4, 0x37b3, 0x37b3, // 11432
-    0x37b2, 0x37b1, 0x37b0, 0x37af, 0x37ae, 0x37ad, 0x37ac, 0x37ab, // 11440
-    0x37ab, 0x37aa, 0x37a9, 0x37a8, 0x37a7, 0x37a6, 0x37a5, 0x37a4, // 11448
-    0x37a3, 0x37a2, 0x37a2, 0x37a1, 0x37a0, 0x379f, 0x379e, 0x379d, // 11456
-    0x379c, 0x379b, 0x379a, 0x379a, 0x3799, 0x3798, 0x3797, 0x3796, // 11464
-    0x3795, 0x3794, 0x3793, 0x3792, 0x3792, 0x3791, 0x3790, 0x378f, // 11472
-    0x378e, 0x378d, 0x378c, 0x378b, 0x378a, 0x3789, 0x3789, 0x3788, // 11480
-    0x3787, 0x3786, 0x3785, 0x3784, 0x3783, 0x3782, 0x3781, 0x3781, // 11488
-    0x3780, 0x377f, 0x377e, 0x377d, 0x377c, 0x377b, 0x377a, 0x3779, // 11496
-    0x3779, 0x3778, 0x3777, 0x3776, 0x3775, 0x3774, 0x3773, 0x3772, // 11504
-    0x3771, 0x3770, 0x3770, 0x376f, 0x376e, 0x376d, 0x376c, 0x376b, // 11512
-    0x376a, 0x3769, 0x3768, 0x3768, 0x3767, 0x3766, 0x3765, 0x3764, // 11520
-    0x3763, 0x3762, 0x3761, 0x3760, 0x3760, 0x375f, 0x375e, 0x375d, // 11528
-    0x375c, 0x375b, 0x375a, 0x3759, 0x3758, 0x3758, 0x3757, 0x3756, // 11536
-    0x3755, 0x3754, 0x3753, 0x3752, 0x3751, 0x3750, 0x374f, 0x374f, // 11544
-    0x374e, 0x374d, 0x374c, 0x374b, 0x374a, 0x3749, 0x3748, 0x3747, // 11552
-    0x3747, 0x3746, 0x3745, 0x3744, 0x3743, 0x3742, 0x3741, 0x3740, // 11560
-    0x373f, 0x373f, 0x373e, 0x373d, 0x373c, 0x373b, 0x373a, 0x3739, // 11568
-    0x3738, 0x3737, 0x3736, 0x3736, 0x3735, 0x3734, 0x3733, 0x3732, // 11576
-    0x3731, 0x3730, 0x372f, 0x372e, 0x372e, 0x372d, 0x372c, 0x372b, // 11584
-    0x372a, 0x3729, 0x3728, 0x3727, 0x3726, 0x3726, 0x3725, 0x3724, // 11592
-    0x3723, 0x3722, 0x3721, 0x3720, 0x371f, 0x371e, 0x371d, 0x371d, // 11600
-    0x371c, 0x371b, 0x371a, 0x3719, 0x3718, 0x3717, 0x3716, 0x3715, // 11608
-    0x3715, 0x3714, 0x3713, 0x3712, 0x3711, 0x3710, 0x370f, 0x370e, // 11616
-    0x370d, 0x370d, 0x370c, 0x370b, 0x370a, 0x3709, 0x3708, 0x3707, // 11624
-    0x3706, 0x3705, 0x3704, 0x3704, 0x3703, 0x3702, 0x3701, 0x3700, // 11632
-    0x36ff, 0x36fe, 0x36fd, 0x36fc, 0x36fc, 0x36fb, 0x36fa, 0x36f9, // 11640
-    0x36f8, 0x36f7, 0x36f6, 0x36f5, 0x36f4, 0x36f4, 0x36f3, 0x36f2, // 11648
-    0x36f1, 0x36f0, 0x36ef, 0x36ee, 0x36ed, 0x36ec, 0x36ec, 0x36eb, // 11656
-    0x36ea, 0x36e9, 0x36e8, 0x36e7, 0x36e6, 0x36e5, 0x36e4, 0x36e3, // 11664
-    0x36e3, 0x36e2, 0x36e1, 0x36e0, 0x36df, 0x36de, 0x36dd, 0x36dc, // 11672
-    0x36db, 0x36db, 0x36da, 0x36d9, 0x36d8, 0x36d7, 0x36d6, 0x36d5, // 11680
-    0x36d4, 0x36d3, 0x36d3, 0x36d2, 0x36d1, 0x36d0, 0x36cf, 0x36ce, // 11688
-    0x36cd, 0x36cc, 0x36cb, 0x36ca, 0x36ca, 0x36c9, 0x36c8, 0x36c7, // 11696
-    0x36c6, 0x36c5, 0x36c4, 0x36c3, 0x36c2, 0x36c2, 0x36c1, 0x36c0, // 11704
-    0x36bf, 0x36be, 0x36bd, 0x36bc, 0x36bb, 0x36ba, 0x36ba, 0x36b9, // 11712
-    0x36b8, 0x36b7, 0x36b6, 0x36b5, 0x36b4, 0x36b3, 0x36b2, 0x36b1, // 11720
-    0x36b1, 0x36b0, 0x36af, 0x36ae, 0x36ad, 0x36ac, 0x36ab, 0x36aa, // 11728
-    0x36a9, 0x36a9, 0x36a8, 0x36a7, 0x36a6, 0x36a5, 0x36a4, 0x36a3, // 11736
-    0x36a2, 0x36a1, 0x36a1, 0x36a0, 0x369f, 0x369e, 0x369d, 0x369c, // 11744
-    0x369b, 0x369a, 0x3699, 0x3698, 0x3698, 0x3697, 0x3696, 0x3695, // 11752
-    0x3694, 0x3693, 0x3692, 0x3691, 0x3690, 0x3690, 0x368f, 0x368e, // 11760
-    0x368d, 0x368c, 0x368b, 0x368a, 0x3689, 0x3688, 0x3688, 0x3687, // 11768
-    0x3686, 0x3685, 0x3684, 0x3683, 0x3682, 0x3681, 0x3680, 0x3680, // 11776
-    0x367f, 0x367e, 0x367d, 0x367c, 0x367b, 0x367a, 0x3679, 0x3678, // 11784
-    0x3677, 0x3677, 0x3676, 0x3675, 0x3674, 0x3673, 0x3672, 0x3671, // 11792
-    0x3670, 0x366f, 0x366f, 0x366e, 0x366d, 0x366c, 0x366b, 0x366a, // 11800
-    0x3669, 0x3668, 0x3667, 0x3667, 0x3666, 0x3665, 0x3664, 0x3663, // 11808
-    0x3662, 0x3661, 0x3660, 0x365f, 0x365e, 0x365e, 0x365d, 0x365c, // 11816
-    0x365b, 0x365a, 0x3659, 0x3658, 0x3657, 0x3656, 0x3656, 0x3655, // 11824
-    0x3654, 0x3653, 0x3652, 0x3651, 0x3650, 0x364f, 0x364e, 0x364e, // 11832
-    0x364d, 0x364c, 0x364b, 0x364a, 0x3649, 0x3648, 0x3647, 0x3646, // 11840
-    0x3645, 0x3645, 0x3644, 0x3643, 0x3642, 0x3641, 0x3640, 0x363f, // 11848
-    0x363e, 0x363d, 0x363d, 0x363c, 0x363b, 0x363a, 0x3639, 0x3638, // 11856
-    0x3637, 0x3636, 0x3635, 0x3635, 0x3634, 0x3633, 0x3632, 0x3631, // 11864
-    0x3630, 0x362f, 0x362e, 0x362d, 0x362c, 0x362c, 0x362b, 0x362a, // 11872
-    0x3629, 0x3628, 0x3627, 0x3626, 0x3625, 0x3624, 0x3624, 0x3623, // 11880
-    0x3622, 0x3621, 0x3620, 0x361f, 0x361e, 0x361d, 0x361c, 0x361c, // 11888
-    0x361b, 0x361a, 0x3619, 0x3618, 0x3617, 0x3616, 0x3615, 0x3614, // 11896
-    0x3614, 0x3613, 0x3612, 0x3611, 0x3610, 0x360f, 0x360e, 0x360d, // 11904
-    0x360c, 0x360b, 0x360b, 0x360a, 0x3609, 0x3608, 0x3607, 0x3606, // 11912
-    0x3605, 0x3604, 0x3603, 0x3603, 0x3602, 0x3601, 0x3600, 0x35ff, // 11920
-    0x35fe, 0x35fd, 0x35fc, 0x35fb, 0x35fb, 0x35fa, 0x35f9, 0x35f8, // 11928
-    0x35f7, 0x35f6, 0x35f5, 0x35f4, 0x35f3, 0x35f2, 0x35f2, 0x35f1, // 11936
-    0x35f0, 0x35ef, 0x35ee, 0x35ed, 0x35ec, 0x35eb, 0x35ea, 0x35ea, // 11944
-    0x35e9, 0x35e8, 0x35e7, 0x35e6, 0x35e5, 0x35e4, 0x35e3, 0x35e2, // 11952
-    0x35e2, 0x35e1, 0x35e0, 0x35df, 0x35de, 0x35dd, 0x35dc, 0x35db, // 11960
-    0x35da, 0x35d9, 0x35d9, 0x35d8, 0x35d7, 0x35d6, 0x35d5, 0x35d4, // 11968
-    0x35d3, 0x35d2, 0x35d1, 0x35d1, 0x35d0, 0x35cf, 0x35ce, 0x35cd, // 11976
-    0x35cc, 0x35cb, 0x35ca, 0x35c9, 0x35c9, 0x35c8, 0x35c7, 0x35c6, // 11984
-    0x35c5, 0x35c4, 0x35c3, 0x35c2, 0x35c1, 0x35c0, 0x35c0, 0x35bf, // 11992
-    0x35be, 0x35bd, 0x35bc, 0x35bb, 0x35ba, 0x35b9, 0x35b8, 0x35b8, // 12000
-    0x35b7, 0x35b6, 0x35b5, 0x35b4, 0x35b3, 0x35b2, 0x35b1, 0x35b0, // 12008
-    0x35b0, 0x35af, 0x35ae, 0x35ad, 0x35ac, 0x35ab, 0x35aa, 0x35a9, // 12016
-    0x35a8, 0x35a7, 0x35a7, 0x35a6, 0x35a5, 0x35a4, 0x35a3, 0x35a2, // 12024
-    0x35a1, 0x35a0, 0x359f, 0x359f, 0x359e, 0x359d, 0x359c, 0x359b, // 12032
-    0x359a, 0x3599, 0x3598, 0x3597, 0x3597, 0x3596, 0x3595, 0x3594, // 12040
-    0x3593, 0x3592, 0x3591, 0x3590, 0x358f, 0x358f, 0x358e, 0x358d, // 12048
-    0x358c, 0x358b, 0x358a, 0x3589, 0x3588, 0x3587, 0x3586, 0x3586, // 12056
-    0x3585, 0x3584, 0x3583, 0x3582, 0x3581, 0x3580, 0x357f, 0x357e, // 12064
-    0x357e, 0x357d, 0x357c, 0x357b, 0x357a, 0x3579, 0x3578, 0x3577, // 12072
-    0x3576, 0x3576, 0x3575, 0x3574, 0x3573, 0x3572, 0x3571, 0x3570, // 12080
-    0x356f, 0x356e, 0x356d, 0x356d, 0x356c, 0x356b, 0x356a, 0x3569, // 12088
-    0x3568, 0x3567, 0x3566, 0x3565, 0x3565, 0x3564, 0x3563, 0x3562, // 12096
-    0x3561, 0x3560, 0x355f, 0x355e, 0x355d, 0x355d, 0x355c, 0x355b, // 12104
-    0x355a, 0x3559, 0x3558, 0x3557, 0x3556, 0x3555, 0x3554, 0x3554, // 12112
-    0x3553, 0x3552, 0x3551, 0x3550, 0x354f, 0x354e, 0x354d, 0x354c, // 12120
-    0x354c, 0x354b, 0x354a, 0x3549, 0x3548, 0x3547, 0x3546, 0x3545, // 12128
-    0x3544, 0x3544, 0x3543, 0x3542, 0x3541, 0x3540, 0x353f, 0x353e, // 12136
-    0x353d, 0x353c, 0x353b, 0x353b, 0x353a, 0x3539, 0x3538, 0x3537, // 12144
-    0x3536, 0x3535, 0x3534, 0x3533, 0x3533, 0x3532, 0x3531, 0x3530, // 12152
-    0x352f, 0x352e, 0x352d, 0x352c, 0x352b, 0x352b, 0x352a, 0x3529, // 12160
-    0x3528, 0x3527, 0x3526, 0x3525, 0x3524, 0x3523, 0x3523, 0x3522, // 12168
-    0x3521, 0x3520, 0x351f, 0x351e, 0x351d, 0x351c, 0x351b, 0x351a, // 12176
-    0x351a, 0x3519, 0x3518, 0x3517, 0x3516, 0x3515, 0x3514, 0x3513, // 12184
-    0x3512, 0x3512, 0x3511, 0x3510, 0x350f, 0x350e, 0x350d, 0x350c, // 12192
-    0x350b, 0x350a, 0x350a, 0x3509, 0x3508, 0x3507, 0x3506, 0x3505, // 12200
-    0x3504, 0x3503, 0x3502, 0x3501, 0x3501, 0x3500, 0x34ff, 0x34fe, // 12208
-    0x34fd, 0x34fc, 0x34fb, 0x34fa, 0x34f9, 0x34f9, 0x34f8, 0x34f7, // 12216
-    0x34f6, 0x34f5, 0x34f4, 0x34f3, 0x34f2, 0x34f1, 0x34f1, 0x34f0, // 12224
-    0x34ef, 0x34ee, 0x34ed, 0x34ec, 0x34eb, 0x34ea, 0x34e9, 0x34e8, // 12232
-    0x34e8, 0x34e7, 0x34e6, 0x34e5, 0x34e4, 0x34e3, 0x34e2, 0x34e1, // 12240
-    0x34e0, 0x34e0, 0x34df, 0x34de, 0x34dd, 0x34dc, 0x34db, 0x34da, // 12248
-    0x34d9, 0x34d8, 0x34d8, 0x34d7, 0x34d6, 0x34d5, 0x34d4, 0x34d3, // 12256
-    0x34d2, 0x34d1, 0x34d0, 0x34cf, 0x34cf, 0x34ce, 0x34cd, 0x34cc, // 12264
-    0x34cb, 0x34ca, 0x34c9, 0x34c8, 0x34c7, 0x34c7, 0x34c6, 0x34c5, // 12272
-    0x34c4, 0x34c3, 0x34c2, 0x34c1, 0x34c0, 0x34bf, 0x34bf, 0x34be, // 12280
-    0x34bd, 0x34bc, 0x34bb, 0x34ba, 0x34b9, 0x34b8, 0x34b8, 0x34b7, // 12288
-    0x34b6, 0x34b5, 0x34b4, 0x34b3, 0x34b2, 0x34b2, 0x34b1, 0x34b0, // 12296
-    0x34af, 0x34ae, 0x34ad, 0x34ac, 0x34ac, 0x34ab, 0x34aa, 0x34a9, // 12304
-    0x34a8, 0x34a7, 0x34a6, 0x34a5, 0x34a5, 0x34a4, 0x34a3, 0x34a2, // 12312
-    0x34a1, 0x34a0, 0x349f, 0x349f, 0x349e, 0x349d, 0x349c, 0x349b, // 12320
-    0x349a, 0x3499, 0x3499, 0x3498, 0x3497, 0x3496, 0x3495, 0x3494, // 12328
-    0x3493, 0x3493, 0x3492, 0x3491, 0x3490, 0x348f, 0x348e, 0x348d, // 12336
-    0x348d, 0x348c, 0x348b, 0x348a, 0x3489, 0x3488, 0x3487, 0x3486, // 12344
-    0x3486, 0x3485, 0x3484, 0x3483, 0x3482, 0x3481, 0x3480, 0x3480, // 12352
-    0x347f, 0x347e, 0x347d, 0x347c, 0x347b, 0x347a, 0x347a, 0x3479, // 12360
-    0x3478, 0x3477, 0x3476, 0x3475, 0x3474, 0x3474, 0x3473, 0x3472, // 12368
-    0x3471, 0x3470, 0x346f, 0x346e, 0x346e, 0x346d, 0x346c, 0x346b, // 12376
-    0x346a, 0x3469, 0x3468, 0x3467, 0x3467, 0x3466, 0x3465, 0x3464, // 12384
-    0x3463, 0x3462, 0x3461, 0x3461, 0x3460, 0x345f, 0x345e, 0x345d, // 12392
-    0x345c, 0x345b, 0x345b, 0x345a, 0x3459, 0x3458, 0x3457, 0x3456, // 12400
-    0x3455, 0x3455, 0x3454, 0x3453, 0x3452, 0x3451, 0x3450, 0x344f, // 12408
-    0x344f, 0x344e, 0x344d, 0x344c, 0x344b, 0x344a, 0x3449, 0x3448, // 12416
-    0x3448, 0x3447, 0x3446, 0x3445, 0x3444, 0x3443, 0x3442, 0x3442, // 12424
-    0x3441, 0x3440, 0x343f, 0x343e, 0x343d, 0x343c, 0x343c, 0x343b, // 12432
-    0x343a, 0x3439, 0x3438, 0x3437, 0x3436, 0x3436, 0x3435, 0x3434, // 12440
-    0x3433, 0x3432, 0x3431, 0x3430, 0x342f, 0x342f, 0x342e, 0x342d, // 12448
-    0x342c, 0x342b, 0x342a, 0x3429, 0x3429, 0x3428, 0x3427, 0x3426, // 12456
-    0x3425, 0x3424, 0x3423, 0x3423, 0x3422, 0x3421, 0x3420, 0x341f, // 12464
-    0x341e, 0x341d, 0x341d, 0x341c, 0x341b, 0x341a, 0x3419, 0x3418, // 12472
-    0x3417, 0x3417, 0x3416, 0x3415, 0x3414, 0x3413, 0x3412, 0x3411, // 12480
-    0x3410, 0x3410, 0x340f, 0x340e, 0x340d, 0x340c, 0x340b, 0x340a, // 12488
-    0x340a, 0x3409, 0x3408, 0x3407, 0x3406, 0x3405, 0x3404, 0x3404, // 12496
-    0x3403, 0x3402, 0x3401, 0x3400, 0x33ff, 0x33fe, 0x33fe, 0x33fd, // 12504
-    0x33fc, 0x33fb, 0x33fa, 0x33f9, 0x33f8, 0x33f8, 0x33f7, 0x33f6, // 12512
-    0x33f5, 0x33f4, 0x33f3, 0x33f2, 0x33f1, 0x33f1, 0x33f0, 0x33ef, // 12520
-    0x33ee, 0x33ed, 0x33ec, 0x33eb, 0x33eb, 0x33ea, 0x33e9, 0x33e8, // 12528
-    0x33e7, 0x33e6, 0x33e5, 0x33e5, 0x33e4, 0x33e3, 0x33e2, 0x33e1, // 12536
-    0x33e0, 0x33df, 0x33df, 0x33de, 0x33dd, 0x33dc, 0x33db, 0x33da, // 12544
-    0x33d9, 0x33d8, 0x33d8, 0x33d7, 0x33d6, 0x33d5, 0x33d4, 0x33d3, // 12552
-    0x33d2, 0x33d2, 0x33d1, 0x33d0, 0x33cf, 0x33ce, 0x33cd, 0x33cc, // 12560
-    0x33cc, 0x33cb, 0x33ca, 0x33c9, 0x33c8, 0x33c7, 0x33c6, 0x33c6, // 12568
-    0x33c5, 0x33c4, 0x33c3, 0x33c2, 0x33c1, 0x33c0, 0x33c0, 0x33bf, // 12576
-    0x33be, 0x33bd, 0x33bc, 0x33bb, 0x33ba, 0x33b9, 0x33b9, 0x33b8, // 12584
-    0x33b7, 0x33b6, 0x33b5, 0x33b4, 0x33b3, 0x33b3, 0x33b2, 0x33b1, // 12592
-    0x33b0, 0x33af, 0x33ae, 0x33ad, 0x33ad, 0x33ac, 0x33ab, 0x33aa, // 12600
-    0x33a9, 0x33a8, 0x33a7, 0x33a7, 0x33a6, 0x33a5, 0x33a4, 0x33a3, // 12608
-    0x33a2, 0x33a1, 0x33a1, 0x33a0, 0x339f, 0x339e, 0x339d, 0x339c, // 12616
-    0x339b, 0x339a, 0x339a, 0x3399, 0x3398, 0x3397, 0x3396, 0x3395, // 12624
-    0x3394, 0x3394, 0x3393, 0x3392, 0x3391, 0x3390, 0x338f, 0x338e, // 12632
-    0x338e, 0x338d, 0x338c, 0x338b, 0x338a, 0x3389, 0x3388, 0x3388, // 12640
-    0x3387, 0x3386, 0x3385, 0x3384, 0x3383, 0x3382, 0x3382, 0x3381, // 12648
-    0x3380, 0x337f, 0x337e, 0x337d, 0x337c, 0x337b, 0x337b, 0x337a, // 12656
-    0x3379, 0x3378, 0x3377, 0x3376, 0x3375, 0x3375, 0x3374, 0x3373, // 12664
-    0x3372, 0x3371, 0x3370, 0x336f, 0x336f, 0x336e, 0x336d, 0x336c, // 12672
-    0x336b, 0x336a, 0x3369, 0x3369, 0x3368, 0x3367, 0x3366, 0x3365, // 12680
-    0x3364, 0x3363, 0x3362, 0x3362, 0x3361, 0x3360, 0x335f, 0x335e, // 12688
-    0x335d, 0x335c, 0x335c, 0x335b, 0x335a, 0x3359, 0x3358, 0x3357, // 12696
-    0x3356, 0x3356, 0x3355, 0x3354, 0x3353, 0x3352, 0x3351, 0x3350, // 12704
-    0x3350, 0x334f, 0x334e, 0x334d, 0x334c, 0x334b, 0x334a, 0x334a, // 12712
-    0x3349, 0x3348, 0x3347, 0x3346, 0x3345, 0x3344, 0x3343, 0x3343, // 12720
-    0x3342, 0x3341, 0x3340, 0x333f, 0x333e, 0x333d, 0x333d, 0x333c, // 12728
-    0x333b, 0x333a, 0x3339, 0x3338, 0x3337, 0x3337, 0x3336, 0x3335, // 12736
-    0x3334, 0x3333, 0x3332, 0x3331, 0x3331, 0x3330, 0x332f, 0x332e, // 12744
-    0x332d, 0x332c, 0x332b, 0x332b, 0x332a, 0x3329, 0x3328, 0x3327, // 12752
-    0x3326, 0x3325, 0x3324, 0x3324, 0x3323, 0x3322, 0x3321, 0x3320, // 12760
-    0x331f, 0x331e, 0x331e, 0x331d, 0x331c, 0x331b, 0x331a, 0x3319, // 12768
-    0x3318, 0x3318, 0x3317, 0x3316, 0x3315, 0x3314, 0x3313, 0x3312, // 12776
-    0x3312, 0x3311, 0x3310, 0x330f, 0x330e, 0x330d, 0x330c, 0x330c, // 12784
-    0x330b, 0x330a, 0x3309, 0x3308, 0x3307, 0x3306, 0x3305, 0x3305, // 12792
-    0x3304, 0x3303, 0x3302, 0x3301, 0x3300, 0x32ff, 0x32ff, 0x32fe, // 12800
-    0x32fd, 0x32fc, 0x32fb, 0x32fa, 0x32f9, 0x32f9, 0x32f8, 0x32f7, // 12808
-    0x32f6, 0x32f5, 0x32f4, 0x32f3, 0x32f3, 0x32f2, 0x32f1, 0x32f0, // 12816
-    0x32ef, 0x32ee, 0x32ed, 0x32ec, 0x32ec, 0x32eb, 0x32ea, 0x32e9, // 12824
-    0x32e8, 0x32e7, 0x32e6, 0x32e6, 0x32e5, 0x32e4, 0x32e3, 0x32e2, // 12832
-    0x32e1, 0x32e0, 0x32e0, 0x32df, 0x32de, 0x32dd, 0x32dc, 0x32db, // 12840
-    0x32da, 0x32da, 0x32d9, 0x32d8, 0x32d7, 0x32d6, 0x32d5, 0x32d4, // 12848
-    0x32d4, 0x32d3, 0x32d2, 0x32d1, 0x32d0, 0x32cf, 0x32ce, 0x32cd, // 12856
-    0x32cd, 0x32cc, 0x32cb, 0x32ca, 0x32c9, 0x32c8, 0x32c7, 0x32c7, // 12864
-    0x32c6, 0x32c5, 0x32c4, 0x32c3, 0x32c2, 0x32c1, 0x32c1, 0x32c0, // 12872
-    0x32bf, 0x32be, 0x32bd, 0x32bc, 0x32bb, 0x32bb, 0x32ba, 0x32b9, // 12880
-    0x32b8, 0x32b7, 0x32b6, 0x32b5, 0x32b5, 0x32b4, 0x32b3, 0x32b2, // 12888
-    0x32b1, 0x32b0, 0x32af, 0x32ae, 0x32ae, 0x32ad, 0x32ac, 0x32ab, // 12896
-    0x32aa, 0x32a9, 0x32a8, 0x32a8, 0x32a7, 0x32a6, 0x32a5, 0x32a4, // 12904
-    0x32a3, 0x32a2, 0x32a2, 0x32a1, 0x32a0, 0x329f, 0x329e, 0x329d, // 12912
-    0x329c, 0x329c, 0x329b, 0x329a, 0x3299, 0x3298, 0x3297, 0x3296, // 12920
-    0x3296, 0x3295, 0x3294, 0x3293, 0x3292, 0x3291, 0x3290, 0x328f, // 12928
-    0x328f, 0x328e, 0x328d, 0x328c, 0x328b, 0x328a, 0x3289, 0x3289, // 12936
-    0x3288, 0x3287, 0x3286, 0x3285, 0x3284, 0x3283, 0x3283, 0x3282, // 12944
-    0x3281, 0x3280, 0x327f, 0x327e, 0x327d, 0x327d, 0x327c, 0x327b, // 12952
-    0x327a, 0x3279, 0x3278, 0x3277, 0x3276, 0x3276, 0x3275, 0x3274, // 12960
-    0x3273, 0x3272, 0x3271, 0x3270, 0x3270, 0x326f, 0x326e, 0x326d, // 12968
-    0x326c, 0x326b, 0x326a, 0x326a, 0x3269, 0x3268, 0x3267, 0x3266, // 12976
-    0x3265, 0x3264, 0x3264, 0x3263, 0x3262, 0x3261, 0x3260, 0x325f, // 12984
-    0x325e, 0x325e, 0x325d, 0x325c, 0x325b, 0x325a, 0x3259, 0x3258, // 12992
-    0x3257, 0x3257, 0x3256, 0x3255, 0x3254, 0x3253, 0x3252, 0x3251, // 13000
-    0x3251, 0x3250, 0x324f, 0x324e, 0x324d, 0x324c, 0x324b, 0x324b, // 13008
-    0x324a, 0x3249, 0x3248, 0x3247, 0x3246, 0x3245, 0x3245, 0x3244, // 13016
-    0x3243, 0x3242, 0x3241, 0x3240, 0x323f, 0x323f, 0x323e, 0x323d, // 13024
-    0x323c, 0x323b, 0x323a, 0x3239, 0x3238, 0x3238, 0x3237, 0x3236, // 13032
-    0x3235, 0x3234, 0x3233, 0x3232, 0x3232, 0x3231, 0x3230, 0x322f, // 13040
-    0x322e, 0x322d, 0x322c, 0x322c, 0x322b, 0x322a, 0x3229, 0x3228, // 13048
-    0x3227, 0x3226, 0x3226, 0x3225, 0x3224, 0x3223, 0x3222, 0x3221, // 13056
-    0x3220, 0x321f, 0x321f, 0x321e, 0x321d, 0x321c, 0x321b, 0x321a, // 13064
-    0x3219, 0x3219, 0x3218, 0x3217, 0x3216, 0x3215, 0x3214, 0x3213, // 13072
-    0x3213, 0x3212, 0x3211, 0x3210, 0x320f, 0x320e, 0x320d, 0x320d, // 13080
-    0x320c, 0x320b, 0x320a, 0x3209, 0x3208, 0x3207, 0x3207, 0x3206, // 13088
-    0x3205, 0x3204, 0x3203, 0x3202, 0x3201, 0x3200, 0x3200, 0x31ff, // 13096
-    0x31fe, 0x31fd, 0x31fc, 0x31fb, 0x31fa, 0x31fa, 0x31f9, 0x31f8, // 13104
-    0x31f7, 0x31f6, 0x31f5, 0x31f4, 0x31f4, 0x31f3, 0x31f2, 0x31f1, // 13112
-    0x31f0, 0x31ef, 0x31ee, 0x31ee, 0x31ed, 0x31ec, 0x31eb, 0x31ea, // 13120
-    0x31e9, 0x31e8, 0x31e8, 0x31e7, 0x31e6, 0x31e5, 0x31e4, 0x31e3, // 13128
-    0x31e2, 0x31e1, 0x31e1, 0x31e0, 0x31df, 0x31de, 0x31dd, 0x31dc, // 13136
-    0x31db, 0x31db, 0x31da, 0x31d9, 0x31d8, 0x31d7, 0x31d6, 0x31d5, // 13144
-    0x31d5, 0x31d4, 0x31d3, 0x31d2, 0x31d1, 0x31d0, 0x31cf, 0x31cf, // 13152
-    0x31ce, 0x31cd, 0x31cc, 0x31cb, 0x31ca, 0x31c9, 0x31c9, 0x31c8, // 13160
-    0x31c7, 0x31c6, 0x31c5, 0x31c4, 0x31c3, 0x31c2, 0x31c2, 0x31c1, // 13168
-    0x31c0, 0x31bf, 0x31be, 0x31bd, 0x31bc, 0x31bc, 0x31bb, 0x31ba, // 13176
-    0x31b9, 0x31b8, 0x31b7, 0x31b6, 0x31b6, 0x31b5, 0x31b4, 0x31b3, // 13184
-    0x31b2, 0x31b1, 0x31b0, 0x31b0, 0x31af, 0x31ae, 0x31ad, 0x31ac, // 13192
-    0x31ab, 0x31aa, 0x31a9, 0x31a9, 0x31a8, 0x31a7, 0x31a6, 0x31a5, // 13200
-    0x31a4, 0x31a3, 0x31a3, 0x31a2, 0x31a1, 0x31a0, 0x319f, 0x319e, // 13208
-    0x319d, 0x319d, 0x319c, 0x319b, 0x319a, 0x3199, 0x3198, 0x3197, // 13216
-    0x3197, 0x3196, 0x3195, 0x3194, 0x3193, 0x3192, 0x3191, 0x3191, // 13224
-    0x3190, 0x318f, 0x318e, 0x318d, 0x318c, 0x318b, 0x318a, 0x318a, // 13232
-    0x3189, 0x3188, 0x3187, 0x3186, 0x3185, 0x3184, 0x3184, 0x3183, // 13240
-    0x3182, 0x3181, 0x3180, 0x317f, 0x317e, 0x317e, 0x317d, 0x317c, // 13248
-    0x317b, 0x317a, 0x3179, 0x3178, 0x3178, 0x3177, 0x3176, 0x3175, // 13256
-    0x3174, 0x3173, 0x3172, 0x3172, 0x3171, 0x3170, 0x316f, 0x316e, // 13264
-    0x316d, 0x316c, 0x316b, 0x316b, 0x316a, 0x3169, 0x3168, 0x3167, // 13272
-    0x3166, 0x3165, 0x3165, 0x3164, 0x3163, 0x3162, 0x3161, 0x3160, // 13280
-    0x315f, 0x315f, 0x315e, 0x315d, 0x315c, 0x315b, 0x315a, 0x3159, // 13288
-    0x3159, 0x3158, 0x3157, 0x3156, 0x3155, 0x3154, 0x3153, 0x3153, // 13296
-    0x3152, 0x3151, 0x3150, 0x314f, 0x314e, 0x314d, 0x314c, 0x314c, // 13304
-    0x314a, 0x3149, 0x3148, 0x3147, 0x3147, 0x3146, 0x3145, 0x3144, // 13312
-    0x3143, 0x3142, 0x3142, 0x3141, 0x3140, 0x313f, 0x313e, 0x313d, // 13320
-    0x313d, 0x313c, 0x313b, 0x313a, 0x3139, 0x3138, 0x3138, 0x3137, // 13328
-    0x3136, 0x3135, 0x3134, 0x3133, 0x3133, 0x3132, 0x3131, 0x3130, // 13336
-    0x312f, 0x312e, 0x312e, 0x312d, 0x312c, 0x312b, 0x312a, 0x3129, // 13344
-    0x3129, 0x3128, 0x3127, 0x3126, 0x3125, 0x3124, 0x3124, 0x3123, // 13352
-    0x3122, 0x3121, 0x3120, 0x311f, 0x311f, 0x311e, 0x311d, 0x311c, // 13360
-    0x311b, 0x311a, 0x311a, 0x3119, 0x3118, 0x3117, 0x3116, 0x3115, // 13368
-    0x3115, 0x3114, 0x3113, 0x3112, 0x3111, 0x3110, 0x3110, 0x310f, // 13376
-    0x310e, 0x310d, 0x310c, 0x310b, 0x310b, 0x310a, 0x3109, 0x3108, // 13384
-    0x3107, 0x3106, 0x3106, 0x3105, 0x3104, 0x3103, 0x3102, 0x3101, // 13392
-    0x3101, 0x3100, 0x30ff, 0x30fe, 0x30fd, 0x30fc, 0x30fc, 0x30fb, // 13400
-    0x30fa, 0x30f9, 0x30f8, 0x30f7, 0x30f7, 0x30f6, 0x30f5, 0x30f4, // 13408
-    0x30f3, 0x30f2, 0x30f2, 0x30f1, 0x30f0, 0x30ef, 0x30ee, 0x30ed, // 13416
-    0x30ed, 0x30ec, 0x30eb, 0x30ea, 0x30e9, 0x30e8, 0x30e8, 0x30e7, // 13424
-    0x30e6, 0x30e5, 0x30e4, 0x30e3, 0x30e3, 0x30e2, 0x30e1, 0x30e0, // 13432
-    0x30df, 0x30de, 0x30de, 0x30dd, 0x30dc, 0x30db, 0x30da, 0x30d9, // 13440
-    0x30d9, 0x30d8, 0x30d7, 0x30d6, 0x30d5, 0x30d4, 0x30d4, 0x30d3, // 13448
-    0x30d2, 0x30d1, 0x30d0, 0x30cf, 0x30cf, 0x30ce, 0x30cd, 0x30cc, // 13456
-    0x30cb, 0x30ca, 0x30ca, 0x30c9, 0x30c8, 0x30c7, 0x30c6, 0x30c5, // 13464
-    0x30c5, 0x30c4, 0x30c3, 0x30c2, 0x30c1, 0x30c0, 0x30c0, 0x30bf, // 13472
-    0x30be, 0x30bd, 0x30bc, 0x30bb, 0x30bb, 0x30ba, 0x30b9, 0x30b8, // 13480
-    0x30b7, 0x30b6, 0x30b6, 0x30b5, 0x30b4, 0x30b3, 0x30b2, 0x30b1, // 13488
-    0x30b1, 0x30b0, 0x30af, 0x30ae, 0x30ad, 0x30ac, 0x30ac, 0x30ab, // 13496
-    0x30aa, 0x30a9, 0x30a8, 0x30a7, 0x30a7, 0x30a6, 0x30a5, 0x30a4, // 13504
-    0x30a3, 0x30a2, 0x30a2, 0x30a1, 0x30a0, 0x309f, 0x309e, 0x309d, // 13512
-    0x309d, 0x309c, 0x309b, 0x309a, 0x3099, 0x3098, 0x3098, 0x3097, // 13520
-    0x3096, 0x3095, 0x3094, 0x3093, 0x3093, 0x3092, 0x3091, 0x3090, // 13528
-    0x308f, 0x308e, 0x308e, 0x308d, 0x308c, 0x308b, 0x308a, 0x3089, // 13536
-    0x3089, 0x3088, 0x3087, 0x3086, 0x3085, 0x3084, 0x3084, 0x3083, // 13544
-    0x3082, 0x3081, 0x3080, 0x307f, 0x307f, 0x307e, 0x307d, 0x307c, // 13552
-    0x307b, 0x307a, 0x307a, 0x3079, 0x3078, 0x3077, 0x3076, 0x3075, // 13560
-    0x3075, 0x3074, 0x3073, 0x3072, 0x3071, 0x3070, 0x306f, 0x306f, // 13568
-    0x306e, 0x306d, 0x306c, 0x306b, 0x306a, 0x306a, 0x3069, 0x3068, // 13576
-    0x3067, 0x3066, 0x3065, 0x3065, 0x3064, 0x3063, 0x3062, 0x3061, // 13584
-    0x3060, 0x3060, 0x305f, 0x305e, 0x305d, 0x305c, 0x305b, 0x305b, // 13592
-    0x305a, 0x3059, 0x3058, 0x3057, 0x3056, 0x3056, 0x3055, 0x3054, // 13600
-    0x3053, 0x3052, 0x3051, 0x3051, 0x3050, 0x304f, 0x304e, 0x304d, // 13608
-    0x304c, 0x304c, 0x304b, 0x304a, 0x3049, 0x3048, 0x3047, 0x3047, // 13616
-    0x3046, 0x3045, 0x3044, 0x3043, 0x3042, 0x3042, 0x3041, 0x3040, // 13624
-    0x303f, 0x303e, 0x303d, 0x303d, 0x303c, 0x303b, 0x303a, 0x3039, // 13632
-    0x3038, 0x3038, 0x3037, 0x3036, 0x3035, 0x3034, 0x3033, 0x3033, // 13640
-    0x3032, 0x3031, 0x3030, 0x302f, 0x302e, 0x302e, 0x302d, 0x302c, // 13648
-    0x302b, 0x302a, 0x3029, 0x3029, 0x3028, 0x3027, 0x3026, 0x3025, // 13656
-    0x3024, 0x3024, 0x3023, 0x3022, 0x3021, 0x3020, 0x301f, 0x301f, // 13664
-    0x301e, 0x301d, 0x301c, 0x301b, 0x301a, 0x301a, 0x3019, 0x3018, // 13672
-    0x3017, 0x3016, 0x3015, 0x3015, 0x3014, 0x3013, 0x3012, 0x3011, // 13680
-    0x3010, 0x3010, 0x300f, 0x300e, 0x300d, 0x300c, 0x300b, 0x300b, // 13688
-    0x300a, 0x3009, 0x3008, 0x3007, 0x3006, 0x3006, 0x3005, 0x3004, // 13696
-    0x3003, 0x3002, 0x3001, 0x3001, 0x3000, 0x2fff, 0x2ffe, 0x2ffd, // 13704
-    0x2ffc, 0x2ffc, 0x2ffb, 0x2ffa, 0x2ff9, 0x2ff8, 0x2ff7, 0x2ff7, // 13712
-    0x2ff6, 0x2ff5, 0x2ff4, 0x2ff3, 0x2ff2, 0x2ff2, 0x2ff1, 0x2ff0, // 13720
-    0x2fef, 0x2fee, 0x2fed, 0x2fed, 0x2fec, 0x2feb, 0x2fea, 0x2fe9, // 13728
-    0x2fe8, 0x2fe8, 0x2fe7, 0x2fe6, 0x2fe5, 0x2fe4, 0x2fe3, 0x2fe3, // 13736
-    0x2fe2, 0x2fe1, 0x2fe0, 0x2fdf, 0x2fde, 0x2fde, 0x2fdd, 0x2fdc, // 13744
-    0x2fdb, 0x2fda, 0x2fd9, 0x2fd9, 0x2fd8, 0x2fd7, 0x2fd6, 0x2fd5, // 13752
-    0x2fd4, 0x2fd4, 0x2fd3, 0x2fd2, 0x2fd1, 0x2fd0, 0x2fcf, 0x2fcf, // 13760
-    0x2fce, 0x2fcd, 0x2fcc, 0x2fcb, 0x2fca, 0x2fca, 0x2fc9, 0x2fc8, // 13768
-    0x2fc7, 0x2fc6, 0x2fc5, 0x2fc5, 0x2fc4, 0x2fc3, 0x2fc2, 0x2fc1, // 13776
-    0x2fc0, 0x2fc0, 0x2fbf, 0x2fbe, 0x2fbd, 0x2fbc, 0x2fbb, 0x2fbb, // 13784
-    0x2fba, 0x2fb9, 0x2fb8, 0x2fb7, 0x2fb6, 0x2fb6, 0x2fb5, 0x2fb4, // 13792
-    0x2fb3, 0x2fb2, 0x2fb1, 0x2fb1, 0x2fb0, 0x2faf, 0x2fae, 0x2fad, // 13800
-    0x2fac, 0x2fac, 0x2fab, 0x2faa, 0x2fa9, 0x2fa8, 0x2fa7, 0x2fa7, // 13808
-    0x2fa6, 0x2fa5, 0x2fa4, 0x2fa3, 0x2fa2, 0x2fa2, 0x2fa1, 0x2fa0, // 13816
-    0x2f9f, 0x2f9e, 0x2f9d, 0x2f9c, 0x2f9c, 0x2f9b, 0x2f9a, 0x2f99, // 13824
-    0x2f98, 0x2f97, 0x2f97, 0x2f96, 0x2f95, 0x2f94, 0x2f93, 0x2f92, // 13832
-    0x2f92, 0x2f91, 0x2f90, 0x2f8f, 0x2f8e, 0x2f8d, 0x2f8d, 0x2f8c, // 13840
-    0x2f8b, 0x2f8a, 0x2f89, 0x2f88, 0x2f88, 0x2f87, 0x2f86, 0x2f85, // 13848
-    0x2f84, 0x2f83, 0x2f83, 0x2f82, 0x2f81, 0x2f80, 0x2f7f, 0x2f7e, // 13856
-    0x2f7e, 0x2f7d, 0x2f7c, 0x2f7b, 0x2f7a, 0x2f79, 0x2f79, 0x2f78, // 13864
-    0x2f77, 0x2f76, 0x2f75, 0x2f74, 0x2f74, 0x2f73, 0x2f72, 0x2f71, // 13872
-    0x2f70, 0x2f6f, 0x2f6f, 0x2f6e, 0x2f6d, 0x2f6c, 0x2f6b, 0x2f6a, // 13880
-    0x2f6a, 0x2f69, 0x2f68, 0x2f67, 0x2f66, 0x2f65, 0x2f65, 0x2f64, // 13888
-    0x2f63, 0x2f62, 0x2f61, 0x2f60, 0x2f60, 0x2f5f, 0x2f5e, 0x2f5d, // 13896
-    0x2f5c, 0x2f5b, 0x2f5b, 0x2f5a, 0x2f59, 0x2f58, 0x2f57, 0x2f56, // 13904
-    0x2f56, 0x2f55, 0x2f54, 0x2f53, 0x2f52, 0x2f51, 0x2f51, 0x2f50, // 13912
-    0x2f4f, 0x2f4e, 0x2f4d, 0x2f4c, 0x2f4c, 0x2f4b, 0x2f4a, 0x2f49, // 13920
-    0x2f48, 0x2f47, 0x2f47, 0x2f46, 0x2f45, 0x2f44, 0x2f43, 0x2f42, // 13928
-    0x2f42, 0x2f41, 0x2f40, 0x2f3f, 0x2f3e, 0x2f3d, 0x2f3d, 0x2f3c, // 13936
-    0x2f3b, 0x2f3a, 0x2f39, 0x2f38, 0x2f38, 0x2f37, 0x2f36, 0x2f35, // 13944
-    0x2f34, 0x2f33, 0x2f33, 0x2f32, 0x2f31, 0x2f30, 0x2f2f, 0x2f2e, // 13952
-    0x2f2e, 0x2f2d, 0x2f2c, 0x2f2b, 0x2f2a, 0x2f29, 0x2f29, 0x2f28, // 13960
-    0x2f27, 0x2f26, 0x2f25, 0x2f24, 0x2f24, 0x2f23, 0x2f22, 0x2f21, // 13968
-    0x2f20, 0x2f1f, 0x2f1f, 0x2f1e, 0x2f1d, 0x2f1c, 0x2f1b, 0x2f1a, // 13976
-    0x2f1a, 0x2f19, 0x2f18, 0x2f17, 0x2f16, 0x2f15, 0x2f15, 0x2f14, // 13984
-    0x2f13, 0x2f12, 0x2f11, 0x2f10, 0x2f10, 0x2f0f, 0x2f0e, 0x2f0d, // 13992
-    0x2f0c, 0x2f0b, 0x2f0b, 0x2f0a, 0x2f09, 0x2f08, 0x2f07, 0x2f06, // 14000
-    0x2f06, 0x2f05, 0x2f04, 0x2f03, 0x2f02, 0x2f01, 0x2f01, 0x2f00, // 14008
-    0x2eff, 0x2efe, 0x2efd, 0x2efc, 0x2efc, 0x2efb, 0x2efa, 0x2ef9, // 14016
-    0x2ef8, 0x2ef7, 0x2ef7, 0x2ef6, 0x2ef5, 0x2ef4, 0x2ef3, 0x2ef2, // 14024
-    0x2ef2, 0x2ef1, 0x2ef0, 0x2eef, 0x2eee, 0x2eed, 0x2eed, 0x2eec, // 14032
-    0x2eeb, 0x2eea, 0x2ee9, 0x2ee8, 0x2ee8, 0x2ee7, 0x2ee6, 0x2ee5, // 14040
-    0x2ee4, 0x2ee3, 0x2ee3, 0x2ee2, 0x2ee1, 0x2ee0, 0x2edf, 0x2ede, // 14048
-    0x2ede, 0x2edd, 0x2edc, 0x2edb, 0x2eda, 0x2ed9, 0x2ed9, 0x2ed8, // 14056
-    0x2ed7, 0x2ed6, 0x2ed5, 0x2ed4, 0x2ed4, 0x2ed3, 0x2ed2, 0x2ed1, // 14064
-    0x2ed0, 0x2ecf, 0x2ecf, 0x2ece, 0x2ecd, 0x2ecc, 0x2ecb, 0x2eca, // 14072
-    0x2eca, 0x2ec9, 0x2ec8, 0x2ec7, 0x2ec6, 0x2ec5, 0x2ec4, 0x2ec4, // 14080
-    0x2ec3, 0x2ec2, 0x2ec1, 0x2ec0, 0x2ebf, 0x2ebf, 0x2ebe, 0x2ebd, // 14088
-    0x2ebc, 0x2ebb, 0x2eba, 0x2eba, 0x2eb9, 0x2eb8, 0x2eb7, 0x2eb6, // 14096
-    0x2eb5, 0x2eb5, 0x2eb4, 0x2eb3, 0x2eb2, 0x2eb1, 0x2eb0, 0x2eb0, // 14104
-    0x2eaf, 0x2eae, 0x2ead, 0x2eac, 0x2eab, 0x2eab, 0x2eaa, 0x2ea9, // 14112
-    0x2ea8, 0x2ea7, 0x2ea6, 0x2ea6, 0x2ea5, 0x2ea4, 0x2ea3, 0x2ea2, // 14120
-    0x2ea1, 0x2ea1, 0x2ea0, 0x2e9f, 0x2e9e, 0x2e9d, 0x2e9c, 0x2e9c, // 14128
-    0x2e9b, 0x2e9a, 0x2e99, 0x2e98, 0x2e97, 0x2e97, 0x2e96, 0x2e95, // 14136
-    0x2e94, 0x2e93, 0x2e92, 0x2e92, 0x2e91, 0x2e90, 0x2e8f, 0x2e8e, // 14144
-    0x2e8d, 0x2e8d, 0x2e8c, 0x2e8b, 0x2e8a, 0x2e89, 0x2e88, 0x2e88, // 14152
-    0x2e87, 0x2e86, 0x2e85, 0x2e84, 0x2e83, 0x2e83, 0x2e82, 0x2e81, // 14160
-    0x2e80, 0x2e7f, 0x2e7e, 0x2e7e, 0x2e7d, 0x2e7c, 0x2e7b, 0x2e7a, // 14168
-    0x2e79, 0x2e79, 0x2e78, 0x2e77, 0x2e76, 0x2e75, 0x2e74, 0x2e74, // 14176
-    0x2e73, 0x2e72, 0x2e71, 0x2e70, 0x2e6f, 0x2e6f, 0x2e6e, 0x2e6d, // 14184
-    0x2e6c, 0x2e6b, 0x2e6a, 0x2e6a, 0x2e69, 0x2e68, 0x2e67, 0x2e66, // 14192
-    0x2e65, 0x2e65, 0x2e64, 0x2e63, 0x2e62, 0x2e61, 0x2e60, 0x2e60, // 14200
-    0x2e5f, 0x2e5e, 0x2e5d, 0x2e5c, 0x2e5b, 0x2e5b, 0x2e5a, 0x2e59, // 14208
-    0x2e58, 0x2e57, 0x2e56, 0x2e56, 0x2e55, 0x2e54, 0x2e53, 0x2e52, // 14216
-    0x2e51, 0x2e51, 0x2e50, 0x2e4f, 0x2e4e, 0x2e4d, 0x2e4c, 0x2e4c, // 14224
-    0x2e4b, 0x2e4a, 0x2e49, 0x2e48, 0x2e47, 0x2e47, 0x2e46, 0x2e45, // 14232
-    0x2e44, 0x2e43, 0x2e42, 0x2e42, 0x2e41, 0x2e40, 0x2e3f, 0x2e3e, // 14240
-    0x2e3d, 0x2e3d, 0x2e3c, 0x2e3b, 0x2e3a, 0x2e39, 0x2e38, 0x2e38, // 14248
-    0x2e37, 0x2e36, 0x2e35, 0x2e34, 0x2e33, 0x2e33, 0x2e32, 0x2e31, // 14256
-    0x2e30, 0x2e2f, 0x2e2e, 0x2e2e, 0x2e2d, 0x2e2c, 0x2e2b, 0x2e2a, // 14264
-    0x2e29, 0x2e29, 0x2e28, 0x2e27, 0x2e26, 0x2e25, 0x2e24, 0x2e24, // 14272
-    0x2e23, 0x2e22, 0x2e21, 0x2e20, 0x2e1f, 0x2e1f, 0x2e1e, 0x2e1d, // 14280
-    0x2e1c, 0x2e1b, 0x2e1a, 0x2e1a, 0x2e19, 0x2e18, 0x2e17, 0x2e16, // 14288
-    0x2e15, 0x2e15, 0x2e14, 0x2e13, 0x2e12, 0x2e11, 0x2e10, 0x2e10, // 14296
-    0x2e0f, 0x2e0e, 0x2e0d, 0x2e0c, 0x2e0b, 0x2e0b, 0x2e0a, 0x2e09, // 14304
-    0x2e08, 0x2e07, 0x2e06, 0x2e06, 0x2e05, 0x2e04, 0x2e03, 0x2e02, // 14312
-    0x2e01, 0x2e01, 0x2e00, 0x2dff, 0x2dfe, 0x2dfd, 0x2dfc, 0x2dfc, // 14320
-    0x2dfb, 0x2dfa, 0x2df9, 0x2df8, 0x2df7, 0x2df7, 0x2df6, 0x2df5, // 14328
-    0x2df4, 0x2df3, 0x2df2, 0x2df1, 0x2df1, 0x2df0, 0x2def, 0x2dee, // 14336
-    0x2ded, 0x2dec, 0x2dec, 0x2deb, 0x2dea, 0x2de9, 0x2de8, 0x2de8, // 14344
-    0x2de7, 0x2de6, 0x2de5, 0x2de4, 0x2de4, 0x2de3, 0x2de2, 0x2de1, // 14352
-    0x2de0, 0x2de0, 0x2ddf, 0x2dde, 0x2ddd, 0x2ddc, 0x2ddc, 0x2ddb, // 14360
-    0x2dda, 0x2dd9, 0x2dd8, 0x2dd8, 0x2dd7, 0x2dd6, 0x2dd5, 0x2dd4, // 14368
-    0x2dd3, 0x2dd3, 0x2dd2, 0x2dd1, 0x2dd0, 0x2dcf, 0x2dcf, 0x2dce, // 14376
-    0x2dcd, 0x2dcc, 0x2dcb, 0x2dcb, 0x2dca, 0x2dc9, 0x2dc8, 0x2dc7, // 14384
-    0x2dc7, 0x2dc6, 0x2dc5, 0x2dc4, 0x2dc3, 0x2dc3, 0x2dc2, 0x2dc1, // 14392
-    0x2dc0, 0x2dbf, 0x2dbf, 0x2dbe, 0x2dbd, 0x2dbc, 0x2dbb, 0x2dba, // 14400
-    0x2dba, 0x2db9, 0x2db8, 0x2db7, 0x2db6, 0x2db6, 0x2db5, 0x2db4, // 14408
-    0x2db3, 0x2db2, 0x2db2, 0x2db1, 0x2db0, 0x2daf, 0x2dae, 0x2dae, // 14416
-    0x2dad, 0x2dac, 0x2dab, 0x2daa, 0x2daa, 0x2da9, 0x2da8, 0x2da7, // 14424
-    0x2da6, 0x2da6, 0x2da5, 0x2da4, 0x2da3, 0x2da2, 0x2da1, 0x2da1, // 14432
-    0x2da0, 0x2d9f, 0x2d9e, 0x2d9d, 0x2d9d, 0x2d9c, 0x2d9b, 0x2d9a, // 14440
-    0x2d99, 0x2d99, 0x2d98, 0x2d97, 0x2d96, 0x2d95, 0x2d95, 0x2d94, // 14448
-    0x2d93, 0x2d92, 0x2d91, 0x2d91, 0x2d90, 0x2d8f, 0x2d8e, 0x2d8d, // 14456
-    0x2d8d, 0x2d8c, 0x2d8b, 0x2d8a, 0x2d89, 0x2d88, 0x2d88, 0x2d87, // 14464
-    0x2d86, 0x2d85, 0x2d84, 0x2d84, 0x2d83, 0x2d82, 0x2d81, 0x2d80, // 14472
-    0x2d80, 0x2d7f, 0x2d7e, 0x2d7d, 0x2d7c, 0x2d7c, 0x2d7b, 0x2d7a, // 14480
-    0x2d79, 0x2d78, 0x2d78, 0x2d77, 0x2d76, 0x2d75, 0x2d74, 0x2d73, // 14488
-    0x2d73, 0x2d72, 0x2d71, 0x2d70, 0x2d6f, 0x2d6f, 0x2d6e, 0x2d6d, // 14496
-    0x2d6c, 0x2d6b, 0x2d6b, 0x2d6a, 0x2d69, 0x2d68, 0x2d67, 0x2d67, // 14504
-    0x2d66, 0x2d65, 0x2d64, 0x2d63, 0x2d63, 0x2d62, 0x2d61, 0x2d60, // 14512
-    0x2d5f, 0x2d5f, 0x2d5e, 0x2d5d, 0x2d5c, 0x2d5b, 0x2d5a, 0x2d5a, // 14520
-    0x2d59, 0x2d58, 0x2d57, 0x2d56, 0x2d56, 0x2d55, 0x2d54, 0x2d53, // 14528
-    0x2d52, 0x2d52, 0x2d51, 0x2d50, 0x2d4f, 0x2d4e, 0x2d4e, 0x2d4d, // 14536
-    0x2d4c, 0x2d4b, 0x2d4a, 0x2d4a, 0x2d49, 0x2d48, 0x2d47, 0x2d46, // 14544
-    0x2d46, 0x2d45, 0x2d44, 0x2d43, 0x2d42, 0x2d41, 0x2d41, 0x2d40, // 14552
-    0x2d3f, 0x2d3e, 0x2d3d, 0x2d3d, 0x2d3c, 0x2d3b, 0x2d3a, 0x2d39, // 14560
-    0x2d39, 0x2d38, 0x2d37, 0x2d36, 0x2d35, 0x2d35, 0x2d34, 0x2d33, // 14568
-    0x2d32, 0x2d31, 0x2d31, 0x2d30, 0x2d2f, 0x2d2e, 0x2d2d, 0x2d2d, // 14576
-    0x2d2c, 0x2d2b, 0x2d2a, 0x2d29, 0x2d28, 0x2d28, 0x2d27, 0x2d26, // 14584
-    0x2d25, 0x2d24, 0x2d24, 0x2d23, 0x2d22, 0x2d21, 0x2d20, 0x2d20, // 14592
-    0x2d1f, 0x2d1e, 0x2d1d, 0x2d1c, 0x2d1c, 0x2d1b, 0x2d1a, 0x2d19, // 14600
-    0x2d18, 0x2d18, 0x2d17, 0x2d16, 0x2d15, 0x2d14, 0x2d14, 0x2d13, // 14608
-    0x2d12, 0x2d11, 0x2d10, 0x2d0f, 0x2d0f, 0x2d0e, 0x2d0d, 0x2d0c, // 14616
-    0x2d0b, 0x2d0b, 0x2d0a, 0x2d09, 0x2d08, 0x2d07, 0x2d07, 0x2d06, // 14624
-    0x2d05, 0x2d04, 0x2d03, 0x2d03, 0x2d02, 0x2d01, 0x2d00, 0x2cff, // 14632
-    0x2cff, 0x2cfe, 0x2cfd, 0x2cfc, 0x2cfb, 0x2cfa, 0x2cfa, 0x2cf9, // 14640
-    0x2cf8, 0x2cf7, 0x2cf6, 0x2cf6, 0x2cf5, 0x2cf4, 0x2cf3, 0x2cf2, // 14648
-    0x2cf2, 0x2cf1, 0x2cf0, 0x2cef, 0x2cee, 0x2cee, 0x2ced, 0x2cec, // 14656
-    0x2ceb, 0x2cea, 0x2cea, 0x2ce9, 0x2ce8, 0x2ce7, 0x2ce6, 0x2ce6, // 14664
-    0x2ce5, 0x2ce4, 0x2ce3, 0x2ce2, 0x2ce1, 0x2ce1, 0x2ce0, 0x2cdf, // 14672
-    0x2cde, 0x2cdd, 0x2cdd, 0x2cdc, 0x2cdb, 0x2cda, 0x2cd9, 0x2cd9, // 14680
-    0x2cd8, 0x2cd7, 0x2cd6, 0x2cd5, 0x2cd5, 0x2cd4, 0x2cd3, 0x2cd2, // 14688
-    0x2cd1, 0x2cd1, 0x2cd0, 0x2ccf, 0x2cce, 0x2ccd, 0x2ccd, 0x2ccc, // 14696
-    0x2ccb, 0x2cca, 0x2cc9, 0x2cc8, 0x2cc8, 0x2cc7, 0x2cc6, 0x2cc5, // 14704
-    0x2cc4, 0x2cc4, 0x2cc3, 0x2cc2, 0x2cc1, 0x2cc0, 0x2cc0, 0x2cbf, // 14712
-    0x2cbe, 0x2cbd, 0x2cbc, 0x2cbc, 0x2cbb, 0x2cba, 0x2cb9, 0x2cb8, // 14720
-    0x2cb8, 0x2cb7, 0x2cb6, 0x2cb5, 0x2cb4, 0x2cb4, 0x2cb3, 0x2cb2, // 14728
-    0x2cb1, 0x2cb0, 0x2caf, 0x2caf, 0x2cae, 0x2cad, 0x2cac, 0x2cab, // 14736
-    0x2cab, 0x2caa, 0x2ca9, 0x2ca8, 0x2ca7, 0x2ca7, 0x2ca6, 0x2ca5, // 14744
-    0x2ca4, 0x2ca3, 0x2ca3, 0x2ca2, 0x2ca1, 0x2ca0, 0x2c9f, 0x2c9f, // 14752
-    0x2c9e, 0x2c9d, 0x2c9c, 0x2c9b, 0x2c9b, 0x2c9a, 0x2c99, 0x2c98, // 14760
-    0x2c97, 0x2c96, 0x2c96, 0x2c95, 0x2c94, 0x2c93, 0x2c92, 0x2c92, // 14768
-    0x2c91, 0x2c90, 0x2c8f, 0x2c8e, 0x2c8e, 0x2c8d, 0x2c8c, 0x2c8b, // 14776
-    0x2c8a, 0x2c8a, 0x2c89, 0x2c88, 0x2c87, 0x2c86, 0x2c86, 0x2c85, // 14784
-    0x2c84, 0x2c83, 0x2c82, 0x2c82, 0x2c81, 0x2c80, 0x2c7f, 0x2c7e, // 14792
-    0x2c7d, 0x2c7d, 0x2c7c, 0x2c7b, 0x2c7a, 0x2c79, 0x2c79, 0x2c78, // 14800
-    0x2c77, 0x2c76, 0x2c75, 0x2c75, 0x2c74, 0x2c73, 0x2c72, 0x2c71, // 14808
-    0x2c71, 0x2c70, 0x2c6f, 0x2c6e, 0x2c6d, 0x2c6d, 0x2c6c, 0x2c6b, // 14816
-    0x2c6a, 0x2c69, 0x2c68, 0x2c68, 0x2c67, 0x2c66, 0x2c65, 0x2c64, // 14824
-    0x2c64, 0x2c63, 0x2c62, 0x2c61, 0x2c60, 0x2c60, 0x2c5f, 0x2c5e, // 14832
-    0x2c5d, 0x2c5c, 0x2c5c, 0x2c5b, 0x2c5a, 0x2c59, 0x2c58, 0x2c58, // 14840
-    0x2c57, 0x2c56, 0x2c55, 0x2c54, 0x2c54, 0x2c53, 0x2c52, 0x2c51, // 14848
-    0x2c50, 0x2c4f, 0x2c4f, 0x2c4e, 0x2c4d, 0x2c4c, 0x2c4b, 0x2c4b, // 14856
-    0x2c4a, 0x2c49, 0x2c48, 0x2c47, 0x2c47, 0x2c46, 0x2c45, 0x2c44, // 14864
-    0x2c43, 0x2c43, 0x2c42, 0x2c41, 0x2c40, 0x2c3f, 0x2c3f, 0x2c3e, // 14872
-    0x2c3d, 0x2c3c, 0x2c3b, 0x2c3b, 0x2c3a, 0x2c39, 0x2c38, 0x2c37, // 14880
-    0x2c36, 0x2c36, 0x2c35, 0x2c34, 0x2c33, 0x2c32, 0x2c32, 0x2c31, // 14888
-    0x2c30, 0x2c2f, 0x2c2e, 0x2c2e, 0x2c2d, 0x2c2c, 0x2c2b, 0x2c2a, // 14896
-    0x2c2a, 0x2c29, 0x2c28, 0x2c27, 0x2c26, 0x2c26, 0x2c25, 0x2c24, // 14904
-    0x2c23, 0x2c22, 0x2c22, 0x2c21, 0x2c20, 0x2c1f, 0x2c1e, 0x2c1d, // 14912
-    0x2c1d, 0x2c1c, 0x2c1b, 0x2c1a, 0x2c19, 0x2c19, 0x2c18, 0x2c17, // 14920
-    0x2c16, 0x2c15, 0x2c15, 0x2c14, 0x2c13, 0x2c12, 0x2c11, 0x2c11, // 14928
-    0x2c10, 0x2c0f, 0x2c0e, 0x2c0d, 0x2c0d, 0x2c0c, 0x2c0b, 0x2c0a, // 14936
-    0x2c09, 0x2c09, 0x2c08, 0x2c07, 0x2c06, 0x2c05, 0x2c04, 0x2c04, // 14944
-    0x2c03, 0x2c02, 0x2c01, 0x2c00, 0x2c00, 0x2bff, 0x2bfe, 0x2bfd, // 14952
-    0x2bfc, 0x2bfc, 0x2bfb, 0x2bfa, 0x2bf9, 0x2bf8, 0x2bf8, 0x2bf7, // 14960
-    0x2bf6, 0x2bf5, 0x2bf4, 0x2bf4, 0x2bf3, 0x2bf2, 0x2bf1, 0x2bf0, // 14968
-    0x2bf0, 0x2bef, 0x2bee, 0x2bed, 0x2bec, 0x2beb, 0x2beb, 0x2bea, // 14976
-    0x2be9, 0x2be8, 0x2be7, 0x2be7, 0x2be6, 0x2be5, 0x2be4, 0x2be3, // 14984
-    0x2be3, 0x2be2, 0x2be1, 0x2be0, 0x2bdf, 0x2bdf, 0x2bde, 0x2bdd, // 14992
-    0x2bdc, 0x2bdb, 0x2bdb, 0x2bda, 0x2bd9, 0x2bd8, 0x2bd7, 0x2bd6, // 15000
-    0x2bd6, 0x2bd5, 0x2bd4, 0x2bd3, 0x2bd2, 0x2bd2, 0x2bd1, 0x2bd0, // 15008
-    0x2bcf, 0x2bce, 0x2bce, 0x2bcd, 0x2bcc, 0x2bcb, 0x2bca, 0x2bca, // 15016
-    0x2bc9, 0x2bc8, 0x2bc7, 0x2bc6, 0x2bc6, 0x2bc5, 0x2bc4, 0x2bc3, // 15024
-    0x2bc2, 0x2bc2, 0x2bc1, 0x2bc0, 0x2bbf, 0x2bbe, 0x2bbd, 0x2bbd, // 15032
-    0x2bbc, 0x2bbb, 0x2bba, 0x2bb9, 0x2bb9, 0x2bb8, 0x2bb7, 0x2bb6, // 15040
-    0x2bb5, 0x2bb5, 0x2bb4, 0x2bb3, 0x2bb2, 0x2bb1, 0x2bb1, 0x2bb0, // 15048
-    0x2baf, 0x2bae, 0x2bad, 0x2bad, 0x2bac, 0x2bab, 0x2baa, 0x2ba9, // 15056
-    0x2ba9, 0x2ba8, 0x2ba7, 0x2ba6, 0x2ba5, 0x2ba4, 0x2ba4, 0x2ba3, // 15064
-    0x2ba2, 0x2ba1, 0x2ba0, 0x2ba0, 0x2b9f, 0x2b9e, 0x2b9d, 0x2b9c, // 15072
-    0x2b9c, 0x2b9b, 0x2b9a, 0x2b99, 0x2b98, 0x2b98, 0x2b97, 0x2b96, // 15080
-    0x2b95, 0x2b94, 0x2b94, 0x2b93, 0x2b92, 0x2b91, 0x2b90, 0x2b90, // 15088
-    0x2b8f, 0x2b8e, 0x2b8d, 0x2b8c, 0x2b8b, 0x2b8b, 0x2b8a, 0x2b89, // 15096
-    0x2b88, 0x2b87, 0x2b87, 0x2b86, 0x2b85, 0x2b84, 0x2b83, 0x2b83, // 15104
-    0x2b82, 0x2b81, 0x2b80, 0x2b7f, 0x2b7f, 0x2b7e, 0x2b7d, 0x2b7c, // 15112
-    0x2b7b, 0x2b7b, 0x2b7a, 0x2b79, 0x2b78, 0x2b77, 0x2b77, 0x2b76, // 15120
-    0x2b75, 0x2b74, 0x2b73, 0x2b72, 0x2b72, 0x2b71, 0x2b70, 0x2b6f, // 15128
-    0x2b6e, 0x2b6e, 0x2b6d, 0x2b6c, 0x2b6b, 0x2b6a, 0x2b6a, 0x2b69, // 15136
-    0x2b68, 0x2b67, 0x2b66, 0x2b66, 0x2b65, 0x2b64, 0x2b63, 0x2b62, // 15144
-    0x2b62, 0x2b61, 0x2b60, 0x2b5f, 0x2b5e, 0x2b5d, 0x2b5d, 0x2b5c, // 15152
-    0x2b5b, 0x2b5a, 0x2b59, 0x2b59, 0x2b58, 0x2b57, 0x2b56, 0x2b55, // 15160
-    0x2b55, 0x2b54, 0x2b53, 0x2b52, 0x2b51, 0x2b51, 0x2b50, 0x2b4f, // 15168
-    0x2b4e, 0x2b4d, 0x2b4d, 0x2b4c, 0x2b4b, 0x2b4a, 0x2b49, 0x2b49, // 15176
-    0x2b48, 0x2b47, 0x2b46, 0x2b45, 0x2b44, 0x2b44, 0x2b43, 0x2b42, // 15184
-    0x2b41, 0x2b40, 0x2b40, 0x2b3f, 0x2b3e, 0x2b3d, 0x2b3c, 0x2b3c, // 15192
-    0x2b3b, 0x2b3a, 0x2b39, 0x2b38, 0x2b38, 0x2b37, 0x2b36, 0x2b35, // 15200
-    0x2b34, 0x2b34, 0x2b33, 0x2b32, 0x2b31, 0x2b30, 0x2b30, 0x2b2f, // 15208
-    0x2b2e, 0x2b2d, 0x2b2c, 0x2b2b, 0x2b2b, 0x2b2a, 0x2b29, 0x2b28, // 15216
-    0x2b27, 0x2b27, 0x2b26, 0x2b25, 0x2b24, 0x2b23, 0x2b23, 0x2b22, // 15224
-    0x2b21, 0x2b20, 0x2b1f, 0x2b1f, 0x2b1e, 0x2b1d, 0x2b1c, 0x2b1b, // 15232
-    0x2b1b, 0x2b1a, 0x2b19, 0x2b18, 0x2b17, 0x2b17, 0x2b16, 0x2b15, // 15240
-    0x2b14, 0x2b13, 0x2b12, 0x2b12, 0x2b11, 0x2b10, 0x2b0f, 0x2b0e, // 15248
-    0x2b0e, 0x2b0d, 0x2b0c, 0x2b0b, 0x2b0a, 0x2b0a, 0x2b09, 0x2b08, // 15256
-    0x2b07, 0x2b06, 0x2b06, 0x2b05, 0x2b04, 0x2b03, 0x2b02, 0x2b02, // 15264
-    0x2b01, 0x2b00, 0x2aff, 0x2afe, 0x2afe, 0x2afd, 0x2afc, 0x2afb, // 15272
-    0x2afa, 0x2af9, 0x2af9, 0x2af8, 0x2af7, 0x2af6, 0x2af5, 0x2af5, // 15280
-    0x2af4, 0x2af3, 0x2af2, 0x2af1, 0x2af1, 0x2af0, 0x2aef, 0x2aee, // 15288
-    0x2aed, 0x2aed, 0x2aec, 0x2aeb, 0x2aea, 0x2ae9, 0x2ae9, 0x2ae8, // 15296
-    0x2ae7, 0x2ae6, 0x2ae5, 0x2ae5, 0x2ae4, 0x2ae3, 0x2ae2, 0x2ae1, // 15304
-    0x2ae0, 0x2ae0, 0x2adf, 0x2ade, 0x2add, 0x2adc, 0x2adc, 0x2adb, // 15312
-    0x2ada, 0x2ad9, 0x2ad8, 0x2ad8, 0x2ad7, 0x2ad6, 0x2ad5, 0x2ad4, // 15320
-    0x2ad4, 0x2ad3, 0x2ad2, 0x2ad1, 0x2ad0, 0x2ad0, 0x2acf, 0x2ace, // 15328
-    0x2acd, 0x2acc, 0x2acb, 0x2acb, 0x2aca, 0x2ac9, 0x2ac8, 0x2ac7, // 15336
-    0x2ac7, 0x2ac6, 0x2ac5, 0x2ac4, 0x2ac3, 0x2ac3, 0x2ac2, 0x2ac1, // 15344
-    0x2ac0, 0x2abf, 0x2abf, 0x2abe, 0x2abd, 0x2abc, 0x2abb, 0x2abb, // 15352
-    0x2aba, 0x2ab9, 0x2ab9, 0x2ab8, 0x2ab7, 0x2ab6, 0x2ab6, 0x2ab5, // 15360
-    0x2ab4, 0x2ab3, 0x2ab2, 0x2ab2, 0x2ab1, 0x2ab0, 0x2aaf, 0x2aaf, // 15368
-    0x2aae, 0x2aad, 0x2aac, 0x2aab, 0x2aab, 0x2aaa, 0x2aa9, 0x2aa8, // 15376
-    0x2aa7, 0x2aa7, 0x2aa6, 0x2aa5, 0x2aa4, 0x2aa4, 0x2aa3, 0x2aa2, // 15384
-    0x2aa1, 0x2aa0, 0x2aa0, 0x2a9f, 0x2a9e, 0x2a9d, 0x2a9c, 0x2a9c, // 15392
-    0x2a9b, 0x2a9a, 0x2a99, 0x2a99, 0x2a98, 0x2a97, 0x2a96, 0x2a95, // 15400
-    0x2a95, 0x2a94, 0x2a93, 0x2a92, 0x2a92, 0x2a91, 0x2a90, 0x2a8f, // 15408
-    0x2a8e, 0x2a8e, 0x2a8d, 0x2a8c, 0x2a8b, 0x2a8a, 0x2a8a, 0x2a89, // 15416
-    0x2a88, 0x2a87, 0x2a87, 0x2a86, 0x2a85, 0x2a84, 0x2a83, 0x2a83, // 15424
-    0x2a82, 0x2a81, 0x2a80, 0x2a80, 0x2a7f, 0x2a7e, 0x2a7d, 0x2a7c, // 15432
-    0x2a7c, 0x2a7b, 0x2a7a, 0x2a79, 0x2a78, 0x2a78, 0x2a77, 0x2a76, // 15440
-    0x2a75, 0x2a75, 0x2a74, 0x2a73, 0x2a72, 0x2a71, 0x2a71, 0x2a70, // 15448
-    0x2a6f, 0x2a6e, 0x2a6d, 0x2a6d, 0x2a6c, 0x2a6b, 0x2a6a, 0x2a6a, // 15456
-    0x2a69, 0x2a68, 0x2a67, 0x2a66, 0x2a66, 0x2a65, 0x2a64, 0x2a63, // 15464
-    0x2a63, 0x2a62, 0x2a61, 0x2a60, 0x2a5f, 0x2a5f, 0x2a5e, 0x2a5d, // 15472
-    0x2a5c, 0x2a5b, 0x2a5b, 0x2a5a, 0x2a59, 0x2a58, 0x2a58, 0x2a57, // 15480
-    0x2a56, 0x2a55, 0x2a54, 0x2a54, 0x2a53, 0x2a52, 0x2a51, 0x2a51, // 15488
-    0x2a50, 0x2a4f, 0x2a4e, 0x2a4d, 0x2a4d, 0x2a4c, 0x2a4b, 0x2a4a, // 15496
-    0x2a49, 0x2a49, 0x2a48, 0x2a47, 0x2a46, 0x2a46, 0x2a45, 0x2a44, // 15504
-    0x2a43, 0x2a42, 0x2a42, 0x2a41, 0x2a40, 0x2a3f, 0x2a3f, 0x2a3e, // 15512
-    0x2a3d, 0x2a3c, 0x2a3b, 0x2a3b, 0x2a3a, 0x2a39, 0x2a38, 0x2a37, // 15520
-    0x2a37, 0x2a36, 0x2a35, 0x2a34, 0x2a34, 0x2a33, 0x2a32, 0x2a31, // 15528
-    0x2a30, 0x2a30, 0x2a2f, 0x2a2e, 0x2a2d, 0x2a2c, 0x2a2c, 0x2a2b, // 15536
-    0x2a2a, 0x2a29, 0x2a29, 0x2a28, 0x2a27, 0x2a26, 0x2a25, 0x2a25, // 15544
-    0x2a24, 0x2a23, 0x2a22, 0x2a22, 0x2a21, 0x2a20, 0x2a1f, 0x2a1e, // 15552
-    0x2a1e, 0x2a1d, 0x2a1c, 0x2a1b, 0x2a1a, 0x2a1a, 0x2a19, 0x2a18, // 15560
-    0x2a17, 0x2a17, 0x2a16, 0x2a15, 0x2a14, 0x2a13, 0x2a13, 0x2a12, // 15568
-    0x2a11, 0x2a10, 0x2a10, 0x2a0f, 0x2a0e, 0x2a0d, 0x2a0c, 0x2a0c, // 15576
-    0x2a0b, 0x2a0a, 0x2a09, 0x2a08, 0x2a08, 0x2a07, 0x2a06, 0x2a05, // 15584
-    0x2a05, 0x2a04, 0x2a03, 0x2a02, 0x2a01, 0x2a01, 0x2a00, 0x29ff, // 15592
-    0x29fe, 0x29fd, 0x29fd, 0x29fc, 0x29fb, 0x29fa, 0x29fa, 0x29f9, // 15600
-    0x29f8, 0x29f7, 0x29f6, 0x29f6, 0x29f5, 0x29f4, 0x29f3, 0x29f3, // 15608
-    0x29f2, 0x29f1, 0x29f0, 0x29ef, 0x29ef, 0x29ee, 0x29ed, 0x29ec, // 15616
-    0x29eb, 0x29eb, 0x29ea, 0x29e9, 0x29e8, 0x29e8, 0x29e7, 0x29e6, // 15624
-    0x29e5, 0x29e4, 0x29e4, 0x29e3, 0x29e2, 0x29e1, 0x29e1, 0x29e0, // 15632
-    0x29df, 0x29de, 0x29dd, 0x29dd, 0x29dc, 0x29db, 0x29da, 0x29d9, // 15640
-    0x29d9, 0x29d8, 0x29d7, 0x29d6, 0x29d6, 0x29d5, 0x29d4, 0x29d3, // 15648
-    0x29d2, 0x29d2, 0x29d1, 0x29d0, 0x29cf, 0x29cf, 0x29ce, 0x29cd, // 15656
-    0x29cc, 0x29cb, 0x29cb, 0x29ca, 0x29c9, 0x29c8, 0x29c7, 0x29c7, // 15664
-    0x29c6, 0x29c5, 0x29c4, 0x29c4, 0x29c3, 0x29c2, 0x29c1, 0x29c0, // 15672
-    0x29c0, 0x29bf, 0x29be, 0x29bd, 0x29bc, 0x29bc, 0x29bb, 0x29ba, // 15680
-    0x29b9, 0x29b9, 0x29b8, 0x29b7, 0x29b6, 0x29b5, 0x29b5, 0x29b4, // 15688
-    0x29b3, 0x29b2, 0x29b2, 0x29b1, 0x29b0, 0x29af, 0x29ae, 0x29ae, // 15696
-    0x29ad, 0x29ac, 0x29ab, 0x29aa, 0x29aa, 0x29a9, 0x29a8, 0x29a7, // 15704
-    0x29a7, 0x29a6, 0x29a5, 0x29a4, 0x29a3, 0x29a3, 0x29a2, 0x29a1, // 15712
-    0x29a0, 0x29a0, 0x299f, 0x299e, 0x299d, 0x299c, 0x299c, 0x299b, // 15720
-    0x299a, 0x2999, 0x2998, 0x2998, 0x2997, 0x2996, 0x2995, 0x2995, // 15728
-    0x2994, 0x2993, 0x2992, 0x2991, 0x2991, 0x2990, 0x298f, 0x298e, // 15736
-    0x298e, 0x298d, 0x298c, 0x298b, 0x298a, 0x298a, 0x2989, 0x2988, // 15744
-    0x2987, 0x2986, 0x2986, 0x2985, 0x2984, 0x2983, 0x2983, 0x2982, // 15752
-    0x2981, 0x2980, 0x297f, 0x297f, 0x297e, 0x297d, 0x297c, 0x297b, // 15760
-    0x297b, 0x297a, 0x2979, 0x2978, 0x2978, 0x2977, 0x2976, 0x2975, // 15768
-    0x2974, 0x2974, 0x2973, 0x2972, 0x2971, 0x2971, 0x2970, 0x296f, // 15776
-    0x296e, 0x296d, 0x296d, 0x296c, 0x296b, 0x296a, 0x2969, 0x2969, // 15784
-    0x2968, 0x2967, 0x2966, 0x2966, 0x2965, 0x2964, 0x2963, 0x2962, // 15792
-    0x2962, 0x2961, 0x2960, 0x295f, 0x295f, 0x295e, 0x295d, 0x295c, // 15800
-    0x295b, 0x295b, 0x295a, 0x2959, 0x2958, 0x2957, 0x2957, 0x2956, // 15808
-    0x2955, 0x2954, 0x2954, 0x2953, 0x2952, 0x2951, 0x2950, 0x2950, // 15816
-    0x294f, 0x294e, 0x294d, 0x294c, 0x294c, 0x294b, 0x294a, 0x2949, // 15824
-    0x2949, 0x2948, 0x2947, 0x2946, 0x2945, 0x2945, 0x2944, 0x2943, // 15832
-    0x2942, 0x2942, 0x2941, 0x2940, 0x293f, 0x293e, 0x293e, 0x293d, // 15840
-    0x293c, 0x293b, 0x293a, 0x293a, 0x2939, 0x2938, 0x2937, 0x2937, // 15848
-    0x2936, 0x2935, 0x2934, 0x2933, 0x2933, 0x2932, 0x2931, 0x2930, // 15856
-    0x2930, 0x292f, 0x292e, 0x292d, 0x292c, 0x292c, 0x292b, 0x292a, // 15864
-    0x2929, 0x2928, 0x2928, 0x2927, 0x2926, 0x2925, 0x2925, 0x2924, // 15872
-    0x2923, 0x2922, 0x2921, 0x2921, 0x2920, 0x291f, 0x291e, 0x291e, // 15880
-    0x291d, 0x291c, 0x291b, 0x291a, 0x291a, 0x2919, 0x2918, 0x2917, // 15888
-    0x2916, 0x2916, 0x2915, 0x2914, 0x2913, 0x2913, 0x2912, 0x2911, // 15896
-    0x2910, 0x290f, 0x290f, 0x290e, 0x290d, 0x290c, 0x290b, 0x290b, // 15904
-    0x290a, 0x2909, 0x2908, 0x2908, 0x2907, 0x2906, 0x2905, 0x2904, // 15912
-    0x2904, 0x2903, 0x2902, 0x2901, 0x2901, 0x2900, 0x28ff, 0x28fe, // 15920
-    0x28fd, 0x28fd, 0x28fc, 0x28fb, 0x28fa, 0x28f9, 0x28f9, 0x28f8, // 15928
-    0x28f7, 0x28f6, 0x28f6, 0x28f5, 0x28f4, 0x28f3, 0x28f2, 0x28f2, // 15936
-    0x28f1, 0x28f0, 0x28ef, 0x28ef, 0x28ee, 0x28ed, 0x28ec, 0x28eb, // 15944
-    0x28eb, 0x28ea, 0x28e9, 0x28e8, 0x28e7, 0x28e7, 0x28e6, 0x28e5, // 15952
-    0x28e4, 0x28e4, 0x28e3, 0x28e2, 0x28e1, 0x28e0, 0x28e0, 0x28df, // 15960
-    0x28de, 0x28dd, 0x28dc, 0x28dc, 0x28db, 0x28da, 0x28d9, 0x28d9, // 15968
-    0x28d8, 0x28d7, 0x28d6, 0x28d5, 0x28d5, 0x28d4, 0x28d3, 0x28d2, // 15976
-    0x28d2, 0x28d1, 0x28d0, 0x28cf, 0x28ce, 0x28ce, 0x28cd, 0x28cc, // 15984
-    0x28cb, 0x28ca, 0x28ca, 0x28c9, 0x28c8, 0x28c7, 0x28c7, 0x28c6, // 15992
-    0x28c5, 0x28c4, 0x28c3, 0x28c3, 0x28c2, 0x28c1, 0x28c0, 0x28c0, // 16000
-    0x28bf, 0x28be, 0x28bd, 0x28bc, 0x28bc, 0x28bb, 0x28ba, 0x28b9, // 16008
-    0x28b8, 0x28b8, 0x28b7, 0x28b6, 0x28b5, 0x28b5, 0x28b4, 0x28b3, // 16016
-    0x28b2, 0x28b1, 0x28b1, 0x28b0, 0x28af, 0x28ae, 0x28ae, 0x28ad, // 16024
-    0x28ac, 0x28ab, 0x28aa, 0x28aa, 0x28a9, 0x28a8, 0x28a7, 0x28a6, // 16032
-    0x28a6, 0x28a5, 0x28a4, 0x28a3, 0x28a3, 0x28a2, 0x28a1, 0x28a0, // 16040
-    0x289f, 0x289f, 0x289e, 0x289d, 0x289c, 0x289b, 0x289b, 0x289a, // 16048
-    0x2899, 0x2898, 0x2898, 0x2897, 0x2896, 0x2895, 0x2894, 0x2894, // 16056
-    0x2893, 0x2892, 0x2891, 0x2891, 0x2890, 0x288f, 0x288e, 0x288d, // 16064
-    0x288d, 0x288c, 0x288b, 0x288a, 0x2889, 0x2889, 0x2888, 0x2887, // 16072
-    0x2886, 0x2886, 0x2885, 0x2884, 0x2883, 0x2882, 0x2882, 0x2881, // 16080
-    0x2880, 0x287f, 0x287f, 0x287e, 0x287d, 0x287c, 0x287b, 0x287b, // 16088
-    0x287a, 0x2879, 0x2878, 0x2877, 0x2877, 0x2876, 0x2875, 0x2874, // 16096
-    0x2874, 0x2873, 0x2872, 0x2871, 0x2870, 0x2870, 0x286f, 0x286e, // 16104
-    0x286d, 0x286c, 0x286c, 0x286b, 0x286a, 0x2869, 0x2869, 0x2868, // 16112
-    0x2867, 0x2866, 0x2865, 0x2865, 0x2864, 0x2863, 0x2862, 0x2862, // 16120
-    0x2861, 0x2860, 0x285f, 0x285e, 0x285e, 0x285d, 0x285c, 0x285b, // 16128
-    0x285a, 0x285a, 0x2859, 0x2858, 0x2857, 0x2857, 0x2856, 0x2855, // 16136
-    0x2854, 0x2853, 0x2853, 0x2852, 0x2851, 0x2850, 0x2850, 0x284f, // 16144
-    0x284e, 0x284d, 0x284c, 0x284c, 0x284b, 0x284a, 0x2849, 0x2848, // 16152
-    0x2848, 0x2847, 0x2846, 0x2845, 0x2845, 0x2844, 0x2843, 0x2842, // 16160
-    0x2841, 0x2841, 0x2840, 0x283f, 0x283e, 0x283e, 0x283d, 0x283c, // 16168
-    0x283b, 0x283a, 0x283a, 0x2839, 0x2838, 0x2837, 0x2836, 0x2836, // 16176
-    0x2835, 0x2834, 0x2833, 0x2833, 0x2832, 0x2831, 0x2830, 0x282f, // 16184
-    0x282f, 0x282e, 0x282d, 0x282c, 0x282b, 0x282b, 0x282a, 0x2829, // 16192
-    0x2828, 0x2828, 0x2827, 0x2826, 0x2825, 0x2824, 0x2824, 0x2823, // 16200
-    0x2822, 0x2821, 0x2821, 0x2820, 0x281f, 0x281e, 0x281d, 0x281d, // 16208
-    0x281c, 0x281b, 0x281a, 0x2819, 0x2819, 0x2818, 0x2817, 0x2816, // 16216
-    0x2816, 0x2815, 0x2814, 0x2813, 0x2812, 0x2812, 0x2811, 0x2810, // 16224
-    0x280f, 0x280f, 0x280e, 0x280d, 0x280c, 0x280b, 0x280b, 0x280a, // 16232
-    0x2809, 0x2808, 0x2807, 0x2807, 0x2806, 0x2805, 0x2804, 0x2804, // 16240
-    0x2803, 0x2802, 0x2801, 0x2800, 0x2800, 0x27ff, 0x27fe, 0x27fd, // 16248
-    0x27fd, 0x27fc, 0x27fb, 0x27fa, 0x27f9, 0x27f9, 0x27f8, 0x27f7, // 16256
-    0x27f6, 0x27f5, 0x27f5, 0x27f4, 0x27f3, 0x27f2, 0x27f2, 0x27f1, // 16264
-    0x27f0, 0x27ef, 0x27ee, 0x27ee, 0x27ed, 0x27ec, 0x27eb, 0x27ea, // 16272
-    0x27ea, 0x27e9, 0x27e8, 0x27e7, 0x27e7, 0x27e6, 0x27e5, 0x27e4, // 16280
-    0x27e3, 0x27e3, 0x27e2, 0x27e1, 0x27e0, 0x27e0, 0x27df, 0x27de, // 16288
-    0x27dd, 0x27dc, 0x27dc, 0x27db, 0x27da, 0x27d9, 0x27d8, 0x27d8, // 16296
-    0x27d7, 0x27d6, 0x27d5, 0x27d5, 0x27d4, 0x27d3, 0x27d2, 0x27d1, // 16304
-    0x27d1, 0x27d0, 0x27cf, 0x27ce, 0x27ce, 0x27cd, 0x27cc, 0x27cb, // 16312
-    0x27ca, 0x27ca, 0x27c9, 0x27c8, 0x27c7, 0x27c6, 0x27c6, 0x27c5, // 16320
-    0x27c4, 0x27c3, 0x27c3, 0x27c2, 0x27c1, 0x27c0, 0x27bf, 0x27bf, // 16328
-    0x27be, 0x27bd, 0x27bc, 0x27bb, 0x27bb, 0x27ba, 0x27b9, 0x27b8, // 16336
-    0x27b8, 0x27b7, 0x27b6, 0x27b5, 0x27b4, 0x27b4, 0x27b3, 0x27b2, // 16344
-    0x27b1, 0x27b1, 0x27b0, 0x27af, 0x27ae, 0x27ad, 0x27ad, 0x27ac, // 16352
-    0x27ab, 0x27aa, 0x27a9, 0x27a9, 0x27a8, 0x27a7, 0x27a6, 0x27a6, // 16360
-    0x27a5, 0x27a4, 0x27a3, 0x27a2, 0x27a2, 0x27a1, 0x27a0, 0x279f, // 16368
-    0x279f, 0x279e, 0x279d, 0x279c, 0x279b, 0x279b, 0x279a, 0x2799, // 16376
-    0x2799, 0x2798, 0x2798, 0x2797, 0x2796, 0x2795, 0x2795, 0x2794, // 16384
-    0x2793, 0x2792, 0x2792, 0x2791, 0x2790, 0x278f, 0x278f, 0x278e, // 16392
-    0x278d, 0x278c, 0x278c, 0x278b, 0x278a, 0x2789, 0x2789, 0x2788, // 16400
-    0x2787, 0x2786, 0x2785, 0x2785, 0x2784, 0x2783, 0x2782, 0x2782, // 16408
-    0x2781, 0x2780, 0x277f, 0x277f, 0x277e, 0x277d, 0x277c, 0x277c, // 16416
-    0x277b, 0x277a, 0x2779, 0x2779, 0x2778, 0x2777, 0x2776, 0x2776, // 16424
-    0x2775, 0x2774, 0x2773, 0x2773, 0x2772, 0x2771, 0x2770, 0x276f, // 16432
-    0x276f, 0x276e, 0x276d, 0x276c, 0x276c, 0x276b, 0x276a, 0x2769, // 16440
-    0x2769, 0x2768, 0x2767, 0x2766, 0x2766, 0x2765, 0x2764, 0x2763, // 16448
-    0x2763, 0x2762, 0x2761, 0x2760, 0x2760, 0x275f, 0x275e, 0x275d, // 16456
-    0x275c, 0x275c, 0x275b, 0x275a, 0x2759, 0x2759, 0x2758, 0x2757, // 16464
-    0x2756, 0x2756, 0x2755, 0x2754, 0x2753, 0x2753, 0x2752, 0x2751, // 16472
-    0x2750, 0x2750, 0x274f, 0x274e, 0x274d, 0x274d, 0x274c, 0x274b, // 16480
-    0x274a, 0x2749, 0x2749, 0x2748, 0x2747, 0x2746, 0x2746, 0x2745, // 16488
-    0x2744, 0x2743, 0x2743, 0x2742, 0x2741, 0x2740, 0x2740, 0x273f, // 16496
-    0x273e, 0x273d, 0x273d, 0x273c, 0x273b, 0x273a, 0x273a, 0x2739, // 16504
-    0x2738, 0x2737, 0x2736, 0x2736, 0x2735, 0x2734, 0x2733, 0x2733, // 16512
-    0x2732, 0x2731, 0x2730, 0x2730, 0x272f, 0x272e, 0x272d, 0x272d, // 16520
-    0x272c, 0x272b, 0x272a, 0x272a, 0x2729, 0x2728, 0x2727, 0x2727, // 16528
-    0x2726, 0x2725, 0x2724, 0x2723, 0x2723, 0x2722, 0x2721, 0x2720, // 16536
-    0x2720, 0x271f, 0x271e, 0x271d, 0x271d, 0x271c, 0x271b, 0x271a, // 16544
-    0x271a, 0x2719, 0x2718, 0x2717, 0x2717, 0x2716, 0x2715, 0x2714, // 16552
-    0x2714, 0x2713, 0x2712, 0x2711, 0x2710, 0x2710, 0x270f, 0x270e, // 16560
-    0x270d, 0x270d, 0x270c, 0x270b, 0x270a, 0x270a, 0x2709, 0x2708, // 16568
-    0x2707, 0x2707, 0x2706, 0x2705, 0x2704, 0x2704, 0x2703, 0x2702, // 16576
-    0x2701, 0x2701, 0x2700, 0x26ff, 0x26fe, 0x26fd, 0x26fd, 0x26fc, // 16584
-    0x26fb, 0x26fa, 0x26fa, 0x26f9, 0x26f8, 0x26f7, 0x26f7, 0x26f6, // 16592
-    0x26f5, 0x26f4, 0x26f4, 0x26f3, 0x26f2, 0x26f1, 0x26f1, 0x26f0, // 16600
-    0x26ef, 0x26ee, 0x26ee, 0x26ed, 0x26ec, 0x26eb, 0x26eb, 0x26ea, // 16608
-    0x26e9, 0x26e8, 0x26e7, 0x26e7, 0x26e6, 0x26e5, 0x26e4, 0x26e4, // 16616
-    0x26e3, 0x26e2, 0x26e1, 0x26e1, 0x26e0, 0x26df, 0x26de, 0x26de, // 16624
-    0x26dd, 0x26dc, 0x26db, 0x26db, 0x26da, 0x26d9, 0x26d8, 0x26d8, // 16632
-    0x26d7, 0x26d6, 0x26d5, 0x26d4, 0x26d4, 0x26d3, 0x26d2, 0x26d1, // 16640
-    0x26d1, 0x26d0, 0x26cf, 0x26ce, 0x26ce, 0x26cd, 0x26cc, 0x26cb, // 16648
-    0x26cb, 0x26ca, 0x26c9, 0x26c8, 0x26c8, 0x26c7, 0x26c6, 0x26c5, // 16656
-    0x26c5, 0x26c4, 0x26c3, 0x26c2, 0x26c1, 0x26c1, 0x26c0, 0x26bf, // 16664
-    0x26be, 0x26be, 0x26bd, 0x26bc, 0x26bb, 0x26bb, 0x26ba, 0x26b9, // 16672
-    0x26b8, 0x26b8, 0x26b7, 0x26b6, 0x26b5, 0x26b5, 0x26b4, 0x26b3, // 16680
-    0x26b2, 0x26b2, 0x26b1, 0x26b0, 0x26af, 0x26ae, 0x26ae, 0x26ad, // 16688
-    0x26ac, 0x26ab, 0x26ab, 0x26aa, 0x26a9, 0x26a8, 0x26a8, 0x26a7, // 16696
-    0x26a6, 0x26a5, 0x26a5, 0x26a4, 0x26a3, 0x26a2, 0x26a2, 0x26a1, // 16704
-    0x26a0, 0x269f, 0x269f, 0x269e, 0x269d, 0x269c, 0x269b, 0x269b, // 16712
-    0x269a, 0x2699, 0x2698, 0x2698, 0x2697, 0x2696, 0x2695, 0x2695, // 16720
-    0x2694, 0x2693, 0x2692, 0x2692, 0x2691, 0x2690, 0x268f, 0x268f, // 16728
-    0x268e, 0x268d, 0x268c, 0x268c, 0x268b, 0x268a, 0x2689, 0x2688, // 16736
-    0x2688, 0x2687, 0x2686, 0x2685, 0x2685, 0x2684, 0x2683, 0x2682, // 16744
-    0x2682, 0x2681, 0x2680, 0x267f, 0x267f, 0x267e, 0x267d, 0x267c, // 16752
-    0x267c, 0x267b, 0x267a, 0x2679, 0x2679, 0x2678, 0x2677, 0x2676, // 16760
-    0x2676, 0x2675, 0x2674, 0x2673, 0x2672, 0x2672, 0x2671, 0x2670, // 16768
-    0x266f, 0x266f, 0x266e, 0x266d, 0x266c, 0x266c, 0x266b, 0x266a, // 16776
-    0x2669, 0x2669, 0x2668, 0x2667, 0x2666, 0x2666, 0x2665, 0x2664, // 16784
-    0x2663, 0x2663, 0x2662, 0x2661, 0x2660, 0x265f, 0x265f, 0x265e, // 16792
-    0x265d, 0x265c, 0x265c, 0x265b, 0x265a, 0x2659, 0x2659, 0x2658, // 16800
-    0x2657, 0x2656, 0x2656, 0x2655, 0x2654, 0x2653, 0x2653, 0x2652, // 16808
-    0x2651, 0x2650, 0x2650, 0x264f, 0x264e, 0x264d, 0x264c, 0x264c, // 16816
-    0x264b, 0x264a, 0x2649, 0x2649, 0x2648, 0x2647, 0x2646, 0x2646, // 16824
-    0x2645, 0x2644, 0x2643, 0x2643, 0x2642, 0x2641, 0x2640, 0x2640, // 16832
-    0x263f, 0x263e, 0x263d, 0x263d, 0x263c, 0x263b, 0x263a, 0x2639, // 16840
-    0x2639, 0x2638, 0x2637, 0x2636, 0x2636, 0x2635, 0x2634, 0x2633, // 16848
-    0x2633, 0x2632, 0x2631, 0x2630, 0x2630, 0x262f, 0x262e, 0x262d, // 16856
-    0x262d, 0x262c, 0x262b, 0x262a, 0x262a, 0x2629, 0x2628, 0x2627, // 16864
-    0x2626, 0x2626, 0x2625, 0x2624, 0x2623, 0x2623, 0x2622, 0x2621, // 16872
-    0x2620, 0x2620, 0x261f, 0x261e, 0x261d, 0x261d, 0x261c, 0x261b, // 16880
-    0x261a, 0x261a, 0x2619, 0x2618, 0x2617, 0x2617, 0x2616, 0x2615, // 16888
-    0x2614, 0x2613, 0x2613, 0x2612, 0x2611, 0x2610, 0x2610, 0x260f, // 16896
-    0x260e, 0x260d, 0x260d, 0x260c, 0x260b, 0x260a, 0x260a, 0x2609, // 16904
-    0x2608, 0x2607, 0x2607, 0x2606, 0x2605, 0x2604, 0x2604, 0x2603, // 16912
-    0x2602, 0x2601, 0x2600, 0x2600, 0x25ff, 0x25fe, 0x25fd, 0x25fd, // 16920
-    0x25fc, 0x25fb, 0x25fa, 0x25fa, 0x25f9, 0x25f8, 0x25f7, 0x25f7, // 16928
-    0x25f6, 0x25f5, 0x25f4, 0x25f4, 0x25f3, 0x25f2, 0x25f1, 0x25f1, // 16936
-    0x25f0, 0x25ef, 0x25ee, 0x25ee, 0x25ed, 0x25ec, 0x25eb, 0x25ea, // 16944
-    0x25ea, 0x25e9, 0x25e8, 0x25e7, 0x25e7, 0x25e6, 0x25e5, 0x25e4, // 16952
-    0x25e4, 0x25e3, 0x25e2, 0x25e1, 0x25e1, 0x25e0, 0x25df, 0x25de, // 16960
-    0x25de, 0x25dd, 0x25dc, 0x25db, 0x25db, 0x25da, 0x25d9, 0x25d8, // 16968
-    0x25d7, 0x25d7, 0x25d6, 0x25d5, 0x25d4, 0x25d4, 0x25d3, 0x25d2, // 16976
-    0x25d1, 0x25d1, 0x25d0, 0x25cf, 0x25ce, 0x25ce, 0x25cd, 0x25cc, // 16984
-    0x25cb, 0x25cb, 0x25ca, 0x25c9, 0x25c8, 0x25c8, 0x25c7, 0x25c6, // 16992
-    0x25c5, 0x25c4, 0x25c4, 0x25c3, 0x25c2, 0x25c1, 0x25c1, 0x25c0, // 17000
-    0x25bf, 0x25be, 0x25be, 0x25bd, 0x25bc, 0x25bb, 0x25bb, 0x25ba, // 17008
-    0x25b9, 0x25b8, 0x25b8, 0x25b7, 0x25b6, 0x25b5, 0x25b5, 0x25b4, // 17016
-    0x25b3, 0x25b2, 0x25b1, 0x25b1, 0x25b0, 0x25af, 0x25ae, 0x25ae, // 17024
-    0x25ad, 0x25ac, 0x25ab, 0x25ab, 0x25aa, 0x25a9, 0x25a8, 0x25a8, // 17032
-    0x25a7, 0x25a6, 0x25a5, 0x25a5, 0x25a4, 0x25a3, 0x25a2, 0x25a2, // 17040
-    0x25a1, 0x25a0, 0x259f, 0x259e, 0x259e, 0x259d, 0x259c, 0x259b, // 17048
-    0x259b, 0x259a, 0x2599, 0x2598, 0x2598, 0x2597, 0x2596, 0x2595, // 17056
-    0x2595, 0x2594, 0x2593, 0x2592, 0x2592, 0x2591, 0x2590, 0x258f, // 17064
-    0x258f, 0x258e, 0x258d, 0x258c, 0x258b, 0x258b, 0x258a, 0x2589, // 17072
-    0x2588, 0x2588, 0x2587, 0x2586, 0x2585, 0x2585, 0x2584, 0x2583, // 17080
-    0x2582, 0x2582, 0x2581, 0x2580, 0x257f, 0x257f, 0x257e, 0x257d, // 17088
-    0x257c, 0x257c, 0x257b, 0x257a, 0x2579, 0x2578, 0x2578, 0x2577, // 17096
-    0x2576, 0x2575, 0x2575, 0x2574, 0x2573, 0x2572, 0x2572, 0x2571, // 17104
-    0x2570, 0x256f, 0x256f, 0x256e, 0x256d, 0x256c, 0x256c, 0x256b, // 17112
-    0x256a, 0x2569, 0x2569, 0x2568, 0x2567, 0x2566, 0x2566, 0x2565, // 17120
-    0x2564, 0x2563, 0x2562, 0x2562, 0x2561, 0x2560, 0x255f, 0x255f, // 17128
-    0x255e, 0x255d, 0x255c, 0x255c, 0x255b, 0x255a, 0x2559, 0x2559, // 17136
-    0x2558, 0x2557, 0x2556, 0x2556, 0x2555, 0x2554, 0x2553, 0x2553, // 17144
-    0x2552, 0x2551, 0x2550, 0x254f, 0x254f, 0x254e, 0x254d, 0x254c, // 17152
-    0x254c, 0x254b, 0x254a, 0x2549, 0x2549, 0x2548, 0x2547, 0x2546, // 17160
-    0x2546, 0x2545, 0x2544, 0x2543, 0x2543, 0x2542, 0x2541, 0x2540, // 17168
-    0x2540, 0x253f, 0x253e, 0x253d, 0x253c, 0x253c, 0x253b, 0x253a, // 17176
-    0x2539, 0x2539, 0x2538, 0x2537, 0x2536, 0x2536, 0x2535, 0x2534, // 17184
-    0x2533, 0x2533, 0x2532, 0x2531, 0x2530, 0x2530, 0x252f, 0x252e, // 17192
-    0x252d, 0x252d, 0x252c, 0x252b, 0x252a, 0x2529, 0x2529, 0x2528, // 17200
-    0x2527, 0x2526, 0x2526, 0x2525, 0x2524, 0x2523, 0x2523, 0x2522, // 17208
-    0x2521, 0x2520, 0x2520, 0x251f, 0x251e, 0x251d, 0x251d, 0x251c, // 17216
-    0x251b, 0x251a, 0x251a, 0x2519, 0x2518, 0x2517, 0x2516, 0x2516, // 17224
-    0x2515, 0x2514, 0x2513, 0x2513, 0x2512, 0x2511, 0x2510, 0x2510, // 17232
-    0x250f, 0x250e, 0x250d, 0x250d, 0x250c, 0x250b, 0x250a, 0x250a, // 17240
-    0x2509, 0x2508, 0x2507, 0x2507, 0x2506, 0x2505, 0x2504, 0x2503, // 17248
-    0x2503, 0x2502, 0x2501, 0x2500, 0x2500, 0x24ff, 0x24fe, 0x24fd, // 17256
-    0x24fd, 0x24fc, 0x24fb, 0x24fa, 0x24fa, 0x24f9, 0x24f8, 0x24f7, // 17264
-    0x24f7, 0x24f6, 0x24f5, 0x24f4, 0x24f4, 0x24f3, 0x24f2, 0x24f1, // 17272
-    0x24f1, 0x24f0, 0x24ef, 0x24ee, 0x24ed, 0x24ed, 0x24ec, 0x24eb, // 17280
-    0x24ea, 0x24ea, 0x24e9, 0x24e8, 0x24e7, 0x24e7, 0x24e6, 0x24e5, // 17288
-    0x24e4, 0x24e4, 0x24e3, 0x24e2, 0x24e1, 0x24e1, 0x24e0, 0x24df, // 17296
-    0x24de, 0x24de, 0x24dd, 0x24dc, 0x24db, 0x24da, 0x24da, 0x24d9, // 17304
-    0x24d8, 0x24d7, 0x24d7, 0x24d6, 0x24d5, 0x24d4, 0x24d4, 0x24d3, // 17312
-    0x24d2, 0x24d1, 0x24d1, 0x24d0, 0x24cf, 0x24ce, 0x24ce, 0x24cd, // 17320
-    0x24cc, 0x24cb, 0x24cb, 0x24ca, 0x24c9, 0x24c8, 0x24c7, 0x24c7, // 17328
-    0x24c6, 0x24c5, 0x24c4, 0x24c4, 0x24c3, 0x24c2, 0x24c1, 0x24c1, // 17336
-    0x24c0, 0x24bf, 0x24be, 0x24be, 0x24bd, 0x24bc, 0x24bb, 0x24bb, // 17344
-    0x24ba, 0x24b9, 0x24b8, 0x24b8, 0x24b7, 0x24b6, 0x24b5, 0x24b4, // 17352
-    0x24b4, 0x24b3, 0x24b2, 0x24b1, 0x24b1, 0x24b0, 0x24af, 0x24ae, // 17360
-    0x24ae, 0x24ad, 0x24ac, 0x24ab, 0x24ab, 0x24aa, 0x24a9, 0x24a8, // 17368
-    0x24a8, 0x24a7, 0x24a6, 0x24a5, 0x24a5, 0x24a4, 0x24a3, 0x24a2, // 17376
-    0x24a1, 0x24a1, 0x24a0, 0x249f, 0x249e, 0x249e, 0x249d, 0x249c, // 17384
-    0x249b, 0x249b, 0x249a, 0x2499, 0x2498, 0x2498, 0x2497, 0x2496, // 17392
-    0x2495, 0x2495, 0x2494, 0x2493, 0x2492, 0x2492, 0x2491, 0x2490, // 17400
-    0x2490, 0x2490, 0x248f, 0x248e, 0x248d, 0x248d, 0x248c, 0x248b, // 17408
-    0x248a, 0x248a, 0x2489, 0x2488, 0x2487, 0x2487, 0x2486, 0x2485, // 17416
-    0x2484, 0x2484, 0x2483, 0x2482, 0x2482, 0x2481, 0x2480, 0x247f, // 17424
-    0x247f, 0x247e, 0x247d, 0x247c, 0x247c, 0x247b, 0x247a, 0x2479, // 17432
-    0x2479, 0x2478, 0x2477, 0x2476, 0x2476, 0x2475, 0x2474, 0x2474, // 17440
-    0x2473, 0x2472, 0x2471, 0x2471, 0x2470, 0x246f, 0x246e, 0x246e, // 17448
-    0x246d, 0x246c, 0x246b, 0x246b, 0x246a, 0x2469, 0x2468, 0x2468, // 17456
-    0x2467, 0x2466, 0x2466, 0x2465, 0x2464, 0x2463, 0x2463, 0x2462, // 17464
-    0x2461, 0x2460, 0x2460, 0x245f, 0x245e, 0x245d, 0x245d, 0x245c, // 17472
-    0x245b, 0x245a, 0x245a, 0x2459, 0x2458, 0x2458, 0x2457, 0x2456, // 17480
-    0x2455, 0x2455, 0x2454, 0x2453, 0x2452, 0x2452, 0x2451, 0x2450, // 17488
-    0x244f, 0x244f, 0x244e, 0x244d, 0x244d, 0x244c, 0x244b, 0x244a, // 17496
-    0x244a, 0x2449, 0x2448, 0x2447, 0x2447, 0x2446, 0x2445, 0x2444, // 17504
-    0x2444, 0x2443, 0x2442, 0x2441, 0x2441, 0x2440, 0x243f, 0x243f, // 17512
-    0x243e, 0x243d, 0x243c, 0x243c, 0x243b, 0x243a, 0x2439, 0x2439, // 17520
-    0x2438, 0x2437, 0x2436, 0x2436, 0x2435, 0x2434, 0x2433, 0x2433, // 17528
-    0x2432, 0x2431, 0x2431, 0x2430, 0x242f, 0x242e, 0x242e, 0x242d, // 17536
-    0x242c, 0x242b, 0x242b, 0x242a, 0x2429, 0x2428, 0x2428, 0x2427, // 17544
-    0x2426, 0x2425, 0x2425, 0x2424, 0x2423, 0x2423, 0x2422, 0x2421, // 17552
-    0x2420, 0x2420, 0x241f, 0x241e, 0x241d, 0x241d, 0x241c, 0x241b, // 17560
-    0x241a, 0x241a, 0x2419, 0x2418, 0x2417, 0x2417, 0x2416, 0x2415, // 17568
-    0x2415, 0x2414, 0x2413, 0x2412, 0x2412, 0x2411, 0x2410, 0x240f, // 17576
-    0x240f, 0x240e, 0x240d, 0x240c, 0x240c, 0x240b, 0x240a, 0x240a, // 17584
-    0x2409, 0x2408, 0x2407, 0x2407, 0x2406, 0x2405, 0x2404, 0x2404, // 17592
-    0x2403, 0x2402, 0x2401, 0x2401, 0x2400, 0x23ff, 0x23fe, 0x23fe, // 17600
-    0x23fd, 0x23fc, 0x23fc, 0x23fb, 0x23fa, 0x23f9, 0x23f9, 0x23f8, // 17608
-    0x23f7, 0x23f6, 0x23f6, 0x23f5, 0x23f4, 0x23f3, 0x23f3, 0x23f2, // 17616
-    0x23f1, 0x23f0, 0x23f0, 0x23ef, 0x23ee, 0x23ee, 0x23ed, 0x23ec, // 17624
-    0x23eb, 0x23eb, 0x23ea, 0x23e9, 0x23e8, 0x23e8, 0x23e7, 0x23e6, // 17632
-    0x23e5, 0x23e5, 0x23e4, 0x23e3, 0x23e2, 0x23e2, 0x23e1, 0x23e0, // 17640
-    0x23e0, 0x23df, 0x23de, 0x23dd, 0x23dd, 0x23dc, 0x23db, 0x23da, // 17648
-    0x23da, 0x23d9, 0x23d8, 0x23d7, 0x23d7, 0x23d6, 0x23d5, 0x23d4, // 17656
-    0x23d4, 0x23d3, 0x23d2, 0x23d2, 0x23d1, 0x23d0, 0x23cf, 0x23cf, // 17664
-    0x23ce, 0x23cd, 0x23cc, 0x23cc, 0x23cb, 0x23ca, 0x23c9, 0x23c9, // 17672
-    0x23c8, 0x23c7, 0x23c6, 0x23c6, 0x23c5, 0x23c4, 0x23c4, 0x23c3, // 17680
-    0x23c2, 0x23c1, 0x23c1, 0x23c0, 0x23bf, 0x23be, 0x23be, 0x23bd, // 17688
-    0x23bc, 0x23bb, 0x23bb, 0x23ba, 0x23b9, 0x23b9, 0x23b8, 0x23b7, // 17696
-    0x23b6, 0x23b6, 0x23b5, 0x23b4, 0x23b3, 0x23b3, 0x23b2, 0x23b1, // 17704
-    0x23b0, 0x23b0, 0x23af, 0x23ae, 0x23ad, 0x23ad, 0x23ac, 0x23ab, // 17712
-    0x23ab, 0x23aa, 0x23a9, 0x23a8, 0x23a8, 0x23a7, 0x23a6, 0x23a5, // 17720
-    0x23a5, 0x23a4, 0x23a3, 0x23a2, 0x23a2, 0x23a1, 0x23a0, 0x239f, // 17728
-    0x239f, 0x239e, 0x239d, 0x239d, 0x239c, 0x239b, 0x239a, 0x239a, // 17736
-    0x2399, 0x2398, 0x2397, 0x2397, 0x2396, 0x2395, 0x2394, 0x2394, // 17744
-    0x2393, 0x2392, 0x2391, 0x2391, 0x2390, 0x238f, 0x238f, 0x238e, // 17752
-    0x238d, 0x238c, 0x238c, 0x238b, 0x238a, 0x2389, 0x2389, 0x2388, // 17760
-    0x2387, 0x2386, 0x2386, 0x2385, 0x2384, 0x2383, 0x2383, 0x2382, // 17768
-    0x2381, 0x2381, 0x2380, 0x237f, 0x237e, 0x237e, 0x237d, 0x237c, // 17776
-    0x237b, 0x237b, 0x237a, 0x2379, 0x2378, 0x2378, 0x2377, 0x2376, // 17784
-    0x2376, 0x2375, 0x2374, 0x2373, 0x2373, 0x2372, 0x2371, 0x2370, // 17792
-    0x2370, 0x236f, 0x236e, 0x236d, 0x236d, 0x236c, 0x236b, 0x236a, // 17800
-    0x236a, 0x2369, 0x2368, 0x2368, 0x2367, 0x2366, 0x2365, 0x2365, // 17808
-    0x2364, 0x2363, 0x2362, 0x2362, 0x2361, 0x2360, 0x235f, 0x235f, // 17816
-    0x235e, 0x235d, 0x235c, 0x235c, 0x235b, 0x235a, 0x235a, 0x2359, // 17824
-    0x2358, 0x2357, 0x2357, 0x2356, 0x2355, 0x2354, 0x2354, 0x2353, // 17832
-    0x2352, 0x2351, 0x2351, 0x2350, 0x234f, 0x234e, 0x234e, 0x234d, // 17840
-    0x234c, 0x234c, 0x234b, 0x234a, 0x2349, 0x2349, 0x2348, 0x2347, // 17848
-    0x2346, 0x2346, 0x2345, 0x2344, 0x2343, 0x2343, 0x2342, 0x2341, // 17856
-    0x2340, 0x2340, 0x233f, 0x233e, 0x233e, 0x233d, 0x233c, 0x233b, // 17864
-    0x233b, 0x233a, 0x2339, 0x2338, 0x2338, 0x2337, 0x2336, 0x2335, // 17872
-    0x2335, 0x2334, 0x2333, 0x2332, 0x2332, 0x2331, 0x2330, 0x2330, // 17880
-    0x232f, 0x232e, 0x232d, 0x232d, 0x232c, 0x232b, 0x232a, 0x232a, // 17888
-    0x2329, 0x2328, 0x2327, 0x2327, 0x2326, 0x2325, 0x2325, 0x2324, // 17896
-    0x2323, 0x2322, 0x2322, 0x2321, 0x2320, 0x231f, 0x231f, 0x231e, // 17904
-    0x231d, 0x231c, 0x231c, 0x231b, 0x231a, 0x2319, 0x2319, 0x2318, // 17912
-    0x2317, 0x2317, 0x2316, 0x2315, 0x2314, 0x2314, 0x2313, 0x2312, // 17920
-    0x2311, 0x2311, 0x2310, 0x230f, 0x230e, 0x230e, 0x230d, 0x230c, // 17928
-    0x230b, 0x230b, 0x230a, 0x2309, 0x2309, 0x2308, 0x2307, 0x2306, // 17936
-    0x2306, 0x2305, 0x2304, 0x2303, 0x2303, 0x2302, 0x2301, 0x2300, // 17944
-    0x2300, 0x22ff, 0x22fe, 0x22fd, 0x22fd, 0x22fc, 0x22fb, 0x22fb, // 17952
-    0x22fa, 0x22f9, 0x22f8, 0x22f8, 0x22f7, 0x22f6, 0x22f5, 0x22f5, // 17960
-    0x22f4, 0x22f3, 0x22f2, 0x22f2, 0x22f1, 0x22f0, 0x22ef, 0x22ef, // 17968
-    0x22ee, 0x22ed, 0x22ed, 0x22ec, 0x22eb, 0x22ea, 0x22ea, 0x22e9, // 17976
-    0x22e8, 0x22e7, 0x22e7, 0x22e6, 0x22e5, 0x22e4, 0x22e4, 0x22e3, // 17984
-    0x22e2, 0x22e1, 0x22e1, 0x22e0, 0x22df, 0x22df, 0x22de, 0x22dd, // 17992
-    0x22dc, 0x22dc, 0x22db, 0x22da, 0x22d9, 0x22d9, 0x22d8, 0x22d7, // 18000
-    0x22d6, 0x22d6, 0x22d5, 0x22d4, 0x22d4, 0x22d3, 0x22d2, 0x22d1, // 18008
-    0x22d1, 0x22d0, 0x22cf, 0x22ce, 0x22ce, 0x22cd, 0x22cc, 0x22cb, // 18016
-    0x22cb, 0x22ca, 0x22c9, 0x22c8, 0x22c8, 0x22c7, 0x22c6, 0x22c6, // 18024
-    0x22c5, 0x22c4, 0x22c3, 0x22c3, 0x22c2, 0x22c1, 0x22c0, 0x22c0, // 18032
-    0x22bf, 0x22be, 0x22bd, 0x22bd, 0x22bc, 0x22bb, 0x22ba, 0x22ba, // 18040
-    0x22b9, 0x22b8, 0x22b8, 0x22b7, 0x22b6, 0x22b5, 0x22b5, 0x22b4, // 18048
-    0x22b3, 0x22b2, 0x22b2, 0x22b1, 0x22b0, 0x22af, 0x22af, 0x22ae, // 18056
-    0x22ad, 0x22ac, 0x22ac, 0x22ab, 0x22aa, 0x22aa, 0x22a9, 0x22a8, // 18064
-    0x22a7, 0x22a7, 0x22a6, 0x22a5, 0x22a4, 0x22a4, 0x22a3, 0x22a2, // 18072
-    0x22a1, 0x22a1, 0x22a0, 0x229f, 0x229e, 0x229e, 0x229d, 0x229c, // 18080
-    0x229c, 0x229b, 0x229a, 0x2299, 0x2299, 0x2298, 0x2297, 0x2296, // 18088
-    0x2296, 0x2295, 0x2294, 0x2293, 0x2293, 0x2292, 0x2291, 0x2291, // 18096
-    0x2290, 0x228f, 0x228e, 0x228e, 0x228d, 0x228c, 0x228b, 0x228b, // 18104
-    0x228a, 0x2289, 0x2288, 0x2288, 0x2287, 0x2286, 0x2285, 0x2285, // 18112
-    0x2284, 0x2283, 0x2283, 0x2282, 0x2281, 0x2280, 0x2280, 0x227f, // 18120
-    0x227e, 0x227d, 0x227d, 0x227c, 0x227b, 0x227a, 0x227a, 0x2279, // 18128
-    0x2278, 0x2277, 0x2277, 0x2276, 0x2275, 0x2275, 0x2274, 0x2273, // 18136
-    0x2272, 0x2272, 0x2271, 0x2270, 0x226f, 0x226f, 0x226e, 0x226d, // 18144
-    0x226c, 0x226c, 0x226b, 0x226a, 0x2269, 0x2269, 0x2268, 0x2267, // 18152
-    0x2267, 0x2266, 0x2265, 0x2264, 0x2264, 0x2263, 0x2262, 0x2261, // 18160
-    0x2261, 0x2260, 0x225f, 0x225e, 0x225e, 0x225d, 0x225c, 0x225b, // 18168
-    0x225b, 0x225a, 0x2259, 0x2259, 0x2258, 0x2257, 0x2256, 0x2256, // 18176
-    0x2255, 0x2254, 0x2253, 0x2253, 0x2252, 0x2251, 0x2250, 0x2250, // 18184
-    0x224f, 0x224e, 0x224d, 0x224d, 0x224c, 0x224b, 0x224b, 0x224a, // 18192
-    0x2249, 0x2248, 0x2248, 0x2247, 0x2246, 0x2245, 0x2245, 0x2244, // 18200
-    0x2243, 0x2242, 0x2242, 0x2241, 0x2240, 0x2240, 0x223f, 0x223e, // 18208
-    0x223d, 0x223d, 0x223c, 0x223b, 0x223a, 0x223a, 0x2239, 0x2238, // 18216
-    0x2237, 0x2237, 0x2236, 0x2235, 0x2234, 0x2234, 0x2233, 0x2232, // 18224
-    0x2232, 0x2231, 0x2230, 0x222f, 0x222f, 0x222e, 0x222d, 0x222c, // 18232
-    0x222c, 0x222b, 0x222a, 0x2229, 0x2229, 0x2228, 0x2227, 0x2226, // 18240
-    0x2226, 0x2225, 0x2224, 0x2224, 0x2223, 0x2222, 0x2221, 0x2221, // 18248
-    0x2220, 0x221f, 0x221e, 0x221e, 0x221d, 0x221c, 0x221b, 0x221b, // 18256
-    0x221a, 0x2219, 0x2218, 0x2218, 0x2217, 0x2216, 0x2216, 0x2215, // 18264
-    0x2214, 0x2213, 0x2213, 0x2212, 0x2211, 0x2210, 0x2210, 0x220f, // 18272
-    0x220e, 0x220d, 0x220d, 0x220c, 0x220b, 0x220a, 0x220a, 0x2209, // 18280
-    0x2208, 0x2208, 0x2207, 0x2206, 0x2205, 0x2205, 0x2204, 0x2203, // 18288
-    0x2202, 0x2202, 0x2201, 0x2200, 0x21ff, 0x21ff, 0x21fe, 0x21fd, // 18296
-    0x21fd, 0x21fc, 0x21fb, 0x21fa, 0x21fa, 0x21f9, 0x21f8, 0x21f7, // 18304
-    0x21f7, 0x21f6, 0x21f5, 0x21f4, 0x21f4, 0x21f3, 0x21f2, 0x21f1, // 18312
-    0x21f1, 0x21f0, 0x21ef, 0x21ef, 0x21ee, 0x21ed, 0x21ec, 0x21ec, // 18320
-    0x21eb, 0x21ea, 0x21e9, 0x21e9, 0x21e8, 0x21e7, 0x21e6, 0x21e6, // 18328
-    0x21e5, 0x21e4, 0x21e3, 0x21e3, 0x21e2, 0x21e1, 0x21e1, 0x21e0, // 18336
-    0x21df, 0x21de, 0x21de, 0x21dd, 0x21dc, 0x21db, 0x21db, 0x21da, // 18344
-    0x21d9, 0x21d8, 0x21d8, 0x21d7, 0x21d6, 0x21d5, 0x21d5, 0x21d4, // 18352
-    0x21d3, 0x21d3, 0x21d2, 0x21d1, 0x21d0, 0x21d0, 0x21cf, 0x21ce, // 18360
-    0x21cd, 0x21cd, 0x21cc, 0x21cb, 0x21ca, 0x21ca, 0x21c9, 0x21c8, // 18368
-    0x21c7, 0x21c7, 0x21c6, 0x21c5, 0x21c5, 0x21c4, 0x21c3, 0x21c2, // 18376
-    0x21c2, 0x21c1, 0x21c0, 0x21bf, 0x21bf, 0x21be, 0x21bd, 0x21bc, // 18384
-    0x21bc, 0x21bb, 0x21ba, 0x21b9, 0x21b9, 0x21b8, 0x21b7, 0x21b7, // 18392
-    0x21b6, 0x21b5, 0x21b4, 0x21b4, 0x21b3, 0x21b2, 0x21b1, 0x21b1, // 18400
-    0x21b0, 0x21af, 0x21ae, 0x21ae, 0x21ad, 0x21ac, 0x21ac, 0x21ab, // 18408
-    0x21aa, 0x21a9, 0x21a9, 0x21a8, 0x21a7, 0x21a6, 0x21a6, 0x21a5, // 18416
-    0x21a4, 0x21a3, 0x21a3, 0x21a2, 0x21a1, 0x21a0, 0x21a0, 0x219f, // 18424
-    0x219f, 0x219f, 0x219e, 0x219d, 0x219c, 0x219c, 0x219b, 0x219a, // 18432
-    0x219a, 0x2199, 0x2198, 0x2197, 0x2197, 0x2196, 0x2195, 0x2195, // 18440
-    0x2194, 0x2193, 0x2192, 0x2192, 0x2191, 0x2190, 0x2190, 0x218f, // 18448
-    0x218e, 0x218d, 0x218d, 0x218c, 0x218b, 0x218b, 0x218a, 0x2189, // 18456
-    0x2188, 0x2188, 0x2187, 0x2186, 0x2186, 0x2185, 0x2184, 0x2183, // 18464
-    0x2183, 0x2182, 0x2181, 0x2181, 0x2180, 0x217f, 0x217e, 0x217e, // 18472
-    0x217d, 0x217c, 0x217c, 0x217b, 0x217a, 0x2179, 0x2179, 0x2178, // 18480
-    0x2177, 0x2177, 0x2176, 0x2175, 0x2174, 0x2174, 0x2173, 0x2172, // 18488
-    0x2172, 0x2171, 0x2170, 0x216f, 0x216f, 0x216e, 0x216d, 0x216d, // 18496
-    0x216c, 0x216b, 0x216a, 0x216a, 0x2169, 0x2168, 0x2168, 0x2167, // 18504
-    0x2166, 0x2166, 0x2165, 0x2164, 0x2163, 0x2163, 0x2162, 0x2161, // 18512
-    0x2161, 0x2160, 0x215f, 0x215e, 0x215e, 0x215d, 0x215c, 0x215c, // 18520
-    0x215b, 0x215a, 0x2159, 0x2159, 0x2158, 0x2157, 0x2157, 0x2156, // 18528
-    0x2155, 0x2154, 0x2154, 0x2153, 0x2152, 0x2152, 0x2151, 0x2150, // 18536
-    0x214f, 0x214f, 0x214e, 0x214d, 0x214d, 0x214c, 0x214b, 0x214a, // 18544
-    0x214a, 0x2149, 0x2148, 0x2148, 0x2147, 0x2146, 0x2145, 0x2145, // 18552
-    0x2144, 0x2143, 0x2143, 0x2142, 0x2141, 0x2140, 0x2140, 0x213f, // 18560
-    0x213e, 0x213e, 0x213d, 0x213c, 0x213b, 0x213b, 0x213a, 0x2139, // 18568
-    0x2139, 0x2138, 0x2137, 0x2136, 0x2136, 0x2135, 0x2134, 0x2134, // 18576
-    0x2133, 0x2132, 0x2131, 0x2131, 0x2130, 0x212f, 0x212f, 0x212e, // 18584
-    0x212d, 0x212c, 0x212c, 0x212b, 0x212a, 0x212a, 0x2129, 0x2128, // 18592
-    0x2127, 0x2127, 0x2126, 0x2125, 0x2125, 0x2124, 0x2123, 0x2122, // 18600
-    0x2122, 0x2121, 0x2120, 0x2120, 0x211f, 0x211e, 0x211e, 0x211d, // 18608
-    0x211c, 0x211b, 0x211b, 0x211a, 0x2119, 0x2119, 0x2118, 0x2117, // 18616
-    0x2116, 0x2116, 0x2115, 0x2114, 0x2114, 0x2113, 0x2112, 0x2111, // 18624
-    0x2111, 0x2110, 0x210f, 0x210f, 0x210e, 0x210d, 0x210c, 0x210c, // 18632
-    0x210b, 0x210a, 0x210a, 0x2109, 0x2108, 0x2107, 0x2107, 0x2106, // 18640
-    0x2105, 0x2105, 0x2104, 0x2103, 0x2102, 0x2102, 0x2101, 0x2100, // 18648
-    0x2100, 0x20ff, 0x20fe, 0x20fd, 0x20fd, 0x20fc, 0x20fb, 0x20fb, // 18656
-    0x20fa, 0x20f9, 0x20f8, 0x20f8, 0x20f7, 0x20f6, 0x20f6, 0x20f5, // 18664
-    0x20f4, 0x20f3, 0x20f3, 0x20f2, 0x20f1, 0x20f1, 0x20f0, 0x20ef, // 18672
-    0x20ee, 0x20ee, 0x20ed, 0x20ec, 0x20ec, 0x20eb, 0x20ea, 0x20e9, // 18680
-    0x20e9, 0x20e8, 0x20e7, 0x20e7, 0x20e6, 0x20e5, 0x20e4, 0x20e4, // 18688
-    0x20e3, 0x20e2, 0x20e2, 0x20e1, 0x20e0, 0x20df, 0x20df, 0x20de, // 18696
-    0x20dd, 0x20dd, 0x20dc, 0x20db, 0x20da, 0x20da, 0x20d9, 0x20d8, // 18704
-    0x20d8, 0x20d7, 0x20d6, 0x20d6, 0x20d5, 0x20d4, 0x20d3, 0x20d3, // 18712
-    0x20d2, 0x20d1, 0x20d1, 0x20d0, 0x20cf, 0x20ce, 0x20ce, 0x20cd, // 18720
-    0x20cc, 0x20cc, 0x20cb, 0x20ca, 0x20c9, 0x20c9, 0x20c8, 0x20c7, // 18728
-    0x20c7, 0x20c6, 0x20c5, 0x20c4, 0x20c4, 0x20c3, 0x20c2, 0x20c2, // 18736
-    0x20c1, 0x20c0, 0x20bf, 0x20bf, 0x20be, 0x20bd, 0x20bd, 0x20bc, // 18744
-    0x20bb, 0x20ba, 0x20ba, 0x20b9, 0x20b8, 0x20b8, 0x20b7, 0x20b6, // 18752
-    0x20b5, 0x20b5, 0x20b4, 0x20b3, 0x20b3, 0x20b2, 0x20b1, 0x20b0, // 18760
-    0x20b0, 0x20af, 0x20ae, 0x20ae, 0x20ad, 0x20ac, 0x20ab, 0x20ab, // 18768
-    0x20aa, 0x20a9, 0x20a9, 0x20a8, 0x20a7, 0x20a6, 0x20a6, 0x20a5, // 18776
-    0x20a4, 0x20a4, 0x20a3, 0x20a2, 0x20a1, 0x20a1, 0x20a0, 0x209f, // 18784
-    0x209f, 0x209e, 0x209d, 0x209c, 0x209c, 0x209b, 0x209a, 0x209a, // 18792
-    0x2099, 0x2098, 0x2097, 0x2097, 0x2096, 0x2095, 0x2095, 0x2094, // 18800
-    0x2093, 0x2092, 0x2092, 0x2091, 0x2090, 0x2090, 0x208f, 0x208e, // 18808
-    0x208e, 0x208d, 0x208c, 0x208b, 0x208b, 0x208a, 0x2089, 0x2089, // 18816
-    0x2088, 0x2087, 0x2086, 0x2086, 0x2085, 0x2084, 0x2084, 0x2083, // 18824
-    0x2082, 0x2081, 0x2081, 0x2080, 0x207f, 0x207f, 0x207e, 0x207d, // 18832
-    0x207c, 0x207c, 0x207b, 0x207a, 0x207a, 0x2079, 0x2078, 0x2077, // 18840
-    0x2077, 0x2076, 0x2075, 0x2075, 0x2074, 0x2073, 0x2072, 0x2072, // 18848
-    0x2071, 0x2070, 0x2070, 0x206f, 0x206e, 0x206d, 0x206d, 0x206c, // 18856
-    0x206b, 0x206b, 0x206a, 0x2069, 0x2068, 0x2068, 0x2067, 0x2066, // 18864
-    0x2066, 0x2065, 0x2064, 0x2063, 0x2063, 0x2062, 0x2061, 0x2061, // 18872
-    0x2060, 0x205f, 0x205e, 0x205e, 0x205d, 0x205c, 0x205c, 0x205b, // 18880
-    0x205a, 0x2059, 0x2059, 0x2058, 0x2057, 0x2057, 0x2056, 0x2055, // 18888
-    0x2054, 0x2054, 0x2053, 0x2052, 0x2052, 0x2051, 0x2050, 0x204f, // 18896
-    0x204f, 0x204e, 0x204d, 0x204d, 0x204c, 0x204b, 0x204a, 0x204a, // 18904
-    0x2049, 0x2048, 0x2048, 0x2047, 0x2046, 0x2045, 0x2045, 0x2044, // 18912
-    0x2043, 0x2043, 0x2042, 0x2041, 0x2041, 0x2040, 0x203f, 0x203e, // 18920
-    0x203e, 0x203d, 0x203c, 0x203c, 0x203b, 0x203a, 0x2039, 0x2039, // 18928
-    0x2038, 0x2037, 0x2037, 0x2036, 0x2035, 0x2034, 0x2034, 0x2033, // 18936
-    0x2032, 0x2032, 0x2031, 0x2030, 0x202f, 0x202f, 0x202e, 0x202d, // 18944
-    0x202d, 0x202c, 0x202b, 0x202a, 0x202a, 0x2029, 0x2028, 0x2028, // 18952
-    0x2027, 0x2026, 0x2025, 0x2025, 0x2024, 0x2023, 0x2023, 0x2022, // 18960
-    0x2021, 0x2020, 0x2020, 0x201f, 0x201e, 0x201e, 0x201d, 0x201c, // 18968
-    0x201b, 0x201b, 0x201a, 0x2019, 0x2019, 0x2018, 0x2017, 0x2016, // 18976
-    0x2016, 0x2015, 0x2014, 0x2014, 0x2013, 0x2012, 0x2011, 0x2011, // 18984
-    0x2010, 0x200f, 0x200f, 0x200e, 0x200d, 0x200c, 0x200c, 0x200b, // 18992
-    0x200a, 0x200a, 0x2009, 0x2008, 0x2007, 0x2007, 0x2006, 0x2005, // 19000
-    0x2005, 0x2004, 0x2003, 0x2002, 0x2002, 0x2001, 0x2000, 0x2000, // 19008
-    0x1fff, 0x1ffe, 0x1ffd, 0x1ffd, 0x1ffc, 0x1ffb, 0x1ffb, 0x1ffa, // 19016
-    0x1ff9, 0x1ff9, 0x1ff8, 0x1ff7, 0x1ff6, 0x1ff6, 0x1ff5, 0x1ff4, // 19024
-    0x1ff4, 0x1ff3, 0x1ff2, 0x1ff1, 0x1ff1, 0x1ff0, 0x1fef, 0x1fef, // 19032
-    0x1fee, 0x1fed, 0x1fec, 0x1fec, 0x1feb, 0x1fea, 0x1fea, 0x1fe9, // 19040
-    0x1fe8, 0x1fe7, 0x1fe7, 0x1fe6, 0x1fe5, 0x1fe5, 0x1fe4, 0x1fe3, // 19048
-    0x1fe2, 0x1fe2, 0x1fe1, 0x1fe0, 0x1fe0, 0x1fdf, 0x1fde, 0x1fdd, // 19056
-    0x1fdd, 0x1fdc, 0x1fdb, 0x1fdb, 0x1fda, 0x1fd9, 0x1fd8, 0x1fd8, // 19064
-    0x1fd7, 0x1fd6, 0x1fd6, 0x1fd5, 0x1fd4, 0x1fd3, 0x1fd3, 0x1fd2, // 19072
-    0x1fd1, 0x1fd1, 0x1fd0, 0x1fcf, 0x1fce, 0x1fce, 0x1fcd, 0x1fcc, // 19080
-    0x1fcc, 0x1fcb, 0x1fca, 0x1fc9, 0x1fc9, 0x1fc8, 0x1fc7, 0x1fc7, // 19088
-    0x1fc6, 0x1fc5, 0x1fc4, 0x1fc4, 0x1fc3, 0x1fc2, 0x1fc2, 0x1fc1, // 19096
-    0x1fc0, 0x1fbf, 0x1fbf, 0x1fbe, 0x1fbd, 0x1fbd, 0x1fbc, 0x1fbb, // 19104
-    0x1fba, 0x1fba, 0x1fb9, 0x1fb8, 0x1fb8, 0x1fb7, 0x1fb6, 0x1fb5, // 19112
-    0x1fb5, 0x1fb4, 0x1fb3, 0x1fb3, 0x1fb2, 0x1fb1, 0x1fb1, 0x1fb0, // 19120
-    0x1faf, 0x1fae, 0x1fae, 0x1fad, 0x1fac, 0x1fac, 0x1fab, 0x1faa, // 19128
-    0x1fa9, 0x1fa9, 0x1fa8, 0x1fa7, 0x1fa7, 0x1fa6, 0x1fa5, 0x1fa4, // 19136
-    0x1fa4, 0x1fa3, 0x1fa2, 0x1fa2, 0x1fa1, 0x1fa0, 0x1f9f, 0x1f9f, // 19144
-    0x1f9e, 0x1f9d, 0x1f9d, 0x1f9c, 0x1f9b, 0x1f9a, 0x1f9a, 0x1f99, // 19152
-    0x1f98, 0x1f98, 0x1f97, 0x1f96, 0x1f95, 0x1f95, 0x1f94, 0x1f93, // 19160
-    0x1f93, 0x1f92, 0x1f91, 0x1f90, 0x1f90, 0x1f8f, 0x1f8e, 0x1f8e, // 19168
-    0x1f8d, 0x1f8c, 0x1f8b, 0x1f8b, 0x1f8a, 0x1f89, 0x1f89, 0x1f88, // 19176
-    0x1f87, 0x1f86, 0x1f86, 0x1f85, 0x1f84, 0x1f84, 0x1f83, 0x1f82, // 19184
-    0x1f81, 0x1f81, 0x1f80, 0x1f7f, 0x1f7f, 0x1f7e, 0x1f7d, 0x1f7c, // 19192
-    0x1f7c, 0x1f7b, 0x1f7a, 0x1f7a, 0x1f79, 0x1f78, 0x1f77, 0x1f77, // 19200
-    0x1f76, 0x1f75, 0x1f75, 0x1f74, 0x1f73, 0x1f72, 0x1f72, 0x1f71, // 19208
-    0x1f70, 0x1f70, 0x1f6f, 0x1f6e, 0x1f6d, 0x1f6d, 0x1f6c, 0x1f6b, // 19216
-    0x1f6b, 0x1f6a, 0x1f69, 0x1f69, 0x1f68, 0x1f67, 0x1f66, 0x1f66, // 19224
-    0x1f65, 0x1f64, 0x1f64, 0x1f63, 0x1f62, 0x1f61, 0x1f61, 0x1f60, // 19232
-    0x1f5f, 0x1f5f, 0x1f5e, 0x1f5d, 0x1f5c, 0x1f5c, 0x1f5b, 0x1f5a, // 19240
-    0x1f5a, 0x1f59, 0x1f58, 0x1f57, 0x1f57, 0x1f56, 0x1f55, 0x1f55, // 19248
-    0x1f54, 0x1f53, 0x1f52, 0x1f52, 0x1f51, 0x1f50, 0x1f50, 0x1f4f, // 19256
-    0x1f4e, 0x1f4d, 0x1f4d, 0x1f4c, 0x1f4b, 0x1f4b, 0x1f4a, 0x1f49, // 19264
-    0x1f48, 0x1f48, 0x1f47, 0x1f46, 0x1f46, 0x1f45, 0x1f44, 0x1f43, // 19272
-    0x1f43, 0x1f42, 0x1f41, 0x1f41, 0x1f40, 0x1f3f, 0x1f3e, 0x1f3e, // 19280
-    0x1f3d, 0x1f3c, 0x1f3c, 0x1f3b, 0x1f3a, 0x1f39, 0x1f39, 0x1f38, // 19288
-    0x1f37, 0x1f37, 0x1f36, 0x1f35, 0x1f34, 0x1f34, 0x1f33, 0x1f32, // 19296
-    0x1f32, 0x1f31, 0x1f30, 0x1f2f, 0x1f2f, 0x1f2e, 0x1f2d, 0x1f2d, // 19304
-    0x1f2c, 0x1f2b, 0x1f2a, 0x1f2a, 0x1f29, 0x1f28, 0x1f28, 0x1f27, // 19312
-    0x1f26, 0x1f25, 0x1f25, 0x1f24, 0x1f23, 0x1f23, 0x1f22, 0x1f21, // 19320
-    0x1f21, 0x1f20, 0x1f1f, 0x1f1e, 0x1f1e, 0x1f1d, 0x1f1c, 0x1f1c, // 19328
-    0x1f1b, 0x1f1a, 0x1f19, 0x1f19, 0x1f18, 0x1f17, 0x1f17, 0x1f16, // 19336
-    0x1f15, 0x1f14, 0x1f14, 0x1f13, 0x1f12, 0x1f12, 0x1f11, 0x1f10, // 19344
-    0x1f0f, 0x1f0f, 0x1f0e, 0x1f0d, 0x1f0d, 0x1f0c, 0x1f0b, 0x1f0a, // 19352
-    0x1f0a, 0x1f09, 0x1f08, 0x1f08, 0x1f07, 0x1f06, 0x1f05, 0x1f05, // 19360
-    0x1f04, 0x1f03, 0x1f03, 0x1f02, 0x1f01, 0x1f00, 0x1f00, 0x1eff, // 19368
-    0x1efe, 0x1efe, 0x1efd, 0x1efc, 0x1efb, 0x1efb, 0x1efa, 0x1ef9, // 19376
-    0x1ef9, 0x1ef8, 0x1ef7, 0x1ef6, 0x1ef6, 0x1ef5, 0x1ef4, 0x1ef4, // 19384
-    0x1ef3, 0x1ef2, 0x1ef1, 0x1ef1, 0x1ef0, 0x1eef, 0x1eef, 0x1eee, // 19392
-    0x1eed, 0x1eec, 0x1eec, 0x1eeb, 0x1eea, 0x1eea, 0x1ee9, 0x1ee8, // 19400
-    0x1ee7, 0x1ee7, 0x1ee6, 0x1ee5, 0x1ee5, 0x1ee4, 0x1ee3, 0x1ee2, // 19408
-    0x1ee2, 0x1ee1, 0x1ee0, 0x1ee0, 0x1edf, 0x1ede, 0x1edd, 0x1edd, // 19416
-    0x1edc, 0x1edb, 0x1edb, 0x1eda, 0x1ed9, 0x1ed8, 0x1ed8, 0x1ed7, // 19424
-    0x1ed6, 0x1ed6, 0x1ed5, 0x1ed4, 0x1ed4, 0x1ed3, 0x1ed2, 0x1ed1, // 19432
-    0x1ed1, 0x1ed0, 0x1ecf, 0x1ecf, 0x1ece, 0x1ecd, 0x1ecc, 0x1ecc, // 19440
-    0x1ecb, 0x1eca, 0x1eca, 0x1ec9, 0x1ec8, 0x1ec7, 0x1ec7, 0x1ec6, // 19448
-    0x1ec6, 0x1ec5, 0x1ec4, 0x1ec4, 0x1ec3, 0x1ec2, 0x1ec2, 0x1ec1, // 19456
-    0x1ec0, 0x1ec0, 0x1ebf, 0x1ebe, 0x1ebd, 0x1ebd, 0x1ebc, 0x1ebb, // 19464
-    0x1ebb, 0x1eba, 0x1eb9, 0x1eb9, 0x1eb8, 0x1eb7, 0x1eb6, 0x1eb6, // 19472
-    0x1eb5, 0x1eb4, 0x1eb4, 0x1eb3, 0x1eb2, 0x1eb2, 0x1eb1, 0x1eb0, // 19480
-    0x1eb0, 0x1eaf, 0x1eae, 0x1ead, 0x1ead, 0x1eac, 0x1eab, 0x1eab, // 19488
-    0x1eaa, 0x1ea9, 0x1ea9, 0x1ea8, 0x1ea7, 0x1ea7, 0x1ea6, 0x1ea5, // 19496
-    0x1ea4, 0x1ea4, 0x1ea3, 0x1ea2, 0x1ea2, 0x1ea1, 0x1ea0, 0x1ea0, // 19504
-    0x1e9f, 0x1e9e, 0x1e9e, 0x1e9d, 0x1e9c, 0x1e9b, 0x1e9b, 0x1e9a, // 19512
-    0x1e99, 0x1e99, 0x1e98, 0x1e97, 0x1e97, 0x1e96, 0x1e95, 0x1e95, // 19520
-    0x1e94, 0x1e93, 0x1e92, 0x1e92, 0x1e91, 0x1e90, 0x1e90, 0x1e8f, // 19528
-    0x1e8e, 0x1e8e, 0x1e8d, 0x1e8c, 0x1e8c, 0x1e8b, 0x1e8a, 0x1e89, // 19536
-    0x1e89, 0x1e88, 0x1e87, 0x1e87, 0x1e86, 0x1e85, 0x1e85, 0x1e84, // 19544
-    0x1e83, 0x1e82, 0x1e82, 0x1e81, 0x1e80, 0x1e80, 0x1e7f, 0x1e7e, // 19552
-    0x1e7e, 0x1e7d, 0x1e7c, 0x1e7c, 0x1e7b, 0x1e7a, 0x1e79, 0x1e79, // 19560
-    0x1e78, 0x1e77, 0x1e77, 0x1e76, 0x1e75, 0x1e75, 0x1e74, 0x1e73, // 19568
-    0x1e73, 0x1e72, 0x1e71, 0x1e70, 0x1e70, 0x1e6f, 0x1e6e, 0x1e6e, // 19576
-    0x1e6d, 0x1e6c, 0x1e6c, 0x1e6b, 0x1e6a, 0x1e6a, 0x1e69, 0x1e68, // 19584
-    0x1e67, 0x1e67, 0x1e66, 0x1e65, 0x1e65, 0x1e64, 0x1e63, 0x1e63, // 19592
-    0x1e62, 0x1e61, 0x1e61, 0x1e60, 0x1e5f, 0x1e5e, 0x1e5e, 0x1e5d, // 19600
-    0x1e5c, 0x1e5c, 0x1e5b, 0x1e5a, 0x1e5a, 0x1e59, 0x1e58, 0x1e58, // 19608
-    0x1e57, 0x1e56, 0x1e55, 0x1e55, 0x1e54, 0x1e53, 0x1e53, 0x1e52, // 19616
-    0x1e51, 0x1e51, 0x1e50, 0x1e4f, 0x1e4e, 0x1e4e, 0x1e4d, 0x1e4c, // 19624
-    0x1e4c, 0x1e4b, 0x1e4a, 0x1e4a, 0x1e49, 0x1e48, 0x1e48, 0x1e47, // 19632
-    0x1e46, 0x1e45, 0x1e45, 0x1e44, 0x1e43, 0x1e43, 0x1e42, 0x1e41, // 19640
-    0x1e41, 0x1e40, 0x1e3f, 0x1e3f, 0x1e3e, 0x1e3d, 0x1e3c, 0x1e3c, // 19648
-    0x1e3b, 0x1e3a, 0x1e3a, 0x1e39, 0x1e38, 0x1e38, 0x1e37, 0x1e36, // 19656
-    0x1e36, 0x1e35, 0x1e34, 0x1e33, 0x1e33, 0x1e32, 0x1e31, 0x1e31, // 19664
-    0x1e30, 0x1e2f, 0x1e2f, 0x1e2e, 0x1e2d, 0x1e2d, 0x1e2c, 0x1e2b, // 19672
-    0x1e2a, 0x1e2a, 0x1e29, 0x1e28, 0x1e28, 0x1e27, 0x1e26, 0x1e26, // 19680
-    0x1e25, 0x1e24, 0x1e24, 0x1e23, 0x1e22, 0x1e21, 0x1e21, 0x1e20, // 19688
-    0x1e1f, 0x1e1f, 0x1e1e, 0x1e1d, 0x1e1d, 0x1e1c, 0x1e1b, 0x1e1a, // 19696
-    0x1e1a, 0x1e19, 0x1e18, 0x1e18, 0x1e17, 0x1e16, 0x1e16, 0x1e15, // 19704
-    0x1e14, 0x1e14, 0x1e13, 0x1e12, 0x1e11, 0x1e11, 0x1e10, 0x1e0f, // 19712
-    0x1e0f, 0x1e0e, 0x1e0d, 0x1e0d, 0x1e0c, 0x1e0b, 0x1e0b, 0x1e0a, // 19720
-    0x1e09, 0x1e08, 0x1e08, 0x1e07, 0x1e06, 0x1e06, 0x1e05, 0x1e04, // 19728
-    0x1e04, 0x1e03, 0x1e02, 0x1e02, 0x1e01, 0x1e00, 0x1dff, 0x1dff, // 19736
-    0x1dfe, 0x1dfd, 0x1dfd, 0x1dfc, 0x1dfb, 0x1dfb, 0x1dfa, 0x1df9, // 19744
-    0x1df9, 0x1df8, 0x1df7, 0x1df6, 0x1df6, 0x1df5, 0x1df4, 0x1df4, // 19752
-    0x1df3, 0x1df2, 0x1df2, 0x1df1, 0x1df0, 0x1df0, 0x1def, 0x1dee, // 19760
-    0x1ded, 0x1ded, 0x1dec, 0x1deb, 0x1deb, 0x1dea, 0x1de9, 0x1de9, // 19768
-    0x1de8, 0x1de7, 0x1de6, 0x1de6, 0x1de5, 0x1de4, 0x1de4, 0x1de3, // 19776
-    0x1de2, 0x1de2, 0x1de1, 0x1de0, 0x1de0, 0x1ddf, 0x1dde, 0x1ddd, // 19784
-    0x1ddd, 0x1ddc, 0x1ddb, 0x1ddb, 0x1dda, 0x1dd9, 0x1dd9, 0x1dd8, // 19792
-    0x1dd7, 0x1dd7, 0x1dd6, 0x1dd5, 0x1dd4, 0x1dd4, 0x1dd3, 0x1dd2, // 19800
-    0x1dd2, 0x1dd1, 0x1dd0, 0x1dd0, 0x1dcf, 0x1dce, 0x1dce, 0x1dcd, // 19808
-    0x1dcc, 0x1dcb, 0x1dcb, 0x1dca, 0x1dc9, 0x1dc9, 0x1dc8, 0x1dc7, // 19816
-    0x1dc7, 0x1dc6, 0x1dc5, 0x1dc5, 0x1dc4, 0x1dc3, 0x1dc2, 0x1dc2, // 19824
-    0x1dc1, 0x1dc0, 0x1dc0, 0x1dbf, 0x1dbe, 0x1dbe, 0x1dbd, 0x1dbc, // 19832
-    0x1dbc, 0x1dbb, 0x1dba, 0x1db9, 0x1db9, 0x1db8, 0x1db7, 0x1db7, // 19840
-    0x1db6, 0x1db5, 0x1db5, 0x1db4, 0x1db3, 0x1db2, 0x1db2, 0x1db1, // 19848
-    0x1db0, 0x1db0, 0x1daf, 0x1dae, 0x1dae, 0x1dad, 0x1dac, 0x1dac, // 19856
-    0x1dab, 0x1daa, 0x1da9, 0x1da9, 0x1da8, 0x1da7, 0x1da7, 0x1da6, // 19864
-    0x1da5, 0x1da5, 0x1da4, 0x1da3, 0x1da3, 0x1da2, 0x1da1, 0x1da0, // 19872
-    0x1da0, 0x1d9f, 0x1d9e, 0x1d9e, 0x1d9d, 0x1d9c, 0x1d9c, 0x1d9b, // 19880
-    0x1d9a, 0x1d9a, 0x1d99, 0x1d98, 0x1d97, 0x1d97, 0x1d96, 0x1d95, // 19888
-    0x1d95, 0x1d94, 0x1d93, 0x1d93, 0x1d92, 0x1d91, 0x1d91, 0x1d90, // 19896
-    0x1d8f, 0x1d8e, 0x1d8e, 0x1d8d, 0x1d8c, 0x1d8c, 0x1d8b, 0x1d8a, // 19904
-    0x1d8a, 0x1d89, 0x1d88, 0x1d87, 0x1d87, 0x1d86, 0x1d85, 0x1d85, // 19912
-    0x1d84, 0x1d83, 0x1d83, 0x1d82, 0x1d81, 0x1d81, 0x1d80, 0x1d7f, // 19920
-    0x1d7e, 0x1d7e, 0x1d7d, 0x1d7c, 0x1d7c, 0x1d7b, 0x1d7a, 0x1d7a, // 19928
-    0x1d79, 0x1d78, 0x1d78, 0x1d77, 0x1d76, 0x1d75, 0x1d75, 0x1d74, // 19936
-    0x1d73, 0x1d73, 0x1d72, 0x1d71, 0x1d71, 0x1d70, 0x1d6f, 0x1d6f, // 19944
-    0x1d6e, 0x1d6d, 0x1d6c, 0x1d6c, 0x1d6b, 0x1d6a, 0x1d6a, 0x1d69, // 19952
-    0x1d68, 0x1d68, 0x1d67, 0x1d66, 0x1d66, 0x1d65, 0x1d64, 0x1d63, // 19960
-    0x1d63, 0x1d62, 0x1d61, 0x1d61, 0x1d60, 0x1d5f, 0x1d5f, 0x1d5e, // 19968
-    0x1d5d, 0x1d5d, 0x1d5c, 0x1d5b, 0x1d5a, 0x1d5a, 0x1d59, 0x1d58, // 19976
-    0x1d58, 0x1d57, 0x1d56, 0x1d56, 0x1d55, 0x1d54, 0x1d53, 0x1d53, // 19984
-    0x1d52, 0x1d51, 0x1d51, 0x1d50, 0x1d4f, 0x1d4f, 0x1d4e, 0x1d4d, // 19992
-    0x1d4d, 0x1d4c, 0x1d4b, 0x1d4a, 0x1d4a, 0x1d49, 0x1d48, 0x1d48, // 20000
-    0x1d47, 0x1d46, 0x1d46, 0x1d45, 0x1d44, 0x1d44, 0x1d43, 0x1d42, // 20008
-    0x1d41, 0x1d41, 0x1d40, 0x1d3f, 0x1d3f, 0x1d3e, 0x1d3d, 0x1d3d, // 20016
-    0x1d3c, 0x1d3b, 0x1d3b, 0x1d3a, 0x1d39, 0x1d38, 0x1d38, 0x1d37, // 20024
-    0x1d36, 0x1d36, 0x1d35, 0x1d34, 0x1d34, 0x1d33, 0x1d32, 0x1d32, // 20032
-    0x1d31, 0x1d30, 0x1d2f, 0x1d2f, 0x1d2e, 0x1d2d, 0x1d2d, 0x1d2c, // 20040
-    0x1d2b, 0x1d2b, 0x1d2a, 0x1d29, 0x1d29, 0x1d28, 0x1d27, 0x1d26, // 20048
-    0x1d26, 0x1d25, 0x1d24, 0x1d24, 0x1d23, 0x1d22, 0x1d22, 0x1d21, // 20056
-    0x1d20, 0x1d1f, 0x1d1f, 0x1d1e, 0x1d1d, 0x1d1d, 0x1d1c, 0x1d1b, // 20064
-    0x1d1b, 0x1d1a, 0x1d19, 0x1d19, 0x1d18, 0x1d17, 0x1d16, 0x1d16, // 20072
-    0x1d15, 0x1d14, 0x1d14, 0x1d13, 0x1d12, 0x1d12, 0x1d11, 0x1d10, // 20080
-    0x1d10, 0x1d0f, 0x1d0e, 0x1d0d, 0x1d0d, 0x1d0c, 0x1d0b, 0x1d0b, // 20088
-    0x1d0a, 0x1d09, 0x1d09, 0x1d08, 0x1d07, 0x1d07, 0x1d06, 0x1d05, // 20096
-    0x1d04, 0x1d04, 0x1d03, 0x1d02, 0x1d02, 0x1d01, 0x1d00, 0x1d00, // 20104
-    0x1cff, 0x1cfe, 0x1cfe, 0x1cfd, 0x1cfc, 0x1cfb, 0x1cfb, 0x1cfa, // 20112
-    0x1cf9, 0x1cf9, 0x1cf8, 0x1cf7, 0x1cf7, 0x1cf6, 0x1cf5, 0x1cf5, // 20120
-    0x1cf4, 0x1cf3, 0x1cf2, 0x1cf2, 0x1cf1, 0x1cf0, 0x1cf0, 0x1cef, // 20128
-    0x1cee, 0x1cee, 0x1ced, 0x1cec, 0x1ceb, 0x1ceb, 0x1cea, 0x1ce9, // 20136
-    0x1ce9, 0x1ce8, 0x1ce7, 0x1ce7, 0x1ce6, 0x1ce5, 0x1ce5, 0x1ce4, // 20144
-    0x1ce3, 0x1ce2, 0x1ce2, 0x1ce1, 0x1ce0, 0x1ce0, 0x1cdf, 0x1cde, // 20152
-    0x1cde, 0x1cdd, 0x1cdc, 0x1cdc, 0x1cdb, 0x1cda, 0x1cd9, 0x1cd9, // 20160
-    0x1cd8, 0x1cd7, 0x1cd7, 0x1cd6, 0x1cd5, 0x1cd5, 0x1cd4, 0x1cd3, // 20168
-    0x1cd3, 0x1cd2, 0x1cd1, 0x1cd0, 0x1cd0, 0x1ccf, 0x1cce, 0x1cce, // 20176
-    0x1ccd, 0x1ccc, 0x1ccc, 0x1ccb, 0x1cca, 0x1cca, 0x1cc9, 0x1cc8, // 20184
-    0x1cc7, 0x1cc7, 0x1cc6, 0x1cc5, 0x1cc5, 0x1cc4, 0x1cc3, 0x1cc3, // 20192
-    0x1cc2, 0x1cc1, 0x1cc1, 0x1cc0, 0x1cbf, 0x1cbe, 0x1cbe, 0x1cbd, // 20200
-    0x1cbc, 0x1cbc, 0x1cbb, 0x1cba, 0x1cba, 0x1cb9, 0x1cb8, 0x1cb7, // 20208
-    0x1cb7, 0x1cb6, 0x1cb5, 0x1cb5, 0x1cb4, 0x1cb3, 0x1cb3, 0x1cb2, // 20216
-    0x1cb1, 0x1cb1, 0x1cb0, 0x1caf, 0x1cae, 0x1cae, 0x1cad, 0x1cac, // 20224
-    0x1cac, 0x1cab, 0x1caa, 0x1caa, 0x1ca9, 0x1ca8, 0x1ca8, 0x1ca7, // 20232
-    0x1ca6, 0x1ca5, 0x1ca5, 0x1ca4, 0x1ca3, 0x1ca3, 0x1ca2, 0x1ca1, // 20240
-    0x1ca1, 0x1ca0, 0x1c9f, 0x1c9f, 0x1c9e, 0x1c9d, 0x1c9c, 0x1c9c, // 20248
-    0x1c9b, 0x1c9a, 0x1c9a, 0x1c99, 0x1c98, 0x1c98, 0x1c97, 0x1c96, // 20256
-    0x1c96, 0x1c95, 0x1c94, 0x1c93, 0x1c93, 0x1c92, 0x1c91, 0x1c91, // 20264
-    0x1c90, 0x1c8f, 0x1c8f, 0x1c8e, 0x1c8d, 0x1c8d, 0x1c8c, 0x1c8b, // 20272
-    0x1c8a, 0x1c8a, 0x1c89, 0x1c88, 0x1c88, 0x1c87, 0x1c86, 0x1c86, // 20280
-    0x1c85, 0x1c84, 0x1c83, 0x1c83, 0x1c82, 0x1c81, 0x1c81, 0x1c80, // 20288
-    0x1c7f, 0x1c7f, 0x1c7e, 0x1c7d, 0x1c7d, 0x1c7c, 0x1c7b, 0x1c7a, // 20296
-    0x1c7a, 0x1c79, 0x1c78, 0x1c78, 0x1c77, 0x1c76, 0x1c76, 0x1c75, // 20304
-    0x1c74, 0x1c74, 0x1c73, 0x1c72, 0x1c71, 0x1c71, 0x1c70, 0x1c6f, // 20312
-    0x1c6f, 0x1c6e, 0x1c6d, 0x1c6d, 0x1c6c, 0x1c6b, 0x1c6b, 0x1c6a, // 20320
-    0x1c69, 0x1c68, 0x1c68, 0x1c67, 0x1c66, 0x1c66, 0x1c65, 0x1c64, // 20328
-    0x1c64, 0x1c63, 0x1c62, 0x1c62, 0x1c61, 0x1c60, 0x1c5f, 0x1c5f, // 20336
-    0x1c5e, 0x1c5d, 0x1c5d, 0x1c5c, 0x1c5b, 0x1c5b, 0x1c5a, 0x1c59, // 20344
-    0x1c59, 0x1c58, 0x1c57, 0x1c56, 0x1c56, 0x1c55, 0x1c54, 0x1c54, // 20352
-    0x1c53, 0x1c52, 0x1c52, 0x1c51, 0x1c50, 0x1c4f, 0x1c4f, 0x1c4e, // 20360
-    0x1c4d, 0x1c4d, 0x1c4c, 0x1c4b, 0x1c4b, 0x1c4a, 0x1c49, 0x1c49, // 20368
-    0x1c48, 0x1c47, 0x1c46, 0x1c46, 0x1c45, 0x1c44, 0x1c44, 0x1c43, // 20376
-    0x1c42, 0x1c42, 0x1c41, 0x1c40, 0x1c40, 0x1c3f, 0x1c3e, 0x1c3d, // 20384
-    0x1c3d, 0x1c3c, 0x1c3b, 0x1c3b, 0x1c3a, 0x1c39, 0x1c39, 0x1c38, // 20392
-    0x1c37, 0x1c37, 0x1c36, 0x1c35, 0x1c34, 0x1c34, 0x1c33, 0x1c32, // 20400
-    0x1c32, 0x1c31, 0x1c30, 0x1c30, 0x1c2f, 0x1c2e, 0x1c2e, 0x1c2d, // 20408
-    0x1c2c, 0x1c2b, 0x1c2b, 0x1c2a, 0x1c29, 0x1c29, 0x1c28, 0x1c27, // 20416
-    0x1c27, 0x1c26, 0x1c25, 0x1c24, 0x1c24, 0x1c23, 0x1c22, 0x1c22, // 20424
-    0x1c21, 0x1c20, 0x1c20, 0x1c1f, 0x1c1e, 0x1c1e, 0x1c1d, 0x1c1c, // 20432
-    0x1c1b, 0x1c1b, 0x1c1a, 0x1c19, 0x1c19, 0x1c18, 0x1c17, 0x1c17, // 20440
-    0x1c16, 0x1c15, 0x1c15, 0x1c14, 0x1c13, 0x1c12, 0x1c12, 0x1c11, // 20448
-    0x1c10, 0x1c10, 0x1c0f, 0x1c0e, 0x1c0e, 0x1c0d, 0x1c0c, 0x1c0c, // 20456
-    0x1c0b, 0x1c0a, 0x1c09, 0x1c09, 0x1c08, 0x1c07, 0x1c07, 0x1c06, // 20464
-    0x1c05, 0x1c05, 0x1c04, 0x1c03, 0x1c03, 0x1c02, 0x1c01, 0x1c00, // 20472
-    0x1c00, 0x1c00, 0x1bff, 0x1bfe, 0x1bfe, 0x1bfd, 0x1bfc, 0x1bfc, // 20480
-    0x1bfb, 0x1bfa, 0x1bfa, 0x1bf9, 0x1bf8, 0x1bf7, 0x1bf7, 0x1bf6, // 20488
-    0x1bf5, 0x1bf5, 0x1bf4, 0x1bf3, 0x1bf3, 0x1bf2, 0x1bf1, 0x1bf1, // 20496
-    0x1bf0, 0x1bef, 0x1bef, 0x1bee, 0x1bed, 0x1bed, 0x1bec, 0x1beb, // 20504
-    0x1beb, 0x1bea, 0x1be9, 0x1be9, 0x1be8, 0x1be7, 0x1be7, 0x1be6, // 20512
-    0x1be5, 0x1be5, 0x1be4, 0x1be3, 0x1be3, 0x1be2, 0x1be1, 0x1be1, // 20520
-    0x1be0, 0x1bdf, 0x1bdf, 0x1bde, 0x1bdd, 0x1bdd, 0x1bdc, 0x1bdb, // 20528
-    0x1bdb, 0x1bda, 0x1bd9, 0x1bd8, 0x1bd8, 0x1bd7, 0x1bd6, 0x1bd6, // 20536
-    0x1bd5, 0x1bd4, 0x1bd4, 0x1bd3, 0x1bd2, 0x1bd2, 0x1bd1, 0x1bd0, // 20544
-    0x1bd0, 0x1bcf, 0x1bce, 0x1bce, 0x1bcd, 0x1bcc, 0x1bcc, 0x1bcb, // 20552
-    0x1bca, 0x1bca, 0x1bc9, 0x1bc8, 0x1bc8, 0x1bc7, 0x1bc6, 0x1bc6, // 20560
-    0x1bc5, 0x1bc4, 0x1bc4, 0x1bc3, 0x1bc2, 0x1bc2, 0x1bc1, 0x1bc0, // 20568
-    0x1bc0, 0x1bbf, 0x1bbe, 0x1bbe, 0x1bbd, 0x1bbc, 0x1bbc, 0x1bbb, // 20576
-    0x1bba, 0x1bb9, 0x1bb9, 0x1bb8, 0x1bb7, 0x1bb7, 0x1bb6, 0x1bb5, // 20584
-    0x1bb5, 0x1bb4, 0x1bb3, 0x1bb3, 0x1bb2, 0x1bb1, 0x1bb1, 0x1bb0, // 20592
-    0x1baf, 0x1baf, 0x1bae, 0x1bad, 0x1bad, 0x1bac, 0x1bab, 0x1bab, // 20600
-    0x1baa, 0x1ba9, 0x1ba9, 0x1ba8, 0x1ba7, 0x1ba7, 0x1ba6, 0x1ba5, // 20608
-    0x1ba5, 0x1ba4, 0x1ba3, 0x1ba3, 0x1ba2, 0x1ba1, 0x1ba1, 0x1ba0, // 20616
-    0x1b9f, 0x1b9f, 0x1b9e, 0x1b9d, 0x1b9d, 0x1b9c, 0x1b9b, 0x1b9b, // 20624
-    0x1b9a, 0x1b99, 0x1b98, 0x1b98, 0x1b97, 0x1b96, 0x1b96, 0x1b95, // 20632
-    0x1b94, 0x1b94, 0x1b93, 0x1b92, 0x1b92, 0x1b91, 0x1b90, 0x1b90, // 20640
-    0x1b8f, 0x1b8e, 0x1b8e, 0x1b8d, 0x1b8c, 0x1b8c, 0x1b8b, 0x1b8a, // 20648
-    0x1b8a, 0x1b89, 0x1b88, 0x1b88, 0x1b87, 0x1b86, 0x1b86, 0x1b85, // 20656
-    0x1b84, 0x1b84, 0x1b83, 0x1b82, 0x1b82, 0x1b81, 0x1b80, 0x1b80, // 20664
-    0x1b7f, 0x1b7e, 0x1b7e, 0x1b7d, 0x1b7c, 0x1b7c, 0x1b7b, 0x1b7a, // 20672
-    0x1b79, 0x1b79, 0x1b78, 0x1b77, 0x1b77, 0x1b76, 0x1b75, 0x1b75, // 20680
-    0x1b74, 0x1b73, 0x1b73, 0x1b72, 0x1b71, 0x1b71, 0x1b70, 0x1b6f, // 20688
-    0x1b6f, 0x1b6e, 0x1b6d, 0x1b6d, 0x1b6c, 0x1b6b, 0x1b6b, 0x1b6a, // 20696
-    0x1b69, 0x1b69, 0x1b68, 0x1b67, 0x1b67, 0x1b66, 0x1b65, 0x1b65, // 20704
-    0x1b64, 0x1b63, 0x1b63, 0x1b62, 0x1b61, 0x1b61, 0x1b60, 0x1b5f, // 20712
-    0x1b5f, 0x1b5e, 0x1b5d, 0x1b5d, 0x1b5c, 0x1b5b, 0x1b5a, 0x1b5a, // 20720
-    0x1b59, 0x1b58, 0x1b58, 0x1b57, 0x1b56, 0x1b56, 0x1b55, 0x1b54, // 20728
-    0x1b54, 0x1b53, 0x1b52, 0x1b52, 0x1b51, 0x1b50, 0x1b50, 0x1b4f, // 20736
-    0x1b4e, 0x1b4e, 0x1b4d, 0x1b4c, 0x1b4c, 0x1b4b, 0x1b4a, 0x1b4a, // 20744
-    0x1b49, 0x1b48, 0x1b48, 0x1b47, 0x1b46, 0x1b46, 0x1b45, 0x1b44, // 20752
-    0x1b44, 0x1b43, 0x1b42, 0x1b42, 0x1b41, 0x1b40, 0x1b40, 0x1b3f, // 20760
-    0x1b3e, 0x1b3e, 0x1b3d, 0x1b3c, 0x1b3b, 0x1b3b, 0x1b3a, 0x1b39, // 20768
-    0x1b39, 0x1b38, 0x1b37, 0x1b37, 0x1b36, 0x1b35, 0x1b35, 0x1b34, // 20776
-    0x1b33, 0x1b33, 0x1b32, 0x1b31, 0x1b31, 0x1b30, 0x1b2f, 0x1b2f, // 20784
-    0x1b2e, 0x1b2d, 0x1b2d, 0x1b2c, 0x1b2b, 0x1b2b, 0x1b2a, 0x1b29, // 20792
-    0x1b29, 0x1b28, 0x1b27, 0x1b27, 0x1b26, 0x1b25, 0x1b25, 0x1b24, // 20800
-    0x1b23, 0x1b23, 0x1b22, 0x1b21, 0x1b21, 0x1b20, 0x1b1f, 0x1b1f, // 20808
-    0x1b1e, 0x1b1d, 0x1b1c, 0x1b1c, 0x1b1b, 0x1b1a, 0x1b1a, 0x1b19, // 20816
-    0x1b18, 0x1b18, 0x1b17, 0x1b16, 0x1b16, 0x1b15, 0x1b14, 0x1b14, // 20824
-    0x1b13, 0x1b12, 0x1b12, 0x1b11, 0x1b10, 0x1b10, 0x1b0f, 0x1b0e, // 20832
-    0x1b0e, 0x1b0d, 0x1b0c, 0x1b0c, 0x1b0b, 0x1b0a, 0x1b0a, 0x1b09, // 20840
-    0x1b08, 0x1b08, 0x1b07, 0x1b06, 0x1b06, 0x1b05, 0x1b04, 0x1b04, // 20848
-    0x1b03, 0x1b02, 0x1b02, 0x1b01, 0x1b00, 0x1b00, 0x1aff, 0x1afe, // 20856
-    0x1afe, 0x1afd, 0x1afc, 0x1afb, 0x1afb, 0x1afa, 0x1af9, 0x1af9, // 20864
-    0x1af8, 0x1af7, 0x1af7, 0x1af6, 0x1af5, 0x1af5, 0x1af4, 0x1af3, // 20872
-    0x1af3, 0x1af2, 0x1af1, 0x1af1, 0x1af0, 0x1aef, 0x1aef, 0x1aee, // 20880
-    0x1aed, 0x1aed, 0x1aec, 0x1aeb, 0x1aeb, 0x1aea, 0x1ae9, 0x1ae9, // 20888
-    0x1ae8, 0x1ae7, 0x1ae7, 0x1ae6, 0x1ae5, 0x1ae5, 0x1ae4, 0x1ae3, // 20896
-    0x1ae3, 0x1ae2, 0x1ae1, 0x1ae1, 0x1ae0, 0x1adf, 0x1adf, 0x1ade, // 20904
-    0x1add, 0x1adc, 0x1adc, 0x1adb, 0x1ada, 0x1ada, 0x1ad9, 0x1ad8, // 20912
-    0x1ad8, 0x1ad7, 0x1ad6, 0x1ad6, 0x1ad5, 0x1ad4, 0x1ad4, 0x1ad3, // 20920
-    0x1ad2, 0x1ad2, 0x1ad1, 0x1ad0, 0x1ad0, 0x1acf, 0x1ace, 0x1ace, // 20928
-    0x1acd, 0x1acc, 0x1acc, 0x1acb, 0x1aca, 0x1aca, 0x1ac9, 0x1ac8, // 20936
-    0x1ac8, 0x1ac7, 0x1ac6, 0x1ac6, 0x1ac5, 0x1ac4, 0x1ac4, 0x1ac3, // 20944
-    0x1ac2, 0x1ac2, 0x1ac1, 0x1ac0, 0x1ac0, 0x1abf, 0x1abe, 0x1abd, // 20952
-    0x1abd, 0x1abc, 0x1abb, 0x1abb, 0x1aba, 0x1ab9, 0x1ab9, 0x1ab8, // 20960
-    0x1ab7, 0x1ab7, 0x1ab6, 0x1ab5, 0x1ab5, 0x1ab4, 0x1ab3, 0x1ab3, // 20968
-    0x1ab2, 0x1ab1, 0x1ab1, 0x1ab0, 0x1aaf, 0x1aaf, 0x1aae, 0x1aad, // 20976
-    0x1aad, 0x1aac, 0x1aab, 0x1aab, 0x1aaa, 0x1aa9, 0x1aa9, 0x1aa8, // 20984
-    0x1aa7, 0x1aa7, 0x1aa6, 0x1aa5, 0x1aa5, 0x1aa4, 0x1aa3, 0x1aa3, // 20992
-    0x1aa2, 0x1aa1, 0x1aa1, 0x1aa0, 0x1a9f, 0x1a9e, 0x1a9e, 0x1a9d, // 21000
-    0x1a9c, 0x1a9c, 0x1a9b, 0x1a9a, 0x1a9a, 0x1a99, 0x1a98, 0x1a98, // 21008
-    0x1a97, 0x1a96, 0x1a96, 0x1a95, 0x1a94, 0x1a94, 0x1a93, 0x1a92, // 21016
-    0x1a92, 0x1a91, 0x1a90, 0x1a90, 0x1a8f, 0x1a8e, 0x1a8e, 0x1a8d, // 21024
-    0x1a8c, 0x1a8c, 0x1a8b, 0x1a8a, 0x1a8a, 0x1a89, 0x1a88, 0x1a88, // 21032
-    0x1a87, 0x1a86, 0x1a86, 0x1a85, 0x1a84, 0x1a84, 0x1a83, 0x1a82, // 21040
-    0x1a82, 0x1a81, 0x1a80, 0x1a7f, 0x1a7f, 0x1a7e, 0x1a7d, 0x1a7d, // 21048
-    0x1a7c, 0x1a7b, 0x1a7b, 0x1a7a, 0x1a79, 0x1a79, 0x1a78, 0x1a77, // 21056
-    0x1a77, 0x1a76, 0x1a75, 0x1a75, 0x1a74, 0x1a73, 0x1a73, 0x1a72, // 21064
-    0x1a71, 0x1a71, 0x1a70, 0x1a6f, 0x1a6f, 0x1a6e, 0x1a6d, 0x1a6d, // 21072
-    0x1a6c, 0x1a6b, 0x1a6b, 0x1a6a, 0x1a69, 0x1a69, 0x1a68, 0x1a67, // 21080
-    0x1a67, 0x1a66, 0x1a65, 0x1a65, 0x1a64, 0x1a63, 0x1a63, 0x1a62, // 21088
-    0x1a61, 0x1a60, 0x1a60, 0x1a5f, 0x1a5e, 0x1a5e, 0x1a5d, 0x1a5c, // 21096
-    0x1a5c, 0x1a5b, 0x1a5a, 0x1a5a, 0x1a59, 0x1a58, 0x1a58, 0x1a57, // 21104
-    0x1a56, 0x1a56, 0x1a55, 0x1a54, 0x1a54, 0x1a53, 0x1a52, 0x1a52, // 21112
-    0x1a51, 0x1a50, 0x1a50, 0x1a4f, 0x1a4e, 0x1a4e, 0x1a4d, 0x1a4c, // 21120
-    0x1a4c, 0x1a4b, 0x1a4a, 0x1a4a, 0x1a49, 0x1a48, 0x1a48, 0x1a47, // 21128
-    0x1a46, 0x1a46, 0x1a45, 0x1a44, 0x1a44, 0x1a43, 0x1a42, 0x1a42, // 21136
-    0x1a41, 0x1a40, 0x1a3f, 0x1a3f, 0x1a3e, 0x1a3d, 0x1a3d, 0x1a3c, // 21144
-    0x1a3b, 0x1a3b, 0x1a3a, 0x1a39, 0x1a39, 0x1a38, 0x1a37, 0x1a37, // 21152
-    0x1a36, 0x1a35, 0x1a35, 0x1a34, 0x1a33, 0x1a33, 0x1a32, 0x1a31, // 21160
-    0x1a31, 0x1a30, 0x1a2f, 0x1a2f, 0x1a2e, 0x1a2d, 0x1a2d, 0x1a2c, // 21168
-    0x1a2b, 0x1a2b, 0x1a2a, 0x1a29, 0x1a29, 0x1a28, 0x1a27, 0x1a27, // 21176
-    0x1a26, 0x1a25, 0x1a25, 0x1a24, 0x1a23, 0x1a23, 0x1a22, 0x1a21, // 21184
-    0x1a20, 0x1a20, 0x1a1f, 0x1a1e, 0x1a1e, 0x1a1d, 0x1a1c, 0x1a1c, // 21192
-    0x1a1b, 0x1a1a, 0x1a1a, 0x1a19, 0x1a18, 0x1a18, 0x1a17, 0x1a16, // 21200
-    0x1a16, 0x1a15, 0x1a14, 0x1a14, 0x1a13, 0x1a12, 0x1a12, 0x1a11, // 21208
-    0x1a10, 0x1a10, 0x1a0f, 0x1a0e, 0x1a0e, 0x1a0d, 0x1a0c, 0x1a0c, // 21216
-    0x1a0b, 0x1a0a, 0x1a0a, 0x1a09, 0x1a08, 0x1a08, 0x1a07, 0x1a06, // 21224
-    0x1a06, 0x1a05, 0x1a04, 0x1a04, 0x1a03, 0x1a02, 0x1a01, 0x1a01, // 21232
-    0x1a00, 0x19ff, 0x19ff, 0x19fe, 0x19fd, 0x19fd, 0x19fc, 0x19fb, // 21240
-    0x19fb, 0x19fa, 0x19f9, 0x19f9, 0x19f8, 0x19f7, 0x19f7, 0x19f6, // 21248
-    0x19f5, 0x19f5, 0x19f4, 0x19f3, 0x19f3, 0x19f2, 0x19f1, 0x19f1, // 21256
-    0x19f0, 0x19ef, 0x19ef, 0x19ee, 0x19ed, 0x19ed, 0x19ec, 0x19eb, // 21264
-    0x19eb, 0x19ea, 0x19e9, 0x19e9, 0x19e8, 0x19e7, 0x19e7, 0x19e6, // 21272
-    0x19e5, 0x19e5, 0x19e4, 0x19e3, 0x19e2, 0x19e2, 0x19e1, 0x19e0, // 21280
-    0x19e0, 0x19df, 0x19de, 0x19de, 0x19dd, 0x19dc, 0x19dc, 0x19db, // 21288
-    0x19da, 0x19da, 0x19d9, 0x19d8, 0x19d8, 0x19d7, 0x19d6, 0x19d6, // 21296
-    0x19d5, 0x19d4, 0x19d4, 0x19d3, 0x19d2, 0x19d2, 0x19d1, 0x19d0, // 21304
-    0x19d0, 0x19cf, 0x19ce, 0x19ce, 0x19cd, 0x19cc, 0x19cc, 0x19cb, // 21312
-    0x19ca, 0x19ca, 0x19c9, 0x19c8, 0x19c8, 0x19c7, 0x19c6, 0x19c6, // 21320
-    0x19c5, 0x19c4, 0x19c3, 0x19c3, 0x19c2, 0x19c1, 0x19c1, 0x19c0, // 21328
-    0x19bf, 0x19bf, 0x19be, 0x19bd, 0x19bd, 0x19bc, 0x19bb, 0x19bb, // 21336
-    0x19ba, 0x19b9, 0x19b9, 0x19b8, 0x19b7, 0x19b7, 0x19b6, 0x19b5, // 21344
-    0x19b5, 0x19b4, 0x19b3, 0x19b3, 0x19b2, 0x19b1, 0x19b1, 0x19b0, // 21352
-    0x19af, 0x19af, 0x19ae, 0x19ad, 0x19ad, 0x19ac, 0x19ab, 0x19ab, // 21360
-    0x19aa, 0x19a9, 0x19a9, 0x19a8, 0x19a7, 0x19a7, 0x19a6, 0x19a5, // 21368
-    0x19a5, 0x19a4, 0x19a3, 0x19a2, 0x19a2, 0x19a1, 0x19a0, 0x19a0, // 21376
-    0x199f, 0x199e, 0x199e, 0x199d, 0x199c, 0x199c, 0x199b, 0x199a, // 21384
-    0x199a, 0x1999, 0x1998, 0x1998, 0x1997, 0x1996, 0x1996, 0x1995, // 21392
-    0x1994, 0x1994, 0x1993, 0x1992, 0x1992, 0x1991, 0x1990, 0x1990, // 21400
-    0x198f, 0x198e, 0x198e, 0x198d, 0x198c, 0x198c, 0x198b, 0x198a, // 21408
-    0x198a, 0x1989, 0x1988, 0x1988, 0x1987, 0x1986, 0x1986, 0x1985, // 21416
-    0x1984, 0x1983, 0x1983, 0x1982, 0x1981, 0x1981, 0x1980, 0x197f, // 21424
-    0x197f, 0x197e, 0x197d, 0x197d, 0x197c, 0x197b, 0x197b, 0x197a, // 21432
-    0x1979, 0x1979, 0x1978, 0x1977, 0x1977, 0x1976, 0x1975, 0x1975, // 21440
-    0x1974, 0x1973, 0x1973, 0x1972, 0x1971, 0x1971, 0x1970, 0x196f, // 21448
-    0x196f, 0x196e, 0x196d, 0x196d, 0x196c, 0x196b, 0x196b, 0x196a, // 21456
-    0x1969, 0x1969, 0x1968, 0x1967, 0x1967, 0x1966, 0x1965, 0x1964, // 21464
-    0x1964, 0x1963, 0x1962, 0x1962, 0x1961, 0x1960, 0x1960, 0x195f, // 21472
-    0x195e, 0x195e, 0x195d, 0x195c, 0x195c, 0x195b, 0x195a, 0x195a, // 21480
-    0x1959, 0x1958, 0x1958, 0x1957, 0x1956, 0x1956, 0x1955, 0x1954, // 21488
-    0x1954, 0x1953, 0x1952, 0x1952, 0x1951, 0x1950, 0x1950, 0x194f, // 21496
-    0x194f, 0x194e, 0x194e, 0x194d, 0x194c, 0x194c, 0x194b, 0x194a, // 21504
-    0x194a, 0x1949, 0x1948, 0x1948, 0x1947, 0x1946, 0x1946, 0x1945, // 21512
-    0x1945, 0x1944, 0x1943, 0x1943, 0x1942, 0x1941, 0x1941, 0x1940, // 21520
-    0x193f, 0x193f, 0x193e, 0x193d, 0x193d, 0x193c, 0x193b, 0x193b, // 21528
-    0x193a, 0x1939, 0x1939, 0x1938, 0x1937, 0x1937, 0x1936, 0x1935, // 21536
-    0x1935, 0x1934, 0x1934, 0x1933, 0x1932, 0x1932, 0x1931, 0x1930, // 21544
-    0x1930, 0x192f, 0x192e, 0x192e, 0x192d, 0x192c, 0x192c, 0x192b, // 21552
-    0x192a, 0x192a, 0x1929, 0x1928, 0x1928, 0x1927, 0x1926, 0x1926, // 21560
-    0x1925, 0x1924, 0x1924, 0x1923, 0x1923, 0x1922, 0x1921, 0x1921, // 21568
-    0x1920, 0x191f, 0x191f, 0x191e, 0x191d, 0x191d, 0x191c, 0x191b, // 21576
-    0x191b, 0x191a, 0x1919, 0x1919, 0x1918, 0x1917, 0x1917, 0x1916, // 21584
-    0x1915, 0x1915, 0x1914, 0x1913, 0x1913, 0x1912, 0x1911, 0x1911, // 21592
-    0x1910, 0x1910, 0x190f, 0x190e, 0x190e, 0x190d, 0x190c, 0x190c, // 21600
-    0x190b, 0x190a, 0x190a, 0x1909, 0x1908, 0x1908, 0x1907, 0x1906, // 21608
-    0x1906, 0x1905, 0x1904, 0x1904, 0x1903, 0x1902, 0x1902, 0x1901, // 21616
-    0x1900, 0x1900, 0x18ff, 0x18ff, 0x18fe, 0x18fd, 0x18fd, 0x18fc, // 21624
-    0x18fb, 0x18fb, 0x18fa, 0x18f9, 0x18f9, 0x18f8, 0x18f7, 0x18f7, // 21632
-    0x18f6, 0x18f5, 0x18f5, 0x18f4, 0x18f3, 0x18f3, 0x18f2, 0x18f1, // 21640
-    0x18f1, 0x18f0, 0x18ef, 0x18ef, 0x18ee, 0x18ee, 0x18ed, 0x18ec, // 21648
-    0x18ec, 0x18eb, 0x18ea, 0x18ea, 0x18e9, 0x18e8, 0x18e8, 0x18e7, // 21656
-    0x18e6, 0x18e6, 0x18e5, 0x18e4, 0x18e4, 0x18e3, 0x18e2, 0x18e2, // 21664
-    0x18e1, 0x18e0, 0x18e0, 0x18df, 0x18de, 0x18de, 0x18dd, 0x18dc, // 21672
-    0x18dc, 0x18db, 0x18db, 0x18da, 0x18d9, 0x18d9, 0x18d8, 0x18d7, // 21680
-    0x18d7, 0x18d6, 0x18d5, 0x18d5, 0x18d4, 0x18d3, 0x18d3, 0x18d2, // 21688
-    0x18d1, 0x18d1, 0x18d0, 0x18cf, 0x18cf, 0x18ce, 0x18cd, 0x18cd, // 21696
-    0x18cc, 0x18cb, 0x18cb, 0x18ca, 0x18ca, 0x18c9, 0x18c8, 0x18c8, // 21704
-    0x18c7, 0x18c6, 0x18c6, 0x18c5, 0x18c4, 0x18c4, 0x18c3, 0x18c2, // 21712
-    0x18c2, 0x18c1, 0x18c0, 0x18c0, 0x18bf, 0x18be, 0x18be, 0x18bd, // 21720
-    0x18bc, 0x18bc, 0x18bb, 0x18ba, 0x18ba, 0x18b9, 0x18b9, 0x18b8, // 21728
-    0x18b7, 0x18b7, 0x18b6, 0x18b5, 0x18b5, 0x18b4, 0x18b3, 0x18b3, // 21736
-    0x18b2, 0x18b1, 0x18b1, 0x18b0, 0x18af, 0x18af, 0x18ae, 0x18ad, // 21744
-    0x18ad, 0x18ac, 0x18ab, 0x18ab, 0x18aa, 0x18a9, 0x18a9, 0x18a8, // 21752
-    0x18a8, 0x18a7, 0x18a6, 0x18a6, 0x18a5, 0x18a4, 0x18a4, 0x18a3, // 21760
-    0x18a2, 0x18a2, 0x18a1, 0x18a0, 0x18a0, 0x189f, 0x189e, 0x189e, // 21768
-    0x189d, 0x189c, 0x189c, 0x189b, 0x189a, 0x189a, 0x1899, 0x1898, // 21776
-    0x1898, 0x1897, 0x1896, 0x1896, 0x1895, 0x1895, 0x1894, 0x1893, // 21784
-    0x1893, 0x1892, 0x1891, 0x1891, 0x1890, 0x188f, 0x188f, 0x188e, // 21792
-    0x188d, 0x188d, 0x188c, 0x188b, 0x188b, 0x188a, 0x1889, 0x1889, // 21800
-    0x1888, 0x1887, 0x1887, 0x1886, 0x1885, 0x1885, 0x1884, 0x1884, // 21808
-    0x1883, 0x1882, 0x1882, 0x1881, 0x1880, 0x1880, 0x187f, 0x187e, // 21816
-    0x187e, 0x187d, 0x187c, 0x187c, 0x187b, 0x187a, 0x187a, 0x1879, // 21824
-    0x1878, 0x1878, 0x1877, 0x1876, 0x1876, 0x1875, 0x1874, 0x1874, // 21832
-    0x1873, 0x1873, 0x1872, 0x1871, 0x1871, 0x1870, 0x186f, 0x186f, // 21840
-    0x186e, 0x186d, 0x186d, 0x186c, 0x186b, 0x186b, 0x186a, 0x1869, // 21848
-    0x1869, 0x1868, 0x1867, 0x1867, 0x1866, 0x1865, 0x1865, 0x1864, // 21856
-    0x1863, 0x1863, 0x1862, 0x1861, 0x1861, 0x1860, 0x1860, 0x185f, // 21864
-    0x185e, 0x185e, 0x185d, 0x185c, 0x185c, 0x185b, 0x185a, 0x185a, // 21872
-    0x1859, 0x1858, 0x1858, 0x1857, 0x1856, 0x1856, 0x1855, 0x1854, // 21880
-    0x1854, 0x1853, 0x1852, 0x1852, 0x1851, 0x1850, 0x1850, 0x184f, // 21888
-    0x184f, 0x184e, 0x184d, 0x184d, 0x184c, 0x184b, 0x184b, 0x184a, // 21896
-    0x1849, 0x1849, 0x1848, 0x1847, 0x1847, 0x1846, 0x1845, 0x1845, // 21904
-    0x1844, 0x1843, 0x1843, 0x1842, 0x1841, 0x1841, 0x1840, 0x183f, // 21912
-    0x183f, 0x183e, 0x183e, 0x183d, 0x183c, 0x183c, 0x183b, 0x183a, // 21920
-    0x183a, 0x1839, 0x1838, 0x1838, 0x1837, 0x1836, 0x1836, 0x1835, // 21928
-    0x1834, 0x1834, 0x1833, 0x1832, 0x1832, 0x1831, 0x1830, 0x1830, // 21936
-    0x182f, 0x182e, 0x182e, 0x182d, 0x182c, 0x182c, 0x182b, 0x182b, // 21944
-    0x182a, 0x1829, 0x1829, 0x1828, 0x1827, 0x1827, 0x1826, 0x1825, // 21952
-    0x1825, 0x1824, 0x1823, 0x1823, 0x1822, 0x1821, 0x1821, 0x1820, // 21960
-    0x181f, 0x181f, 0x181e, 0x181d, 0x181d, 0x181c, 0x181b, 0x181b, // 21968
-    0x181a, 0x181a, 0x1819, 0x1818, 0x1818, 0x1817, 0x1816, 0x1816, // 21976
-    0x1815, 0x1814, 0x1814, 0x1813, 0x1812, 0x1812, 0x1811, 0x1810, // 21984
-    0x1810, 0x180f, 0x180e, 0x180e, 0x180d, 0x180c, 0x180c, 0x180b, // 21992
-    0x180a, 0x180a, 0x1809, 0x1809, 0x1808, 0x1807, 0x1807, 0x1806, // 22000
-    0x1805, 0x1805, 0x1804, 0x1803, 0x1803, 0x1802, 0x1801, 0x1801, // 22008
-    0x1800, 0x17ff, 0x17ff, 0x17fe, 0x17fd, 0x17fd, 0x17fc, 0x17fb, // 22016
-    0x17fb, 0x17fa, 0x17f9, 0x17f9, 0x17f8, 0x17f7, 0x17f7, 0x17f6, // 22024
-    0x17f6, 0x17f5, 0x17f4, 0x17f4, 0x17f3, 0x17f2, 0x17f2, 0x17f1, // 22032
-    0x17f0, 0x17f0, 0x17ef, 0x17ee, 0x17ee, 0x17ed, 0x17ec, 0x17ec, // 22040
-    0x17eb, 0x17ea, 0x17ea, 0x17e9, 0x17e8, 0x17e8, 0x17e7, 0x17e6, // 22048
-    0x17e6, 0x17e5, 0x17e5, 0x17e4, 0x17e3, 0x17e3, 0x17e2, 0x17e1, // 22056
-    0x17e1, 0x17e0, 0x17df, 0x17df, 0x17de, 0x17dd, 0x17dd, 0x17dc, // 22064
-    0x17db, 0x17db, 0x17da, 0x17d9, 0x17d9, 0x17d8, 0x17d7, 0x17d7, // 22072
-    0x17d6, 0x17d5, 0x17d5, 0x17d4, 0x17d4, 0x17d3, 0x17d2, 0x17d2, // 22080
-    0x17d1, 0x17d0, 0x17d0, 0x17cf, 0x17ce, 0x17ce, 0x17cd, 0x17cc, // 22088
-    0x17cc, 0x17cb, 0x17ca, 0x17ca, 0x17c9, 0x17c8, 0x17c8, 0x17c7, // 22096
-    0x17c6, 0x17c6, 0x17c5, 0x17c4, 0x17c4, 0x17c3, 0x17c2, 0x17c2, // 22104
-    0x17c1, 0x17c1, 0x17c0, 0x17bf, 0x17bf, 0x17be, 0x17bd, 0x17bd, // 22112
-    0x17bc, 0x17bb, 0x17bb, 0x17ba, 0x17b9, 0x17b9, 0x17b8, 0x17b7, // 22120
-    0x17b7, 0x17b6, 0x17b5, 0x17b5, 0x17b4, 0x17b3, 0x17b3, 0x17b2, // 22128
-    0x17b1, 0x17b1, 0x17b0, 0x17b0, 0x17af, 0x17ae, 0x17ae, 0x17ad, // 22136
-    0x17ac, 0x17ac, 0x17ab, 0x17aa, 0x17aa, 0x17a9, 0x17a8, 0x17a8, // 22144
-    0x17a7, 0x17a6, 0x17a6, 0x17a5, 0x17a4, 0x17a4, 0x17a3, 0x17a2, // 22152
-    0x17a2, 0x17a1, 0x17a0, 0x17a0, 0x179f, 0x179f, 0x179e, 0x179d, // 22160
-    0x179d, 0x179c, 0x179b, 0x179b, 0x179a, 0x1799, 0x1799, 0x1798, // 22168
-    0x1797, 0x1797, 0x1796, 0x1795, 0x1795, 0x1794, 0x1793, 0x1793, // 22176
-    0x1792, 0x1791, 0x1791, 0x1790, 0x178f, 0x178f, 0x178e, 0x178d, // 22184
-    0x178d, 0x178c, 0x178c, 0x178b, 0x178a, 0x178a, 0x1789, 0x1788, // 22192
-    0x1788, 0x1787, 0x1786, 0x1786, 0x1785, 0x1784, 0x1784, 0x1783, // 22200
-    0x1782, 0x1782, 0x1781, 0x1780, 0x1780, 0x177f, 0x177e, 0x177e, // 22208
-    0x177d, 0x177c, 0x177c, 0x177b, 0x177b, 0x177a, 0x1779, 0x1779, // 22216
-    0x1778, 0x1777, 0x1777, 0x1776, 0x1775, 0x1775, 0x1774, 0x1773, // 22224
-    0x1773, 0x1772, 0x1771, 0x1771, 0x1770, 0x176f, 0x176f, 0x176e, // 22232
-    0x176d, 0x176d, 0x176c, 0x176b, 0x176b, 0x176a, 0x176a, 0x1769, // 22240
-    0x1768, 0x1768, 0x1767, 0x1766, 0x1766, 0x1765, 0x1764, 0x1764, // 22248
-    0x1763, 0x1762, 0x1762, 0x1761, 0x1760, 0x1760, 0x175f, 0x175e, // 22256
-    0x175e, 0x175d, 0x175c, 0x175c, 0x175b, 0x175a, 0x175a, 0x1759, // 22264
-    0x1759, 0x1758, 0x1757, 0x1757, 0x1756, 0x1755, 0x1755, 0x1754, // 22272
-    0x1753, 0x1753, 0x1752, 0x1751, 0x1751, 0x1750, 0x174f, 0x174f, // 22280
-    0x174e, 0x174d, 0x174d, 0x174c, 0x174b, 0x174b, 0x174a, 0x1749, // 22288
-    0x1749, 0x1748, 0x1747, 0x1747, 0x1746, 0x1746, 0x1745, 0x1744, // 22296
-    0x1744, 0x1743, 0x1742, 0x1742, 0x1741, 0x1740, 0x1740, 0x173f, // 22304
-    0x173e, 0x173e, 0x173d, 0x173c, 0x173c, 0x173b, 0x173a, 0x173a, // 22312
-    0x1739, 0x1738, 0x1738, 0x1737, 0x1736, 0x1736, 0x1735, 0x1735, // 22320
-    0x1734, 0x1733, 0x1733, 0x1732, 0x1731, 0x1731, 0x1730, 0x172f, // 22328
-    0x172f, 0x172e, 0x172d, 0x172d, 0x172c, 0x172b, 0x172b, 0x172a, // 22336
-    0x1729, 0x1729, 0x1728, 0x1727, 0x1727, 0x1726, 0x1725, 0x1725, // 22344
-    0x1724, 0x1724, 0x1723, 0x1722, 0x1722, 0x1721, 0x1720, 0x1720, // 22352
-    0x171f, 0x171e, 0x171e, 0x171d, 0x171c, 0x171c, 0x171b, 0x171a, // 22360
-    0x171a, 0x1719, 0x1718, 0x1718, 0x1717, 0x1716, 0x1716, 0x1715, // 22368
-    0x1714, 0x1714, 0x1713, 0x1712, 0x1712, 0x1711, 0x1711, 0x1710, // 22376
-    0x170f, 0x170f, 0x170e, 0x170d, 0x170d, 0x170c, 0x170b, 0x170b, // 22384
-    0x170a, 0x1709, 0x1709, 0x1708, 0x1707, 0x1707, 0x1706, 0x1705, // 22392
-    0x1705, 0x1704, 0x1703, 0x1703, 0x1702, 0x1701, 0x1701, 0x1700, // 22400
-    0x1700, 0x16ff, 0x16fe, 0x16fe, 0x16fd, 0x16fc, 0x16fc, 0x16fb, // 22408
-    0x16fa, 0x16fa, 0x16f9, 0x16f8, 0x16f8, 0x16f7, 0x16f6, 0x16f6, // 22416
-    0x16f5, 0x16f4, 0x16f4, 0x16f3, 0x16f2, 0x16f2, 0x16f1, 0x16f0, // 22424
-    0x16f0, 0x16ef, 0x16ef, 0x16ee, 0x16ed, 0x16ed, 0x16ec, 0x16eb, // 22432
-    0x16eb, 0x16ea, 0x16e9, 0x16e9, 0x16e8, 0x16e7, 0x16e7, 0x16e6, // 22440
-    0x16e5, 0x16e5, 0x16e4, 0x16e3, 0x16e3, 0x16e2, 0x16e1, 0x16e1, // 22448
-    0x16e0, 0x16df, 0x16df, 0x16de, 0x16dd, 0x16dd, 0x16dc, 0x16dc, // 22456
-    0x16db, 0x16da, 0x16da, 0x16d9, 0x16d8, 0x16d8, 0x16d7, 0x16d6, // 22464
-    0x16d6, 0x16d5, 0x16d4, 0x16d4, 0x16d3, 0x16d2, 0x16d2, 0x16d1, // 22472
-    0x16d0, 0x16d0, 0x16cf, 0x16ce, 0x16ce, 0x16cd, 0x16cc, 0x16cc, // 22480
-    0x16cb, 0x16cb, 0x16ca, 0x16c9, 0x16c9, 0x16c8, 0x16c7, 0x16c7, // 22488
-    0x16c6, 0x16c5, 0x16c5, 0x16c4, 0x16c3, 0x16c3, 0x16c2, 0x16c1, // 22496
-    0x16c1, 0x16c0, 0x16bf, 0x16bf, 0x16be, 0x16bd, 0x16bd, 0x16bc, // 22504
-    0x16bb, 0x16bb, 0x16ba, 0x16ba, 0x16b9, 0x16b8, 0x16b8, 0x16b7, // 22512
-    0x16b6, 0x16b6, 0x16b5, 0x16b4, 0x16b4, 0x16b3, 0x16b2, 0x16b2, // 22520
-    0x16b1, 0x16b0, 0x16af, 0x16af, 0x16ae, 0x16ad, 0x16ad, 0x16ac, // 22528
-    0x16ab, 0x16ab, 0x16aa, 0x16aa, 0x16a9, 0x16a8, 0x16a8, 0x16a7, // 22536
-    0x16a6, 0x16a6, 0x16a5, 0x16a4, 0x16a4, 0x16a3, 0x16a3, 0x16a2, // 22544
-    0x16a1, 0x16a1, 0x16a0, 0x169f, 0x169f, 0x169e, 0x169d, 0x169d, // 22552
-    0x169c, 0x169c, 0x169b, 0x169a, 0x169a, 0x1699, 0x1698, 0x1698, // 22560
-    0x1697, 0x1696, 0x1696, 0x1695, 0x1695, 0x1694, 0x1693, 0x1693, // 22568
-    0x1692, 0x1691, 0x1691, 0x1690, 0x168f, 0x168f, 0x168e, 0x168e, // 22576
-    0x168d, 0x168c, 0x168c, 0x168b, 0x168a, 0x168a, 0x1689, 0x1689, // 22584
-    0x1688, 0x1687, 0x1687, 0x1686, 0x1685, 0x1685, 0x1684, 0x1683, // 22592
-    0x1683, 0x1682, 0x1682, 0x1681, 0x1680, 0x1680, 0x167f, 0x167e, // 22600
-    0x167e, 0x167d, 0x167c, 0x167c, 0x167b, 0x167b, 0x167a, 0x1679, // 22608
-    0x1679, 0x1678, 0x1677, 0x1677, 0x1676, 0x1675, 0x1675, 0x1674, // 22616
-    0x1674, 0x1673, 0x1672, 0x1672, 0x1671, 0x1670, 0x1670, 0x166f, // 22624
-    0x166e, 0x166e, 0x166d, 0x166d, 0x166c, 0x166b, 0x166b, 0x166a, // 22632
-    0x1669, 0x1669, 0x1668, 0x1668, 0x1667, 0x1666, 0x1666, 0x1665, // 22640
-    0x1664, 0x1664, 0x1663, 0x1662, 0x1662, 0x1661, 0x1661, 0x1660, // 22648
-    0x165f, 0x165f, 0x165e, 0x165d, 0x165d, 0x165c, 0x165b, 0x165b, // 22656
-    0x165a, 0x165a, 0x1659, 0x1658, 0x1658, 0x1657, 0x1656, 0x1656, // 22664
-    0x1655, 0x1654, 0x1654, 0x1653, 0x1653, 0x1652, 0x1651, 0x1651, // 22672
-    0x1650, 0x164f, 0x164f, 0x164e, 0x164d, 0x164d, 0x164c, 0x164c, // 22680
-    0x164b, 0x164a, 0x164a, 0x1649, 0x1648, 0x1648, 0x1647, 0x1646, // 22688
-    0x1646, 0x1645, 0x1645, 0x1644, 0x1643, 0x1643, 0x1642, 0x1641, // 22696
-    0x1641, 0x1640, 0x1640, 0x163f, 0x163e, 0x163e, 0x163d, 0x163c, // 22704
-    0x163c, 0x163b, 0x163a, 0x163a, 0x1639, 0x1639, 0x1638, 0x1637, // 22712
-    0x1637, 0x1636, 0x1635, 0x1635, 0x1634, 0x1633, 0x1633, 0x1632, // 22720
-    0x1632, 0x1631, 0x1630, 0x1630, 0x162f, 0x162e, 0x162e, 0x162d, // 22728
-    0x162c, 0x162c, 0x162b, 0x162b, 0x162a, 0x1629, 0x1629, 0x1628, // 22736
-    0x1627, 0x1627, 0x1626, 0x1625, 0x1625, 0x1624, 0x1624, 0x1623, // 22744
-    0x1622, 0x1622, 0x1621, 0x1620, 0x1620, 0x161f, 0x161f, 0x161e, // 22752
-    0x161d, 0x161d, 0x161c, 0x161b, 0x161b, 0x161a, 0x1619, 0x1619, // 22760
-    0x1618, 0x1618, 0x1617, 0x1616, 0x1616, 0x1615, 0x1614, 0x1614, // 22768
-    0x1613, 0x1612, 0x1612, 0x1611, 0x1611, 0x1610, 0x160f, 0x160f, // 22776
-    0x160e, 0x160d, 0x160d, 0x160c, 0x160b, 0x160b, 0x160a, 0x160a, // 22784
-    0x1609, 0x1608, 0x1608, 0x1607, 0x1606, 0x1606, 0x1605, 0x1604, // 22792
-    0x1604, 0x1603, 0x1603, 0x1602, 0x1601, 0x1601, 0x1600, 0x15ff, // 22800
-    0x15ff, 0x15fe, 0x15fd, 0x15fd, 0x15fc, 0x15fc, 0x15fb, 0x15fa, // 22808
-    0x15fa, 0x15f9, 0x15f8, 0x15f8, 0x15f7, 0x15f7, 0x15f6, 0x15f5, // 22816
-    0x15f5, 0x15f4, 0x15f3, 0x15f3, 0x15f2, 0x15f1, 0x15f1, 0x15f0, // 22824
-    0x15f0, 0x15ef, 0x15ee, 0x15ee, 0x15ed, 0x15ec, 0x15ec, 0x15eb, // 22832
-    0x15ea, 0x15ea, 0x15e9, 0x15e9, 0x15e8, 0x15e7, 0x15e7, 0x15e6, // 22840
-    0x15e5, 0x15e5, 0x15e4, 0x15e3, 0x15e3, 0x15e2, 0x15e2, 0x15e1, // 22848
-    0x15e0, 0x15e0, 0x15df, 0x15de, 0x15de, 0x15dd, 0x15dc, 0x15dc, // 22856
-    0x15db, 0x15db, 0x15da, 0x15d9, 0x15d9, 0x15d8, 0x15d7, 0x15d7, // 22864
-    0x15d6, 0x15d6, 0x15d5, 0x15d4, 0x15d4, 0x15d3, 0x15d2, 0x15d2, // 22872
-    0x15d1, 0x15d0, 0x15d0, 0x15cf, 0x15cf, 0x15ce, 0x15cd, 0x15cd, // 22880
-    0x15cc, 0x15cb, 0x15cb, 0x15ca, 0x15c9, 0x15c9, 0x15c8, 0x15c8, // 22888
-    0x15c7, 0x15c6, 0x15c6, 0x15c5, 0x15c4, 0x15c4, 0x15c3, 0x15c2, // 22896
-    0x15c2, 0x15c1, 0x15c1, 0x15c0, 0x15bf, 0x15bf, 0x15be, 0x15bd, // 22904
-    0x15bd, 0x15bc, 0x15bb, 0x15bb, 0x15ba, 0x15ba, 0x15b9, 0x15b8, // 22912
-    0x15b8, 0x15b7, 0x15b6, 0x15b6, 0x15b5, 0x15b4, 0x15b4, 0x15b3, // 22920
-    0x15b3, 0x15b2, 0x15b1, 0x15b1, 0x15b0, 0x15af, 0x15af, 0x15ae, // 22928
-    0x15ae, 0x15ad, 0x15ac, 0x15ac, 0x15ab, 0x15aa, 0x15aa, 0x15a9, // 22936
-    0x15a8, 0x15a8, 0x15a7, 0x15a7, 0x15a6, 0x15a5, 0x15a5, 0x15a4, // 22944
-    0x15a3, 0x15a3, 0x15a2, 0x15a1, 0x15a1, 0x15a0, 0x15a0, 0x159f, // 22952
-    0x159e, 0x159e, 0x159d, 0x159c, 0x159c, 0x159b, 0x159a, 0x159a, // 22960
-    0x1599, 0x1599, 0x1598, 0x1597, 0x1597, 0x1596, 0x1595, 0x1595, // 22968
-    0x1594, 0x1593, 0x1593, 0x1592, 0x1592, 0x1591, 0x1590, 0x1590, // 22976
-    0x158f, 0x158e, 0x158e, 0x158d, 0x158d, 0x158c, 0x158b, 0x158b, // 22984
-    0x158a, 0x1589, 0x1589, 0x1588, 0x1587, 0x1587, 0x1586, 0x1586, // 22992
-    0x1585, 0x1584, 0x1584, 0x1583, 0x1582, 0x1582, 0x1581, 0x1580, // 23000
-    0x1580, 0x157f, 0x157f, 0x157e, 0x157d, 0x157d, 0x157c, 0x157b, // 23008
-    0x157b, 0x157a, 0x1579, 0x1579, 0x1578, 0x1578, 0x1577, 0x1576, // 23016
-    0x1576, 0x1575, 0x1574, 0x1574, 0x1573, 0x1572, 0x1572, 0x1571, // 23024
-    0x1571, 0x1570, 0x156f, 0x156f, 0x156e, 0x156d, 0x156d, 0x156c, // 23032
-    0x156c, 0x156b, 0x156a, 0x156a, 0x1569, 0x1568, 0x1568, 0x1567, // 23040
-    0x1566, 0x1566, 0x1565, 0x1565, 0x1564, 0x1563, 0x1563, 0x1562, // 23048
-    0x1561, 0x1561, 0x1560, 0x155f, 0x155f, 0x155e, 0x155e, 0x155d, // 23056
-    0x155c, 0x155c, 0x155b, 0x155a, 0x155a, 0x1559, 0x1558, 0x1558, // 23064
-    0x1557, 0x1557, 0x1556, 0x1555, 0x1555, 0x1554, 0x1553, 0x1553, // 23072
-    0x1552, 0x1551, 0x1551, 0x1550, 0x1550, 0x154f, 0x154e, 0x154e, // 23080
-    0x154d, 0x154c, 0x154c, 0x154b, 0x154a, 0x154a, 0x1549, 0x1549, // 23088
-    0x1548, 0x1547, 0x1547, 0x1546, 0x1545, 0x1545, 0x1544, 0x1544, // 23096
-    0x1543, 0x1542, 0x1542, 0x1541, 0x1540, 0x1540, 0x153f, 0x153e, // 23104
-    0x153e, 0x153d, 0x153d, 0x153c, 0x153b, 0x153b, 0x153a, 0x1539, // 23112
-    0x1539, 0x1538, 0x1537, 0x1537, 0x1536, 0x1536, 0x1535, 0x1534, // 23120
-    0x1534, 0x1533, 0x1532, 0x1532, 0x1531, 0x1530, 0x1530, 0x152f, // 23128
-    0x152f, 0x152e, 0x152d, 0x152d, 0x152c, 0x152b, 0x152b, 0x152a, // 23136
-    0x1529, 0x1529, 0x1528, 0x1528, 0x1527, 0x1526, 0x1526, 0x1525, // 23144
-    0x1524, 0x1524, 0x1523, 0x1523, 0x1522, 0x1521, 0x1521, 0x1520, // 23152
-    0x151f, 0x151f, 0x151e, 0x151d, 0x151d, 0x151c, 0x151c, 0x151b, // 23160
-    0x151a, 0x151a, 0x1519, 0x1518, 0x1518, 0x1517, 0x1516, 0x1516, // 23168
-    0x1515, 0x1515, 0x1514, 0x1513, 0x1513, 0x1512, 0x1511, 0x1511, // 23176
-    0x1510, 0x150f, 0x150f, 0x150e, 0x150e, 0x150d, 0x150c, 0x150c, // 23184
-    0x150b, 0x150a, 0x150a, 0x1509, 0x1508, 0x1508, 0x1507, 0x1507, // 23192
-    0x1506, 0x1505, 0x1505, 0x1504, 0x1503, 0x1503, 0x1502, 0x1501, // 23200
-    0x1501, 0x1500, 0x1500, 0x14ff, 0x14fe, 0x14fe, 0x14fd, 0x14fc, // 23208
-    0x14fc, 0x14fb, 0x14fb, 0x14fa, 0x14f9, 0x14f9, 0x14f8, 0x14f7, // 23216
-    0x14f7, 0x14f6, 0x14f5, 0x14f5, 0x14f4, 0x14f4, 0x14f3, 0x14f2, // 23224
-    0x14f2, 0x14f1, 0x14f0, 0x14f0, 0x14ef, 0x14ee, 0x14ee, 0x14ed, // 23232
-    0x14ed, 0x14ec, 0x14eb, 0x14eb, 0x14ea, 0x14e9, 0x14e9, 0x14e8, // 23240
-    0x14e7, 0x14e7, 0x14e6, 0x14e6, 0x14e5, 0x14e4, 0x14e4, 0x14e3, // 23248
-    0x14e2, 0x14e2, 0x14e1, 0x14e0, 0x14e0, 0x14df, 0x14df, 0x14de, // 23256
-    0x14dd, 0x14dd, 0x14dc, 0x14db, 0x14db, 0x14da, 0x14da, 0x14d9, // 23264
-    0x14d8, 0x14d8, 0x14d7, 0x14d6, 0x14d6, 0x14d5, 0x14d4, 0x14d4, // 23272
-    0x14d3, 0x14d3, 0x14d2, 0x14d1, 0x14d1, 0x14d0, 0x14cf, 0x14cf, // 23280
-    0x14ce, 0x14cd, 0x14cd, 0x14cc, 0x14cc, 0x14cb, 0x14ca, 0x14ca, // 23288
-    0x14c9, 0x14c8, 0x14c8, 0x14c7, 0x14c6, 0x14c6, 0x14c5, 0x14c5, // 23296
-    0x14c4, 0x14c3, 0x14c3, 0x14c2, 0x14c1, 0x14c1, 0x14c0, 0x14bf, // 23304
-    0x14bf, 0x14be, 0x14be, 0x14bd, 0x14bc, 0x14bc, 0x14bb, 0x14ba, // 23312
-    0x14ba, 0x14b9, 0x14b8, 0x14b8, 0x14b7, 0x14b7, 0x14b6, 0x14b5, // 23320
-    0x14b5, 0x14b4, 0x14b3, 0x14b3, 0x14b2, 0x14b2, 0x14b1, 0x14b0, // 23328
-    0x14b0, 0x14af, 0x14ae, 0x14ae, 0x14ad, 0x14ac, 0x14ac, 0x14ab, // 23336
-    0x14ab, 0x14aa, 0x14a9, 0x14a9, 0x14a8, 0x14a7, 0x14a7, 0x14a6, // 23344
-    0x14a5, 0x14a5, 0x14a4, 0x14a4, 0x14a3, 0x14a2, 0x14a2, 0x14a1, // 23352
-    0x14a0, 0x14a0, 0x149f, 0x149e, 0x149e, 0x149d, 0x149d, 0x149c, // 23360
-    0x149b, 0x149b, 0x149a, 0x1499, 0x1499, 0x1498, 0x1497, 0x1497, // 23368
-    0x1496, 0x1496, 0x1495, 0x1494, 0x1494, 0x1493, 0x1492, 0x1492, // 23376
-    0x1491, 0x1491, 0x1490, 0x148f, 0x148f, 0x148e, 0x148d, 0x148d, // 23384
-    0x148c, 0x148b, 0x148b, 0x148a, 0x148a, 0x1489, 0x1488, 0x1488, // 23392
-    0x1487, 0x1486, 0x1486, 0x1485, 0x1484, 0x1484, 0x1483, 0x1483, // 23400
-    0x1482, 0x1481, 0x1481, 0x1480, 0x147f, 0x147f, 0x147e, 0x147d, // 23408
-    0x147d, 0x147c, 0x147c, 0x147b, 0x147a, 0x147a, 0x1479, 0x1478, // 23416
-    0x1478, 0x1477, 0x1476, 0x1476, 0x1475, 0x1475, 0x1474, 0x1473, // 23424
-    0x1473, 0x1472, 0x1471, 0x1471, 0x1470, 0x146f, 0x146f, 0x146e, // 23432
-    0x146e, 0x146d, 0x146c, 0x146c, 0x146b, 0x146a, 0x146a, 0x1469, // 23440
-    0x1469, 0x1468, 0x1467, 0x1467, 0x1466, 0x1465, 0x1465, 0x1464, // 23448
-    0x1463, 0x1463, 0x1462, 0x1462, 0x1461, 0x1460, 0x1460, 0x145f, // 23456
-    0x145e, 0x145e, 0x145d, 0x145c, 0x145c, 0x145b, 0x145b, 0x145a, // 23464
-    0x1459, 0x1459, 0x1458, 0x1457, 0x1457, 0x1456, 0x1455, 0x1455, // 23472
-    0x1454, 0x1454, 0x1453, 0x1452, 0x1452, 0x1451, 0x1450, 0x1450, // 23480
-    0x144f, 0x144e, 0x144e, 0x144d, 0x144d, 0x144c, 0x144b, 0x144b, // 23488
-    0x144a, 0x1449, 0x1449, 0x1448, 0x1448, 0x1447, 0x1446, 0x1446, // 23496
-    0x1445, 0x1444, 0x1444, 0x1443, 0x1442, 0x1442, 0x1441, 0x1441, // 23504
-    0x1440, 0x143f, 0x143f, 0x143e, 0x143d, 0x143d, 0x143c, 0x143b, // 23512
-    0x143b, 0x143a, 0x143a, 0x1439, 0x1438, 0x1438, 0x1437, 0x1436, // 23520
-    0x1436, 0x1435, 0x1434, 0x1434, 0x1433, 0x1433, 0x1432, 0x1431, // 23528
-    0x1431, 0x1430, 0x142f, 0x142f, 0x142e, 0x142d, 0x142d, 0x142c, // 23536
-    0x142c, 0x142b, 0x142a, 0x142a, 0x1429, 0x1428, 0x1428, 0x1427, // 23544
-    0x1426, 0x1425, 0x1424, 0x1424, 0x1423, 0x1422, 0x1422, 0x1421, // 23552
-    0x1421, 0x1420, 0x141f, 0x141f, 0x141e, 0x141d, 0x141d, 0x141c, // 23560
-    0x141c, 0x141b, 0x141a, 0x141a, 0x1419, 0x1418, 0x1418, 0x1417, // 23568
-    0x1417, 0x1416, 0x1415, 0x1415, 0x1414, 0x1414, 0x1413, 0x1412, // 23576
-    0x1412, 0x1411, 0x1410, 0x1410, 0x140f, 0x140f, 0x140e, 0x140d, // 23584
-    0x140d, 0x140c, 0x140b, 0x140b, 0x140a, 0x140a, 0x1409, 0x1408, // 23592
-    0x1408, 0x1407, 0x1407, 0x1406, 0x1405, 0x1405, 0x1404, 0x1403, // 23600
-    0x1403, 0x1402, 0x1402, 0x1401, 0x1400, 0x1400, 0x13ff, 0x13fe, // 23608
-    0x13fe, 0x13fd, 0x13fd, 0x13fc, 0x13fb, 0x13fb, 0x13fa, 0x13fa, // 23616
-    0x13f9, 0x13f8, 0x13f8, 0x13f7, 0x13f6, 0x13f6, 0x13f5, 0x13f5, // 23624
-    0x13f4, 0x13f3, 0x13f3, 0x13f2, 0x13f1, 0x13f1, 0x13f0, 0x13f0, // 23632
-    0x13ef, 0x13ee, 0x13ee, 0x13ed, 0x13ed, 0x13ec, 0x13eb, 0x13eb, // 23640
-    0x13ea, 0x13e9, 0x13e9, 0x13e8, 0x13e8, 0x13e7, 0x13e6, 0x13e6, // 23648
-    0x13e5, 0x13e4, 0x13e4, 0x13e3, 0x13e3, 0x13e2, 0x13e1, 0x13e1, // 23656
-    0x13e0, 0x13e0, 0x13df, 0x13de, 0x13de, 0x13dd, 0x13dc, 0x13dc, // 23664
-    0x13db, 0x13db, 0x13da, 0x13d9, 0x13d9, 0x13d8, 0x13d7, 0x13d7, // 23672
-    0x13d6, 0x13d6, 0x13d5, 0x13d4, 0x13d4, 0x13d3, 0x13d3, 0x13d2, // 23680
-    0x13d1, 0x13d1, 0x13d0, 0x13cf, 0x13cf, 0x13ce, 0x13ce, 0x13cd, // 23688
-    0x13cc, 0x13cc, 0x13cb, 0x13ca, 0x13ca, 0x13c9, 0x13c9, 0x13c8, // 23696
-    0x13c7, 0x13c7, 0x13c6, 0x13c6, 0x13c5, 0x13c4, 0x13c4, 0x13c3, // 23704
-    0x13c2, 0x13c2, 0x13c1, 0x13c1, 0x13c0, 0x13bf, 0x13bf, 0x13be, // 23712
-    0x13bd, 0x13bd, 0x13bc, 0x13bc, 0x13bb, 0x13ba, 0x13ba, 0x13b9, // 23720
-    0x13b9, 0x13b8, 0x13b7, 0x13b7, 0x13b6, 0x13b5, 0x13b5, 0x13b4, // 23728
-    0x13b4, 0x13b3, 0x13b2, 0x13b2, 0x13b1, 0x13b0, 0x13b0, 0x13af, // 23736
-    0x13af, 0x13ae, 0x13ad, 0x13ad, 0x13ac, 0x13ac, 0x13ab, 0x13aa, // 23744
-    0x13aa, 0x13a9, 0x13a8, 0x13a8, 0x13a7, 0x13a7, 0x13a6, 0x13a5, // 23752
-    0x13a5, 0x13a4, 0x13a3, 0x13a3, 0x13a2, 0x13a2, 0x13a1, 0x13a0, // 23760
-    0x13a0, 0x139f, 0x139f, 0x139e, 0x139d, 0x139d, 0x139c, 0x139b, // 23768
-    0x139b, 0x139a, 0x139a, 0x1399, 0x1398, 0x1398, 0x1397, 0x1396, // 23776
-    0x1396, 0x1395, 0x1395, 0x1394, 0x1393, 0x1393, 0x1392, 0x1392, // 23784
-    0x1391, 0x1390, 0x1390, 0x138f, 0x138e, 0x138e, 0x138d, 0x138d, // 23792
-    0x138c, 0x138b, 0x138b, 0x138a, 0x1389, 0x1389, 0x1388, 0x1388, // 23800
-    0x1387, 0x1386, 0x1386, 0x1385, 0x1385, 0x1384, 0x1383, 0x1383, // 23808
-    0x1382, 0x1381, 0x1381, 0x1380, 0x1380, 0x137f, 0x137e, 0x137e, // 23816
-    0x137d, 0x137c, 0x137c, 0x137b, 0x137b, 0x137a, 0x1379, 0x1379, // 23824
-    0x1378, 0x1378, 0x1377, 0x1376, 0x1376, 0x1375, 0x1374, 0x1374, // 23832
-    0x1373, 0x1373, 0x1372, 0x1371, 0x1371, 0x1370, 0x136f, 0x136f, // 23840
-    0x136e, 0x136e, 0x136d, 0x136c, 0x136c, 0x136b, 0x136b, 0x136a, // 23848
-    0x1369, 0x1369, 0x1368, 0x1367, 0x1367, 0x1366, 0x1366, 0x1365, // 23856
-    0x1364, 0x1364, 0x1363, 0x1362, 0x1362, 0x1361, 0x1361, 0x1360, // 23864
-    0x135f, 0x135f, 0x135e, 0x135e, 0x135d, 0x135c, 0x135c, 0x135b, // 23872
-    0x135a, 0x135a, 0x1359, 0x1359, 0x1358, 0x1357, 0x1357, 0x1356, // 23880
-    0x1355, 0x1355, 0x1354, 0x1354, 0x1353, 0x1352, 0x1352, 0x1351, // 23888
-    0x1351, 0x1350, 0x134f, 0x134f, 0x134e, 0x134d, 0x134d, 0x134c, // 23896
-    0x134c, 0x134b, 0x134a, 0x134a, 0x1349, 0x1348, 0x1348, 0x1347, // 23904
-    0x1347, 0x1346, 0x1345, 0x1345, 0x1344, 0x1344, 0x1343, 0x1342, // 23912
-    0x1342, 0x1341, 0x1340, 0x1340, 0x133f, 0x133f, 0x133e, 0x133d, // 23920
-    0x133d, 0x133c, 0x133b, 0x133b, 0x133a, 0x133a, 0x1339, 0x1338, // 23928
-    0x1338, 0x1337, 0x1337, 0x1336, 0x1335, 0x1335, 0x1334, 0x1333, // 23936
-    0x1333, 0x1332, 0x1332, 0x1331, 0x1330, 0x1330, 0x132f, 0x132e, // 23944
-    0x132e, 0x132d, 0x132d, 0x132c, 0x132b, 0x132b, 0x132a, 0x132a, // 23952
-    0x1329, 0x1328, 0x1328, 0x1327, 0x1326, 0x1326, 0x1325, 0x1325, // 23960
-    0x1324, 0x1323, 0x1323, 0x1322, 0x1321, 0x1321, 0x1320, 0x1320, // 23968
-    0x131f, 0x131e, 0x131e, 0x131d, 0x131d, 0x131c, 0x131b, 0x131b, // 23976
-    0x131a, 0x1319, 0x1319, 0x1318, 0x1318, 0x1317, 0x1316, 0x1316, // 23984
-    0x1315, 0x1314, 0x1314, 0x1313, 0x1313, 0x1312, 0x1311, 0x1311, // 23992
-    0x1310, 0x1310, 0x130f, 0x130e, 0x130e, 0x130d, 0x130c, 0x130c, // 24000
-    0x130b, 0x130b, 0x130a, 0x1309, 0x1309, 0x1308, 0x1307, 0x1307, // 24008
-    0x1306, 0x1306, 0x1305, 0x1304, 0x1304, 0x1303, 0x1303, 0x1302, // 24016
-    0x1301, 0x1301, 0x1300, 0x12ff, 0x12ff, 0x12fe, 0x12fe, 0x12fd, // 24024
-    0x12fc, 0x12fc, 0x12fb, 0x12fa, 0x12fa, 0x12f9, 0x12f9, 0x12f8, // 24032
-    0x12f7, 0x12f7, 0x12f6, 0x12f6, 0x12f5, 0x12f4, 0x12f4, 0x12f3, // 24040
-    0x12f2, 0x12f2, 0x12f1, 0x12f1, 0x12f0, 0x12ef, 0x12ef, 0x12ee, // 24048
-    0x12ed, 0x12ed, 0x12ec, 0x12ec, 0x12eb, 0x12ea, 0x12ea, 0x12e9, // 24056
-    0x12e9, 0x12e8, 0x12e7, 0x12e7, 0x12e6, 0x12e5, 0x12e5, 0x12e4, // 24064
-    0x12e4, 0x12e3, 0x12e2, 0x12e2, 0x12e1, 0x12e0, 0x12e0, 0x12df, // 24072
-    0x12df, 0x12de, 0x12dd, 0x12dd, 0x12dc, 0x12db, 0x12db, 0x12da, // 24080
-    0x12da, 0x12d9, 0x12d8, 0x12d8, 0x12d7, 0x12d7, 0x12d6, 0x12d5, // 24088
-    0x12d5, 0x12d4, 0x12d3, 0x12d3, 0x12d2, 0x12d2, 0x12d1, 0x12d0, // 24096
-    0x12d0, 0x12cf, 0x12ce, 0x12ce, 0x12cd, 0x12cd, 0x12cc, 0x12cb, // 24104
-    0x12cb, 0x12ca, 0x12ca, 0x12c9, 0x12c8, 0x12c8, 0x12c7, 0x12c6, // 24112
-    0x12c6, 0x12c5, 0x12c5, 0x12c4, 0x12c3, 0x12c3, 0x12c2, 0x12c1, // 24120
-    0x12c1, 0x12c0, 0x12c0, 0x12bf, 0x12be, 0x12be, 0x12bd, 0x12bd, // 24128
-    0x12bc, 0x12bb, 0x12bb, 0x12ba, 0x12b9, 0x12b9, 0x12b8, 0x12b8, // 24136
-    0x12b7, 0x12b6, 0x12b6, 0x12b5, 0x12b4, 0x12b4, 0x12b3, 0x12b3, // 24144
-    0x12b2, 0x12b1, 0x12b1, 0x12b0, 0x12b0, 0x12af, 0x12ae, 0x12ae, // 24152
-    0x12ad, 0x12ac, 0x12ac, 0x12ab, 0x12ab, 0x12aa, 0x12a9, 0x12a9, // 24160
-    0x12a8, 0x12a7, 0x12a7, 0x12a6, 0x12a6, 0x12a5, 0x12a4, 0x12a4, // 24168
-    0x12a3, 0x12a3, 0x12a2, 0x12a1, 0x12a1, 0x12a0, 0x129f, 0x129f, // 24176
-    0x129e, 0x129e, 0x129d, 0x129c, 0x129c, 0x129b, 0x129a, 0x129a, // 24184
-    0x1299, 0x1299, 0x1298, 0x1297, 0x1297, 0x1296, 0x1296, 0x1295, // 24192
-    0x1294, 0x1294, 0x1293, 0x1292, 0x1292, 0x1291, 0x1291, 0x1290, // 24200
-    0x128f, 0x128f, 0x128e, 0x128d, 0x128d, 0x128c, 0x128c, 0x128b, // 24208
-    0x128a, 0x128a, 0x1289, 0x1289, 0x1288, 0x1287, 0x1287, 0x1286, // 24216
-    0x1285, 0x1285, 0x1284, 0x1284, 0x1283, 0x1282, 0x1282, 0x1281, // 24224
-    0x1280, 0x1280, 0x127f, 0x127f, 0x127e, 0x127d, 0x127d, 0x127c, // 24232
-    0x127c, 0x127b, 0x127a, 0x127a, 0x1279, 0x1278, 0x1278, 0x1277, // 24240
-    0x1277, 0x1276, 0x1275, 0x1275, 0x1274, 0x1273, 0x1273, 0x1272, // 24248
-    0x1272, 0x1271, 0x1270, 0x1270, 0x126f, 0x126f, 0x126e, 0x126d, // 24256
-    0x126d, 0x126c, 0x126b, 0x126b, 0x126a, 0x126a, 0x1269, 0x1268, // 24264
-    0x1268, 0x1267, 0x1266, 0x1266, 0x1265, 0x1265, 0x1264, 0x1263, // 24272
-    0x1263, 0x1262, 0x1262, 0x1261, 0x1260, 0x1260, 0x125f, 0x125e, // 24280
-    0x125e, 0x125d, 0x125d, 0x125c, 0x125b, 0x125b, 0x125a, 0x1259, // 24288
-    0x1259, 0x1258, 0x1258, 0x1257, 0x1256, 0x1256, 0x1255, 0x1255, // 24296
-    0x1254, 0x1253, 0x1253, 0x1252, 0x1251, 0x1251, 0x1250, 0x1250, // 24304
-    0x124f, 0x124e, 0x124e, 0x124d, 0x124c, 0x124c, 0x124b, 0x124b, // 24312
-    0x124a, 0x1249, 0x1249, 0x1248, 0x1248, 0x1247, 0x1246, 0x1246, // 24320
-    0x1245, 0x1244, 0x1244, 0x1243, 0x1243, 0x1242, 0x1241, 0x1241, // 24328
-    0x1240, 0x123f, 0x123f, 0x123e, 0x123e, 0x123d, 0x123c, 0x123c, // 24336
-    0x123b, 0x123b, 0x123a, 0x1239, 0x1239, 0x1238, 0x1237, 0x1237, // 24344
-    0x1236, 0x1236, 0x1235, 0x1234, 0x1234, 0x1233, 0x1232, 0x1232, // 24352
-    0x1231, 0x1231, 0x1230, 0x122f, 0x122f, 0x122e, 0x122e, 0x122d, // 24360
-    0x122c, 0x122c, 0x122b, 0x122a, 0x122a, 0x1229, 0x1229, 0x1228, // 24368
-    0x1227, 0x1227, 0x1226, 0x1225, 0x1225, 0x1224, 0x1224, 0x1223, // 24376
-    0x1222, 0x1222, 0x1221, 0x1221, 0x1220, 0x121f, 0x121f, 0x121e, // 24384
-    0x121d, 0x121d, 0x121c, 0x121c, 0x121b, 0x121a, 0x121a, 0x1219, // 24392
-    0x1218, 0x1218, 0x1217, 0x1217, 0x1216, 0x1215, 0x1215, 0x1214, // 24400
-    0x1214, 0x1213, 0x1212, 0x1212, 0x1211, 0x1210, 0x1210, 0x120f, // 24408
-    0x120f, 0x120e, 0x120d, 0x120d, 0x120c, 0x120b, 0x120b, 0x120a, // 24416
-    0x120a, 0x1209, 0x1208, 0x1208, 0x1207, 0x1207, 0x1206, 0x1205, // 24424
-    0x1205, 0x1204, 0x1203, 0x1203, 0x1202, 0x1202, 0x1201, 0x1200, // 24432
-    0x1200, 0x11ff, 0x11fe, 0x11fe, 0x11fd, 0x11fd, 0x11fc, 0x11fb, // 24440
-    0x11fb, 0x11fa, 0x11fa, 0x11f9, 0x11f8, 0x11f8, 0x11f7, 0x11f6, // 24448
-    0x11f6, 0x11f5, 0x11f5, 0x11f4, 0x11f3, 0x11f3, 0x11f2, 0x11f1, // 24456
-    0x11f1, 0x11f0, 0x11f0, 0x11ef, 0x11ee, 0x11ee, 0x11ed, 0x11ed, // 24464
-    0x11ec, 0x11eb, 0x11eb, 0x11ea, 0x11e9, 0x11e9, 0x11e8, 0x11e8, // 24472
-    0x11e7, 0x11e6, 0x11e6, 0x11e5, 0x11e4, 0x11e4, 0x11e3, 0x11e3, // 24480
-    0x11e2, 0x11e1, 0x11e1, 0x11e0, 0x11e0, 0x11df, 0x11de, 0x11de, // 24488
-    0x11dd, 0x11dc, 0x11dc, 0x11db, 0x11db, 0x11da, 0x11d9, 0x11d9, // 24496
-    0x11d8, 0x11d7, 0x11d7, 0x11d6, 0x11d6, 0x11d5, 0x11d4, 0x11d4, // 24504
-    0x11d3, 0x11d3, 0x11d2, 0x11d1, 0x11d1, 0x11d0, 0x11cf, 0x11cf, // 24512
-    0x11ce, 0x11ce, 0x11cd, 0x11cc, 0x11cc, 0x11cb, 0x11ca, 0x11ca, // 24520
-    0x11c9, 0x11c9, 0x11c8, 0x11c7, 0x11c7, 0x11c6, 0x11c6, 0x11c5, // 24528
-    0x11c4, 0x11c4, 0x11c3, 0x11c2, 0x11c2, 0x11c1, 0x11c1, 0x11c0, // 24536
-    0x11bf, 0x11bf, 0x11be, 0x11bd, 0x11bd, 0x11bc, 0x11bc, 0x11bb, // 24544
-    0x11ba, 0x11ba, 0x11b9, 0x11b9, 0x11b8, 0x11b7, 0x11b7, 0x11b6, // 24552
-    0x11b5, 0x11b5, 0x11b4, 0x11b4, 0x11b3, 0x11b2, 0x11b2, 0x11b1, // 24560
-    0x11b0, 0x11b0, 0x11af, 0x11af, 0x11ae, 0x11ad, 0x11ad, 0x11ac, // 24568
-    0x11ac, 0x11ab, 0x11ab, 0x11aa, 0x11aa, 0x11a9, 0x11a8, 0x11a8, // 24576
-    0x11a7, 0x11a7, 0x11a6, 0x11a5, 0x11a5, 0x11a4, 0x11a4, 0x11a3, // 24584
-    0x11a2, 0x11a2, 0x11a1, 0x11a1, 0x11a0, 0x119f, 0x119f, 0x119e, // 24592
-    0x119e, 0x119d, 0x119c, 0x119c, 0x119b, 0x119a, 0x119a, 0x1199, // 24600
-    0x1199, 0x1198, 0x1197, 0x1197, 0x1196, 0x1196, 0x1195, 0x1194, // 24608
-    0x1194, 0x1193, 0x1193, 0x1192, 0x1191, 0x1191, 0x1190, 0x1190, // 24616
-    0x118f, 0x118e, 0x118e, 0x118d, 0x118d, 0x118c, 0x118b, 0x118b, // 24624
-    0x118a, 0x118a, 0x1189, 0x1188, 0x1188, 0x1187, 0x1187, 0x1186, // 24632
-    0x1185, 0x1185, 0x1184, 0x1184, 0x1183, 0x1182, 0x1182, 0x1181, // 24640
-    0x1181, 0x1180, 0x117f, 0x117f, 0x117e, 0x117e, 0x117d, 0x117c, // 24648
-    0x117c, 0x117b, 0x117b, 0x117a, 0x1179, 0x1179, 0x1178, 0x1177, // 24656
-    0x1177, 0x1176, 0x1176, 0x1175, 0x1174, 0x1174, 0x1173, 0x1173, // 24664
-    0x1172, 0x1171, 0x1171, 0x1170, 0x1170, 0x116f, 0x116e, 0x116e, // 24672
-    0x116d, 0x116d, 0x116c, 0x116b, 0x116b, 0x116a, 0x116a, 0x1169, // 24680
-    0x1168, 0x1168, 0x1167, 0x1167, 0x1166, 0x1165, 0x1165, 0x1164, // 24688
-    0x1164, 0x1163, 0x1162, 0x1162, 0x1161, 0x1161, 0x1160, 0x115f, // 24696
-    0x115f, 0x115e, 0x115e, 0x115d, 0x115c, 0x115c, 0x115b, 0x115b, // 24704
-    0x115a, 0x1159, 0x1159, 0x1158, 0x1158, 0x1157, 0x1156, 0x1156, // 24712
-    0x1155, 0x1154, 0x1154, 0x1153, 0x1153, 0x1152, 0x1151, 0x1151, // 24720
-    0x1150, 0x1150, 0x114f, 0x114e, 0x114e, 0x114d, 0x114d, 0x114c, // 24728
-    0x114b, 0x114b, 0x114a, 0x114a, 0x1149, 0x1148, 0x1148, 0x1147, // 24736
-    0x1147, 0x1146, 0x1145, 0x1145, 0x1144, 0x1144, 0x1143, 0x1142, // 24744
-    0x1142, 0x1141, 0x1141, 0x1140, 0x113f, 0x113f, 0x113e, 0x113e, // 24752
-    0x113d, 0x113c, 0x113c, 0x113b, 0x113b, 0x113a, 0x1139, 0x1139, // 24760
-    0x1138, 0x1138, 0x1137, 0x1136, 0x1136, 0x1135, 0x1135, 0x1134, // 24768
-    0x1133, 0x1133, 0x1132, 0x1131, 0x1131, 0x1130, 0x1130, 0x112f, // 24776
-    0x112e, 0x112e, 0x112d, 0x112d, 0x112c, 0x112b, 0x112b, 0x112a, // 24784
-    0x112a, 0x1129, 0x1128, 0x1128, 0x1127, 0x1127, 0x1126, 0x1125, // 24792
-    0x1125, 0x1124, 0x1124, 0x1123, 0x1122, 0x1122, 0x1121, 0x1121, // 24800
-    0x1120, 0x111f, 0x111f, 0x111e, 0x111e, 0x111d, 0x111c, 0x111c, // 24808
-    0x111b, 0x111b, 0x111a, 0x1119, 0x1119, 0x1118, 0x1118, 0x1117, // 24816
-    0x1116, 0x1116, 0x1115, 0x1115, 0x1114, 0x1113, 0x1113, 0x1112, // 24824
-    0x1112, 0x1111, 0x1110, 0x1110, 0x110f, 0x110e, 0x110e, 0x110d, // 24832
-    0x110d, 0x110c, 0x110b, 0x110b, 0x110a, 0x110a, 0x1109, 0x1108, // 24840
-    0x1108, 0x1107, 0x1107, 0x1106, 0x1105, 0x1105, 0x1104, 0x1104, // 24848
-    0x1103, 0x1102, 0x1102, 0x1101, 0x1101, 0x1100, 0x10ff, 0x10ff, // 24856
-    0x10fe, 0x10fe, 0x10fd, 0x10fc, 0x10fc, 0x10fb, 0x10fb, 0x10fa, // 24864
-    0x10f9, 0x10f9, 0x10f8, 0x10f8, 0x10f7, 0x10f6, 0x10f6, 0x10f5, // 24872
-    0x10f5, 0x10f4, 0x10f3, 0x10f3, 0x10f2, 0x10f2, 0x10f1, 0x10f0, // 24880
-    0x10f0, 0x10ef, 0x10ee, 0x10ee, 0x10ed, 0x10ed, 0x10ec, 0x10eb, // 24888
-    0x10eb, 0x10ea, 0x10ea, 0x10e9, 0x10e8, 0x10e8, 0x10e7, 0x10e7, // 24896
-    0x10e6, 0x10e5, 0x10e5, 0x10e4, 0x10e4, 0x10e3, 0x10e2, 0x10e2, // 24904
-    0x10e1, 0x10e1, 0x10e0, 0x10df, 0x10df, 0x10de, 0x10de, 0x10dd, // 24912
-    0x10dc, 0x10dc, 0x10db, 0x10db, 0x10da, 0x10d9, 0x10d9, 0x10d8, // 24920
-    0x10d8, 0x10d7, 0x10d6, 0x10d6, 0x10d5, 0x10d5, 0x10d4, 0x10d3, // 24928
-    0x10d3, 0x10d2, 0x10d2, 0x10d1, 0x10d0, 0x10d0, 0x10cf, 0x10cf, // 24936
-    0x10ce, 0x10cd, 0x10cd, 0x10cc, 0x10cb, 0x10cb, 0x10ca, 0x10ca, // 24944
-    0x10c9, 0x10c8, 0x10c8, 0x10c7, 0x10c7, 0x10c6, 0x10c5, 0x10c5, // 24952
-    0x10c4, 0x10c4, 0x10c3, 0x10c2, 0x10c2, 0x10c1, 0x10c1, 0x10c0, // 24960
-    0x10bf, 0x10bf, 0x10be, 0x10be, 0x10bd, 0x10bc, 0x10bc, 0x10bb, // 24968
-    0x10bb, 0x10ba, 0x10b9, 0x10b9, 0x10b8, 0x10b8, 0x10b7, 0x10b6, // 24976
-    0x10b6, 0x10b5, 0x10b5, 0x10b4, 0x10b3, 0x10b3, 0x10b2, 0x10b2, // 24984
-    0x10b1, 0x10b0, 0x10b0, 0x10af, 0x10af, 0x10ae, 0x10ad, 0x10ad, // 24992
-    0x10ac, 0x10ac, 0x10ab, 0x10aa, 0x10aa, 0x10a9, 0x10a8, 0x10a8, // 25000
-    0x10a7, 0x10a7, 0x10a6, 0x10a5, 0x10a5, 0x10a4, 0x10a4, 0x10a3, // 25008
-    0x10a2, 0x10a2, 0x10a1, 0x10a1, 0x10a0, 0x109f, 0x109f, 0x109e, // 25016
-    0x109e, 0x109d, 0x109c, 0x109c, 0x109b, 0x109b, 0x109a, 0x1099, // 25024
-    0x1099, 0x1098, 0x1098, 0x1097, 0x1096, 0x1096, 0x1095, 0x1095, // 25032
-    0x1094, 0x1093, 0x1093, 0x1092, 0x1092, 0x1091, 0x1090, 0x1090, // 25040
-    0x108f, 0x108f, 0x108e, 0x108d, 0x108d, 0x108c, 0x108c, 0x108b, // 25048
-    0x108a, 0x108a, 0x1089, 0x1089, 0x1088, 0x1087, 0x1087, 0x1086, // 25056
-    0x1085, 0x1085, 0x1084, 0x1084, 0x1083, 0x1082, 0x1082, 0x1081, // 25064
-    0x1081, 0x1080, 0x107f, 0x107f, 0x107e, 0x107e, 0x107d, 0x107c, // 25072
-    0x107c, 0x107b, 0x107b, 0x107a, 0x1079, 0x1079, 0x1078, 0x1078, // 25080
-    0x1077, 0x1076, 0x1076, 0x1075, 0x1075, 0x1074, 0x1073, 0x1073, // 25088
-    0x1072, 0x1072, 0x1071, 0x1070, 0x1070, 0x106f, 0x106f, 0x106e, // 25096
-    0x106d, 0x106d, 0x106c, 0x106c, 0x106b, 0x106a, 0x106a, 0x1069, // 25104
-    0x1069, 0x1068, 0x1067, 0x1067, 0x1066, 0x1065, 0x1065, 0x1064, // 25112
-    0x1064, 0x1063, 0x1062, 0x1062, 0x1061, 0x1061, 0x1060, 0x105f, // 25120
-    0x105f, 0x105e, 0x105e, 0x105d, 0x105c, 0x105c, 0x105b, 0x105b, // 25128
-    0x105a, 0x1059, 0x1059, 0x1058, 0x1058, 0x1057, 0x1056, 0x1056, // 25136
-    0x1055, 0x1055, 0x1054, 0x1053, 0x1053, 0x1052, 0x1052, 0x1051, // 25144
-    0x1050, 0x1050, 0x104f, 0x104f, 0x104e, 0x104d, 0x104d, 0x104c, // 25152
-    0x104c, 0x104b, 0x104a, 0x104a, 0x1049, 0x1049, 0x1048, 0x1047, // 25160
-    0x1047, 0x1046, 0x1046, 0x1045, 0x1044, 0x1044, 0x1043, 0x1042, // 25168
-    0x1042, 0x1041, 0x1041, 0x1040, 0x103f, 0x103f, 0x103e, 0x103e, // 25176
-    0x103d, 0x103c, 0x103c, 0x103b, 0x103b, 0x103a, 0x1039, 0x1039, // 25184
-    0x1038, 0x1038, 0x1037, 0x1036, 0x1036, 0x1035, 0x1035, 0x1034, // 25192
-    0x1033, 0x1033, 0x1032, 0x1032, 0x1031, 0x1030, 0x1030, 0x102f, // 25200
-    0x102f, 0x102e, 0x102d, 0x102d, 0x102c, 0x102c, 0x102b, 0x102a, // 25208
-    0x102a, 0x1029, 0x1029, 0x1028, 0x1027, 0x1027, 0x1026, 0x1026, // 25216
-    0x1025, 0x1024, 0x1024, 0x1023, 0x1023, 0x1022, 0x1021, 0x1021, // 25224
-    0x1020, 0x101f, 0x101f, 0x101e, 0x101e, 0x101d, 0x101c, 0x101c, // 25232
-    0x101b, 0x101b, 0x101a, 0x1019, 0x1019, 0x1018, 0x1018, 0x1017, // 25240
-    0x1016, 0x1016, 0x1015, 0x1015, 0x1014, 0x1013, 0x1013, 0x1012, // 25248
-    0x1012, 0x1011, 0x1010, 0x1010, 0x100f, 0x100f, 0x100e, 0x100d, // 25256
-    0x100d, 0x100c, 0x100c, 0x100b, 0x100a, 0x100a, 0x1009, 0x1009, // 25264
-    0x1008, 0x1007, 0x1007, 0x1006, 0x1006, 0x1005, 0x1004, 0x1004, // 25272
-    0x1003, 0x1003, 0x1002, 0x1001, 0x1001, 0x1000, 0x1000, 0x0fff, // 25280
-    0x0ffe, 0x0ffe, 0x0ffd, 0x0ffc, 0x0ffc, 0x0ffb, 0x0ffb, 0x0ffa, // 25288
-    0x0ff9, 0x0ff9, 0x0ff8, 0x0ff8, 0x0ff7, 0x0ff6, 0x0ff6, 0x0ff5, // 25296
-    0x0ff5, 0x0ff4, 0x0ff3, 0x0ff3, 0x0ff2, 0x0ff2, 0x0ff1, 0x0ff0, // 25304
-    0x0ff0, 0x0fef, 0x0fef, 0x0fee, 0x0fed, 0x0fed, 0x0fec, 0x0fec, // 25312
-    0x0feb, 0x0fea, 0x0fea, 0x0fe9, 0x0fe9, 0x0fe8, 0x0fe7, 0x0fe7, // 25320
-    0x0fe6, 0x0fe6, 0x0fe5, 0x0fe4, 0x0fe4, 0x0fe3, 0x0fe3, 0x0fe2, // 25328
-    0x0fe1, 0x0fe1, 0x0fe0, 0x0fe0, 0x0fdf, 0x0fde, 0x0fde, 0x0fdd, // 25336
-    0x0fdd, 0x0fdc, 0x0fdb, 0x0fdb, 0x0fda, 0x0fd9, 0x0fd9, 0x0fd8, // 25344
-    0x0fd8, 0x0fd7, 0x0fd6, 0x0fd6, 0x0fd5, 0x0fd5, 0x0fd4, 0x0fd3, // 25352
-    0x0fd3, 0x0fd2, 0x0fd2, 0x0fd1, 0x0fd0, 0x0fd0, 0x0fcf, 0x0fcf, // 25360
-    0x0fce, 0x0fcd, 0x0fcd, 0x0fcc, 0x0fcc, 0x0fcb, 0x0fca, 0x0fca, // 25368
-    0x0fc9, 0x0fc9, 0x0fc8, 0x0fc7, 0x0fc7, 0x0fc6, 0x0fc6, 0x0fc5, // 25376
-    0x0fc4, 0x0fc4, 0x0fc3, 0x0fc3, 0x0fc2, 0x0fc1, 0x0fc1, 0x0fc0, // 25384
-    0x0fc0, 0x0fbf, 0x0fbe, 0x0fbe, 0x0fbd, 0x0fbd, 0x0fbc, 0x0fbb, // 25392
-    0x0fbb, 0x0fba, 0x0fb9, 0x0fb9, 0x0fb8, 0x0fb8, 0x0fb7, 0x0fb6, // 25400
-    0x0fb6, 0x0fb5, 0x0fb5, 0x0fb4, 0x0fb3, 0x0fb3, 0x0fb2, 0x0fb2, // 25408
-    0x0fb1, 0x0fb0, 0x0fb0, 0x0faf, 0x0faf, 0x0fae, 0x0fad, 0x0fad, // 25416
-    0x0fac, 0x0fac, 0x0fab, 0x0faa, 0x0faa, 0x0fa9, 0x0fa9, 0x0fa8, // 25424
-    0x0fa7, 0x0fa7, 0x0fa6, 0x0fa6, 0x0fa5, 0x0fa4, 0x0fa4, 0x0fa3, // 25432
-    0x0fa3, 0x0fa2, 0x0fa1, 0x0fa1, 0x0fa0, 0x0fa0, 0x0f9f, 0x0f9e, // 25440
-    0x0f9e, 0x0f9d, 0x0f9d, 0x0f9c, 0x0f9b, 0x0f9b, 0x0f9a, 0x0f9a, // 25448
-    0x0f99, 0x0f98, 0x0f98, 0x0f97, 0x0f96, 0x0f96, 0x0f95, 0x0f95, // 25456
-    0x0f94, 0x0f93, 0x0f93, 0x0f92, 0x0f92, 0x0f91, 0x0f90, 0x0f90, // 25464
-    0x0f8f, 0x0f8f, 0x0f8e, 0x0f8d, 0x0f8d, 0x0f8c, 0x0f8c, 0x0f8b, // 25472
-    0x0f8a, 0x0f8a, 0x0f89, 0x0f89, 0x0f88, 0x0f87, 0x0f87, 0x0f86, // 25480
-    0x0f86, 0x0f85, 0x0f84, 0x0f84, 0x0f83, 0x0f83, 0x0f82, 0x0f81, // 25488
-    0x0f81, 0x0f80, 0x0f80, 0x0f7f, 0x0f7e, 0x0f7e, 0x0f7d, 0x0f7d, // 25496
-    0x0f7c, 0x0f7b, 0x0f7b, 0x0f7a, 0x0f7a, 0x0f79, 0x0f78, 0x0f78, // 25504
-    0x0f77, 0x0f77, 0x0f76, 0x0f75, 0x0f75, 0x0f74, 0x0f73, 0x0f73, // 25512
-    0x0f72, 0x0f72, 0x0f71, 0x0f70, 0x0f70, 0x0f6f, 0x0f6f, 0x0f6e, // 25520
-    0x0f6d, 0x0f6d, 0x0f6c, 0x0f6c, 0x0f6b, 0x0f6a, 0x0f6a, 0x0f69, // 25528
-    0x0f69, 0x0f68, 0x0f67, 0x0f67, 0x0f66, 0x0f66, 0x0f65, 0x0f64, // 25536
-    0x0f64, 0x0f63, 0x0f63, 0x0f62, 0x0f61, 0x0f61, 0x0f60, 0x0f60, // 25544
-    0x0f5f, 0x0f5e, 0x0f5e, 0x0f5d, 0x0f5d, 0x0f5c, 0x0f5b, 0x0f5b, // 25552
-    0x0f5a, 0x0f5a, 0x0f59, 0x0f58, 0x0f58, 0x0f57, 0x0f57, 0x0f56, // 25560
-    0x0f55, 0x0f55, 0x0f54, 0x0f54, 0x0f53, 0x0f52, 0x0f52, 0x0f51, // 25568
-    0x0f50, 0x0f50, 0x0f4f, 0x0f4f, 0x0f4e, 0x0f4d, 0x0f4d, 0x0f4c, // 25576
-    0x0f4c, 0x0f4b, 0x0f4a, 0x0f4a, 0x0f49, 0x0f49, 0x0f48, 0x0f47, // 25584
-    0x0f47, 0x0f46, 0x0f46, 0x0f45, 0x0f44, 0x0f44, 0x0f43, 0x0f43, // 25592
-    0x0f43, 0x0f42, 0x0f42, 0x0f41, 0x0f40, 0x0f40, 0x0f3f, 0x0f3f, // 25600
-    0x0f3e, 0x0f3d, 0x0f3d, 0x0f3c, 0x0f3c, 0x0f3b, 0x0f3b, 0x0f3a, // 25608
-    0x0f39, 0x0f39, 0x0f38, 0x0f38, 0x0f37, 0x0f36, 0x0f36, 0x0f35, // 25616
-    0x0f35, 0x0f34, 0x0f33, 0x0f33, 0x0f32, 0x0f32, 0x0f31, 0x0f31, // 25624
-    0x0f30, 0x0f2f, 0x0f2f, 0x0f2e, 0x0f2e, 0x0f2d, 0x0f2c, 0x0f2c, // 25632
-    0x0f2b, 0x0f2b, 0x0f2a, 0x0f29, 0x0f29, 0x0f28, 0x0f28, 0x0f27, // 25640
-    0x0f27, 0x0f26, 0x0f25, 0x0f25, 0x0f24, 0x0f24, 0x0f23, 0x0f22, // 25648
-    0x0f22, 0x0f21, 0x0f21, 0x0f20, 0x0f1f, 0x0f1f, 0x0f1e, 0x0f1e, // 25656
-    0x0f1d, 0x0f1d, 0x0f1c, 0x0f1b, 0x0f1b, 0x0f1a, 0x0f1a, 0x0f19, // 25664
-    0x0f18, 0x0f18, 0x0f17, 0x0f17, 0x0f16, 0x0f15, 0x0f15, 0x0f14, // 25672
-    0x0f14, 0x0f13, 0x0f13, 0x0f12, 0x0f11, 0x0f11, 0x0f10, 0x0f10, // 25680
-    0x0f0f, 0x0f0e, 0x0f0e, 0x0f0d, 0x0f0d, 0x0f0c, 0x0f0b, 0x0f0b, // 25688
-    0x0f0a, 0x0f0a, 0x0f09, 0x0f09, 0x0f08, 0x0f07, 0x0f07, 0x0f06, // 25696
-    0x0f06, 0x0f05, 0x0f04, 0x0f04, 0x0f03, 0x0f03, 0x0f02, 0x0f01, // 25704
-    0x0f01, 0x0f00, 0x0f00, 0x0eff, 0x0eff, 0x0efe, 0x0efd, 0x0efd, // 25712
-    0x0efc, 0x0efc, 0x0efb, 0x0efa, 0x0efa, 0x0ef9, 0x0ef9, 0x0ef8, // 25720
-    0x0ef8, 0x0ef7, 0x0ef6, 0x0ef6, 0x0ef5, 0x0ef5, 0x0ef4, 0x0ef3, // 25728
-    0x0ef3, 0x0ef2, 0x0ef2, 0x0ef1, 0x0ef0, 0x0ef0, 0x0eef, 0x0eef, // 25736
-    0x0eee, 0x0eee, 0x0eed, 0x0eec, 0x0eec, 0x0eeb, 0x0eeb, 0x0eea, // 25744
-    0x0ee9, 0x0ee9, 0x0ee8, 0x0ee8, 0x0ee7, 0x0ee6, 0x0ee6, 0x0ee5, // 25752
-    0x0ee5, 0x0ee4, 0x0ee4, 0x0ee3, 0x0ee2, 0x0ee2, 0x0ee1, 0x0ee1, // 25760
-    0x0ee0, 0x0edf, 0x0edf, 0x0ede, 0x0ede, 0x0edd, 0x0edc, 0x0edc, // 25768
-    0x0edb, 0x0edb, 0x0eda, 0x0eda, 0x0ed9, 0x0ed8, 0x0ed8, 0x0ed7, // 25776
-    0x0ed7, 0x0ed6, 0x0ed5, 0x0ed5, 0x0ed4, 0x0ed4, 0x0ed3, 0x0ed2, // 25784
-    0x0ed2, 0x0ed1, 0x0ed1, 0x0ed0, 0x0ed0, 0x0ecf, 0x0ece, 0x0ece, // 25792
-    0x0ecd, 0x0ecd, 0x0ecc, 0x0ecb, 0x0ecb, 0x0eca, 0x0eca, 0x0ec9, // 25800
-    0x0ec8, 0x0ec8, 0x0ec7, 0x0ec7, 0x0ec6, 0x0ec6, 0x0ec5, 0x0ec4, // 25808
-    0x0ec4, 0x0ec3, 0x0ec3, 0x0ec2, 0x0ec1, 0x0ec1, 0x0ec0, 0x0ec0, // 25816
-    0x0ebf, 0x0ebe, 0x0ebe, 0x0ebd, 0x0ebd, 0x0ebc, 0x0ebc, 0x0ebb, // 25824
-    0x0eba, 0x0eba, 0x0eb9, 0x0eb9, 0x0eb8, 0x0eb7, 0x0eb7, 0x0eb6, // 25832
-    0x0eb6, 0x0eb5, 0x0eb4, 0x0eb4, 0x0eb3, 0x0eb3, 0x0eb2, 0x0eb2, // 25840
-    0x0eb1, 0x0eb0, 0x0eb0, 0x0eaf, 0x0eaf, 0x0eae, 0x0ead, 0x0ead, // 25848
-    0x0eac, 0x0eac, 0x0eab, 0x0eaa, 0x0eaa, 0x0ea9, 0x0ea9, 0x0ea8, // 25856
-    0x0ea8, 0x0ea7, 0x0ea6, 0x0ea6, 0x0ea5, 0x0ea5, 0x0ea4, 0x0ea3, // 25864
-    0x0ea3, 0x0ea2, 0x0ea2, 0x0ea1, 0x0ea0, 0x0ea0, 0x0e9f, 0x0e9f, // 25872
-    0x0e9e, 0x0e9e, 0x0e9d, 0x0e9c, 0x0e9c, 0x0e9b, 0x0e9b, 0x0e9a, // 25880
-    0x0e99, 0x0e99, 0x0e98, 0x0e98, 0x0e97, 0x0e96, 0x0e96, 0x0e95, // 25888
-    0x0e95, 0x0e94, 0x0e94, 0x0e93, 0x0e92, 0x0e92, 0x0e91, 0x0e91, // 25896
-    0x0e90, 0x0e8f, 0x0e8f, 0x0e8e, 0x0e8e, 0x0e8d, 0x0e8d, 0x0e8c, // 25904
-    0x0e8b, 0x0e8b, 0x0e8a, 0x0e8a, 0x0e89, 0x0e88, 0x0e88, 0x0e87, // 25912
-    0x0e87, 0x0e86, 0x0e85, 0x0e85, 0x0e84, 0x0e84, 0x0e83, 0x0e83, // 25920
-    0x0e82, 0x0e81, 0x0e81, 0x0e80, 0x0e80, 0x0e7f, 0x0e7e, 0x0e7e, // 25928
-    0x0e7d, 0x0e7d, 0x0e7c, 0x0e7b, 0x0e7b, 0x0e7a, 0x0e7a, 0x0e79, // 25936
-    0x0e79, 0x0e78, 0x0e77, 0x0e77, 0x0e76, 0x0e76, 0x0e75, 0x0e74, // 25944
-    0x0e74, 0x0e73, 0x0e73, 0x0e72, 0x0e71, 0x0e71, 0x0e70, 0x0e70, // 25952
-    0x0e6f, 0x0e6f, 0x0e6e, 0x0e6d, 0x0e6d, 0x0e6c, 0x0e6c, 0x0e6b, // 25960
-    0x0e6a, 0x0e6a, 0x0e69, 0x0e69, 0x0e68, 0x0e67, 0x0e67, 0x0e66, // 25968
-    0x0e66, 0x0e65, 0x0e65, 0x0e64, 0x0e63, 0x0e63, 0x0e62, 0x0e62, // 25976
-    0x0e61, 0x0e60, 0x0e60, 0x0e5f, 0x0e5f, 0x0e5e, 0x0e5d, 0x0e5d, // 25984
-    0x0e5c, 0x0e5c, 0x0e5b, 0x0e5b, 0x0e5a, 0x0e59, 0x0e59, 0x0e58, // 25992
-    0x0e58, 0x0e57, 0x0e56, 0x0e56, 0x0e55, 0x0e55, 0x0e54, 0x0e53, // 26000
-    0x0e53, 0x0e52, 0x0e52, 0x0e51, 0x0e51, 0x0e50, 0x0e4f, 0x0e4f, // 26008
-    0x0e4e, 0x0e4e, 0x0e4d, 0x0e4c, 0x0e4c, 0x0e4b, 0x0e4b, 0x0e4a, // 26016
-    0x0e49, 0x0e49, 0x0e48, 0x0e48, 0x0e47, 0x0e47, 0x0e46, 0x0e45, // 26024
-    0x0e45, 0x0e44, 0x0e44, 0x0e43, 0x0e42, 0x0e42, 0x0e41, 0x0e41, // 26032
-    0x0e40, 0x0e3f, 0x0e3f, 0x0e3e, 0x0e3e, 0x0e3d, 0x0e3d, 0x0e3c, // 26040
-    0x0e3b, 0x0e3b, 0x0e3a, 0x0e3a, 0x0e39, 0x0e38, 0x0e38, 0x0e37, // 26048
-    0x0e37, 0x0e36, 0x0e35, 0x0e35, 0x0e34, 0x0e34, 0x0e33, 0x0e33, // 26056
-    0x0e32, 0x0e31, 0x0e31, 0x0e30, 0x0e30, 0x0e2f, 0x0e2e, 0x0e2e, // 26064
-    0x0e2d, 0x0e2d, 0x0e2c, 0x0e2c, 0x0e2b, 0x0e2a, 0x0e2a, 0x0e29, // 26072
-    0x0e29, 0x0e28, 0x0e27, 0x0e27, 0x0e26, 0x0e26, 0x0e25, 0x0e24, // 26080
-    0x0e24, 0x0e23, 0x0e23, 0x0e22, 0x0e22, 0x0e21, 0x0e20, 0x0e20, // 26088
-    0x0e1f, 0x0e1f, 0x0e1e, 0x0e1d, 0x0e1d, 0x0e1c, 0x0e1c, 0x0e1b, // 26096
-    0x0e1a, 0x0e1a, 0x0e19, 0x0e19, 0x0e18, 0x0e18, 0x0e17, 0x0e16, // 26104
-    0x0e16, 0x0e15, 0x0e15, 0x0e14, 0x0e13, 0x0e13, 0x0e12, 0x0e12, // 26112
-    0x0e11, 0x0e10, 0x0e10, 0x0e0f, 0x0e0f, 0x0e0e, 0x0e0e, 0x0e0d, // 26120
-    0x0e0c, 0x0e0c, 0x0e0b, 0x0e0b, 0x0e0a, 0x0e09, 0x0e09, 0x0e08, // 26128
-    0x0e08, 0x0e07, 0x0e06, 0x0e06, 0x0e05, 0x0e05, 0x0e04, 0x0e04, // 26136
-    0x0e03, 0x0e02, 0x0e02, 0x0e01, 0x0e01, 0x0e00, 0x0dff, 0x0dff, // 26144
-    0x0dfe, 0x0dfe, 0x0dfd, 0x0dfc, 0x0dfc, 0x0dfb, 0x0dfb, 0x0dfa, // 26152
-    0x0dfa, 0x0df9, 0x0df8, 0x0df8, 0x0df7, 0x0df7, 0x0df6, 0x0df5, // 26160
-    0x0df5, 0x0df4, 0x0df4, 0x0df3, 0x0df2, 0x0df2, 0x0df1, 0x0df1, // 26168
-    0x0df0, 0x0df0, 0x0def, 0x0dee, 0x0dee, 0x0ded, 0x0ded, 0x0dec, // 26176
-    0x0deb, 0x0deb, 0x0dea, 0x0dea, 0x0de9, 0x0de8, 0x0de8, 0x0de7, // 26184
-    0x0de7, 0x0de6, 0x0de6, 0x0de5, 0x0de4, 0x0de4, 0x0de3, 0x0de3, // 26192
-    0x0de2, 0x0de1, 0x0de1, 0x0de0, 0x0de0, 0x0ddf, 0x0dde, 0x0dde, // 26200
-    0x0ddd, 0x0ddd, 0x0ddc, 0x0ddc, 0x0ddb, 0x0dda, 0x0dda, 0x0dd9, // 26208
-    0x0dd9, 0x0dd8, 0x0dd7, 0x0dd7, 0x0dd6, 0x0dd6, 0x0dd5, 0x0dd4, // 26216
-    0x0dd4, 0x0dd3, 0x0dd3, 0x0dd2, 0x0dd2, 0x0dd1, 0x0dd0, 0x0dd0, // 26224
-    0x0dcf, 0x0dcf, 0x0dce, 0x0dcd, 0x0dcd, 0x0dcc, 0x0dcc, 0x0dcb, // 26232
-    0x0dcb, 0x0dca, 0x0dc9, 0x0dc9, 0x0dc8, 0x0dc8, 0x0dc7, 0x0dc6, // 26240
-    0x0dc6, 0x0dc5, 0x0dc5, 0x0dc4, 0x0dc3, 0x0dc3, 0x0dc2, 0x0dc2, // 26248
-    0x0dc1, 0x0dc1, 0x0dc0, 0x0dbf, 0x0dbf, 0x0dbe, 0x0dbe, 0x0dbd, // 26256
-    0x0dbc, 0x0dbc, 0x0dbb, 0x0dbb, 0x0dba, 0x0db9, 0x0db9, 0x0db8, // 26264
-    0x0db8, 0x0db7, 0x0db7, 0x0db6, 0x0db5, 0x0db5, 0x0db4, 0x0db4, // 26272
-    0x0db3, 0x0db2, 0x0db2, 0x0db1, 0x0db1, 0x0db0, 0x0daf, 0x0daf, // 26280
-    0x0dae, 0x0dae, 0x0dad, 0x0dad, 0x0dac, 0x0dab, 0x0dab, 0x0daa, // 26288
-    0x0daa, 0x0da9, 0x0da8, 0x0da8, 0x0da7, 0x0da7, 0x0da6, 0x0da5, // 26296
-    0x0da5, 0x0da4, 0x0da4, 0x0da3, 0x0da3, 0x0da2, 0x0da1, 0x0da1, // 26304
-    0x0da0, 0x0da0, 0x0d9f, 0x0d9e, 0x0d9e, 0x0d9d, 0x0d9d, 0x0d9c, // 26312
-    0x0d9b, 0x0d9b, 0x0d9a, 0x0d9a, 0x0d99, 0x0d99, 0x0d98, 0x0d97, // 26320
-    0x0d97, 0x0d96, 0x0d96, 0x0d95, 0x0d94, 0x0d94, 0x0d93, 0x0d93, // 26328
-    0x0d92, 0x0d91, 0x0d91, 0x0d90, 0x0d90, 0x0d8f, 0x0d8f, 0x0d8e, // 26336
-    0x0d8d, 0x0d8d, 0x0d8c, 0x0d8c, 0x0d8b, 0x0d8a, 0x0d8a, 0x0d89, // 26344
-    0x0d89, 0x0d88, 0x0d87, 0x0d87, 0x0d86, 0x0d86, 0x0d85, 0x0d85, // 26352
-    0x0d84, 0x0d83, 0x0d83, 0x0d82, 0x0d82, 0x0d81, 0x0d80, 0x0d80, // 26360
-    0x0d7f, 0x0d7f, 0x0d7e, 0x0d7d, 0x0d7d, 0x0d7c, 0x0d7c, 0x0d7b, // 26368
-    0x0d7b, 0x0d7a, 0x0d79, 0x0d79, 0x0d78, 0x0d78, 0x0d77, 0x0d76, // 26376
-    0x0d76, 0x0d75, 0x0d75, 0x0d74, 0x0d73, 0x0d73, 0x0d72, 0x0d72, // 26384
-    0x0d71, 0x0d71, 0x0d70, 0x0d6f, 0x0d6f, 0x0d6e, 0x0d6e, 0x0d6d, // 26392
-    0x0d6c, 0x0d6c, 0x0d6b, 0x0d6b, 0x0d6a, 0x0d69, 0x0d69, 0x0d68, // 26400
-    0x0d68, 0x0d67, 0x0d67, 0x0d66, 0x0d65, 0x0d65, 0x0d64, 0x0d64, // 26408
-    0x0d63, 0x0d62, 0x0d62, 0x0d61, 0x0d61, 0x0d60, 0x0d60, 0x0d5f, // 26416
-    0x0d5e, 0x0d5e, 0x0d5d, 0x0d5d, 0x0d5c, 0x0d5b, 0x0d5b, 0x0d5a, // 26424
-    0x0d5a, 0x0d59, 0x0d58, 0x0d58, 0x0d57, 0x0d57, 0x0d56, 0x0d56, // 26432
-    0x0d55, 0x0d54, 0x0d54, 0x0d53, 0x0d53, 0x0d52, 0x0d51, 0x0d51, // 26440
-    0x0d50, 0x0d50, 0x0d4f, 0x0d4e, 0x0d4e, 0x0d4d, 0x0d4d, 0x0d4c, // 26448
-    0x0d4c, 0x0d4b, 0x0d4a, 0x0d4a, 0x0d49, 0x0d49, 0x0d48, 0x0d47, // 26456
-    0x0d47, 0x0d46, 0x0d46, 0x0d45, 0x0d44, 0x0d44, 0x0d43, 0x0d43, // 26464
-    0x0d42, 0x0d42, 0x0d41, 0x0d40, 0x0d40, 0x0d3f, 0x0d3f, 0x0d3e, // 26472
-    0x0d3d, 0x0d3d, 0x0d3c, 0x0d3c, 0x0d3b, 0x0d3a, 0x0d3a, 0x0d39, // 26480
-    0x0d39, 0x0d38, 0x0d38, 0x0d37, 0x0d36, 0x0d36, 0x0d35, 0x0d35, // 26488
-    0x0d34, 0x0d33, 0x0d33, 0x0d32, 0x0d32, 0x0d31, 0x0d30, 0x0d30, // 26496
-    0x0d2f, 0x0d2f, 0x0d2e, 0x0d2e, 0x0d2d, 0x0d2c, 0x0d2c, 0x0d2b, // 26504
-    0x0d2b, 0x0d2a, 0x0d29, 0x0d29, 0x0d28, 0x0d28, 0x0d27, 0x0d26, // 26512
-    0x0d26, 0x0d25, 0x0d25, 0x0d24, 0x0d24, 0x0d23, 0x0d22, 0x0d22, // 26520
-    0x0d21, 0x0d21, 0x0d20, 0x0d1f, 0x0d1f, 0x0d1e, 0x0d1e, 0x0d1d, // 26528
-    0x0d1c, 0x0d1c, 0x0d1b, 0x0d1b, 0x0d1a, 0x0d1a, 0x0d19, 0x0d18, // 26536
-    0x0d18, 0x0d17, 0x0d17, 0x0d16, 0x0d15, 0x0d15, 0x0d14, 0x0d14, // 26544
-    0x0d13, 0x0d12, 0x0d12, 0x0d11, 0x0d11, 0x0d10, 0x0d10, 0x0d0f, // 26552
-    0x0d0e, 0x0d0e, 0x0d0d, 0x0d0d, 0x0d0c, 0x0d0b, 0x0d0b, 0x0d0a, // 26560
-    0x0d0a, 0x0d09, 0x0d08, 0x0d08, 0x0d07, 0x0d07, 0x0d06, 0x0d06, // 26568
-    0x0d05, 0x0d04, 0x0d04, 0x0d03, 0x0d03, 0x0d02, 0x0d01, 0x0d01, // 26576
-    0x0d00, 0x0d00, 0x0cff, 0x0cff, 0x0cfe, 0x0cfd, 0x0cfd, 0x0cfc, // 26584
-    0x0cfc, 0x0cfb, 0x0cfa, 0x0cfa, 0x0cf9, 0x0cf9, 0x0cf8, 0x0cf7, // 26592
-    0x0cf7, 0x0cf6, 0x0cf6, 0x0cf5, 0x0cf5, 0x0cf4, 0x0cf3, 0x0cf3, // 26600
-    0x0cf2, 0x0cf2, 0x0cf1, 0x0cf0, 0x0cf0, 0x0cef, 0x0cef, 0x0cee, // 26608
-    0x0ced, 0x0ced, 0x0cec, 0x0cec, 0x0ceb, 0x0ceb, 0x0cea, 0x0ce9, // 26616
-    0x0ce9, 0x0ce9, 0x0ce8, 0x0ce8, 0x0ce7, 0x0ce6, 0x0ce6, 0x0ce5, // 26624
-    0x0ce5, 0x0ce4, 0x0ce4, 0x0ce3, 0x0ce2, 0x0ce2, 0x0ce1, 0x0ce1, // 26632
-    0x0ce0, 0x0ce0, 0x0cdf, 0x0cde, 0x0cde, 0x0cdd, 0x0cdd, 0x0cdc, // 26640
-    0x0cdc, 0x0cdb, 0x0cda, 0x0cda, 0x0cd9, 0x0cd9, 0x0cd8, 0x0cd8, // 26648
-    0x0cd7, 0x0cd6, 0x0cd6, 0x0cd5, 0x0cd5, 0x0cd4, 0x0cd4, 0x0cd3, // 26656
-    0x0cd2, 0x0cd2, 0x0cd1, 0x0cd1, 0x0cd0, 0x0ccf, 0x0ccf, 0x0cce, // 26664
-    0x0cce, 0x0ccd, 0x0ccd, 0x0ccc, 0x0ccb, 0x0ccb, 0x0cca, 0x0cca, // 26672
-    0x0cc9, 0x0cc9, 0x0cc8, 0x0cc7, 0x0cc7, 0x0cc6, 0x0cc6, 0x0cc5, // 26680
-    0x0cc5, 0x0cc4, 0x0cc3, 0x0cc3, 0x0cc2, 0x0cc2, 0x0cc1, 0x0cc1, // 26688
-    0x0cc0, 0x0cbf, 0x0cbf, 0x0cbe, 0x0cbe, 0x0cbd, 0x0cbd, 0x0cbc, // 26696
-    0x0cbb, 0x0cbb, 0x0cba, 0x0cba, 0x0cb9, 0x0cb9, 0x0cb8, 0x0cb7, // 26704
-    0x0cb7, 0x0cb6, 0x0cb6, 0x0cb5, 0x0cb5, 0x0cb4, 0x0cb3, 0x0cb3, // 26712
-    0x0cb2, 0x0cb2, 0x0cb1, 0x0cb1, 0x0cb0, 0x0caf, 0x0caf, 0x0cae, // 26720
-    0x0cae, 0x0cad, 0x0cad, 0x0cac, 0x0cab, 0x0cab, 0x0caa, 0x0caa, // 26728
-    0x0ca9, 0x0ca9, 0x0ca8, 0x0ca7, 0x0ca7, 0x0ca6, 0x0ca6, 0x0ca5, // 26736
-    0x0ca5, 0x0ca4, 0x0ca3, 0x0ca3, 0x0ca2, 0x0ca2, 0x0ca1, 0x0ca1, // 26744
-    0x0ca0, 0x0c9f, 0x0c9f, 0x0c9e, 0x0c9e, 0x0c9d, 0x0c9d, 0x0c9c, // 26752
-    0x0c9b, 0x0c9b, 0x0c9a, 0x0c9a, 0x0c99, 0x0c99, 0x0c98, 0x0c97, // 26760
-    0x0c97, 0x0c96, 0x0c96, 0x0c95, 0x0c95, 0x0c94, 0x0c93, 0x0c93, // 26768
-    0x0c92, 0x0c92, 0x0c91, 0x0c91, 0x0c90, 0x0c8f, 0x0c8f, 0x0c8e, // 26776
-    0x0c8e, 0x0c8d, 0x0c8d, 0x0c8c, 0x0c8b, 0x0c8b, 0x0c8a, 0x0c8a, // 26784
-    0x0c89, 0x0c89, 0x0c88, 0x0c87, 0x0c87, 0x0c86, 0x0c86, 0x0c85, // 26792
-    0x0c85, 0x0c84, 0x0c83, 0x0c83, 0x0c82, 0x0c82, 0x0c81, 0x0c81, // 26800
-    0x0c80, 0x0c7f, 0x0c7f, 0x0c7e, 0x0c7e, 0x0c7d, 0x0c7d, 0x0c7c, // 26808
-    0x0c7b, 0x0c7b, 0x0c7a, 0x0c7a, 0x0c79, 0x0c79, 0x0c78, 0x0c77, // 26816
-    0x0c77, 0x0c76, 0x0c76, 0x0c75, 0x0c75, 0x0c74, 0x0c73, 0x0c73, // 26824
-    0x0c72, 0x0c72, 0x0c71, 0x0c71, 0x0c70, 0x0c6f, 0x0c6f, 0x0c6e, // 26832
-    0x0c6e, 0x0c6d, 0x0c6c, 0x0c6c, 0x0c6b, 0x0c6b, 0x0c6a, 0x0c6a, // 26840
-    0x0c69, 0x0c68, 0x0c68, 0x0c67, 0x0c67, 0x0c66, 0x0c66, 0x0c65, // 26848
-    0x0c64, 0x0c64, 0x0c63, 0x0c63, 0x0c62, 0x0c62, 0x0c61, 0x0c60, // 26856
-    0x0c60, 0x0c5f, 0x0c5f, 0x0c5e, 0x0c5e, 0x0c5d, 0x0c5c, 0x0c5c, // 26864
-    0x0c5b, 0x0c5b, 0x0c5a, 0x0c5a, 0x0c59, 0x0c58, 0x0c58, 0x0c57, // 26872
-    0x0c57, 0x0c56, 0x0c56, 0x0c55, 0x0c54, 0x0c54, 0x0c53, 0x0c53, // 26880
-    0x0c52, 0x0c52, 0x0c51, 0x0c50, 0x0c50, 0x0c4f, 0x0c4f, 0x0c4e, // 26888
-    0x0c4e, 0x0c4d, 0x0c4c, 0x0c4c, 0x0c4b, 0x0c4b, 0x0c4a, 0x0c4a, // 26896
-    0x0c49, 0x0c48, 0x0c48, 0x0c47, 0x0c47, 0x0c46, 0x0c46, 0x0c45, // 26904
-    0x0c44, 0x0c44, 0x0c43, 0x0c43, 0x0c42, 0x0c42, 0x0c41, 0x0c40, // 26912
-    0x0c40, 0x0c3f, 0x0c3f, 0x0c3e, 0x0c3e, 0x0c3d, 0x0c3c, 0x0c3c, // 26920
-    0x0c3b, 0x0c3b, 0x0c3a, 0x0c3a, 0x0c39, 0x0c38, 0x0c38, 0x0c37, // 26928
-    0x0c37, 0x0c36, 0x0c36, 0x0c35, 0x0c34, 0x0c34, 0x0c33, 0x0c33, // 26936
-    0x0c32, 0x0c32, 0x0c31, 0x0c30, 0x0c30, 0x0c2f, 0x0c2f, 0x0c2e, // 26944
-    0x0c2e, 0x0c2d, 0x0c2c, 0x0c2c, 0x0c2b, 0x0c2b, 0x0c2a, 0x0c2a, // 26952
-    0x0c29, 0x0c28, 0x0c28, 0x0c27, 0x0c27, 0x0c26, 0x0c26, 0x0c25, // 26960
-    0x0c24, 0x0c24, 0x0c23, 0x0c23, 0x0c22, 0x0c22, 0x0c21, 0x0c20, // 26968
-    0x0c20, 0x0c1f, 0x0c1f, 0x0c1e, 0x0c1e, 0x0c1d, 0x0c1c, 0x0c1c, // 26976
-    0x0c1b, 0x0c1b, 0x0c1a, 0x0c1a, 0x0c19, 0x0c18, 0x0c18, 0x0c17, // 26984
-    0x0c17, 0x0c16, 0x0c16, 0x0c15, 0x0c14, 0x0c14, 0x0c13, 0x0c13, // 26992
-    0x0c12, 0x0c12, 0x0c11, 0x0c10, 0x0c10, 0x0c0f, 0x0c0f, 0x0c0e, // 27000
-    0x0c0e, 0x0c0d, 0x0c0c, 0x0c0c, 0x0c0b, 0x0c0b, 0x0c0a, 0x0c09, // 27008
-    0x0c09, 0x0c08, 0x0c08, 0x0c07, 0x0c07, 0x0c06, 0x0c05, 0x0c05, // 27016
-    0x0c04, 0x0c04, 0x0c03, 0x0c03, 0x0c02, 0x0c01, 0x0c01, 0x0c00, // 27024
-    0x0c00, 0x0bff, 0x0bff, 0x0bfe, 0x0bfd, 0x0bfd, 0x0bfc, 0x0bfc, // 27032
-    0x0bfb, 0x0bfb, 0x0bfa, 0x0bf9, 0x0bf9, 0x0bf8, 0x0bf8, 0x0bf7, // 27040
-    0x0bf7, 0x0bf6, 0x0bf5, 0x0bf5, 0x0bf4, 0x0bf4, 0x0bf3, 0x0bf3, // 27048
-    0x0bf2, 0x0bf1, 0x0bf1, 0x0bf0, 0x0bf0, 0x0bef, 0x0bef, 0x0bee, // 27056
-    0x0bed, 0x0bed, 0x0bec, 0x0bec, 0x0beb, 0x0beb, 0x0bea, 0x0be9, // 27064
-    0x0be9, 0x0be8, 0x0be8, 0x0be7, 0x0be7, 0x0be6, 0x0be5, 0x0be5, // 27072
-    0x0be4, 0x0be4, 0x0be3, 0x0be3, 0x0be2, 0x0be1, 0x0be1, 0x0be0, // 27080
-    0x0be0, 0x0bdf, 0x0bdf, 0x0bde, 0x0bdd, 0x0bdd, 0x0bdc, 0x0bdc, // 27088
-    0x0bdb, 0x0bdb, 0x0bda, 0x0bd9, 0x0bd9, 0x0bd8, 0x0bd8, 0x0bd7, // 27096
-    0x0bd7, 0x0bd6, 0x0bd5, 0x0bd5, 0x0bd4, 0x0bd4, 0x0bd3, 0x0bd3, // 27104
-    0x0bd2, 0x0bd1, 0x0bd1, 0x0bd0, 0x0bd0, 0x0bcf, 0x0bcf, 0x0bce, // 27112
-    0x0bcd, 0x0bcd, 0x0bcc, 0x0bcc, 0x0bcb, 0x0bcb, 0x0bca, 0x0bc9, // 27120
-    0x0bc9, 0x0bc8, 0x0bc8, 0x0bc7, 0x0bc7, 0x0bc6, 0x0bc5, 0x0bc5, // 27128
-    0x0bc4, 0x0bc4, 0x0bc3, 0x0bc3, 0x0bc2, 0x0bc1, 0x0bc1, 0x0bc0, // 27136
-    0x0bc0, 0x0bbf, 0x0bbf, 0x0bbe, 0x0bbd, 0x0bbd, 0x0bbc, 0x0bbc, // 27144
-    0x0bbb, 0x0bbb, 0x0bba, 0x0bb9, 0x0bb9, 0x0bb8, 0x0bb8, 0x0bb7, // 27152
-    0x0bb7, 0x0bb6, 0x0bb5, 0x0bb5, 0x0bb4, 0x0bb4, 0x0bb3, 0x0bb3, // 27160
-    0x0bb2, 0x0bb1, 0x0bb1, 0x0bb0, 0x0bb0, 0x0baf, 0x0baf, 0x0bae, // 27168
-    0x0bad, 0x0bad, 0x0bac, 0x0bac, 0x0bab, 0x0baa, 0x0baa, 0x0ba9, // 27176
-    0x0ba9, 0x0ba8, 0x0ba8, 0x0ba7, 0x0ba6, 0x0ba6, 0x0ba5, 0x0ba5, // 27184
-    0x0ba4, 0x0ba4, 0x0ba3, 0x0ba2, 0x0ba2, 0x0ba1, 0x0ba1, 0x0ba0, // 27192
-    0x0ba0, 0x0b9f, 0x0b9e, 0x0b9e, 0x0b9d, 0x0b9d, 0x0b9c, 0x0b9c, // 27200
-    0x0b9b, 0x0b9a, 0x0b9a, 0x0b99, 0x0b99, 0x0b98, 0x0b98, 0x0b97, // 27208
-    0x0b96, 0x0b96, 0x0b95, 0x0b95, 0x0b94, 0x0b94, 0x0b93, 0x0b92, // 27216
-    0x0b92, 0x0b91, 0x0b91, 0x0b90, 0x0b90, 0x0b8f, 0x0b8e, 0x0b8e, // 27224
-    0x0b8d, 0x0b8d, 0x0b8c, 0x0b8c, 0x0b8b, 0x0b8a, 0x0b8a, 0x0b89, // 27232
-    0x0b89, 0x0b88, 0x0b88, 0x0b87, 0x0b86, 0x0b86, 0x0b85, 0x0b85, // 27240
-    0x0b84, 0x0b84, 0x0b83, 0x0b82, 0x0b82, 0x0b81, 0x0b81, 0x0b80, // 27248
-    0x0b80, 0x0b7f, 0x0b7e, 0x0b7e, 0x0b7d, 0x0b7d, 0x0b7c, 0x0b7c, // 27256
-    0x0b7b, 0x0b7a, 0x0b7a, 0x0b79, 0x0b79, 0x0b78, 0x0b78, 0x0b77, // 27264
-    0x0b76, 0x0b76, 0x0b75, 0x0b75, 0x0b74, 0x0b74, 0x0b73, 0x0b72, // 27272
-    0x0b72, 0x0b71, 0x0b71, 0x0b70, 0x0b70, 0x0b6f, 0x0b6e, 0x0b6e, // 27280
-    0x0b6d, 0x0b6d, 0x0b6c, 0x0b6c, 0x0b6b, 0x0b6a, 0x0b6a, 0x0b69, // 27288
-    0x0b69, 0x0b68, 0x0b68, 0x0b67, 0x0b66, 0x0b66, 0x0b65, 0x0b65, // 27296
-    0x0b64, 0x0b64, 0x0b63, 0x0b62, 0x0b62, 0x0b61, 0x0b61, 0x0b60, // 27304
-    0x0b60, 0x0b5f, 0x0b5e, 0x0b5e, 0x0b5d, 0x0b5d, 0x0b5c, 0x0b5c, // 27312
-    0x0b5b, 0x0b5a, 0x0b5a, 0x0b59, 0x0b59, 0x0b58, 0x0b58, 0x0b57, // 27320
-    0x0b56, 0x0b56, 0x0b55, 0x0b55, 0x0b54, 0x0b54, 0x0b53, 0x0b52, // 27328
-    0x0b52, 0x0b51, 0x0b51, 0x0b50, 0x0b50, 0x0b4f, 0x0b4e, 0x0b4e, // 27336
-    0x0b4d, 0x0b4d, 0x0b4c, 0x0b4c, 0x0b4b, 0x0b4a, 0x0b4a, 0x0b49, // 27344
-    0x0b49, 0x0b48, 0x0b47, 0x0b47, 0x0b46, 0x0b46, 0x0b45, 0x0b45, // 27352
-    0x0b44, 0x0b43, 0x0b43, 0x0b42, 0x0b42, 0x0b41, 0x0b41, 0x0b40, // 27360
-    0x0b3f, 0x0b3f, 0x0b3e, 0x0b3e, 0x0b3d, 0x0b3d, 0x0b3c, 0x0b3b, // 27368
-    0x0b3b, 0x0b3a, 0x0b3a, 0x0b39, 0x0b39, 0x0b38, 0x0b37, 0x0b37, // 27376
-    0x0b36, 0x0b36, 0x0b35, 0x0b35, 0x0b34, 0x0b33, 0x0b33, 0x0b32, // 27384
-    0x0b32, 0x0b31, 0x0b31, 0x0b30, 0x0b2f, 0x0b2f, 0x0b2e, 0x0b2e, // 27392
-    0x0b2d, 0x0b2d, 0x0b2c, 0x0b2b, 0x0b2b, 0x0b2a, 0x0b2a, 0x0b29, // 27400
-    0x0b29, 0x0b28, 0x0b27, 0x0b27, 0x0b26, 0x0b26, 0x0b25, 0x0b25, // 27408
-    0x0b24, 0x0b23, 0x0b23, 0x0b22, 0x0b22, 0x0b21, 0x0b21, 0x0b20, // 27416
-    0x0b1f, 0x0b1f, 0x0b1e, 0x0b1e, 0x0b1d, 0x0b1d, 0x0b1c, 0x0b1b, // 27424
-    0x0b1b, 0x0b1a, 0x0b1a, 0x0b19, 0x0b19, 0x0b18, 0x0b17, 0x0b17, // 27432
-    0x0b16, 0x0b16, 0x0b15, 0x0b15, 0x0b14, 0x0b13, 0x0b13, 0x0b12, // 27440
-    0x0b12, 0x0b11, 0x0b11, 0x0b10, 0x0b0f, 0x0b0f, 0x0b0e, 0x0b0e, // 27448
-    0x0b0d, 0x0b0d, 0x0b0c, 0x0b0b, 0x0b0b, 0x0b0a, 0x0b0a, 0x0b09, // 27456
-    0x0b09, 0x0b08, 0x0b07, 0x0b07, 0x0b06, 0x0b06, 0x0b05, 0x0b05, // 27464
-    0x0b04, 0x0b03, 0x0b03, 0x0b02, 0x0b02, 0x0b01, 0x0b01, 0x0b00, // 27472
-    0x0aff, 0x0aff, 0x0afe, 0x0afe, 0x0afd, 0x0afd, 0x0afc, 0x0afb, // 27480
-    0x0afb, 0x0afa, 0x0afa, 0x0af9, 0x0af9, 0x0af8, 0x0af7, 0x0af7, // 27488
-    0x0af6, 0x0af6, 0x0af5, 0x0af5, 0x0af4, 0x0af3, 0x0af3, 0x0af2, // 27496
-    0x0af2, 0x0af1, 0x0af1, 0x0af0, 0x0aef, 0x0aef, 0x0aee, 0x0aee, // 27504
-    0x0aed, 0x0aed, 0x0aec, 0x0aeb, 0x0aeb, 0x0aea, 0x0aea, 0x0ae9, // 27512
-    0x0ae9, 0x0ae8, 0x0ae7, 0x0ae7, 0x0ae6, 0x0ae6, 0x0ae5, 0x0ae4, // 27520
-    0x0ae4, 0x0ae3, 0x0ae3, 0x0ae2, 0x0ae2, 0x0ae1, 0x0ae0, 0x0ae0, // 27528
-    0x0adf, 0x0adf, 0x0ade, 0x0ade, 0x0add, 0x0adc, 0x0adc, 0x0adb, // 27536
-    0x0adb, 0x0ada, 0x0ada, 0x0ad9, 0x0ad8, 0x0ad8, 0x0ad7, 0x0ad7, // 27544
-    0x0ad6, 0x0ad6, 0x0ad5, 0x0ad4, 0x0ad4, 0x0ad3, 0x0ad3, 0x0ad2, // 27552
-    0x0ad2, 0x0ad1, 0x0ad0, 0x0ad0, 0x0acf, 0x0acf, 0x0ace, 0x0ace, // 27560
-    0x0acd, 0x0acc, 0x0acc, 0x0acb, 0x0acb, 0x0aca, 0x0aca, 0x0ac9, // 27568
-    0x0ac8, 0x0ac8, 0x0ac7, 0x0ac7, 0x0ac6, 0x0ac6, 0x0ac5, 0x0ac4, // 27576
-    0x0ac4, 0x0ac3, 0x0ac3, 0x0ac2, 0x0ac2, 0x0ac1, 0x0ac0, 0x0ac0, // 27584
-    0x0abf, 0x0abf, 0x0abe, 0x0abe, 0x0abd, 0x0abc, 0x0abc, 0x0abb, // 27592
-    0x0abb, 0x0aba, 0x0aba, 0x0ab9, 0x0ab8, 0x0ab8, 0x0ab7, 0x0ab7, // 27600
-    0x0ab6, 0x0ab6, 0x0ab5, 0x0ab4, 0x0ab4, 0x0ab3, 0x0ab3, 0x0ab2, // 27608
-    0x0ab2, 0x0ab1, 0x0ab0, 0x0ab0, 0x0aaf, 0x0aaf, 0x0aae, 0x0aae, // 27616
-    0x0aad, 0x0aac, 0x0aac, 0x0aab, 0x0aab, 0x0aaa, 0x0aaa, 0x0aa9, // 27624
-    0x0aa8, 0x0aa8, 0x0aa7, 0x0aa7, 0x0aa6, 0x0aa6, 0x0aa5, 0x0aa4, // 27632
-    0x0aa4, 0x0aa3, 0x0aa3, 0x0aa2, 0x0aa2, 0x0aa1, 0x0aa0, 0x0aa0, // 27640
-    0x0a9f, 0x0a9e, 0x0a9e, 0x0a9d, 0x0a9d, 0x0a9c, 0x0a9c, 0x0a9b, // 27648
-    0x0a9b, 0x0a9a, 0x0a99, 0x0a99, 0x0a98, 0x0a98, 0x0a97, 0x0a97, // 27656
-    0x0a96, 0x0a96, 0x0a95, 0x0a94, 0x0a94, 0x0a93, 0x0a93, 0x0a92, // 27664
-    0x0a92, 0x0a91, 0x0a91, 0x0a90, 0x0a8f, 0x0a8f, 0x0a8e, 0x0a8e, // 27672
-    0x0a8d, 0x0a8d, 0x0a8c, 0x0a8c, 0x0a8b, 0x0a8a, 0x0a8a, 0x0a89, // 27680
-    0x0a89, 0x0a88, 0x0a88, 0x0a87, 0x0a87, 0x0a86, 0x0a85, 0x0a85, // 27688
-    0x0a84, 0x0a84, 0x0a83, 0x0a83, 0x0a82, 0x0a81, 0x0a81, 0x0a80, // 27696
-    0x0a80, 0x0a7f, 0x0a7f, 0x0a7e, 0x0a7e, 0x0a7d, 0x0a7c, 0x0a7c, // 27704
-    0x0a7b, 0x0a7b, 0x0a7a, 0x0a7a, 0x0a79, 0x0a79, 0x0a78, 0x0a77, // 27712
-    0x0a77, 0x0a76, 0x0a76, 0x0a75, 0x0a75, 0x0a74, 0x0a74, 0x0a73, // 27720
-    0x0a72, 0x0a72, 0x0a71, 0x0a71, 0x0a70, 0x0a70, 0x0a6f, 0x0a6f, // 27728
-    0x0a6e, 0x0a6d, 0x0a6d, 0x0a6c, 0x0a6c, 0x0a6b, 0x0a6b, 0x0a6a, // 27736
-    0x0a6a, 0x0a69, 0x0a68, 0x0a68, 0x0a67, 0x0a67, 0x0a66, 0x0a66, // 27744
-    0x0a65, 0x0a65, 0x0a64, 0x0a63, 0x0a63, 0x0a62, 0x0a62, 0x0a61, // 27752
-    0x0a61, 0x0a60, 0x0a60, 0x0a5f, 0x0a5e, 0x0a5e, 0x0a5d, 0x0a5d, // 27760
-    0x0a5c, 0x0a5c, 0x0a5b, 0x0a5b, 0x0a5a, 0x0a59, 0x0a59, 0x0a58, // 27768
-    0x0a58, 0x0a57, 0x0a57, 0x0a56, 0x0a56, 0x0a55, 0x0a54, 0x0a54, // 27776
-    0x0a53, 0x0a53, 0x0a52, 0x0a52, 0x0a51, 0x0a51, 0x0a50, 0x0a4f, // 27784
-    0x0a4f, 0x0a4e, 0x0a4e, 0x0a4d, 0x0a4d, 0x0a4c, 0x0a4c, 0x0a4b, // 27792
-    0x0a4a, 0x0a4a, 0x0a49, 0x0a49, 0x0a48, 0x0a48, 0x0a47, 0x0a46, // 27800
-    0x0a46, 0x0a45, 0x0a45, 0x0a44, 0x0a44, 0x0a43, 0x0a43, 0x0a42, // 27808
-    0x0a41, 0x0a41, 0x0a40, 0x0a40, 0x0a3f, 0x0a3f, 0x0a3e, 0x0a3e, // 27816
-    0x0a3d, 0x0a3c, 0x0a3c, 0x0a3b, 0x0a3b, 0x0a3a, 0x0a3a, 0x0a39, // 27824
-    0x0a39, 0x0a38, 0x0a37, 0x0a37, 0x0a36, 0x0a36, 0x0a35, 0x0a35, // 27832
-    0x0a34, 0x0a34, 0x0a33, 0x0a32, 0x0a32, 0x0a31, 0x0a31, 0x0a30, // 27840
-    0x0a30, 0x0a2f, 0x0a2f, 0x0a2e, 0x0a2d, 0x0a2d, 0x0a2c, 0x0a2c, // 27848
-    0x0a2b, 0x0a2b, 0x0a2a, 0x0a2a, 0x0a29, 0x0a28, 0x0a28, 0x0a27, // 27856
-    0x0a27, 0x0a26, 0x0a26, 0x0a25, 0x0a25, 0x0a24, 0x0a23, 0x0a23, // 27864
-    0x0a22, 0x0a22, 0x0a21, 0x0a21, 0x0a20, 0x0a20, 0x0a1f, 0x0a1e, // 27872
-    0x0a1e, 0x0a1d, 0x0a1d, 0x0a1c, 0x0a1c, 0x0a1b, 0x0a1b, 0x0a1a, // 27880
-    0x0a19, 0x0a19, 0x0a18, 0x0a18, 0x0a17, 0x0a17, 0x0a16, 0x0a16, // 27888
-    0x0a15, 0x0a14, 0x0a14, 0x0a13, 0x0a13, 0x0a12, 0x0a12, 0x0a11, // 27896
-    0x0a11, 0x0a10, 0x0a0f, 0x0a0f, 0x0a0e, 0x0a0e, 0x0a0d, 0x0a0d, // 27904
-    0x0a0c, 0x0a0b, 0x0a0b, 0x0a0a, 0x0a0a, 0x0a09, 0x0a09, 0x0a08, // 27912
-    0x0a08, 0x0a07, 0x0a06, 0x0a06, 0x0a05, 0x0a05, 0x0a04, 0x0a04, // 27920
-    0x0a03, 0x0a03, 0x0a02, 0x0a01, 0x0a01, 0x0a00, 0x0a00, 0x09ff, // 27928
-    0x09ff, 0x09fe, 0x09fe, 0x09fd, 0x09fc, 0x09fc, 0x09fb, 0x09fb, // 27936
-    0x09fa, 0x09fa, 0x09f9, 0x09f9, 0x09f8, 0x09f7, 0x09f7, 0x09f6, // 27944
-    0x09f6, 0x09f5, 0x09f5, 0x09f4, 0x09f4, 0x09f3, 0x09f2, 0x09f2, // 27952
-    0x09f1, 0x09f1, 0x09f0, 0x09f0, 0x09ef, 0x09ef, 0x09ee, 0x09ed, // 27960
-    0x09ed, 0x09ec, 0x09ec, 0x09eb, 0x09eb, 0x09ea, 0x09ea, 0x09e9, // 27968
-    0x09e8, 0x09e8, 0x09e7, 0x09e7, 0x09e6, 0x09e6, 0x09e5, 0x09e5, // 27976
-    0x09e4, 0x09e3, 0x09e3, 0x09e2, 0x09e2, 0x09e1, 0x09e1, 0x09e0, // 27984
-    0x09e0, 0x09df, 0x09de, 0x09de, 0x09dd, 0x09dd, 0x09dc, 0x09dc, // 27992
-    0x09db, 0x09db, 0x09da, 0x09d9, 0x09d9, 0x09d8, 0x09d8, 0x09d7, // 28000
-    0x09d7, 0x09d6, 0x09d5, 0x09d5, 0x09d4, 0x09d4, 0x09d3, 0x09d3, // 28008
-    0x09d2, 0x09d2, 0x09d1, 0x09d0, 0x09d0, 0x09cf, 0x09cf, 0x09ce, // 28016
-    0x09ce, 0x09cd, 0x09cd, 0x09cc, 0x09cb, 0x09cb, 0x09ca, 0x09ca, // 28024
-    0x09c9, 0x09c9, 0x09c8, 0x09c8, 0x09c7, 0x09c6, 0x09c6, 0x09c5, // 28032
-    0x09c5, 0x09c4, 0x09c4, 0x09c3, 0x09c3, 0x09c2, 0x09c1, 0x09c1, // 28040
-    0x09c0, 0x09c0, 0x09bf, 0x09bf, 0x09be, 0x09be, 0x09bd, 0x09bc, // 28048
-    0x09bc, 0x09bb, 0x09bb, 0x09ba, 0x09ba, 0x09b9, 0x09b9, 0x09b8, // 28056
-    0x09b7, 0x09b7, 0x09b6, 0x09b6, 0x09b5, 0x09b5, 0x09b4, 0x09b4, // 28064
-    0x09b3, 0x09b2, 0x09b2, 0x09b1, 0x09b1, 0x09b0, 0x09b0, 0x09af, // 28072
-    0x09af, 0x09ae, 0x09ad, 0x09ad, 0x09ac, 0x09ac, 0x09ab, 0x09ab, // 28080
-    0x09aa, 0x09aa, 0x09a9, 0x09a8, 0x09a8, 0x09a7, 0x09a7, 0x09a6, // 28088
-    0x09a6, 0x09a5, 0x09a5, 0x09a4, 0x09a3, 0x09a3, 0x09a2, 0x09a2, // 28096
-    0x09a1, 0x09a1, 0x09a0, 0x09a0, 0x099f, 0x099e, 0x099e, 0x099d, // 28104
-    0x099d, 0x099c, 0x099c, 0x099b, 0x099a, 0x099a, 0x0999, 0x0999, // 28112
-    0x0998, 0x0998, 0x0997, 0x0997, 0x0996, 0x0995, 0x0995, 0x0994, // 28120
-    0x0994, 0x0993, 0x0993, 0x0992, 0x0992, 0x0991, 0x0990, 0x0990, // 28128
-    0x098f, 0x098f, 0x098e, 0x098e, 0x098d, 0x098d, 0x098c, 0x098b, // 28136
-    0x098b, 0x098a, 0x098a, 0x0989, 0x0989, 0x0988, 0x0988, 0x0987, // 28144
-    0x0986, 0x0986, 0x0985, 0x0985, 0x0984, 0x0984, 0x0983, 0x0983, // 28152
-    0x0982, 0x0981, 0x0981, 0x0980, 0x0980, 0x097f, 0x097f, 0x097e, // 28160
-    0x097e, 0x097d, 0x097c, 0x097c, 0x097b, 0x097b, 0x097a, 0x097a, // 28168
-    0x0979, 0x0979, 0x0978, 0x0977, 0x0977, 0x0976, 0x0976, 0x0975, // 28176
-    0x0975, 0x0974, 0x0974, 0x0973, 0x0972, 0x0972, 0x0971, 0x0971, // 28184
-    0x0970, 0x0970, 0x096f, 0x096f, 0x096e, 0x096d, 0x096d, 0x096c, // 28192
-    0x096c, 0x096b, 0x096b, 0x096a, 0x096a, 0x0969, 0x0968, 0x0968, // 28200
-    0x0967, 0x0967, 0x0966, 0x0966, 0x0965, 0x0964, 0x0964, 0x0963, // 28208
-    0x0963, 0x0962, 0x0962, 0x0961, 0x0961, 0x0960, 0x095f, 0x095f, // 28216
-    0x095e, 0x095e, 0x095d, 0x095d, 0x095c, 0x095c, 0x095b, 0x095a, // 28224
-    0x095a, 0x0959, 0x0959, 0x0958, 0x0958, 0x0957, 0x0957, 0x0956, // 28232
-    0x0955, 0x0955, 0x0954, 0x0954, 0x0953, 0x0953, 0x0952, 0x0952, // 28240
-    0x0951, 0x0950, 0x0950, 0x094f, 0x094f, 0x094e, 0x094e, 0x094d, // 28248
-    0x094d, 0x094c, 0x094b, 0x094b, 0x094a, 0x094a, 0x0949, 0x0949, // 28256
-    0x0948, 0x0948, 0x0947, 0x0946, 0x0946, 0x0945, 0x0945, 0x0944, // 28264
-    0x0944, 0x0943, 0x0943, 0x0942, 0x0941, 0x0941, 0x0940, 0x0940, // 28272
-    0x093f, 0x093f, 0x093e, 0x093e, 0x093d, 0x093c, 0x093c, 0x093b, // 28280
-    0x093b, 0x093a, 0x093a, 0x0939, 0x0939, 0x0938, 0x0937, 0x0937, // 28288
-    0x0936, 0x0936, 0x0935, 0x0935, 0x0934, 0x0934, 0x0933, 0x0932, // 28296
-    0x0932, 0x0931, 0x0931, 0x0930, 0x0930, 0x092f, 0x092f, 0x092e, // 28304
-    0x092d, 0x092d, 0x092c, 0x092c, 0x092b, 0x092b, 0x092a, 0x0929, // 28312
-    0x0929, 0x0928, 0x0928, 0x0927, 0x0927, 0x0926, 0x0926, 0x0925, // 28320
-    0x0924, 0x0924, 0x0923, 0x0923, 0x0922, 0x0922, 0x0921, 0x0921, // 28328
-    0x0920, 0x091f, 0x091f, 0x091e, 0x091e, 0x091d, 0x091d, 0x091c, // 28336
-    0x091c, 0x091b, 0x091a, 0x091a, 0x0919, 0x0919, 0x0918, 0x0918, // 28344
-    0x0917, 0x0917, 0x0916, 0x0915, 0x0915, 0x0914, 0x0914, 0x0913, // 28352
-    0x0913, 0x0912, 0x0912, 0x0911, 0x0910, 0x0910, 0x090f, 0x090f, // 28360
-    0x090e, 0x090e, 0x090d, 0x090d, 0x090c, 0x090b, 0x090b, 0x090a, // 28368
-    0x090a, 0x0909, 0x0909, 0x0908, 0x0908, 0x0907, 0x0906, 0x0906, // 28376
-    0x0905, 0x0905, 0x0904, 0x0904, 0x0903, 0x0903, 0x0902, 0x0901, // 28384
-    0x0901, 0x0900, 0x0900, 0x08ff, 0x08ff, 0x08fe, 0x08fe, 0x08fd, // 28392
-    0x08fc, 0x08fc, 0x08fb, 0x08fb, 0x08fa, 0x08fa, 0x08f9, 0x08f9, // 28400
-    0x08f8, 0x08f7, 0x08f7, 0x08f6, 0x08f6, 0x08f5, 0x08f5, 0x08f4, // 28408
-    0x08f4, 0x08f3, 0x08f2, 0x08f2, 0x08f1, 0x08f1, 0x08f0, 0x08f0, // 28416
-    0x08ef, 0x08ee, 0x08ee, 0x08ed, 0x08ed, 0x08ec, 0x08ec, 0x08eb, // 28424
-    0x08eb, 0x08ea, 0x08e9, 0x08e9, 0x08e8, 0x08e8, 0x08e7, 0x08e7, // 28432
-    0x08e6, 0x08e6, 0x08e5, 0x08e4, 0x08e4, 0x08e3, 0x08e3, 0x08e2, // 28440
-    0x08e2, 0x08e1, 0x08e1, 0x08e0, 0x08df, 0x08df, 0x08de, 0x08de, // 28448
-    0x08dd, 0x08dd, 0x08dc, 0x08dc, 0x08db, 0x08da, 0x08da, 0x08d9, // 28456
-    0x08d9, 0x08d8, 0x08d8, 0x08d7, 0x08d7, 0x08d6, 0x08d5, 0x08d5, // 28464
-    0x08d4, 0x08d4, 0x08d3, 0x08d3, 0x08d2, 0x08d2, 0x08d1, 0x08d0, // 28472
-    0x08d0, 0x08cf, 0x08cf, 0x08ce, 0x08ce, 0x08cd, 0x08cd, 0x08cc, // 28480
-    0x08cb, 0x08cb, 0x08ca, 0x08ca, 0x08c9, 0x08c9, 0x08c8, 0x08c8, // 28488
-    0x08c7, 0x08c6, 0x08c6, 0x08c5, 0x08c5, 0x08c4, 0x08c4, 0x08c3, // 28496
-    0x08c3, 0x08c2, 0x08c1, 0x08c1, 0x08c0, 0x08c0, 0x08bf, 0x08bf, // 28504
-    0x08be, 0x08be, 0x08bd, 0x08bc, 0x08bc, 0x08bb, 0x08bb, 0x08ba, // 28512
-    0x08ba, 0x08b9, 0x08b8, 0x08b8, 0x08b7, 0x08b7, 0x08b6, 0x08b6, // 28520
-    0x08b5, 0x08b5, 0x08b4, 0x08b3, 0x08b3, 0x08b2, 0x08b2, 0x08b1, // 28528
-    0x08b1, 0x08b0, 0x08b0, 0x08af, 0x08ae, 0x08ae, 0x08ad, 0x08ad, // 28536
-    0x08ac, 0x08ac, 0x08ab, 0x08ab, 0x08aa, 0x08a9, 0x08a9, 0x08a8, // 28544
-    0x08a8, 0x08a7, 0x08a7, 0x08a6, 0x08a6, 0x08a5, 0x08a4, 0x08a4, // 28552
-    0x08a3, 0x08a3, 0x08a2, 0x08a2, 0x08a1, 0x08a1, 0x08a0, 0x089f, // 28560
-    0x089f, 0x089e, 0x089e, 0x089d, 0x089d, 0x089c, 0x089c, 0x089b, // 28568
-    0x089a, 0x089a, 0x0899, 0x0899, 0x0898, 0x0898, 0x0897, 0x0897, // 28576
-    0x0896, 0x0895, 0x0895, 0x0894, 0x0894, 0x0893, 0x0893, 0x0892, // 28584
-    0x0892, 0x0891, 0x0890, 0x0890, 0x088f, 0x088f, 0x088e, 0x088e, // 28592
-    0x088d, 0x088d, 0x088c, 0x088b, 0x088b, 0x088a, 0x088a, 0x0889, // 28600
-    0x0889, 0x0888, 0x0888, 0x0887, 0x0886, 0x0886, 0x0885, 0x0885, // 28608
-    0x0884, 0x0884, 0x0883, 0x0883, 0x0882, 0x0881, 0x0881, 0x0880, // 28616
-    0x0880, 0x087f, 0x087f, 0x087e, 0x087d, 0x087d, 0x087c, 0x087c, // 28624
-    0x087b, 0x087b, 0x087a, 0x087a, 0x0879, 0x0878, 0x0878, 0x0877, // 28632
-    0x0877, 0x0876, 0x0876, 0x0875, 0x0875, 0x0874, 0x0873, 0x0873, // 28640
-    0x0872, 0x0872, 0x0871, 0x0871, 0x0870, 0x0870, 0x086f, 0x086e, // 28648
-    0x086e, 0x086d, 0x086d, 0x086c, 0x086c, 0x086b, 0x086b, 0x086a, // 28656
-    0x0869, 0x0869, 0x0868, 0x0868, 0x0867, 0x0867, 0x0866, 0x0866, // 28664
-    0x0865, 0x0864, 0x0864, 0x0863, 0x0863, 0x0862, 0x0861, 0x0861, // 28672
-    0x0860, 0x0860, 0x085f, 0x085f, 0x085e, 0x085e, 0x085d, 0x085d, // 28680
-    0x085c, 0x085b, 0x085b, 0x085a, 0x085a, 0x0859, 0x0859, 0x0858, // 28688
-    0x0858, 0x0857, 0x0857, 0x0856, 0x0855, 0x0855, 0x0854, 0x0854, // 28696
-    0x0853, 0x0853, 0x0852, 0x0852, 0x0851, 0x0851, 0x0850, 0x084f, // 28704
-    0x084f, 0x084e, 0x084e, 0x084d, 0x084d, 0x084c, 0x084c, 0x084b, // 28712
-    0x084b, 0x084a, 0x084a, 0x0849, 0x0848, 0x0848, 0x0847, 0x0847, // 28720
-    0x0846, 0x0846, 0x0845, 0x0845, 0x0844, 0x0844, 0x0843, 0x0842, // 28728
-    0x0842, 0x0841, 0x0841, 0x0840, 0x0840, 0x083f, 0x083f, 0x083e, // 28736
-    0x083e, 0x083d, 0x083c, 0x083c, 0x083b, 0x083b, 0x083a, 0x083a, // 28744
-    0x0839, 0x0839, 0x0838, 0x0838, 0x0837, 0x0836, 0x0836, 0x0835, // 28752
-    0x0835, 0x0834, 0x0834, 0x0833, 0x0833, 0x0832, 0x0832, 0x0831, // 28760
-    0x0830, 0x0830, 0x082f, 0x082f, 0x082e, 0x082e, 0x082d, 0x082d, // 28768
-    0x082c, 0x082c, 0x082b, 0x082a, 0x082a, 0x0829, 0x0829, 0x0828, // 28776
-    0x0828, 0x0827, 0x0827, 0x0826, 0x0826, 0x0825, 0x0824, 0x0824, // 28784
-    0x0823, 0x0823, 0x0822, 0x0822, 0x0821, 0x0821, 0x0820, 0x0820, // 28792
-    0x081f, 0x081e, 0x081e, 0x081d, 0x081d, 0x081c, 0x081c, 0x081b, // 28800
-    0x081b, 0x081a, 0x081a, 0x0819, 0x0818, 0x0818, 0x0817, 0x0817, // 28808
-    0x0816, 0x0816, 0x0815, 0x0815, 0x0814, 0x0814, 0x0813, 0x0812, // 28816
-    0x0812, 0x0811, 0x0811, 0x0810, 0x0810, 0x080f, 0x080f, 0x080e, // 28824
-    0x080e, 0x080d, 0x080c, 0x080c, 0x080b, 0x080b, 0x080a, 0x080a, // 28832
-    0x0809, 0x0809, 0x0808, 0x0808, 0x0807, 0x0806, 0x0806, 0x0805, // 28840
-    0x0805, 0x0804, 0x0804, 0x0803, 0x0803, 0x0802, 0x0802, 0x0801, // 28848
-    0x0800, 0x0800, 0x07ff, 0x07ff, 0x07fe, 0x07fe, 0x07fd, 0x07fd, // 28856
-    0x07fc, 0x07fc, 0x07fb, 0x07fa, 0x07fa, 0x07f9, 0x07f9, 0x07f8, // 28864
-    0x07f8, 0x07f7, 0x07f7, 0x07f6, 0x07f6, 0x07f5, 0x07f4, 0x07f4, // 28872
-    0x07f3, 0x07f3, 0x07f2, 0x07f2, 0x07f1, 0x07f1, 0x07f0, 0x07f0, // 28880
-    0x07ef, 0x07ef, 0x07ee, 0x07ed, 0x07ed, 0x07ec, 0x07ec, 0x07eb, // 28888
-    0x07eb, 0x07ea, 0x07ea, 0x07e9, 0x07e9, 0x07e8, 0x07e7, 0x07e7, // 28896
-    0x07e6, 0x07e6, 0x07e5, 0x07e5, 0x07e4, 0x07e4, 0x07e3, 0x07e3, // 28904
-    0x07e2, 0x07e1, 0x07e1, 0x07e0, 0x07e0, 0x07df, 0x07df, 0x07de, // 28912
-    0x07de, 0x07dd, 0x07dd, 0x07dc, 0x07db, 0x07db, 0x07da, 0x07da, // 28920
-    0x07d9, 0x07d9, 0x07d8, 0x07d8, 0x07d7, 0x07d7, 0x07d6, 0x07d5, // 28928
-    0x07d5, 0x07d4, 0x07d4, 0x07d3, 0x07d3, 0x07d2, 0x07d2, 0x07d1, // 28936
-    0x07d1, 0x07d0, 0x07cf, 0x07cf, 0x07ce, 0x07ce, 0x07cd, 0x07cd, // 28944
-    0x07cc, 0x07cc, 0x07cb, 0x07cb, 0x07ca, 0x07c9, 0x07c9, 0x07c8, // 28952
-    0x07c8, 0x07c7, 0x07c7, 0x07c6, 0x07c6, 0x07c5, 0x07c5, 0x07c4, // 28960
-    0x07c3, 0x07c3, 0x07c2, 0x07c2, 0x07c1, 0x07c1, 0x07c0, 0x07c0, // 28968
-    0x07bf, 0x07bf, 0x07be, 0x07bd, 0x07bd, 0x07bc, 0x07bc, 0x07bb, // 28976
-    0x07bb, 0x07ba, 0x07ba, 0x07b9, 0x07b9, 0x07b8, 0x07b7, 0x07b7, // 28984
-    0x07b6, 0x07b6, 0x07b5, 0x07b5, 0x07b4, 0x07b4, 0x07b3, 0x07b3, // 28992
-    0x07b2, 0x07b1, 0x07b1, 0x07b0, 0x07b0, 0x07af, 0x07af, 0x07ae, // 29000
-    0x07ae, 0x07ad, 0x07ad, 0x07ac, 0x07ab, 0x07ab, 0x07aa, 0x07aa, // 29008
-    0x07a9, 0x07a9, 0x07a8, 0x07a8, 0x07a7, 0x07a7, 0x07a6, 0x07a5, // 29016
-    0x07a5, 0x07a4, 0x07a4, 0x07a3, 0x07a3, 0x07a2, 0x07a2, 0x07a1, // 29024
-    0x07a1, 0x07a0, 0x079f, 0x079f, 0x079e, 0x079e, 0x079d, 0x079d, // 29032
-    0x079c, 0x079c, 0x079b, 0x079b, 0x079a, 0x0799, 0x0799, 0x0798, // 29040
-    0x0798, 0x0797, 0x0797, 0x0796, 0x0796, 0x0795, 0x0795, 0x0794, // 29048
-    0x0794, 0x0793, 0x0792, 0x0792, 0x0791, 0x0791, 0x0790, 0x0790, // 29056
-    0x078f, 0x078f, 0x078e, 0x078e, 0x078d, 0x078c, 0x078c, 0x078b, // 29064
-    0x078b, 0x078a, 0x078a, 0x0789, 0x0789, 0x0788, 0x0788, 0x0787, // 29072
-    0x0786, 0x0786, 0x0785, 0x0785, 0x0784, 0x0784, 0x0783, 0x0783, // 29080
-    0x0782, 0x0782, 0x0781, 0x0780, 0x0780, 0x077f, 0x077f, 0x077e, // 29088
-    0x077e, 0x077d, 0x077d, 0x077c, 0x077c, 0x077b, 0x077a, 0x077a, // 29096
-    0x0779, 0x0779, 0x0778, 0x0778, 0x0777, 0x0777, 0x0776, 0x0776, // 29104
-    0x0775, 0x0774, 0x0774, 0x0773, 0x0773, 0x0772, 0x0772, 0x0771, // 29112
-    0x0771, 0x0770, 0x0770, 0x076f, 0x076e, 0x076e, 0x076d, 0x076d, // 29120
-    0x076c, 0x076c, 0x076b, 0x076b, 0x076a, 0x076a, 0x0769, 0x0768, // 29128
-    0x0768, 0x0767, 0x0767, 0x0766, 0x0766, 0x0765, 0x0765, 0x0764, // 29136
-    0x0764, 0x0763, 0x0762, 0x0762, 0x0761, 0x0761, 0x0760, 0x0760, // 29144
-    0x075f, 0x075f, 0x075e, 0x075e, 0x075d, 0x075c, 0x075c, 0x075b, // 29152
-    0x075b, 0x075a, 0x075a, 0x0759, 0x0759, 0x0758, 0x0758, 0x0757, // 29160
-    0x0756, 0x0756, 0x0755, 0x0755, 0x0754, 0x0754, 0x0753, 0x0753, // 29168
-    0x0752, 0x0752, 0x0751, 0x0750, 0x0750, 0x074f, 0x074f, 0x074e, // 29176
-    0x074e, 0x074d, 0x074d, 0x074c, 0x074c, 0x074b, 0x074a, 0x074a, // 29184
-    0x0749, 0x0749, 0x0748, 0x0748, 0x0747, 0x0747, 0x0746, 0x0746, // 29192
-    0x0745, 0x0744, 0x0744, 0x0743, 0x0743, 0x0742, 0x0742, 0x0741, // 29200
-    0x0741, 0x0740, 0x0740, 0x073f, 0x073e, 0x073e, 0x073d, 0x073d, // 29208
-    0x073c, 0x073c, 0x073b, 0x073b, 0x073a, 0x073a, 0x0739, 0x0738, // 29216
-    0x0738, 0x0737, 0x0737, 0x0736, 0x0736, 0x0735, 0x0735, 0x0734, // 29224
-    0x0734, 0x0733, 0x0733, 0x0732, 0x0731, 0x0731, 0x0730, 0x0730, // 29232
-    0x072f, 0x072f, 0x072e, 0x072e, 0x072d, 0x072d, 0x072c, 0x072b, // 29240
-    0x072b, 0x072a, 0x072a, 0x0729, 0x0729, 0x0728, 0x0728, 0x0727, // 29248
-    0x0727, 0x0726, 0x0725, 0x0725, 0x0724, 0x0724, 0x0723, 0x0723, // 29256
-    0x0722, 0x0722, 0x0721, 0x0721, 0x0720, 0x071f, 0x071f, 0x071e, // 29264
-    0x071e, 0x071d, 0x071d, 0x071c, 0x071c, 0x071b, 0x071b, 0x071a, // 29272
-    0x0719, 0x0719, 0x0718, 0x0718, 0x0717, 0x0717, 0x0716, 0x0716, // 29280
-    0x0715, 0x0715, 0x0714, 0x0713, 0x0713, 0x0712, 0x0712, 0x0711, // 29288
-    0x0711, 0x0710, 0x0710, 0x070f, 0x070f, 0x070e, 0x070d, 0x070d, // 29296
-    0x070c, 0x070c, 0x070b, 0x070b, 0x070a, 0x070a, 0x0709, 0x0709, // 29304
-    0x0708, 0x0707, 0x0707, 0x0706, 0x0706, 0x0705, 0x0705, 0x0704, // 29312
-    0x0704, 0x0703, 0x0703, 0x0702, 0x0701, 0x0701, 0x0700, 0x0700, // 29320
-    0x06ff, 0x06ff, 0x06fe, 0x06fe, 0x06fd, 0x06fd, 0x06fc, 0x06fb, // 29328
-    0x06fb, 0x06fa, 0x06fa, 0x06f9, 0x06f9, 0x06f8, 0x06f8, 0x06f7, // 29336
-    0x06f7, 0x06f6, 0x06f5, 0x06f5, 0x06f4, 0x06f4, 0x06f3, 0x06f3, // 29344
-    0x06f2, 0x06f2, 0x06f1, 0x06f1, 0x06f0, 0x06ef, 0x06ef, 0x06ee, // 29352
-    0x06ee, 0x06ed, 0x06ed, 0x06ec, 0x06ec, 0x06eb, 0x06eb, 0x06ea, // 29360
-    0x06e9, 0x06e9, 0x06e8, 0x06e8, 0x06e7, 0x06e7, 0x06e6, 0x06e6, // 29368
-    0x06e5, 0x06e5, 0x06e4, 0x06e3, 0x06e3, 0x06e2, 0x06e2, 0x06e1, // 29376
-    0x06e1, 0x06e0, 0x06e0, 0x06df, 0x06df, 0x06de, 0x06dd, 0x06dd, // 29384
-    0x06dc, 0x06dc, 0x06db, 0x06db, 0x06da, 0x06da, 0x06d9, 0x06d9, // 29392
-    0x06d8, 0x06d8, 0x06d7, 0x06d6, 0x06d6, 0x06d5, 0x06d5, 0x06d4, // 29400
-    0x06d4, 0x06d3, 0x06d3, 0x06d2, 0x06d2, 0x06d1, 0x06d0, 0x06d0, // 29408
-    0x06cf, 0x06cf, 0x06ce, 0x06ce, 0x06cd, 0x06cd, 0x06cc, 0x06cc, // 29416
-    0x06cb, 0x06ca, 0x06ca, 0x06c9, 0x06c9, 0x06c8, 0x06c8, 0x06c7, // 29424
-    0x06c7, 0x06c6, 0x06c6, 0x06c5, 0x06c4, 0x06c4, 0x06c3, 0x06c3, // 29432
-    0x06c2, 0x06c2, 0x06c1, 0x06c1, 0x06c0, 0x06c0, 0x06bf, 0x06be, // 29440
-    0x06be, 0x06bd, 0x06bd, 0x06bc, 0x06bc, 0x06bb, 0x06bb, 0x06ba, // 29448
-    0x06ba, 0x06b9, 0x06b8, 0x06b8, 0x06b7, 0x06b7, 0x06b6, 0x06b6, // 29456
-    0x06b5, 0x06b5, 0x06b4, 0x06b4, 0x06b3, 0x06b2, 0x06b2, 0x06b1, // 29464
-    0x06b1, 0x06b0, 0x06b0, 0x06af, 0x06af, 0x06ae, 0x06ae, 0x06ad, // 29472
-    0x06ac, 0x06ac, 0x06ab, 0x06ab, 0x06aa, 0x06aa, 0x06a9, 0x06a9, // 29480
-    0x06a8, 0x06a8, 0x06a7, 0x06a6, 0x06a6, 0x06a5, 0x06a5, 0x06a4, // 29488
-    0x06a4, 0x06a3, 0x06a3, 0x06a2, 0x06a2, 0x06a1, 0x06a0, 0x06a0, // 29496
-    0x069f, 0x069f, 0x069e, 0x069e, 0x069d, 0x069d, 0x069c, 0x069c, // 29504
-    0x069b, 0x069a, 0x069a, 0x0699, 0x0699, 0x0698, 0x0698, 0x0697, // 29512
-    0x0697, 0x0696, 0x0696, 0x0695, 0x0694, 0x0694, 0x0693, 0x0693, // 29520
-    0x0692, 0x0692, 0x0691, 0x0691, 0x0690, 0x0690, 0x068f, 0x068e, // 29528
-    0x068e, 0x068d, 0x068d, 0x068c, 0x068c, 0x068b, 0x068b, 0x068a, // 29536
-    0x068a, 0x0689, 0x0688, 0x0688, 0x0687, 0x0687, 0x0686, 0x0686, // 29544
-    0x0685, 0x0685, 0x0684, 0x0684, 0x0683, 0x0682, 0x0682, 0x0681, // 29552
-    0x0681, 0x0680, 0x0680, 0x067f, 0x067f, 0x067e, 0x067e, 0x067d, // 29560
-    0x067d, 0x067c, 0x067b, 0x067b, 0x067a, 0x067a, 0x0679, 0x0679, // 29568
-    0x0678, 0x0678, 0x0677, 0x0677, 0x0676, 0x0675, 0x0675, 0x0674, // 29576
-    0x0674, 0x0673, 0x0673, 0x0672, 0x0672, 0x0671, 0x0671, 0x0670, // 29584
-    0x066f, 0x066f, 0x066e, 0x066e, 0x066d, 0x066d, 0x066c, 0x066c, // 29592
-    0x066b, 0x066b, 0x066a, 0x0669, 0x0669, 0x0668, 0x0668, 0x0667, // 29600
-    0x0667, 0x0666, 0x0666, 0x0665, 0x0665, 0x0664, 0x0663, 0x0663, // 29608
-    0x0662, 0x0662, 0x0661, 0x0661, 0x0660, 0x0660, 0x065f, 0x065f, // 29616
-    0x065e, 0x065d, 0x065d, 0x065c, 0x065c, 0x065b, 0x065b, 0x065a, // 29624
-    0x065a, 0x0659, 0x0659, 0x0658, 0x0657, 0x0657, 0x0656, 0x0656, // 29632
-    0x0655, 0x0655, 0x0654, 0x0654, 0x0653, 0x0653, 0x0652, 0x0651, // 29640
-    0x0651, 0x0650, 0x0650, 0x064f, 0x064f, 0x064e, 0x064e, 0x064d, // 29648
-    0x064d, 0x064c, 0x064b, 0x064b, 0x064a, 0x064a, 0x0649, 0x0649, // 29656
-    0x0648, 0x0648, 0x0647, 0x0647, 0x0646, 0x0645, 0x0645, 0x0644, // 29664
-    0x0644, 0x0643, 0x0643, 0x0642, 0x0642, 0x0641, 0x0641, 0x0640, // 29672
-    0x063f, 0x063f, 0x063e, 0x063e, 0x063d, 0x063d, 0x063c, 0x063c, // 29680
-    0x063b, 0x063b, 0x063a, 0x0639, 0x0639, 0x0638, 0x0638, 0x0637, // 29688
-    0x0637, 0x0636, 0x0636, 0x0635, 0x0635, 0x0634, 0x0634, 0x0633, // 29696
-    0x0633, 0x0632, 0x0631, 0x0631, 0x0630, 0x0630, 0x062f, 0x062f, // 29704
-    0x062e, 0x062e, 0x062d, 0x062d, 0x062c, 0x062c, 0x062b, 0x062b, // 29712
-    0x062a, 0x062a, 0x0629, 0x0628, 0x0628, 0x0627, 0x0627, 0x0626, // 29720
-    0x0626, 0x0625, 0x0625, 0x0624, 0x0624, 0x0623, 0x0623, 0x0622, // 29728
-    0x0622, 0x0621, 0x0621, 0x0620, 0x061f, 0x061f, 0x061e, 0x061e, // 29736
-    0x061d, 0x061d, 0x061c, 0x061c, 0x061b, 0x061b, 0x061a, 0x061a, // 29744
-    0x0619, 0x0619, 0x0618, 0x0618, 0x0617, 0x0616, 0x0616, 0x0615, // 29752
-    0x0615, 0x0614, 0x0614, 0x0613, 0x0613, 0x0612, 0x0612, 0x0611, // 29760
-    0x0611, 0x0610, 0x0610, 0x060f, 0x060f, 0x060e, 0x060d, 0x060d, // 29768
-    0x060c, 0x060c, 0x060b, 0x060b, 0x060a, 0x060a, 0x0609, 0x0609, // 29776
-    0x0608, 0x0608, 0x0607, 0x0607, 0x0606, 0x0606, 0x0605, 0x0604, // 29784
-    0x0604, 0x0603, 0x0603, 0x0602, 0x0602, 0x0601, 0x0601, 0x0600, // 29792
-    0x0600, 0x05ff, 0x05ff, 0x05fe, 0x05fe, 0x05fd, 0x05fd, 0x05fc, // 29800
-    0x05fb, 0x05fb, 0x05fa, 0x05fa, 0x05f9, 0x05f9, 0x05f8, 0x05f8, // 29808
-    0x05f7, 0x05f7, 0x05f6, 0x05f6, 0x05f5, 0x05f5, 0x05f4, 0x05f4, // 29816
-    0x05f3, 0x05f2, 0x05f2, 0x05f1, 0x05f1, 0x05f0, 0x05f0, 0x05ef, // 29824
-    0x05ef, 0x05ee, 0x05ee, 0x05ed, 0x05ed, 0x05ec, 0x05ec, 0x05eb, // 29832
-    0x05eb, 0x05ea, 0x05e9, 0x05e9, 0x05e8, 0x05e8, 0x05e7, 0x05e7, // 29840
-    0x05e6, 0x05e6, 0x05e5, 0x05e5, 0x05e4, 0x05e4, 0x05e3, 0x05e3, // 29848
-    0x05e2, 0x05e2, 0x05e1, 0x05e0, 0x05e0, 0x05df, 0x05df, 0x05de, // 29856
-    0x05de, 0x05dd, 0x05dd, 0x05dc, 0x05dc, 0x05db, 0x05db, 0x05da, // 29864
-    0x05da, 0x05d9, 0x05d9, 0x05d8, 0x05d7, 0x05d7, 0x05d6, 0x05d6, // 29872
-    0x05d5, 0x05d5, 0x05d4, 0x05d4, 0x05d3, 0x05d3, 0x05d2, 0x05d2, // 29880
-    0x05d1, 0x05d1, 0x05d0, 0x05d0, 0x05cf, 0x05ce, 0x05ce, 0x05cd, // 29888
-    0x05cd, 0x05cc, 0x05cc, 0x05cb, 0x05cb, 0x05ca, 0x05ca, 0x05c9, // 29896
-    0x05c9, 0x05c8, 0x05c8, 0x05c7, 0x05c7, 0x05c6, 0x05c5, 0x05c5, // 29904
-    0x05c4, 0x05c4, 0x05c3, 0x05c3, 0x05c2, 0x05c2, 0x05c1, 0x05c1, // 29912
-    0x05c0, 0x05c0, 0x05bf, 0x05bf, 0x05be, 0x05be, 0x05bd, 0x05bc, // 29920
-    0x05bc, 0x05bb, 0x05bb, 0x05ba, 0x05ba, 0x05b9, 0x05b9, 0x05b8, // 29928
-    0x05b8, 0x05b7, 0x05b7, 0x05b6, 0x05b6, 0x05b5, 0x05b5, 0x05b4, // 29936
-    0x05b3, 0x05b3, 0x05b2, 0x05b2, 0x05b1, 0x05b1, 0x05b0, 0x05b0, // 29944
-    0x05af, 0x05af, 0x05ae, 0x05ae, 0x05ad, 0x05ad, 0x05ac, 0x05ac, // 29952
-    0x05ab, 0x05aa, 0x05aa, 0x05a9, 0x05a9, 0x05a8, 0x05a8, 0x05a7, // 29960
-    0x05a7, 0x05a6, 0x05a6, 0x05a5, 0x05a5, 0x05a4, 0x05a4, 0x05a3, // 29968
-    0x05a3, 0x05a2, 0x05a1, 0x05a1, 0x05a0, 0x05a0, 0x059f, 0x059f, // 29976
-    0x059e, 0x059e, 0x059d, 0x059d, 0x059c, 0x059c, 0x059b, 0x059b, // 29984
-    0x059a, 0x059a, 0x0599, 0x0598, 0x0598, 0x0597, 0x0597, 0x0596, // 29992
-    0x0596, 0x0595, 0x0595, 0x0594, 0x0594, 0x0593, 0x0593, 0x0592, // 30000
-    0x0592, 0x0591, 0x0591, 0x0590, 0x058f, 0x058f, 0x058e, 0x058e, // 30008
-    0x058d, 0x058d, 0x058c, 0x058c, 0x058b, 0x058b, 0x058a, 0x058a, // 30016
-    0x0589, 0x0589, 0x0588, 0x0588, 0x0587, 0x0586, 0x0586, 0x0585, // 30024
-    0x0585, 0x0584, 0x0584, 0x0583, 0x0583, 0x0582, 0x0582, 0x0581, // 30032
-    0x0581, 0x0580, 0x0580, 0x057f, 0x057f, 0x057e, 0x057d, 0x057d, // 30040
-    0x057c, 0x057c, 0x057b, 0x057b, 0x057a, 0x057a, 0x0579, 0x0579, // 30048
-    0x0578, 0x0578, 0x0577, 0x0577, 0x0576, 0x0576, 0x0575, 0x0574, // 30056
-    0x0574, 0x0573, 0x0573, 0x0572, 0x0572, 0x0571, 0x0571, 0x0570, // 30064
-    0x0570, 0x056f, 0x056f, 0x056e, 0x056e, 0x056d, 0x056d, 0x056c, // 30072
-    0x056c, 0x056b, 0x056a, 0x056a, 0x0569, 0x0569, 0x0568, 0x0568, // 30080
-    0x0567, 0x0567, 0x0566, 0x0566, 0x0565, 0x0565, 0x0564, 0x0564, // 30088
-    0x0563, 0x0563, 0x0562, 0x0561, 0x0561, 0x0560, 0x0560, 0x055f, // 30096
-    0x055f, 0x055e, 0x055e, 0x055d, 0x055d, 0x055c, 0x055c, 0x055b, // 30104
-    0x055b, 0x055a, 0x055a, 0x0559, 0x0558, 0x0558, 0x0557, 0x0557, // 30112
-    0x0556, 0x0556, 0x0555, 0x0555, 0x0554, 0x0554, 0x0553, 0x0553, // 30120
-    0x0552, 0x0552, 0x0551, 0x0551, 0x0550, 0x054f, 0x054f, 0x054e, // 30128
-    0x054e, 0x054d, 0x054d, 0x054c, 0x054c, 0x054b, 0x054b, 0x054a, // 30136
-    0x054a, 0x0549, 0x0549, 0x0548, 0x0548, 0x0547, 0x0546, 0x0546, // 30144
-    0x0545, 0x0545, 0x0544, 0x0544, 0x0543, 0x0543, 0x0542, 0x0542, // 30152
-    0x0541, 0x0541, 0x0540, 0x0540, 0x053f, 0x053f, 0x053e, 0x053d, // 30160
-    0x053d, 0x053c, 0x053c, 0x053b, 0x053b, 0x053a, 0x053a, 0x0539, // 30168
-    0x0539, 0x0538, 0x0538, 0x0537, 0x0537, 0x0536, 0x0536, 0x0535, // 30176
-    0x0534, 0x0534, 0x0533, 0x0533, 0x0532, 0x0532, 0x0531, 0x0531, // 30184
-    0x0530, 0x0530, 0x052f, 0x052f, 0x052e, 0x052e, 0x052d, 0x052d, // 30192
-    0x052c, 0x052b, 0x052b, 0x052a, 0x052a, 0x0529, 0x0529, 0x0528, // 30200
-    0x0528, 0x0527, 0x0527, 0x0526, 0x0526, 0x0525, 0x0525, 0x0524, // 30208
-    0x0524, 0x0523, 0x0522, 0x0522, 0x0521, 0x0521, 0x0520, 0x0520, // 30216
-    0x051f, 0x051f, 0x051e, 0x051e, 0x051d, 0x051d, 0x051c, 0x051c, // 30224
-    0x051b, 0x051b, 0x051a, 0x0519, 0x0519, 0x0518, 0x0518, 0x0517, // 30232
-    0x0517, 0x0516, 0x0516, 0x0515, 0x0515, 0x0514, 0x0514, 0x0513, // 30240
-    0x0513, 0x0512, 0x0512, 0x0511, 0x0510, 0x0510, 0x050f, 0x050f, // 30248
-    0x050e, 0x050e, 0x050d, 0x050d, 0x050c, 0x050c, 0x050b, 0x050b, // 30256
-    0x050a, 0x050a, 0x0509, 0x0509, 0x0508, 0x0507, 0x0507, 0x0506, // 30264
-    0x0506, 0x0505, 0x0505, 0x0504, 0x0504, 0x0503, 0x0503, 0x0502, // 30272
-    0x0502, 0x0501, 0x0501, 0x0500, 0x0500, 0x04ff, 0x04fe, 0x04fe, // 30280
-    0x04fd, 0x04fd, 0x04fc, 0x04fc, 0x04fb, 0x04fb, 0x04fa, 0x04fa, // 30288
-    0x04f9, 0x04f9, 0x04f8, 0x04f8, 0x04f7, 0x04f7, 0x04f6, 0x04f5, // 30296
-    0x04f5, 0x04f4, 0x04f4, 0x04f3, 0x04f3, 0x04f2, 0x04f2, 0x04f1, // 30304
-    0x04f1, 0x04f0, 0x04f0, 0x04ef, 0x04ef, 0x04ee, 0x04ee, 0x04ed, // 30312
-    0x04ec, 0x04ec, 0x04eb, 0x04eb, 0x04ea, 0x04ea, 0x04e9, 0x04e9, // 30320
-    0x04e8, 0x04e8, 0x04e7, 0x04e7, 0x04e6, 0x04e6, 0x04e5, 0x04e5, // 30328
-    0x04e4, 0x04e3, 0x04e3, 0x04e2, 0x04e2, 0x04e1, 0x04e1, 0x04e0, // 30336
-    0x04e0, 0x04df, 0x04df, 0x04de, 0x04de, 0x04dd, 0x04dd, 0x04dc, // 30344
-    0x04dc, 0x04db, 0x04da, 0x04da, 0x04d9, 0x04d9, 0x04d8, 0x04d8, // 30352
-    0x04d7, 0x04d7, 0x04d6, 0x04d6, 0x04d5, 0x04d5, 0x04d4, 0x04d4, // 30360
-    0x04d3, 0x04d3, 0x04d2, 0x04d1, 0x04d1, 0x04d0, 0x04d0, 0x04cf, // 30368
-    0x04cf, 0x04ce, 0x04ce, 0x04cd, 0x04cd, 0x04cc, 0x04cc, 0x04cb, // 30376
-    0x04cb, 0x04ca, 0x04ca, 0x04c9, 0x04c8, 0x04c8, 0x04c7, 0x04c7, // 30384
-    0x04c6, 0x04c6, 0x04c5, 0x04c5, 0x04c4, 0x04c4, 0x04c3, 0x04c3, // 30392
-    0x04c2, 0x04c2, 0x04c1, 0x04c1, 0x04c0, 0x04bf, 0x04bf, 0x04be, // 30400
-    0x04be, 0x04bd, 0x04bd, 0x04bc, 0x04bc, 0x04bb, 0x04bb, 0x04ba, // 30408
-    0x04ba, 0x04b9, 0x04b9, 0x04b8, 0x04b8, 0x04b7, 0x04b6, 0x04b6, // 30416
-    0x04b5, 0x04b5, 0x04b4, 0x04b4, 0x04b3, 0x04b3, 0x04b2, 0x04b2, // 30424
-    0x04b1, 0x04b1, 0x04b0, 0x04b0, 0x04af, 0x04af, 0x04ae, 0x04ad, // 30432
-    0x04ad, 0x04ac, 0x04ac, 0x04ab, 0x04ab, 0x04aa, 0x04aa, 0x04a9, // 30440
-    0x04a9, 0x04a8, 0x04a8, 0x04a7, 0x04a7, 0x04a6, 0x04a6, 0x04a5, // 30448
-    0x04a4, 0x04a4, 0x04a3, 0x04a3, 0x04a2, 0x04a2, 0x04a1, 0x04a1, // 30456
-    0x04a0, 0x04a0, 0x049f, 0x049f, 0x049e, 0x049e, 0x049d, 0x049d, // 30464
-    0x049c, 0x049b, 0x049b, 0x049a, 0x049a, 0x0499, 0x0499, 0x0498, // 30472
-    0x0498, 0x0497, 0x0497, 0x0496, 0x0496, 0x0495, 0x0495, 0x0494, // 30480
-    0x0494, 0x0493, 0x0492, 0x0492, 0x0491, 0x0491, 0x0490, 0x0490, // 30488
-    0x048f, 0x048f, 0x048e, 0x048e, 0x048d, 0x048d, 0x048c, 0x048c, // 30496
-    0x048b, 0x048b, 0x048a, 0x0489, 0x0489, 0x0488, 0x0488, 0x0487, // 30504
-    0x0487, 0x0486, 0x0486, 0x0485, 0x0485, 0x0484, 0x0484, 0x0483, // 30512
-    0x0483, 0x0482, 0x0482, 0x0481, 0x0480, 0x0480, 0x047f, 0x047f, // 30520
-    0x047e, 0x047e, 0x047d, 0x047d, 0x047c, 0x047c, 0x047b, 0x047b, // 30528
-    0x047a, 0x047a, 0x0479, 0x0479, 0x0478, 0x0477, 0x0477, 0x0476, // 30536
-    0x0476, 0x0475, 0x0475, 0x0474, 0x0474, 0x0473, 0x0473, 0x0472, // 30544
-    0x0472, 0x0471, 0x0471, 0x0470, 0x0470, 0x046f, 0x046e, 0x046e, // 30552
-    0x046d, 0x046d, 0x046c, 0x046c, 0x046b, 0x046b, 0x046a, 0x046a, // 30560
-    0x0469, 0x0469, 0x0468, 0x0468, 0x0467, 0x0467, 0x0466, 0x0465, // 30568
-    0x0465, 0x0464, 0x0464, 0x0463, 0x0463, 0x0462, 0x0462, 0x0461, // 30576
-    0x0461, 0x0460, 0x0460, 0x045f, 0x045f, 0x045e, 0x045e, 0x045d, // 30584
-    0x045d, 0x045c, 0x045b, 0x045b, 0x045a, 0x045a, 0x0459, 0x0459, // 30592
-    0x0458, 0x0458, 0x0457, 0x0457, 0x0456, 0x0456, 0x0455, 0x0455, // 30600
-    0x0454, 0x0454, 0x0453, 0x0452, 0x0452, 0x0451, 0x0451, 0x0450, // 30608
-    0x0450, 0x044f, 0x044f, 0x044e, 0x044e, 0x044d, 0x044d, 0x044c, // 30616
-    0x044c, 0x044b, 0x044b, 0x044a, 0x0449, 0x0449, 0x0448, 0x0448, // 30624
-    0x0447, 0x0447, 0x0446, 0x0446, 0x0445, 0x0445, 0x0444, 0x0444, // 30632
-    0x0443, 0x0443, 0x0442, 0x0442, 0x0441, 0x0440, 0x0440, 0x043f, // 30640
-    0x043f, 0x043e, 0x043e, 0x043d, 0x043d, 0x043c, 0x043c, 0x043b, // 30648
-    0x043b, 0x043a, 0x043a, 0x0439, 0x0439, 0x0438, 0x0437, 0x0437, // 30656
-    0x0436, 0x0436, 0x0435, 0x0435, 0x0434, 0x0434, 0x0433, 0x0433, // 30664
-    0x0432, 0x0432, 0x0431, 0x0431, 0x0430, 0x0430, 0x042f, 0x042e, // 30672
-    0x042e, 0x042d, 0x042d, 0x042c, 0x042c, 0x042b, 0x042b, 0x042a, // 30680
-    0x042a, 0x0429, 0x0429, 0x0428, 0x0428, 0x0427, 0x0427, 0x0426, // 30688
-    0x0425, 0x0425, 0x0424, 0x0424, 0x0423, 0x0423, 0x0422, 0x0422, // 30696
-    0x0421, 0x0421, 0x0420, 0x0420, 0x041f, 0x041f, 0x041e, 0x041e, // 30704
-    0x041d, 0x041c, 0x041c, 0x041b, 0x041b, 0x041a, 0x041a, 0x0419, // 30712
-    0x0418, 0x0417, 0x0416, 0x0416, 0x0415, 0x0415, 0x0414, 0x0414, // 30720
-    0x0413, 0x0413, 0x0412, 0x0412, 0x0411, 0x0411, 0x0410, 0x0410, // 30728
-    0x040f, 0x040f, 0x040e, 0x040e, 0x040d, 0x040d, 0x040c, 0x040c, // 30736
-    0x040b, 0x040b, 0x040a, 0x040a, 0x0409, 0x0408, 0x0408, 0x0407, // 30744
-    0x0407, 0x0406, 0x0406, 0x0405, 0x0405, 0x0404, 0x0404, 0x0403, // 30752
-    0x0403, 0x0402, 0x0402, 0x0401, 0x0401, 0x0400, 0x0400, 0x03ff, // 30760
-    0x03ff, 0x03fe, 0x03fe, 0x03fd, 0x03fd, 0x03fc, 0x03fc, 0x03fb, // 30768
-    0x03fb, 0x03fa, 0x03f9, 0x03f9, 0x03f8, 0x03f8, 0x03f7, 0x03f7, // 30776
-    0x03f6, 0x03f6, 0x03f5, 0x03f5, 0x03f4, 0x03f4, 0x03f3, 0x03f3, // 30784
-    0x03f2, 0x03f2, 0x03f1, 0x03f1, 0x03f0, 0x03f0, 0x03ef, 0x03ef, // 30792
-    0x03ee, 0x03ee, 0x03ed, 0x03ed, 0x03ec, 0x03ec, 0x03eb, 0x03ea, // 30800
-    0x03ea, 0x03e9, 0x03e9, 0x03e8, 0x03e8, 0x03e7, 0x03e7, 0x03e6, // 30808
-    0x03e6, 0x03e5, 0x03e5, 0x03e4, 0x03e4, 0x03e3, 0x03e3, 0x03e2, // 30816
-    0x03e2, 0x03e1, 0x03e1, 0x03e0, 0x03e0, 0x03df, 0x03df, 0x03de, // 30824
-    0x03de, 0x03dd, 0x03dc, 0x03dc, 0x03db, 0x03db, 0x03da, 0x03da, // 30832
-    0x03d9, 0x03d9, 0x03d8, 0x03d8, 0x03d7, 0x03d7, 0x03d6, 0x03d6, // 30840
-    0x03d5, 0x03d5, 0x03d4, 0x03d4, 0x03d3, 0x03d3, 0x03d2, 0x03d2, // 30848
-    0x03d1, 0x03d1, 0x03d0, 0x03d0, 0x03cf, 0x03cf, 0x03ce, 0x03cd, // 30856
-    0x03cd, 0x03cc, 0x03cc, 0x03cb, 0x03cb, 0x03ca, 0x03ca, 0x03c9, // 30864
-    0x03c9, 0x03c8, 0x03c8, 0x03c7, 0x03c7, 0x03c6, 0x03c6, 0x03c5, // 30872
-    0x03c5, 0x03c4, 0x03c4, 0x03c3, 0x03c3, 0x03c2, 0x03c2, 0x03c1, // 30880
-    0x03c1, 0x03c0, 0x03c0, 0x03bf, 0x03be, 0x03be, 0x03bd, 0x03bd, // 30888
-    0x03bc, 0x03bc, 0x03bb, 0x03bb, 0x03ba, 0x03ba, 0x03b9, 0x03b9, // 30896
-    0x03b8, 0x03b8, 0x03b7, 0x03b7, 0x03b6, 0x03b6, 0x03b5, 0x03b5, // 30904
-    0x03b4, 0x03b4, 0x03b3, 0x03b3, 0x03b2, 0x03b2, 0x03b1, 0x03b1, // 30912
-    0x03b0, 0x03af, 0x03af, 0x03ae, 0x03ae, 0x03ad, 0x03ad, 0x03ac, // 30920
-    0x03ac, 0x03ab, 0x03ab, 0x03aa, 0x03aa, 0x03a9, 0x03a9, 0x03a8, // 30928
-    0x03a8, 0x03a7, 0x03a7, 0x03a6, 0x03a6, 0x03a5, 0x03a5, 0x03a4, // 30936
-    0x03a4, 0x03a3, 0x03a3, 0x03a2, 0x03a1, 0x03a1, 0x03a0, 0x03a0, // 30944
-    0x039f, 0x039f, 0x039e, 0x039e, 0x039d, 0x039d, 0x039c, 0x039c, // 30952
-    0x039b, 0x039b, 0x039a, 0x039a, 0x0399, 0x0399, 0x0398, 0x0398, // 30960
-    0x0397, 0x0397, 0x0396, 0x0396, 0x0395, 0x0395, 0x0394, 0x0394, // 30968
-    0x0393, 0x0392, 0x0392, 0x0391, 0x0391, 0x0390, 0x0390, 0x038f, // 30976
-    0x038f, 0x038e, 0x038e, 0x038d, 0x038d, 0x038c, 0x038c, 0x038b, // 30984
-    0x038b, 0x038a, 0x038a, 0x0389, 0x0389, 0x0388, 0x0388, 0x0387, // 30992
-    0x0387, 0x0386, 0x0386, 0x0385, 0x0385, 0x0384, 0x0383, 0x0383, // 31000
-    0x0382, 0x0382, 0x0381, 0x0381, 0x0380, 0x0380, 0x037f, 0x037f, // 31008
-    0x037e, 0x037e, 0x037d, 0x037d, 0x037c, 0x037c, 0x037b, 0x037b, // 31016
-    0x037a, 0x037a, 0x0379, 0x0379, 0x0378, 0x0378, 0x0377, 0x0377, // 31024
-    0x0376, 0x0375, 0x0375, 0x0374, 0x0374, 0x0373, 0x0373, 0x0372, // 31032
-    0x0372, 0x0371, 0x0371, 0x0370, 0x0370, 0x036f, 0x036f, 0x036e, // 31040
-    0x036e, 0x036d, 0x036d, 0x036c, 0x036c, 0x036b, 0x036b, 0x036a, // 31048
-    0x036a, 0x0369, 0x0369, 0x0368, 0x0368, 0x0367, 0x0366, 0x0366, // 31056
-    0x0365, 0x0365, 0x0364, 0x0364, 0x0363, 0x0363, 0x0362, 0x0362, // 31064
-    0x0361, 0x0361, 0x0360, 0x0360, 0x035f, 0x035f, 0x035e, 0x035e, // 31072
-    0x035d, 0x035d, 0x035c, 0x035c, 0x035b, 0x035b, 0x035a, 0x035a, // 31080
-    0x0359, 0x0359, 0x0358, 0x0357, 0x0357, 0x0356, 0x0356, 0x0355, // 31088
-    0x0355, 0x0354, 0x0354, 0x0353, 0x0353, 0x0352, 0x0352, 0x0351, // 31096
-    0x0351, 0x0350, 0x0350, 0x034f, 0x034f, 0x034e, 0x034e, 0x034d, // 31104
-    0x034d, 0x034c, 0x034c, 0x034b, 0x034b, 0x034a, 0x034a, 0x0349, // 31112
-    0x0348, 0x0348, 0x0347, 0x0347, 0x0346, 0x0346, 0x0345, 0x0345, // 31120
-    0x0344, 0x0344, 0x0343, 0x0343, 0x0342, 0x0342, 0x0341, 0x0341, // 31128
-    0x0340, 0x0340, 0x033f, 0x033f, 0x033e, 0x033e, 0x033d, 0x033d, // 31136
-    0x033c, 0x033c, 0x033b, 0x033a, 0x033a, 0x0339, 0x0339, 0x0338, // 31144
-    0x0338, 0x0337, 0x0337, 0x0336, 0x0336, 0x0335, 0x0335, 0x0334, // 31152
-    0x0334, 0x0333, 0x0333, 0x0332, 0x0332, 0x0331, 0x0331, 0x0330, // 31160
-    0x0330, 0x032f, 0x032f, 0x032e, 0x032e, 0x032d, 0x032d, 0x032c, // 31168
-    0x032b, 0x032b, 0x032a, 0x032a, 0x0329, 0x0329, 0x0328, 0x0328, // 31176
-    0x0327, 0x0327, 0x0326, 0x0326, 0x0325, 0x0325, 0x0324, 0x0324, // 31184
-    0x0323, 0x0323, 0x0322, 0x0322, 0x0321, 0x0321, 0x0320, 0x0320, // 31192
-    0x031f, 0x031f, 0x031e, 0x031e, 0x031d, 0x031c, 0x031c, 0x031b, // 31200
-    0x031b, 0x031a, 0x031a, 0x0319, 0x0319, 0x0318, 0x0318, 0x0317, // 31208
-    0x0317, 0x0316, 0x0316, 0x0315, 0x0315, 0x0314, 0x0314, 0x0313, // 31216
-    0x0313, 0x0312, 0x0312, 0x0311, 0x0311, 0x0310, 0x0310, 0x030f, // 31224
-    0x030f, 0x030e, 0x030d, 0x030d, 0x030c, 0x030c, 0x030b, 0x030b, // 31232
-    0x030a, 0x030a, 0x0309, 0x0309, 0x0308, 0x0308, 0x0307, 0x0307, // 31240
-    0x0306, 0x0306, 0x0305, 0x0305, 0x0304, 0x0304, 0x0303, 0x0303, // 31248
-    0x0302, 0x0302, 0x0301, 0x0301, 0x0300, 0x02ff, 0x02ff, 0x02fe, // 31256
-    0x02fe, 0x02fd, 0x02fd, 0x02fc, 0x02fc, 0x02fb, 0x02fb, 0x02fa, // 31264
-    0x02fa, 0x02f9, 0x02f9, 0x02f8, 0x02f8, 0x02f7, 0x02f7, 0x02f6, // 31272
-    0x02f6, 0x02f5, 0x02f5, 0x02f4, 0x02f4, 0x02f3, 0x02f3, 0x02f2, // 31280
-    0x02f2, 0x02f1, 0x02f0, 0x02f0, 0x02ef, 0x02ef, 0x02ee, 0x02ee, // 31288
-    0x02ed, 0x02ed, 0x02ec, 0x02ec, 0x02eb, 0x02eb, 0x02ea, 0x02ea, // 31296
-    0x02e9, 0x02e9, 0x02e8, 0x02e8, 0x02e7, 0x02e7, 0x02e6, 0x02e6, // 31304
-    0x02e5, 0x02e5, 0x02e4, 0x02e4, 0x02e3, 0x02e3, 0x02e2, 0x02e1, // 31312
-    0x02e1, 0x02e0, 0x02e0, 0x02df, 0x02df, 0x02de, 0x02de, 0x02dd, // 31320
-    0x02dd, 0x02dc, 0x02dc, 0x02db, 0x02db, 0x02da, 0x02da, 0x02d9, // 31328
-    0x02d9, 0x02d8, 0x02d8, 0x02d7, 0x02d7, 0x02d6, 0x02d6, 0x02d5, // 31336
-    0x02d5, 0x02d4, 0x02d3, 0x02d3, 0x02d2, 0x02d2, 0x02d1, 0x02d1, // 31344
-    0x02d0, 0x02d0, 0x02cf, 0x02cf, 0x02ce, 0x02ce, 0x02cd, 0x02cd, // 31352
-    0x02cc, 0x02cc, 0x02cb, 0x02cb, 0x02ca, 0x02ca, 0x02c9, 0x02c9, // 31360
-    0x02c8, 0x02c8, 0x02c7, 0x02c7, 0x02c6, 0x02c6, 0x02c5, 0x02c4, // 31368
-    0x02c4, 0x02c3, 0x02c3, 0x02c2, 0x02c2, 0x02c1, 0x02c1, 0x02c0, // 31376
-    0x02c0, 0x02bf, 0x02bf, 0x02be, 0x02be, 0x02bd, 0x02bd, 0x02bc, // 31384
-    0x02bc, 0x02bb, 0x02bb, 0x02ba, 0x02ba, 0x02b9, 0x02b9, 0x02b8, // 31392
-    0x02b8, 0x02b7, 0x02b7, 0x02b6, 0x02b5, 0x02b5, 0x02b4, 0x02b4, // 31400
-    0x02b3, 0x02b3, 0x02b2, 0x02b2, 0x02b1, 0x02b1, 0x02b0, 0x02b0, // 31408
-    0x02af, 0x02af, 0x02ae, 0x02ae, 0x02ad, 0x02ad, 0x02ac, 0x02ac, // 31416
-    0x02ab, 0x02ab, 0x02aa, 0x02aa, 0x02a9, 0x02a9, 0x02a8, 0x02a8, // 31424
-    0x02a7, 0x02a6, 0x02a6, 0x02a5, 0x02a5, 0x02a4, 0x02a4, 0x02a3, // 31432
-    0x02a3, 0x02a2, 0x02a2, 0x02a1, 0x02a1, 0x02a0, 0x02a0, 0x029f, // 31440
-    0x029f, 0x029e, 0x029e, 0x029d, 0x029d, 0x029c, 0x029c, 0x029b, // 31448
-    0x029b, 0x029a, 0x029a, 0x0299, 0x0298, 0x0298, 0x0297, 0x0297, // 31456
-    0x0296, 0x0296, 0x0295, 0x0295, 0x0294, 0x0294, 0x0293, 0x0293, // 31464
-    0x0292, 0x0292, 0x0291, 0x0291, 0x0290, 0x0290, 0x028f, 0x028f, // 31472
-    0x028e, 0x028e, 0x028d, 0x028d, 0x028c, 0x028c, 0x028b, 0x028b, // 31480
-    0x028a, 0x0289, 0x0289, 0x0288, 0x0288, 0x0287, 0x0287, 0x0286, // 31488
-    0x0286, 0x0285, 0x0285, 0x0284, 0x0284, 0x0283, 0x0283, 0x0282, // 31496
-    0x0282, 0x0281, 0x0281, 0x0280, 0x0280, 0x027f, 0x027f, 0x027e, // 31504
-    0x027e, 0x027d, 0x027d, 0x027c, 0x027c, 0x027b, 0x027a, 0x027a, // 31512
-    0x0279, 0x0279, 0x0278, 0x0278, 0x0277, 0x0277, 0x0276, 0x0276, // 31520
-    0x0275, 0x0275, 0x0274, 0x0274, 0x0273, 0x0273, 0x0272, 0x0272, // 31528
-    0x0271, 0x0271, 0x0270, 0x0270, 0x026f, 0x026f, 0x026e, 0x026e, // 31536
-    0x026d, 0x026c, 0x026c, 0x026b, 0x026b, 0x026a, 0x026a, 0x0269, // 31544
-    0x0269, 0x0268, 0x0268, 0x0267, 0x0267, 0x0266, 0x0266, 0x0265, // 31552
-    0x0265, 0x0264, 0x0264, 0x0263, 0x0263, 0x0262, 0x0262, 0x0261, // 31560
-    0x0261, 0x0260, 0x0260, 0x025f, 0x025f, 0x025e, 0x025d, 0x025d, // 31568
-    0x025c, 0x025c, 0x025b, 0x025b, 0x025a, 0x025a, 0x0259, 0x0259, // 31576
-    0x0258, 0x0258, 0x0257, 0x0257, 0x0256, 0x0256, 0x0255, 0x0255, // 31584
-    0x0254, 0x0254, 0x0253, 0x0253, 0x0252, 0x0252, 0x0251, 0x0251, // 31592
-    0x0250, 0x0250, 0x024f, 0x024e, 0x024e, 0x024d, 0x024d, 0x024c, // 31600
-    0x024c, 0x024b, 0x024b, 0x024a, 0x024a, 0x0249, 0x0249, 0x0248, // 31608
-    0x0248, 0x0247, 0x0247, 0x0246, 0x0246, 0x0245, 0x0245, 0x0244, // 31616
-    0x0244, 0x0243, 0x0243, 0x0242, 0x0242, 0x0241, 0x0241, 0x0240, // 31624
-    0x023f, 0x023f, 0x023e, 0x023e, 0x023d, 0x023d, 0x023c, 0x023c, // 31632
-    0x023b, 0x023b, 0x023a, 0x023a, 0x0239, 0x0239, 0x0238, 0x0238, // 31640
-    0x0237, 0x0237, 0x0236, 0x0236, 0x0235, 0x0235, 0x0234, 0x0234, // 31648
-    0x0233, 0x0233, 0x0232, 0x0231, 0x0231, 0x0230, 0x0230, 0x022f, // 31656
-    0x022f, 0x022e, 0x022e, 0x022d, 0x022d, 0x022c, 0x022c, 0x022b, // 31664
-    0x022b, 0x022a, 0x022a, 0x0229, 0x0229, 0x0228, 0x0228, 0x0227, // 31672
-    0x0227, 0x0226, 0x0226, 0x0225, 0x0225, 0x0224, 0x0224, 0x0223, // 31680
-    0x0222, 0x0222, 0x0221, 0x0221, 0x0220, 0x0220, 0x021f, 0x021f, // 31688
-    0x021e, 0x021e, 0x021d, 0x021d, 0x021c, 0x021c, 0x021b, 0x021b, // 31696
-    0x021a, 0x021a, 0x0219, 0x0219, 0x0218, 0x0218, 0x0217, 0x0217, // 31704
-    0x0216, 0x0216, 0x0215, 0x0215, 0x0214, 0x0213, 0x0213, 0x0212, // 31712
-    0x0212, 0x0211, 0x0211, 0x0210, 0x0210, 0x020f, 0x020f, 0x020e, // 31720
-    0x020e, 0x020d, 0x020d, 0x020c, 0x020c, 0x020b, 0x020b, 0x020a, // 31728
-    0x020a, 0x0209, 0x0209, 0x0208, 0x0208, 0x0207, 0x0207, 0x0206, // 31736
-    0x0205, 0x0204, 0x0204, 0x0203, 0x0203, 0x0202, 0x0202, 0x0201, // 31744
-    0x0201, 0x0200, 0x0200, 0x01ff, 0x01ff, 0x01fe, 0x01fe, 0x01fd, // 31752
-    0x01fd, 0x01fc, 0x01fc, 0x01fb, 0x01fb, 0x01fa, 0x01fa, 0x01f9, // 31760
-    0x01f9, 0x01f8, 0x01f8, 0x01f7, 0x01f7, 0x01f6, 0x01f6, 0x01f5, // 31768
-    0x01f5, 0x01f4, 0x01f4, 0x01f3, 0x01f3, 0x01f2, 0x01f2, 0x01f1, // 31776
-    0x01f1, 0x01f0, 0x01f0, 0x01ef, 0x01ef, 0x01ee, 0x01ee, 0x01ed, // 31784
-    0x01ed, 0x01ec, 0x01ec, 0x01eb, 0x01eb, 0x01ea, 0x01ea, 0x01e9, // 31792
-    0x01e9, 0x01e8, 0x01e8, 0x01e7, 0x01e7, 0x01e6, 0x01e6, 0x01e5, // 31800
-    0x01e5, 0x01e4, 0x01e4, 0x01e3, 0x01e3, 0x01e2, 0x01e2, 0x01e1, // 31808
-    0x01e1, 0x01e0, 0x01e0, 0x01df, 0x01df, 0x01de, 0x01de, 0x01dd, // 31816
-    0x01dd, 0x01dc, 0x01dc, 0x01db, 0x01db, 0x01da, 0x01d9, 0x01d9, // 31824
-    0x01d8, 0x01d8, 0x01d7, 0x01d7, 0x01d6, 0x01d6, 0x01d5, 0x01d5, // 31832
-    0x01d4, 0x01d4, 0x01d3, 0x01d3, 0x01d2, 0x01d2, 0x01d1, 0x01d1, // 31840
-    0x01d0, 0x01d0, 0x01cf, 0x01cf, 0x01ce, 0x01ce, 0x01cd, 0x01cd, // 31848
-    0x01cc, 0x01cc, 0x01cb, 0x01cb, 0x01ca, 0x01ca, 0x01c9, 0x01c9, // 31856
-    0x01c8, 0x01c8, 0x01c7, 0x01c7, 0x01c6, 0x01c6, 0x01c5, 0x01c5, // 31864
-    0x01c4, 0x01c4, 0x01c3, 0x01c3, 0x01c2, 0x01c2, 0x01c1, 0x01c1, // 31872
-    0x01c0, 0x01c0, 0x01bf, 0x01bf, 0x01be, 0x01be, 0x01bd, 0x01bd, // 31880
-    0x01bc, 0x01bc, 0x01bb, 0x01bb, 0x01ba, 0x01ba, 0x01b9, 0x01b9, // 31888
-    0x01b8, 0x01b8, 0x01b7, 0x01b7, 0x01b6, 0x01b6, 0x01b5, 0x01b5, // 31896
-    0x01b4, 0x01b4, 0x01b3, 0x01b3, 0x01b2, 0x01b2, 0x01b1, 0x01b1, // 31904
-    0x01b0, 0x01b0, 0x01af, 0x01ae, 0x01ae, 0x01ad, 0x01ad, 0x01ac, // 31912
-    0x01ac, 0x01ab, 0x01ab, 0x01aa, 0x01aa, 0x01a9, 0x01a9, 0x01a8, // 31920
-    0x01a8, 0x01a7, 0x01a7, 0x01a6, 0x01a6, 0x01a5, 0x01a5, 0x01a4, // 31928
-    0x01a4, 0x01a3, 0x01a3, 0x01a2, 0x01a2, 0x01a1, 0x01a1, 0x01a0, // 31936
-    0x01a0, 0x019f, 0x019f, 0x019e, 0x019e, 0x019d, 0x019d, 0x019c, // 31944
-    0x019c, 0x019b, 0x019b, 0x019a, 0x019a, 0x0199, 0x0199, 0x0198, // 31952
-    0x0198, 0x0197, 0x0197, 0x0196, 0x0196, 0x0195, 0x0195, 0x0194, // 31960
-    0x0194, 0x0193, 0x0193, 0x0192, 0x0192, 0x0191, 0x0191, 0x0190, // 31968
-    0x0190, 0x018f, 0x018f, 0x018e, 0x018e, 0x018d, 0x018d, 0x018c, // 31976
-    0x018c, 0x018b, 0x018b, 0x018a, 0x018a, 0x0189, 0x0189, 0x0188, // 31984
-    0x0188, 0x0187, 0x0187, 0x0186, 0x0186, 0x0185, 0x0185, 0x0184, // 31992
-    0x0184, 0x0183, 0x0182, 0x0182, 0x0181, 0x0181, 0x0180, 0x0180, // 32000
-    0x017f, 0x017f, 0x017e, 0x017e, 0x017d, 0x017d, 0x017c, 0x017c, // 32008
-    0x017b, 0x017b, 0x017a, 0x017a, 0x0179, 0x0179, 0x0178, 0x0178, // 32016
-    0x0177, 0x0177, 0x0176, 0x0176, 0x0175, 0x0175, 0x0174, 0x0174, // 32024
-    0x0173, 0x0173, 0x0172, 0x0172, 0x0171, 0x0171, 0x0170, 0x0170, // 32032
-    0x016f, 0x016f, 0x016e, 0x016e, 0x016d, 0x016d, 0x016c, 0x016c, // 32040
-    0x016b, 0x016b, 0x016a, 0x016a, 0x0169, 0x0169, 0x0168, 0x0168, // 32048
-    0x0167, 0x0167, 0x0166, 0x0166, 0x0165, 0x0165, 0x0164, 0x0164, // 32056
-    0x0163, 0x0163, 0x0162, 0x0162, 0x0161, 0x0161, 0x0160, 0x0160, // 32064
-    0x015f, 0x015f, 0x015e, 0x015e, 0x015d, 0x015d, 0x015c, 0x015c, // 32072
-    0x015b, 0x015b, 0x015a, 0x015a, 0x0159, 0x0159, 0x0158, 0x0157, // 32080
-    0x0157, 0x0156, 0x0156, 0x0155, 0x0155, 0x0154, 0x0154, 0x0153, // 32088
-    0x0153, 0x0152, 0x0152, 0x0151, 0x0151, 0x0150, 0x0150, 0x014f, // 32096
-    0x014f, 0x014e, 0x014e, 0x014d, 0x014d, 0x014c, 0x014c, 0x014b, // 32104
-    0x014b, 0x014a, 0x014a, 0x0149, 0x0149, 0x0148, 0x0148, 0x0147, // 32112
-    0x0147, 0x0146, 0x0146, 0x0145, 0x0145, 0x0144, 0x0144, 0x0143, // 32120
-    0x0143, 0x0142, 0x0142, 0x0141, 0x0141, 0x0140, 0x0140, 0x013f, // 32128
-    0x013f, 0x013e, 0x013e, 0x013d, 0x013d, 0x013c, 0x013c, 0x013b, // 32136
-    0x013b, 0x013a, 0x013a, 0x0139, 0x0139, 0x0138, 0x0138, 0x0137, // 32144
-    0x0137, 0x0136, 0x0136, 0x0135, 0x0135, 0x0134, 0x0134, 0x0133, // 32152
-    0x0133, 0x0132, 0x0132, 0x0131, 0x0131, 0x0130, 0x0130, 0x012f, // 32160
-    0x012f, 0x012e, 0x012e, 0x012d, 0x012c, 0x012c, 0x012b, 0x012b, // 32168
-    0x012a, 0x012a, 0x0129, 0x0129, 0x0128, 0x0128, 0x0127, 0x0127, // 32176
-    0x0126, 0x0126, 0x0125, 0x0125, 0x0124, 0x0124, 0x0123, 0x0123, // 32184
-    0x0122, 0x0122, 0x0121, 0x0121, 0x0120, 0x0120, 0x011f, 0x011f, // 32192
-    0x011e, 0x011e, 0x011d, 0x011d, 0x011c, 0x011c, 0x011b, 0x011b, // 32200
-    0x011a, 0x011a, 0x0119, 0x0119, 0x0118, 0x0118, 0x0117, 0x0117, // 32208
-    0x0116, 0x0116, 0x0115, 0x0115, 0x0114, 0x0114, 0x0113, 0x0113, // 32216
-    0x0112, 0x0112, 0x0111, 0x0111, 0x0110, 0x0110, 0x010f, 0x010f, // 32224
-    0x010e, 0x010e, 0x010d, 0x010d, 0x010c, 0x010c, 0x010b, 0x010b, // 32232
-    0x010a, 0x010a, 0x0109, 0x0109, 0x0108, 0x0108, 0x0107, 0x0107, // 32240
-    0x0106, 0x0106, 0x0105, 0x0105, 0x0104, 0x0104, 0x0103, 0x0103, // 32248
-    0x0102, 0x0101, 0x0101, 0x0100, 0x0100, 0x00ff, 0x00ff, 0x00fe, // 32256
-    0x00fe, 0x00fd, 0x00fd, 0x00fc, 0x00fc, 0x00fb, 0x00fb, 0x00fa, // 32264
-    0x00fa, 0x00f9, 0x00f9, 0x00f8, 0x00f8, 0x00f7, 0x00f7, 0x00f6, // 32272
-    0x00f6, 0x00f5, 0x00f5, 0x00f4, 0x00f4, 0x00f3, 0x00f3, 0x00f2, // 32280
-    0x00f2, 0x00f1, 0x00f1, 0x00f0, 0x00f0, 0x00ef, 0x00ef, 0x00ee, // 32288
-    0x00ee, 0x00ed, 0x00ed, 0x00ec, 0x00ec, 0x00eb, 0x00eb, 0x00ea, // 32296
-    0x00ea, 0x00e9, 0x00e9, 0x00e8, 0x00e8, 0x00e7, 0x00e7, 0x00e6, // 32304
-    0x00e6, 0x00e5, 0x00e5, 0x00e4, 0x00e4, 0x00e3, 0x00e3, 0x00e2, // 32312
-    0x00e2, 0x00e1, 0x00e1, 0x00e0, 0x00e0, 0x00df, 0x00df, 0x00de, // 32320
-    0x00de, 0x00dd, 0x00dd, 0x00dc, 0x00dc, 0x00db, 0x00db, 0x00da, // 32328
-    0x00da, 0x00d9, 0x00d9, 0x00d8, 0x00d8, 0x00d7, 0x00d6, 0x00d6, // 32336
-    0x00d5, 0x00d5, 0x00d4, 0x00d4, 0x00d3, 0x00d3, 0x00d2, 0x00d2, // 32344
-    0x00d1, 0x00d1, 0x00d0, 0x00d0, 0x00cf, 0x00cf, 0x00ce, 0x00ce, // 32352
-    0x00cd, 0x00cd, 0x00cc, 0x00cc, 0x00cb, 0x00cb, 0x00ca, 0x00ca, // 32360
-    0x00c9, 0x00c9, 0x00c8, 0x00c8, 0x00c7, 0x00c7, 0x00c6, 0x00c6, // 32368
-    0x00c5, 0x00c5, 0x00c4, 0x00c4, 0x00c3, 0x00c3, 0x00c2, 0x00c2, // 32376
-    0x00c1, 0x00c1, 0x00c0, 0x00c0, 0x00bf, 0x00bf, 0x00be, 0x00be, // 32384
-    0x00bd, 0x00bd, 0x00bc, 0x00bc, 0x00bb, 0x00bb, 0x00ba, 0x00ba, // 32392
-    0x00b9, 0x00b9, 0x00b8, 0x00b8, 0x00b7, 0x00b7, 0x00b6, 0x00b6, // 32400
-    0x00b5, 0x00b5, 0x00b4, 0x00b4, 0x00b3, 0x00b3, 0x00b2, 0x00b2, // 32408
-    0x00b1, 0x00b1, 0x00b0, 0x00b0, 0x00af, 0x00af, 0x00ae, 0x00ae, // 32416
-    0x00ad, 0x00ad, 0x00ac, 0x00ab, 0x00ab, 0x00aa, 0x00aa, 0x00a9, // 32424
-    0x00a9, 0x00a8, 0x00a8, 0x00a7, 0x00a7, 0x00a6, 0x00a6, 0x00a5, // 32432
-    0x00a5, 0x00a4, 0x00a4, 0x00a3, 0x00a3, 0x00a2, 0x00a2, 0x00a1, // 32440
-    0x00a1, 0x00a0, 0x00a0, 0x009f, 0x009f, 0x009e, 0x009e, 0x009d, // 32448
-    0x009d, 0x009c, 0x009c, 0x009b, 0x009b, 0x009a, 0x009a, 0x0099, // 32456
-    0x0099, 0x0098, 0x0098, 0x0097, 0x0097, 0x0096, 0x0096, 0x0095, // 32464
-    0x0095, 0x0094, 0x0094, 0x0093, 0x0093, 0x0092, 0x0092, 0x0091, // 32472
-    0x0091, 0x0090, 0x0090, 0x008f, 0x008f, 0x008e, 0x008e, 0x008d, // 32480
-    0x008d, 0x008c, 0x008c, 0x008b, 0x008b, 0x008a, 0x008a, 0x0089, // 32488
-    0x0089, 0x0088, 0x0088, 0x0087, 0x0087, 0x0086, 0x0086, 0x0085, // 32496
-    0x0085, 0x0084, 0x0084, 0x0083, 0x0083, 0x0082, 0x0082, 0x0081, // 32504
-    0x0081, 0x0080, 0x007f, 0x007f, 0x007e, 0x007e, 0x007d, 0x007d, // 32512
-    0x007c, 0x007c, 0x007b, 0x007b, 0x007a, 0x007a, 0x0079, 0x0079, // 32520
-    0x0078, 0x0078, 0x0077, 0x0077, 0x0076, 0x0076, 0x0075, 0x0075, // 32528
-    0x0074, 0x0074, 0x0073, 0x0073, 0x0072, 0x0072, 0x0071, 0x0071, // 32536
-    0x0070, 0x0070, 0x006f, 0x006f, 0x006e, 0x006e, 0x006d, 0x006d, // 32544
-    0x006c, 0x006c, 0x006b, 0x006b, 0x006a, 0x006a, 0x0069, 0x0069, // 32552
-    0x0068, 0x0068, 0x0067, 0x0067, 0x0066, 0x0066, 0x0065, 0x0065, // 32560
-    0x0064, 0x0064, 0x0063, 0x0063, 0x0062, 0x0062, 0x0061, 0x0061, // 32568
-    0x0060, 0x0060, 0x005f, 0x005f, 0x005e, 0x005e, 0x005d, 0x005d, // 32576
-    0x005c, 0x005c, 0x005b, 0x005b, 0x005a, 0x005a, 0x0059, 0x0059, // 32584
-    0x0058, 0x0058, 0x0057, 0x0057, 0x0056, 0x0056, 0x0055, 0x0054, // 32592
-    0x0054, 0x0053, 0x0053, 0x0052, 0x0052, 0x0051, 0x0051, 0x0050, // 32600
-    0x0050, 0x004f, 0x004f, 0x004e, 0x004e, 0x004d, 0x004d, 0x004c, // 32608
-    0x004c, 0x004b, 0x004b, 0x004a, 0x004a, 0x0049, 0x0049, 0x0048, // 32616
-    0x0048, 0x0047, 0x0047, 0x0046, 0x0046, 0x0045, 0x0045, 0x0044, // 32624
-    0x0044, 0x0043, 0x0043, 0x0042, 0x0042, 0x0041, 0x0041, 0x0040, // 32632
-    0x0040, 0x003f, 0x003f, 0x003e, 0x003e, 0x003d, 0x003d, 0x003c, // 32640
-    0x003c, 0x003b, 0x003b, 0x003a, 0x003a, 0x0039, 0x0039, 0x0038, // 32648
-    0x0038, 0x0037, 0x0037, 0x0036, 0x0036, 0x0035, 0x0035, 0x0034, // 32656
-    0x0034, 0x0033, 0x0033, 0x0032, 0x0032, 0x0031, 0x0031, 0x0030, // 32664
-    0x0030, 0x002f, 0x002f, 0x002e, 0x002e, 0x002d, 0x002d, 0x002c, // 32672
-    0x002c, 0x002b, 0x002b, 0x002a, 0x0029, 0x0029, 0x0028, 0x0028, // 32680
-    0x0027, 0x0027, 0x0026, 0x0026, 0x0025, 0x0025, 0x0024, 0x0024, // 32688
-    0x0023, 0x0023, 0x0022, 0x0022, 0x0021, 0x0021, 0x0020, 0x0020, // 32696
-    0x001f, 0x001f, 0x001e, 0x001e, 0x001d, 0x001d, 0x001c, 0x001c, // 32704
-    0x001b, 0x001b, 0x001a, 0x001a, 0x0019, 0x0019, 0x0018, 0x0018, // 32712
-    0x0017, 0x0017, 0x0016, 0x0016, 0x0015, 0x0015, 0x0014, 0x0014, // 32720
-    0x0013, 0x0013, 0x0012, 0x0012, 0x0011, 0x0011, 0x0010, 0x0010, // 32728
-    0x000f, 0x000f, 0x000e, 0x000e, 0x000d, 0x000d, 0x000c, 0x000c, // 32736
-    0x000b, 0x000b, 0x000a, 0x000a, 0x0009, 0x0009, 0x0008, 0x0008, // 32744
-    0x0007, 0x0007, 0x0006, 0x0006, 0x0005, 0x0005, 0x0004, 0x0004, // 32752
-    0x0003, 0x0003, 0x0002, 0x0002, 0x0001, 0x0001, 0x0000, 0x0000  // 32760
-};
-
-static const Bit16u rsqrt14_table1[32768] = {
-    0xfffa, 0xfff8, 0xfff6, 0xfff4, 0xfff2, 0xfff0, 0xffee, 0xffec, //     0
-    0xffea, 0xffe8, 0xffe6, 0xffe4, 0xffe2, 0xffe0, 0xffde, 0xffdc, //     8
-    0xffda, 0xffd9, 0xffd7, 0xffd5, 0xffd3, 0xffd1, 0xffcf, 0xffcd, //    16
-    0xffcb, 0xffc9, 0xffc7, 0xffc5, 0xffc3, 0xffc1, 0xffbf, 0xffbd, //    24
-    0xffbb, 0xffb9, 0xffb7, 0xffb5, 0xffb3, 0xffb1, 0xffaf, 0xffae, //    32
-    0xffac, 0xffaa, 0xffa8, 0xffa6, 0xffa4, 0xffa2, 0xffa0, 0xff9e, //    40
-    0xff9c, 0xff9a, 0xff98, 0xff96, 0xff94, 0xff92, 0xff90, 0xff8e, //    48
-    0xff8c, 0xff8a, 0xff88, 0xff86, 0xff84, 0xff82, 0xff81, 0xff7f, //    56
-    0xff7d, 0xff7b, 0xff79, 0xff77, 0xff75, 0xff73, 0xff71, 0xff6f, //    64
-    0xff6d, 0xff6b, 0xff69, 0xff67, 0xff65, 0xff63, 0xff61, 0xff5f, //    72
-    0xff5d, 0xff5b, 0xff59, 0xff57, 0xff56, 0xff54, 0xff52, 0xff50, //    80
-    0xff4e, 0xff4c, 0xff4a, 0xff48, 0xff46, 0xff44, 0xff42, 0xff40, //    88
-    0xff3e, 0xff3c, 0xff3a, 0xff38, 0xff36, 0xff34, 0xff32, 0xff30, //    96
-    0xff2e, 0xff2c, 0xff2b, 0xff29, 0xff27, 0xff25, 0xff23, 0xff21, //   104
-    0xff1f, 0xff1d, 0xff1b, 0xff19, 0xff17, 0xff15, 0xff13, 0xff11, //   112
-    0xff0f, 0xff0d, 0xff0b, 0xff09, 0xff07, 0xff05, 0xff03, 0xff01, //   120
-    0xff00, 0xfefe, 0xfefc, 0xfefa, 0xfef8, 0xfef6, 0xfef4, 0xfef2, //   128
-    0xfef0, 0xfeee, 0xfeec, 0xfeea, 0xfee8, 0xfee6, 0xfee4, 0xfee2, //   136
-    0xfee0, 0xfede, 0xfedc, 0xfeda, 0xfed8, 0xfed6, 0xfed4, 0xfed3, //   144
-    0xfed1, 0xfecf, 0xfecd, 0xfecb, 0xfec9, 0xfec7, 0xfec5, 0xfec3, //   152
-    0xfec1, 0xfebf, 0xfebd, 0xfebb, 0xfeb9, 0xfeb7, 0xfeb5, 0xfeb3, //   160
-    0xfeb1, 0xfeaf, 0xfead, 0xfeab, 0xfea9, 0xfea8, 0xfea6, 0xfea4, //   168
-    0xfea2, 0xfea0, 0xfe9e, 0xfe9c, 0xfe9a, 0xfe98, 0xfe96, 0xfe94, //   176
-    0xfe92, 0xfe90, 0xfe8e, 0xfe8c, 0xfe8a, 0xfe88, 0xfe86, 0xfe84, //   184
-    0xfe82, 0xfe80, 0xfe7e, 0xfe7d, 0xfe7b, 0xfe79, 0xfe77, 0xfe75, //   192
-    0xfe73, 0xfe71, 0xfe6f, 0xfe6d, 0xfe6b, 0xfe69, 0xfe67, 0xfe65, //   200
-    0xfe63, 0xfe61, 0xfe5f, 0xfe5d, 0xfe5b, 0xfe59, 0xfe57, 0xfe55, //   208
-    0xfe53, 0xfe51, 0xfe50, 0xfe4e, 0xfe4c, 0xfe4a, 0xfe48, 0xfe46, //   216
-    0xfe44, 0xfe42, 0xfe40, 0xfe3e, 0xfe3c, 0xfe3a, 0xfe38, 0xfe36, //   224
-    0xfe34, 0xfe32, 0xfe30, 0xfe2e, 0xfe2c, 0xfe2a, 0xfe28, 0xfe26, //   232
-    0xfe25, 0xfe23, 0xfe21, 0xfe1f, 0xfe1d, 0xfe1b, 0xfe19, 0xfe17, //   240
-    0xfe15, 0xfe13, 0xfe11, 0xfe0f, 0xfe0d, 0xfe0b, 0xfe09, 0xfe07, //   248
-    0xfe05, 0xfe03, 0xfe01, 0xfdff, 0xfdfd, 0xfdfb, 0xfdfa, 0xfdf8, //   256
-    0xfdf6, 0xfdf4, 0xfdf2, 0xfdf0, 0xfdee, 0xfdec, 0xfdea, 0xfde8, //   264
-    0xfde6, 0xfde4, 0xfde2, 0xfde0, 0xfdde, 0xfddc, 0xfdda, 0xfdd8, //   272
-    0xfdd6, 0xfdd4, 0xfdd2, 0xfdd0, 0xfdcf, 0xfdcd, 0xfdcb, 0xfdc9, //   280
-    0xfdc7, 0xfdc5, 0xfdc3, 0xfdc1, 0xfdbf, 0xfdbd, 0xfdbb, 0xfdb9, //   288
-    0xfdb7, 0xfdb5, 0xfdb3, 0xfdb1, 0xfdaf, 0xfdad, 0xfdab, 0xfda9, //   296
-    0xfda7, 0xfda5, 0xfda3, 0xfda2, 0xfda0, 0xfd9e, 0xfd9c, 0xfd9a, //   304
-    0xfd98, 0xfd96, 0xfd94, 0xfd92, 0xfd90, 0xfd8e, 0xfd8c, 0xfd8a, //   312
-    0xfd88, 0xfd86, 0xfd84, 0xfd82, 0xfd80, 0xfd7e, 0xfd7c, 0xfd7a, //   320
-    0xfd78, 0xfd77, 0xfd75, 0xfd73, 0xfd71, 0xfd6f, 0xfd6d, 0xfd6b, //   328
-    0xfd69, 0xfd67, 0xfd65, 0xfd63, 0xfd61, 0xfd5f, 0xfd5d, 0xfd5b, //   336
-    0xfd59, 0xfd57, 0xfd55, 0xfd53, 0xfd51, 0xfd4f, 0xfd4d, 0xfd4c, //   344
-    0xfd4a, 0xfd48, 0xfd46, 0xfd44, 0xfd42, 0xfd40, 0xfd3e, 0xfd3c, //   352
-    0xfd3a, 0xfd38, 0xfd36, 0xfd34, 0xfd32, 0xfd30, 0xfd2e, 0xfd2c, //   360
-    0xfd2a, 0xfd28, 0xfd26, 0xfd24, 0xfd22, 0xfd21, 0xfd1f, 0xfd1d, //   368
-    0xfd1b, 0xfd19, 0xfd17, 0xfd15, 0xfd13, 0xfd11, 0xfd0f, 0xfd0d, //   376
-    0xfd0b, 0xfd09, 0xfd07, 0xfd05, 0xfd03, 0xfd01, 0xfcff, 0xfcfd, //   384
-    0xfcfb, 0xfcf9, 0xfcf7, 0xfcf5, 0xfcf4, 0xfcf2, 0xfcf0, 0xfcee, //   392
-    0xfcec, 0xfcea, 0xfce8, 0xfce6, 0xfce4, 0xfce2, 0xfce0, 0xfcde, //   400
-    0xfcdc, 0xfcda, 0xfcd8, 0xfcd6, 0xfcd4, 0xfcd2, 0xfcd0, 0xfcce, //   408
-    0xfccc, 0xfcca, 0xfcc9, 0xfcc7, 0xfcc5, 0xfcc3, 0xfcc1, 0xfcbf, //   416
-    0xfcbd, 0xfcbb, 0xfcb9, 0xfcb7, 0xfcb5, 0xfcb3, 0xfcb1, 0xfcaf, //   424
-    0xfcad, 0xfcab, 0xfca9, 0xfca7, 0xfca5, 0xfca3, 0xfca1, 0xfc9f, //   432
-    0xfc9e, 0xfc9c, 0xfc9a, 0xfc98, 0xfc96, 0xfc94, 0xfc92, 0xfc90, //   440
-    0xfc8e, 0xfc8c, 0xfc8a, 0xfc88, 0xfc86, 0xfc84, 0xfc82, 0xfc80, //   448
-    0xfc7e, 0xfc7c, 0xfc7a, 0xfc78, 0xfc76, 0xfc74, 0xfc73, 0xfc71, //   456
-    0xfc6f, 0xfc6d, 0xfc6b, 0xfc69, 0xfc67, 0xfc65, 0xfc63, 0xfc61, //   464
-    0xfc5f, 0xfc5d, 0xfc5b, 0xfc59, 0xfc57, 0xfc55, 0xfc53, 0xfc51, //   472
-    0xfc4f, 0xfc4d, 0xfc4b, 0xfc49, 0xfc47, 0xfc46, 0xfc44, 0xfc42, //   480
-    0xfc40, 0xfc3e, 0xfc3c, 0xfc3a, 0xfc38, 0xfc36, 0xfc34, 0xfc32, //   488
-    0xfc30, 0xfc2e, 0xfc2c, 0xfc2a, 0xfc28, 0xfc26, 0xfc24, 0xfc22, //   496
-    0xfc20, 0xfc1e, 0xfc1c, 0xfc1b, 0xfc19, 0xfc17, 0xfc15, 0xfc13, //   504
-    0xfc11, 0xfc0f, 0xfc0d, 0xfc0b, 0xfc09, 0xfc07, 0xfc05, 0xfc03, //   512
-    0xfc01, 0xfbff, 0xfbfd, 0xfbfb, 0xfbf9, 0xfbf7, 0xfbf5, 0xfbf3, //   520
-    0xfbf1, 0xfbf0, 0xfbee, 0xfbec, 0xfbea, 0xfbe8, 0xfbe6, 0xfbe4, //   528
-    0xfbe2, 0xfbe0, 0xfbde, 0xfbdc, 0xfbda, 0xfbd8, 0xfbd6, 0xfbd4, //   536
-    0xfbd2, 0xfbd0, 0xfbce, 0xfbcc, 0xfbca, 0xfbc8, 0xfbc6, 0xfbc5, //   544
-    0xfbc3, 0xfbc1, 0xfbbf, 0xfbbd, 0xfbbb, 0xfbb9, 0xfbb7, 0xfbb5, //   552
-    0xfbb3, 0xfbb1, 0xfbaf, 0xfbad, 0xfbab, 0xfba9, 0xfba7, 0xfba5, //   560
-    0xfba3, 0xfba1, 0xfb9f, 0xfb9d, 0xfb9b, 0xfb99, 0xfb98, 0xfb96, //   568
-    0xfb94, 0xfb92, 0xfb90, 0xfb8e, 0xfb8c, 0xfb8a, 0xfb88, 0xfb86, //   576
-    0xfb84, 0xfb82, 0xfb80, 0xfb7e, 0xfb7c, 0xfb7a, 0xfb78, 0xfb76, //   584
-    0xfb74, 0xfb72, 0xfb70, 0xfb6e, 0xfb6d, 0xfb6b, 0xfb69, 0xfb67, //   592
-    0xfb65, 0xfb63, 0xfb61, 0xfb5f, 0xfb5d, 0xfb5b, 0xfb59, 0xfb57, //   600
-    0xfb55, 0xfb53, 0xfb51, 0xfb4f, 0xfb4d, 0xfb4b, 0xfb49, 0xfb47, //   608
-    0xfb45, 0xfb43, 0xfb42, 0xfb40, 0xfb3e, 0xfb3c, 0xfb3a, 0xfb38, //   616
-    0xfb36, 0xfb34, 0xfb32, 0xfb30, 0xfb2e, 0xfb2c, 0xfb2a, 0xfb28, //   624
-    0xfb26, 0xfb24, 0xfb22, 0xfb20, 0xfb1e, 0xfb1c, 0xfb1a, 0xfb18, //   632
-    0xfb17, 0xfb15, 0xfb13, 0xfb11, 0xfb0f, 0xfb0d, 0xfb0b, 0xfb09, //   640
-    0xfb07, 0xfb05, 0xfb03, 0xfb01, 0xfaff, 0xfafd, 0xfafb, 0xfaf9, //   648
-    0xfaf7, 0xfaf5, 0xfaf3, 0xfaf1, 0xfaef, 0xfaed, 0xfaeb, 0xfaea, //   656
-    0xfae8, 0xfae6, 0xfae4, 0xfae2, 0xfae0, 0xfade, 0xfadc, 0xfada, //   664
-    0xfad8, 0xfad6, 0xfad4, 0xfad2, 0xfad0, 0xface, 0xfacc, 0xfaca, //   672
-    0xfac8, 0xfac6, 0xfac4, 0xfac2, 0xfac0, 0xfabf, 0xfabd, 0xfabb, //   680
-    0xfab9, 0xfab7, 0xfab5, 0xfab3, 0xfab1, 0xfaaf, 0xfaad, 0xfaab, //   688
-    0xfaa9, 0xfaa7, 0xfaa5, 0xfaa3, 0xfaa1, 0xfa9f, 0xfa9d, 0xfa9b, //   696
-    0xfa99, 0xfa97, 0xfa95, 0xfa94, 0xfa92, 0xfa90, 0xfa8e, 0xfa8c, //   704
-    0xfa8a, 0xfa88, 0xfa86, 0xfa84, 0xfa82, 0xfa80, 0xfa7e, 0xfa7c, //   712
-    0xfa7a, 0xfa78, 0xfa76, 0xfa74, 0xfa72, 0xfa70, 0xfa6e, 0xfa6c, //   720
-    0xfa6a, 0xfa68, 0xfa67, 0xfa65, 0xfa63, 0xfa61, 0xfa5f, 0xfa5d, //   728
-    0xfa5b, 0xfa59, 0xfa57, 0xfa55, 0xfa53, 0xfa51, 0xfa4f, 0xfa4d, //   736
-    0xfa4b, 0xfa49, 0xfa47, 0xfa45, 0xfa43, 0xfa41, 0xfa3f, 0xfa3d, //   744
-    0xfa3c, 0xfa3a, 0xfa38, 0xfa36, 0xfa34, 0xfa32, 0xfa30, 0xfa2e, //   752
-    0xfa2c, 0xfa2a, 0xfa28, 0xfa26, 0xfa24, 0xfa22, 0xfa20, 0xfa1e, //   760
-    0xfa1c, 0xfa1a, 0xfa18, 0xfa16, 0xfa14, 0xfa12, 0xfa11, 0xfa0f, //   768
-    0xfa0d, 0xfa0b, 0xfa09, 0xfa07, 0xfa05, 0xfa03, 0xfa01, 0xf9ff, //   776
-    0xf9fd, 0xf9fb, 0xf9f9, 0xf9f7, 0xf9f5, 0xf9f3, 0xf9f1, 0xf9ef, //   784
-    0xf9ed, 0xf9eb, 0xf9e9, 0xf9e7, 0xf9e6, 0xf9e4, 0xf9e2, 0xf9e0, //   792
-    0xf9de, 0xf9dc, 0xf9da, 0xf9d8, 0xf9d6, 0xf9d4, 0xf9d2, 0xf9d0, //   800
-    0xf9ce, 0xf9cc, 0xf9ca, 0xf9c8, 0xf9c6, 0xf9c4, 0xf9c2, 0xf9c0, //   808
-    0xf9be, 0xf9bc, 0xf9ba, 0xf9b9, 0xf9b7, 0xf9b5, 0xf9b3, 0xf9b1, //   816
-    0xf9af, 0xf9ad, 0xf9ab, 0xf9a9, 0xf9a7, 0xf9a5, 0xf9a3, 0xf9a1, //   824
-    0xf99f, 0xf99d, 0xf99b, 0xf999, 0xf997, 0xf995, 0xf993, 0xf991, //   832
-    0xf98f, 0xf98e, 0xf98c, 0xf98a, 0xf988, 0xf986, 0xf984, 0xf982, //   840
-    0xf980, 0xf97e, 0xf97c, 0xf97a, 0xf978, 0xf976, 0xf974, 0xf972, //   848
-    0xf970, 0xf96e, 0xf96c, 0xf96a, 0xf968, 0xf966, 0xf964, 0xf963, //   856
-    0xf961, 0xf95f, 0xf95d, 0xf95b, 0xf959, 0xf957, 0xf955, 0xf953, //   864
-    0xf951, 0xf94f, 0xf94d, 0xf94b, 0xf949, 0xf947, 0xf945, 0xf943, //   872
-    0xf941, 0xf93f, 0xf93d, 0xf93b, 0xf939, 0xf938, 0xf936, 0xf934, //   880
-    0xf932, 0xf930, 0xf92e, 0xf92c, 0xf92a, 0xf928, 0xf926, 0xf924, //   888
-    0xf922, 0xf920, 0xf91e, 0xf91c, 0xf91a, 0xf918, 0xf916, 0xf914, //   896
-    0xf912, 0xf910, 0xf90e, 0xf90c, 0xf90b, 0xf909, 0xf907, 0xf905, //   904
-    0xf903, 0xf901, 0xf8ff, 0xf8fd, 0xf8fb, 0xf8f9, 0xf8f7, 0xf8f5, //   912
-    0xf8f3, 0xf8f1, 0xf8ef, 0xf8ed, 0xf8eb, 0xf8e9, 0xf8e7, 0xf8e5, //   920
-    0xf8e3, 0xf8e1, 0xf8e0, 0xf8de, 0xf8dc, 0xf8da, 0xf8d8, 0xf8d6, //   928
-    0xf8d4, 0xf8d2, 0xf8d0, 0xf8ce, 0xf8cc, 0xf8ca, 0xf8c8, 0xf8c6, //   936
-    0xf8c4, 0xf8c2, 0xf8c0, 0xf8be, 0xf8bc, 0xf8ba, 0xf8b8, 0xf8b6, //   944
-    0xf8b5, 0xf8b3, 0xf8b1, 0xf8af, 0xf8ad, 0xf8ab, 0xf8a9, 0xf8a7, //   952
-    0xf8a5, 0xf8a3, 0xf8a1, 0xf89f, 0xf89d, 0xf89b, 0xf899, 0xf897, //   960
-    0xf895, 0xf893, 0xf891, 0xf88f, 0xf88d, 0xf88b, 0xf88a, 0xf888, //   968
-    0xf886, 0xf884, 0xf882, 0xf880, 0xf87e, 0xf87c, 0xf87a, 0xf878, //   976
-    0xf876, 0xf874, 0xf872, 0xf870, 0xf86e, 0xf86c, 0xf86a, 0xf868, //   984
-    0xf866, 0xf864, 0xf862, 0xf860, 0xf85e, 0xf85d, 0xf85b, 0xf859, //   992
-    0xf857, 0xf855, 0xf853, 0xf851, 0xf84f, 0xf84d, 0xf84b, 0xf849, //  1000
-    0xf847, 0xf845, 0xf843, 0xf841, 0xf83f, 0xf83d, 0xf83b, 0xf839, //  1008
-    0xf837, 0xf835, 0xf833, 0xf832, 0xf830, 0xf82e, 0xf82c, 0xf82a, //  1016
-    0xf828, 0xf826, 0xf824, 0xf822, 0xf820, 0xf81e, 0xf81d, 0xf81b, //  1024
-    0xf819, 0xf817, 0xf815, 0xf813, 0xf811, 0xf810, 0xf80e, 0xf80c, //  1032
-    0xf80a, 0xf808, 0xf806, 0xf804, 0xf802, 0xf801, 0xf7ff, 0xf7fd, //  1040
-    0xf7fb, 0xf7f9, 0xf7f7, 0xf7f5, 0xf7f4, 0xf7f2, 0xf7f0, 0xf7ee, //  1048
-    0xf7ec, 0xf7ea, 0xf7e8, 0xf7e6, 0xf7e5, 0xf7e3, 0xf7e1, 0xf7df, //  1056
-    0xf7dd, 0xf7db, 0xf7d9, 0xf7d8, 0xf7d6, 0xf7d4, 0xf7d2, 0xf7d0, //  1064
-    0xf7ce, 0xf7cc, 0xf7ca, 0xf7c9, 0xf7c7, 0xf7c5, 0xf7c3, 0xf7c1, //  1072
-    0xf7bf, 0xf7bd, 0xf7bc, 0xf7ba, 0xf7b8, 0xf7b6, 0xf7b4, 0xf7b2, //  1080
-    0xf7b0, 0xf7af, 0xf7ad, 0xf7ab, 0xf7a9, 0xf7a7, 0xf7a5, 0xf7a3, //  1088
-    0xf7a1, 0xf7a0, 0xf79e, 0xf79c, 0xf79a, 0xf798, 0xf796, 0xf794, //  1096
-    0xf793, 0xf791, 0xf78f, 0xf78d, 0xf78b, 0xf789, 0xf787, 0xf785, //  1104
-    0xf784, 0xf782, 0xf780, 0xf77e, 0xf77c, 0xf77a, 0xf778, 0xf777, //  1112
-    0xf775, 0xf773, 0xf771, 0xf76f, 0xf76d, 0xf76b, 0xf769, 0xf768, //  1120
-    0xf766, 0xf764, 0xf762, 0xf760, 0xf75e, 0xf75c, 0xf75b, 0xf759, //  1128
-    0xf757, 0xf755, 0xf753, 0xf751, 0xf74f, 0xf74e, 0xf74c, 0xf74a, //  1136
-    0xf748, 0xf746, 0xf744, 0xf742, 0xf740, 0xf73f, 0xf73d, 0xf73b, //  1144
-    0xf739, 0xf737, 0xf735, 0xf733, 0xf732, 0xf730, 0xf72e, 0xf72c, //  1152
-    0xf72a, 0xf728, 0xf726, 0xf724, 0xf723, 0xf721, 0xf71f, 0xf71d, //  1160
-    0xf71b, 0xf719, 0xf717, 0xf716, 0xf714, 0xf712, 0xf710, 0xf70e, //  1168
-    0xf70c, 0xf70a, 0xf709, 0xf707, 0xf705, 0xf703, 0xf701, 0xf6ff, //  1176
-    0xf6fd, 0xf6fb, 0xf6fa, 0xf6f8, 0xf6f6, 0xf6f4, 0xf6f2, 0xf6f0, //  1184
-    0xf6ee, 0xf6ed, 0xf6eb, 0xf6e9, 0xf6e7, 0xf6e5, 0xf6e3, 0xf6e1, //  1192
-    0xf6df, 0xf6de, 0xf6dc, 0xf6da, 0xf6d8, 0xf6d6, 0xf6d4, 0xf6d2, //  1200
-    0xf6d1, 0xf6cf, 0xf6cd, 0xf6cb, 0xf6c9, 0xf6c7, 0xf6c5, 0xf6c3, //  1208
-    0xf6c2, 0xf6c0, 0xf6be, 0xf6bc, 0xf6ba, 0xf6b8, 0xf6b6, 0xf6b5, //  1216
-    0xf6b3, 0xf6b1, 0xf6af, 0xf6ad, 0xf6ab, 0xf6a9, 0xf6a8, 0xf6a6, //  1224
-    0xf6a4, 0xf6a2, 0xf6a0, 0xf69e, 0xf69c, 0xf69a, 0xf699, 0xf697, //  1232
-    0xf695, 0xf693, 0xf691, 0xf68f, 0xf68d, 0xf68c, 0xf68a, 0xf688, //  1240
-    0xf686, 0xf684, 0xf682, 0xf680, 0xf67e, 0xf67d, 0xf67b, 0xf679, //  1248
-    0xf677, 0xf675, 0xf673, 0xf671, 0xf670, 0xf66e, 0xf66c, 0xf66a, //  1256
-    0xf668, 0xf666, 0xf664, 0xf662, 0xf661, 0xf65f, 0xf65d, 0xf65b, //  1264
-    0xf659, 0xf657, 0xf655, 0xf654, 0xf652, 0xf650, 0xf64e, 0xf64c, //  1272
-    0xf64a, 0xf648, 0xf647, 0xf645, 0xf643, 0xf641, 0xf63f, 0xf63d, //  1280
-    0xf63b, 0xf639, 0xf638, 0xf636, 0xf634, 0xf632, 0xf630, 0xf62e, //  1288
-    0xf62c, 0xf62b, 0xf629, 0xf627, 0xf625, 0xf623, 0xf621, 0xf61f, //  1296
-    0xf61d, 0xf61c, 0xf61a, 0xf618, 0xf616, 0xf614, 0xf612, 0xf610, //  1304
-    0xf60f, 0xf60d, 0xf60b, 0xf609, 0xf607, 0xf605, 0xf603, 0xf602, //  1312
-    0xf600, 0xf5fe, 0xf5fc, 0xf5fa, 0xf5f8, 0xf5f6, 0xf5f4, 0xf5f3, //  1320
-    0xf5f1, 0xf5ef, 0xf5ed, 0xf5eb, 0xf5e9, 0xf5e7, 0xf5e6, 0xf5e4, //  1328
-    0xf5e2, 0xf5e0, 0xf5de, 0xf5dc, 0xf5da, 0xf5d8, 0xf5d7, 0xf5d5, //  1336
-    0xf5d3, 0xf5d1, 0xf5cf, 0xf5cd, 0xf5cb, 0xf5ca, 0xf5c8, 0xf5c6, //  1344
-    0xf5c4, 0xf5c2, 0xf5c0, 0xf5be, 0xf5bc, 0xf5bb, 0xf5b9, 0xf5b7, //  1352
-    0xf5b5, 0xf5b3, 0xf5b1, 0xf5af, 0xf5ae, 0xf5ac, 0xf5aa, 0xf5a8, //  1360
-    0xf5a6, 0xf5a4, 0xf5a2, 0xf5a1, 0xf59f, 0xf59d, 0xf59b, 0xf599, //  1368
-    0xf597, 0xf595, 0xf593, 0xf592, 0xf590, 0xf58e, 0xf58c, 0xf58a, //  1376
-    0xf588, 0xf586, 0xf585, 0xf583, 0xf581, 0xf57f, 0xf57d, 0xf57b, //  1384
-    0xf579, 0xf577, 0xf576, 0xf574, 0xf572, 0xf570, 0xf56e, 0xf56c, //  1392
-    0xf56a, 0xf569, 0xf567, 0xf565, 0xf563, 0xf561, 0xf55f, 0xf55d, //  1400
-    0xf55c, 0xf55a, 0xf558, 0xf556, 0xf554, 0xf552, 0xf550, 0xf54e, //  1408
-    0xf54d, 0xf54b, 0xf549, 0xf547, 0xf545, 0xf543, 0xf541, 0xf540, //  1416
-    0xf53e, 0xf53c, 0xf53a, 0xf538, 0xf536, 0xf534, 0xf532, 0xf531, //  1424
-    0xf52f, 0xf52d, 0xf52b, 0xf529, 0xf527, 0xf525, 0xf524, 0xf522, //  1432
-    0xf520, 0xf51e, 0xf51c, 0xf51a, 0xf518, 0xf516, 0xf515, 0xf513, //  1440
-    0xf511, 0xf50f, 0xf50d, 0xf50b, 0xf509, 0xf508, 0xf506, 0xf504, //  1448
-    0xf502, 0xf500, 0xf4fe, 0xf4fc, 0xf4fb, 0xf4f9, 0xf4f7, 0xf4f5, //  1456
-    0xf4f3, 0xf4f1, 0xf4ef, 0xf4ed, 0xf4ec, 0xf4ea, 0xf4e8, 0xf4e6, //  1464
-    0xf4e4, 0xf4e2, 0xf4e0, 0xf4df, 0xf4dd, 0xf4db, 0xf4d9, 0xf4d7, //  1472
-    0xf4d5, 0xf4d3, 0xf4d1, 0xf4d0, 0xf4ce, 0xf4cc, 0xf4ca, 0xf4c8, //  1480
-    0xf4c6, 0xf4c4, 0xf4c3, 0xf4c1, 0xf4bf, 0xf4bd, 0xf4bb, 0xf4b9, //  1488
-    0xf4b7, 0xf4b5, 0xf4b4, 0xf4b2, 0xf4b0, 0xf4ae, 0xf4ac, 0xf4aa, //  1496
-    0xf4a8, 0xf4a7, 0xf4a5, 0xf4a3, 0xf4a1, 0xf49f, 0xf49d, 0xf49b, //  1504
-    0xf49a, 0xf498, 0xf496, 0xf494, 0xf492, 0xf490, 0xf48e, 0xf48c, //  1512
-    0xf48b, 0xf489, 0xf487, 0xf485, 0xf483, 0xf481, 0xf47f, 0xf47e, //  1520
-    0xf47c, 0xf47a, 0xf478, 0xf476, 0xf474, 0xf472, 0xf470, 0xf46f, //  1528
-    0xf46d, 0xf46b, 0xf469, 0xf467, 0xf465, 0xf463, 0xf462, 0xf460, //  1536
-    0xf45e, 0xf45c, 0xf45a, 0xf458, 0xf456, 0xf455, 0xf453, 0xf451, //  1544
-    0xf44f, 0xf44d, 0xf44b, 0xf449, 0xf447, 0xf446, 0xf444, 0xf442, //  1552
-    0xf440, 0xf43e, 0xf43c, 0xf43a, 0xf439, 0xf437, 0xf435, 0xf433, //  1560
-    0xf431, 0xf42f, 0xf42d, 0xf42b, 0xf42a, 0xf428, 0xf426, 0xf424, //  1568
-    0xf422, 0xf420, 0xf41e, 0xf41d, 0xf41b, 0xf419, 0xf417, 0xf415, //  1576
-    0xf413, 0xf411, 0xf40f, 0xf40e, 0xf40c, 0xf40a, 0xf408, 0xf406, //  1584
-    0xf404, 0xf402, 0xf401, 0xf3ff, 0xf3fd, 0xf3fb, 0xf3f9, 0xf3f7, //  1592
-    0xf3f5, 0xf3f4, 0xf3f2, 0xf3f0, 0xf3ee, 0xf3ec, 0xf3ea, 0xf3e8, //  1600
-    0xf3e6, 0xf3e5, 0xf3e3, 0xf3e1, 0xf3df, 0xf3dd, 0xf3db, 0xf3d9, //  1608
-    0xf3d8, 0xf3d6, 0xf3d4, 0xf3d2, 0xf3d0, 0xf3ce, 0xf3cc, 0xf3ca, //  1616
-    0xf3c9, 0xf3c7, 0xf3c5, 0xf3c3, 0xf3c1, 0xf3bf, 0xf3bd, 0xf3bc, //  1624
-    0xf3ba, 0xf3b8, 0xf3b6, 0xf3b4, 0xf3b2, 0xf3b0, 0xf3ae, 0xf3ad, //  1632
-    0xf3ab, 0xf3a9, 0xf3a7, 0xf3a5, 0xf3a3, 0xf3a1, 0xf3a0, 0xf39e, //  1640
-    0xf39c, 0xf39a, 0xf398, 0xf396, 0xf394, 0xf393, 0xf391, 0xf38f, //  1648
-    0xf38d, 0xf38b, 0xf389, 0xf387, 0xf385, 0xf384, 0xf382, 0xf380, //  1656
-    0xf37e, 0xf37c, 0xf37a, 0xf378, 0xf377, 0xf375, 0xf373, 0xf371, //  1664
-    0xf36f, 0xf36d, 0xf36b, 0xf369, 0xf368, 0xf366, 0xf364, 0xf362, //  1672
-    0xf360, 0xf35e, 0xf35c, 0xf35b, 0xf359, 0xf357, 0xf355, 0xf353, //  1680
-    0xf351, 0xf34f, 0xf34e, 0xf34c, 0xf34a, 0xf348, 0xf346, 0xf344, //  1688
-    0xf342, 0xf340, 0xf33f, 0xf33d, 0xf33b, 0xf339, 0xf337, 0xf335, //  1696
-    0xf333, 0xf332, 0xf330, 0xf32e, 0xf32c, 0xf32a, 0xf328, 0xf326, //  1704
-    0xf324, 0xf323, 0xf321, 0xf31f, 0xf31d, 0xf31b, 0xf319, 0xf317, //  1712
-    0xf316, 0xf314, 0xf312, 0xf310, 0xf30e, 0xf30c, 0xf30a, 0xf308, //  1720
-    0xf307, 0xf305, 0xf303, 0xf301, 0xf2ff, 0xf2fd, 0xf2fb, 0xf2fa, //  1728
-    0xf2f8, 0xf2f6, 0xf2f4, 0xf2f2, 0xf2f0, 0xf2ee, 0xf2ed, 0xf2eb, //  1736
-    0xf2e9, 0xf2e7, 0xf2e5, 0xf2e3, 0xf2e1, 0xf2df, 0xf2de, 0xf2dc, //  1744
-    0xf2da, 0xf2d8, 0xf2d6, 0xf2d4, 0xf2d2, 0xf2d1, 0xf2cf, 0xf2cd, //  1752
-    0xf2cb, 0xf2c9, 0xf2c7, 0xf2c5, 0xf2c3, 0xf2c2, 0xf2c0, 0xf2be, //  1760
-    0xf2bc, 0xf2ba, 0xf2b8, 0xf2b6, 0xf2b5, 0xf2b3, 0xf2b1, 0xf2af, //  1768
-    0xf2ad, 0xf2ab, 0xf2a9, 0xf2a7, 0xf2a6, 0xf2a4, 0xf2a2, 0xf2a0, //  1776
-    0xf29e, 0xf29c, 0xf29a, 0xf299, 0xf297, 0xf295, 0xf293, 0xf291, //  1784
-    0xf28f, 0xf28d, 0xf28c, 0xf28a, 0xf288, 0xf286, 0xf284, 0xf282, //  1792
-    0xf280, 0xf27e, 0xf27d, 0xf27b, 0xf279, 0xf277, 0xf275, 0xf273, //  1800
-    0xf271, 0xf270, 0xf26e, 0xf26c, 0xf26a, 0xf268, 0xf266, 0xf264, //  1808
-    0xf262, 0xf261, 0xf25f, 0xf25d, 0xf25b, 0xf259, 0xf257, 0xf255, //  1816
-    0xf254, 0xf252, 0xf250, 0xf24e, 0xf24c, 0xf24a, 0xf248, 0xf247, //  1824
-    0xf245, 0xf243, 0xf241, 0xf23f, 0xf23d, 0xf23b, 0xf239, 0xf238, //  1832
-    0xf236, 0xf234, 0xf232, 0xf230, 0xf22e, 0xf22c, 0xf22b, 0xf229, //  1840
-    0xf227, 0xf225, 0xf223, 0xf221, 0xf21f, 0xf21d, 0xf21c, 0xf21a, //  1848
-    0xf218, 0xf216, 0xf214, 0xf212, 0xf210, 0xf20f, 0xf20d, 0xf20b, //  1856
-    0xf209, 0xf207, 0xf205, 0xf203, 0xf201, 0xf200, 0xf1fe, 0xf1fc, //  1864
-    0xf1fa, 0xf1f8, 0xf1f6, 0xf1f4, 0xf1f3, 0xf1f1, 0xf1ef, 0xf1ed, //  1872
-    0xf1eb, 0xf1e9, 0xf1e7, 0xf1e6, 0xf1e4, 0xf1e2, 0xf1e0, 0xf1de, //  1880
-    0xf1dc, 0xf1da, 0xf1d8, 0xf1d7, 0xf1d5, 0xf1d3, 0xf1d1, 0xf1cf, //  1888
-    0xf1cd, 0xf1cb, 0xf1ca, 0xf1c8, 0xf1c6, 0xf1c4, 0xf1c2, 0xf1c0, //  1896
-    0xf1be, 0xf1bc, 0xf1bb, 0xf1b9, 0xf1b7, 0xf1b5, 0xf1b3, 0xf1b1, //  1904
-    0xf1af, 0xf1ae, 0xf1ac, 0xf1aa, 0xf1a8, 0xf1a6, 0xf1a4, 0xf1a2, //  1912
-    0xf1a1, 0xf19f, 0xf19d, 0xf19b, 0xf199, 0xf197, 0xf195, 0xf193, //  1920
-    0xf192, 0xf190, 0xf18e, 0xf18c, 0xf18a, 0xf188, 0xf186, 0xf185, //  1928
-    0xf183, 0xf181, 0xf17f, 0xf17d, 0xf17b, 0xf179, 0xf177, 0xf176, //  1936
-    0xf174, 0xf172, 0xf170, 0xf16e, 0xf16c, 0xf16a, 0xf169, 0xf167, //  1944
-    0xf165, 0xf163, 0xf161, 0xf15f, 0xf15d, 0xf15b, 0xf15a, 0xf158, //  1952
-    0xf156, 0xf154, 0xf152, 0xf150, 0xf14e, 0xf14d, 0xf14b, 0xf149, //  1960
-    0xf147, 0xf145, 0xf143, 0xf141, 0xf140, 0xf13e, 0xf13c, 0xf13a, //  1968
-    0xf138, 0xf136, 0xf134, 0xf132, 0xf131, 0xf12f, 0xf12d, 0xf12b, //  1976
-    0xf129, 0xf127, 0xf125, 0xf124, 0xf122, 0xf120, 0xf11e, 0xf11c, //  1984
-    0xf11a, 0xf118, 0xf116, 0xf115, 0xf113, 0xf111, 0xf10f, 0xf10d, //  1992
-    0xf10b, 0xf109, 0xf108, 0xf106, 0xf104, 0xf102, 0xf100, 0xf0fe, //  2000
-    0xf0fc, 0xf0fa, 0xf0f9, 0xf0f7, 0xf0f5, 0xf0f3, 0xf0f1, 0xf0ef, //  2008
-    0xf0ed, 0xf0ec, 0xf0ea, 0xf0e8, 0xf0e6, 0xf0e4, 0xf0e2, 0xf0e0, //  2016
-    0xf0df, 0xf0dd, 0xf0db, 0xf0d9, 0xf0d7, 0xf0d5, 0xf0d3, 0xf0d1, //  2024
-    0xf0d0, 0xf0ce, 0xf0cc, 0xf0ca, 0xf0c8, 0xf0c6, 0xf0c4, 0xf0c3, //  2032
-    0xf0c1, 0xf0bf, 0xf0bd, 0xf0bb, 0xf0b9, 0xf0b7, 0xf0b5, 0xf0b4, //  2040
-    0xf0b1, 0xf0af, 0xf0ad, 0xf0ab, 0xf0aa, 0xf0a8, 0xf0a6, 0xf0a4, //  2048
-    0xf0a2, 0xf0a1, 0xf09f, 0xf09d, 0xf09b, 0xf09a, 0xf098, 0xf096, //  2056
-    0xf094, 0xf092, 0xf091, 0xf08f, 0xf08d, 0xf08b, 0xf089, 0xf088, //  2064
-    0xf086, 0xf084, 0xf082, 0xf080, 0xf07f, 0xf07d, 0xf07b, 0xf079, //  2072
-    0xf078, 0xf076, 0xf074, 0xf072, 0xf070, 0xf06f, 0xf06d, 0xf06b, //  2080
-    0xf069, 0xf067, 0xf066, 0xf064, 0xf062, 0xf060, 0xf05f, 0xf05d, //  2088
-    0xf05b, 0xf059, 0xf057, 0xf056, 0xf054, 0xf052, 0xf050, 0xf04e, //  2096
-    0xf04d, 0xf04b, 0xf049, 0xf047, 0xf046, 0xf044, 0xf042, 0xf040, //  2104
-    0xf03e, 0xf03d, 0xf03b, 0xf039, 0xf037, 0xf035, 0xf034, 0xf032, //  2112
-    0xf030, 0xf02e, 0xf02d, 0xf02b, 0xf029, 0xf027, 0xf025, 0xf024, //  2120
-    0xf022, 0xf020, 0xf01e, 0xf01c, 0xf01b, 0xf019, 0xf017, 0xf015, //  2128
-    0xf013, 0xf012, 0xf010, 0xf00e, 0xf00c, 0xf00b, 0xf009, 0xf007, //  2136
-    0xf005, 0xf003, 0xf002, 0xf000, 0xeffe, 0xeffc, 0xeffa, 0xeff9, //  2144
-    0xeff7, 0xeff5, 0xeff3, 0xeff2, 0xeff0, 0xefee, 0xefec, 0xefea, //  2152
-    0xefe9, 0xefe7, 0xefe5, 0xefe3, 0xefe1, 0xefe0, 0xefde, 0xefdc, //  2160
-    0xefda, 0xefd9, 0xefd7, 0xefd5, 0xefd3, 0xefd1, 0xefd0, 0xefce, //  2168
-    0xefcc, 0xefca, 0xefc8, 0xefc7, 0xefc5, 0xefc3, 0xefc1, 0xefbf, //  2176
-    0xefbe, 0xefbc, 0xefba, 0xefb8, 0xefb7, 0xefb5, 0xefb3, 0xefb1, //  2184
-    0xefaf, 0xefae, 0xefac, 0xefaa, 0xefa8, 0xefa6, 0xefa5, 0xefa3, //  2192
-    0xefa1, 0xef9f, 0xef9e, 0xef9c, 0xef9a, 0xef98, 0xef96, 0xef95, //  2200
-    0xef93, 0xef91, 0xef8f, 0xef8d, 0xef8c, 0xef8a, 0xef88, 0xef86, //  2208
-    0xef85, 0xef83, 0xef81, 0xef7f, 0xef7d, 0xef7c, 0xef7a, 0xef78, //  2216
-    0xef76, 0xef74, 0xef73, 0xef71, 0xef6f, 0xef6d, 0xef6b, 0xef6a, //  2224
-    0xef68, 0xef66, 0xef64, 0xef63, 0xef61, 0xef5f, 0xef5d, 0xef5b, //  2232
-    0xef5a, 0xef58, 0xef56, 0xef54, 0xef52, 0xef51, 0xef4f, 0xef4d, //  2240
-    0xef4b, 0xef4a, 0xef48, 0xef46, 0xef44, 0xef42, 0xef41, 0xef3f, //  2248
-    0xef3d, 0xef3b, 0xef39, 0xef38, 0xef36, 0xef34, 0xef32, 0xef31, //  2256
-    0xef2f, 0xef2d, 0xef2b, 0xef29, 0xef28, 0xef26, 0xef24, 0xef22, //  2264
-    0xef20, 0xef1f, 0xef1d, 0xef1b, 0xef19, 0xef18, 0xef16, 0xef14, //  2272
-    0xef12, 0xef10, 0xef0f, 0xef0d, 0xef0b, 0xef09, 0xef07, 0xef06, //  2280
-    0xef04, 0xef02, 0xef00, 0xeefe, 0xeefd, 0xeefb, 0xeef9, 0xeef7, //  2288
-    0xeef6, 0xeef4, 0xeef2, 0xeef0, 0xeeee, 0xeeed, 0xeeeb, 0xeee9, //  2296
-    0xeee7, 0xeee5, 0xeee4, 0xeee2, 0xeee0, 0xeede, 0xeedd, 0xeedb, //  2304
-    0xeed9, 0xeed7, 0xeed5, 0xeed4, 0xeed2, 0xeed0, 0xeece, 0xeecc, //  2312
-    0xeecb, 0xeec9, 0xeec7, 0xeec5, 0xeec4, 0xeec2, 0xeec0, 0xeebe, //  2320
-    0xeebc, 0xeebb, 0xeeb9, 0xeeb7, 0xeeb5, 0xeeb3, 0xeeb2, 0xeeb0, //  2328
-    0xeeae, 0xeeac, 0xeeaa, 0xeea9, 0xeea7, 0xeea5, 0xeea3, 0xeea2, //  2336
-    0xeea0, 0xee9e, 0xee9c, 0xee9a, 0xee99, 0xee97, 0xee95, 0xee93, //  2344
-    0xee91, 0xee90, 0xee8e, 0xee8c, 0xee8a, 0xee89, 0xee87, 0xee85, //  2352
-    0xee83, 0xee81, 0xee80, 0xee7e, 0xee7c, 0xee7a, 0xee78, 0xee77, //  2360
-    0xee75, 0xee73, 0xee71, 0xee70, 0xee6e, 0xee6c, 0xee6a, 0xee68, //  2368
-    0xee67, 0xee65, 0xee63, 0xee61, 0xee5f, 0xee5e, 0xee5c, 0xee5a, //  2376
-    0xee58, 0xee56, 0xee55, 0xee53, 0xee51, 0xee4f, 0xee4e, 0xee4c, //  2384
-    0xee4a, 0xee48, 0xee46, 0xee45, 0xee43, 0xee41, 0xee3f, 0xee3d, //  2392
-    0xee3c, 0xee3a, 0xee38, 0xee36, 0xee35, 0xee33, 0xee31, 0xee2f, //  2400
-    0xee2d, 0xee2c, 0xee2a, 0xee28, 0xee26, 0xee24, 0xee23, 0xee21, //  2408
-    0xee1f, 0xee1d, 0xee1c, 0xee1a, 0xee18, 0xee16, 0xee14, 0xee13, //  2416
-    0xee11, 0xee0f, 0xee0d, 0xee0b, 0xee0a, 0xee08, 0xee06, 0xee04, //  2424
-    0xee03, 0xee01, 0xedff, 0xedfd, 0xedfb, 0xedfa, 0xedf8, 0xedf6, //  2432
-    0xedf4, 0xedf2, 0xedf1, 0xedef, 0xeded, 0xedeb, 0xede9, 0xede8, //  2440
-    0xede6, 0xede4, 0xede2, 0xede1, 0xeddf, 0xeddd, 0xeddb, 0xedd9, //  2448
-    0xedd8, 0xedd6, 0xedd4, 0xedd2, 0xedd0, 0xedcf, 0xedcd, 0xedcb, //  2456
-    0xedc9, 0xedc8, 0xedc6, 0xedc4, 0xedc2, 0xedc0, 0xedbf, 0xedbd, //  2464
-    0xedbb, 0xedb9, 0xedb7, 0xedb6, 0xedb4, 0xedb2, 0xedb0, 0xedaf, //  2472
-    0xedad, 0xedab, 0xeda9, 0xeda7, 0xeda6, 0xeda4, 0xeda2, 0xeda0, //  2480
-    0xed9e, 0xed9d, 0xed9b, 0xed99, 0xed97, 0xed95, 0xed94, 0xed92, //  2488
-    0xed90, 0xed8e, 0xed8d, 0xed8b, 0xed89, 0xed87, 0xed85, 0xed84, //  2496
-    0xed82, 0xed80, 0xed7e, 0xed7c, 0xed7b, 0xed79, 0xed77, 0xed75, //  2504
-    0xed74, 0xed72, 0xed70, 0xed6e, 0xed6c, 0xed6b, 0xed69, 0xed67, //  2512
-    0xed65, 0xed63, 0xed62, 0xed60, 0xed5e, 0xed5c, 0xed5b, 0xed59, //  2520
-    0xed57, 0xed55, 0xed53, 0xed52, 0xed50, 0xed4e, 0xed4c, 0xed4a, //  2528
-    0xed49, 0xed47, 0xed45, 0xed43, 0xed41, 0xed40, 0xed3e, 0xed3c, //  2536
-    0xed3a, 0xed39, 0xed37, 0xed35, 0xed33, 0xed31, 0xed30, 0xed2e, //  2544
-    0xed2c, 0xed2a, 0xed28, 0xed27, 0xed25, 0xed23, 0xed21, 0xed20, //  2552
-    0xed1e, 0xed1c, 0xed1a, 0xed18, 0xed17, 0xed15, 0xed13, 0xed11, //  2560
-    0xed0f, 0xed0e, 0xed0c, 0xed0a, 0xed08, 0xed07, 0xed05, 0xed03, //  2568
-    0xed01, 0xecff, 0xecfe, 0xecfc, 0xecfa, 0xecf8, 0xecf6, 0xecf5, //  2576
-    0xecf3, 0xecf1, 0xecef, 0xeced, 0xecec, 0xecea, 0xece8, 0xece6, //  2584
-    0xece5, 0xece3, 0xece1, 0xecdf, 0xecdd, 0xecdc, 0xecda, 0xecd8, //  2592
-    0xecd6, 0xecd4, 0xecd3, 0xecd1, 0xeccf, 0xeccd, 0xeccc, 0xecca, //  2600
-    0xecc8, 0xecc6, 0xecc4, 0xecc3, 0xecc1, 0xecbf, 0xecbd, 0xecbb, //  2608
-    0xecba, 0xecb8, 0xecb6, 0xecb4, 0xecb3, 0xecb1, 0xecaf, 0xecad, //  2616
-    0xecab, 0xecaa, 0xeca8, 0xeca6, 0xeca4, 0xeca2, 0xeca1, 0xec9f, //  2624
-    0xec9d, 0xec9b, 0xec9a, 0xec98, 0xec96, 0xec94, 0xec92, 0xec91, //  2632
-    0xec8f, 0xec8d, 0xec8b, 0xec89, 0xec88, 0xec86, 0xec84, 0xec82, //  2640
-    0xec80, 0xec7f, 0xec7d, 0xec7b, 0xec79, 0xec78, 0xec76, 0xec74, //  2648
-    0xec72, 0xec70, 0xec6f, 0xec6d, 0xec6b, 0xec69, 0xec67, 0xec66, //  2656
-    0xec64, 0xec62, 0xec60, 0xec5f, 0xec5d, 0xec5b, 0xec59, 0xec57, //  2664
-    0xec56, 0xec54, 0xec52, 0xec50, 0xec4e, 0xec4d, 0xec4b, 0xec49, //  2672
-    0xec47, 0xec46, 0xec44, 0xec42, 0xec40, 0xec3e, 0xec3d, 0xec3b, //  2680
-    0xec39, 0xec37, 0xec35, 0xec34, 0xec32, 0xec30, 0xec2e, 0xec2c, //  2688
-    0xec2b, 0xec29, 0xec27, 0xec25, 0xec24, 0xec22, 0xec20, 0xec1e, //  2696
-    0xec1c, 0xec1b, 0xec19, 0xec17, 0xec15, 0xec13, 0xec12, 0xec10, //  2704
-    0xec0e, 0xec0c, 0xec0b, 0xec09, 0xec07, 0xec05, 0xec03, 0xec02, //  2712
-    0xec00, 0xebfe, 0xebfc, 0xebfa, 0xebf9, 0xebf7, 0xebf5, 0xebf3, //  2720
-    0xebf2, 0xebf0, 0xebee, 0xebec, 0xebea, 0xebe9, 0xebe7, 0xebe5, //  2728
-    0xebe3, 0xebe1, 0xebe0, 0xebde, 0xebdc, 0xebda, 0xebd8, 0xebd7, //  2736
-    0xebd5, 0xebd3, 0xebd1, 0xebd0, 0xebce, 0xebcc, 0xebca, 0xebc8, //  2744
-    0xebc7, 0xebc5, 0xebc3, 0xebc1, 0xebbf, 0xebbe, 0xebbc, 0xebba, //  2752
-    0xebb8, 0xebb7, 0xebb5, 0xebb3, 0xebb1, 0xebaf, 0xebae, 0xebac, //  2760
-    0xebaa, 0xeba8, 0xeba6, 0xeba5, 0xeba3, 0xeba1, 0xeb9f, 0xeb9e, //  2768
-    0xeb9c, 0xeb9a, 0xeb98, 0xeb96, 0xeb95, 0xeb93, 0xeb91, 0xeb8f, //  2776
-    0xeb8d, 0xeb8c, 0xeb8a, 0xeb88, 0xeb86, 0xeb85, 0xeb83, 0xeb81, //  2784
-    0xeb7f, 0xeb7d, 0xeb7c, 0xeb7a, 0xeb78, 0xeb76, 0xeb74, 0xeb73, //  2792
-    0xeb71, 0xeb6f, 0xeb6d, 0xeb6b, 0xeb6a, 0xeb68, 0xeb66, 0xeb64, //  2800
-    0xeb63, 0xeb61, 0xeb5f, 0xeb5d, 0xeb5b, 0xeb5a, 0xeb58, 0xeb56, //  2808
-    0xeb54, 0xeb52, 0xeb51, 0xeb4f, 0xeb4d, 0xeb4b, 0xeb4a, 0xeb48, //  2816
-    0xeb46, 0xeb44, 0xeb42, 0xeb41, 0xeb3f, 0xeb3d, 0xeb3b, 0xeb39, //  2824
-    0xeb38, 0xeb36, 0xeb34, 0xeb32, 0xeb31, 0xeb2f, 0xeb2d, 0xeb2b, //  2832
-    0xeb29, 0xeb28, 0xeb26, 0xeb24, 0xeb22, 0xeb20, 0xeb1f, 0xeb1d, //  2840
-    0xeb1b, 0xeb19, 0xeb17, 0xeb16, 0xeb14, 0xeb12, 0xeb10, 0xeb0f, //  2848
-    0xeb0d, 0xeb0b, 0xeb09, 0xeb07, 0xeb06, 0xeb04, 0xeb02, 0xeb00, //  2856
-    0xeafe, 0xeafd, 0xeafb, 0xeaf9, 0xeaf7, 0xeaf6, 0xeaf4, 0xeaf2, //  2864
-    0xeaf0, 0xeaee, 0xeaed, 0xeaeb, 0xeae9, 0xeae7, 0xeae5, 0xeae4, //  2872
-    0xeae2, 0xeae0, 0xeade, 0xeadd, 0xeadb, 0xead9, 0xead7, 0xead5, //  2880
-    0xead4, 0xead2, 0xead0, 0xeace, 0xeacc, 0xeacb, 0xeac9, 0xeac7, //  2888
-    0xeac5, 0xeac3, 0xeac2, 0xeac0, 0xeabe, 0xeabc, 0xeabb, 0xeab9, //  2896
-    0xeab7, 0xeab5, 0xeab3, 0xeab2, 0xeab0, 0xeaae, 0xeaac, 0xeaaa, //  2904
-    0xeaa9, 0xeaa7, 0xeaa5, 0xeaa3, 0xeaa2, 0xeaa0, 0xea9e, 0xea9c, //  2912
-    0xea9a, 0xea99, 0xea97, 0xea95, 0xea93, 0xea91, 0xea90, 0xea8e, //  2920
-    0xea8c, 0xea8a, 0xea89, 0xea87, 0xea85, 0xea83, 0xea81, 0xea80, //  2928
-    0xea7e, 0xea7c, 0xea7a, 0xea78, 0xea77, 0xea75, 0xea73, 0xea71, //  2936
-    0xea70, 0xea6e, 0xea6c, 0xea6a, 0xea68, 0xea67, 0xea65, 0xea63, //  2944
-    0xea61, 0xea5f, 0xea5e, 0xea5c, 0xea5a, 0xea58, 0xea56, 0xea55, //  2952
-    0xea53, 0xea51, 0xea4f, 0xea4e, 0xea4c, 0xea4a, 0xea48, 0xea46, //  2960
-    0xea45, 0xea43, 0xea41, 0xea3f, 0xea3d, 0xea3c, 0xea3a, 0xea38, //  2968
-    0xea36, 0xea35, 0xea33, 0xea31, 0xea2f, 0xea2d, 0xea2c, 0xea2a, //  2976
-    0xea28, 0xea26, 0xea24, 0xea23, 0xea21, 0xea1f, 0xea1d, 0xea1c, //  2984
-    0xea1a, 0xea18, 0xea16, 0xea14, 0xea13, 0xea11, 0xea0f, 0xea0d, //  2992
-    0xea0b, 0xea0a, 0xea08, 0xea06, 0xea04, 0xea02, 0xea01, 0xe9ff, //  3000
-    0xe9fd, 0xe9fb, 0xe9fa, 0xe9f8, 0xe9f6, 0xe9f4, 0xe9f2, 0xe9f1, //  3008
-    0xe9ef, 0xe9ed, 0xe9eb, 0xe9e9, 0xe9e8, 0xe9e6, 0xe9e4, 0xe9e2, //  3016
-    0xe9e1, 0xe9df, 0xe9dd, 0xe9db, 0xe9d9, 0xe9d8, 0xe9d6, 0xe9d4, //  3024
-    0xe9d2, 0xe9d0, 0xe9cf, 0xe9cd, 0xe9cb, 0xe9c9, 0xe9c8, 0xe9c6, //  3032
-    0xe9c4, 0xe9c2, 0xe9c0, 0xe9bf, 0xe9bd, 0xe9bb, 0xe9b9, 0xe9b7, //  3040
-    0xe9b6, 0xe9b4, 0xe9b2, 0xe9b0, 0xe9ae, 0xe9ad, 0xe9ab, 0xe9a9, //  3048
-    0xe9a7, 0xe9a6, 0xe9a4, 0xe9a2, 0xe9a0, 0xe99e, 0xe99d, 0xe99b, //  3056
-    0xe999, 0xe997, 0xe995, 0xe994, 0xe992, 0xe990, 0xe98e, 0xe98d, //  3064
-    0xe98c, 0xe98a, 0xe989, 0xe987, 0xe985, 0xe983, 0xe982, 0xe980, //  3072
-    0xe97e, 0xe97d, 0xe97b, 0xe979, 0xe977, 0xe976, 0xe974, 0xe972, //  3080
-    0xe971, 0xe96f, 0xe96d, 0xe96b, 0xe96a, 0xe968, 0xe966, 0xe965, //  3088
-    0xe963, 0xe961, 0xe95f, 0xe95e, 0xe95c, 0xe95a, 0xe959, 0xe957, //  3096
-    0xe955, 0xe953, 0xe952, 0xe950, 0xe94e, 0xe94d, 0xe94b, 0xe949, //  3104
-    0xe947, 0xe946, 0xe944, 0xe942, 0xe941, 0xe93f, 0xe93d, 0xe93b, //  3112
-    0xe93a, 0xe938, 0xe936, 0xe935, 0xe933, 0xe931, 0xe930, 0xe92e, //  3120
-    0xe92c, 0xe92a, 0xe929, 0xe927, 0xe925, 0xe924, 0xe922, 0xe920, //  3128
-    0xe91e, 0xe91d, 0xe91b, 0xe919, 0xe918, 0xe916, 0xe914, 0xe912, //  3136
-    0xe911, 0xe90f, 0xe90d, 0xe90c, 0xe90a, 0xe908, 0xe906, 0xe905, //  3144
-    0xe903, 0xe901, 0xe900, 0xe8fe, 0xe8fc, 0xe8fa, 0xe8f9, 0xe8f7, //  3152
-    0xe8f5, 0xe8f4, 0xe8f2, 0xe8f0, 0xe8ee, 0xe8ed, 0xe8eb, 0xe8e9, //  3160
-    0xe8e8, 0xe8e6, 0xe8e4, 0xe8e2, 0xe8e1, 0xe8df, 0xe8dd, 0xe8dc, //  3168
-    0xe8da, 0xe8d8, 0xe8d6, 0xe8d5, 0xe8d3, 0xe8d1, 0xe8d0, 0xe8ce, //  3176
-    0xe8cc, 0xe8ca, 0xe8c9, 0xe8c7, 0xe8c5, 0xe8c4, 0xe8c2, 0xe8c0, //  3184
-    0xe8be, 0xe8bd, 0xe8bb, 0xe8b9, 0xe8b8, 0xe8b6, 0xe8b4, 0xe8b2, //  3192
-    0xe8b1, 0xe8af, 0xe8ad, 0xe8ac, 0xe8aa, 0xe8a8, 0xe8a6, 0xe8a5, //  3200
-    0xe8a3, 0xe8a1, 0xe8a0, 0xe89e, 0xe89c, 0xe89a, 0xe899, 0xe897, //  3208
-    0xe895, 0xe894, 0xe892, 0xe890, 0xe88e, 0xe88d, 0xe88b, 0xe889, //  3216
-    0xe888, 0xe886, 0xe884, 0xe883, 0xe881, 0xe87f, 0xe87d, 0xe87c, //  3224
-    0xe87a, 0xe878, 0xe877, 0xe875, 0xe873, 0xe871, 0xe870, 0xe86e, //  3232
-    0xe86c, 0xe86b, 0xe869, 0xe867, 0xe865, 0xe864, 0xe862, 0xe860, //  3240
-    0xe85f, 0xe85d, 0xe85b, 0xe859, 0xe858, 0xe856, 0xe854, 0xe853, //  3248
-    0xe851, 0xe84f, 0xe84d, 0xe84c, 0xe84a, 0xe848, 0xe847, 0xe845, //  3256
-    0xe843, 0xe841, 0xe840, 0xe83e, 0xe83c, 0xe83b, 0xe839, 0xe837, //  3264
-    0xe835, 0xe834, 0xe832, 0xe830, 0xe82f, 0xe82d, 0xe82b, 0xe829, //  3272
-    0xe828, 0xe826, 0xe824, 0xe823, 0xe821, 0xe81f, 0xe81d, 0xe81c, //  3280
-    0xe81a, 0xe818, 0xe817, 0xe815, 0xe813, 0xe811, 0xe810, 0xe80e, //  3288
-    0xe80c, 0xe80b, 0xe809, 0xe807, 0xe805, 0xe804, 0xe802, 0xe800, //  3296
-    0xe7ff, 0xe7fd, 0xe7fb, 0xe7f9, 0xe7f8, 0xe7f6, 0xe7f4, 0xe7f3, //  3304
-    0xe7f1, 0xe7ef, 0xe7ed, 0xe7ec, 0xe7ea, 0xe7e8, 0xe7e7, 0xe7e5, //  3312
-    0xe7e3, 0xe7e1, 0xe7e0, 0xe7de, 0xe7dc, 0xe7db, 0xe7d9, 0xe7d7, //  3320
-    0xe7d6, 0xe7d4, 0xe7d2, 0xe7d0, 0xe7cf, 0xe7cd, 0xe7cb, 0xe7ca, //  3328
-    0xe7c8, 0xe7c6, 0xe7c4, 0xe7c3, 0xe7c1, 0xe7bf, 0xe7be, 0xe7bc, //  3336
-    0xe7ba, 0xe7b8, 0xe7b7, 0xe7b5, 0xe7b3, 0xe7b2, 0xe7b0, 0xe7ae, //  3344
-    0xe7ac, 0xe7ab, 0xe7a9, 0xe7a7, 0xe7a6, 0xe7a4, 0xe7a2, 0xe7a0, //  3352
-    0xe79f, 0xe79d, 0xe79b, 0xe79a, 0xe798, 0xe796, 0xe794, 0xe793, //  3360
-    0xe791, 0xe78f, 0xe78e, 0xe78c, 0xe78a, 0xe788, 0xe787, 0xe785, //  3368
-    0xe783, 0xe782, 0xe780, 0xe77e, 0xe77c, 0xe77b, 0xe779, 0xe777, //  3376
-    0xe776, 0xe774, 0xe772, 0xe770, 0xe76f, 0xe76d, 0xe76b, 0xe76a, //  3384
-    0xe768, 0xe766, 0xe764, 0xe763, 0xe761, 0xe75f, 0xe75e, 0xe75c, //  3392
-    0xe75a, 0xe758, 0xe757, 0xe755, 0xe753, 0xe752, 0xe750, 0xe74e, //  3400
-    0xe74c, 0xe74b, 0xe749, 0xe747, 0xe746, 0xe744, 0xe742, 0xe740, //  3408
-    0xe73f, 0xe73d, 0xe73b, 0xe73a, 0xe738, 0xe736, 0xe734, 0xe733, //  3416
-    0xe731, 0xe72f, 0xe72e, 0xe72c, 0xe72a, 0xe728, 0xe727, 0xe725, //  3424
-    0xe723, 0xe722, 0xe720, 0xe71e, 0xe71d, 0xe71b, 0xe719, 0xe717, //  3432
-    0xe716, 0xe714, 0xe712, 0xe711, 0xe70f, 0xe70d, 0xe70b, 0xe70a, //  3440
-    0xe708, 0xe706, 0xe705, 0xe703, 0xe701, 0xe6ff, 0xe6fe, 0xe6fc, //  3448
-    0xe6fa, 0xe6f9, 0xe6f7, 0xe6f5, 0xe6f3, 0xe6f2, 0xe6f0, 0xe6ee, //  3456
-    0xe6ed, 0xe6eb, 0xe6e9, 0xe6e7, 0xe6e6, 0xe6e4, 0xe6e2, 0xe6e1, //  3464
-    0xe6df, 0xe6dd, 0xe6db, 0xe6da, 0xe6d8, 0xe6d6, 0xe6d5, 0xe6d3, //  3472
-    0xe6d1, 0xe6cf, 0xe6ce, 0xe6cc, 0xe6ca, 0xe6c9, 0xe6c7, 0xe6c5, //  3480
-    0xe6c3, 0xe6c2, 0xe6c0, 0xe6be, 0xe6bd, 0xe6bb, 0xe6b9, 0xe6b7, //  3488
-    0xe6b6, 0xe6b4, 0xe6b2, 0xe6b1, 0xe6af, 0xe6ad, 0xe6ab, 0xe6aa, //  3496
-    0xe6a8, 0xe6a6, 0xe6a5, 0xe6a3, 0xe6a1, 0xe69f, 0xe69e, 0xe69c, //  3504
-    0xe69a, 0xe699, 0xe697, 0xe695, 0xe693, 0xe692, 0xe690, 0xe68e, //  3512
-    0xe68d, 0xe68b, 0xe689, 0xe687, 0xe686, 0xe684, 0xe682, 0xe681, //  3520
-    0xe67f, 0xe67d, 0xe67b, 0xe67a, 0xe678, 0xe676, 0xe675, 0xe673, //  3528
-    0xe671, 0xe670, 0xe66e, 0xe66c, 0xe66a, 0xe669, 0xe667, 0xe665, //  3536
-    0xe664, 0xe662, 0xe660, 0xe65e, 0xe65d, 0xe65b, 0xe659, 0xe658, //  3544
-    0xe656, 0xe654, 0xe652, 0xe651, 0xe64f, 0xe64d, 0xe64c, 0xe64a, //  3552
-    0xe648, 0xe646, 0xe645, 0xe643, 0xe641, 0xe640, 0xe63e, 0xe63c, //  3560
-    0xe63a, 0xe639, 0xe637, 0xe635, 0xe634, 0xe632, 0xe630, 0xe62e, //  3568
-    0xe62d, 0xe62b, 0xe629, 0xe628, 0xe626, 0xe624, 0xe622, 0xe621, //  3576
-    0xe61f, 0xe61d, 0xe61c, 0xe61a, 0xe618, 0xe616, 0xe615, 0xe613, //  3584
-    0xe611, 0xe610, 0xe60e, 0xe60c, 0xe60a, 0xe609, 0xe607, 0xe605, //  3592
-    0xe604, 0xe602, 0xe600, 0xe5fe, 0xe5fd, 0xe5fb, 0xe5f9, 0xe5f8, //  3600
-    0xe5f6, 0xe5f4, 0xe5f2, 0xe5f1, 0xe5ef, 0xe5ed, 0xe5ec, 0xe5ea, //  3608
-    0xe5e8, 0xe5e6, 0xe5e5, 0xe5e3, 0xe5e1, 0xe5e0, 0xe5de, 0xe5dc, //  3616
-    0xe5da, 0xe5d9, 0xe5d7, 0xe5d5, 0xe5d4, 0xe5d2, 0xe5d0, 0xe5ce, //  3624
-    0xe5cd, 0xe5cb, 0xe5c9, 0xe5c8, 0xe5c6, 0xe5c4, 0xe5c3, 0xe5c1, //  3632
-    0xe5bf, 0xe5bd, 0xe5bc, 0xe5ba, 0xe5b8, 0xe5b7, 0xe5b5, 0xe5b3, //  3640
-    0xe5b1, 0xe5b0, 0xe5ae, 0xe5ac, 0xe5ab, 0xe5a9, 0xe5a7, 0xe5a5, //  3648
-    0xe5a4, 0xe5a2, 0xe5a0, 0xe59f, 0xe59d, 0xe59b, 0xe599, 0xe598, //  3656
-    0xe596, 0xe594, 0xe593, 0xe591, 0xe58f, 0xe58d, 0xe58c, 0xe58a, //  3664
-    0xe588, 0xe587, 0xe585, 0xe583, 0xe581, 0xe580, 0xe57e, 0xe57c, //  3672
-    0xe57b, 0xe579, 0xe577, 0xe575, 0xe574, 0xe572, 0xe570, 0xe56f, //  3680
-    0xe56d, 0xe56b, 0xe569, 0xe568, 0xe566, 0xe564, 0xe563, 0xe561, //  3688
-    0xe55f, 0xe55d, 0xe55c, 0xe55a, 0xe558, 0xe557, 0xe555, 0xe553, //  3696
-    0xe551, 0xe550, 0xe54e, 0xe54c, 0xe54b, 0xe549, 0xe547, 0xe545, //  3704
-    0xe544, 0xe542, 0xe540, 0xe53f, 0xe53d, 0xe53b, 0xe539, 0xe538, //  3712
-    0xe536, 0xe534, 0xe533, 0xe531, 0xe52f, 0xe52d, 0xe52c, 0xe52a, //  3720
-    0xe528, 0xe527, 0xe525, 0xe523, 0xe521, 0xe520, 0xe51e, 0xe51c, //  3728
-    0xe51b, 0xe519, 0xe517, 0xe516, 0xe514, 0xe512, 0xe510, 0xe50f, //  3736
-    0xe50d, 0xe50b, 0xe50a, 0xe508, 0xe506, 0xe504, 0xe503, 0xe501, //  3744
-    0xe4ff, 0xe4fe, 0xe4fc, 0xe4fa, 0xe4f8, 0xe4f7, 0xe4f5, 0xe4f3, //  3752
-    0xe4f2, 0xe4f0, 0xe4ee, 0xe4ec, 0xe4eb, 0xe4e9, 0xe4e7, 0xe4e6, //  3760
-    0xe4e4, 0xe4e2, 0xe4e0, 0xe4df, 0xe4dd, 0xe4db, 0xe4da, 0xe4d8, //  3768
-    0xe4d6, 0xe4d4, 0xe4d3, 0xe4d1, 0xe4cf, 0xe4ce, 0xe4cc, 0xe4ca, //  3776
-    0xe4c8, 0xe4c7, 0xe4c5, 0xe4c3, 0xe4c2, 0xe4c0, 0xe4be, 0xe4bc, //  3784
-    0xe4bb, 0xe4b9, 0xe4b7, 0xe4b6, 0xe4b4, 0xe4b2, 0xe4b0, 0xe4af, //  3792
-    0xe4ad, 0xe4ab, 0xe4aa, 0xe4a8, 0xe4a6, 0xe4a4, 0xe4a3, 0xe4a1, //  3800
-    0xe49f, 0xe49e, 0xe49c, 0xe49a, 0xe498, 0xe497, 0xe495, 0xe493, //  3808
-    0xe492, 0xe490, 0xe48e, 0xe48c, 0xe48b, 0xe489, 0xe487, 0xe486, //  3816
-    0xe484, 0xe482, 0xe480, 0xe47f, 0xe47d, 0xe47b, 0xe47a, 0xe478, //  3824
-    0xe476, 0xe474, 0xe473, 0xe471, 0xe46f, 0xe46e, 0xe46c, 0xe46a, //  3832
-    0xe469, 0xe467, 0xe465, 0xe463, 0xe462, 0xe460, 0xe45e, 0xe45d, //  3840
-    0xe45b, 0xe459, 0xe457, 0xe456, 0xe454, 0xe452, 0xe451, 0xe44f, //  3848
-    0xe44d, 0xe44b, 0xe44a, 0xe448, 0xe446, 0xe445, 0xe443, 0xe441, //  3856
-    0xe43f, 0xe43e, 0xe43c, 0xe43a, 0xe439, 0xe437, 0xe435, 0xe433, //  3864
-    0xe432, 0xe430, 0xe42e, 0xe42d, 0xe42b, 0xe429, 0xe427, 0xe426, //  3872
-    0xe424, 0xe422, 0xe421, 0xe41f, 0xe41d, 0xe41b, 0xe41a, 0xe418, //  3880
-    0xe416, 0xe415, 0xe413, 0xe411, 0xe40f, 0xe40e, 0xe40c, 0xe40a, //  3888
-    0xe409, 0xe407, 0xe405, 0xe403, 0xe402, 0xe400, 0xe3fe, 0xe3fd, //  3896
-    0xe3fb, 0xe3f9, 0xe3f7, 0xe3f6, 0xe3f4, 0xe3f2, 0xe3f1, 0xe3ef, //  3904
-    0xe3ed, 0xe3eb, 0xe3ea, 0xe3e8, 0xe3e6, 0xe3e5, 0xe3e3, 0xe3e1, //  3912
-    0xe3df, 0xe3de, 0xe3dc, 0xe3da, 0xe3d9, 0xe3d7, 0xe3d5, 0xe3d3, //  3920
-    0xe3d2, 0xe3d0, 0xe3ce, 0xe3cd, 0xe3cb, 0xe3c9, 0xe3c7, 0xe3c6, //  3928
-    0xe3c4, 0xe3c2, 0xe3c1, 0xe3bf, 0xe3bd, 0xe3bb, 0xe3ba, 0xe3b8, //  3936
-    0xe3b6, 0xe3b5, 0xe3b3, 0xe3b1, 0xe3b0, 0xe3ae, 0xe3ac, 0xe3aa, //  3944
-    0xe3a9, 0xe3a7, 0xe3a5, 0xe3a4, 0xe3a2, 0xe3a0, 0xe39e, 0xe39d, //  3952
-    0xe39b, 0xe399, 0xe398, 0xe396, 0xe394, 0xe392, 0xe391, 0xe38f, //  3960
-    0xe38d, 0xe38c, 0xe38a, 0xe388, 0xe386, 0xe385, 0xe383, 0xe381, //  3968
-    0xe380, 0xe37e, 0xe37c, 0xe37a, 0xe379, 0xe377, 0xe375, 0xe374, //  3976
-    0xe372, 0xe370, 0xe36e, 0xe36d, 0xe36b, 0xe369, 0xe368, 0xe366, //  3984
-    0xe364, 0xe362, 0xe361, 0xe35f, 0xe35d, 0xe35c, 0xe35a, 0xe358, //  3992
-    0xe356, 0xe355, 0xe353, 0xe351, 0xe350, 0xe34e, 0xe34c, 0xe34a, //  4000
-    0xe349, 0xe347, 0xe345, 0xe344, 0xe342, 0xe340, 0xe33e, 0xe33d, //  4008
-    0xe33b, 0xe339, 0xe338, 0xe336, 0xe334, 0xe332, 0xe331, 0xe32f, //  4016
-    0xe32d, 0xe32c, 0xe32a, 0xe328, 0xe326, 0xe325, 0xe323, 0xe321, //  4024
-    0xe320, 0xe31e, 0xe31c, 0xe31a, 0xe319, 0xe317, 0xe315, 0xe314, //  4032
-    0xe312, 0xe310, 0xe30e, 0xe30d, 0xe30b, 0xe309, 0xe308, 0xe306, //  4040
-    0xe304, 0xe303, 0xe301, 0xe2ff, 0xe2fd, 0xe2fc, 0xe2fa, 0xe2f8, //  4048
-    0xe2f7, 0xe2f5, 0xe2f3, 0xe2f1, 0xe2f0, 0xe2ee, 0xe2ec, 0xe2eb, //  4056
-    0xe2e9, 0xe2e7, 0xe2e5, 0xe2e4, 0xe2e2, 0xe2e0, 0xe2df, 0xe2dd, //  4064
-    0xe2db, 0xe2d9, 0xe2d8, 0xe2d6, 0xe2d4, 0xe2d3, 0xe2d1, 0xe2cf, //  4072
-    0xe2cd, 0xe2cc, 0xe2ca, 0xe2c8, 0xe2c7, 0xe2c5, 0xe2c3, 0xe2c1, //  4080
-    0xe2c0, 0xe2be, 0xe2bc, 0xe2bb, 0xe2b9, 0xe2b7, 0xe2b5, 0xe2b4, //  4088
-    0xe2b3, 0xe2b1, 0xe2b0, 0xe2ae, 0xe2ac, 0xe2ab, 0xe2a9, 0xe2a8, //  4096
-    0xe2a6, 0xe2a4, 0xe2a3, 0xe2a1, 0xe29f, 0xe29e, 0xe29c, 0xe29a, //  4104
-    0xe299, 0xe297, 0xe295, 0xe294, 0xe292, 0xe291, 0xe28f, 0xe28d, //  4112
-    0xe28c, 0xe28a, 0xe288, 0xe287, 0xe285, 0xe283, 0xe282, 0xe280, //  4120
-    0xe27e, 0xe27d, 0xe27b, 0xe27a, 0xe278, 0xe276, 0xe275, 0xe273, //  4128
-    0xe271, 0xe270, 0xe26e, 0xe26c, 0xe26b, 0xe269, 0xe267, 0xe266, //  4136
-    0xe264, 0xe263, 0xe261, 0xe25f, 0xe25e, 0xe25c, 0xe25a, 0xe259, //  4144
-    0xe257, 0xe255, 0xe254, 0xe252, 0xe250, 0xe24f, 0xe24d, 0xe24c, //  4152
-    0xe24a, 0xe248, 0xe247, 0xe245, 0xe243, 0xe242, 0xe240, 0xe23e, //  4160
-    0xe23d, 0xe23b, 0xe239, 0xe238, 0xe236, 0xe235, 0xe233, 0xe231, //  4168
-    0xe230, 0xe22e, 0xe22c, 0xe22b, 0xe229, 0xe227, 0xe226, 0xe224, //  4176
-    0xe222, 0xe221, 0xe21f, 0xe21e, 0xe21c, 0xe21a, 0xe219, 0xe217, //  4184
-    0xe215, 0xe214, 0xe212, 0xe210, 0xe20f, 0xe20d, 0xe20b, 0xe20a, //  4192
-    0xe208, 0xe207, 0xe205, 0xe203, 0xe202, 0xe200, 0xe1fe, 0xe1fd, //  4200
-    0xe1fb, 0xe1f9, 0xe1f8, 0xe1f6, 0xe1f4, 0xe1f3, 0xe1f1, 0xe1f0, //  4208
-    0xe1ee, 0xe1ec, 0xe1eb, 0xe1e9, 0xe1e7, 0xe1e6, 0xe1e4, 0xe1e2, //  4216
-    0xe1e1, 0xe1df, 0xe1dd, 0xe1dc, 0xe1da, 0xe1d9, 0xe1d7, 0xe1d5, //  4224
-    0xe1d4, 0xe1d2, 0xe1d0, 0xe1cf, 0xe1cd, 0xe1cb, 0xe1ca, 0xe1c8, //  4232
-    0xe1c6, 0xe1c5, 0xe1c3, 0xe1c2, 0xe1c0, 0xe1be, 0xe1bd, 0xe1bb, //  4240
-    0xe1b9, 0xe1b8, 0xe1b6, 0xe1b4, 0xe1b3, 0xe1b1, 0xe1af, 0xe1ae, //  4248
-    0xe1ac, 0xe1ab, 0xe1a9, 0xe1a7, 0xe1a6, 0xe1a4, 0xe1a2, 0xe1a1, //  4256
-    0xe19f, 0xe19d, 0xe19c, 0xe19a, 0xe198, 0xe197, 0xe195, 0xe194, //  4264
-    0xe192, 0xe190, 0xe18f, 0xe18d, 0xe18b, 0xe18a, 0xe188, 0xe186, //  4272
-    0xe185, 0xe183, 0xe181, 0xe180, 0xe17e, 0xe17d, 0xe17b, 0xe179, //  4280
-    0xe178, 0xe176, 0xe174, 0xe173, 0xe171, 0xe16f, 0xe16e, 0xe16c, //  4288
-    0xe16a, 0xe169, 0xe167, 0xe166, 0xe164, 0xe162, 0xe161, 0xe15f, //  4296
-    0xe15d, 0xe15c, 0xe15a, 0xe158, 0xe157, 0xe155, 0xe153, 0xe152, //  4304
-    0xe150, 0xe14f, 0xe14d, 0xe14b, 0xe14a, 0xe148, 0xe146, 0xe145, //  4312
-    0xe143, 0xe141, 0xe140, 0xe13e, 0xe13c, 0xe13b, 0xe139, 0xe138, //  4320
-    0xe136, 0xe134, 0xe133, 0xe131, 0xe12f, 0xe12e, 0xe12c, 0xe12a, //  4328
-    0xe129, 0xe127, 0xe125, 0xe124, 0xe122, 0xe121, 0xe11f, 0xe11d, //  4336
-    0xe11c, 0xe11a, 0xe118, 0xe117, 0xe115, 0xe113, 0xe112, 0xe110, //  4344
-    0xe10f, 0xe10d, 0xe10b, 0xe10a, 0xe108, 0xe106, 0xe105, 0xe103, //  4352
-    0xe101, 0xe100, 0xe0fe, 0xe0fc, 0xe0fb, 0xe0f9, 0xe0f8, 0xe0f6, //  4360
-    0xe0f4, 0xe0f3, 0xe0f1, 0xe0ef, 0xe0ee, 0xe0ec, 0xe0ea, 0xe0e9, //  4368
-    0xe0e7, 0xe0e5, 0xe0e4, 0xe0e2, 0xe0e1, 0xe0df, 0xe0dd, 0xe0dc, //  4376
-    0xe0da, 0xe0d8, 0xe0d7, 0xe0d5, 0xe0d3, 0xe0d2, 0xe0d0, 0xe0ce, //  4384
-    0xe0cd, 0xe0cb, 0xe0ca, 0xe0c8, 0xe0c6, 0xe0c5, 0xe0c3, 0xe0c1, //  4392
-    0xe0c0, 0xe0be, 0xe0bc, 0xe0bb, 0xe0b9, 0xe0b7, 0xe0b6, 0xe0b4, //  4400
-    0xe0b3, 0xe0b1, 0xe0af, 0xe0ae, 0xe0ac, 0xe0aa, 0xe0a9, 0xe0a7, //  4408
-    0xe0a5, 0xe0a4, 0xe0a2, 0xe0a0, 0xe09f, 0xe09d, 0xe09c, 0xe09a, //  4416
-    0xe098, 0xe097, 0xe095, 0xe093, 0xe092, 0xe090, 0xe08e, 0xe08d, //  4424
-    0xe08b, 0xe089, 0xe088, 0xe086, 0xe085, 0xe083, 0xe081, 0xe080, //  4432
-    0xe07e, 0xe07c, 0xe07b, 0xe079, 0xe077, 0xe076, 0xe074, 0xe072, //  4440
-    0xe071, 0xe06f, 0xe06e, 0xe06c, 0xe06a, 0xe069, 0xe067, 0xe065, //  4448
-    0xe064, 0xe062, 0xe060, 0xe05f, 0xe05d, 0xe05b, 0xe05a, 0xe058, //  4456
-    0xe057, 0xe055, 0xe053, 0xe052, 0xe050, 0xe04e, 0xe04d, 0xe04b, //  4464
-    0xe049, 0xe048, 0xe046, 0xe044, 0xe043, 0xe041, 0xe040, 0xe03e, //  4472
-    0xe03c, 0xe03b, 0xe039, 0xe037, 0xe036, 0xe034, 0xe032, 0xe031, //  4480
-    0xe02f, 0xe02d, 0xe02c, 0xe02a, 0xe029, 0xe027, 0xe025, 0xe024, //  4488
-    0xe022, 0xe020, 0xe01f, 0xe01d, 0xe01b, 0xe01a, 0xe018, 0xe016, //  4496
-    0xe015, 0xe013, 0xe012, 0xe010, 0xe00e, 0xe00d, 0xe00b, 0xe009, //  4504
-    0xe008, 0xe006, 0xe004, 0xe003, 0xe001, 0xdfff, 0xdffe, 0xdffc, //  4512
-    0xdffb, 0xdff9, 0xdff7, 0xdff6, 0xdff4, 0xdff2, 0xdff1, 0xdfef, //  4520
-    0xdfed, 0xdfec, 0xdfea, 0xdfe8, 0xdfe7, 0xdfe5, 0xdfe4, 0xdfe2, //  4528
-    0xdfe0, 0xdfdf, 0xdfdd, 0xdfdb, 0xdfda, 0xdfd8, 0xdfd6, 0xdfd5, //  4536
-    0xdfd3, 0xdfd1, 0xdfd0, 0xdfce, 0xdfcd, 0xdfcb, 0xdfc9, 0xdfc8, //  4544
-    0xdfc6, 0xdfc4, 0xdfc3, 0xdfc1, 0xdfbf, 0xdfbe, 0xdfbc, 0xdfba, //  4552
-    0xdfb9, 0xdfb7, 0xdfb6, 0xdfb4, 0xdfb2, 0xdfb1, 0xdfaf, 0xdfad, //  4560
-    0xdfac, 0xdfaa, 0xdfa8, 0xdfa7, 0xdfa5, 0xdfa3, 0xdfa2, 0xdfa0, //  4568
-    0xdf9f, 0xdf9d, 0xdf9b, 0xdf9a, 0xdf98, 0xdf96, 0xdf95, 0xdf93, //  4576
-    0xdf91, 0xdf90, 0xdf8e, 0xdf8c, 0xdf8b, 0xdf89, 0xdf88, 0xdf86, //  4584
-    0xdf84, 0xdf83, 0xdf81, 0xdf7f, 0xdf7e, 0xdf7c, 0xdf7a, 0xdf79, //  4592
-    0xdf77, 0xdf75, 0xdf74, 0xdf72, 0xdf71, 0xdf6f, 0xdf6d, 0xdf6c, //  4600
-    0xdf6a, 0xdf68, 0xdf67, 0xdf65, 0xdf63, 0xdf62, 0xdf60, 0xdf5f, //  4608
-    0xdf5d, 0xdf5b, 0xdf5a, 0xdf58, 0xdf56, 0xdf55, 0xdf53, 0xdf51, //  4616
-    0xdf50, 0xdf4e, 0xdf4c, 0xdf4b, 0xdf49, 0xdf48, 0xdf46, 0xdf44, //  4624
-    0xdf43, 0xdf41, 0xdf3f, 0xdf3e, 0xdf3c, 0xdf3a, 0xdf39, 0xdf37, //  4632
-    0xdf35, 0xdf34, 0xdf32, 0xdf31, 0xdf2f, 0xdf2d, 0xdf2c, 0xdf2a, //  4640
-    0xdf28, 0xdf27, 0xdf25, 0xdf23, 0xdf22, 0xdf20, 0xdf1e, 0xdf1d, //  4648
-    0xdf1b, 0xdf1a, 0xdf18, 0xdf16, 0xdf15, 0xdf13, 0xdf11, 0xdf10, //  4656
-    0xdf0e, 0xdf0c, 0xdf0b, 0xdf09, 0xdf07, 0xdf06, 0xdf04, 0xdf03, //  4664
-    0xdf01, 0xdeff, 0xdefe, 0xdefc, 0xdefa, 0xdef9, 0xdef7, 0xdef5, //  4672
-    0xdef4, 0xdef2, 0xdef0, 0xdeef, 0xdeed, 0xdeec, 0xdeea, 0xdee8, //  4680
-    0xdee7, 0xdee5, 0xdee3, 0xdee2, 0xdee0, 0xdede, 0xdedd, 0xdedb, //  4688
-    0xded9, 0xded8, 0xded6, 0xded5, 0xded3, 0xded1, 0xded0, 0xdece, //  4696
-    0xdecc, 0xdecb, 0xdec9, 0xdec7, 0xdec6, 0xdec4, 0xdec2, 0xdec1, //  4704
-    0xdebf, 0xdebe, 0xdebc, 0xdeba, 0xdeb9, 0xdeb7, 0xdeb5, 0xdeb4, //  4712
-    0xdeb2, 0xdeb0, 0xdeaf, 0xdead, 0xdeab, 0xdeaa, 0xdea8, 0xdea7, //  4720
-    0xdea5, 0xdea3, 0xdea2, 0xdea0, 0xde9e, 0xde9d, 0xde9b, 0xde99, //  4728
-    0xde98, 0xde96, 0xde94, 0xde93, 0xde91, 0xde90, 0xde8e, 0xde8c, //  4736
-    0xde8b, 0xde89, 0xde87, 0xde86, 0xde84, 0xde82, 0xde81, 0xde7f, //  4744
-    0xde7d, 0xde7c, 0xde7a, 0xde79, 0xde77, 0xde75, 0xde74, 0xde72, //  4752
-    0xde70, 0xde6f, 0xde6d, 0xde6b, 0xde6a, 0xde68, 0xde66, 0xde65, //  4760
-    0xde63, 0xde62, 0xde60, 0xde5e, 0xde5d, 0xde5b, 0xde59, 0xde58, //  4768
-    0xde56, 0xde54, 0xde53, 0xde51, 0xde4f, 0xde4e, 0xde4c, 0xde4b, //  4776
-    0xde49, 0xde47, 0xde46, 0xde44, 0xde42, 0xde41, 0xde3f, 0xde3d, //  4784
-    0xde3c, 0xde3a, 0xde38, 0xde37, 0xde35, 0xde34, 0xde32, 0xde30, //  4792
-    0xde2f, 0xde2d, 0xde2b, 0xde2a, 0xde28, 0xde26, 0xde25, 0xde23, //  4800
-    0xde21, 0xde20, 0xde1e, 0xde1d, 0xde1b, 0xde19, 0xde18, 0xde16, //  4808
-    0xde14, 0xde13, 0xde11, 0xde0f, 0xde0e, 0xde0c, 0xde0a, 0xde09, //  4816
-    0xde07, 0xde06, 0xde04, 0xde02, 0xde01, 0xddff, 0xddfd, 0xddfc, //  4824
-    0xddfa, 0xddf8, 0xddf7, 0xddf5, 0xddf3, 0xddf2, 0xddf0, 0xddef, //  4832
-    0xdded, 0xddeb, 0xddea, 0xdde8, 0xdde6, 0xdde5, 0xdde3, 0xdde1, //  4840
-    0xdde0, 0xddde, 0xdddc, 0xdddb, 0xddd9, 0xddd8, 0xddd6, 0xddd4, //  4848
-    0xddd3, 0xddd1, 0xddcf, 0xddce, 0xddcc, 0xddca, 0xddc9, 0xddc7, //  4856
-    0xddc6, 0xddc4, 0xddc2, 0xddc1, 0xddbf, 0xddbd, 0xddbc, 0xddba, //  4864
-    0xddb8, 0xddb7, 0xddb5, 0xddb3, 0xddb2, 0xddb0, 0xddaf, 0xddad, //  4872
-    0xddab, 0xddaa, 0xdda8, 0xdda6, 0xdda5, 0xdda3, 0xdda1, 0xdda0, //  4880
-    0xdd9e, 0xdd9c, 0xdd9b, 0xdd99, 0xdd98, 0xdd96, 0xdd94, 0xdd93, //  4888
-    0xdd91, 0xdd8f, 0xdd8e, 0xdd8c, 0xdd8a, 0xdd89, 0xdd87, 0xdd85, //  4896
-    0xdd84, 0xdd82, 0xdd81, 0xdd7f, 0xdd7d, 0xdd7c, 0xdd7a, 0xdd78, //  4904
-    0xdd77, 0xdd75, 0xdd73, 0xdd72, 0xdd70, 0xdd6e, 0xdd6d, 0xdd6b, //  4912
-    0xdd6a, 0xdd68, 0xdd66, 0xdd65, 0xdd63, 0xdd61, 0xdd60, 0xdd5e, //  4920
-    0xdd5c, 0xdd5b, 0xdd59, 0xdd57, 0xdd56, 0xdd54, 0xdd53, 0xdd51, //  4928
-    0xdd4f, 0xdd4e, 0xdd4c, 0xdd4a, 0xdd49, 0xdd47, 0xdd45, 0xdd44, //  4936
-    0xdd42, 0xdd40, 0xdd3f, 0xdd3d, 0xdd3c, 0xdd3a, 0xdd38, 0xdd37, //  4944
-    0xdd35, 0xdd33, 0xdd32, 0xdd30, 0xdd2e, 0xdd2d, 0xdd2b, 0xdd29, //  4952
-    0xdd28, 0xdd26, 0xdd25, 0xdd23, 0xdd21, 0xdd20, 0xdd1e, 0xdd1c, //  4960
-    0xdd1b, 0xdd19, 0xdd17, 0xdd16, 0xdd14, 0xdd12, 0xdd11, 0xdd0f, //  4968
-    0xdd0e, 0xdd0c, 0xdd0a, 0xdd09, 0xdd07, 0xdd05, 0xdd04, 0xdd02, //  4976
-    0xdd00, 0xdcff, 0xdcfd, 0xdcfb, 0xdcfa, 0xdcf8, 0xdcf7, 0xdcf5, //  4984
-    0xdcf3, 0xdcf2, 0xdcf0, 0xdcee, 0xdced, 0xdceb, 0xdce9, 0xdce8, //  4992
-    0xdce6, 0xdce4, 0xdce3, 0xdce1, 0xdce0, 0xdcde, 0xdcdc, 0xdcdb, //  5000
-    0xdcd9, 0xdcd7, 0xdcd6, 0xdcd4, 0xdcd2, 0xdcd1, 0xdccf, 0xdccd, //  5008
-    0xdccc, 0xdcca, 0xdcc9, 0xdcc7, 0xdcc5, 0xdcc4, 0xdcc2, 0xdcc0, //  5016
-    0xdcbf, 0xdcbd, 0xdcbb, 0xdcba, 0xdcb8, 0xdcb6, 0xdcb5, 0xdcb3, //  5024
-    0xdcb2, 0xdcb0, 0xdcae, 0xdcad, 0xdcab, 0xdca9, 0xdca8, 0xdca6, //  5032
-    0xdca4, 0xdca3, 0xdca1, 0xdc9f, 0xdc9e, 0xdc9c, 0xdc9b, 0xdc99, //  5040
-    0xdc97, 0xdc96, 0xdc94, 0xdc92, 0xdc91, 0xdc8f, 0xdc8d, 0xdc8c, //  5048
-    0xdc8a, 0xdc88, 0xdc87, 0xdc85, 0xdc84, 0xdc82, 0xdc80, 0xdc7f, //  5056
-    0xdc7d, 0xdc7b, 0xdc7a, 0xdc78, 0xdc76, 0xdc75, 0xdc73, 0xdc71, //  5064
-    0xdc70, 0xdc6e, 0xdc6d, 0xdc6b, 0xdc69, 0xdc68, 0xdc66, 0xdc64, //  5072
-    0xdc63, 0xdc61, 0xdc5f, 0xdc5e, 0xdc5c, 0xdc5a, 0xdc59, 0xdc57, //  5080
-    0xdc56, 0xdc54, 0xdc52, 0xdc51, 0xdc4f, 0xdc4d, 0xdc4c, 0xdc4a, //  5088
-    0xdc48, 0xdc47, 0xdc45, 0xdc43, 0xdc42, 0xdc40, 0xdc3f, 0xdc3d, //  5096
-    0xdc3b, 0xdc3a, 0xdc38, 0xdc36, 0xdc35, 0xdc33, 0xdc31, 0xdc30, //  5104
-    0xdc2e, 0xdc2c, 0xdc2b, 0xdc29, 0xdc28, 0xdc26, 0xdc24, 0xdc23, //  5112
-    0xdc21, 0xdc20, 0xdc1e, 0xdc1d, 0xdc1b, 0xdc19, 0xdc18, 0xdc16, //  5120
-    0xdc15, 0xdc13, 0xdc11, 0xdc10, 0xdc0e, 0xdc0d, 0xdc0b, 0xdc0a, //  5128
-    0xdc08, 0xdc06, 0xdc05, 0xdc03, 0xdc02, 0xdc00, 0xdbff, 0xdbfd, //  5136
-    0xdbfb, 0xdbfa, 0xdbf8, 0xdbf7, 0xdbf5, 0xdbf4, 0xdbf2, 0xdbf0, //  5144
-    0xdbef, 0xdbed, 0xdbec, 0xdbea, 0xdbe9, 0xdbe7, 0xdbe5, 0xdbe4, //  5152
-    0xdbe2, 0xdbe1, 0xdbdf, 0xdbdd, 0xdbdc, 0xdbda, 0xdbd9, 0xdbd7, //  5160
-    0xdbd6, 0xdbd4, 0xdbd2, 0xdbd1, 0xdbcf, 0xdbce, 0xdbcc, 0xdbcb, //  5168
-    0xdbc9, 0xdbc7, 0xdbc6, 0xdbc4, 0xdbc3, 0xdbc1, 0xdbc0, 0xdbbe, //  5176
-    0xdbbc, 0xdbbb, 0xdbb9, 0xdbb8, 0xdbb6, 0xdbb4, 0xdbb3, 0xdbb1, //  5184
-    0xdbb0, 0xdbae, 0xdbad, 0xdbab, 0xdba9, 0xdba8, 0xdba6, 0xdba5, //  5192
-    0xdba3, 0xdba2, 0xdba0, 0xdb9e, 0xdb9d, 0xdb9b, 0xdb9a, 0xdb98, //  5200
-    0xdb97, 0xdb95, 0xdb93, 0xdb92, 0xdb90, 0xdb8f, 0xdb8d, 0xdb8c, //  5208
-    0xdb8a, 0xdb88, 0xdb87, 0xdb85, 0xdb84, 0xdb82, 0xdb80, 0xdb7f, //  5216
-    0xdb7d, 0xdb7c, 0xdb7a, 0xdb79, 0xdb77, 0xdb75, 0xdb74, 0xdb72, //  5224
-    0xdb71, 0xdb6f, 0xdb6e, 0xdb6c, 0xdb6a, 0xdb69, 0xdb67, 0xdb66, //  5232
-    0xdb64, 0xdb63, 0xdb61, 0xdb5f, 0xdb5e, 0xdb5c, 0xdb5b, 0xdb59, //  5240
-    0xdb58, 0xdb56, 0xdb54, 0xdb53, 0xdb51, 0xdb50, 0xdb4e, 0xdb4c, //  5248
-    0xdb4b, 0xdb49, 0xdb48, 0xdb46, 0xdb45, 0xdb43, 0xdb41, 0xdb40, //  5256
-    0xdb3e, 0xdb3d, 0xdb3b, 0xdb3a, 0xdb38, 0xdb36, 0xdb35, 0xdb33, //  5264
-    0xdb32, 0xdb30, 0xdb2f, 0xdb2d, 0xdb2b, 0xdb2a, 0xdb28, 0xdb27, //  5272
-    0xdb25, 0xdb23, 0xdb22, 0xdb20, 0xdb1f, 0xdb1d, 0xdb1c, 0xdb1a, //  5280
-    0xdb18, 0xdb17, 0xdb15, 0xdb14, 0xdb12, 0xdb11, 0xdb0f, 0xdb0d, //  5288
-    0xdb0c, 0xdb0a, 0xdb09, 0xdb07, 0xdb06, 0xdb04, 0xdb02, 0xdb01, //  5296
-    0xdaff, 0xdafe, 0xdafc, 0xdafb, 0xdaf9, 0xdaf7, 0xdaf6, 0xdaf4, //  5304
-    0xdaf3, 0xdaf1, 0xdaef, 0xdaee, 0xdaec, 0xdaeb, 0xdae9, 0xdae8, //  5312
-    0xdae6, 0xdae4, 0xdae3, 0xdae1, 0xdae0, 0xdade, 0xdadd, 0xdadb, //  5320
-    0xdad9, 0xdad8, 0xdad6, 0xdad5, 0xdad3, 0xdad2, 0xdad0, 0xdace, //  5328
-    0xdacd, 0xdacb, 0xdaca, 0xdac8, 0xdac6, 0xdac5, 0xdac3, 0xdac2, //  5336
-    0xdac0, 0xdabf, 0xdabd, 0xdabb, 0xdaba, 0xdab8, 0xdab7, 0xdab5, //  5344
-    0xdab4, 0xdab2, 0xdab0, 0xdaaf, 0xdaad, 0xdaac, 0xdaaa, 0xdaa9, //  5352
-    0xdaa7, 0xdaa5, 0xdaa4, 0xdaa2, 0xdaa1, 0xda9f, 0xda9e, 0xda9c, //  5360
-    0xda9a, 0xda99, 0xda97, 0xda96, 0xda94, 0xda92, 0xda91, 0xda8f, //  5368
-    0xda8e, 0xda8c, 0xda8b, 0xda89, 0xda87, 0xda86, 0xda84, 0xda83, //  5376
-    0xda81, 0xda80, 0xda7e, 0xda7c, 0xda7b, 0xda79, 0xda78, 0xda76, //  5384
-    0xda75, 0xda73, 0xda71, 0xda70, 0xda6e, 0xda6d, 0xda6b, 0xda69, //  5392
-    0xda68, 0xda66, 0xda65, 0xda63, 0xda62, 0xda60, 0xda5e, 0xda5d, //  5400
-    0xda5b, 0xda5a, 0xda58, 0xda57, 0xda55, 0xda53, 0xda52, 0xda50, //  5408
-    0xda4f, 0xda4d, 0xda4c, 0xda4a, 0xda48, 0xda47, 0xda45, 0xda44, //  5416
-    0xda42, 0xda41, 0xda3f, 0xda3d, 0xda3c, 0xda3a, 0xda39, 0xda37, //  5424
-    0xda35, 0xda34, 0xda32, 0xda31, 0xda2f, 0xda2e, 0xda2c, 0xda2a, //  5432
-    0xda29, 0xda27, 0xda26, 0xda24, 0xda23, 0xda21, 0xda1f, 0xda1e, //  5440
-    0xda1c, 0xda1b, 0xda19, 0xda18, 0xda16, 0xda14, 0xda13, 0xda11, //  5448
-    0xda10, 0xda0e, 0xda0d, 0xda0b, 0xda09, 0xda08, 0xda06, 0xda05, //  5456
-    0xda03, 0xda01, 0xda00, 0xd9fe, 0xd9fd, 0xd9fb, 0xd9fa, 0xd9f8, //  5464
-    0xd9f6, 0xd9f5, 0xd9f3, 0xd9f2, 0xd9f0, 0xd9ef, 0xd9ed, 0xd9eb, //  5472
-    0xd9ea, 0xd9e8, 0xd9e7, 0xd9e5, 0xd9e4, 0xd9e2, 0xd9e0, 0xd9df, //  5480
-    0xd9dd, 0xd9dc, 0xd9da, 0xd9d8, 0xd9d7, 0xd9d5, 0xd9d4, 0xd9d2, //  5488
-    0xd9d1, 0xd9cf, 0xd9cd, 0xd9cc, 0xd9ca, 0xd9c9, 0xd9c7, 0xd9c6, //  5496
-    0xd9c4, 0xd9c2, 0xd9c1, 0xd9bf, 0xd9be, 0xd9bc, 0xd9bb, 0xd9b9, //  5504
-    0xd9b7, 0xd9b6, 0xd9b4, 0xd9b3, 0xd9b1, 0xd9b0, 0xd9ae, 0xd9ac, //  5512
-    0xd9ab, 0xd9a9, 0xd9a8, 0xd9a6, 0xd9a4, 0xd9a3, 0xd9a1, 0xd9a0, //  5520
-    0xd99e, 0xd99d, 0xd99b, 0xd999, 0xd998, 0xd996, 0xd995, 0xd993, //  5528
-    0xd992, 0xd990, 0xd98e, 0xd98d, 0xd98b, 0xd98a, 0xd988, 0xd987, //  5536
-    0xd985, 0xd983, 0xd982, 0xd980, 0xd97f, 0xd97d, 0xd97b, 0xd97a, //  5544
-    0xd978, 0xd977, 0xd975, 0xd974, 0xd972, 0xd970, 0xd96f, 0xd96d, //  5552
-    0xd96c, 0xd96a, 0xd969, 0xd967, 0xd965, 0xd964, 0xd962, 0xd961, //  5560
-    0xd95f, 0xd95e, 0xd95c, 0xd95a, 0xd959, 0xd957, 0xd956, 0xd954, //  5568
-    0xd953, 0xd951, 0xd94f, 0xd94e, 0xd94c, 0xd94b, 0xd949, 0xd947, //  5576
-    0xd946, 0xd944, 0xd943, 0xd941, 0xd940, 0xd93e, 0xd93c, 0xd93b, //  5584
-    0xd939, 0xd938, 0xd936, 0xd935, 0xd933, 0xd931, 0xd930, 0xd92e, //  5592
-    0xd92d, 0xd92b, 0xd92a, 0xd928, 0xd926, 0xd925, 0xd923, 0xd922, //  5600
-    0xd920, 0xd91f, 0xd91d, 0xd91b, 0xd91a, 0xd918, 0xd917, 0xd915, //  5608
-    0xd913, 0xd912, 0xd910, 0xd90f, 0xd90d, 0xd90c, 0xd90a, 0xd908, //  5616
-    0xd907, 0xd905, 0xd904, 0xd902, 0xd901, 0xd8ff, 0xd8fd, 0xd8fc, //  5624
-    0xd8fa, 0xd8f9, 0xd8f7, 0xd8f6, 0xd8f4, 0xd8f2, 0xd8f1, 0xd8ef, //  5632
-    0xd8ee, 0xd8ec, 0xd8ea, 0xd8e9, 0xd8e7, 0xd8e6, 0xd8e4, 0xd8e3, //  5640
-    0xd8e1, 0xd8df, 0xd8de, 0xd8dc, 0xd8db, 0xd8d9, 0xd8d8, 0xd8d6, //  5648
-    0xd8d4, 0xd8d3, 0xd8d1, 0xd8d0, 0xd8ce, 0xd8cd, 0xd8cb, 0xd8c9, //  5656
-    0xd8c8, 0xd8c6, 0xd8c5, 0xd8c3, 0xd8c2, 0xd8c0, 0xd8be, 0xd8bd, //  5664
-    0xd8bb, 0xd8ba, 0xd8b8, 0xd8b6, 0xd8b5, 0xd8b3, 0xd8b2, 0xd8b0, //  5672
-    0xd8af, 0xd8ad, 0xd8ab, 0xd8aa, 0xd8a8, 0xd8a7, 0xd8a5, 0xd8a4, //  5680
-    0xd8a2, 0xd8a0, 0xd89f, 0xd89d, 0xd89c, 0xd89a, 0xd899, 0xd897, //  5688
-    0xd895, 0xd894, 0xd892, 0xd891, 0xd88f, 0xd88d, 0xd88c, 0xd88a, //  5696
-    0xd889, 0xd887, 0xd886, 0xd884, 0xd882, 0xd881, 0xd87f, 0xd87e, //  5704
-    0xd87c, 0xd87b, 0xd879, 0xd877, 0xd876, 0xd874, 0xd873, 0xd871, //  5712
-    0xd870, 0xd86e, 0xd86c, 0xd86b, 0xd869, 0xd868, 0xd866, 0xd865, //  5720
-    0xd863, 0xd861, 0xd860, 0xd85e, 0xd85d, 0xd85b, 0xd859, 0xd858, //  5728
-    0xd856, 0xd855, 0xd853, 0xd852, 0xd850, 0xd84e, 0xd84d, 0xd84b, //  5736
-    0xd84a, 0xd848, 0xd847, 0xd845, 0xd843, 0xd842, 0xd840, 0xd83f, //  5744
-    0xd83d, 0xd83c, 0xd83a, 0xd838, 0xd837, 0xd835, 0xd834, 0xd832, //  5752
-    0xd831, 0xd82f, 0xd82d, 0xd82c, 0xd82a, 0xd829, 0xd827, 0xd825, //  5760
-    0xd824, 0xd822, 0xd821, 0xd81f, 0xd81e, 0xd81c, 0xd81a, 0xd819, //  5768
-    0xd817, 0xd816, 0xd814, 0xd813, 0xd811, 0xd80f, 0xd80e, 0xd80c, //  5776
-    0xd80b, 0xd809, 0xd808, 0xd806, 0xd804, 0xd803, 0xd801, 0xd800, //  5784
-    0xd7fe, 0xd7fc, 0xd7fb, 0xd7f9, 0xd7f8, 0xd7f6, 0xd7f5, 0xd7f3, //  5792
-    0xd7f1, 0xd7f0, 0xd7ee, 0xd7ed, 0xd7eb, 0xd7ea, 0xd7e8, 0xd7e6, //  5800
-    0xd7e5, 0xd7e3, 0xd7e2, 0xd7e0, 0xd7df, 0xd7dd, 0xd7db, 0xd7da, //  5808
-    0xd7d8, 0xd7d7, 0xd7d5, 0xd7d4, 0xd7d2, 0xd7d0, 0xd7cf, 0xd7cd, //  5816
-    0xd7cc, 0xd7ca, 0xd7c8, 0xd7c7, 0xd7c5, 0xd7c4, 0xd7c2, 0xd7c1, //  5824
-    0xd7bf, 0xd7bd, 0xd7bc, 0xd7ba, 0xd7b9, 0xd7b7, 0xd7b6, 0xd7b4, //  5832
-    0xd7b2, 0xd7b1, 0xd7af, 0xd7ae, 0xd7ac, 0xd7ab, 0xd7a9, 0xd7a7, //  5840
-    0xd7a6, 0xd7a4, 0xd7a3, 0xd7a1, 0xd79f, 0xd79e, 0xd79c, 0xd79b, //  5848
-    0xd799, 0xd798, 0xd796, 0xd794, 0xd793, 0xd791, 0xd790, 0xd78e, //  5856
-    0xd78d, 0xd78b, 0xd789, 0xd788, 0xd786, 0xd785, 0xd783, 0xd782, //  5864
-    0xd780, 0xd77e, 0xd77d, 0xd77b, 0xd77a, 0xd778, 0xd777, 0xd775, //  5872
-    0xd773, 0xd772, 0xd770, 0xd76f, 0xd76d, 0xd76b, 0xd76a, 0xd768, //  5880
-    0xd767, 0xd765, 0xd764, 0xd762, 0xd760, 0xd75f, 0xd75d, 0xd75c, //  5888
-    0xd75a, 0xd759, 0xd757, 0xd755, 0xd754, 0xd752, 0xd751, 0xd74f, //  5896
-    0xd74e, 0xd74c, 0xd74a, 0xd749, 0xd747, 0xd746, 0xd744, 0xd742, //  5904
-    0xd741, 0xd73f, 0xd73e, 0xd73c, 0xd73b, 0xd739, 0xd737, 0xd736, //  5912
-    0xd734, 0xd733, 0xd731, 0xd730, 0xd72e, 0xd72c, 0xd72b, 0xd729, //  5920
-    0xd728, 0xd726, 0xd725, 0xd723, 0xd721, 0xd720, 0xd71e, 0xd71d, //  5928
-    0xd71b, 0xd71a, 0xd718, 0xd716, 0xd715, 0xd713, 0xd712, 0xd710, //  5936
-    0xd70e, 0xd70d, 0xd70b, 0xd70a, 0xd708, 0xd707, 0xd705, 0xd703, //  5944
-    0xd702, 0xd700, 0xd6ff, 0xd6fd, 0xd6fc, 0xd6fa, 0xd6f8, 0xd6f7, //  5952
-    0xd6f5, 0xd6f4, 0xd6f2, 0xd6f1, 0xd6ef, 0xd6ed, 0xd6ec, 0xd6ea, //  5960
-    0xd6e9, 0xd6e7, 0xd6e6, 0xd6e4, 0xd6e2, 0xd6e1, 0xd6df, 0xd6de, //  5968
-    0xd6dc, 0xd6da, 0xd6d9, 0xd6d7, 0xd6d6, 0xd6d4, 0xd6d3, 0xd6d1, //  5976
-    0xd6cf, 0xd6ce, 0xd6cc, 0xd6cb, 0xd6c9, 0xd6c8, 0xd6c6, 0xd6c4, //  5984
-    0xd6c3, 0xd6c1, 0xd6c0, 0xd6be, 0xd6bd, 0xd6bb, 0xd6b9, 0xd6b8, //  5992
-    0xd6b6, 0xd6b5, 0xd6b3, 0xd6b1, 0xd6b0, 0xd6ae, 0xd6ad, 0xd6ab, //  6000
-    0xd6aa, 0xd6a8, 0xd6a6, 0xd6a5, 0xd6a3, 0xd6a2, 0xd6a0, 0xd69f, //  6008
-    0xd69d, 0xd69b, 0xd69a, 0xd698, 0xd697, 0xd695, 0xd694, 0xd692, //  6016
-    0xd690, 0xd68f, 0xd68d, 0xd68c, 0xd68a, 0xd689, 0xd687, 0xd685, //  6024
-    0xd684, 0xd682, 0xd681, 0xd67f, 0xd67d, 0xd67c, 0xd67a, 0xd679, //  6032
-    0xd677, 0xd676, 0xd674, 0xd672, 0xd671, 0xd66f, 0xd66e, 0xd66c, //  6040
-    0xd66b, 0xd669, 0xd667, 0xd666, 0xd664, 0xd663, 0xd661, 0xd660, //  6048
-    0xd65e, 0xd65c, 0xd65b, 0xd659, 0xd658, 0xd656, 0xd654, 0xd653, //  6056
-    0xd651, 0xd650, 0xd64e, 0xd64d, 0xd64b, 0xd649, 0xd648, 0xd646, //  6064
-    0xd645, 0xd643, 0xd642, 0xd640, 0xd63e, 0xd63d, 0xd63b, 0xd63a, //  6072
-    0xd638, 0xd637, 0xd635, 0xd633, 0xd632, 0xd630, 0xd62f, 0xd62d, //  6080
-    0xd62c, 0xd62a, 0xd628, 0xd627, 0xd625, 0xd624, 0xd622, 0xd620, //  6088
-    0xd61f, 0xd61d, 0xd61c, 0xd61a, 0xd619, 0xd617, 0xd615, 0xd614, //  6096
-    0xd612, 0xd611, 0xd60f, 0xd60e, 0xd60c, 0xd60a, 0xd609, 0xd607, //  6104
-    0xd606, 0xd604, 0xd603, 0xd601, 0xd5ff, 0xd5fe, 0xd5fc, 0xd5fb, //  6112
-    0xd5f9, 0xd5f8, 0xd5f6, 0xd5f4, 0xd5f3, 0xd5f1, 0xd5f0, 0xd5ee, //  6120
-    0xd5ec, 0xd5eb, 0xd5e9, 0xd5e8, 0xd5e6, 0xd5e5, 0xd5e3, 0xd5e1, //  6128
-    0xd5e0, 0xd5de, 0xd5dd, 0xd5db, 0xd5da, 0xd5d8, 0xd5d6, 0xd5d5, //  6136
-    0xd5d3, 0xd5d1, 0xd5d0, 0xd5ce, 0xd5cd, 0xd5cb, 0xd5ca, 0xd5c8, //  6144
-    0xd5c7, 0xd5c5, 0xd5c4, 0xd5c2, 0xd5c1, 0xd5bf, 0xd5be, 0xd5bc, //  6152
-    0xd5bb, 0xd5b9, 0xd5b8, 0xd5b6, 0xd5b4, 0xd5b3, 0xd5b1, 0xd5b0, //  6160
-    0xd5ae, 0xd5ad, 0xd5ab, 0xd5aa, 0xd5a8, 0xd5a7, 0xd5a5, 0xd5a4, //  6168
-    0xd5a2, 0xd5a1, 0xd59f, 0xd59e, 0xd59c, 0xd59b, 0xd599, 0xd598, //  6176
-    0xd596, 0xd595, 0xd593, 0xd592, 0xd590, 0xd58f, 0xd58d, 0xd58c, //  6184
-    0xd58a, 0xd589, 0xd587, 0xd586, 0xd584, 0xd583, 0xd581, 0xd57f, //  6192
-    0xd57e, 0xd57c, 0xd57b, 0xd579, 0xd578, 0xd576, 0xd575, 0xd573, //  6200
-    0xd572, 0xd570, 0xd56f, 0xd56d, 0xd56c, 0xd56a, 0xd569, 0xd567, //  6208
-    0xd566, 0xd564, 0xd563, 0xd561, 0xd560, 0xd55e, 0xd55d, 0xd55b, //  6216
-    0xd55a, 0xd558, 0xd557, 0xd555, 0xd554, 0xd552, 0xd551, 0xd54f, //  6224
-    0xd54e, 0xd54c, 0xd54b, 0xd549, 0xd547, 0xd546, 0xd544, 0xd543, //  6232
-    0xd541, 0xd540, 0xd53e, 0xd53d, 0xd53b, 0xd53a, 0xd538, 0xd537, //  6240
-    0xd535, 0xd534, 0xd532, 0xd531, 0xd52f, 0xd52e, 0xd52c, 0xd52b, //  6248
-    0xd529, 0xd528, 0xd526, 0xd525, 0xd523, 0xd522, 0xd520, 0xd51f, //  6256
-    0xd51d, 0xd51c, 0xd51a, 0xd519, 0xd517, 0xd516, 0xd514, 0xd513, //  6264
-    0xd511, 0xd50f, 0xd50e, 0xd50c, 0xd50b, 0xd509, 0xd508, 0xd506, //  6272
-    0xd505, 0xd503, 0xd502, 0xd500, 0xd4ff, 0xd4fd, 0xd4fc, 0xd4fa, //  6280
-    0xd4f9, 0xd4f7, 0xd4f6, 0xd4f4, 0xd4f3, 0xd4f1, 0xd4f0, 0xd4ee, //  6288
-    0xd4ed, 0xd4eb, 0xd4ea, 0xd4e8, 0xd4e7, 0xd4e5, 0xd4e4, 0xd4e2, //  6296
-    0xd4e1, 0xd4df, 0xd4de, 0xd4dc, 0xd4db, 0xd4d9, 0xd4d7, 0xd4d6, //  6304
-    0xd4d4, 0xd4d3, 0xd4d1, 0xd4d0, 0xd4ce, 0xd4cd, 0xd4cb, 0xd4ca, //  6312
-    0xd4c8, 0xd4c7, 0xd4c5, 0xd4c4, 0xd4c2, 0xd4c1, 0xd4bf, 0xd4be, //  6320
-    0xd4bc, 0xd4bb, 0xd4b9, 0xd4b8, 0xd4b6, 0xd4b5, 0xd4b3, 0xd4b2, //  6328
-    0xd4b0, 0xd4af, 0xd4ad, 0xd4ac, 0xd4aa, 0xd4a9, 0xd4a7, 0xd4a6, //  6336
-    0xd4a4, 0xd4a3, 0xd4a1, 0xd49f, 0xd49e, 0xd49c, 0xd49b, 0xd499, //  6344
-    0xd498, 0xd496, 0xd495, 0xd493, 0xd492, 0xd490, 0xd48f, 0xd48d, //  6352
-    0xd48c, 0xd48a, 0xd489, 0xd487, 0xd486, 0xd484, 0xd483, 0xd481, //  6360
-    0xd480, 0xd47e, 0xd47d, 0xd47b, 0xd47a, 0xd478, 0xd477, 0xd475, //  6368
-    0xd474, 0xd472, 0xd471, 0xd46f, 0xd46e, 0xd46c, 0xd46a, 0xd469, //  6376
-    0xd467, 0xd466, 0xd464, 0xd463, 0xd461, 0xd460, 0xd45e, 0xd45d, //  6384
-    0xd45b, 0xd45a, 0xd458, 0xd457, 0xd455, 0xd454, 0xd452, 0xd451, //  6392
-    0xd44f, 0xd44e, 0xd44c, 0xd44b, 0xd449, 0xd448, 0xd446, 0xd445, //  6400
-    0xd443, 0xd442, 0xd440, 0xd43f, 0xd43d, 0xd43c, 0xd43a, 0xd439, //  6408
-    0xd437, 0xd436, 0xd434, 0xd432, 0xd431, 0xd42f, 0xd42e, 0xd42c, //  6416
-    0xd42b, 0xd429, 0xd428, 0xd426, 0xd425, 0xd423, 0xd422, 0xd420, //  6424
-    0xd41f, 0xd41d, 0xd41c, 0xd41a, 0xd419, 0xd417, 0xd416, 0xd414, //  6432
-    0xd413, 0xd411, 0xd410, 0xd40e, 0xd40d, 0xd40b, 0xd40a, 0xd408, //  6440
-    0xd407, 0xd405, 0xd404, 0xd402, 0xd401, 0xd3ff, 0xd3fe, 0xd3fc, //  6448
-    0xd3fa, 0xd3f9, 0xd3f7, 0xd3f6, 0xd3f4, 0xd3f3, 0xd3f1, 0xd3f0, //  6456
-    0xd3ee, 0xd3ed, 0xd3eb, 0xd3ea, 0xd3e8, 0xd3e7, 0xd3e5, 0xd3e4, //  6464
-    0xd3e2, 0xd3e1, 0xd3df, 0xd3de, 0xd3dc, 0xd3db, 0xd3d9, 0xd3d8, //  6472
-    0xd3d6, 0xd3d5, 0xd3d3, 0xd3d2, 0xd3d0, 0xd3cf, 0xd3cd, 0xd3cc, //  6480
-    0xd3ca, 0xd3c9, 0xd3c7, 0xd3c6, 0xd3c4, 0xd3c2, 0xd3c1, 0xd3bf, //  6488
-    0xd3be, 0xd3bc, 0xd3bb, 0xd3b9, 0xd3b8, 0xd3b6, 0xd3b5, 0xd3b3, //  6496
-    0xd3b2, 0xd3b0, 0xd3af, 0xd3ad, 0xd3ac, 0xd3aa, 0xd3a9, 0xd3a7, //  6504
-    0xd3a6, 0xd3a4, 0xd3a3, 0xd3a1, 0xd3a0, 0xd39e, 0xd39d, 0xd39b, //  6512
-    0xd39a, 0xd398, 0xd397, 0xd395, 0xd394, 0xd392, 0xd391, 0xd38f, //  6520
-    0xd38e, 0xd38c, 0xd38a, 0xd389, 0xd387, 0xd386, 0xd384, 0xd383, //  6528
-    0xd381, 0xd380, 0xd37e, 0xd37d, 0xd37b, 0xd37a, 0xd378, 0xd377, //  6536
-    0xd375, 0xd374, 0xd372, 0xd371, 0xd36f, 0xd36e, 0xd36c, 0xd36b, //  6544
-    0xd369, 0xd368, 0xd366, 0xd365, 0xd363, 0xd362, 0xd360, 0xd35f, //  6552
-    0xd35d, 0xd35c, 0xd35a, 0xd359, 0xd357, 0xd355, 0xd354, 0xd352, //  6560
-    0xd351, 0xd34f, 0xd34e, 0xd34c, 0xd34b, 0xd349, 0xd348, 0xd346, //  6568
-    0xd345, 0xd343, 0xd342, 0xd340, 0xd33f, 0xd33d, 0xd33c, 0xd33a, //  6576
-    0xd339, 0xd337, 0xd336, 0xd334, 0xd333, 0xd331, 0xd330, 0xd32e, //  6584
-    0xd32d, 0xd32b, 0xd32a, 0xd328, 0xd327, 0xd325, 0xd324, 0xd322, //  6592
-    0xd321, 0xd31f, 0xd31d, 0xd31c, 0xd31a, 0xd319, 0xd317, 0xd316, //  6600
-    0xd314, 0xd313, 0xd311, 0xd310, 0xd30e, 0xd30d, 0xd30b, 0xd30a, //  6608
-    0xd308, 0xd307, 0xd305, 0xd304, 0xd302, 0xd301, 0xd2ff, 0xd2fe, //  6616
-    0xd2fc, 0xd2fb, 0xd2f9, 0xd2f8, 0xd2f6, 0xd2f5, 0xd2f3, 0xd2f2, //  6624
-    0xd2f0, 0xd2ef, 0xd2ed, 0xd2ec, 0xd2ea, 0xd2e9, 0xd2e7, 0xd2e5, //  6632
-    0xd2e4, 0xd2e2, 0xd2e1, 0xd2df, 0xd2de, 0xd2dc, 0xd2db, 0xd2d9, //  6640
-    0xd2d8, 0xd2d6, 0xd2d5, 0xd2d3, 0xd2d2, 0xd2d0, 0xd2cf, 0xd2cd, //  6648
-    0xd2cc, 0xd2ca, 0xd2c9, 0xd2c7, 0xd2c6, 0xd2c4, 0xd2c3, 0xd2c1, //  6656
-    0xd2c0, 0xd2be, 0xd2bd, 0xd2bb, 0xd2ba, 0xd2b8, 0xd2b7, 0xd2b5, //  6664
-    0xd2b4, 0xd2b2, 0xd2b1, 0xd2af, 0xd2ad, 0xd2ac, 0xd2aa, 0xd2a9, //  6672
-    0xd2a7, 0xd2a6, 0xd2a4, 0xd2a3, 0xd2a1, 0xd2a0, 0xd29e, 0xd29d, //  6680
-    0xd29b, 0xd29a, 0xd298, 0xd297, 0xd295, 0xd294, 0xd292, 0xd291, //  6688
-    0xd28f, 0xd28e, 0xd28c, 0xd28b, 0xd289, 0xd288, 0xd286, 0xd285, //  6696
-    0xd283, 0xd282, 0xd280, 0xd27f, 0xd27d, 0xd27c, 0xd27a, 0xd278, //  6704
-    0xd277, 0xd275, 0xd274, 0xd272, 0xd271, 0xd26f, 0xd26e, 0xd26c, //  6712
-    0xd26b, 0xd269, 0xd268, 0xd266, 0xd265, 0xd263, 0xd262, 0xd260, //  6720
-    0xd25f, 0xd25d, 0xd25c, 0xd25a, 0xd259, 0xd257, 0xd256, 0xd254, //  6728
-    0xd253, 0xd251, 0xd250, 0xd24e, 0xd24d, 0xd24b, 0xd24a, 0xd248, //  6736
-    0xd247, 0xd245, 0xd244, 0xd242, 0xd240, 0xd23f, 0xd23d, 0xd23c, //  6744
-    0xd23a, 0xd239, 0xd237, 0xd236, 0xd234, 0xd233, 0xd231, 0xd230, //  6752
-    0xd22e, 0xd22d, 0xd22b, 0xd22a, 0xd228, 0xd227, 0xd225, 0xd224, //  6760
-    0xd222, 0xd221, 0xd21f, 0xd21e, 0xd21c, 0xd21b, 0xd219, 0xd218, //  6768
-    0xd216, 0xd215, 0xd213, 0xd212, 0xd210, 0xd20f, 0xd20d, 0xd20c, //  6776
-    0xd20a, 0xd208, 0xd207, 0xd205, 0xd204, 0xd202, 0xd201, 0xd1ff, //  6784
-    0xd1fe, 0xd1fc, 0xd1fb, 0xd1f9, 0xd1f8, 0xd1f6, 0xd1f5, 0xd1f3, //  6792
-    0xd1f2, 0xd1f0, 0xd1ef, 0xd1ed, 0xd1ec, 0xd1ea, 0xd1e9, 0xd1e7, //  6800
-    0xd1e6, 0xd1e4, 0xd1e3, 0xd1e1, 0xd1e0, 0xd1de, 0xd1dd, 0xd1db, //  6808
-    0xd1da, 0xd1d8, 0xd1d7, 0xd1d5, 0xd1d4, 0xd1d2, 0xd1d0, 0xd1cf, //  6816
-    0xd1cd, 0xd1cc, 0xd1ca, 0xd1c9, 0xd1c7, 0xd1c6, 0xd1c4, 0xd1c3, //  6824
-    0xd1c1, 0xd1c0, 0xd1be, 0xd1bd, 0xd1bb, 0xd1ba, 0xd1b8, 0xd1b7, //  6832
-    0xd1b5, 0xd1b4, 0xd1b2, 0xd1b1, 0xd1af, 0xd1ae, 0xd1ac, 0xd1ab, //  6840
-    0xd1a9, 0xd1a8, 0xd1a6, 0xd1a5, 0xd1a3, 0xd1a2, 0xd1a0, 0xd19f, //  6848
-    0xd19d, 0xd19c, 0xd19a, 0xd198, 0xd197, 0xd195, 0xd194, 0xd192, //  6856
-    0xd191, 0xd18f, 0xd18e, 0xd18c, 0xd18b, 0xd189, 0xd188, 0xd186, //  6864
-    0xd185, 0xd183, 0xd182, 0xd180, 0xd17f, 0xd17d, 0xd17c, 0xd17a, //  6872
-    0xd179, 0xd177, 0xd176, 0xd174, 0xd173, 0xd171, 0xd170, 0xd16e, //  6880
-    0xd16d, 0xd16b, 0xd16a, 0xd168, 0xd167, 0xd165, 0xd163, 0xd162, //  6888
-    0xd160, 0xd15f, 0xd15d, 0xd15c, 0xd15a, 0xd159, 0xd157, 0xd156, //  6896
-    0xd154, 0xd153, 0xd151, 0xd150, 0xd14e, 0xd14d, 0xd14b, 0xd14a, //  6904
-    0xd148, 0xd147, 0xd145, 0xd144, 0xd142, 0xd141, 0xd13f, 0xd13e, //  6912
-    0xd13c, 0xd13b, 0xd139, 0xd138, 0xd136, 0xd135, 0xd133, 0xd132, //  6920
-    0xd130, 0xd12f, 0xd12d, 0xd12b, 0xd12a, 0xd128, 0xd127, 0xd125, //  6928
-    0xd124, 0xd122, 0xd121, 0xd11f, 0xd11e, 0xd11c, 0xd11b, 0xd119, //  6936
-    0xd118, 0xd116, 0xd115, 0xd113, 0xd112, 0xd110, 0xd10f, 0xd10d, //  6944
-    0xd10c, 0xd10a, 0xd109, 0xd107, 0xd106, 0xd104, 0xd103, 0xd101, //  6952
-    0xd100, 0xd0fe, 0xd0fd, 0xd0fb, 0xd0fa, 0xd0f8, 0xd0f7, 0xd0f5, //  6960
-    0xd0f3, 0xd0f2, 0xd0f0, 0xd0ef, 0xd0ed, 0xd0ec, 0xd0ea, 0xd0e9, //  6968
-    0xd0e7, 0xd0e6, 0xd0e4, 0xd0e3, 0xd0e1, 0xd0e0, 0xd0de, 0xd0dd, //  6976
-    0xd0db, 0xd0da, 0xd0d8, 0xd0d7, 0xd0d5, 0xd0d4, 0xd0d2, 0xd0d1, //  6984
-    0xd0cf, 0xd0ce, 0xd0cc, 0xd0cb, 0xd0c9, 0xd0c8, 0xd0c6, 0xd0c5, //  6992
-    0xd0c3, 0xd0c2, 0xd0c0, 0xd0bf, 0xd0bd, 0xd0bb, 0xd0ba, 0xd0b8, //  7000
-    0xd0b7, 0xd0b5, 0xd0b4, 0xd0b2, 0xd0b1, 0xd0af, 0xd0ae, 0xd0ac, //  7008
-    0xd0ab, 0xd0a9, 0xd0a8, 0xd0a6, 0xd0a5, 0xd0a3, 0xd0a2, 0xd0a0, //  7016
-    0xd09f, 0xd09d, 0xd09c, 0xd09a, 0xd099, 0xd097, 0xd096, 0xd094, //  7024
-    0xd093, 0xd091, 0xd090, 0xd08e, 0xd08d, 0xd08b, 0xd08a, 0xd088, //  7032
-    0xd087, 0xd085, 0xd083, 0xd082, 0xd080, 0xd07f, 0xd07d, 0xd07c, //  7040
-    0xd07a, 0xd079, 0xd077, 0xd076, 0xd074, 0xd073, 0xd071, 0xd070, //  7048
-    0xd06e, 0xd06d, 0xd06b, 0xd06a, 0xd068, 0xd067, 0xd065, 0xd064, //  7056
-    0xd062, 0xd061, 0xd05f, 0xd05e, 0xd05c, 0xd05b, 0xd059, 0xd058, //  7064
-    0xd056, 0xd055, 0xd053, 0xd052, 0xd050, 0xd04e, 0xd04d, 0xd04b, //  7072
-    0xd04a, 0xd048, 0xd047, 0xd045, 0xd044, 0xd042, 0xd041, 0xd03f, //  7080
-    0xd03e, 0xd03c, 0xd03b, 0xd039, 0xd038, 0xd036, 0xd035, 0xd033, //  7088
-    0xd032, 0xd030, 0xd02f, 0xd02d, 0xd02c, 0xd02a, 0xd029, 0xd027, //  7096
-    0xd026, 0xd024, 0xd023, 0xd021, 0xd020, 0xd01e, 0xd01d, 0xd01b, //  7104
-    0xd01a, 0xd018, 0xd016, 0xd015, 0xd013, 0xd012, 0xd010, 0xd00f, //  7112
-    0xd00d, 0xd00c, 0xd00a, 0xd009, 0xd007, 0xd006, 0xd004, 0xd003, //  7120
-    0xd001, 0xd000, 0xcffe, 0xcffd, 0xcffb, 0xcffa, 0xcff8, 0xcff7, //  7128
-    0xcff5, 0xcff4, 0xcff2, 0xcff1, 0xcfef, 0xcfee, 0xcfec, 0xcfeb, //  7136
-    0xcfe9, 0xcfe8, 0xcfe6, 0xcfe5, 0xcfe3, 0xcfe2, 0xcfe0, 0xcfde, //  7144
-    0xcfdd, 0xcfdb, 0xcfda, 0xcfd8, 0xcfd7, 0xcfd5, 0xcfd4, 0xcfd2, //  7152
-    0xcfd1, 0xcfcf, 0xcfce, 0xcfcc, 0xcfcb, 0xcfc9, 0xcfc8, 0xcfc6, //  7160
-    0xcfc4, 0xcfc2, 0xcfc1, 0xcfbf, 0xcfbe, 0xcfbc, 0xcfbb, 0xcfba, //  7168
-    0xcfb8, 0xcfb7, 0xcfb5, 0xcfb4, 0xcfb2, 0xcfb1, 0xcfaf, 0xcfae, //  7176
-    0xcfac, 0xcfab, 0xcfa9, 0xcfa8, 0xcfa7, 0xcfa5, 0xcfa4, 0xcfa2, //  7184
-    0xcfa1, 0xcf9f, 0xcf9e, 0xcf9c, 0xcf9b, 0xcf99, 0xcf98, 0xcf97, //  7192
-    0xcf95, 0xcf94, 0xcf92, 0xcf91, 0xcf8f, 0xcf8e, 0xcf8c, 0xcf8b, //  7200
-    0xcf89, 0xcf88, 0xcf86, 0xcf85, 0xcf84, 0xcf82, 0xcf81, 0xcf7f, //  7208
-    0xcf7e, 0xcf7c, 0xcf7b, 0xcf79, 0xcf78, 0xcf76, 0xcf75, 0xcf74, //  7216
-    0xcf72, 0xcf71, 0xcf6f, 0xcf6e, 0xcf6c, 0xcf6b, 0xcf69, 0xcf68, //  7224
-    0xcf66, 0xcf65, 0xcf63, 0xcf62, 0xcf61, 0xcf5f, 0xcf5e, 0xcf5c, //  7232
-    0xcf5b, 0xcf59, 0xcf58, 0xcf56, 0xcf55, 0xcf53, 0xcf52, 0xcf50, //  7240
-    0xcf4f, 0xcf4e, 0xcf4c, 0xcf4b, 0xcf49, 0xcf48, 0xcf46, 0xcf45, //  7248
-    0xcf43, 0xcf42, 0xcf40, 0xcf3f, 0xcf3e, 0xcf3c, 0xcf3b, 0xcf39, //  7256
-    0xcf38, 0xcf36, 0xcf35, 0xcf33, 0xcf32, 0xcf30, 0xcf2f, 0xcf2d, //  7264
-    0xcf2c, 0xcf2b, 0xcf29, 0xcf28, 0xcf26, 0xcf25, 0xcf23, 0xcf22, //  7272
-    0xcf20, 0xcf1f, 0xcf1d, 0xcf1c, 0xcf1b, 0xcf19, 0xcf18, 0xcf16, //  7280
-    0xcf15, 0xcf13, 0xcf12, 0xcf10, 0xcf0f, 0xcf0d, 0xcf0c, 0xcf0a, //  7288
-    0xcf09, 0xcf08, 0xcf06, 0xcf05, 0xcf03, 0xcf02, 0xcf00, 0xceff, //  7296
-    0xcefd, 0xcefc, 0xcefa, 0xcef9, 0xcef7, 0xcef6, 0xcef5, 0xcef3, //  7304
-    0xcef2, 0xcef0, 0xceef, 0xceed, 0xceec, 0xceea, 0xcee9, 0xcee7, //  7312
-    0xcee6, 0xcee5, 0xcee3, 0xcee2, 0xcee0, 0xcedf, 0xcedd, 0xcedc, //  7320
-    0xceda, 0xced9, 0xced7, 0xced6, 0xced4, 0xced3, 0xced2, 0xced0, //  7328
-    0xcecf, 0xcecd, 0xcecc, 0xceca, 0xcec9, 0xcec7, 0xcec6, 0xcec4, //  7336
-    0xcec3, 0xcec2, 0xcec0, 0xcebf, 0xcebd, 0xcebc, 0xceba, 0xceb9, //  7344
-    0xceb7, 0xceb6, 0xceb4, 0xceb3, 0xceb1, 0xceb0, 0xceaf, 0xcead, //  7352
-    0xceac, 0xceaa, 0xcea9, 0xcea7, 0xcea6, 0xcea4, 0xcea3, 0xcea1, //  7360
-    0xcea0, 0xce9e, 0xce9d, 0xce9c, 0xce9a, 0xce99, 0xce97, 0xce96, //  7368
-    0xce94, 0xce93, 0xce91, 0xce90, 0xce8e, 0xce8d, 0xce8c, 0xce8a, //  7376
-    0xce89, 0xce87, 0xce86, 0xce84, 0xce83, 0xce81, 0xce80, 0xce7e, //  7384
-    0xce7d, 0xce7b, 0xce7a, 0xce79, 0xce77, 0xce76, 0xce74, 0xce73, //  7392
-    0xce71, 0xce70, 0xce6e, 0xce6d, 0xce6b, 0xce6a, 0xce69, 0xce67, //  7400
-    0xce66, 0xce64, 0xce63, 0xce61, 0xce60, 0xce5e, 0xce5d, 0xce5b, //  7408
-    0xce5a, 0xce58, 0xce57, 0xce56, 0xce54, 0xce53, 0xce51, 0xce50, //  7416
-    0xce4e, 0xce4d, 0xce4b, 0xce4a, 0xce48, 0xce47, 0xce45, 0xce44, //  7424
-    0xce43, 0xce41, 0xce40, 0xce3e, 0xce3d, 0xce3b, 0xce3a, 0xce38, //  7432
-    0xce37, 0xce35, 0xce34, 0xce33, 0xce31, 0xce30, 0xce2e, 0xce2d, //  7440
-    0xce2b, 0xce2a, 0xce28, 0xce27, 0xce25, 0xce24, 0xce22, 0xce21, //  7448
-    0xce20, 0xce1e, 0xce1d, 0xce1b, 0xce1a, 0xce18, 0xce17, 0xce15, //  7456
-    0xce14, 0xce12, 0xce11, 0xce10, 0xce0e, 0xce0d, 0xce0b, 0xce0a, //  7464
-    0xce08, 0xce07, 0xce05, 0xce04, 0xce02, 0xce01, 0xcdff, 0xcdfe, //  7472
-    0xcdfd, 0xcdfb, 0xcdfa, 0xcdf8, 0xcdf7, 0xcdf5, 0xcdf4, 0xcdf2, //  7480
-    0xcdf1, 0xcdef, 0xcdee, 0xcdec, 0xcdeb, 0xcdea, 0xcde8, 0xcde7, //  7488
-    0xcde5, 0xcde4, 0xcde2, 0xcde1, 0xcddf, 0xcdde, 0xcddc, 0xcddb, //  7496
-    0xcdda, 0xcdd8, 0xcdd7, 0xcdd5, 0xcdd4, 0xcdd2, 0xcdd1, 0xcdcf, //  7504
-    0xcdce, 0xcdcc, 0xcdcb, 0xcdc9, 0xcdc8, 0xcdc7, 0xcdc5, 0xcdc4, //  7512
-    0xcdc2, 0xcdc1, 0xcdbf, 0xcdbe, 0xcdbc, 0xcdbb, 0xcdb9, 0xcdb8, //  7520
-    0xcdb7, 0xcdb5, 0xcdb4, 0xcdb2, 0xcdb1, 0xcdaf, 0xcdae, 0xcdac, //  7528
-    0xcdab, 0xcda9, 0xcda8, 0xcda6, 0xcda5, 0xcda4, 0xcda2, 0xcda1, //  7536
-    0xcd9f, 0xcd9e, 0xcd9c, 0xcd9b, 0xcd99, 0xcd98, 0xcd96, 0xcd95, //  7544
-    0xcd94, 0xcd92, 0xcd91, 0xcd8f, 0xcd8e, 0xcd8c, 0xcd8b, 0xcd89, //  7552
-    0xcd88, 0xcd86, 0xcd85, 0xcd83, 0xcd82, 0xcd81, 0xcd7f, 0xcd7e, //  7560
-    0xcd7c, 0xcd7b, 0xcd79, 0xcd78, 0xcd76, 0xcd75, 0xcd73, 0xcd72, //  7568
-    0xcd70, 0xcd6f, 0xcd6e, 0xcd6c, 0xcd6b, 0xcd69, 0xcd68, 0xcd66, //  7576
-    0xcd65, 0xcd63, 0xcd62, 0xcd60, 0xcd5f, 0xcd5e, 0xcd5c, 0xcd5b, //  7584
-    0xcd59, 0xcd58, 0xcd56, 0xcd55, 0xcd53, 0xcd52, 0xcd50, 0xcd4f, //  7592
-    0xcd4d, 0xcd4c, 0xcd4b, 0xcd49, 0xcd48, 0xcd46, 0xcd45, 0xcd43, //  7600
-    0xcd42, 0xcd40, 0xcd3f, 0xcd3d, 0xcd3c, 0xcd3b, 0xcd39, 0xcd38, //  7608
-    0xcd36, 0xcd35, 0xcd33, 0xcd32, 0xcd30, 0xcd2f, 0xcd2d, 0xcd2c, //  7616
-    0xcd2a, 0xcd29, 0xcd28, 0xcd26, 0xcd25, 0xcd23, 0xcd22, 0xcd20, //  7624
-    0xcd1f, 0xcd1d, 0xcd1c, 0xcd1a, 0xcd19, 0xcd17, 0xcd16, 0xcd15, //  7632
-    0xcd13, 0xcd12, 0xcd10, 0xcd0f, 0xcd0d, 0xcd0c, 0xcd0a, 0xcd09, //  7640
-    0xcd07, 0xcd06, 0xcd05, 0xcd03, 0xcd02, 0xcd00, 0xccff, 0xccfd, //  7648
-    0xccfc, 0xccfa, 0xccf9, 0xccf7, 0xccf6, 0xccf4, 0xccf3, 0xccf2, //  7656
-    0xccf0, 0xccef, 0xcced, 0xccec, 0xccea, 0xcce9, 0xcce7, 0xcce6, //  7664
-    0xcce4, 0xcce3, 0xcce2, 0xcce0, 0xccdf, 0xccdd, 0xccdc, 0xccda, //  7672
-    0xccd9, 0xccd7, 0xccd6, 0xccd4, 0xccd3, 0xccd1, 0xccd0, 0xcccf, //  7680
-    0xcccd, 0xcccc, 0xccca, 0xccc9, 0xccc7, 0xccc6, 0xccc4, 0xccc3, //  7688
-    0xccc1, 0xccc0, 0xccbe, 0xccbd, 0xccbc, 0xccba, 0xccb9, 0xccb7, //  7696
-    0xccb6, 0xccb4, 0xccb3, 0xccb1, 0xccb0, 0xccae, 0xccad, 0xccac, //  7704
-    0xccaa, 0xcca9, 0xcca7, 0xcca6, 0xcca4, 0xcca3, 0xcca1, 0xcca0, //  7712
-    0xcc9e, 0xcc9d, 0xcc9b, 0xcc9a, 0xcc99, 0xcc97, 0xcc96, 0xcc94, //  7720
-    0xcc93, 0xcc91, 0xcc90, 0xcc8e, 0xcc8d, 0xcc8b, 0xcc8a, 0xcc89, //  7728
-    0xcc87, 0xcc86, 0xcc84, 0xcc83, 0xcc81, 0xcc80, 0xcc7e, 0xcc7d, //  7736
-    0xcc7b, 0xcc7a, 0xcc78, 0xcc77, 0xcc76, 0xcc74, 0xcc73, 0xcc71, //  7744
-    0xcc70, 0xcc6e, 0xcc6d, 0xcc6b, 0xcc6a, 0xcc68, 0xcc67, 0xcc65, //  7752
-    0xcc64, 0xcc63, 0xcc61, 0xcc60, 0xcc5e, 0xcc5d, 0xcc5b, 0xcc5a, //  7760
-    0xcc58, 0xcc57, 0xcc55, 0xcc54, 0xcc53, 0xcc51, 0xcc50, 0xcc4e, //  7768
-    0xcc4d, 0xcc4b, 0xcc4a, 0xcc48, 0xcc47, 0xcc45, 0xcc44, 0xcc42, //  7776
-    0xcc41, 0xcc40, 0xcc3e, 0xcc3d, 0xcc3b, 0xcc3a, 0xcc38, 0xcc37, //  7784
-    0xcc35, 0xcc34, 0xcc32, 0xcc31, 0xcc30, 0xcc2e, 0xcc2d, 0xcc2b, //  7792
-    0xcc2a, 0xcc28, 0xcc27, 0xcc25, 0xcc24, 0xcc22, 0xcc21, 0xcc1f, //  7800
-    0xcc1e, 0xcc1d, 0xcc1b, 0xcc1a, 0xcc18, 0xcc17, 0xcc15, 0xcc14, //  7808
-    0xcc12, 0xcc11, 0xcc0f, 0xcc0e, 0xcc0c, 0xcc0b, 0xcc0a, 0xcc08, //  7816
-    0xcc07, 0xcc05, 0xcc04, 0xcc02, 0xcc01, 0xcbff, 0xcbfe, 0xcbfc, //  7824
-    0xcbfb, 0xcbfa, 0xcbf8, 0xcbf7, 0xcbf5, 0xcbf4, 0xcbf2, 0xcbf1, //  7832
-    0xcbef, 0xcbee, 0xcbec, 0xcbeb, 0xcbe9, 0xcbe8, 0xcbe7, 0xcbe5, //  7840
-    0xcbe4, 0xcbe2, 0xcbe1, 0xcbdf, 0xcbde, 0xcbdc, 0xcbdb, 0xcbd9, //  7848
-    0xcbd8, 0xcbd7, 0xcbd5, 0xcbd4, 0xcbd2, 0xcbd1, 0xcbcf, 0xcbce, //  7856
-    0xcbcc, 0xcbcb, 0xcbc9, 0xcbc8, 0xcbc6, 0xcbc5, 0xcbc4, 0xcbc2, //  7864
-    0xcbc1, 0xcbbf, 0xcbbe, 0xcbbc, 0xcbbb, 0xcbb9, 0xcbb8, 0xcbb6, //  7872
-    0xcbb5, 0xcbb3, 0xcbb2, 0xcbb1, 0xcbaf, 0xcbae, 0xcbac, 0xcbab, //  7880
-    0xcba9, 0xcba8, 0xcba6, 0xcba5, 0xcba3, 0xcba2, 0xcba1, 0xcb9f, //  7888
-    0xcb9e, 0xcb9c, 0xcb9b, 0xcb99, 0xcb98, 0xcb96, 0xcb95, 0xcb93, //  7896
-    0xcb92, 0xcb90, 0xcb8f, 0xcb8e, 0xcb8c, 0xcb8b, 0xcb89, 0xcb88, //  7904
-    0xcb86, 0xcb85, 0xcb83, 0xcb82, 0xcb80, 0xcb7f, 0xcb7e, 0xcb7c, //  7912
-    0xcb7b, 0xcb79, 0xcb78, 0xcb76, 0xcb75, 0xcb73, 0xcb72, 0xcb70, //  7920
-    0xcb6f, 0xcb6d, 0xcb6c, 0xcb6b, 0xcb69, 0xcb68, 0xcb66, 0xcb65, //  7928
-    0xcb63, 0xcb62, 0xcb60, 0xcb5f, 0xcb5d, 0xcb5c, 0xcb5a, 0xcb59, //  7936
-    0xcb58, 0xcb56, 0xcb55, 0xcb53, 0xcb52, 0xcb50, 0xcb4f, 0xcb4d, //  7944
-    0xcb4c, 0xcb4a, 0xcb49, 0xcb48, 0xcb46, 0xcb45, 0xcb43, 0xcb42, //  7952
-    0xcb40, 0xcb3f, 0xcb3d, 0xcb3c, 0xcb3a, 0xcb39, 0xcb37, 0xcb36, //  7960
-    0xcb35, 0xcb33, 0xcb32, 0xcb30, 0xcb2f, 0xcb2d, 0xcb2c, 0xcb2a, //  7968
-    0xcb29, 0xcb27, 0xcb26, 0xcb25, 0xcb23, 0xcb22, 0xcb20, 0xcb1f, //  7976
-    0xcb1d, 0xcb1c, 0xcb1a, 0xcb19, 0xcb17, 0xcb16, 0xcb14, 0xcb13, //  7984
-    0xcb12, 0xcb10, 0xcb0f, 0xcb0d, 0xcb0c, 0xcb0a, 0xcb09, 0xcb07, //  7992
-    0xcb06, 0xcb04, 0xcb03, 0xcb01, 0xcb00, 0xcaff, 0xcafd, 0xcafc, //  8000
-    0xcafa, 0xcaf9, 0xcaf7, 0xcaf6, 0xcaf4, 0xcaf3, 0xcaf1, 0xcaf0, //  8008
-    0xcaef, 0xcaed, 0xcaec, 0xcaea, 0xcae9, 0xcae7, 0xcae6, 0xcae4, //  8016
-    0xcae3, 0xcae1, 0xcae0, 0xcade, 0xcadd, 0xcadc, 0xcada, 0xcad9, //  8024
-    0xcad7, 0xcad6, 0xcad4, 0xcad3, 0xcad1, 0xcad0, 0xcace, 0xcacd, //  8032
-    0xcacc, 0xcaca, 0xcac9, 0xcac7, 0xcac6, 0xcac4, 0xcac3, 0xcac1, //  8040
-    0xcac0, 0xcabe, 0xcabd, 0xcabb, 0xcaba, 0xcab9, 0xcab7, 0xcab6, //  8048
-    0xcab4, 0xcab3, 0xcab1, 0xcab0, 0xcaae, 0xcaad, 0xcaab, 0xcaaa, //  8056
-    0xcaa9, 0xcaa7, 0xcaa6, 0xcaa4, 0xcaa3, 0xcaa1, 0xcaa0, 0xca9e, //  8064
-    0xca9d, 0xca9b, 0xca9a, 0xca98, 0xca97, 0xca96, 0xca94, 0xca93, //  8072
-    0xca91, 0xca90, 0xca8e, 0xca8d, 0xca8b, 0xca8a, 0xca88, 0xca87, //  8080
-    0xca85, 0xca84, 0xca83, 0xca81, 0xca80, 0xca7e, 0xca7d, 0xca7b, //  8088
-    0xca7a, 0xca78, 0xca77, 0xca75, 0xca74, 0xca73, 0xca71, 0xca70, //  8096
-    0xca6e, 0xca6d, 0xca6b, 0xca6a, 0xca68, 0xca67, 0xca65, 0xca64, //  8104
-    0xca62, 0xca61, 0xca60, 0xca5e, 0xca5d, 0xca5b, 0xca5a, 0xca58, //  8112
-    0xca57, 0xca55, 0xca54, 0xca52, 0xca51, 0xca50, 0xca4e, 0xca4d, //  8120
-    0xca4b, 0xca4a, 0xca48, 0xca47, 0xca45, 0xca44, 0xca42, 0xca41, //  8128
-    0xca3f, 0xca3e, 0xca3d, 0xca3b, 0xca3a, 0xca38, 0xca37, 0xca35, //  8136
-    0xca34, 0xca32, 0xca31, 0xca2f, 0xca2e, 0xca2c, 0xca2b, 0xca2a, //  8144
-    0xca28, 0xca27, 0xca25, 0xca24, 0xca22, 0xca21, 0xca1f, 0xca1e, //  8152
-    0xca1c, 0xca1b, 0xca1a, 0xca18, 0xca17, 0xca15, 0xca14, 0xca12, //  8160
-    0xca11, 0xca0f, 0xca0e, 0xca0c, 0xca0b, 0xca09, 0xca08, 0xca07, //  8168
-    0xca05, 0xca04, 0xca02, 0xca01, 0xc9ff, 0xc9fe, 0xc9fc, 0xc9fb, //  8176
-    0xc9f9, 0xc9f8, 0xc9f7, 0xc9f5, 0xc9f4, 0xc9f2, 0xc9f1, 0xc9ef, //  8184
-    0xc9ee, 0xc9ed, 0xc9eb, 0xc9ea, 0xc9e8, 0xc9e7, 0xc9e6, 0xc9e4, //  8192
-    0xc9e3, 0xc9e1, 0xc9e0, 0xc9df, 0xc9dd, 0xc9dc, 0xc9da, 0xc9d9, //  8200
-    0xc9d8, 0xc9d6, 0xc9d5, 0xc9d3, 0xc9d2, 0xc9d1, 0xc9cf, 0xc9ce, //  8208
-    0xc9cc, 0xc9cb, 0xc9c9, 0xc9c8, 0xc9c7, 0xc9c5, 0xc9c4, 0xc9c2, //  8216
-    0xc9c1, 0xc9c0, 0xc9be, 0xc9bd, 0xc9bb, 0xc9ba, 0xc9b9, 0xc9b7, //  8224
-    0xc9b6, 0xc9b4, 0xc9b3, 0xc9b2, 0xc9b0, 0xc9af, 0xc9ad, 0xc9ac, //  8232
-    0xc9ab, 0xc9a9, 0xc9a8, 0xc9a6, 0xc9a5, 0xc9a4, 0xc9a2, 0xc9a1, //  8240
-    0xc99f, 0xc99e, 0xc99d, 0xc99b, 0xc99a, 0xc998, 0xc997, 0xc996, //  8248
-    0xc994, 0xc993, 0xc991, 0xc990, 0xc98f, 0xc98d, 0xc98c, 0xc98a, //  8256
-    0xc989, 0xc987, 0xc986, 0xc985, 0xc983, 0xc982, 0xc980, 0xc97f, //  8264
-    0xc97e, 0xc97c, 0xc97b, 0xc979, 0xc978, 0xc977, 0xc975, 0xc974, //  8272
-    0xc972, 0xc971, 0xc970, 0xc96e, 0xc96d, 0xc96b, 0xc96a, 0xc969, //  8280
-    0xc967, 0xc966, 0xc964, 0xc963, 0xc962, 0xc960, 0xc95f, 0xc95d, //  8288
-    0xc95c, 0xc95b, 0xc959, 0xc958, 0xc956, 0xc955, 0xc954, 0xc952, //  8296
-    0xc951, 0xc94f, 0xc94e, 0xc94d, 0xc94b, 0xc94a, 0xc948, 0xc947, //  8304
-    0xc945, 0xc944, 0xc943, 0xc941, 0xc940, 0xc93e, 0xc93d, 0xc93c, //  8312
-    0xc93a, 0xc939, 0xc937, 0xc936, 0xc935, 0xc933, 0xc932, 0xc930, //  8320
-    0xc92f, 0xc92e, 0xc92c, 0xc92b, 0xc929, 0xc928, 0xc927, 0xc925, //  8328
-    0xc924, 0xc922, 0xc921, 0xc920, 0xc91e, 0xc91d, 0xc91b, 0xc91a, //  8336
-    0xc919, 0xc917, 0xc916, 0xc914, 0xc913, 0xc912, 0xc910, 0xc90f, //  8344
-    0xc90d, 0xc90c, 0xc90b, 0xc909, 0xc908, 0xc906, 0xc905, 0xc903, //  8352
-    0xc902, 0xc901, 0xc8ff, 0xc8fe, 0xc8fc, 0xc8fb, 0xc8fa, 0xc8f8, //  8360
-    0xc8f7, 0xc8f5, 0xc8f4, 0xc8f3, 0xc8f1, 0xc8f0, 0xc8ee, 0xc8ed, //  8368
-    0xc8ec, 0xc8ea, 0xc8e9, 0xc8e7, 0xc8e6, 0xc8e5, 0xc8e3, 0xc8e2, //  8376
-    0xc8e0, 0xc8df, 0xc8de, 0xc8dc, 0xc8db, 0xc8d9, 0xc8d8, 0xc8d7, //  8384
-    0xc8d5, 0xc8d4, 0xc8d2, 0xc8d1, 0xc8d0, 0xc8ce, 0xc8cd, 0xc8cb, //  8392
-    0xc8ca, 0xc8c9, 0xc8c7, 0xc8c6, 0xc8c4, 0xc8c3, 0xc8c1, 0xc8c0, //  8400
-    0xc8bf, 0xc8bd, 0xc8bc, 0xc8ba, 0xc8b9, 0xc8b8, 0xc8b6, 0xc8b5, //  8408
-    0xc8b3, 0xc8b2, 0xc8b1, 0xc8af, 0xc8ae, 0xc8ac, 0xc8ab, 0xc8aa, //  8416
-    0xc8a8, 0xc8a7, 0xc8a5, 0xc8a4, 0xc8a3, 0xc8a1, 0xc8a0, 0xc89e, //  8424
-    0xc89d, 0xc89c, 0xc89a, 0xc899, 0xc897, 0xc896, 0xc895, 0xc893, //  8432
-    0xc892, 0xc890, 0xc88f, 0xc88e, 0xc88c, 0xc88b, 0xc889, 0xc888, //  8440
-    0xc887, 0xc885, 0xc884, 0xc882, 0xc881, 0xc87f, 0xc87e, 0xc87d, //  8448
-    0xc87b, 0xc87a, 0xc878, 0xc877, 0xc876, 0xc874, 0xc873, 0xc871, //  8456
-    0xc870, 0xc86f, 0xc86d, 0xc86c, 0xc86a, 0xc869, 0xc868, 0xc866, //  8464
-    0xc865, 0xc863, 0xc862, 0xc861, 0xc85f, 0xc85e, 0xc85c, 0xc85b, //  8472
-    0xc85a, 0xc858, 0xc857, 0xc855, 0xc854, 0xc853, 0xc851, 0xc850, //  8480
-    0xc84e, 0xc84d, 0xc84c, 0xc84a, 0xc849, 0xc847, 0xc846, 0xc844, //  8488
-    0xc843, 0xc842, 0xc840, 0xc83f, 0xc83d, 0xc83c, 0xc83b, 0xc839, //  8496
-    0xc838, 0xc836, 0xc835, 0xc834, 0xc832, 0xc831, 0xc82f, 0xc82e, //  8504
-    0xc82d, 0xc82b, 0xc82a, 0xc828, 0xc827, 0xc826, 0xc824, 0xc823, //  8512
-    0xc821, 0xc820, 0xc81f, 0xc81d, 0xc81c, 0xc81a, 0xc819, 0xc818, //  8520
-    0xc816, 0xc815, 0xc813, 0xc812, 0xc811, 0xc80f, 0xc80e, 0xc80c, //  8528
-    0xc80b, 0xc80a, 0xc808, 0xc807, 0xc805, 0xc804, 0xc802, 0xc801, //  8536
-    0xc800, 0xc7fe, 0xc7fd, 0xc7fb, 0xc7fa, 0xc7f9, 0xc7f7, 0xc7f6, //  8544
-    0xc7f4, 0xc7f3, 0xc7f2, 0xc7f0, 0xc7ef, 0xc7ed, 0xc7ec, 0xc7eb, //  8552
-    0xc7e9, 0xc7e8, 0xc7e6, 0xc7e5, 0xc7e4, 0xc7e2, 0xc7e1, 0xc7df, //  8560
-    0xc7de, 0xc7dd, 0xc7db, 0xc7da, 0xc7d8, 0xc7d7, 0xc7d6, 0xc7d4, //  8568
-    0xc7d3, 0xc7d1, 0xc7d0, 0xc7cf, 0xc7cd, 0xc7cc, 0xc7ca, 0xc7c9, //  8576
-    0xc7c8, 0xc7c6, 0xc7c5, 0xc7c3, 0xc7c2, 0xc7c0, 0xc7bf, 0xc7be, //  8584
-    0xc7bc, 0xc7bb, 0xc7b9, 0xc7b8, 0xc7b7, 0xc7b5, 0xc7b4, 0xc7b2, //  8592
-    0xc7b1, 0xc7b0, 0xc7ae, 0xc7ad, 0xc7ab, 0xc7aa, 0xc7a9, 0xc7a7, //  8600
-    0xc7a6, 0xc7a4, 0xc7a3, 0xc7a2, 0xc7a0, 0xc79f, 0xc79d, 0xc79c, //  8608
-    0xc79b, 0xc799, 0xc798, 0xc796, 0xc795, 0xc794, 0xc792, 0xc791, //  8616
-    0xc78f, 0xc78e, 0xc78d, 0xc78b, 0xc78a, 0xc788, 0xc787, 0xc786, //  8624
-    0xc784, 0xc783, 0xc781, 0xc780, 0xc77e, 0xc77d, 0xc77c, 0xc77a, //  8632
-    0xc779, 0xc777, 0xc776, 0xc775, 0xc773, 0xc772, 0xc770, 0xc76f, //  8640
-    0xc76e, 0xc76c, 0xc76b, 0xc769, 0xc768, 0xc767, 0xc765, 0xc764, //  8648
-    0xc762, 0xc761, 0xc760, 0xc75e, 0xc75d, 0xc75b, 0xc75a, 0xc759, //  8656
-    0xc757, 0xc756, 0xc754, 0xc753, 0xc752, 0xc750, 0xc74f, 0xc74d, //  8664
-    0xc74c, 0xc74b, 0xc749, 0xc748, 0xc746, 0xc745, 0xc744, 0xc742, //  8672
-    0xc741, 0xc73f, 0xc73e, 0xc73c, 0xc73b, 0xc73a, 0xc738, 0xc737, //  8680
-    0xc735, 0xc734, 0xc733, 0xc731, 0xc730, 0xc72e, 0xc72d, 0xc72c, //  8688
-    0xc72a, 0xc729, 0xc727, 0xc726, 0xc725, 0xc723, 0xc722, 0xc720, //  8696
-    0xc71f, 0xc71e, 0xc71c, 0xc71b, 0xc719, 0xc718, 0xc717, 0xc715, //  8704
-    0xc714, 0xc712, 0xc711, 0xc710, 0xc70e, 0xc70d, 0xc70b, 0xc70a, //  8712
-    0xc709, 0xc707, 0xc706, 0xc704, 0xc703, 0xc702, 0xc700, 0xc6ff, //  8720
-    0xc6fd, 0xc6fc, 0xc6fa, 0xc6f9, 0xc6f8, 0xc6f6, 0xc6f5, 0xc6f3, //  8728
-    0xc6f2, 0xc6f1, 0xc6ef, 0xc6ee, 0xc6ec, 0xc6eb, 0xc6ea, 0xc6e8, //  8736
-    0xc6e7, 0xc6e5, 0xc6e4, 0xc6e3, 0xc6e1, 0xc6e0, 0xc6de, 0xc6dd, //  8744
-    0xc6dc, 0xc6da, 0xc6d9, 0xc6d7, 0xc6d6, 0xc6d5, 0xc6d3, 0xc6d2, //  8752
-    0xc6d0, 0xc6cf, 0xc6ce, 0xc6cc, 0xc6cb, 0xc6c9, 0xc6c8, 0xc6c7, //  8760
-    0xc6c5, 0xc6c4, 0xc6c2, 0xc6c1, 0xc6c0, 0xc6be, 0xc6bd, 0xc6bb, //  8768
-    0xc6ba, 0xc6b8, 0xc6b7, 0xc6b6, 0xc6b4, 0xc6b3, 0xc6b1, 0xc6b0, //  8776
-    0xc6af, 0xc6ad, 0xc6ac, 0xc6aa, 0xc6a9, 0xc6a8, 0xc6a6, 0xc6a5, //  8784
-    0xc6a3, 0xc6a2, 0xc6a1, 0xc69f, 0xc69e, 0xc69c, 0xc69b, 0xc69a, //  8792
-    0xc698, 0xc697, 0xc695, 0xc694, 0xc693, 0xc691, 0xc690, 0xc68e, //  8800
-    0xc68d, 0xc68c, 0xc68a, 0xc689, 0xc687, 0xc686, 0xc685, 0xc683, //  8808
-    0xc682, 0xc680, 0xc67f, 0xc67e, 0xc67c, 0xc67b, 0xc679, 0xc678, //  8816
-    0xc676, 0xc675, 0xc674, 0xc672, 0xc671, 0xc66f, 0xc66e, 0xc66d, //  8824
-    0xc66b, 0xc66a, 0xc668, 0xc667, 0xc666, 0xc664, 0xc663, 0xc661, //  8832
-    0xc660, 0xc65f, 0xc65d, 0xc65c, 0xc65a, 0xc659, 0xc658, 0xc656, //  8840
-    0xc655, 0xc653, 0xc652, 0xc651, 0xc64f, 0xc64e, 0xc64c, 0xc64b, //  8848
-    0xc64a, 0xc648, 0xc647, 0xc645, 0xc644, 0xc643, 0xc641, 0xc640, //  8856
-    0xc63e, 0xc63d, 0xc63c, 0xc63a, 0xc639, 0xc637, 0xc636, 0xc634, //  8864
-    0xc633, 0xc632, 0xc630, 0xc62f, 0xc62d, 0xc62c, 0xc62b, 0xc629, //  8872
-    0xc628, 0xc626, 0xc625, 0xc624, 0xc622, 0xc621, 0xc61f, 0xc61e, //  8880
-    0xc61d, 0xc61b, 0xc61a, 0xc618, 0xc617, 0xc616, 0xc614, 0xc613, //  8888
-    0xc611, 0xc610, 0xc60f, 0xc60d, 0xc60c, 0xc60a, 0xc609, 0xc608, //  8896
-    0xc606, 0xc605, 0xc603, 0xc602, 0xc601, 0xc5ff, 0xc5fe, 0xc5fc, //  8904
-    0xc5fb, 0xc5fa, 0xc5f8, 0xc5f7, 0xc5f5, 0xc5f4, 0xc5f2, 0xc5f1, //  8912
-    0xc5f0, 0xc5ee, 0xc5ed, 0xc5eb, 0xc5ea, 0xc5e9, 0xc5e7, 0xc5e6, //  8920
-    0xc5e4, 0xc5e3, 0xc5e2, 0xc5e0, 0xc5df, 0xc5dd, 0xc5dc, 0xc5db, //  8928
-    0xc5d9, 0xc5d8, 0xc5d6, 0xc5d5, 0xc5d4, 0xc5d2, 0xc5d1, 0xc5cf, //  8936
-    0xc5ce, 0xc5cd, 0xc5cb, 0xc5ca, 0xc5c8, 0xc5c7, 0xc5c6, 0xc5c4, //  8944
-    0xc5c3, 0xc5c1, 0xc5c0, 0xc5bf, 0xc5bd, 0xc5bc, 0xc5ba, 0xc5b9, //  8952
-    0xc5b8, 0xc5b6, 0xc5b5, 0xc5b3, 0xc5b2, 0xc5b0, 0xc5af, 0xc5ae, //  8960
-    0xc5ac, 0xc5ab, 0xc5a9, 0xc5a8, 0xc5a7, 0xc5a5, 0xc5a4, 0xc5a2, //  8968
-    0xc5a1, 0xc5a0, 0xc59e, 0xc59d, 0xc59b, 0xc59a, 0xc599, 0xc597, //  8976
-    0xc596, 0xc594, 0xc593, 0xc592, 0xc590, 0xc58f, 0xc58d, 0xc58c, //  8984
-    0xc58b, 0xc589, 0xc588, 0xc586, 0xc585, 0xc584, 0xc582, 0xc581, //  8992
-    0xc57f, 0xc57e, 0xc57d, 0xc57b, 0xc57a, 0xc578, 0xc577, 0xc575, //  9000
-    0xc574, 0xc573, 0xc571, 0xc570, 0xc56e, 0xc56d, 0xc56c, 0xc56a, //  9008
-    0xc569, 0xc567, 0xc566, 0xc565, 0xc563, 0xc562, 0xc560, 0xc55f, //  9016
-    0xc55e, 0xc55c, 0xc55b, 0xc559, 0xc558, 0xc557, 0xc555, 0xc554, //  9024
-    0xc552, 0xc551, 0xc550, 0xc54e, 0xc54d, 0xc54b, 0xc54a, 0xc549, //  9032
-    0xc547, 0xc546, 0xc544, 0xc543, 0xc542, 0xc540, 0xc53f, 0xc53d, //  9040
-    0xc53c, 0xc53b, 0xc539, 0xc538, 0xc536, 0xc535, 0xc533, 0xc532, //  9048
-    0xc531, 0xc52f, 0xc52e, 0xc52c, 0xc52b, 0xc52a, 0xc528, 0xc527, //  9056
-    0xc525, 0xc524, 0xc523, 0xc521, 0xc520, 0xc51e, 0xc51d, 0xc51c, //  9064
-    0xc51a, 0xc519, 0xc517, 0xc516, 0xc515, 0xc513, 0xc512, 0xc510, //  9072
-    0xc50f, 0xc50e, 0xc50c, 0xc50b, 0xc509, 0xc508, 0xc507, 0xc505, //  9080
-    0xc504, 0xc502, 0xc501, 0xc500, 0xc4fe, 0xc4fd, 0xc4fb, 0xc4fa, //  9088
-    0xc4f9, 0xc4f7, 0xc4f6, 0xc4f4, 0xc4f3, 0xc4f1, 0xc4f0, 0xc4ef, //  9096
-    0xc4ed, 0xc4ec, 0xc4ea, 0xc4e9, 0xc4e8, 0xc4e6, 0xc4e5, 0xc4e3, //  9104
-    0xc4e2, 0xc4e1, 0xc4df, 0xc4de, 0xc4dc, 0xc4db, 0xc4da, 0xc4d8, //  9112
-    0xc4d7, 0xc4d5, 0xc4d4, 0xc4d3, 0xc4d1, 0xc4d0, 0xc4ce, 0xc4cd, //  9120
-    0xc4cc, 0xc4ca, 0xc4c9, 0xc4c7, 0xc4c6, 0xc4c5, 0xc4c3, 0xc4c2, //  9128
-    0xc4c0, 0xc4bf, 0xc4be, 0xc4bc, 0xc4bb, 0xc4b9, 0xc4b8, 0xc4b7, //  9136
-    0xc4b5, 0xc4b4, 0xc4b2, 0xc4b1, 0xc4af, 0xc4ae, 0xc4ad, 0xc4ab, //  9144
-    0xc4aa, 0xc4a8, 0xc4a7, 0xc4a6, 0xc4a4, 0xc4a3, 0xc4a1, 0xc4a0, //  9152
-    0xc49f, 0xc49d, 0xc49c, 0xc49a, 0xc499, 0xc498, 0xc496, 0xc495, //  9160
-    0xc493, 0xc492, 0xc491, 0xc48f, 0xc48e, 0xc48c, 0xc48b, 0xc48a, //  9168
-    0xc488, 0xc487, 0xc485, 0xc484, 0xc483, 0xc481, 0xc480, 0xc47e, //  9176
-    0xc47d, 0xc47c, 0xc47a, 0xc479, 0xc477, 0xc476, 0xc475, 0xc473, //  9184
-    0xc472, 0xc470, 0xc46f, 0xc46d, 0xc46c, 0xc46b, 0xc469, 0xc468, //  9192
-    0xc466, 0xc465, 0xc464, 0xc462, 0xc461, 0xc45f, 0xc45e, 0xc45d, //  9200
-    0xc45b, 0xc45a, 0xc458, 0xc457, 0xc456, 0xc454, 0xc453, 0xc451, //  9208
-    0xc450, 0xc44e, 0xc44d, 0xc44c, 0xc44a, 0xc449, 0xc448, 0xc446, //  9216
-    0xc445, 0xc444, 0xc442, 0xc441, 0xc440, 0xc43e, 0xc43d, 0xc43b, //  9224
-    0xc43a, 0xc439, 0xc437, 0xc436, 0xc435, 0xc433, 0xc432, 0xc431, //  9232
-    0xc42f, 0xc42e, 0xc42d, 0xc42b, 0xc42a, 0xc428, 0xc427, 0xc426, //  9240
-    0xc424, 0xc423, 0xc422, 0xc420, 0xc41f, 0xc41e, 0xc41c, 0xc41b, //  9248
-    0xc41a, 0xc418, 0xc417, 0xc416, 0xc414, 0xc413, 0xc411, 0xc410, //  9256
-    0xc40f, 0xc40d, 0xc40c, 0xc40b, 0xc409, 0xc408, 0xc407, 0xc405, //  9264
-    0xc404, 0xc403, 0xc401, 0xc400, 0xc3ff, 0xc3fd, 0xc3fc, 0xc3fa, //  9272
-    0xc3f9, 0xc3f8, 0xc3f6, 0xc3f5, 0xc3f4, 0xc3f2, 0xc3f1, 0xc3f0, //  9280
-    0xc3ee, 0xc3ed, 0xc3ec, 0xc3ea, 0xc3e9, 0xc3e8, 0xc3e6, 0xc3e5, //  9288
-    0xc3e3, 0xc3e2, 0xc3e1, 0xc3df, 0xc3de, 0xc3dd, 0xc3db, 0xc3da, //  9296
-    0xc3d9, 0xc3d7, 0xc3d6, 0xc3d5, 0xc3d3, 0xc3d2, 0xc3d1, 0xc3cf, //  9304
-    0xc3ce, 0xc3cc, 0xc3cb, 0xc3ca, 0xc3c8, 0xc3c7, 0xc3c6, 0xc3c4, //  9312
-    0xc3c3, 0xc3c2, 0xc3c0, 0xc3bf, 0xc3be, 0xc3bc, 0xc3bb, 0xc3ba, //  9320
-    0xc3b8, 0xc3b7, 0xc3b5, 0xc3b4, 0xc3b3, 0xc3b1, 0xc3b0, 0xc3af, //  9328
-    0xc3ad, 0xc3ac, 0xc3ab, 0xc3a9, 0xc3a8, 0xc3a7, 0xc3a5, 0xc3a4, //  9336
-    0xc3a3, 0xc3a1, 0xc3a0, 0xc39e, 0xc39d, 0xc39c, 0xc39a, 0xc399, //  9344
-    0xc398, 0xc396, 0xc395, 0xc394, 0xc392, 0xc391, 0xc390, 0xc38e, //  9352
-    0xc38d, 0xc38b, 0xc38a, 0xc389, 0xc387, 0xc386, 0xc385, 0xc383, //  9360
-    0xc382, 0xc381, 0xc37f, 0xc37e, 0xc37d, 0xc37b, 0xc37a, 0xc379, //  9368
-    0xc377, 0xc376, 0xc374, 0xc373, 0xc372, 0xc370, 0xc36f, 0xc36e, //  9376
-    0xc36c, 0xc36b, 0xc36a, 0xc368, 0xc367, 0xc366, 0xc364, 0xc363, //  9384
-    0xc362, 0xc360, 0xc35f, 0xc35d, 0xc35c, 0xc35b, 0xc359, 0xc358, //  9392
-    0xc357, 0xc355, 0xc354, 0xc353, 0xc351, 0xc350, 0xc34f, 0xc34d, //  9400
-    0xc34c, 0xc34b, 0xc349, 0xc348, 0xc346, 0xc345, 0xc344, 0xc342, //  9408
-    0xc341, 0xc340, 0xc33e, 0xc33d, 0xc33c, 0xc33a, 0xc339, 0xc338, //  9416
-    0xc336, 0xc335, 0xc334, 0xc332, 0xc331, 0xc32f, 0xc32e, 0xc32d, //  9424
-    0xc32b, 0xc32a, 0xc329, 0xc327, 0xc326, 0xc325, 0xc323, 0xc322, //  9432
-    0xc321, 0xc31f, 0xc31e, 0xc31d, 0xc31b, 0xc31a, 0xc318, 0xc317, //  9440
-    0xc316, 0xc314, 0xc313, 0xc312, 0xc310, 0xc30f, 0xc30e, 0xc30c, //  9448
-    0xc30b, 0xc30a, 0xc308, 0xc307, 0xc305, 0xc304, 0xc303, 0xc301, //  9456
-    0xc300, 0xc2ff, 0xc2fd, 0xc2fc, 0xc2fb, 0xc2f9, 0xc2f8, 0xc2f7, //  9464
-    0xc2f5, 0xc2f4, 0xc2f3, 0xc2f1, 0xc2f0, 0xc2ee, 0xc2ed, 0xc2ec, //  9472
-    0xc2ea, 0xc2e9, 0xc2e8, 0xc2e6, 0xc2e5, 0xc2e4, 0xc2e2, 0xc2e1, //  9480
-    0xc2e0, 0xc2de, 0xc2dd, 0xc2dc, 0xc2da, 0xc2d9, 0xc2d7, 0xc2d6, //  9488
-    0xc2d5, 0xc2d3, 0xc2d2, 0xc2d1, 0xc2cf, 0xc2ce, 0xc2cd, 0xc2cb, //  9496
-    0xc2ca, 0xc2c9, 0xc2c7, 0xc2c6, 0xc2c5, 0xc2c3, 0xc2c2, 0xc2c0, //  9504
-    0xc2bf, 0xc2be, 0xc2bc, 0xc2bb, 0xc2ba, 0xc2b8, 0xc2b7, 0xc2b6, //  9512
-    0xc2b4, 0xc2b3, 0xc2b2, 0xc2b0, 0xc2af, 0xc2ae, 0xc2ac, 0xc2ab, //  9520
-    0xc2a9, 0xc2a8, 0xc2a7, 0xc2a5, 0xc2a4, 0xc2a3, 0xc2a1, 0xc2a0, //  9528
-    0xc29f, 0xc29d, 0xc29c, 0xc29b, 0xc299, 0xc298, 0xc297, 0xc295, //  9536
-    0xc294, 0xc292, 0xc291, 0xc290, 0xc28e, 0xc28d, 0xc28c, 0xc28a, //  9544
-    0xc289, 0xc288, 0xc286, 0xc285, 0xc284, 0xc282, 0xc281, 0xc27f, //  9552
-    0xc27e, 0xc27d, 0xc27b, 0xc27a, 0xc279, 0xc277, 0xc276, 0xc275, //  9560
-    0xc273, 0xc272, 0xc271, 0xc26f, 0xc26e, 0xc26d, 0xc26b, 0xc26a, //  9568
-    0xc268, 0xc267, 0xc266, 0xc264, 0xc263, 0xc262, 0xc260, 0xc25f, //  9576
-    0xc25e, 0xc25c, 0xc25b, 0xc25a, 0xc258, 0xc257, 0xc256, 0xc254, //  9584
-    0xc253, 0xc251, 0xc250, 0xc24f, 0xc24d, 0xc24c, 0xc24b, 0xc249, //  9592
-    0xc248, 0xc247, 0xc245, 0xc244, 0xc243, 0xc241, 0xc240, 0xc23f, //  9600
-    0xc23d, 0xc23c, 0xc23a, 0xc239, 0xc238, 0xc236, 0xc235, 0xc234, //  9608
-    0xc232, 0xc231, 0xc230, 0xc22e, 0xc22d, 0xc22c, 0xc22a, 0xc229, //  9616
-    0xc228, 0xc226, 0xc225, 0xc223, 0xc222, 0xc221, 0xc21f, 0xc21e, //  9624
-    0xc21d, 0xc21b, 0xc21a, 0xc219, 0xc217, 0xc216, 0xc215, 0xc213, //  9632
-    0xc212, 0xc211, 0xc20f, 0xc20e, 0xc20c, 0xc20b, 0xc20a, 0xc208, //  9640
-    0xc207, 0xc206, 0xc204, 0xc203, 0xc202, 0xc200, 0xc1ff, 0xc1fe, //  9648
-    0xc1fc, 0xc1fb, 0xc1f9, 0xc1f8, 0xc1f7, 0xc1f5, 0xc1f4, 0xc1f3, //  9656
-    0xc1f1, 0xc1f0, 0xc1ef, 0xc1ed, 0xc1ec, 0xc1eb, 0xc1e9, 0xc1e8, //  9664
-    0xc1e7, 0xc1e5, 0xc1e4, 0xc1e2, 0xc1e1, 0xc1e0, 0xc1de, 0xc1dd, //  9672
-    0xc1dc, 0xc1da, 0xc1d9, 0xc1d8, 0xc1d6, 0xc1d5, 0xc1d4, 0xc1d2, //  9680
-    0xc1d1, 0xc1d0, 0xc1ce, 0xc1cd, 0xc1cb, 0xc1ca, 0xc1c9, 0xc1c7, //  9688
-    0xc1c6, 0xc1c5, 0xc1c3, 0xc1c2, 0xc1c1, 0xc1bf, 0xc1be, 0xc1bd, //  9696
-    0xc1bb, 0xc1ba, 0xc1b9, 0xc1b7, 0xc1b6, 0xc1b4, 0xc1b3, 0xc1b2, //  9704
-    0xc1b0, 0xc1af, 0xc1ae, 0xc1ac, 0xc1ab, 0xc1aa, 0xc1a8, 0xc1a7, //  9712
-    0xc1a6, 0xc1a4, 0xc1a3, 0xc1a2, 0xc1a0, 0xc19f, 0xc19d, 0xc19c, //  9720
-    0xc19b, 0xc199, 0xc198, 0xc197, 0xc195, 0xc194, 0xc193, 0xc191, //  9728
-    0xc190, 0xc18f, 0xc18d, 0xc18c, 0xc18b, 0xc189, 0xc188, 0xc186, //  9736
-    0xc185, 0xc184, 0xc182, 0xc181, 0xc180, 0xc17e, 0xc17d, 0xc17c, //  9744
-    0xc17a, 0xc179, 0xc178, 0xc176, 0xc175, 0xc173, 0xc172, 0xc171, //  9752
-    0xc16f, 0xc16e, 0xc16d, 0xc16b, 0xc16a, 0xc169, 0xc167, 0xc166, //  9760
-    0xc165, 0xc163, 0xc162, 0xc161, 0xc15f, 0xc15e, 0xc15c, 0xc15b, //  9768
-    0xc15a, 0xc158, 0xc157, 0xc156, 0xc154, 0xc153, 0xc152, 0xc150, //  9776
-    0xc14f, 0xc14e, 0xc14c, 0xc14b, 0xc14a, 0xc148, 0xc147, 0xc145, //  9784
-    0xc144, 0xc143, 0xc141, 0xc140, 0xc13f, 0xc13d, 0xc13c, 0xc13b, //  9792
-    0xc139, 0xc138, 0xc137, 0xc135, 0xc134, 0xc133, 0xc131, 0xc130, //  9800
-    0xc12e, 0xc12d, 0xc12c, 0xc12a, 0xc129, 0xc128, 0xc126, 0xc125, //  9808
-    0xc124, 0xc122, 0xc121, 0xc120, 0xc11e, 0xc11d, 0xc11c, 0xc11a, //  9816
-    0xc119, 0xc117, 0xc116, 0xc115, 0xc113, 0xc112, 0xc111, 0xc10f, //  9824
-    0xc10e, 0xc10d, 0xc10b, 0xc10a, 0xc109, 0xc107, 0xc106, 0xc105, //  9832
-    0xc103, 0xc102, 0xc100, 0xc0ff, 0xc0fe, 0xc0fc, 0xc0fb, 0xc0fa, //  9840
-    0xc0f8, 0xc0f7, 0xc0f6, 0xc0f4, 0xc0f3, 0xc0f2, 0xc0f0, 0xc0ef, //  9848
-    0xc0ee, 0xc0ec, 0xc0eb, 0xc0e9, 0xc0e8, 0xc0e7, 0xc0e5, 0xc0e4, //  9856
-    0xc0e3, 0xc0e1, 0xc0e0, 0xc0df, 0xc0dd, 0xc0dc, 0xc0db, 0xc0d9, //  9864
-    0xc0d8, 0xc0d6, 0xc0d5, 0xc0d4, 0xc0d2, 0xc0d1, 0xc0d0, 0xc0ce, //  9872
-    0xc0cd, 0xc0cc, 0xc0ca, 0xc0c9, 0xc0c8, 0xc0c6, 0xc0c5, 0xc0c4, //  9880
-    0xc0c2, 0xc0c1, 0xc0bf, 0xc0be, 0xc0bd, 0xc0bb, 0xc0ba, 0xc0b9, //  9888
-    0xc0b7, 0xc0b6, 0xc0b5, 0xc0b3, 0xc0b2, 0xc0b1, 0xc0af, 0xc0ae, //  9896
-    0xc0ad, 0xc0ab, 0xc0aa, 0xc0a8, 0xc0a7, 0xc0a6, 0xc0a4, 0xc0a3, //  9904
-    0xc0a2, 0xc0a0, 0xc09f, 0xc09e, 0xc09c, 0xc09b, 0xc09a, 0xc098, //  9912
-    0xc097, 0xc096, 0xc094, 0xc093, 0xc091, 0xc090, 0xc08f, 0xc08d, //  9920
-    0xc08c, 0xc08b, 0xc089, 0xc088, 0xc087, 0xc085, 0xc084, 0xc083, //  9928
-    0xc081, 0xc080, 0xc07f, 0xc07d, 0xc07c, 0xc07a, 0xc079, 0xc078, //  9936
-    0xc076, 0xc075, 0xc074, 0xc072, 0xc071, 0xc070, 0xc06e, 0xc06d, //  9944
-    0xc06c, 0xc06a, 0xc069, 0xc068, 0xc066, 0xc065, 0xc063, 0xc062, //  9952
-    0xc061, 0xc05f, 0xc05e, 0xc05d, 0xc05b, 0xc05a, 0xc059, 0xc057, //  9960
-    0xc056, 0xc055, 0xc053, 0xc052, 0xc050, 0xc04f, 0xc04e, 0xc04c, //  9968
-    0xc04b, 0xc04a, 0xc048, 0xc047, 0xc046, 0xc044, 0xc043, 0xc042, //  9976
-    0xc040, 0xc03f, 0xc03e, 0xc03c, 0xc03b, 0xc039, 0xc038, 0xc037, //  9984
-    0xc035, 0xc034, 0xc033, 0xc031, 0xc030, 0xc02f, 0xc02d, 0xc02c, //  9992
-    0xc02b, 0xc029, 0xc028, 0xc027, 0xc025, 0xc024, 0xc022, 0xc021, // 10000
-    0xc020, 0xc01e, 0xc01d, 0xc01c, 0xc01a, 0xc019, 0xc018, 0xc016, // 10008
-    0xc015, 0xc014, 0xc012, 0xc011, 0xc010, 0xc00e, 0xc00d, 0xc00b, // 10016
-    0xc00a, 0xc009, 0xc007, 0xc006, 0xc005, 0xc003, 0xc002, 0xc001, // 10024
-    0xbfff, 0xbffe, 0xbffd, 0xbffb, 0xbffa, 0xbff9, 0xbff7, 0xbff6, // 10032
-    0xbff4, 0xbff3, 0xbff2, 0xbff0, 0xbfef, 0xbfee, 0xbfec, 0xbfeb, // 10040
-    0xbfea, 0xbfe8, 0xbfe7, 0xbfe6, 0xbfe4, 0xbfe3, 0xbfe2, 0xbfe0, // 10048
-    0xbfdf, 0xbfdd, 0xbfdc, 0xbfdb, 0xbfd9, 0xbfd8, 0xbfd7, 0xbfd5, // 10056
-    0xbfd4, 0xbfd3, 0xbfd1, 0xbfd0, 0xbfcf, 0xbfcd, 0xbfcc, 0xbfca, // 10064
-    0xbfc9, 0xbfc8, 0xbfc6, 0xbfc5, 0xbfc4, 0xbfc2, 0xbfc1, 0xbfc0, // 10072
-    0xbfbe, 0xbfbd, 0xbfbc, 0xbfba, 0xbfb9, 0xbfb8, 0xbfb6, 0xbfb5, // 10080
-    0xbfb3, 0xbfb2, 0xbfb1, 0xbfaf, 0xbfae, 0xbfad, 0xbfab, 0xbfaa, // 10088
-    0xbfa9, 0xbfa7, 0xbfa6, 0xbfa5, 0xbfa3, 0xbfa2, 0xbfa1, 0xbf9f, // 10096
-    0xbf9e, 0xbf9c, 0xbf9b, 0xbf9a, 0xbf98, 0xbf97, 0xbf96, 0xbf94, // 10104
-    0xbf93, 0xbf92, 0xbf90, 0xbf8f, 0xbf8e, 0xbf8c, 0xbf8b, 0xbf8a, // 10112
-    0xbf88, 0xbf87, 0xbf85, 0xbf84, 0xbf83, 0xbf81, 0xbf80, 0xbf7f, // 10120
-    0xbf7d, 0xbf7c, 0xbf7b, 0xbf79, 0xbf78, 0xbf77, 0xbf75, 0xbf74, // 10128
-    0xbf73, 0xbf71, 0xbf70, 0xbf6e, 0xbf6d, 0xbf6c, 0xbf6a, 0xbf69, // 10136
-    0xbf68, 0xbf66, 0xbf65, 0xbf64, 0xbf62, 0xbf61, 0xbf60, 0xbf5e, // 10144
-    0xbf5d, 0xbf5c, 0xbf5a, 0xbf59, 0xbf57, 0xbf56, 0xbf55, 0xbf53, // 10152
-    0xbf52, 0xbf51, 0xbf4f, 0xbf4e, 0xbf4d, 0xbf4b, 0xbf4a, 0xbf49, // 10160
-    0xbf47, 0xbf46, 0xbf44, 0xbf43, 0xbf42, 0xbf40, 0xbf3f, 0xbf3e, // 10168
-    0xbf3c, 0xbf3b, 0xbf3a, 0xbf38, 0xbf37, 0xbf36, 0xbf34, 0xbf33, // 10176
-    0xbf32, 0xbf30, 0xbf2f, 0xbf2d, 0xbf2c, 0xbf2b, 0xbf29, 0xbf28, // 10184
-    0xbf27, 0xbf25, 0xbf24, 0xbf23, 0xbf21, 0xbf20, 0xbf1f, 0xbf1d, // 10192
-    0xbf1c, 0xbf1b, 0xbf19, 0xbf18, 0xbf16, 0xbf15, 0xbf14, 0xbf12, // 10200
-    0xbf11, 0xbf10, 0xbf0e, 0xbf0d, 0xbf0c, 0xbf0a, 0xbf09, 0xbf08, // 10208
-    0xbf06, 0xbf05, 0xbf04, 0xbf02, 0xbf01, 0xbeff, 0xbefe, 0xbefd, // 10216
-    0xbefb, 0xbefa, 0xbef9, 0xbef7, 0xbef6, 0xbef5, 0xbef3, 0xbef2, // 10224
-    0xbef1, 0xbeef, 0xbeee, 0xbeed, 0xbeeb, 0xbeea, 0xbee8, 0xbee7, // 10232
-    0xbee5, 0xbee4, 0xbee3, 0xbee1, 0xbee0, 0xbedf, 0xbedd, 0xbedc, // 10240
-    0xbedb, 0xbed9, 0xbed8, 0xbed7, 0xbed6, 0xbed4, 0xbed3, 0xbed2, // 10248
-    0xbed0, 0xbecf, 0xbece, 0xbecc, 0xbecb, 0xbeca, 0xbec9, 0xbec7, // 10256
-    0xbec6, 0xbec5, 0xbec3, 0xbec2, 0xbec1, 0xbebf, 0xbebe, 0xbebd, // 10264
-    0xbebb, 0xbeba, 0xbeb9, 0xbeb8, 0xbeb6, 0xbeb5, 0xbeb4, 0xbeb2, // 10272
-    0xbeb1, 0xbeb0, 0xbeae, 0xbead, 0xbeac, 0xbeaa, 0xbea9, 0xbea8, // 10280
-    0xbea7, 0xbea5, 0xbea4, 0xbea3, 0xbea1, 0xbea0, 0xbe9f, 0xbe9d, // 10288
-    0xbe9c, 0xbe9b, 0xbe99, 0xbe98, 0xbe97, 0xbe96, 0xbe94, 0xbe93, // 10296
-    0xbe92, 0xbe90, 0xbe8f, 0xbe8e, 0xbe8c, 0xbe8b, 0xbe8a, 0xbe88, // 10304
-    0xbe87, 0xbe86, 0xbe85, 0xbe83, 0xbe82, 0xbe81, 0xbe7f, 0xbe7e, // 10312
-    0xbe7d, 0xbe7b, 0xbe7a, 0xbe79, 0xbe77, 0xbe76, 0xbe75, 0xbe74, // 10320
-    0xbe72, 0xbe71, 0xbe70, 0xbe6e, 0xbe6d, 0xbe6c, 0xbe6a, 0xbe69, // 10328
-    0xbe68, 0xbe67, 0xbe65, 0xbe64, 0xbe63, 0xbe61, 0xbe60, 0xbe5f, // 10336
-    0xbe5d, 0xbe5c, 0xbe5b, 0xbe59, 0xbe58, 0xbe57, 0xbe56, 0xbe54, // 10344
-    0xbe53, 0xbe52, 0xbe50, 0xbe4f, 0xbe4e, 0xbe4c, 0xbe4b, 0xbe4a, // 10352
-    0xbe48, 0xbe47, 0xbe46, 0xbe45, 0xbe43, 0xbe42, 0xbe41, 0xbe3f, // 10360
-    0xbe3e, 0xbe3d, 0xbe3b, 0xbe3a, 0xbe39, 0xbe37, 0xbe36, 0xbe35, // 10368
-    0xbe34, 0xbe32, 0xbe31, 0xbe30, 0xbe2e, 0xbe2d, 0xbe2c, 0xbe2a, // 10376
-    0xbe29, 0xbe28, 0xbe26, 0xbe25, 0xbe24, 0xbe23, 0xbe21, 0xbe20, // 10384
-    0xbe1f, 0xbe1d, 0xbe1c, 0xbe1b, 0xbe19, 0xbe18, 0xbe17, 0xbe15, // 10392
-    0xbe14, 0xbe13, 0xbe12, 0xbe10, 0xbe0f, 0xbe0e, 0xbe0c, 0xbe0b, // 10400
-    0xbe0a, 0xbe08, 0xbe07, 0xbe06, 0xbe05, 0xbe03, 0xbe02, 0xbe01, // 10408
-    0xbdff, 0xbdfe, 0xbdfd, 0xbdfb, 0xbdfa, 0xbdf9, 0xbdf7, 0xbdf6, // 10416
-    0xbdf5, 0xbdf4, 0xbdf2, 0xbdf1, 0xbdf0, 0xbdee, 0xbded, 0xbdec, // 10424
-    0xbdea, 0xbde9, 0xbde8, 0xbde6, 0xbde5, 0xbde4, 0xbde3, 0xbde1, // 10432
-    0xbde0, 0xbddf, 0xbddd, 0xbddc, 0xbddb, 0xbdd9, 0xbdd8, 0xbdd7, // 10440
-    0xbdd5, 0xbdd4, 0xbdd3, 0xbdd2, 0xbdd0, 0xbdcf, 0xbdce, 0xbdcc, // 10448
-    0xbdcb, 0xbdca, 0xbdc8, 0xbdc7, 0xbdc6, 0xbdc4, 0xbdc3, 0xbdc2, // 10456
-    0xbdc1, 0xbdbf, 0xbdbe, 0xbdbd, 0xbdbb, 0xbdba, 0xbdb9, 0xbdb7, // 10464
-    0xbdb6, 0xbdb5, 0xbdb3, 0xbdb2, 0xbdb1, 0xbdb0, 0xbdae, 0xbdad, // 10472
-    0xbdac, 0xbdaa, 0xbda9, 0xbda8, 0xbda6, 0xbda5, 0xbda4, 0xbda3, // 10480
-    0xbda1, 0xbda0, 0xbd9f, 0xbd9d, 0xbd9c, 0xbd9b, 0xbd99, 0xbd98, // 10488
-    0xbd97, 0xbd95, 0xbd94, 0xbd93, 0xbd92, 0xbd90, 0xbd8f, 0xbd8e, // 10496
-    0xbd8c, 0xbd8b, 0xbd8a, 0xbd88, 0xbd87, 0xbd86, 0xbd84, 0xbd83, // 10504
-    0xbd82, 0xbd81, 0xbd7f, 0xbd7e, 0xbd7d, 0xbd7b, 0xbd7a, 0xbd79, // 10512
-    0xbd77, 0xbd76, 0xbd75, 0xbd73, 0xbd72, 0xbd71, 0xbd70, 0xbd6e, // 10520
-    0xbd6d, 0xbd6c, 0xbd6a, 0xbd69, 0xbd68, 0xbd66, 0xbd65, 0xbd64, // 10528
-    0xbd62, 0xbd61, 0xbd60, 0xbd5f, 0xbd5d, 0xbd5c, 0xbd5b, 0xbd59, // 10536
-    0xbd58, 0xbd57, 0xbd55, 0xbd54, 0xbd53, 0xbd51, 0xbd50, 0xbd4f, // 10544
-    0xbd4e, 0xbd4c, 0xbd4b, 0xbd4a, 0xbd48, 0xbd47, 0xbd46, 0xbd44, // 10552
-    0xbd43, 0xbd42, 0xbd41, 0xbd3f, 0xbd3e, 0xbd3d, 0xbd3b, 0xbd3a, // 10560
-    0xbd39, 0xbd37, 0xbd36, 0xbd35, 0xbd33, 0xbd32, 0xbd31, 0xbd30, // 10568
-    0xbd2e, 0xbd2d, 0xbd2c, 0xbd2a, 0xbd29, 0xbd28, 0xbd26, 0xbd25, // 10576
-    0xbd24, 0xbd22, 0xbd21, 0xbd20, 0xbd1f, 0xbd1d, 0xbd1c, 0xbd1b, // 10584
-    0xbd19, 0xbd18, 0xbd17, 0xbd15, 0xbd14, 0xbd13, 0xbd11, 0xbd10, // 10592
-    0xbd0f, 0xbd0e, 0xbd0c, 0xbd0b, 0xbd0a, 0xbd08, 0xbd07, 0xbd06, // 10600
-    0xbd04, 0xbd03, 0xbd02, 0xbd00, 0xbcff, 0xbcfe, 0xbcfd, 0xbcfb, // 10608
-    0xbcfa, 0xbcf9, 0xbcf7, 0xbcf6, 0xbcf5, 0xbcf3, 0xbcf2, 0xbcf1, // 10616
-    0xbcf0, 0xbcee, 0xbced, 0xbcec, 0xbcea, 0xbce9, 0xbce8, 0xbce6, // 10624
-    0xbce5, 0xbce4, 0xbce2, 0xbce1, 0xbce0, 0xbcdf, 0xbcdd, 0xbcdc, // 10632
-    0xbcdb, 0xbcd9, 0xbcd8, 0xbcd7, 0xbcd5, 0xbcd4, 0xbcd3, 0xbcd1, // 10640
-    0xbcd0, 0xbccf, 0xbcce, 0xbccc, 0xbccb, 0xbcca, 0xbcc8, 0xbcc7, // 10648
-    0xbcc6, 0xbcc4, 0xbcc3, 0xbcc2, 0xbcc0, 0xbcbf, 0xbcbe, 0xbcbd, // 10656
-    0xbcbb, 0xbcba, 0xbcb9, 0xbcb7, 0xbcb6, 0xbcb5, 0xbcb3, 0xbcb2, // 10664
-    0xbcb1, 0xbcaf, 0xbcae, 0xbcad, 0xbcac, 0xbcaa, 0xbca9, 0xbca8, // 10672
-    0xbca6, 0xbca5, 0xbca4, 0xbca2, 0xbca1, 0xbca0, 0xbc9e, 0xbc9d, // 10680
-    0xbc9c, 0xbc9b, 0xbc99, 0xbc98, 0xbc97, 0xbc95, 0xbc94, 0xbc93, // 10688
-    0xbc91, 0xbc90, 0xbc8f, 0xbc8e, 0xbc8c, 0xbc8b, 0xbc8a, 0xbc88, // 10696
-    0xbc87, 0xbc86, 0xbc84, 0xbc83, 0xbc82, 0xbc80, 0xbc7f, 0xbc7e, // 10704
-    0xbc7d, 0xbc7b, 0xbc7a, 0xbc79, 0xbc77, 0xbc76, 0xbc75, 0xbc73, // 10712
-    0xbc72, 0xbc71, 0xbc6f, 0xbc6e, 0xbc6d, 0xbc6c, 0xbc6a, 0xbc69, // 10720
-    0xbc68, 0xbc66, 0xbc65, 0xbc64, 0xbc62, 0xbc61, 0xbc60, 0xbc5e, // 10728
-    0xbc5d, 0xbc5c, 0xbc5b, 0xbc59, 0xbc58, 0xbc57, 0xbc55, 0xbc54, // 10736
-    0xbc53, 0xbc51, 0xbc50, 0xbc4f, 0xbc4d, 0xbc4c, 0xbc4b, 0xbc4a, // 10744
-    0xbc48, 0xbc47, 0xbc46, 0xbc44, 0xbc43, 0xbc42, 0xbc40, 0xbc3f, // 10752
-    0xbc3e, 0xbc3c, 0xbc3b, 0xbc3a, 0xbc39, 0xbc37, 0xbc36, 0xbc35, // 10760
-    0xbc33, 0xbc32, 0xbc31, 0xbc2f, 0xbc2e, 0xbc2d, 0xbc2c, 0xbc2a, // 10768
-    0xbc29, 0xbc28, 0xbc26, 0xbc25, 0xbc24, 0xbc22, 0xbc21, 0xbc20, // 10776
-    0xbc1e, 0xbc1d, 0xbc1c, 0xbc1b, 0xbc19, 0xbc18, 0xbc17, 0xbc15, // 10784
-    0xbc14, 0xbc13, 0xbc11, 0xbc10, 0xbc0f, 0xbc0d, 0xbc0c, 0xbc0b, // 10792
-    0xbc0a, 0xbc08, 0xbc07, 0xbc06, 0xbc04, 0xbc03, 0xbc02, 0xbc00, // 10800
-    0xbbff, 0xbbfe, 0xbbfc, 0xbbfb, 0xbbfa, 0xbbf9, 0xbbf7, 0xbbf6, // 10808
-    0xbbf5, 0xbbf3, 0xbbf2, 0xbbf1, 0xbbef, 0xbbee, 0xbbed, 0xbbeb, // 10816
-    0xbbea, 0xbbe9, 0xbbe8, 0xbbe6, 0xbbe5, 0xbbe4, 0xbbe2, 0xbbe1, // 10824
-    0xbbe0, 0xbbde, 0xbbdd, 0xbbdc, 0xbbda, 0xbbd9, 0xbbd8, 0xbbd7, // 10832
-    0xbbd5, 0xbbd4, 0xbbd3, 0xbbd1, 0xbbd0, 0xbbcf, 0xbbcd, 0xbbcc, // 10840
-    0xbbcb, 0xbbca, 0xbbc8, 0xbbc7, 0xbbc6, 0xbbc4, 0xbbc3, 0xbbc2, // 10848
-    0xbbc0, 0xbbbf, 0xbbbe, 0xbbbc, 0xbbbb, 0xbbba, 0xbbb9, 0xbbb7, // 10856
-    0xbbb6, 0xbbb5, 0xbbb3, 0xbbb2, 0xbbb1, 0xbbaf, 0xbbae, 0xbbad, // 10864
-    0xbbab, 0xbbaa, 0xbba9, 0xbba8, 0xbba6, 0xbba5, 0xbba4, 0xbba2, // 10872
-    0xbba1, 0xbba0, 0xbb9e, 0xbb9d, 0xbb9c, 0xbb9a, 0xbb99, 0xbb98, // 10880
-    0xbb97, 0xbb95, 0xbb94, 0xbb93, 0xbb91, 0xbb90, 0xbb8f, 0xbb8d, // 10888
-    0xbb8c, 0xbb8b, 0xbb89, 0xbb88, 0xbb87, 0xbb86, 0xbb84, 0xbb83, // 10896
-    0xbb82, 0xbb80, 0xbb7f, 0xbb7e, 0xbb7c, 0xbb7b, 0xbb7a, 0xbb78, // 10904
-    0xbb77, 0xbb76, 0xbb75, 0xbb73, 0xbb72, 0xbb71, 0xbb6f, 0xbb6e, // 10912
-    0xbb6d, 0xbb6b, 0xbb6a, 0xbb69, 0xbb68, 0xbb66, 0xbb65, 0xbb64, // 10920
-    0xbb62, 0xbb61, 0xbb60, 0xbb5e, 0xbb5d, 0xbb5c, 0xbb5a, 0xbb59, // 10928
-    0xbb58, 0xbb57, 0xbb55, 0xbb54, 0xbb53, 0xbb51, 0xbb50, 0xbb4f, // 10936
-    0xbb4d, 0xbb4c, 0xbb4b, 0xbb49, 0xbb48, 0xbb47, 0xbb46, 0xbb44, // 10944
-    0xbb43, 0xbb42, 0xbb40, 0xbb3f, 0xbb3e, 0xbb3c, 0xbb3b, 0xbb3a, // 10952
-    0xbb38, 0xbb37, 0xbb36, 0xbb35, 0xbb33, 0xbb32, 0xbb31, 0xbb2f, // 10960
-    0xbb2e, 0xbb2d, 0xbb2b, 0xbb2a, 0xbb29, 0xbb27, 0xbb26, 0xbb25, // 10968
-    0xbb24, 0xbb22, 0xbb21, 0xbb20, 0xbb1e, 0xbb1d, 0xbb1c, 0xbb1a, // 10976
-    0xbb19, 0xbb18, 0xbb16, 0xbb15, 0xbb14, 0xbb13, 0xbb11, 0xbb10, // 10984
-    0xbb0f, 0xbb0d, 0xbb0c, 0xbb0b, 0xbb09, 0xbb08, 0xbb07, 0xbb06, // 10992
-    0xbb04, 0xbb03, 0xbb02, 0xbb00, 0xbaff, 0xbafe, 0xbafc, 0xbafb, // 11000
-    0xbafa, 0xbaf8, 0xbaf7, 0xbaf6, 0xbaf5, 0xbaf3, 0xbaf2, 0xbaf1, // 11008
-    0xbaef, 0xbaee, 0xbaed, 0xbaeb, 0xbaea, 0xbae9, 0xbae7, 0xbae6, // 11016
-    0xbae5, 0xbae4, 0xbae2, 0xbae1, 0xbae0, 0xbade, 0xbadd, 0xbadc, // 11024
-    0xbada, 0xbad9, 0xbad8, 0xbad6, 0xbad5, 0xbad4, 0xbad3, 0xbad1, // 11032
-    0xbad0, 0xbacf, 0xbacd, 0xbacc, 0xbacb, 0xbac9, 0xbac8, 0xbac7, // 11040
-    0xbac5, 0xbac4, 0xbac3, 0xbac2, 0xbac0, 0xbabf, 0xbabe, 0xbabc, // 11048
-    0xbabb, 0xbaba, 0xbab8, 0xbab7, 0xbab6, 0xbab4, 0xbab3, 0xbab2, // 11056
-    0xbab1, 0xbaaf, 0xbaae, 0xbaad, 0xbaab, 0xbaaa, 0xbaa9, 0xbaa7, // 11064
-    0xbaa6, 0xbaa5, 0xbaa4, 0xbaa2, 0xbaa1, 0xbaa0, 0xba9e, 0xba9d, // 11072
-    0xba9c, 0xba9a, 0xba99, 0xba98, 0xba96, 0xba95, 0xba94, 0xba93, // 11080
-    0xba91, 0xba90, 0xba8f, 0xba8d, 0xba8c, 0xba8b, 0xba89, 0xba88, // 11088
-    0xba87, 0xba85, 0xba84, 0xba83, 0xba82, 0xba80, 0xba7f, 0xba7e, // 11096
-    0xba7c, 0xba7b, 0xba7a, 0xba78, 0xba77, 0xba76, 0xba74, 0xba73, // 11104
-    0xba72, 0xba71, 0xba6f, 0xba6e, 0xba6d, 0xba6b, 0xba6a, 0xba69, // 11112
-    0xba67, 0xba66, 0xba65, 0xba63, 0xba62, 0xba61, 0xba60, 0xba5e, // 11120
-    0xba5d, 0xba5c, 0xba5a, 0xba59, 0xba58, 0xba56, 0xba55, 0xba54, // 11128
-    0xba53, 0xba51, 0xba50, 0xba4f, 0xba4d, 0xba4c, 0xba4b, 0xba49, // 11136
-    0xba48, 0xba47, 0xba45, 0xba44, 0xba43, 0xba42, 0xba40, 0xba3f, // 11144
-    0xba3e, 0xba3c, 0xba3b, 0xba3a, 0xba38, 0xba37, 0xba36, 0xba34, // 11152
-    0xba33, 0xba32, 0xba31, 0xba2f, 0xba2e, 0xba2d, 0xba2b, 0xba2a, // 11160
-    0xba29, 0xba27, 0xba26, 0xba25, 0xba23, 0xba22, 0xba21, 0xba20, // 11168
-    0xba1e, 0xba1d, 0xba1c, 0xba1a, 0xba19, 0xba18, 0xba16, 0xba15, // 11176
-    0xba14, 0xba12, 0xba11, 0xba10, 0xba0f, 0xba0d, 0xba0c, 0xba0b, // 11184
-    0xba09, 0xba08, 0xba07, 0xba05, 0xba04, 0xba03, 0xba01, 0xba00, // 11192
-    0xb9ff, 0xb9fe, 0xb9fc, 0xb9fb, 0xb9fa, 0xb9f8, 0xb9f7, 0xb9f6, // 11200
-    0xb9f4, 0xb9f3, 0xb9f2, 0xb9f1, 0xb9ef, 0xb9ee, 0xb9ed, 0xb9eb, // 11208
-    0xb9ea, 0xb9e9, 0xb9e7, 0xb9e6, 0xb9e5, 0xb9e3, 0xb9e2, 0xb9e1, // 11216
-    0xb9e0, 0xb9de, 0xb9dd, 0xb9dc, 0xb9da, 0xb9d9, 0xb9d8, 0xb9d6, // 11224
-    0xb9d5, 0xb9d4, 0xb9d2, 0xb9d1, 0xb9d0, 0xb9cf, 0xb9cd, 0xb9cc, // 11232
-    0xb9cb, 0xb9c9, 0xb9c8, 0xb9c7, 0xb9c5, 0xb9c4, 0xb9c3, 0xb9c1, // 11240
-    0xb9c0, 0xb9bf, 0xb9be, 0xb9bc, 0xb9bb, 0xb9ba, 0xb9b8, 0xb9b7, // 11248
-    0xb9b6, 0xb9b4, 0xb9b3, 0xb9b2, 0xb9b0, 0xb9af, 0xb9ae, 0xb9ad, // 11256
-    0xb9ad, 0xb9ab, 0xb9aa, 0xb9a9, 0xb9a7, 0xb9a6, 0xb9a5, 0xb9a4, // 11264
-    0xb9a2, 0xb9a1, 0xb9a0, 0xb99f, 0xb99d, 0xb99c, 0xb99b, 0xb99a, // 11272
-    0xb998, 0xb997, 0xb996, 0xb994, 0xb993, 0xb992, 0xb991, 0xb98f, // 11280
-    0xb98e, 0xb98d, 0xb98c, 0xb98a, 0xb989, 0xb988, 0xb987, 0xb985, // 11288
-    0xb984, 0xb983, 0xb982, 0xb980, 0xb97f, 0xb97e, 0xb97c, 0xb97b, // 11296
-    0xb97a, 0xb979, 0xb977, 0xb976, 0xb975, 0xb974, 0xb972, 0xb971, // 11304
-    0xb970, 0xb96f, 0xb96d, 0xb96c, 0xb96b, 0xb96a, 0xb968, 0xb967, // 11312
-    0xb966, 0xb964, 0xb963, 0xb962, 0xb961, 0xb95f, 0xb95e, 0xb95d, // 11320
-    0xb95c, 0xb95a, 0xb959, 0xb958, 0xb957, 0xb955, 0xb954, 0xb953, // 11328
-    0xb952, 0xb950, 0xb94f, 0xb94e, 0xb94c, 0xb94b, 0xb94a, 0xb949, // 11336
-    0xb947, 0xb946, 0xb945, 0xb944, 0xb942, 0xb941, 0xb940, 0xb93f, // 11344
-    0xb93d, 0xb93c, 0xb93b, 0xb93a, 0xb938, 0xb937, 0xb936, 0xb934, // 11352
-    0xb933, 0xb932, 0xb931, 0xb92f, 0xb92e, 0xb92d, 0xb92c, 0xb92a, // 11360
-    0xb929, 0xb928, 0xb927, 0xb925, 0xb924, 0xb923, 0xb921, 0xb920, // 11368
-    0xb91f, 0xb91e, 0xb91c, 0xb91b, 0xb91a, 0xb919, 0xb917, 0xb916, // 11376
-    0xb915, 0xb914, 0xb912, 0xb911, 0xb910, 0xb90f, 0xb90d, 0xb90c, // 11384
-    0xb90b, 0xb909, 0xb908, 0xb907, 0xb906, 0xb904, 0xb903, 0xb902, // 11392
-    0xb901, 0xb8ff, 0xb8fe, 0xb8fd, 0xb8fc, 0xb8fa, 0xb8f9, 0xb8f8, // 11400
-    0xb8f7, 0xb8f5, 0xb8f4, 0xb8f3, 0xb8f1, 0xb8f0, 0xb8ef, 0xb8ee, // 11408
-    0xb8ec, 0xb8eb, 0xb8ea, 0xb8e9, 0xb8e7, 0xb8e6, 0xb8e5, 0xb8e4, // 11416
-    0xb8e2, 0xb8e1, 0xb8e0, 0xb8df, 0xb8dd, 0xb8dc, 0xb8db, 0xb8d9, // 11424
-    0xb8d8, 0xb8d7, 0xb8d6, 0xb8d4, 0xb8d3, 0xb8d2, 0xb8d1, 0xb8cf, // 11432
-    0xb8ce, 0xb8cd, 0xb8cc, 0xb8ca, 0xb8c9, 0xb8c8, 0xb8c7, 0xb8c5, // 11440
-    0xb8c4, 0xb8c3, 0xb8c1, 0xb8c0, 0xb8bf, 0xb8be, 0xb8bc, 0xb8bb, // 11448
-    0xb8ba, 0xb8b9, 0xb8b7, 0xb8b6, 0xb8b5, 0xb8b4, 0xb8b2, 0xb8b1, // 11456
-    0xb8b0, 0xb8af, 0xb8ad, 0xb8ac, 0xb8ab, 0xb8a9, 0xb8a8, 0xb8a7, // 11464
-    0xb8a6, 0xb8a4, 0xb8a3, 0xb8a2, 0xb8a1, 0xb89f, 0xb89e, 0xb89d, // 11472
-    0xb89c, 0xb89a, 0xb899, 0xb898, 0xb896, 0xb895, 0xb894, 0xb893, // 11480
-    0xb891, 0xb890, 0xb88f, 0xb88e, 0xb88c, 0xb88b, 0xb88a, 0xb889, // 11488
-    0xb887, 0xb886, 0xb885, 0xb884, 0xb882, 0xb881, 0xb880, 0xb87e, // 11496
-    0xb87d, 0xb87c, 0xb87b, 0xb879, 0xb878, 0xb877, 0xb876, 0xb874, // 11504
-    0xb873, 0xb872, 0xb871, 0xb86f, 0xb86e, 0xb86d, 0xb86c, 0xb86a, // 11512
-    0xb869, 0xb868, 0xb866, 0xb865, 0xb864, 0xb863, 0xb861, 0xb860, // 11520
-    0xb85f, 0xb85e, 0xb85c, 0xb85b, 0xb85a, 0xb859, 0xb857, 0xb856, // 11528
-    0xb855, 0xb854, 0xb852, 0xb851, 0xb850, 0xb84e, 0xb84d, 0xb84c, // 11536
-    0xb84b, 0xb849, 0xb848, 0xb847, 0xb846, 0xb844, 0xb843, 0xb842, // 11544
-    0xb841, 0xb83f, 0xb83e, 0xb83d, 0xb83c, 0xb83a, 0xb839, 0xb838, // 11552
-    0xb836, 0xb835, 0xb834, 0xb833, 0xb831, 0xb830, 0xb82f, 0xb82e, // 11560
-    0xb82c, 0xb82b, 0xb82a, 0xb829, 0xb827, 0xb826, 0xb825, 0xb823, // 11568
-    0xb822, 0xb821, 0xb820, 0xb81e, 0xb81d, 0xb81c, 0xb81b, 0xb819, // 11576
-    0xb818, 0xb817, 0xb816, 0xb814, 0xb813, 0xb812, 0xb811, 0xb80f, // 11584
-    0xb80e, 0xb80d, 0xb80b, 0xb80a, 0xb809, 0xb808, 0xb806, 0xb805, // 11592
-    0xb804, 0xb803, 0xb801, 0xb800, 0xb7ff, 0xb7fe, 0xb7fc, 0xb7fb, // 11600
-    0xb7fa, 0xb7f9, 0xb7f7, 0xb7f6, 0xb7f5, 0xb7f3, 0xb7f2, 0xb7f1, // 11608
-    0xb7f0, 0xb7ee, 0xb7ed, 0xb7ec, 0xb7eb, 0xb7e9, 0xb7e8, 0xb7e7, // 11616
-    0xb7e6, 0xb7e4, 0xb7e3, 0xb7e2, 0xb7e1, 0xb7df, 0xb7de, 0xb7dd, // 11624
-    0xb7db, 0xb7da, 0xb7d9, 0xb7d8, 0xb7d6, 0xb7d5, 0xb7d4, 0xb7d3, // 11632
-    0xb7d1, 0xb7d0, 0xb7cf, 0xb7ce, 0xb7cc, 0xb7cb, 0xb7ca, 0xb7c9, // 11640
-    0xb7c7, 0xb7c6, 0xb7c5, 0xb7c3, 0xb7c2, 0xb7c1, 0xb7c0, 0xb7be, // 11648
-    0xb7bd, 0xb7bc, 0xb7bb, 0xb7b9, 0xb7b8, 0xb7b7, 0xb7b6, 0xb7b4, // 11656
-    0xb7b3, 0xb7b2, 0xb7b1, 0xb7af, 0xb7ae, 0xb7ad, 0xb7ab, 0xb7aa, // 11664
-    0xb7a9, 0xb7a8, 0xb7a6, 0xb7a5, 0xb7a4, 0xb7a3, 0xb7a1, 0xb7a0, // 11672
-    0xb79f, 0xb79e, 0xb79c, 0xb79b, 0xb79a, 0xb798, 0xb797, 0xb796, // 11680
-    0xb795, 0xb793, 0xb792, 0xb791, 0xb790, 0xb78e, 0xb78d, 0xb78c, // 11688
-    0xb78b, 0xb789, 0xb788, 0xb787, 0xb786, 0xb784, 0xb783, 0xb782, // 11696
-    0xb780, 0xb77f, 0xb77e, 0xb77d, 0xb77b, 0xb77a, 0xb779, 0xb778, // 11704
-    0xb776, 0xb775, 0xb774, 0xb773, 0xb771, 0xb770, 0xb76f, 0xb76e, // 11712
-    0xb76c, 0xb76b, 0xb76a, 0xb768, 0xb767, 0xb766, 0xb765, 0xb763, // 11720
-    0xb762, 0xb761, 0xb760, 0xb75e, 0xb75d, 0xb75c, 0xb75b, 0xb759, // 11728
-    0xb758, 0xb757, 0xb756, 0xb754, 0xb753, 0xb752, 0xb750, 0xb74f, // 11736
-    0xb74e, 0xb74d, 0xb74b, 0xb74a, 0xb749, 0xb748, 0xb746, 0xb745, // 11744
-    0xb744, 0xb743, 0xb741, 0xb740, 0xb73f, 0xb73e, 0xb73c, 0xb73b, // 11752
-    0xb73a, 0xb738, 0xb737, 0xb736, 0xb735, 0xb733, 0xb732, 0xb731, // 11760
-    0xb730, 0xb72e, 0xb72d, 0xb72c, 0xb72b, 0xb729, 0xb728, 0xb727, // 11768
-    0xb726, 0xb724, 0xb723, 0xb722, 0xb720, 0xb71f, 0xb71e, 0xb71d, // 11776
-    0xb71b, 0xb71a, 0xb719, 0xb718, 0xb716, 0xb715, 0xb714, 0xb713, // 11784
-    0xb711, 0xb710, 0xb70f, 0xb70d, 0xb70c, 0xb70b, 0xb70a, 0xb708, // 11792
-    0xb707, 0xb706, 0xb705, 0xb703, 0xb702, 0xb701, 0xb700, 0xb6fe, // 11800
-    0xb6fd, 0xb6fc, 0xb6fb, 0xb6f9, 0xb6f8, 0xb6f7, 0xb6f5, 0xb6f4, // 11808
-    0xb6f3, 0xb6f2, 0xb6f0, 0xb6ef, 0xb6ee, 0xb6ed, 0xb6eb, 0xb6ea, // 11816
-    0xb6e9, 0xb6e8, 0xb6e6, 0xb6e5, 0xb6e4, 0xb6e3, 0xb6e1, 0xb6e0, // 11824
-    0xb6df, 0xb6dd, 0xb6dc, 0xb6db, 0xb6da, 0xb6d8, 0xb6d7, 0xb6d6, // 11832
-    0xb6d5, 0xb6d3, 0xb6d2, 0xb6d1, 0xb6d0, 0xb6ce, 0xb6cd, 0xb6cc, // 11840
-    0xb6cb, 0xb6c9, 0xb6c8, 0xb6c7, 0xb6c5, 0xb6c4, 0xb6c3, 0xb6c2, // 11848
-    0xb6c0, 0xb6bf, 0xb6be, 0xb6bd, 0xb6bb, 0xb6ba, 0xb6b9, 0xb6b8, // 11856
-    0xb6b6, 0xb6b5, 0xb6b4, 0xb6b3, 0xb6b1, 0xb6b0, 0xb6af, 0xb6ad, // 11864
-    0xb6ac, 0xb6ab, 0xb6aa, 0xb6a8, 0xb6a7, 0xb6a6, 0xb6a5, 0xb6a3, // 11872
-    0xb6a2, 0xb6a1, 0xb6a0, 0xb69e, 0xb69d, 0xb69c, 0xb69a, 0xb699, // 11880
-    0xb698, 0xb697, 0xb695, 0xb694, 0xb693, 0xb692, 0xb690, 0xb68f, // 11888
-    0xb68e, 0xb68d, 0xb68b, 0xb68a, 0xb689, 0xb688, 0xb686, 0xb685, // 11896
-    0xb684, 0xb682, 0xb681, 0xb680, 0xb67f, 0xb67d, 0xb67c, 0xb67b, // 11904
-    0xb67a, 0xb678, 0xb677, 0xb676, 0xb675, 0xb673, 0xb672, 0xb671, // 11912
-    0xb670, 0xb66e, 0xb66d, 0xb66c, 0xb66a, 0xb669, 0xb668, 0xb667, // 11920
-    0xb665, 0xb664, 0xb663, 0xb662, 0xb660, 0xb65f, 0xb65e, 0xb65d, // 11928
-    0xb65b, 0xb65a, 0xb659, 0xb658, 0xb656, 0xb655, 0xb654, 0xb652, // 11936
-    0xb651, 0xb650, 0xb64f, 0xb64d, 0xb64c, 0xb64b, 0xb64a, 0xb648, // 11944
-    0xb647, 0xb646, 0xb645, 0xb643, 0xb642, 0xb641, 0xb640, 0xb63e, // 11952
-    0xb63d, 0xb63c, 0xb63a, 0xb639, 0xb638, 0xb637, 0xb635, 0xb634, // 11960
-    0xb633, 0xb632, 0xb630, 0xb62f, 0xb62e, 0xb62d, 0xb62b, 0xb62a, // 11968
-    0xb629, 0xb628, 0xb626, 0xb625, 0xb624, 0xb622, 0xb621, 0xb620, // 11976
-    0xb61f, 0xb61d, 0xb61c, 0xb61b, 0xb61a, 0xb618, 0xb617, 0xb616, // 11984
-    0xb615, 0xb613, 0xb612, 0xb611, 0xb60f, 0xb60e, 0xb60d, 0xb60c, // 11992
-    0xb60a, 0xb609, 0xb608, 0xb607, 0xb605, 0xb604, 0xb603, 0xb602, // 12000
-    0xb600, 0xb5ff, 0xb5fe, 0xb5fd, 0xb5fb, 0xb5fa, 0xb5f9, 0xb5f7, // 12008
-    0xb5f6, 0xb5f5, 0xb5f4, 0xb5f2, 0xb5f1, 0xb5f0, 0xb5ef, 0xb5ed, // 12016
-    0xb5ec, 0xb5eb, 0xb5ea, 0xb5e8, 0xb5e7, 0xb5e6, 0xb5e5, 0xb5e3, // 12024
-    0xb5e2, 0xb5e1, 0xb5df, 0xb5de, 0xb5dd, 0xb5dc, 0xb5da, 0xb5d9, // 12032
-    0xb5d8, 0xb5d7, 0xb5d5, 0xb5d4, 0xb5d3, 0xb5d2, 0xb5d0, 0xb5cf, // 12040
-    0xb5ce, 0xb5cd, 0xb5cb, 0xb5ca, 0xb5c9, 0xb5c7, 0xb5c6, 0xb5c5, // 12048
-    0xb5c4, 0xb5c2, 0xb5c1, 0xb5c0, 0xb5bf, 0xb5bd, 0xb5bc, 0xb5bb, // 12056
-    0xb5ba, 0xb5b8, 0xb5b7, 0xb5b6, 0xb5b5, 0xb5b3, 0xb5b2, 0xb5b1, // 12064
-    0xb5af, 0xb5ae, 0xb5ad, 0xb5ac, 0xb5aa, 0xb5a9, 0xb5a8, 0xb5a7, // 12072
-    0xb5a5, 0xb5a4, 0xb5a3, 0xb5a2, 0xb5a0, 0xb59f, 0xb59e, 0xb59c, // 12080
-    0xb59b, 0xb59a, 0xb599, 0xb597, 0xb596, 0xb595, 0xb594, 0xb592, // 12088
-    0xb591, 0xb590, 0xb58f, 0xb58d, 0xb58c, 0xb58b, 0xb58a, 0xb588, // 12096
-    0xb587, 0xb586, 0xb584, 0xb583, 0xb582, 0xb581, 0xb57f, 0xb57e, // 12104
-    0xb57d, 0xb57c, 0xb57a, 0xb579, 0xb578, 0xb577, 0xb575, 0xb574, // 12112
-    0xb573, 0xb572, 0xb570, 0xb56f, 0xb56e, 0xb56c, 0xb56b, 0xb56a, // 12120
-    0xb569, 0xb567, 0xb566, 0xb565, 0xb564, 0xb562, 0xb561, 0xb560, // 12128
-    0xb55f, 0xb55d, 0xb55c, 0xb55b, 0xb55a, 0xb558, 0xb557, 0xb556, // 12136
-    0xb554, 0xb553, 0xb552, 0xb551, 0xb54f, 0xb54e, 0xb54d, 0xb54c, // 12144
-    0xb54a, 0xb549, 0xb548, 0xb547, 0xb545, 0xb544, 0xb543, 0xb542, // 12152
-    0xb540, 0xb53f, 0xb53e, 0xb53c, 0xb53b, 0xb53a, 0xb539, 0xb537, // 12160
-    0xb536, 0xb535, 0xb534, 0xb532, 0xb531, 0xb530, 0xb52f, 0xb52d, // 12168
-    0xb52c, 0xb52b, 0xb52a, 0xb528, 0xb527, 0xb526, 0xb524, 0xb523, // 12176
-    0xb522, 0xb521, 0xb51f, 0xb51e, 0xb51d, 0xb51c, 0xb51a, 0xb519, // 12184
-    0xb518, 0xb517, 0xb515, 0xb514, 0xb513, 0xb511, 0xb510, 0xb50f, // 12192
-    0xb50e, 0xb50c, 0xb50b, 0xb50a, 0xb509, 0xb507, 0xb506, 0xb505, // 12200
-    0xb504, 0xb502, 0xb501, 0xb500, 0xb4ff, 0xb4fd, 0xb4fc, 0xb4fb, // 12208
-    0xb4f9, 0xb4f8, 0xb4f7, 0xb4f6, 0xb4f4, 0xb4f3, 0xb4f2, 0xb4f1, // 12216
-    0xb4ef, 0xb4ee, 0xb4ed, 0xb4ec, 0xb4ea, 0xb4e9, 0xb4e8, 0xb4e7, // 12224
-    0xb4e5, 0xb4e4, 0xb4e3, 0xb4e1, 0xb4e0, 0xb4df, 0xb4de, 0xb4dc, // 12232
-    0xb4db, 0xb4da, 0xb4d9, 0xb4d7, 0xb4d6, 0xb4d5, 0xb4d4, 0xb4d2, // 12240
-    0xb4d1, 0xb4d0, 0xb4cf, 0xb4cd, 0xb4cc, 0xb4cb, 0xb4c9, 0xb4c8, // 12248
-    0xb4c7, 0xb4c6, 0xb4c4, 0xb4c3, 0xb4c2, 0xb4c1, 0xb4bf, 0xb4be, // 12256
-    0xb4bd, 0xb4bc, 0xb4ba, 0xb4b9, 0xb4b8, 0xb4b7, 0xb4b5, 0xb4b4, // 12264
-    0xb4b3, 0xb4b1, 0xb4b0, 0xb4af, 0xb4ae, 0xb4ac, 0xb4ab, 0xb4aa, // 12272
-    0xb4a9, 0xb4a7, 0xb4a6, 0xb4a5, 0xb4a4, 0xb4a2, 0xb4a1, 0xb4a0, // 12280
-    0xb4a0, 0xb49f, 0xb49e, 0xb49c, 0xb49b, 0xb49a, 0xb499, 0xb497, // 12288
-    0xb496, 0xb495, 0xb494, 0xb493, 0xb491, 0xb490, 0xb48f, 0xb48e, // 12296
-    0xb48c, 0xb48b, 0xb48a, 0xb489, 0xb488, 0xb486, 0xb485, 0xb484, // 12304
-    0xb483, 0xb481, 0xb480, 0xb47f, 0xb47e, 0xb47d, 0xb47b, 0xb47a, // 12312
-    0xb479, 0xb478, 0xb476, 0xb475, 0xb474, 0xb473, 0xb472, 0xb470, // 12320
-    0xb46f, 0xb46e, 0xb46d, 0xb46c, 0xb46a, 0xb469, 0xb468, 0xb467, // 12328
-    0xb465, 0xb464, 0xb463, 0xb462, 0xb461, 0xb45f, 0xb45e, 0xb45d, // 12336
-    0xb45c, 0xb45a, 0xb459, 0xb458, 0xb457, 0xb456, 0xb454, 0xb453, // 12344
-    0xb452, 0xb451, 0xb44f, 0xb44e, 0xb44d, 0xb44c, 0xb44b, 0xb449, // 12352
-    0xb448, 0xb447, 0xb446, 0xb444, 0xb443, 0xb442, 0xb441, 0xb440, // 12360
-    0xb43e, 0xb43d, 0xb43c, 0xb43b, 0xb439, 0xb438, 0xb437, 0xb436, // 12368
-    0xb435, 0xb433, 0xb432, 0xb431, 0xb430, 0xb42e, 0xb42d, 0xb42c, // 12376
-    0xb42b, 0xb42a, 0xb428, 0xb427, 0xb426, 0xb425, 0xb423, 0xb422, // 12384
-    0xb421, 0xb420, 0xb41f, 0xb41d, 0xb41c, 0xb41b, 0xb41a, 0xb419, // 12392
-    0xb417, 0xb416, 0xb415, 0xb414, 0xb412, 0xb411, 0xb410, 0xb40f, // 12400
-    0xb40e, 0xb40c, 0xb40b, 0xb40a, 0xb409, 0xb407, 0xb406, 0xb405, // 12408
-    0xb404, 0xb403, 0xb401, 0xb400, 0xb3ff, 0xb3fe, 0xb3fc, 0xb3fb, // 12416
-    0xb3fa, 0xb3f9, 0xb3f8, 0xb3f6, 0xb3f5, 0xb3f4, 0xb3f3, 0xb3f1, // 12424
-    0xb3f0, 0xb3ef, 0xb3ee, 0xb3ed, 0xb3eb, 0xb3ea, 0xb3e9, 0xb3e8, // 12432
-    0xb3e6, 0xb3e5, 0xb3e4, 0xb3e3, 0xb3e2, 0xb3e0, 0xb3df, 0xb3de, // 12440
-    0xb3dd, 0xb3db, 0xb3da, 0xb3d9, 0xb3d8, 0xb3d7, 0xb3d5, 0xb3d4, // 12448
-    0xb3d3, 0xb3d2, 0xb3d0, 0xb3cf, 0xb3ce, 0xb3cd, 0xb3cc, 0xb3ca, // 12456
-    0xb3c9, 0xb3c8, 0xb3c7, 0xb3c5, 0xb3c4, 0xb3c3, 0xb3c2, 0xb3c1, // 12464
-    0xb3bf, 0xb3be, 0xb3bd, 0xb3bc, 0xb3bb, 0xb3b9, 0xb3b8, 0xb3b7, // 12472
-    0xb3b6, 0xb3b4, 0xb3b3, 0xb3b2, 0xb3b1, 0xb3b0, 0xb3ae, 0xb3ad, // 12480
-    0xb3ac, 0xb3ab, 0xb3a9, 0xb3a8, 0xb3a7, 0xb3a6, 0xb3a5, 0xb3a3, // 12488
-    0xb3a2, 0xb3a1, 0xb3a0, 0xb39e, 0xb39d, 0xb39c, 0xb39b, 0xb39a, // 12496
-    0xb398, 0xb397, 0xb396, 0xb395, 0xb393, 0xb392, 0xb391, 0xb390, // 12504
-    0xb38f, 0xb38d, 0xb38c, 0xb38b, 0xb38a, 0xb388, 0xb387, 0xb386, // 12512
-    0xb385, 0xb384, 0xb382, 0xb381, 0xb380, 0xb37f, 0xb37d, 0xb37c, // 12520
-    0xb37b, 0xb37a, 0xb379, 0xb377, 0xb376, 0xb375, 0xb374, 0xb372, // 12528
-    0xb371, 0xb370, 0xb36f, 0xb36e, 0xb36c, 0xb36b, 0xb36a, 0xb369, // 12536
-    0xb368, 0xb366, 0xb365, 0xb364, 0xb363, 0xb361, 0xb360, 0xb35f, // 12544
-    0xb35e, 0xb35d, 0xb35b, 0xb35a, 0xb359, 0xb358, 0xb356, 0xb355, // 12552
-    0xb354, 0xb353, 0xb352, 0xb350, 0xb34f, 0xb34e, 0xb34d, 0xb34b, // 12560
-    0xb34a, 0xb349, 0xb348, 0xb347, 0xb345, 0xb344, 0xb343, 0xb342, // 12568
-    0xb340, 0xb33f, 0xb33e, 0xb33d, 0xb33c, 0xb33a, 0xb339, 0xb338, // 12576
-    0xb337, 0xb335, 0xb334, 0xb333, 0xb332, 0xb331, 0xb32f, 0xb32e, // 12584
-    0xb32d, 0xb32c, 0xb32a, 0xb329, 0xb328, 0xb327, 0xb326, 0xb324, // 12592
-    0xb323, 0xb322, 0xb321, 0xb31f, 0xb31e, 0xb31d, 0xb31c, 0xb31b, // 12600
-    0xb319, 0xb318, 0xb317, 0xb316, 0xb314, 0xb313, 0xb312, 0xb311, // 12608
-    0xb310, 0xb30e, 0xb30d, 0xb30c, 0xb30b, 0xb30a, 0xb308, 0xb307, // 12616
-    0xb306, 0xb305, 0xb303, 0xb302, 0xb301, 0xb300, 0xb2ff, 0xb2fd, // 12624
-    0xb2fc, 0xb2fb, 0xb2fa, 0xb2f8, 0xb2f7, 0xb2f6, 0xb2f5, 0xb2f4, // 12632
-    0xb2f2, 0xb2f1, 0xb2f0, 0xb2ef, 0xb2ed, 0xb2ec, 0xb2eb, 0xb2ea, // 12640
-    0xb2e9, 0xb2e7, 0xb2e6, 0xb2e5, 0xb2e4, 0xb2e2, 0xb2e1, 0xb2e0, // 12648
-    0xb2df, 0xb2de, 0xb2dc, 0xb2db, 0xb2da, 0xb2d9, 0xb2d7, 0xb2d6, // 12656
-    0xb2d5, 0xb2d4, 0xb2d3, 0xb2d1, 0xb2d0, 0xb2cf, 0xb2ce, 0xb2cc, // 12664
-    0xb2cb, 0xb2ca, 0xb2c9, 0xb2c8, 0xb2c6, 0xb2c5, 0xb2c4, 0xb2c3, // 12672
-    0xb2c1, 0xb2c0, 0xb2bf, 0xb2be, 0xb2bd, 0xb2bb, 0xb2ba, 0xb2b9, // 12680
-    0xb2b8, 0xb2b6, 0xb2b5, 0xb2b4, 0xb2b3, 0xb2b2, 0xb2b0, 0xb2af, // 12688
-    0xb2ae, 0xb2ad, 0xb2ac, 0xb2aa, 0xb2a9, 0xb2a8, 0xb2a7, 0xb2a5, // 12696
-    0xb2a4, 0xb2a3, 0xb2a2, 0xb2a1, 0xb29f, 0xb29e, 0xb29d, 0xb29c, // 12704
-    0xb29a, 0xb299, 0xb298, 0xb297, 0xb296, 0xb294, 0xb293, 0xb292, // 12712
-    0xb291, 0xb28f, 0xb28e, 0xb28d, 0xb28c, 0xb28b, 0xb289, 0xb288, // 12720
-    0xb287, 0xb286, 0xb284, 0xb283, 0xb282, 0xb281, 0xb280, 0xb27e, // 12728
-    0xb27d, 0xb27c, 0xb27b, 0xb279, 0xb278, 0xb277, 0xb276, 0xb275, // 12736
-    0xb273, 0xb272, 0xb271, 0xb270, 0xb26e, 0xb26d, 0xb26c, 0xb26b, // 12744
-    0xb26a, 0xb268, 0xb267, 0xb266, 0xb265, 0xb263, 0xb262, 0xb261, // 12752
-    0xb260, 0xb25f, 0xb25d, 0xb25c, 0xb25b, 0xb25a, 0xb259, 0xb257, // 12760
-    0xb256, 0xb255, 0xb254, 0xb252, 0xb251, 0xb250, 0xb24f, 0xb24e, // 12768
-    0xb24c, 0xb24b, 0xb24a, 0xb249, 0xb247, 0xb246, 0xb245, 0xb244, // 12776
-    0xb243, 0xb241, 0xb240, 0xb23f, 0xb23e, 0xb23c, 0xb23b, 0xb23a, // 12784
-    0xb239, 0xb238, 0xb236, 0xb235, 0xb234, 0xb233, 0xb231, 0xb230, // 12792
-    0xb22f, 0xb22e, 0xb22d, 0xb22b, 0xb22a, 0xb229, 0xb228, 0xb226, // 12800
-    0xb225, 0xb224, 0xb223, 0xb222, 0xb220, 0xb21f, 0xb21e, 0xb21d, // 12808
-    0xb21b, 0xb21a, 0xb219, 0xb218, 0xb217, 0xb215, 0xb214, 0xb213, // 12816
-    0xb212, 0xb210, 0xb20f, 0xb20e, 0xb20d, 0xb20c, 0xb20a, 0xb209, // 12824
-    0xb208, 0xb207, 0xb205, 0xb204, 0xb203, 0xb202, 0xb201, 0xb1ff, // 12832
-    0xb1fe, 0xb1fd, 0xb1fc, 0xb1fb, 0xb1f9, 0xb1f8, 0xb1f7, 0xb1f6, // 12840
-    0xb1f4, 0xb1f3, 0xb1f2, 0xb1f1, 0xb1f0, 0xb1ee, 0xb1ed, 0xb1ec, // 12848
-    0xb1eb, 0xb1e9, 0xb1e8, 0xb1e7, 0xb1e6, 0xb1e5, 0xb1e3, 0xb1e2, // 12856
-    0xb1e1, 0xb1e0, 0xb1de, 0xb1dd, 0xb1dc, 0xb1db, 0xb1da, 0xb1d8, // 12864
-    0xb1d7, 0xb1d6, 0xb1d5, 0xb1d3, 0xb1d2, 0xb1d1, 0xb1d0, 0xb1cf, // 12872
-    0xb1cd, 0xb1cc, 0xb1cb, 0xb1ca, 0xb1c8, 0xb1c7, 0xb1c6, 0xb1c5, // 12880
-    0xb1c4, 0xb1c2, 0xb1c1, 0xb1c0, 0xb1bf, 0xb1bd, 0xb1bc, 0xb1bb, // 12888
-    0xb1ba, 0xb1b9, 0xb1b7, 0xb1b6, 0xb1b5, 0xb1b4, 0xb1b2, 0xb1b1, // 12896
-    0xb1b0, 0xb1af, 0xb1ae, 0xb1ac, 0xb1ab, 0xb1aa, 0xb1a9, 0xb1a8, // 12904
-    0xb1a6, 0xb1a5, 0xb1a4, 0xb1a3, 0xb1a1, 0xb1a0, 0xb19f, 0xb19e, // 12912
-    0xb19d, 0xb19b, 0xb19a, 0xb199, 0xb198, 0xb196, 0xb195, 0xb194, // 12920
-    0xb193, 0xb192, 0xb190, 0xb18f, 0xb18e, 0xb18d, 0xb18b, 0xb18a, // 12928
-    0xb189, 0xb188, 0xb187, 0xb185, 0xb184, 0xb183, 0xb182, 0xb180, // 12936
-    0xb17f, 0xb17e, 0xb17d, 0xb17c, 0xb17a, 0xb179, 0xb178, 0xb177, // 12944
-    0xb175, 0xb174, 0xb173, 0xb172, 0xb171, 0xb16f, 0xb16e, 0xb16d, // 12952
-    0xb16c, 0xb16a, 0xb169, 0xb168, 0xb167, 0xb166, 0xb164, 0xb163, // 12960
-    0xb162, 0xb161, 0xb15f, 0xb15e, 0xb15d, 0xb15c, 0xb15b, 0xb159, // 12968
-    0xb158, 0xb157, 0xb156, 0xb154, 0xb153, 0xb152, 0xb151, 0xb150, // 12976
-    0xb14e, 0xb14d, 0xb14c, 0xb14b, 0xb14a, 0xb148, 0xb147, 0xb146, // 12984
-    0xb145, 0xb143, 0xb142, 0xb141, 0xb140, 0xb13f, 0xb13d, 0xb13c, // 12992
-    0xb13b, 0xb13a, 0xb138, 0xb137, 0xb136, 0xb135, 0xb134, 0xb132, // 13000
-    0xb131, 0xb130, 0xb12f, 0xb12d, 0xb12c, 0xb12b, 0xb12a, 0xb129, // 13008
-    0xb127, 0xb126, 0xb125, 0xb124, 0xb122, 0xb121, 0xb120, 0xb11f, // 13016
-    0xb11e, 0xb11c, 0xb11b, 0xb11a, 0xb119, 0xb117, 0xb116, 0xb115, // 13024
-    0xb114, 0xb113, 0xb111, 0xb110, 0xb10f, 0xb10e, 0xb10c, 0xb10b, // 13032
-    0xb10a, 0xb109, 0xb108, 0xb106, 0xb105, 0xb104, 0xb103, 0xb101, // 13040
-    0xb100, 0xb0ff, 0xb0fe, 0xb0fd, 0xb0fb, 0xb0fa, 0xb0f9, 0xb0f8, // 13048
-    0xb0f7, 0xb0f5, 0xb0f4, 0xb0f3, 0xb0f2, 0xb0f0, 0xb0ef, 0xb0ee, // 13056
-    0xb0ed, 0xb0ec, 0xb0ea, 0xb0e9, 0xb0e8, 0xb0e7, 0xb0e5, 0xb0e4, // 13064
-    0xb0e3, 0xb0e2, 0xb0e1, 0xb0df, 0xb0de, 0xb0dd, 0xb0dc, 0xb0da, // 13072
-    0xb0d9, 0xb0d8, 0xb0d7, 0xb0d6, 0xb0d4, 0xb0d3, 0xb0d2, 0xb0d1, // 13080
-    0xb0cf, 0xb0ce, 0xb0cd, 0xb0cc, 0xb0cb, 0xb0c9, 0xb0c8, 0xb0c7, // 13088
-    0xb0c6, 0xb0c4, 0xb0c3, 0xb0c2, 0xb0c1, 0xb0c0, 0xb0be, 0xb0bd, // 13096
-    0xb0bc, 0xb0bb, 0xb0b9, 0xb0b8, 0xb0b7, 0xb0b6, 0xb0b5, 0xb0b3, // 13104
-    0xb0b2, 0xb0b1, 0xb0b0, 0xb0ae, 0xb0ad, 0xb0ac, 0xb0ab, 0xb0aa, // 13112
-    0xb0a8, 0xb0a7, 0xb0a6, 0xb0a5, 0xb0a3, 0xb0a2, 0xb0a1, 0xb0a0, // 13120
-    0xb09f, 0xb09d, 0xb09c, 0xb09b, 0xb09a, 0xb099, 0xb097, 0xb096, // 13128
-    0xb095, 0xb094, 0xb092, 0xb091, 0xb090, 0xb08f, 0xb08e, 0xb08c, // 13136
-    0xb08b, 0xb08a, 0xb089, 0xb087, 0xb086, 0xb085, 0xb084, 0xb083, // 13144
-    0xb081, 0xb080, 0xb07f, 0xb07e, 0xb07c, 0xb07b, 0xb07a, 0xb079, // 13152
-    0xb078, 0xb076, 0xb075, 0xb074, 0xb073, 0xb071, 0xb070, 0xb06f, // 13160
-    0xb06e, 0xb06d, 0xb06b, 0xb06a, 0xb069, 0xb068, 0xb066, 0xb065, // 13168
-    0xb064, 0xb063, 0xb062, 0xb060, 0xb05f, 0xb05e, 0xb05d, 0xb05b, // 13176
-    0xb05a, 0xb059, 0xb058, 0xb057, 0xb055, 0xb054, 0xb053, 0xb052, // 13184
-    0xb050, 0xb04f, 0xb04e, 0xb04d, 0xb04c, 0xb04a, 0xb049, 0xb048, // 13192
-    0xb047, 0xb045, 0xb044, 0xb043, 0xb042, 0xb041, 0xb03f, 0xb03e, // 13200
-    0xb03d, 0xb03c, 0xb03b, 0xb039, 0xb038, 0xb037, 0xb036, 0xb034, // 13208
-    0xb033, 0xb032, 0xb031, 0xb030, 0xb02e, 0xb02d, 0xb02c, 0xb02b, // 13216
-    0xb029, 0xb028, 0xb027, 0xb026, 0xb025, 0xb023, 0xb022, 0xb021, // 13224
-    0xb020, 0xb01e, 0xb01d, 0xb01c, 0xb01b, 0xb01a, 0xb018, 0xb017, // 13232
-    0xb016, 0xb015, 0xb013, 0xb012, 0xb011, 0xb010, 0xb00f, 0xb00d, // 13240
-    0xb00c, 0xb00b, 0xb00a, 0xb008, 0xb007, 0xb006, 0xb005, 0xb004, // 13248
-    0xb002, 0xb001, 0xb000, 0xafff, 0xaffd, 0xaffc, 0xaffb, 0xaffa, // 13256
-    0xaff9, 0xaff7, 0xaff6, 0xaff5, 0xaff4, 0xaff2, 0xaff1, 0xaff0, // 13264
-    0xafef, 0xafee, 0xafec, 0xafeb, 0xafea, 0xafe9, 0xafe8, 0xafe6, // 13272
-    0xafe5, 0xafe4, 0xafe3, 0xafe1, 0xafe0, 0xafdf, 0xafde, 0xafdd, // 13280
-    0xafdb, 0xafda, 0xafd9, 0xafd8, 0xafd6, 0xafd5, 0xafd4, 0xafd3, // 13288
-    0xafd2, 0xafd0, 0xafcf, 0xafce, 0xafcd, 0xafcb, 0xafca, 0xafc9, // 13296
-    0xafc8, 0xafc7, 0xafc5, 0xafc4, 0xafc3, 0xafc2, 0xafc0, 0xafbf, // 13304
-    0xafbe, 0xafbd, 0xafbc, 0xafba, 0xafb9, 0xafb8, 0xafb7, 0xafb6, // 13312
-    0xafb5, 0xafb3, 0xafb2, 0xafb1, 0xafb0, 0xafaf, 0xafae, 0xafac, // 13320
-    0xafab, 0xafaa, 0xafa9, 0xafa8, 0xafa6, 0xafa5, 0xafa4, 0xafa3, // 13328
-    0xafa2, 0xafa1, 0xaf9f, 0xaf9e, 0xaf9d, 0xaf9c, 0xaf9b, 0xaf99, // 13336
-    0xaf98, 0xaf97, 0xaf96, 0xaf95, 0xaf94, 0xaf92, 0xaf91, 0xaf90, // 13344
-    0xaf8f, 0xaf8e, 0xaf8d, 0xaf8b, 0xaf8a, 0xaf89, 0xaf88, 0xaf87, // 13352
-    0xaf85, 0xaf84, 0xaf83, 0xaf82, 0xaf81, 0xaf80, 0xaf7e, 0xaf7d, // 13360
-    0xaf7c, 0xaf7b, 0xaf7a, 0xaf79, 0xaf77, 0xaf76, 0xaf75, 0xaf74, // 13368
-    0xaf73, 0xaf71, 0xaf70, 0xaf6f, 0xaf6e, 0xaf6d, 0xaf6c, 0xaf6a, // 13376
-    0xaf69, 0xaf68, 0xaf67, 0xaf66, 0xaf64, 0xaf63, 0xaf62, 0xaf61, // 13384
-    0xaf60, 0xaf5f, 0xaf5d, 0xaf5c, 0xaf5b, 0xaf5a, 0xaf59, 0xaf58, // 13392
-    0xaf56, 0xaf55, 0xaf54, 0xaf53, 0xaf52, 0xaf50, 0xaf4f, 0xaf4e, // 13400
-    0xaf4d, 0xaf4c, 0xaf4b, 0xaf49, 0xaf48, 0xaf47, 0xaf46, 0xaf45, // 13408
-    0xaf44, 0xaf42, 0xaf41, 0xaf40, 0xaf3f, 0xaf3e, 0xaf3c, 0xaf3b, // 13416
-    0xaf3a, 0xaf39, 0xaf38, 0xaf37, 0xaf35, 0xaf34, 0xaf33, 0xaf32, // 13424
-    0xaf31, 0xaf2f, 0xaf2e, 0xaf2d, 0xaf2c, 0xaf2b, 0xaf2a, 0xaf28, // 13432
-    0xaf27, 0xaf26, 0xaf25, 0xaf24, 0xaf23, 0xaf21, 0xaf20, 0xaf1f, // 13440
-    0xaf1e, 0xaf1d, 0xaf1b, 0xaf1a, 0xaf19, 0xaf18, 0xaf17, 0xaf16, // 13448
-    0xaf14, 0xaf13, 0xaf12, 0xaf11, 0xaf10, 0xaf0f, 0xaf0d, 0xaf0c, // 13456
-    0xaf0b, 0xaf0a, 0xaf09, 0xaf07, 0xaf06, 0xaf05, 0xaf04, 0xaf03, // 13464
-    0xaf02, 0xaf00, 0xaeff, 0xaefe, 0xaefd, 0xaefc, 0xaefa, 0xaef9, // 13472
-    0xaef8, 0xaef7, 0xaef6, 0xaef5, 0xaef3, 0xaef2, 0xaef1, 0xaef0, // 13480
-    0xaeef, 0xaeee, 0xaeec, 0xaeeb, 0xaeea, 0xaee9, 0xaee8, 0xaee6, // 13488
-    0xaee5, 0xaee4, 0xaee3, 0xaee2, 0xaee1, 0xaedf, 0xaede, 0xaedd, // 13496
-    0xaedc, 0xaedb, 0xaeda, 0xaed8, 0xaed7, 0xaed6, 0xaed5, 0xaed4, // 13504
-    0xaed2, 0xaed1, 0xaed0, 0xaecf, 0xaece, 0xaecd, 0xaecb, 0xaeca, // 13512
-    0xaec9, 0xaec8, 0xaec7, 0xaec5, 0xaec4, 0xaec3, 0xaec2, 0xaec1, // 13520
-    0xaec0, 0xaebe, 0xaebd, 0xaebc, 0xaebb, 0xaeba, 0xaeb9, 0xaeb7, // 13528
-    0xaeb6, 0xaeb5, 0xaeb4, 0xaeb3, 0xaeb1, 0xaeb0, 0xaeaf, 0xaeae, // 13536
-    0xaead, 0xaeac, 0xaeaa, 0xaea9, 0xaea8, 0xaea7, 0xaea6, 0xaea5, // 13544
-    0xaea3, 0xaea2, 0xaea1, 0xaea0, 0xae9f, 0xae9d, 0xae9c, 0xae9b, // 13552
-    0xae9a, 0xae99, 0xae98, 0xae96, 0xae95, 0xae94, 0xae93, 0xae92, // 13560
-    0xae91, 0xae8f, 0xae8e, 0xae8d, 0xae8c, 0xae8b, 0xae89, 0xae88, // 13568
-    0xae87, 0xae86, 0xae85, 0xae84, 0xae82, 0xae81, 0xae80, 0xae7f, // 13576
-    0xae7e, 0xae7c, 0xae7b, 0xae7a, 0xae79, 0xae78, 0xae77, 0xae75, // 13584
-    0xae74, 0xae73, 0xae72, 0xae71, 0xae70, 0xae6e, 0xae6d, 0xae6c, // 13592
-    0xae6b, 0xae6a, 0xae68, 0xae67, 0xae66, 0xae65, 0xae64, 0xae63, // 13600
-    0xae61, 0xae60, 0xae5f, 0xae5e, 0xae5d, 0xae5c, 0xae5a, 0xae59, // 13608
-    0xae58, 0xae57, 0xae56, 0xae54, 0xae53, 0xae52, 0xae51, 0xae50, // 13616
-    0xae4f, 0xae4d, 0xae4c, 0xae4b, 0xae4a, 0xae49, 0xae47, 0xae46, // 13624
-    0xae45, 0xae44, 0xae43, 0xae42, 0xae40, 0xae3f, 0xae3e, 0xae3d, // 13632
-    0xae3c, 0xae3b, 0xae39, 0xae38, 0xae37, 0xae36, 0xae35, 0xae33, // 13640
-    0xae32, 0xae31, 0xae30, 0xae2f, 0xae2e, 0xae2c, 0xae2b, 0xae2a, // 13648
-    0xae29, 0xae28, 0xae27, 0xae25, 0xae24, 0xae23, 0xae22, 0xae21, // 13656
-    0xae1f, 0xae1e, 0xae1d, 0xae1c, 0xae1b, 0xae1a, 0xae18, 0xae17, // 13664
-    0xae16, 0xae15, 0xae14, 0xae12, 0xae11, 0xae10, 0xae0f, 0xae0e, // 13672
-    0xae0d, 0xae0b, 0xae0a, 0xae09, 0xae08, 0xae07, 0xae06, 0xae04, // 13680
-    0xae03, 0xae02, 0xae01, 0xae00, 0xadfe, 0xadfd, 0xadfc, 0xadfb, // 13688
-    0xadfa, 0xadf9, 0xadf7, 0xadf6, 0xadf5, 0xadf4, 0xadf3, 0xadf2, // 13696
-    0xadf0, 0xadef, 0xadee, 0xaded, 0xadec, 0xadea, 0xade9, 0xade8, // 13704
-    0xade7, 0xade6, 0xade5, 0xade3, 0xade2, 0xade1, 0xade0, 0xaddf, // 13712
-    0xaddd, 0xaddc, 0xaddb, 0xadda, 0xadd9, 0xadd8, 0xadd6, 0xadd5, // 13720
-    0xadd4, 0xadd3, 0xadd2, 0xadd1, 0xadcf, 0xadce, 0xadcd, 0xadcc, // 13728
-    0xadcb, 0xadc9, 0xadc8, 0xadc7, 0xadc6, 0xadc5, 0xadc4, 0xadc2, // 13736
-    0xadc1, 0xadc0, 0xadbf, 0xadbe, 0xadbd, 0xadbb, 0xadba, 0xadb9, // 13744
-    0xadb8, 0xadb7, 0xadb5, 0xadb4, 0xadb3, 0xadb2, 0xadb1, 0xadb0, // 13752
-    0xadae, 0xadad, 0xadac, 0xadab, 0xadaa, 0xada8, 0xada7, 0xada6, // 13760
-    0xada5, 0xada4, 0xada3, 0xada1, 0xada0, 0xad9f, 0xad9e, 0xad9d, // 13768
-    0xad9c, 0xad9a, 0xad99, 0xad98, 0xad97, 0xad96, 0xad94, 0xad93, // 13776
-    0xad92, 0xad91, 0xad90, 0xad8f, 0xad8d, 0xad8c, 0xad8b, 0xad8a, // 13784
-    0xad89, 0xad88, 0xad86, 0xad85, 0xad84, 0xad83, 0xad82, 0xad80, // 13792
-    0xad7f, 0xad7e, 0xad7d, 0xad7c, 0xad7b, 0xad79, 0xad78, 0xad77, // 13800
-    0xad76, 0xad75, 0xad73, 0xad72, 0xad71, 0xad70, 0xad6f, 0xad6e, // 13808
-    0xad6c, 0xad6b, 0xad6a, 0xad69, 0xad68, 0xad67, 0xad65, 0xad64, // 13816
-    0xad63, 0xad62, 0xad61, 0xad5f, 0xad5e, 0xad5d, 0xad5c, 0xad5b, // 13824
-    0xad5a, 0xad58, 0xad57, 0xad56, 0xad55, 0xad54, 0xad53, 0xad51, // 13832
-    0xad50, 0xad4f, 0xad4e, 0xad4d, 0xad4b, 0xad4a, 0xad49, 0xad48, // 13840
-    0xad47, 0xad46, 0xad44, 0xad43, 0xad42, 0xad41, 0xad40, 0xad3e, // 13848
-    0xad3d, 0xad3c, 0xad3b, 0xad3a, 0xad39, 0xad37, 0xad36, 0xad35, // 13856
-    0xad34, 0xad33, 0xad32, 0xad30, 0xad2f, 0xad2e, 0xad2d, 0xad2c, // 13864
-    0xad2a, 0xad29, 0xad28, 0xad27, 0xad26, 0xad25, 0xad23, 0xad22, // 13872
-    0xad21, 0xad20, 0xad1f, 0xad1e, 0xad1c, 0xad1b, 0xad1a, 0xad19, // 13880
-    0xad18, 0xad16, 0xad15, 0xad14, 0xad13, 0xad12, 0xad11, 0xad0f, // 13888
-    0xad0e, 0xad0d, 0xad0c, 0xad0b, 0xad09, 0xad08, 0xad07, 0xad06, // 13896
-    0xad05, 0xad04, 0xad02, 0xad01, 0xad00, 0xacff, 0xacfe, 0xacfd, // 13904
-    0xacfb, 0xacfa, 0xacf9, 0xacf8, 0xacf7, 0xacf5, 0xacf4, 0xacf3, // 13912
-    0xacf2, 0xacf1, 0xacf0, 0xacee, 0xaced, 0xacec, 0xaceb, 0xacea, // 13920
-    0xace9, 0xace7, 0xace6, 0xace5, 0xace4, 0xace3, 0xace1, 0xace0, // 13928
-    0xacdf, 0xacde, 0xacdd, 0xacdc, 0xacda, 0xacd9, 0xacd8, 0xacd7, // 13936
-    0xacd6, 0xacd4, 0xacd3, 0xacd2, 0xacd1, 0xacd0, 0xaccf, 0xaccd, // 13944
-    0xaccc, 0xaccb, 0xacca, 0xacc9, 0xacc8, 0xacc6, 0xacc5, 0xacc4, // 13952
-    0xacc3, 0xacc2, 0xacc0, 0xacbf, 0xacbe, 0xacbd, 0xacbc, 0xacbb, // 13960
-    0xacb9, 0xacb8, 0xacb7, 0xacb6, 0xacb5, 0xacb4, 0xacb2, 0xacb1, // 13968
-    0xacb0, 0xacaf, 0xacae, 0xacac, 0xacab, 0xacaa, 0xaca9, 0xaca8, // 13976
-    0xaca7, 0xaca5, 0xaca4, 0xaca3, 0xaca2, 0xaca1, 0xac9f, 0xac9e, // 13984
-    0xac9d, 0xac9c, 0xac9b, 0xac9a, 0xac98, 0xac97, 0xac96, 0xac95, // 13992
-    0xac94, 0xac93, 0xac91, 0xac90, 0xac8f, 0xac8e, 0xac8d, 0xac8b, // 14000
-    0xac8a, 0xac89, 0xac88, 0xac87, 0xac86, 0xac84, 0xac83, 0xac82, // 14008
-    0xac81, 0xac80, 0xac7f, 0xac7d, 0xac7c, 0xac7b, 0xac7a, 0xac79, // 14016
-    0xac77, 0xac76, 0xac75, 0xac74, 0xac73, 0xac72, 0xac70, 0xac6f, // 14024
-    0xac6e, 0xac6d, 0xac6c, 0xac6a, 0xac69, 0xac68, 0xac67, 0xac66, // 14032
-    0xac65, 0xac63, 0xac62, 0xac61, 0xac60, 0xac5f, 0xac5e, 0xac5c, // 14040
-    0xac5b, 0xac5a, 0xac59, 0xac58, 0xac56, 0xac55, 0xac54, 0xac53, // 14048
-    0xac52, 0xac51, 0xac4f, 0xac4e, 0xac4d, 0xac4c, 0xac4b, 0xac4a, // 14056
-    0xac48, 0xac47, 0xac46, 0xac45, 0xac44, 0xac42, 0xac41, 0xac40, // 14064
-    0xac3f, 0xac3e, 0xac3d, 0xac3b, 0xac3a, 0xac39, 0xac38, 0xac37, // 14072
-    0xac36, 0xac34, 0xac33, 0xac32, 0xac31, 0xac30, 0xac2e, 0xac2d, // 14080
-    0xac2c, 0xac2b, 0xac2a, 0xac29, 0xac27, 0xac26, 0xac25, 0xac24, // 14088
-    0xac23, 0xac21, 0xac20, 0xac1f, 0xac1e, 0xac1d, 0xac1c, 0xac1a, // 14096
-    0xac19, 0xac18, 0xac17, 0xac16, 0xac15, 0xac13, 0xac12, 0xac11, // 14104
-    0xac10, 0xac0f, 0xac0d, 0xac0c, 0xac0b, 0xac0a, 0xac09, 0xac08, // 14112
-    0xac06, 0xac05, 0xac04, 0xac03, 0xac02, 0xac01, 0xabff, 0xabfe, // 14120
-    0xabfd, 0xabfc, 0xabfb, 0xabf9, 0xabf8, 0xabf7, 0xabf6, 0xabf5, // 14128
-    0xabf4, 0xabf2, 0xabf1, 0xabf0, 0xabef, 0xabee, 0xabec, 0xabeb, // 14136
-    0xabea, 0xabe9, 0xabe8, 0xabe7, 0xabe5, 0xabe4, 0xabe3, 0xabe2, // 14144
-    0xabe1, 0xabe0, 0xabde, 0xabdd, 0xabdc, 0xabdb, 0xabda, 0xabd8, // 14152
-    0xabd7, 0xabd6, 0xabd5, 0xabd4, 0xabd3, 0xabd1, 0xabd0, 0xabcf, // 14160
-    0xabce, 0xabcd, 0xabcc, 0xabca, 0xabc9, 0xabc8, 0xabc7, 0xabc6, // 14168
-    0xabc4, 0xabc3, 0xabc2, 0xabc1, 0xabc0, 0xabbf, 0xabbd, 0xabbc, // 14176
-    0xabbb, 0xabba, 0xabb9, 0xabb7, 0xabb6, 0xabb5, 0xabb4, 0xabb3, // 14184
-    0xabb2, 0xabb0, 0xabaf, 0xabae, 0xabad, 0xabac, 0xabab, 0xaba9, // 14192
-    0xaba8, 0xaba7, 0xaba6, 0xaba5, 0xaba3, 0xaba2, 0xaba1, 0xaba0, // 14200
-    0xab9f, 0xab9e, 0xab9c, 0xab9b, 0xab9a, 0xab99, 0xab98, 0xab97, // 14208
-    0xab95, 0xab94, 0xab93, 0xab92, 0xab91, 0xab8f, 0xab8e, 0xab8d, // 14216
-    0xab8c, 0xab8b, 0xab8a, 0xab88, 0xab87, 0xab86, 0xab85, 0xab84, // 14224
-    0xab82, 0xab81, 0xab80, 0xab7f, 0xab7e, 0xab7d, 0xab7b, 0xab7a, // 14232
-    0xab79, 0xab78, 0xab77, 0xab76, 0xab74, 0xab73, 0xab72, 0xab71, // 14240
-    0xab70, 0xab6e, 0xab6d, 0xab6c, 0xab6b, 0xab6a, 0xab69, 0xab67, // 14248
-    0xab66, 0xab65, 0xab64, 0xab63, 0xab62, 0xab60, 0xab5f, 0xab5e, // 14256
-    0xab5d, 0xab5c, 0xab5a, 0xab59, 0xab58, 0xab57, 0xab56, 0xab55, // 14264
-    0xab53, 0xab52, 0xab51, 0xab50, 0xab4f, 0xab4d, 0xab4c, 0xab4b, // 14272
-    0xab4a, 0xab49, 0xab48, 0xab46, 0xab45, 0xab44, 0xab43, 0xab42, // 14280
-    0xab41, 0xab3f, 0xab3e, 0xab3d, 0xab3c, 0xab3b, 0xab39, 0xab38, // 14288
-    0xab37, 0xab36, 0xab35, 0xab34, 0xab32, 0xab31, 0xab30, 0xab2f, // 14296
-    0xab2e, 0xab2d, 0xab2b, 0xab2a, 0xab29, 0xab28, 0xab27, 0xab25, // 14304
-    0xab24, 0xab23, 0xab22, 0xab21, 0xab20, 0xab1e, 0xab1d, 0xab1c, // 14312
-    0xab1b, 0xab1a, 0xab18, 0xab17, 0xab16, 0xab15, 0xab14, 0xab13, // 14320
-    0xab11, 0xab10, 0xab0f, 0xab0e, 0xab0d, 0xab0c, 0xab0a, 0xab09, // 14328
-    0xab07, 0xab06, 0xab05, 0xab04, 0xab03, 0xab02, 0xab00, 0xaaff, // 14336
-    0xaafe, 0xaafd, 0xaafc, 0xaafb, 0xaafa, 0xaaf8, 0xaaf7, 0xaaf6, // 14344
-    0xaaf5, 0xaaf4, 0xaaf3, 0xaaf2, 0xaaf0, 0xaaef, 0xaaee, 0xaaed, // 14352
-    0xaaec, 0xaaeb, 0xaaea, 0xaae8, 0xaae7, 0xaae6, 0xaae5, 0xaae4, // 14360
-    0xaae3, 0xaae2, 0xaae0, 0xaadf, 0xaade, 0xaadd, 0xaadc, 0xaadb, // 14368
-    0xaada, 0xaad8, 0xaad7, 0xaad6, 0xaad5, 0xaad4, 0xaad3, 0xaad2, // 14376
-    0xaad0, 0xaacf, 0xaace, 0xaacd, 0xaacc, 0xaacb, 0xaaca, 0xaac8, // 14384
-    0xaac7, 0xaac6, 0xaac5, 0xaac4, 0xaac3, 0xaac2, 0xaac0, 0xaabf, // 14392
-    0xaabe, 0xaabd, 0xaabc, 0xaabb, 0xaaba, 0xaab8, 0xaab7, 0xaab6, // 14400
-    0xaab5, 0xaab4, 0xaab3, 0xaab2, 0xaab0, 0xaaaf, 0xaaae, 0xaaad, // 14408
-    0xaaac, 0xaaab, 0xaaaa, 0xaaa8, 0xaaa7, 0xaaa6, 0xaaa5, 0xaaa4, // 14416
-    0xaaa3, 0xaaa2, 0xaaa0, 0xaa9f, 0xaa9e, 0xaa9d, 0xaa9c, 0xaa9b, // 14424
-    0xaa9a, 0xaa98, 0xaa97, 0xaa96, 0xaa95, 0xaa94, 0xaa93, 0xaa92, // 14432
-    0xaa90, 0xaa8f, 0xaa8e, 0xaa8d, 0xaa8c, 0xaa8b, 0xaa8a, 0xaa88, // 14440
-    0xaa87, 0xaa86, 0xaa85, 0xaa84, 0xaa83, 0xaa82, 0xaa80, 0xaa7f, // 14448
-    0xaa7e, 0xaa7d, 0xaa7c, 0xaa7b, 0xaa7a, 0xaa78, 0xaa77, 0xaa76, // 14456
-    0xaa75, 0xaa74, 0xaa73, 0xaa72, 0xaa70, 0xaa6f, 0xaa6e, 0xaa6d, // 14464
-    0xaa6c, 0xaa6b, 0xaa6a, 0xaa68, 0xaa67, 0xaa66, 0xaa65, 0xaa64, // 14472
-    0xaa63, 0xaa62, 0xaa60, 0xaa5f, 0xaa5e, 0xaa5d, 0xaa5c, 0xaa5b, // 14480
-    0xaa5a, 0xaa58, 0xaa57, 0xaa56, 0xaa55, 0xaa54, 0xaa53, 0xaa52, // 14488
-    0xaa50, 0xaa4f, 0xaa4e, 0xaa4d, 0xaa4c, 0xaa4b, 0xaa4a, 0xaa48, // 14496
-    0xaa47, 0xaa46, 0xaa45, 0xaa44, 0xaa43, 0xaa42, 0xaa40, 0xaa3f, // 14504
-    0xaa3e, 0xaa3d, 0xaa3c, 0xaa3b, 0xaa3a, 0xaa38, 0xaa37, 0xaa36, // 14512
-    0xaa35, 0xaa34, 0xaa33, 0xaa32, 0xaa30, 0xaa2f, 0xaa2e, 0xaa2d, // 14520
-    0xaa2c, 0xaa2b, 0xaa2a, 0xaa28, 0xaa27, 0xaa26, 0xaa25, 0xaa24, // 14528
-    0xaa23, 0xaa22, 0xaa20, 0xaa1f, 0xaa1e, 0xaa1d, 0xaa1c, 0xaa1b, // 14536
-    0xaa1a, 0xaa18, 0xaa17, 0xaa16, 0xaa15, 0xaa14, 0xaa13, 0xaa12, // 14544
-    0xaa10, 0xaa0f, 0xaa0e, 0xaa0d, 0xaa0c, 0xaa0b, 0xaa0a, 0xaa08, // 14552
-    0xaa07, 0xaa06, 0xaa05, 0xaa04, 0xaa03, 0xaa02, 0xaa00, 0xa9ff, // 14560
-    0xa9fe, 0xa9fd, 0xa9fc, 0xa9fb, 0xa9fa, 0xa9f8, 0xa9f7, 0xa9f6, // 14568
-    0xa9f5, 0xa9f4, 0xa9f3, 0xa9f2, 0xa9f0, 0xa9ef, 0xa9ee, 0xa9ed, // 14576
-    0xa9ec, 0xa9eb, 0xa9ea, 0xa9e8, 0xa9e7, 0xa9e6, 0xa9e5, 0xa9e4, // 14584
-    0xa9e3, 0xa9e2, 0xa9e0, 0xa9df, 0xa9de, 0xa9dd, 0xa9dc, 0xa9db, // 14592
-    0xa9da, 0xa9d8, 0xa9d7, 0xa9d6, 0xa9d5, 0xa9d4, 0xa9d3, 0xa9d2, // 14600
-    0xa9d0, 0xa9cf, 0xa9ce, 0xa9cd, 0xa9cc, 0xa9cb, 0xa9ca, 0xa9c8, // 14608
-    0xa9c7, 0xa9c6, 0xa9c5, 0xa9c4, 0xa9c3, 0xa9c2, 0xa9c0, 0xa9bf, // 14616
-    0xa9be, 0xa9bd, 0xa9bc, 0xa9bb, 0xa9ba, 0xa9b8, 0xa9b7, 0xa9b6, // 14624
-    0xa9b5, 0xa9b4, 0xa9b3, 0xa9b2, 0xa9b0, 0xa9af, 0xa9ae, 0xa9ad, // 14632
-    0xa9ac, 0xa9ab, 0xa9aa, 0xa9a8, 0xa9a7, 0xa9a6, 0xa9a5, 0xa9a4, // 14640
-    0xa9a3, 0xa9a2, 0xa9a0, 0xa99f, 0xa99e, 0xa99d, 0xa99c, 0xa99b, // 14648
-    0xa99a, 0xa998, 0xa997, 0xa996, 0xa995, 0xa994, 0xa993, 0xa992, // 14656
-    0xa990, 0xa98f, 0xa98e, 0xa98d, 0xa98c, 0xa98b, 0xa98a, 0xa988, // 14664
-    0xa987, 0xa986, 0xa985, 0xa984, 0xa983, 0xa982, 0xa980, 0xa97f, // 14672
-    0xa97e, 0xa97d, 0xa97c, 0xa97b, 0xa97a, 0xa978, 0xa977, 0xa976, // 14680
-    0xa975, 0xa974, 0xa973, 0xa972, 0xa970, 0xa96f, 0xa96e, 0xa96d, // 14688
-    0xa96c, 0xa96b, 0xa96a, 0xa968, 0xa967, 0xa966, 0xa965, 0xa964, // 14696
-    0xa963, 0xa962, 0xa960, 0xa95f, 0xa95e, 0xa95d, 0xa95c, 0xa95b, // 14704
-    0xa95a, 0xa958, 0xa957, 0xa956, 0xa955, 0xa954, 0xa953, 0xa952, // 14712
-    0xa951, 0xa94f, 0xa94e, 0xa94d, 0xa94c, 0xa94b, 0xa94a, 0xa949, // 14720
-    0xa947, 0xa946, 0xa945, 0xa944, 0xa943, 0xa942, 0xa941, 0xa93f, // 14728
-    0xa93e, 0xa93d, 0xa93c, 0xa93b, 0xa93a, 0xa939, 0xa937, 0xa936, // 14736
-    0xa935, 0xa934, 0xa933, 0xa932, 0xa931, 0xa92f, 0xa92e, 0xa92d, // 14744
-    0xa92c, 0xa92b, 0xa92a, 0xa929, 0xa927, 0xa926, 0xa925, 0xa924, // 14752
-    0xa923, 0xa922, 0xa921, 0xa91f, 0xa91e, 0xa91d, 0xa91c, 0xa91b, // 14760
-    0xa91a, 0xa919, 0xa917, 0xa916, 0xa915, 0xa914, 0xa913, 0xa912, // 14768
-    0xa911, 0xa90f, 0xa90e, 0xa90d, 0xa90c, 0xa90b, 0xa90a, 0xa909, // 14776
-    0xa907, 0xa906, 0xa905, 0xa904, 0xa903, 0xa902, 0xa901, 0xa8ff, // 14784
-    0xa8fe, 0xa8fd, 0xa8fc, 0xa8fb, 0xa8fa, 0xa8f9, 0xa8f7, 0xa8f6, // 14792
-    0xa8f5, 0xa8f4, 0xa8f3, 0xa8f2, 0xa8f1, 0xa8ef, 0xa8ee, 0xa8ed, // 14800
-    0xa8ec, 0xa8eb, 0xa8ea, 0xa8e9, 0xa8e7, 0xa8e6, 0xa8e5, 0xa8e4, // 14808
-    0xa8e3, 0xa8e2, 0xa8e1, 0xa8df, 0xa8de, 0xa8dd, 0xa8dc, 0xa8db, // 14816
-    0xa8da, 0xa8d9, 0xa8d7, 0xa8d6, 0xa8d5, 0xa8d4, 0xa8d3, 0xa8d2, // 14824
-    0xa8d1, 0xa8cf, 0xa8ce, 0xa8cd, 0xa8cc, 0xa8cb, 0xa8ca, 0xa8c9, // 14832
-    0xa8c7, 0xa8c6, 0xa8c5, 0xa8c4, 0xa8c3, 0xa8c2, 0xa8c1, 0xa8bf, // 14840
-    0xa8be, 0xa8bd, 0xa8bc, 0xa8bb, 0xa8ba, 0xa8b9, 0xa8b7, 0xa8b6, // 14848
-    0xa8b5, 0xa8b4, 0xa8b3, 0xa8b2, 0xa8b1, 0xa8af, 0xa8ae, 0xa8ad, // 14856
-    0xa8ac, 0xa8ab, 0xa8aa, 0xa8a9, 0xa8a7, 0xa8a6, 0xa8a5, 0xa8a4, // 14864
-    0xa8a3, 0xa8a2, 0xa8a1, 0xa89f, 0xa89e, 0xa89d, 0xa89c, 0xa89b, // 14872
-    0xa89a, 0xa899, 0xa897, 0xa896, 0xa895, 0xa894, 0xa893, 0xa892, // 14880
-    0xa891, 0xa88f, 0xa88e, 0xa88d, 0xa88c, 0xa88b, 0xa88a, 0xa889, // 14888
-    0xa887, 0xa886, 0xa885, 0xa884, 0xa883, 0xa882, 0xa881, 0xa87f, // 14896
-    0xa87e, 0xa87d, 0xa87c, 0xa87b, 0xa87a, 0xa879, 0xa877, 0xa876, // 14904
-    0xa875, 0xa874, 0xa873, 0xa872, 0xa871, 0xa86f, 0xa86e, 0xa86d, // 14912
-    0xa86c, 0xa86b, 0xa86a, 0xa869, 0xa867, 0xa866, 0xa865, 0xa864, // 14920
-    0xa863, 0xa862, 0xa861, 0xa85f, 0xa85e, 0xa85d, 0xa85c, 0xa85b, // 14928
-    0xa85a, 0xa859, 0xa857, 0xa856, 0xa855, 0xa854, 0xa853, 0xa852, // 14936
-    0xa851, 0xa84f, 0xa84e, 0xa84d, 0xa84c, 0xa84b, 0xa84a, 0xa849, // 14944
-    0xa847, 0xa846, 0xa845, 0xa844, 0xa843, 0xa842, 0xa841, 0xa83f, // 14952
-    0xa83e, 0xa83d, 0xa83c, 0xa83b, 0xa83a, 0xa839, 0xa837, 0xa836, // 14960
-    0xa835, 0xa834, 0xa833, 0xa832, 0xa831, 0xa82f, 0xa82e, 0xa82d, // 14968
-    0xa82c, 0xa82b, 0xa82a, 0xa829, 0xa827, 0xa826, 0xa825, 0xa824, // 14976
-    0xa823, 0xa822, 0xa821, 0xa81f, 0xa81e, 0xa81d, 0xa81c, 0xa81b, // 14984
-    0xa81a, 0xa819, 0xa817, 0xa816, 0xa815, 0xa814, 0xa813, 0xa812, // 14992
-    0xa811, 0xa80f, 0xa80e, 0xa80d, 0xa80c, 0xa80b, 0xa80a, 0xa809, // 15000
-    0xa807, 0xa806, 0xa805, 0xa804, 0xa803, 0xa802, 0xa801, 0xa7ff, // 15008
-    0xa7fe, 0xa7fd, 0xa7fc, 0xa7fb, 0xa7fa, 0xa7f9, 0xa7f7, 0xa7f6, // 15016
-    0xa7f5, 0xa7f4, 0xa7f3, 0xa7f2, 0xa7f1, 0xa7ef, 0xa7ee, 0xa7ed, // 15024
-    0xa7ec, 0xa7eb, 0xa7ea, 0xa7e9, 0xa7e7, 0xa7e6, 0xa7e5, 0xa7e4, // 15032
-    0xa7e3, 0xa7e2, 0xa7e1, 0xa7df, 0xa7de, 0xa7dd, 0xa7dc, 0xa7db, // 15040
-    0xa7da, 0xa7d9, 0xa7d7, 0xa7d6, 0xa7d5, 0xa7d4, 0xa7d3, 0xa7d2, // 15048
-    0xa7d1, 0xa7cf, 0xa7ce, 0xa7cd, 0xa7cc, 0xa7cb, 0xa7ca, 0xa7c9, // 15056
-    0xa7c7, 0xa7c6, 0xa7c5, 0xa7c4, 0xa7c3, 0xa7c2, 0xa7c1, 0xa7bf, // 15064
-    0xa7be, 0xa7bd, 0xa7bc, 0xa7bb, 0xa7ba, 0xa7b9, 0xa7b7, 0xa7b6, // 15072
-    0xa7b5, 0xa7b4, 0xa7b3, 0xa7b2, 0xa7b1, 0xa7af, 0xa7ae, 0xa7ad, // 15080
-    0xa7ac, 0xa7ab, 0xa7aa, 0xa7a9, 0xa7a7, 0xa7a6, 0xa7a5, 0xa7a4, // 15088
-    0xa7a3, 0xa7a2, 0xa7a1, 0xa79f, 0xa79e, 0xa79d, 0xa79c, 0xa79b, // 15096
-    0xa79a, 0xa799, 0xa797, 0xa796, 0xa795, 0xa794, 0xa793, 0xa792, // 15104
-    0xa791, 0xa78f, 0xa78e, 0xa78d, 0xa78c, 0xa78b, 0xa78a, 0xa789, // 15112
-    0xa787, 0xa786, 0xa785, 0xa784, 0xa783, 0xa782, 0xa781, 0xa77f, // 15120
-    0xa77e, 0xa77d, 0xa77c, 0xa77b, 0xa77a, 0xa779, 0xa777, 0xa776, // 15128
-    0xa775, 0xa774, 0xa773, 0xa772, 0xa771, 0xa76f, 0xa76e, 0xa76d, // 15136
-    0xa76c, 0xa76b, 0xa76a, 0xa769, 0xa767, 0xa766, 0xa765, 0xa764, // 15144
-    0xa763, 0xa762, 0xa761, 0xa75f, 0xa75e, 0xa75d, 0xa75c, 0xa75b, // 15152
-    0xa75a, 0xa759, 0xa757, 0xa756, 0xa755, 0xa754, 0xa753, 0xa752, // 15160
-    0xa751, 0xa74f, 0xa74e, 0xa74d, 0xa74c, 0xa74b, 0xa74a, 0xa749, // 15168
-    0xa747, 0xa746, 0xa745, 0xa744, 0xa743, 0xa742, 0xa741, 0xa73f, // 15176
-    0xa73e, 0xa73d, 0xa73c, 0xa73b, 0xa73a, 0xa739, 0xa737, 0xa736, // 15184
-    0xa735, 0xa734, 0xa733, 0xa732, 0xa731, 0xa72f, 0xa72e, 0xa72d, // 15192
-    0xa72c, 0xa72b, 0xa72a, 0xa729, 0xa727, 0xa726, 0xa725, 0xa724, // 15200
-    0xa723, 0xa722, 0xa721, 0xa71f, 0xa71e, 0xa71d, 0xa71c, 0xa71b, // 15208
-    0xa71a, 0xa719, 0xa717, 0xa716, 0xa715, 0xa714, 0xa713, 0xa712, // 15216
-    0xa711, 0xa70f, 0xa70e, 0xa70d, 0xa70c, 0xa70b, 0xa70a, 0xa709, // 15224
-    0xa708, 0xa706, 0xa705, 0xa704, 0xa703, 0xa702, 0xa701, 0xa700, // 15232
-    0xa6fe, 0xa6fd, 0xa6fc, 0xa6fb, 0xa6fa, 0xa6f9, 0xa6f8, 0xa6f6, // 15240
-    0xa6f5, 0xa6f4, 0xa6f3, 0xa6f2, 0xa6f1, 0xa6f0, 0xa6ee, 0xa6ed, // 15248
-    0xa6ec, 0xa6eb, 0xa6ea, 0xa6e9, 0xa6e8, 0xa6e6, 0xa6e5, 0xa6e4, // 15256
-    0xa6e3, 0xa6e2, 0xa6e1, 0xa6e0, 0xa6de, 0xa6dd, 0xa6dc, 0xa6db, // 15264
-    0xa6da, 0xa6d9, 0xa6d8, 0xa6d6, 0xa6d5, 0xa6d4, 0xa6d3, 0xa6d2, // 15272
-    0xa6d1, 0xa6d0, 0xa6ce, 0xa6cd, 0xa6cc, 0xa6cb, 0xa6ca, 0xa6c9, // 15280
-    0xa6c8, 0xa6c6, 0xa6c5, 0xa6c4, 0xa6c3, 0xa6c2, 0xa6c1, 0xa6c0, // 15288
-    0xa6be, 0xa6bd, 0xa6bc, 0xa6bb, 0xa6ba, 0xa6b9, 0xa6b8, 0xa6b6, // 15296
-    0xa6b5, 0xa6b4, 0xa6b3, 0xa6b2, 0xa6b1, 0xa6b0, 0xa6ae, 0xa6ad, // 15304
-    0xa6ac, 0xa6ab, 0xa6aa, 0xa6a9, 0xa6a8, 0xa6a6, 0xa6a5, 0xa6a4, // 15312
-    0xa6a3, 0xa6a2, 0xa6a1, 0xa6a0, 0xa69e, 0xa69d, 0xa69c, 0xa69b, // 15320
-    0xa69a, 0xa699, 0xa698, 0xa696, 0xa695, 0xa694, 0xa693, 0xa692, // 15328
-    0xa691, 0xa690, 0xa68e, 0xa68d, 0xa68c, 0xa68b, 0xa68a, 0xa689, // 15336
-    0xa688, 0xa686, 0xa685, 0xa684, 0xa683, 0xa682, 0xa681, 0xa680, // 15344
-    0xa67e, 0xa67d, 0xa67c, 0xa67b, 0xa67a, 0xa679, 0xa678, 0xa676, // 15352
-    0xa676, 0xa675, 0xa674, 0xa673, 0xa672, 0xa671, 0xa670, 0xa66e, // 15360
-    0xa66d, 0xa66c, 0xa66b, 0xa66a, 0xa669, 0xa668, 0xa667, 0xa666, // 15368
-    0xa665, 0xa663, 0xa662, 0xa661, 0xa660, 0xa65f, 0xa65e, 0xa65d, // 15376
-    0xa65c, 0xa65b, 0xa659, 0xa658, 0xa657, 0xa656, 0xa655, 0xa654, // 15384
-    0xa653, 0xa652, 0xa651, 0xa64f, 0xa64e, 0xa64d, 0xa64c, 0xa64b, // 15392
-    0xa64a, 0xa649, 0xa648, 0xa647, 0xa646, 0xa644, 0xa643, 0xa642, // 15400
-    0xa641, 0xa640, 0xa63f, 0xa63e, 0xa63d, 0xa63c, 0xa63a, 0xa639, // 15408
-    0xa638, 0xa637, 0xa636, 0xa635, 0xa634, 0xa633, 0xa632, 0xa630, // 15416
-    0xa62f, 0xa62e, 0xa62d, 0xa62c, 0xa62b, 0xa62a, 0xa629, 0xa628, // 15424
-    0xa627, 0xa625, 0xa624, 0xa623, 0xa622, 0xa621, 0xa620, 0xa61f, // 15432
-    0xa61e, 0xa61d, 0xa61b, 0xa61a, 0xa619, 0xa618, 0xa617, 0xa616, // 15440
-    0xa615, 0xa614, 0xa613, 0xa611, 0xa610, 0xa60f, 0xa60e, 0xa60d, // 15448
-    0xa60c, 0xa60b, 0xa60a, 0xa609, 0xa608, 0xa606, 0xa605, 0xa604, // 15456
-    0xa603, 0xa602, 0xa601, 0xa600, 0xa5ff, 0xa5fe, 0xa5fc, 0xa5fb, // 15464
-    0xa5fa, 0xa5f9, 0xa5f8, 0xa5f7, 0xa5f6, 0xa5f5, 0xa5f4, 0xa5f2, // 15472
-    0xa5f1, 0xa5f0, 0xa5ef, 0xa5ee, 0xa5ed, 0xa5ec, 0xa5eb, 0xa5ea, // 15480
-    0xa5e9, 0xa5e7, 0xa5e6, 0xa5e5, 0xa5e4, 0xa5e3, 0xa5e2, 0xa5e1, // 15488
-    0xa5e0, 0xa5df, 0xa5dd, 0xa5dc, 0xa5db, 0xa5da, 0xa5d9, 0xa5d8, // 15496
-    0xa5d7, 0xa5d6, 0xa5d5, 0xa5d3, 0xa5d2, 0xa5d1, 0xa5d0, 0xa5cf, // 15504
-    0xa5ce, 0xa5cd, 0xa5cc, 0xa5cb, 0xa5c9, 0xa5c8, 0xa5c7, 0xa5c6, // 15512
-    0xa5c5, 0xa5c4, 0xa5c3, 0xa5c2, 0xa5c1, 0xa5c0, 0xa5be, 0xa5bd, // 15520
-    0xa5bc, 0xa5bb, 0xa5ba, 0xa5b9, 0xa5b8, 0xa5b7, 0xa5b6, 0xa5b4, // 15528
-    0xa5b3, 0xa5b2, 0xa5b1, 0xa5b0, 0xa5af, 0xa5ae, 0xa5ad, 0xa5ac, // 15536
-    0xa5aa, 0xa5a9, 0xa5a8, 0xa5a7, 0xa5a6, 0xa5a5, 0xa5a4, 0xa5a3, // 15544
-    0xa5a2, 0xa5a1, 0xa59f, 0xa59e, 0xa59d, 0xa59c, 0xa59b, 0xa59a, // 15552
-    0xa599, 0xa598, 0xa597, 0xa595, 0xa594, 0xa593, 0xa592, 0xa591, // 15560
-    0xa590, 0xa58f, 0xa58e, 0xa58d, 0xa58b, 0xa58a, 0xa589, 0xa588, // 15568
-    0xa587, 0xa586, 0xa585, 0xa584, 0xa583, 0xa582, 0xa580, 0xa57f, // 15576
-    0xa57e, 0xa57d, 0xa57c, 0xa57b, 0xa57a, 0xa579, 0xa578, 0xa576, // 15584
-    0xa575, 0xa574, 0xa573, 0xa572, 0xa571, 0xa570, 0xa56f, 0xa56e, // 15592
-    0xa56c, 0xa56b, 0xa56a, 0xa569, 0xa568, 0xa567, 0xa566, 0xa565, // 15600
-    0xa564, 0xa563, 0xa561, 0xa560, 0xa55f, 0xa55e, 0xa55d, 0xa55c, // 15608
-    0xa55b, 0xa55a, 0xa559, 0xa557, 0xa556, 0xa555, 0xa554, 0xa553, // 15616
-    0xa552, 0xa551, 0xa550, 0xa54f, 0xa54d, 0xa54c, 0xa54b, 0xa54a, // 15624
-    0xa549, 0xa548, 0xa547, 0xa546, 0xa545, 0xa543, 0xa542, 0xa541, // 15632
-    0xa540, 0xa53f, 0xa53e, 0xa53d, 0xa53c, 0xa53b, 0xa53a, 0xa538, // 15640
-    0xa537, 0xa536, 0xa535, 0xa534, 0xa533, 0xa532, 0xa531, 0xa530, // 15648
-    0xa52e, 0xa52d, 0xa52c, 0xa52b, 0xa52a, 0xa529, 0xa528, 0xa527, // 15656
-    0xa526, 0xa524, 0xa523, 0xa522, 0xa521, 0xa520, 0xa51f, 0xa51e, // 15664
-    0xa51d, 0xa51c, 0xa51b, 0xa519, 0xa518, 0xa517, 0xa516, 0xa515, // 15672
-    0xa514, 0xa513, 0xa512, 0xa511, 0xa50f, 0xa50e, 0xa50d, 0xa50c, // 15680
-    0xa50b, 0xa50a, 0xa509, 0xa508, 0xa507, 0xa505, 0xa504, 0xa503, // 15688
-    0xa502, 0xa501, 0xa500, 0xa4ff, 0xa4fe, 0xa4fd, 0xa4fc, 0xa4fa, // 15696
-    0xa4f9, 0xa4f8, 0xa4f7, 0xa4f6, 0xa4f5, 0xa4f4, 0xa4f3, 0xa4f2, // 15704
-    0xa4f0, 0xa4ef, 0xa4ee, 0xa4ed, 0xa4ec, 0xa4eb, 0xa4ea, 0xa4e9, // 15712
-    0xa4e8, 0xa4e6, 0xa4e5, 0xa4e4, 0xa4e3, 0xa4e2, 0xa4e1, 0xa4e0, // 15720
-    0xa4df, 0xa4de, 0xa4dd, 0xa4db, 0xa4da, 0xa4d9, 0xa4d8, 0xa4d7, // 15728
-    0xa4d6, 0xa4d5, 0xa4d4, 0xa4d3, 0xa4d1, 0xa4d0, 0xa4cf, 0xa4ce, // 15736
-    0xa4cd, 0xa4cc, 0xa4cb, 0xa4ca, 0xa4c9, 0xa4c7, 0xa4c6, 0xa4c5, // 15744
-    0xa4c4, 0xa4c3, 0xa4c2, 0xa4c1, 0xa4c0, 0xa4bf, 0xa4bd, 0xa4bc, // 15752
-    0xa4bb, 0xa4ba, 0xa4b9, 0xa4b8, 0xa4b7, 0xa4b6, 0xa4b5, 0xa4b4, // 15760
-    0xa4b2, 0xa4b1, 0xa4b0, 0xa4af, 0xa4ae, 0xa4ad, 0xa4ac, 0xa4ab, // 15768
-    0xa4aa, 0xa4a8, 0xa4a7, 0xa4a6, 0xa4a5, 0xa4a4, 0xa4a3, 0xa4a2, // 15776
-    0xa4a1, 0xa4a0, 0xa49e, 0xa49d, 0xa49c, 0xa49b, 0xa49a, 0xa499, // 15784
-    0xa498, 0xa497, 0xa496, 0xa495, 0xa493, 0xa492, 0xa491, 0xa490, // 15792
-    0xa48f, 0xa48e, 0xa48d, 0xa48c, 0xa48b, 0xa489, 0xa488, 0xa487, // 15800
-    0xa486, 0xa485, 0xa484, 0xa483, 0xa482, 0xa481, 0xa47f, 0xa47e, // 15808
-    0xa47d, 0xa47c, 0xa47b, 0xa47a, 0xa479, 0xa478, 0xa477, 0xa476, // 15816
-    0xa474, 0xa473, 0xa472, 0xa471, 0xa470, 0xa46f, 0xa46e, 0xa46d, // 15824
-    0xa46c, 0xa46a, 0xa469, 0xa468, 0xa467, 0xa466, 0xa465, 0xa464, // 15832
-    0xa463, 0xa462, 0xa460, 0xa45f, 0xa45e, 0xa45d, 0xa45c, 0xa45b, // 15840
-    0xa45a, 0xa459, 0xa458, 0xa457, 0xa455, 0xa454, 0xa453, 0xa452, // 15848
-    0xa451, 0xa450, 0xa44f, 0xa44e, 0xa44d, 0xa44b, 0xa44a, 0xa449, // 15856
-    0xa448, 0xa447, 0xa446, 0xa445, 0xa444, 0xa443, 0xa441, 0xa440, // 15864
-    0xa43f, 0xa43e, 0xa43d, 0xa43c, 0xa43b, 0xa43a, 0xa439, 0xa437, // 15872
-    0xa436, 0xa435, 0xa434, 0xa433, 0xa432, 0xa431, 0xa430, 0xa42f, // 15880
-    0xa42e, 0xa42c, 0xa42b, 0xa42a, 0xa429, 0xa428, 0xa427, 0xa426, // 15888
-    0xa425, 0xa424, 0xa422, 0xa421, 0xa420, 0xa41f, 0xa41e, 0xa41d, // 15896
-    0xa41c, 0xa41b, 0xa41a, 0xa418, 0xa417, 0xa416, 0xa415, 0xa414, // 15904
-    0xa413, 0xa412, 0xa411, 0xa410, 0xa40f, 0xa40d, 0xa40c, 0xa40b, // 15912
-    0xa40a, 0xa409, 0xa408, 0xa407, 0xa406, 0xa405, 0xa403, 0xa402, // 15920
-    0xa401, 0xa400, 0xa3ff, 0xa3fe, 0xa3fd, 0xa3fc, 0xa3fb, 0xa3f9, // 15928
-    0xa3f8, 0xa3f7, 0xa3f6, 0xa3f5, 0xa3f4, 0xa3f3, 0xa3f2, 0xa3f1, // 15936
-    0xa3f0, 0xa3ee, 0xa3ed, 0xa3ec, 0xa3eb, 0xa3ea, 0xa3e9, 0xa3e8, // 15944
-    0xa3e7, 0xa3e6, 0xa3e4, 0xa3e3, 0xa3e2, 0xa3e1, 0xa3e0, 0xa3df, // 15952
-    0xa3de, 0xa3dd, 0xa3dc, 0xa3da, 0xa3d9, 0xa3d8, 0xa3d7, 0xa3d6, // 15960
-    0xa3d5, 0xa3d4, 0xa3d3, 0xa3d2, 0xa3d1, 0xa3cf, 0xa3ce, 0xa3cd, // 15968
-    0xa3cc, 0xa3cb, 0xa3ca, 0xa3c9, 0xa3c8, 0xa3c7, 0xa3c5, 0xa3c4, // 15976
-    0xa3c3, 0xa3c2, 0xa3c1, 0xa3c0, 0xa3bf, 0xa3be, 0xa3bd, 0xa3bb, // 15984
-    0xa3ba, 0xa3b9, 0xa3b8, 0xa3b7, 0xa3b6, 0xa3b5, 0xa3b4, 0xa3b3, // 15992
-    0xa3b2, 0xa3b0, 0xa3af, 0xa3ae, 0xa3ad, 0xa3ac, 0xa3ab, 0xa3aa, // 16000
-    0xa3a9, 0xa3a8, 0xa3a6, 0xa3a5, 0xa3a4, 0xa3a3, 0xa3a2, 0xa3a1, // 16008
-    0xa3a0, 0xa39f, 0xa39e, 0xa39c, 0xa39b, 0xa39a, 0xa399, 0xa398, // 16016
-    0xa397, 0xa396, 0xa395, 0xa394, 0xa392, 0xa391, 0xa390, 0xa38f, // 16024
-    0xa38e, 0xa38d, 0xa38c, 0xa38b, 0xa38a, 0xa389, 0xa387, 0xa386, // 16032
-    0xa385, 0xa384, 0xa383, 0xa382, 0xa381, 0xa380, 0xa37f, 0xa37d, // 16040
-    0xa37c, 0xa37b, 0xa37a, 0xa379, 0xa378, 0xa377, 0xa376, 0xa375, // 16048
-    0xa373, 0xa372, 0xa371, 0xa370, 0xa36f, 0xa36e, 0xa36d, 0xa36c, // 16056
-    0xa36b, 0xa36a, 0xa368, 0xa367, 0xa366, 0xa365, 0xa364, 0xa363, // 16064
-    0xa362, 0xa361, 0xa360, 0xa35e, 0xa35d, 0xa35c, 0xa35b, 0xa35a, // 16072
-    0xa359, 0xa358, 0xa357, 0xa356, 0xa354, 0xa353, 0xa352, 0xa351, // 16080
-    0xa350, 0xa34f, 0xa34e, 0xa34d, 0xa34c, 0xa34b, 0xa349, 0xa348, // 16088
-    0xa347, 0xa346, 0xa345, 0xa344, 0xa343, 0xa342, 0xa341, 0xa33f, // 16096
-    0xa33e, 0xa33d, 0xa33c, 0xa33b, 0xa33a, 0xa339, 0xa338, 0xa337, // 16104
-    0xa335, 0xa334, 0xa333, 0xa332, 0xa331, 0xa330, 0xa32f, 0xa32e, // 16112
-    0xa32d, 0xa32c, 0xa32a, 0xa329, 0xa328, 0xa327, 0xa326, 0xa325, // 16120
-    0xa324, 0xa323, 0xa322, 0xa320, 0xa31f, 0xa31e, 0xa31d, 0xa31c, // 16128
-    0xa31b, 0xa31a, 0xa319, 0xa318, 0xa316, 0xa315, 0xa314, 0xa313, // 16136
-    0xa312, 0xa311, 0xa310, 0xa30f, 0xa30e, 0xa30c, 0xa30b, 0xa30a, // 16144
-    0xa309, 0xa308, 0xa307, 0xa306, 0xa305, 0xa304, 0xa303, 0xa301, // 16152
-    0xa300, 0xa2ff, 0xa2fe, 0xa2fd, 0xa2fc, 0xa2fb, 0xa2fa, 0xa2f9, // 16160
-    0xa2f7, 0xa2f6, 0xa2f5, 0xa2f4, 0xa2f3, 0xa2f2, 0xa2f1, 0xa2f0, // 16168
-    0xa2ef, 0xa2ed, 0xa2ec, 0xa2eb, 0xa2ea, 0xa2e9, 0xa2e8, 0xa2e7, // 16176
-    0xa2e6, 0xa2e5, 0xa2e4, 0xa2e2, 0xa2e1, 0xa2e0, 0xa2df, 0xa2de, // 16184
-    0xa2dd, 0xa2dc, 0xa2db, 0xa2da, 0xa2d8, 0xa2d7, 0xa2d6, 0xa2d5, // 16192
-    0xa2d4, 0xa2d3, 0xa2d2, 0xa2d1, 0xa2d0, 0xa2ce, 0xa2cd, 0xa2cc, // 16200
-    0xa2cb, 0xa2ca, 0xa2c9, 0xa2c8, 0xa2c7, 0xa2c6, 0xa2c5, 0xa2c3, // 16208
-    0xa2c2, 0xa2c1, 0xa2c0, 0xa2bf, 0xa2be, 0xa2bd, 0xa2bc, 0xa2bb, // 16216
-    0xa2b9, 0xa2b8, 0xa2b7, 0xa2b6, 0xa2b5, 0xa2b4, 0xa2b3, 0xa2b2, // 16224
-    0xa2b1, 0xa2af, 0xa2ae, 0xa2ad, 0xa2ac, 0xa2ab, 0xa2aa, 0xa2a9, // 16232
-    0xa2a8, 0xa2a7, 0xa2a6, 0xa2a4, 0xa2a3, 0xa2a2, 0xa2a1, 0xa2a0, // 16240
-    0xa29f, 0xa29e, 0xa29d, 0xa29c, 0xa29a, 0xa299, 0xa298, 0xa297, // 16248
-    0xa296, 0xa295, 0xa294, 0xa293, 0xa292, 0xa290, 0xa28f, 0xa28e, // 16256
-    0xa28d, 0xa28c, 0xa28b, 0xa28a, 0xa289, 0xa288, 0xa286, 0xa285, // 16264
-    0xa284, 0xa283, 0xa282, 0xa281, 0xa280, 0xa27f, 0xa27e, 0xa27d, // 16272
-    0xa27b, 0xa27a, 0xa279, 0xa278, 0xa277, 0xa276, 0xa275, 0xa274, // 16280
-    0xa273, 0xa271, 0xa270, 0xa26f, 0xa26e, 0xa26d, 0xa26c, 0xa26b, // 16288
-    0xa26a, 0xa269, 0xa267, 0xa266, 0xa265, 0xa264, 0xa263, 0xa262, // 16296
-    0xa261, 0xa260, 0xa25f, 0xa25e, 0xa25c, 0xa25b, 0xa25a, 0xa259, // 16304
-    0xa258, 0xa257, 0xa256, 0xa255, 0xa254, 0xa252, 0xa251, 0xa250, // 16312
-    0xa24f, 0xa24e, 0xa24d, 0xa24c, 0xa24b, 0xa24a, 0xa248, 0xa247, // 16320
-    0xa246, 0xa245, 0xa244, 0xa243, 0xa242, 0xa241, 0xa240, 0xa23f, // 16328
-    0xa23d, 0xa23c, 0xa23b, 0xa23a, 0xa239, 0xa238, 0xa237, 0xa236, // 16336
-    0xa235, 0xa233, 0xa232, 0xa231, 0xa230, 0xa22f, 0xa22e, 0xa22d, // 16344
-    0xa22c, 0xa22b, 0xa229, 0xa228, 0xa227, 0xa226, 0xa225, 0xa224, // 16352
-    0xa223, 0xa222, 0xa221, 0xa220, 0xa21e, 0xa21d, 0xa21c, 0xa21b, // 16360
-    0xa21a, 0xa219, 0xa218, 0xa217, 0xa216, 0xa214, 0xa213, 0xa212, // 16368
-    0xa211, 0xa210, 0xa20f, 0xa20e, 0xa20d, 0xa20c, 0xa20a, 0xa209, // 16376
-    0xa209, 0xa208, 0xa207, 0xa206, 0xa205, 0xa204, 0xa203, 0xa202, // 16384
-    0xa201, 0xa200, 0xa1ff, 0xa1fd, 0xa1fc, 0xa1fb, 0xa1fa, 0xa1f9, // 16392
-    0xa1f8, 0xa1f7, 0xa1f6, 0xa1f5, 0xa1f4, 0xa1f3, 0xa1f2, 0xa1f1, // 16400
-    0xa1f0, 0xa1ee, 0xa1ed, 0xa1ec, 0xa1eb, 0xa1ea, 0xa1e9, 0xa1e8, // 16408
-    0xa1e7, 0xa1e6, 0xa1e5, 0xa1e4, 0xa1e3, 0xa1e2, 0xa1e1, 0xa1df, // 16416
-    0xa1de, 0xa1dd, 0xa1dc, 0xa1db, 0xa1da, 0xa1d9, 0xa1d8, 0xa1d7, // 16424
-    0xa1d6, 0xa1d5, 0xa1d4, 0xa1d3, 0xa1d1, 0xa1d0, 0xa1cf, 0xa1ce, // 16432
-    0xa1cd, 0xa1cc, 0xa1cb, 0xa1ca, 0xa1c9, 0xa1c8, 0xa1c7, 0xa1c6, // 16440
-    0xa1c5, 0xa1c4, 0xa1c2, 0xa1c1, 0xa1c0, 0xa1bf, 0xa1be, 0xa1bd, // 16448
-    0xa1bc, 0xa1bb, 0xa1ba, 0xa1b9, 0xa1b8, 0xa1b7, 0xa1b6, 0xa1b5, // 16456
-    0xa1b3, 0xa1b2, 0xa1b1, 0xa1b0, 0xa1af, 0xa1ae, 0xa1ad, 0xa1ac, // 16464
-    0xa1ab, 0xa1aa, 0xa1a9, 0xa1a8, 0xa1a7, 0xa1a6, 0xa1a4, 0xa1a3, // 16472
-    0xa1a2, 0xa1a1, 0xa1a0, 0xa19f, 0xa19e, 0xa19d, 0xa19c, 0xa19b, // 16480
-    0xa19a, 0xa199, 0xa198, 0xa197, 0xa195, 0xa194, 0xa193, 0xa192, // 16488
-    0xa191, 0xa190, 0xa18f, 0xa18e, 0xa18d, 0xa18c, 0xa18b, 0xa18a, // 16496
-    0xa189, 0xa188, 0xa186, 0xa185, 0xa184, 0xa183, 0xa182, 0xa181, // 16504
-    0xa180, 0xa17f, 0xa17e, 0xa17d, 0xa17c, 0xa17b, 0xa17a, 0xa178, // 16512
-    0xa177, 0xa176, 0xa175, 0xa174, 0xa173, 0xa172, 0xa171, 0xa170, // 16520
-    0xa16f, 0xa16e, 0xa16d, 0xa16c, 0xa16b, 0xa169, 0xa168, 0xa167, // 16528
-    0xa166, 0xa165, 0xa164, 0xa163, 0xa162, 0xa161, 0xa160, 0xa15f, // 16536
-    0xa15e, 0xa15d, 0xa15c, 0xa15a, 0xa159, 0xa158, 0xa157, 0xa156, // 16544
-    0xa155, 0xa154, 0xa153, 0xa152, 0xa151, 0xa150, 0xa14f, 0xa14e, // 16552
-    0xa14d, 0xa14b, 0xa14a, 0xa149, 0xa148, 0xa147, 0xa146, 0xa145, // 16560
-    0xa144, 0xa143, 0xa142, 0xa141, 0xa140, 0xa13f, 0xa13e, 0xa13c, // 16568
-    0xa13b, 0xa13a, 0xa139, 0xa138, 0xa137, 0xa136, 0xa135, 0xa134, // 16576
-    0xa133, 0xa132, 0xa131, 0xa130, 0xa12f, 0xa12d, 0xa12c, 0xa12b, // 16584
-    0xa12a, 0xa129, 0xa128, 0xa127, 0xa126, 0xa125, 0xa124, 0xa123, // 16592
-    0xa122, 0xa121, 0xa11f, 0xa11e, 0xa11d, 0xa11c, 0xa11b, 0xa11a, // 16600
-    0xa119, 0xa118, 0xa117, 0xa116, 0xa115, 0xa114, 0xa113, 0xa112, // 16608
-    0xa110, 0xa10f, 0xa10e, 0xa10d, 0xa10c, 0xa10b, 0xa10a, 0xa109, // 16616
-    0xa108, 0xa107, 0xa106, 0xa105, 0xa104, 0xa103, 0xa101, 0xa100, // 16624
-    0xa0ff, 0xa0fe, 0xa0fd, 0xa0fc, 0xa0fb, 0xa0fa, 0xa0f9, 0xa0f8, // 16632
-    0xa0f7, 0xa0f6, 0xa0f5, 0xa0f4, 0xa0f2, 0xa0f1, 0xa0f0, 0xa0ef, // 16640
-    0xa0ee, 0xa0ed, 0xa0ec, 0xa0eb, 0xa0ea, 0xa0e9, 0xa0e8, 0xa0e7, // 16648
-    0xa0e6, 0xa0e5, 0xa0e3, 0xa0e2, 0xa0e1, 0xa0e0, 0xa0df, 0xa0de, // 16656
-    0xa0dd, 0xa0dc, 0xa0db, 0xa0da, 0xa0d9, 0xa0d8, 0xa0d7, 0xa0d6, // 16664
-    0xa0d4, 0xa0d3, 0xa0d2, 0xa0d1, 0xa0d0, 0xa0cf, 0xa0ce, 0xa0cd, // 16672
-    0xa0cc, 0xa0cb, 0xa0ca, 0xa0c9, 0xa0c8, 0xa0c6, 0xa0c5, 0xa0c4, // 16680
-    0xa0c3, 0xa0c2, 0xa0c1, 0xa0c0, 0xa0bf, 0xa0be, 0xa0bd, 0xa0bc, // 16688
-    0xa0bb, 0xa0ba, 0xa0b9, 0xa0b7, 0xa0b6, 0xa0b5, 0xa0b4, 0xa0b3, // 16696
-    0xa0b2, 0xa0b1, 0xa0b0, 0xa0af, 0xa0ae, 0xa0ad, 0xa0ac, 0xa0ab, // 16704
-    0xa0aa, 0xa0a8, 0xa0a7, 0xa0a6, 0xa0a5, 0xa0a4, 0xa0a3, 0xa0a2, // 16712
-    0xa0a1, 0xa0a0, 0xa09f, 0xa09e, 0xa09d, 0xa09c, 0xa09b, 0xa099, // 16720
-    0xa098, 0xa097, 0xa096, 0xa095, 0xa094, 0xa093, 0xa092, 0xa091, // 16728
-    0xa090, 0xa08f, 0xa08e, 0xa08d, 0xa08c, 0xa08a, 0xa089, 0xa088, // 16736
-    0xa087, 0xa086, 0xa085, 0xa084, 0xa083, 0xa082, 0xa081, 0xa080, // 16744
-    0xa07f, 0xa07e, 0xa07d, 0xa07b, 0xa07a, 0xa079, 0xa078, 0xa077, // 16752
-    0xa076, 0xa075, 0xa074, 0xa073, 0xa072, 0xa071, 0xa070, 0xa06f, // 16760
-    0xa06e, 0xa06c, 0xa06b, 0xa06a, 0xa069, 0xa068, 0xa067, 0xa066, // 16768
-    0xa065, 0xa064, 0xa063, 0xa062, 0xa061, 0xa060, 0xa05e, 0xa05d, // 16776
-    0xa05c, 0xa05b, 0xa05a, 0xa059, 0xa058, 0xa057, 0xa056, 0xa055, // 16784
-    0xa054, 0xa053, 0xa052, 0xa051, 0xa04f, 0xa04e, 0xa04d, 0xa04c, // 16792
-    0xa04b, 0xa04a, 0xa049, 0xa048, 0xa047, 0xa046, 0xa045, 0xa044, // 16800
-    0xa043, 0xa042, 0xa040, 0xa03f, 0xa03e, 0xa03d, 0xa03c, 0xa03b, // 16808
-    0xa03a, 0xa039, 0xa038, 0xa037, 0xa036, 0xa035, 0xa034, 0xa033, // 16816
-    0xa031, 0xa030, 0xa02f, 0xa02e, 0xa02d, 0xa02c, 0xa02b, 0xa02a, // 16824
-    0xa029, 0xa028, 0xa027, 0xa026, 0xa025, 0xa024, 0xa022, 0xa021, // 16832
-    0xa020, 0xa01f, 0xa01e, 0xa01d, 0xa01c, 0xa01b, 0xa01a, 0xa019, // 16840
-    0xa018, 0xa017, 0xa016, 0xa015, 0xa013, 0xa012, 0xa011, 0xa010, // 16848
-    0xa00f, 0xa00e, 0xa00d, 0xa00c, 0xa00b, 0xa00a, 0xa009, 0xa008, // 16856
-    0xa007, 0xa005, 0xa004, 0xa003, 0xa002, 0xa001, 0xa000, 0x9fff, // 16864
-    0x9ffe, 0x9ffd, 0x9ffc, 0x9ffb, 0x9ffa, 0x9ff9, 0x9ff8, 0x9ff6, // 16872
-    0x9ff5, 0x9ff4, 0x9ff3, 0x9ff2, 0x9ff1, 0x9ff0, 0x9fef, 0x9fee, // 16880
-    0x9fed, 0x9fec, 0x9feb, 0x9fea, 0x9fe9, 0x9fe7, 0x9fe6, 0x9fe5, // 16888
-    0x9fe4, 0x9fe3, 0x9fe2, 0x9fe1, 0x9fe0, 0x9fdf, 0x9fde, 0x9fdd, // 16896
-    0x9fdc, 0x9fdb, 0x9fda, 0x9fd8, 0x9fd7, 0x9fd6, 0x9fd5, 0x9fd4, // 16904
-    0x9fd3, 0x9fd2, 0x9fd1, 0x9fd0, 0x9fcf, 0x9fce, 0x9fcd, 0x9fcc, // 16912
-    0x9fcb, 0x9fc9, 0x9fc8, 0x9fc7, 0x9fc6, 0x9fc5, 0x9fc4, 0x9fc3, // 16920
-    0x9fc2, 0x9fc1, 0x9fc0, 0x9fbf, 0x9fbe, 0x9fbd, 0x9fbc, 0x9fba, // 16928
-    0x9fb9, 0x9fb8, 0x9fb7, 0x9fb6, 0x9fb5, 0x9fb4, 0x9fb3, 0x9fb2, // 16936
-    0x9fb1, 0x9fb0, 0x9faf, 0x9fae, 0x9fac, 0x9fab, 0x9faa, 0x9fa9, // 16944
-    0x9fa8, 0x9fa7, 0x9fa6, 0x9fa5, 0x9fa4, 0x9fa3, 0x9fa2, 0x9fa1, // 16952
-    0x9fa0, 0x9f9f, 0x9f9d, 0x9f9c, 0x9f9b, 0x9f9a, 0x9f99, 0x9f98, // 16960
-    0x9f97, 0x9f96, 0x9f95, 0x9f94, 0x9f93, 0x9f92, 0x9f91, 0x9f90, // 16968
-    0x9f8e, 0x9f8d, 0x9f8c, 0x9f8b, 0x9f8a, 0x9f89, 0x9f88, 0x9f87, // 16976
-    0x9f86, 0x9f85, 0x9f84, 0x9f83, 0x9f82, 0x9f81, 0x9f7f, 0x9f7e, // 16984
-    0x9f7d, 0x9f7c, 0x9f7b, 0x9f7a, 0x9f79, 0x9f78, 0x9f77, 0x9f76, // 16992
-    0x9f75, 0x9f74, 0x9f73, 0x9f72, 0x9f70, 0x9f6f, 0x9f6e, 0x9f6d, // 17000
-    0x9f6c, 0x9f6b, 0x9f6a, 0x9f69, 0x9f68, 0x9f67, 0x9f66, 0x9f65, // 17008
-    0x9f64, 0x9f63, 0x9f61, 0x9f60, 0x9f5f, 0x9f5e, 0x9f5d, 0x9f5c, // 17016
-    0x9f5b, 0x9f5a, 0x9f59, 0x9f58, 0x9f57, 0x9f56, 0x9f55, 0x9f53, // 17024
-    0x9f52, 0x9f51, 0x9f50, 0x9f4f, 0x9f4e, 0x9f4d, 0x9f4c, 0x9f4b, // 17032
-    0x9f4a, 0x9f49, 0x9f48, 0x9f47, 0x9f46, 0x9f44, 0x9f43, 0x9f42, // 17040
-    0x9f41, 0x9f40, 0x9f3f, 0x9f3e, 0x9f3d, 0x9f3c, 0x9f3b, 0x9f3a, // 17048
-    0x9f39, 0x9f38, 0x9f37, 0x9f35, 0x9f34, 0x9f33, 0x9f32, 0x9f31, // 17056
-    0x9f30, 0x9f2f, 0x9f2e, 0x9f2d, 0x9f2c, 0x9f2b, 0x9f2a, 0x9f29, // 17064
-    0x9f28, 0x9f26, 0x9f25, 0x9f24, 0x9f23, 0x9f22, 0x9f21, 0x9f20, // 17072
-    0x9f1f, 0x9f1e, 0x9f1d, 0x9f1c, 0x9f1b, 0x9f1a, 0x9f19, 0x9f17, // 17080
-    0x9f16, 0x9f15, 0x9f14, 0x9f13, 0x9f12, 0x9f11, 0x9f10, 0x9f0f, // 17088
-    0x9f0e, 0x9f0d, 0x9f0c, 0x9f0b, 0x9f0a, 0x9f08, 0x9f07, 0x9f06, // 17096
-    0x9f05, 0x9f04, 0x9f03, 0x9f02, 0x9f01, 0x9f00, 0x9eff, 0x9efe, // 17104
-    0x9efd, 0x9efc, 0x9efa, 0x9ef9, 0x9ef8, 0x9ef7, 0x9ef6, 0x9ef5, // 17112
-    0x9ef4, 0x9ef3, 0x9ef2, 0x9ef1, 0x9ef0, 0x9eef, 0x9eee, 0x9eed, // 17120
-    0x9eeb, 0x9eea, 0x9ee9, 0x9ee8, 0x9ee7, 0x9ee6, 0x9ee5, 0x9ee4, // 17128
-    0x9ee3, 0x9ee2, 0x9ee1, 0x9ee0, 0x9edf, 0x9ede, 0x9edc, 0x9edb, // 17136
-    0x9eda, 0x9ed9, 0x9ed8, 0x9ed7, 0x9ed6, 0x9ed5, 0x9ed4, 0x9ed3, // 17144
-    0x9ed2, 0x9ed1, 0x9ed0, 0x9ecf, 0x9ecd, 0x9ecc, 0x9ecb, 0x9eca, // 17152
-    0x9ec9, 0x9ec8, 0x9ec7, 0x9ec6, 0x9ec5, 0x9ec4, 0x9ec3, 0x9ec2, // 17160
-    0x9ec1, 0x9ec0, 0x9ebe, 0x9ebd, 0x9ebc, 0x9ebb, 0x9eba, 0x9eb9, // 17168
-    0x9eb8, 0x9eb7, 0x9eb6, 0x9eb5, 0x9eb4, 0x9eb3, 0x9eb2, 0x9eb1, // 17176
-    0x9eaf, 0x9eae, 0x9ead, 0x9eac, 0x9eab, 0x9eaa, 0x9ea9, 0x9ea8, // 17184
-    0x9ea7, 0x9ea6, 0x9ea5, 0x9ea4, 0x9ea3, 0x9ea1, 0x9ea0, 0x9e9f, // 17192
-    0x9e9e, 0x9e9d, 0x9e9c, 0x9e9b, 0x9e9a, 0x9e99, 0x9e98, 0x9e97, // 17200
-    0x9e96, 0x9e95, 0x9e94, 0x9e92, 0x9e91, 0x9e90, 0x9e8f, 0x9e8e, // 17208
-    0x9e8d, 0x9e8c, 0x9e8b, 0x9e8a, 0x9e89, 0x9e88, 0x9e87, 0x9e86, // 17216
-    0x9e85, 0x9e83, 0x9e82, 0x9e81, 0x9e80, 0x9e7f, 0x9e7e, 0x9e7d, // 17224
-    0x9e7c, 0x9e7b, 0x9e7a, 0x9e79, 0x9e78, 0x9e77, 0x9e76, 0x9e74, // 17232
-    0x9e73, 0x9e72, 0x9e71, 0x9e70, 0x9e6f, 0x9e6e, 0x9e6d, 0x9e6c, // 17240
-    0x9e6b, 0x9e6a, 0x9e69, 0x9e68, 0x9e67, 0x9e65, 0x9e64, 0x9e63, // 17248
-    0x9e62, 0x9e61, 0x9e60, 0x9e5f, 0x9e5e, 0x9e5d, 0x9e5c, 0x9e5b, // 17256
-    0x9e5a, 0x9e59, 0x9e58, 0x9e56, 0x9e55, 0x9e54, 0x9e53, 0x9e52, // 17264
-    0x9e51, 0x9e50, 0x9e4f, 0x9e4e, 0x9e4d, 0x9e4c, 0x9e4b, 0x9e4a, // 17272
-    0x9e49, 0x9e47, 0x9e46, 0x9e45, 0x9e44, 0x9e43, 0x9e42, 0x9e41, // 17280
-    0x9e40, 0x9e3f, 0x9e3e, 0x9e3d, 0x9e3c, 0x9e3b, 0x9e39, 0x9e38, // 17288
-    0x9e37, 0x9e36, 0x9e35, 0x9e34, 0x9e33, 0x9e32, 0x9e31, 0x9e30, // 17296
-    0x9e2f, 0x9e2e, 0x9e2d, 0x9e2c, 0x9e2a, 0x9e29, 0x9e28, 0x9e27, // 17304
-    0x9e26, 0x9e25, 0x9e24, 0x9e23, 0x9e22, 0x9e21, 0x9e20, 0x9e1f, // 17312
-    0x9e1e, 0x9e1d, 0x9e1b, 0x9e1a, 0x9e19, 0x9e18, 0x9e17, 0x9e16, // 17320
-    0x9e15, 0x9e14, 0x9e13, 0x9e12, 0x9e11, 0x9e10, 0x9e0f, 0x9e0e, // 17328
-    0x9e0c, 0x9e0b, 0x9e0a, 0x9e09, 0x9e08, 0x9e07, 0x9e06, 0x9e05, // 17336
-    0x9e04, 0x9e03, 0x9e02, 0x9e01, 0x9e00, 0x9dff, 0x9dfd, 0x9dfc, // 17344
-    0x9dfb, 0x9dfa, 0x9df9, 0x9df8, 0x9df7, 0x9df6, 0x9df5, 0x9df4, // 17352
-    0x9df3, 0x9df2, 0x9df1, 0x9df0, 0x9dee, 0x9ded, 0x9dec, 0x9deb, // 17360
-    0x9dea, 0x9de9, 0x9de8, 0x9de7, 0x9de6, 0x9de5, 0x9de4, 0x9de3, // 17368
-    0x9de2, 0x9de0, 0x9ddf, 0x9dde, 0x9ddd, 0x9ddc, 0x9ddb, 0x9dda, // 17376
-    0x9dd9, 0x9dd8, 0x9dd7, 0x9dd6, 0x9dd5, 0x9dd4, 0x9dd3, 0x9dd1, // 17384
-    0x9dd0, 0x9dcf, 0x9dce, 0x9dcd, 0x9dcc, 0x9dcb, 0x9dca, 0x9dc9, // 17392
-    0x9dc8, 0x9dc7, 0x9dc6, 0x9dc5, 0x9dc4, 0x9dc2, 0x9dc1, 0x9dc0, // 17400
-    0x9dc0, 0x9dbf, 0x9dbe, 0x9dbd, 0x9dbc, 0x9dbb, 0x9dba, 0x9db9, // 17408
-    0x9db8, 0x9db7, 0x9db6, 0x9db5, 0x9db4, 0x9db3, 0x9db2, 0x9db1, // 17416
-    0x9db0, 0x9daf, 0x9dae, 0x9dac, 0x9dab, 0x9daa, 0x9da9, 0x9da8, // 17424
-    0x9da7, 0x9da6, 0x9da5, 0x9da4, 0x9da3, 0x9da2, 0x9da1, 0x9da0, // 17432
-    0x9d9f, 0x9d9e, 0x9d9d, 0x9d9c, 0x9d9b, 0x9d9a, 0x9d99, 0x9d98, // 17440
-    0x9d97, 0x9d96, 0x9d95, 0x9d93, 0x9d92, 0x9d91, 0x9d90, 0x9d8f, // 17448
-    0x9d8e, 0x9d8d, 0x9d8c, 0x9d8b, 0x9d8a, 0x9d89, 0x9d88, 0x9d87, // 17456
-    0x9d86, 0x9d85, 0x9d84, 0x9d83, 0x9d82, 0x9d81, 0x9d80, 0x9d7f, // 17464
-    0x9d7e, 0x9d7d, 0x9d7c, 0x9d7b, 0x9d79, 0x9d78, 0x9d77, 0x9d76, // 17472
-    0x9d75, 0x9d74, 0x9d73, 0x9d72, 0x9d71, 0x9d70, 0x9d6f, 0x9d6e, // 17480
-    0x9d6d, 0x9d6c, 0x9d6b, 0x9d6a, 0x9d69, 0x9d68, 0x9d67, 0x9d66, // 17488
-    0x9d65, 0x9d64, 0x9d63, 0x9d62, 0x9d60, 0x9d5f, 0x9d5e, 0x9d5d, // 17496
-    0x9d5c, 0x9d5b, 0x9d5a, 0x9d59, 0x9d58, 0x9d57, 0x9d56, 0x9d55, // 17504
-    0x9d54, 0x9d53, 0x9d52, 0x9d51, 0x9d50, 0x9d4f, 0x9d4e, 0x9d4d, // 17512
-    0x9d4c, 0x9d4b, 0x9d4a, 0x9d49, 0x9d47, 0x9d46, 0x9d45, 0x9d44, // 17520
-    0x9d43, 0x9d42, 0x9d41, 0x9d40, 0x9d3f, 0x9d3e, 0x9d3d, 0x9d3c, // 17528
-    0x9d3b, 0x9d3a, 0x9d39, 0x9d38, 0x9d37, 0x9d36, 0x9d35, 0x9d34, // 17536
-    0x9d33, 0x9d32, 0x9d31, 0x9d30, 0x9d2f, 0x9d2d, 0x9d2c, 0x9d2b, // 17544
-    0x9d2a, 0x9d29, 0x9d28, 0x9d27, 0x9d26, 0x9d25, 0x9d24, 0x9d23, // 17552
-    0x9d22, 0x9d21, 0x9d20, 0x9d1f, 0x9d1e, 0x9d1d, 0x9d1c, 0x9d1b, // 17560
-    0x9d1a, 0x9d19, 0x9d18, 0x9d17, 0x9d16, 0x9d14, 0x9d13, 0x9d12, // 17568
-    0x9d11, 0x9d10, 0x9d0f, 0x9d0e, 0x9d0d, 0x9d0c, 0x9d0b, 0x9d0a, // 17576
-    0x9d09, 0x9d08, 0x9d07, 0x9d06, 0x9d05, 0x9d04, 0x9d03, 0x9d02, // 17584
-    0x9d01, 0x9d00, 0x9cff, 0x9cfe, 0x9cfd, 0x9cfb, 0x9cfa, 0x9cf9, // 17592
-    0x9cf8, 0x9cf7, 0x9cf6, 0x9cf5, 0x9cf4, 0x9cf3, 0x9cf2, 0x9cf1, // 17600
-    0x9cf0, 0x9cef, 0x9cee, 0x9ced, 0x9cec, 0x9ceb, 0x9cea, 0x9ce9, // 17608
-    0x9ce8, 0x9ce7, 0x9ce6, 0x9ce5, 0x9ce4, 0x9ce3, 0x9ce1, 0x9ce0, // 17616
-    0x9cdf, 0x9cde, 0x9cdd, 0x9cdc, 0x9cdb, 0x9cda, 0x9cd9, 0x9cd8, // 17624
-    0x9cd7, 0x9cd6, 0x9cd5, 0x9cd4, 0x9cd3, 0x9cd2, 0x9cd1, 0x9cd0, // 17632
-    0x9ccf, 0x9cce, 0x9ccd, 0x9ccc, 0x9ccb, 0x9cca, 0x9cc8, 0x9cc7, // 17640
-    0x9cc6, 0x9cc5, 0x9cc4, 0x9cc3, 0x9cc2, 0x9cc1, 0x9cc0, 0x9cbf, // 17648
-    0x9cbe, 0x9cbd, 0x9cbc, 0x9cbb, 0x9cba, 0x9cb9, 0x9cb8, 0x9cb7, // 17656
-    0x9cb6, 0x9cb5, 0x9cb4, 0x9cb3, 0x9cb2, 0x9cb1, 0x9cb0, 0x9cae, // 17664
-    0x9cad, 0x9cac, 0x9cab, 0x9caa, 0x9ca9, 0x9ca8, 0x9ca7, 0x9ca6, // 17672
-    0x9ca5, 0x9ca4, 0x9ca3, 0x9ca2, 0x9ca1, 0x9ca0, 0x9c9f, 0x9c9e, // 17680
-    0x9c9d, 0x9c9c, 0x9c9b, 0x9c9a, 0x9c99, 0x9c98, 0x9c97, 0x9c95, // 17688
-    0x9c94, 0x9c93, 0x9c92, 0x9c91, 0x9c90, 0x9c8f, 0x9c8e, 0x9c8d, // 17696
-    0x9c8c, 0x9c8b, 0x9c8a, 0x9c89, 0x9c88, 0x9c87, 0x9c86, 0x9c85, // 17704
-    0x9c84, 0x9c83, 0x9c82, 0x9c81, 0x9c80, 0x9c7f, 0x9c7e, 0x9c7c, // 17712
-    0x9c7b, 0x9c7a, 0x9c79, 0x9c78, 0x9c77, 0x9c76, 0x9c75, 0x9c74, // 17720
-    0x9c73, 0x9c72, 0x9c71, 0x9c70, 0x9c6f, 0x9c6e, 0x9c6d, 0x9c6c, // 17728
-    0x9c6b, 0x9c6a, 0x9c69, 0x9c68, 0x9c67, 0x9c66, 0x9c65, 0x9c64, // 17736
-    0x9c62, 0x9c61, 0x9c60, 0x9c5f, 0x9c5e, 0x9c5d, 0x9c5c, 0x9c5b, // 17744
-    0x9c5a, 0x9c59, 0x9c58, 0x9c57, 0x9c56, 0x9c55, 0x9c54, 0x9c53, // 17752
-    0x9c52, 0x9c51, 0x9c50, 0x9c4f, 0x9c4e, 0x9c4d, 0x9c4c, 0x9c4b, // 17760
-    0x9c49, 0x9c48, 0x9c47, 0x9c46, 0x9c45, 0x9c44, 0x9c43, 0x9c42, // 17768
-    0x9c41, 0x9c40, 0x9c3f, 0x9c3e, 0x9c3d, 0x9c3c, 0x9c3b, 0x9c3a, // 17776
-    0x9c39, 0x9c38, 0x9c37, 0x9c36, 0x9c35, 0x9c34, 0x9c33, 0x9c32, // 17784
-    0x9c31, 0x9c2f, 0x9c2e, 0x9c2d, 0x9c2c, 0x9c2b, 0x9c2a, 0x9c29, // 17792
-    0x9c28, 0x9c27, 0x9c26, 0x9c25, 0x9c24, 0x9c23, 0x9c22, 0x9c21, // 17800
-    0x9c20, 0x9c1f, 0x9c1e, 0x9c1d, 0x9c1c, 0x9c1b, 0x9c1a, 0x9c19, // 17808
-    0x9c18, 0x9c16, 0x9c15, 0x9c14, 0x9c13, 0x9c12, 0x9c11, 0x9c10, // 17816
-    0x9c0f, 0x9c0e, 0x9c0d, 0x9c0c, 0x9c0b, 0x9c0a, 0x9c09, 0x9c08, // 17824
-    0x9c07, 0x9c06, 0x9c05, 0x9c04, 0x9c03, 0x9c02, 0x9c01, 0x9c00, // 17832
-    0x9bff, 0x9bfd, 0x9bfc, 0x9bfb, 0x9bfa, 0x9bf9, 0x9bf8, 0x9bf7, // 17840
-    0x9bf6, 0x9bf5, 0x9bf4, 0x9bf3, 0x9bf2, 0x9bf1, 0x9bf0, 0x9bef, // 17848
-    0x9bee, 0x9bed, 0x9bec, 0x9beb, 0x9bea, 0x9be9, 0x9be8, 0x9be7, // 17856
-    0x9be6, 0x9be5, 0x9be3, 0x9be2, 0x9be1, 0x9be0, 0x9bdf, 0x9bde, // 17864
-    0x9bdd, 0x9bdc, 0x9bdb, 0x9bda, 0x9bd9, 0x9bd8, 0x9bd7, 0x9bd6, // 17872
-    0x9bd5, 0x9bd4, 0x9bd3, 0x9bd2, 0x9bd1, 0x9bd0, 0x9bcf, 0x9bce, // 17880
-    0x9bcd, 0x9bcc, 0x9bca, 0x9bc9, 0x9bc8, 0x9bc7, 0x9bc6, 0x9bc5, // 17888
-    0x9bc4, 0x9bc3, 0x9bc2, 0x9bc1, 0x9bc0, 0x9bbf, 0x9bbe, 0x9bbd, // 17896
-    0x9bbc, 0x9bbb, 0x9bba, 0x9bb9, 0x9bb8, 0x9bb7, 0x9bb6, 0x9bb5, // 17904
-    0x9bb4, 0x9bb3, 0x9bb1, 0x9bb0, 0x9baf, 0x9bae, 0x9bad, 0x9bac, // 17912
-    0x9bab, 0x9baa, 0x9ba9, 0x9ba8, 0x9ba7, 0x9ba6, 0x9ba5, 0x9ba4, // 17920
-    0x9ba3, 0x9ba2, 0x9ba1, 0x9ba0, 0x9b9f, 0x9b9e, 0x9b9d, 0x9b9c, // 17928
-    0x9b9b, 0x9b9a, 0x9b99, 0x9b97, 0x9b96, 0x9b95, 0x9b94, 0x9b93, // 17936
-    0x9b92, 0x9b91, 0x9b90, 0x9b8f, 0x9b8e, 0x9b8d, 0x9b8c, 0x9b8b, // 17944
-    0x9b8a, 0x9b89, 0x9b88, 0x9b87, 0x9b86, 0x9b85, 0x9b84, 0x9b83, // 17952
-    0x9b82, 0x9b81, 0x9b80, 0x9b7e, 0x9b7d, 0x9b7c, 0x9b7b, 0x9b7a, // 17960
-    0x9b79, 0x9b78, 0x9b77, 0x9b76, 0x9b75, 0x9b74, 0x9b73, 0x9b72, // 17968
-    0x9b71, 0x9b70, 0x9b6f, 0x9b6e, 0x9b6d, 0x9b6c, 0x9b6b, 0x9b6a, // 17976
-    0x9b69, 0x9b68, 0x9b67, 0x9b66, 0x9b64, 0x9b63, 0x9b62, 0x9b61, // 17984
-    0x9b60, 0x9b5f, 0x9b5e, 0x9b5d, 0x9b5c, 0x9b5b, 0x9b5a, 0x9b59, // 17992
-    0x9b58, 0x9b57, 0x9b56, 0x9b55, 0x9b54, 0x9b53, 0x9b52, 0x9b51, // 18000
-    0x9b50, 0x9b4f, 0x9b4e, 0x9b4d, 0x9b4b, 0x9b4a, 0x9b49, 0x9b48, // 18008
-    0x9b47, 0x9b46, 0x9b45, 0x9b44, 0x9b43, 0x9b42, 0x9b41, 0x9b40, // 18016
-    0x9b3f, 0x9b3e, 0x9b3d, 0x9b3c, 0x9b3b, 0x9b3a, 0x9b39, 0x9b38, // 18024
-    0x9b37, 0x9b36, 0x9b35, 0x9b34, 0x9b32, 0x9b31, 0x9b30, 0x9b2f, // 18032
-    0x9b2e, 0x9b2d, 0x9b2c, 0x9b2b, 0x9b2a, 0x9b29, 0x9b28, 0x9b27, // 18040
-    0x9b26, 0x9b25, 0x9b24, 0x9b23, 0x9b22, 0x9b21, 0x9b20, 0x9b1f, // 18048
-    0x9b1e, 0x9b1d, 0x9b1c, 0x9b1b, 0x9b1a, 0x9b18, 0x9b17, 0x9b16, // 18056
-    0x9b15, 0x9b14, 0x9b13, 0x9b12, 0x9b11, 0x9b10, 0x9b0f, 0x9b0e, // 18064
-    0x9b0d, 0x9b0c, 0x9b0b, 0x9b0a, 0x9b09, 0x9b08, 0x9b07, 0x9b06, // 18072
-    0x9b05, 0x9b04, 0x9b03, 0x9b02, 0x9b01, 0x9aff, 0x9afe, 0x9afd, // 18080
-    0x9afc, 0x9afb, 0x9afa, 0x9af9, 0x9af8, 0x9af7, 0x9af6, 0x9af5, // 18088
-    0x9af4, 0x9af3, 0x9af2, 0x9af1, 0x9af0, 0x9aef, 0x9aee, 0x9aed, // 18096
-    0x9aec, 0x9aeb, 0x9aea, 0x9ae9, 0x9ae8, 0x9ae6, 0x9ae5, 0x9ae4, // 18104
-    0x9ae3, 0x9ae2, 0x9ae1, 0x9ae0, 0x9adf, 0x9ade, 0x9add, 0x9adc, // 18112
-    0x9adb, 0x9ada, 0x9ad9, 0x9ad8, 0x9ad7, 0x9ad6, 0x9ad5, 0x9ad4, // 18120
-    0x9ad3, 0x9ad2, 0x9ad1, 0x9ad0, 0x9acf, 0x9ace, 0x9acc, 0x9acb, // 18128
-    0x9aca, 0x9ac9, 0x9ac8, 0x9ac7, 0x9ac6, 0x9ac5, 0x9ac4, 0x9ac3, // 18136
-    0x9ac2, 0x9ac1, 0x9ac0, 0x9abf, 0x9abe, 0x9abd, 0x9abc, 0x9abb, // 18144
-    0x9aba, 0x9ab9, 0x9ab8, 0x9ab7, 0x9ab6, 0x9ab5, 0x9ab3, 0x9ab2, // 18152
-    0x9ab1, 0x9ab0, 0x9aaf, 0x9aae, 0x9aad, 0x9aac, 0x9aab, 0x9aaa, // 18160
-    0x9aa9, 0x9aa8, 0x9aa7, 0x9aa6, 0x9aa5, 0x9aa4, 0x9aa3, 0x9aa2, // 18168
-    0x9aa1, 0x9aa0, 0x9a9f, 0x9a9e, 0x9a9d, 0x9a9c, 0x9a9b, 0x9a99, // 18176
-    0x9a98, 0x9a97, 0x9a96, 0x9a95, 0x9a94, 0x9a93, 0x9a92, 0x9a91, // 18184
-    0x9a90, 0x9a8f, 0x9a8e, 0x9a8d, 0x9a8c, 0x9a8b, 0x9a8a, 0x9a89, // 18192
-    0x9a88, 0x9a87, 0x9a86, 0x9a85, 0x9a84, 0x9a83, 0x9a82, 0x9a80, // 18200
-    0x9a7f, 0x9a7e, 0x9a7d, 0x9a7c, 0x9a7b, 0x9a7a, 0x9a79, 0x9a78, // 18208
-    0x9a77, 0x9a76, 0x9a75, 0x9a74, 0x9a73, 0x9a72, 0x9a71, 0x9a70, // 18216
-    0x9a6f, 0x9a6e, 0x9a6d, 0x9a6c, 0x9a6b, 0x9a6a, 0x9a69, 0x9a67, // 18224
-    0x9a66, 0x9a65, 0x9a64, 0x9a63, 0x9a62, 0x9a61, 0x9a60, 0x9a5f, // 18232
-    0x9a5e, 0x9a5d, 0x9a5c, 0x9a5b, 0x9a5a, 0x9a59, 0x9a58, 0x9a57, // 18240
-    0x9a56, 0x9a55, 0x9a54, 0x9a53, 0x9a52, 0x9a51, 0x9a50, 0x9a4f, // 18248
-    0x9a4d, 0x9a4c, 0x9a4b, 0x9a4a, 0x9a49, 0x9a48, 0x9a47, 0x9a46, // 18256
-    0x9a45, 0x9a44, 0x9a43, 0x9a42, 0x9a41, 0x9a40, 0x9a3f, 0x9a3e, // 18264
-    0x9a3d, 0x9a3c, 0x9a3b, 0x9a3a, 0x9a39, 0x9a38, 0x9a37, 0x9a36, // 18272
-    0x9a34, 0x9a33, 0x9a32, 0x9a31, 0x9a30, 0x9a2f, 0x9a2e, 0x9a2d, // 18280
-    0x9a2c, 0x9a2b, 0x9a2a, 0x9a29, 0x9a28, 0x9a27, 0x9a26, 0x9a25, // 18288
-    0x9a24, 0x9a23, 0x9a22, 0x9a21, 0x9a20, 0x9a1f, 0x9a1e, 0x9a1d, // 18296
-    0x9a1c, 0x9a1a, 0x9a19, 0x9a18, 0x9a17, 0x9a16, 0x9a15, 0x9a14, // 18304
-    0x9a13, 0x9a12, 0x9a11, 0x9a10, 0x9a0f, 0x9a0e, 0x9a0d, 0x9a0c, // 18312
-    0x9a0b, 0x9a0a, 0x9a09, 0x9a08, 0x9a07, 0x9a06, 0x9a05, 0x9a04, // 18320
-    0x9a03, 0x9a01, 0x9a00, 0x99ff, 0x99fe, 0x99fd, 0x99fc, 0x99fb, // 18328
-    0x99fa, 0x99f9, 0x99f8, 0x99f7, 0x99f6, 0x99f5, 0x99f4, 0x99f3, // 18336
-    0x99f2, 0x99f1, 0x99f0, 0x99ef, 0x99ee, 0x99ed, 0x99ec, 0x99eb, // 18344
-    0x99ea, 0x99e8, 0x99e7, 0x99e6, 0x99e5, 0x99e4, 0x99e3, 0x99e2, // 18352
-    0x99e1, 0x99e0, 0x99df, 0x99de, 0x99dd, 0x99dc, 0x99db, 0x99da, // 18360
-    0x99d9, 0x99d8, 0x99d7, 0x99d6, 0x99d5, 0x99d4, 0x99d3, 0x99d2, // 18368
-    0x99d1, 0x99d0, 0x99ce, 0x99cd, 0x99cc, 0x99cb, 0x99ca, 0x99c9, // 18376
-    0x99c8, 0x99c7, 0x99c6, 0x99c5, 0x99c4, 0x99c3, 0x99c2, 0x99c1, // 18384
-    0x99c0, 0x99bf, 0x99be, 0x99bd, 0x99bc, 0x99bb, 0x99ba, 0x99b9, // 18392
-    0x99b8, 0x99b7, 0x99b5, 0x99b4, 0x99b3, 0x99b2, 0x99b1, 0x99b0, // 18400
-    0x99af, 0x99ae, 0x99ad, 0x99ac, 0x99ab, 0x99aa, 0x99a9, 0x99a8, // 18408
-    0x99a7, 0x99a6, 0x99a5, 0x99a4, 0x99a3, 0x99a2, 0x99a1, 0x99a0, // 18416
-    0x999f, 0x999e, 0x999c, 0x999b, 0x999a, 0x9999, 0x9998, 0x9997, // 18424
-    0x9997, 0x9996, 0x9995, 0x9994, 0x9993, 0x9992, 0x9991, 0x9990, // 18432
-    0x998f, 0x998e, 0x998d, 0x998c, 0x998b, 0x998a, 0x9989, 0x9988, // 18440
-    0x9987, 0x9986, 0x9985, 0x9984, 0x9983, 0x9982, 0x9981, 0x9980, // 18448
-    0x997f, 0x997e, 0x997d, 0x997c, 0x997b, 0x997a, 0x9979, 0x9978, // 18456
-    0x9977, 0x9976, 0x9975, 0x9974, 0x9973, 0x9972, 0x9971, 0x9970, // 18464
-    0x996f, 0x996e, 0x996d, 0x996c, 0x996b, 0x996a, 0x9969, 0x9968, // 18472
-    0x9967, 0x9966, 0x9965, 0x9964, 0x9963, 0x9962, 0x9961, 0x9960, // 18480
-    0x995f, 0x995e, 0x995d, 0x995c, 0x995b, 0x995a, 0x9959, 0x9958, // 18488
-    0x9957, 0x9956, 0x9955, 0x9954, 0x9953, 0x9952, 0x9951, 0x9950, // 18496
-    0x994f, 0x994e, 0x994d, 0x994c, 0x994b, 0x9949, 0x9948, 0x9947, // 18504
-    0x9946, 0x9945, 0x9944, 0x9943, 0x9942, 0x9941, 0x9940, 0x993f, // 18512
-    0x993e, 0x993d, 0x993c, 0x993b, 0x993a, 0x9939, 0x9938, 0x9937, // 18520
-    0x9936, 0x9935, 0x9934, 0x9933, 0x9932, 0x9931, 0x9930, 0x992f, // 18528
-    0x992e, 0x992d, 0x992c, 0x992b, 0x992a, 0x9929, 0x9928, 0x9927, // 18536
-    0x9926, 0x9925, 0x9924, 0x9923, 0x9922, 0x9921, 0x9920, 0x991f, // 18544
-    0x991e, 0x991d, 0x991c, 0x991b, 0x991a, 0x9919, 0x9918, 0x9917, // 18552
-    0x9916, 0x9915, 0x9914, 0x9913, 0x9912, 0x9911, 0x9910, 0x990f, // 18560
-    0x990e, 0x990d, 0x990c, 0x990b, 0x990a, 0x9909, 0x9908, 0x9907, // 18568
-    0x9906, 0x9905, 0x9904, 0x9903, 0x9902, 0x9901, 0x9900, 0x98ff, // 18576
-    0x98fe, 0x98fd, 0x98fc, 0x98fb, 0x98fa, 0x98f9, 0x98f8, 0x98f7, // 18584
-    0x98f6, 0x98f5, 0x98f4, 0x98f3, 0x98f2, 0x98f1, 0x98f0, 0x98ef, // 18592
-    0x98ee, 0x98ed, 0x98ec, 0x98eb, 0x98ea, 0x98e9, 0x98e8, 0x98e7, // 18600
-    0x98e6, 0x98e5, 0x98e4, 0x98e3, 0x98e1, 0x98e0, 0x98df, 0x98de, // 18608
-    0x98dd, 0x98dc, 0x98db, 0x98da, 0x98d9, 0x98d8, 0x98d7, 0x98d6, // 18616
-    0x98d5, 0x98d4, 0x98d3, 0x98d2, 0x98d1, 0x98d0, 0x98cf, 0x98ce, // 18624
-    0x98cd, 0x98cc, 0x98cb, 0x98ca, 0x98c9, 0x98c8, 0x98c7, 0x98c6, // 18632
-    0x98c5, 0x98c4, 0x98c3, 0x98c2, 0x98c1, 0x98c0, 0x98bf, 0x98be, // 18640
-    0x98bd, 0x98bc, 0x98bb, 0x98ba, 0x98b9, 0x98b8, 0x98b7, 0x98b6, // 18648
-    0x98b5, 0x98b4, 0x98b3, 0x98b2, 0x98b1, 0x98b0, 0x98af, 0x98ae, // 18656
-    0x98ad, 0x98ac, 0x98ab, 0x98aa, 0x98a9, 0x98a8, 0x98a7, 0x98a6, // 18664
-    0x98a5, 0x98a4, 0x98a3, 0x98a2, 0x98a1, 0x98a0, 0x989f, 0x989e, // 18672
-    0x989d, 0x989c, 0x989b, 0x989a, 0x9899, 0x9898, 0x9897, 0x9896, // 18680
-    0x9895, 0x9894, 0x9893, 0x9892, 0x9891, 0x9890, 0x988f, 0x988e, // 18688
-    0x988d, 0x988c, 0x988b, 0x988a, 0x9889, 0x9888, 0x9887, 0x9886, // 18696
-    0x9885, 0x9884, 0x9883, 0x9882, 0x9881, 0x9880, 0x987f, 0x987e, // 18704
-    0x987d, 0x987c, 0x987a, 0x9879, 0x9878, 0x9877, 0x9876, 0x9875, // 18712
-    0x9874, 0x9873, 0x9872, 0x9871, 0x9870, 0x986f, 0x986e, 0x986d, // 18720
-    0x986c, 0x986b, 0x986a, 0x9869, 0x9868, 0x9867, 0x9866, 0x9865, // 18728
-    0x9864, 0x9863, 0x9862, 0x9861, 0x9860, 0x985f, 0x985e, 0x985d, // 18736
-    0x985c, 0x985b, 0x985a, 0x9859, 0x9858, 0x9857, 0x9856, 0x9855, // 18744
-    0x9854, 0x9853, 0x9852, 0x9851, 0x9850, 0x984f, 0x984e, 0x984d, // 18752
-    0x984c, 0x984b, 0x984a, 0x9849, 0x9848, 0x9847, 0x9846, 0x9845, // 18760
-    0x9844, 0x9843, 0x9842, 0x9841, 0x9840, 0x983f, 0x983e, 0x983d, // 18768
-    0x983c, 0x983b, 0x983a, 0x9839, 0x9838, 0x9837, 0x9836, 0x9835, // 18776
-    0x9834, 0x9833, 0x9832, 0x9831, 0x9830, 0x982f, 0x982e, 0x982d, // 18784
-    0x982c, 0x982b, 0x982a, 0x9829, 0x9828, 0x9827, 0x9826, 0x9825, // 18792
-    0x9824, 0x9823, 0x9822, 0x9821, 0x9820, 0x981f, 0x981e, 0x981d, // 18800
-    0x981c, 0x981b, 0x981a, 0x9819, 0x9818, 0x9817, 0x9816, 0x9815, // 18808
-    0x9814, 0x9812, 0x9811, 0x9810, 0x980f, 0x980e, 0x980d, 0x980c, // 18816
-    0x980b, 0x980a, 0x9809, 0x9808, 0x9807, 0x9806, 0x9805, 0x9804, // 18824
-    0x9803, 0x9802, 0x9801, 0x9800, 0x97ff, 0x97fe, 0x97fd, 0x97fc, // 18832
-    0x97fb, 0x97fa, 0x97f9, 0x97f8, 0x97f7, 0x97f6, 0x97f5, 0x97f4, // 18840
-    0x97f3, 0x97f2, 0x97f1, 0x97f0, 0x97ef, 0x97ee, 0x97ed, 0x97ec, // 18848
-    0x97eb, 0x97ea, 0x97e9, 0x97e8, 0x97e7, 0x97e6, 0x97e5, 0x97e4, // 18856
-    0x97e3, 0x97e2, 0x97e1, 0x97e0, 0x97df, 0x97de, 0x97dd, 0x97dc, // 18864
-    0x97db, 0x97da, 0x97d9, 0x97d8, 0x97d7, 0x97d6, 0x97d5, 0x97d4, // 18872
-    0x97d3, 0x97d2, 0x97d1, 0x97d0, 0x97cf, 0x97ce, 0x97cd, 0x97cc, // 18880
-    0x97cb, 0x97ca, 0x97c9, 0x97c8, 0x97c7, 0x97c6, 0x97c5, 0x97c4, // 18888
-    0x97c3, 0x97c2, 0x97c1, 0x97c0, 0x97bf, 0x97be, 0x97bd, 0x97bc, // 18896
-    0x97bb, 0x97ba, 0x97b9, 0x97b8, 0x97b7, 0x97b6, 0x97b5, 0x97b4, // 18904
-    0x97b3, 0x97b2, 0x97b1, 0x97b0, 0x97af, 0x97ae, 0x97ad, 0x97ab, // 18912
-    0x97aa, 0x97a9, 0x97a8, 0x97a7, 0x97a6, 0x97a5, 0x97a4, 0x97a3, // 18920
-    0x97a2, 0x97a1, 0x97a0, 0x979f, 0x979e, 0x979d, 0x979c, 0x979b, // 18928
-    0x979a, 0x9799, 0x9798, 0x9797, 0x9796, 0x9795, 0x9794, 0x9793, // 18936
-    0x9792, 0x9791, 0x9790, 0x978f, 0x978e, 0x978d, 0x978c, 0x978b, // 18944
-    0x978a, 0x9789, 0x9788, 0x9787, 0x9786, 0x9785, 0x9784, 0x9783, // 18952
-    0x9782, 0x9781, 0x9780, 0x977f, 0x977e, 0x977d, 0x977c, 0x977b, // 18960
-    0x977a, 0x9779, 0x9778, 0x9777, 0x9776, 0x9775, 0x9774, 0x9773, // 18968
-    0x9772, 0x9771, 0x9770, 0x976f, 0x976e, 0x976d, 0x976c, 0x976b, // 18976
-    0x976a, 0x9769, 0x9768, 0x9767, 0x9766, 0x9765, 0x9764, 0x9763, // 18984
-    0x9762, 0x9761, 0x9760, 0x975f, 0x975e, 0x975d, 0x975c, 0x975b, // 18992
-    0x975a, 0x9759, 0x9758, 0x9757, 0x9756, 0x9755, 0x9754, 0x9753, // 19000
-    0x9752, 0x9751, 0x9750, 0x974f, 0x974e, 0x974d, 0x974c, 0x974b, // 19008
-    0x974a, 0x9749, 0x9748, 0x9747, 0x9746, 0x9744, 0x9743, 0x9742, // 19016
-    0x9741, 0x9740, 0x973f, 0x973e, 0x973d, 0x973c, 0x973b, 0x973a, // 19024
-    0x9739, 0x9738, 0x9737, 0x9736, 0x9735, 0x9734, 0x9733, 0x9732, // 19032
-    0x9731, 0x9730, 0x972f, 0x972e, 0x972d, 0x972c, 0x972b, 0x972a, // 19040
-    0x9729, 0x9728, 0x9727, 0x9726, 0x9725, 0x9724, 0x9723, 0x9722, // 19048
-    0x9721, 0x9720, 0x971f, 0x971e, 0x971d, 0x971c, 0x971b, 0x971a, // 19056
-    0x9719, 0x9718, 0x9717, 0x9716, 0x9715, 0x9714, 0x9713, 0x9712, // 19064
-    0x9711, 0x9710, 0x970f, 0x970e, 0x970d, 0x970c, 0x970b, 0x970a, // 19072
-    0x9709, 0x9708, 0x9707, 0x9706, 0x9705, 0x9704, 0x9703, 0x9702, // 19080
-    0x9701, 0x9700, 0x96ff, 0x96fe, 0x96fd, 0x96fc, 0x96fb, 0x96fa, // 19088
-    0x96f9, 0x96f8, 0x96f7, 0x96f6, 0x96f5, 0x96f4, 0x96f3, 0x96f2, // 19096
-    0x96f1, 0x96f0, 0x96ef, 0x96ee, 0x96ed, 0x96ec, 0x96eb, 0x96ea, // 19104
-    0x96e9, 0x96e8, 0x96e7, 0x96e6, 0x96e5, 0x96e4, 0x96e3, 0x96e2, // 19112
-    0x96e1, 0x96e0, 0x96df, 0x96de, 0x96dc, 0x96db, 0x96da, 0x96d9, // 19120
-    0x96d8, 0x96d7, 0x96d6, 0x96d5, 0x96d4, 0x96d3, 0x96d2, 0x96d1, // 19128
-    0x96d0, 0x96cf, 0x96ce, 0x96cd, 0x96cc, 0x96cb, 0x96ca, 0x96c9, // 19136
-    0x96c8, 0x96c7, 0x96c6, 0x96c5, 0x96c4, 0x96c3, 0x96c2, 0x96c1, // 19144
-    0x96c0, 0x96bf, 0x96be, 0x96bd, 0x96bc, 0x96bb, 0x96ba, 0x96b9, // 19152
-    0x96b8, 0x96b7, 0x96b6, 0x96b5, 0x96b4, 0x96b3, 0x96b2, 0x96b1, // 19160
-    0x96b0, 0x96af, 0x96ae, 0x96ad, 0x96ac, 0x96ab, 0x96aa, 0x96a9, // 19168
-    0x96a8, 0x96a7, 0x96a6, 0x96a5, 0x96a4, 0x96a3, 0x96a2, 0x96a1, // 19176
-    0x96a0, 0x969f, 0x969e, 0x969d, 0x969c, 0x969b, 0x969a, 0x9699, // 19184
-    0x9698, 0x9697, 0x9696, 0x9695, 0x9694, 0x9693, 0x9692, 0x9691, // 19192
-    0x9690, 0x968f, 0x968e, 0x968d, 0x968c, 0x968b, 0x968a, 0x9689, // 19200
-    0x9688, 0x9687, 0x9686, 0x9685, 0x9684, 0x9683, 0x9682, 0x9681, // 19208
-    0x9680, 0x967f, 0x967e, 0x967d, 0x967c, 0x967b, 0x967a, 0x9679, // 19216
-    0x9678, 0x9677, 0x9675, 0x9674, 0x9673, 0x9672, 0x9671, 0x9670, // 19224
-    0x966f, 0x966e, 0x966d, 0x966c, 0x966b, 0x966a, 0x9669, 0x9668, // 19232
-    0x9667, 0x9666, 0x9665, 0x9664, 0x9663, 0x9662, 0x9661, 0x9660, // 19240
-    0x965f, 0x965e, 0x965d, 0x965c, 0x965b, 0x965a, 0x9659, 0x9658, // 19248
-    0x9657, 0x9656, 0x9655, 0x9654, 0x9653, 0x9652, 0x9651, 0x9650, // 19256
-    0x964f, 0x964e, 0x964d, 0x964c, 0x964b, 0x964a, 0x9649, 0x9648, // 19264
-    0x9647, 0x9646, 0x9645, 0x9644, 0x9643, 0x9642, 0x9641, 0x9640, // 19272
-    0x963f, 0x963e, 0x963d, 0x963c, 0x963b, 0x963a, 0x9639, 0x9638, // 19280
-    0x9637, 0x9636, 0x9635, 0x9634, 0x9633, 0x9632, 0x9631, 0x9630, // 19288
-    0x962f, 0x962e, 0x962d, 0x962c, 0x962b, 0x962a, 0x9629, 0x9628, // 19296
-    0x9627, 0x9626, 0x9625, 0x9624, 0x9623, 0x9622, 0x9621, 0x9620, // 19304
-    0x961f, 0x961e, 0x961d, 0x961c, 0x961b, 0x961a, 0x9619, 0x9618, // 19312
-    0x9617, 0x9616, 0x9615, 0x9614, 0x9613, 0x9612, 0x9611, 0x9610, // 19320
-    0x960f, 0x960d, 0x960c, 0x960b, 0x960a, 0x9609, 0x9608, 0x9607, // 19328
-    0x9606, 0x9605, 0x9604, 0x9603, 0x9602, 0x9601, 0x9600, 0x95ff, // 19336
-    0x95fe, 0x95fd, 0x95fc, 0x95fb, 0x95fa, 0x95f9, 0x95f8, 0x95f7, // 19344
-    0x95f6, 0x95f5, 0x95f4, 0x95f3, 0x95f2, 0x95f1, 0x95f0, 0x95ef, // 19352
-    0x95ee, 0x95ed, 0x95ec, 0x95eb, 0x95ea, 0x95e9, 0x95e8, 0x95e7, // 19360
-    0x95e6, 0x95e5, 0x95e4, 0x95e3, 0x95e2, 0x95e1, 0x95e0, 0x95df, // 19368
-    0x95de, 0x95dd, 0x95dc, 0x95db, 0x95da, 0x95d9, 0x95d8, 0x95d7, // 19376
-    0x95d6, 0x95d5, 0x95d4, 0x95d3, 0x95d2, 0x95d1, 0x95d0, 0x95cf, // 19384
-    0x95ce, 0x95cd, 0x95cc, 0x95cb, 0x95ca, 0x95c9, 0x95c8, 0x95c7, // 19392
-    0x95c6, 0x95c5, 0x95c4, 0x95c3, 0x95c2, 0x95c1, 0x95c0, 0x95bf, // 19400
-    0x95be, 0x95bd, 0x95bc, 0x95bb, 0x95ba, 0x95b9, 0x95b8, 0x95b7, // 19408
-    0x95b6, 0x95b5, 0x95b4, 0x95b3, 0x95b2, 0x95b1, 0x95b0, 0x95af, // 19416
-    0x95ae, 0x95ad, 0x95ac, 0x95ab, 0x95aa, 0x95a9, 0x95a8, 0x95a6, // 19424
-    0x95a5, 0x95a4, 0x95a3, 0x95a2, 0x95a1, 0x95a0, 0x959f, 0x959e, // 19432
-    0x959d, 0x959c, 0x959b, 0x959a, 0x9599, 0x9598, 0x9597, 0x9596, // 19440
-    0x9595, 0x9594, 0x9593, 0x9592, 0x9591, 0x9590, 0x958f, 0x958e, // 19448
-    0x958e, 0x958d, 0x958c, 0x958b, 0x958a, 0x9589, 0x9588, 0x9587, // 19456
-    0x9586, 0x9585, 0x9584, 0x9583, 0x9582, 0x9581, 0x9580, 0x957f, // 19464
-    0x957e, 0x957d, 0x957c, 0x957b, 0x957a, 0x9579, 0x9578, 0x9577, // 19472
-    0x9576, 0x9575, 0x9574, 0x9573, 0x9572, 0x9571, 0x9570, 0x956f, // 19480
-    0x956e, 0x956d, 0x956c, 0x956b, 0x956a, 0x9569, 0x9568, 0x9567, // 19488
-    0x9566, 0x9565, 0x9564, 0x9563, 0x9562, 0x9561, 0x9560, 0x9560, // 19496
-    0x955f, 0x955e, 0x955d, 0x955c, 0x955b, 0x955a, 0x9559, 0x9558, // 19504
-    0x9557, 0x9556, 0x9555, 0x9554, 0x9553, 0x9552, 0x9551, 0x9550, // 19512
-    0x954f, 0x954e, 0x954d, 0x954c, 0x954b, 0x954a, 0x9549, 0x9548, // 19520
-    0x9547, 0x9546, 0x9545, 0x9544, 0x9543, 0x9542, 0x9541, 0x9540, // 19528
-    0x953f, 0x953e, 0x953d, 0x953c, 0x953b, 0x953a, 0x9539, 0x9538, // 19536
-    0x9537, 0x9536, 0x9535, 0x9534, 0x9533, 0x9532, 0x9532, 0x9531, // 19544
-    0x9530, 0x952f, 0x952e, 0x952d, 0x952c, 0x952b, 0x952a, 0x9529, // 19552
-    0x9528, 0x9527, 0x9526, 0x9525, 0x9524, 0x9523, 0x9522, 0x9521, // 19560
-    0x9520, 0x951f, 0x951e, 0x951d, 0x951c, 0x951b, 0x951a, 0x9519, // 19568
-    0x9518, 0x9517, 0x9516, 0x9515, 0x9514, 0x9513, 0x9512, 0x9511, // 19576
-    0x9510, 0x950f, 0x950e, 0x950d, 0x950c, 0x950b, 0x950a, 0x9509, // 19584
-    0x9508, 0x9507, 0x9506, 0x9505, 0x9505, 0x9504, 0x9503, 0x9502, // 19592
-    0x9501, 0x9500, 0x94ff, 0x94fe, 0x94fd, 0x94fc, 0x94fb, 0x94fa, // 19600
-    0x94f9, 0x94f8, 0x94f7, 0x94f6, 0x94f5, 0x94f4, 0x94f3, 0x94f2, // 19608
-    0x94f1, 0x94f0, 0x94ef, 0x94ee, 0x94ed, 0x94ec, 0x94eb, 0x94ea, // 19616
-    0x94e9, 0x94e8, 0x94e7, 0x94e6, 0x94e5, 0x94e4, 0x94e3, 0x94e2, // 19624
-    0x94e1, 0x94e0, 0x94df, 0x94de, 0x94dd, 0x94dc, 0x94db, 0x94da, // 19632
-    0x94d9, 0x94d8, 0x94d7, 0x94d7, 0x94d6, 0x94d5, 0x94d4, 0x94d3, // 19640
-    0x94d2, 0x94d1, 0x94d0, 0x94cf, 0x94ce, 0x94cd, 0x94cc, 0x94cb, // 19648
-    0x94ca, 0x94c9, 0x94c8, 0x94c7, 0x94c6, 0x94c5, 0x94c4, 0x94c3, // 19656
-    0x94c2, 0x94c1, 0x94c0, 0x94bf, 0x94be, 0x94bd, 0x94bc, 0x94bb, // 19664
-    0x94ba, 0x94b9, 0x94b8, 0x94b7, 0x94b6, 0x94b5, 0x94b4, 0x94b3, // 19672
-    0x94b2, 0x94b1, 0x94b0, 0x94af, 0x94ae, 0x94ad, 0x94ac, 0x94ab, // 19680
-    0x94aa, 0x94aa, 0x94a9, 0x94a8, 0x94a7, 0x94a6, 0x94a5, 0x94a4, // 19688
-    0x94a3, 0x94a2, 0x94a1, 0x94a0, 0x949f, 0x949e, 0x949d, 0x949c, // 19696
-    0x949b, 0x949a, 0x9499, 0x9498, 0x9497, 0x9496, 0x9495, 0x9494, // 19704
-    0x9493, 0x9492, 0x9491, 0x9490, 0x948f, 0x948e, 0x948d, 0x948c, // 19712
-    0x948b, 0x948a, 0x9489, 0x9488, 0x9487, 0x9486, 0x9485, 0x9484, // 19720
-    0x9483, 0x9482, 0x9481, 0x9480, 0x947f, 0x947e, 0x947d, 0x947c, // 19728
-    0x947c, 0x947b, 0x947a, 0x9479, 0x9478, 0x9477, 0x9476, 0x9475, // 19736
-    0x9474, 0x9473, 0x9472, 0x9471, 0x9470, 0x946f, 0x946e, 0x946d, // 19744
-    0x946c, 0x946b, 0x946a, 0x9469, 0x9468, 0x9467, 0x9466, 0x9465, // 19752
-    0x9464, 0x9463, 0x9462, 0x9461, 0x9460, 0x945f, 0x945e, 0x945d, // 19760
-    0x945c, 0x945b, 0x945a, 0x9459, 0x9458, 0x9457, 0x9456, 0x9455, // 19768
-    0x9454, 0x9453, 0x9452, 0x9451, 0x9450, 0x944f, 0x944f, 0x944e, // 19776
-    0x944d, 0x944c, 0x944b, 0x944a, 0x9449, 0x9448, 0x9447, 0x9446, // 19784
-    0x9445, 0x9444, 0x9443, 0x9442, 0x9441, 0x9440, 0x943f, 0x943e, // 19792
-    0x943d, 0x943c, 0x943b, 0x943a, 0x9439, 0x9438, 0x9437, 0x9436, // 19800
-    0x9435, 0x9434, 0x9433, 0x9432, 0x9431, 0x9430, 0x942f, 0x942e, // 19808
-    0x942d, 0x942c, 0x942b, 0x942a, 0x9429, 0x9428, 0x9427, 0x9426, // 19816
-    0x9425, 0x9424, 0x9423, 0x9422, 0x9421, 0x9421, 0x9420, 0x941f, // 19824
-    0x941e, 0x941d, 0x941c, 0x941b, 0x941a, 0x9419, 0x9418, 0x9417, // 19832
-    0x9416, 0x9415, 0x9414, 0x9413, 0x9412, 0x9411, 0x9410, 0x940f, // 19840
-    0x940e, 0x940d, 0x940c, 0x940b, 0x940a, 0x9409, 0x9408, 0x9407, // 19848
-    0x9406, 0x9405, 0x9404, 0x9403, 0x9402, 0x9401, 0x9400, 0x93ff, // 19856
-    0x93fe, 0x93fd, 0x93fc, 0x93fb, 0x93fa, 0x93f9, 0x93f8, 0x93f7, // 19864
-    0x93f6, 0x93f5, 0x93f4, 0x93f4, 0x93f3, 0x93f2, 0x93f1, 0x93f0, // 19872
-    0x93ef, 0x93ee, 0x93ed, 0x93ec, 0x93eb, 0x93ea, 0x93e9, 0x93e8, // 19880
-    0x93e7, 0x93e6, 0x93e5, 0x93e4, 0x93e3, 0x93e2, 0x93e1, 0x93e0, // 19888
-    0x93df, 0x93de, 0x93dd, 0x93dc, 0x93db, 0x93da, 0x93d9, 0x93d8, // 19896
-    0x93d7, 0x93d6, 0x93d5, 0x93d4, 0x93d3, 0x93d2, 0x93d1, 0x93d0, // 19904
-    0x93cf, 0x93ce, 0x93cd, 0x93cc, 0x93cb, 0x93ca, 0x93c9, 0x93c8, // 19912
-    0x93c7, 0x93c6, 0x93c6, 0x93c5, 0x93c4, 0x93c3, 0x93c2, 0x93c1, // 19920
-    0x93c0, 0x93bf, 0x93be, 0x93bd, 0x93bc, 0x93bb, 0x93ba, 0x93b9, // 19928
-    0x93b8, 0x93b7, 0x93b6, 0x93b5, 0x93b4, 0x93b3, 0x93b2, 0x93b1, // 19936
-    0x93b0, 0x93af, 0x93ae, 0x93ad, 0x93ac, 0x93ab, 0x93aa, 0x93a9, // 19944
-    0x93a8, 0x93a7, 0x93a6, 0x93a5, 0x93a4, 0x93a3, 0x93a2, 0x93a1, // 19952
-    0x93a0, 0x939f, 0x939e, 0x939d, 0x939c, 0x939b, 0x939a, 0x9399, // 19960
-    0x9399, 0x9398, 0x9397, 0x9396, 0x9395, 0x9394, 0x9393, 0x9392, // 19968
-    0x9391, 0x9390, 0x938f, 0x938e, 0x938d, 0x938c, 0x938b, 0x938a, // 19976
-    0x9389, 0x9388, 0x9387, 0x9386, 0x9385, 0x9384, 0x9383, 0x9382, // 19984
-    0x9381, 0x9380, 0x937f, 0x937e, 0x937d, 0x937c, 0x937b, 0x937a, // 19992
-    0x9379, 0x9378, 0x9377, 0x9376, 0x9375, 0x9374, 0x9373, 0x9372, // 20000
-    0x9371, 0x9370, 0x936f, 0x936e, 0x936d, 0x936c, 0x936b, 0x936b, // 20008
-    0x936a, 0x9369, 0x9368, 0x9367, 0x9366, 0x9365, 0x9364, 0x9363, // 20016
-    0x9362, 0x9361, 0x9360, 0x935f, 0x935e, 0x935d, 0x935c, 0x935b, // 20024
-    0x935a, 0x9359, 0x9358, 0x9357, 0x9356, 0x9355, 0x9354, 0x9353, // 20032
-    0x9352, 0x9351, 0x9350, 0x934f, 0x934e, 0x934d, 0x934c, 0x934b, // 20040
-    0x934a, 0x9349, 0x9348, 0x9347, 0x9346, 0x9345, 0x9344, 0x9343, // 20048
-    0x9342, 0x9341, 0x9340, 0x933f, 0x933e, 0x933d, 0x933d, 0x933c, // 20056
-    0x933b, 0x933a, 0x9339, 0x9338, 0x9337, 0x9336, 0x9335, 0x9334, // 20064
-    0x9333, 0x9332, 0x9331, 0x9330, 0x932f, 0x932e, 0x932d, 0x932c, // 20072
-    0x932b, 0x932a, 0x9329, 0x9328, 0x9327, 0x9326, 0x9325, 0x9324, // 20080
-    0x9323, 0x9322, 0x9321, 0x9320, 0x931f, 0x931e, 0x931d, 0x931c, // 20088
-    0x931b, 0x931a, 0x9319, 0x9318, 0x9317, 0x9316, 0x9315, 0x9314, // 20096
-    0x9313, 0x9312, 0x9311, 0x9310, 0x9310, 0x930f, 0x930e, 0x930d, // 20104
-    0x930c, 0x930b, 0x930a, 0x9309, 0x9308, 0x9307, 0x9306, 0x9305, // 20112
-    0x9304, 0x9303, 0x9302, 0x9301, 0x9300, 0x92ff, 0x92fe, 0x92fd, // 20120
-    0x92fc, 0x92fb, 0x92fa, 0x92f9, 0x92f8, 0x92f7, 0x92f6, 0x92f5, // 20128
-    0x92f4, 0x92f3, 0x92f2, 0x92f1, 0x92f0, 0x92ef, 0x92ee, 0x92ed, // 20136
-    0x92ec, 0x92eb, 0x92ea, 0x92e9, 0x92e8, 0x92e7, 0x92e6, 0x92e5, // 20144
-    0x92e4, 0x92e3, 0x92e2, 0x92e2, 0x92e1, 0x92e0, 0x92df, 0x92de, // 20152
-    0x92dd, 0x92dc, 0x92db, 0x92da, 0x92d9, 0x92d8, 0x92d7, 0x92d6, // 20160
-    0x92d5, 0x92d4, 0x92d3, 0x92d2, 0x92d1, 0x92d0, 0x92cf, 0x92ce, // 20168
-    0x92cd, 0x92cc, 0x92cb, 0x92ca, 0x92c9, 0x92c8, 0x92c7, 0x92c6, // 20176
-    0x92c5, 0x92c4, 0x92c3, 0x92c2, 0x92c1, 0x92c0, 0x92bf, 0x92be, // 20184
-    0x92bd, 0x92bc, 0x92bb, 0x92ba, 0x92b9, 0x92b8, 0x92b7, 0x92b6, // 20192
-    0x92b5, 0x92b5, 0x92b4, 0x92b3, 0x92b2, 0x92b1, 0x92b0, 0x92af, // 20200
-    0x92ae, 0x92ad, 0x92ac, 0x92ab, 0x92aa, 0x92a9, 0x92a8, 0x92a7, // 20208
-    0x92a6, 0x92a5, 0x92a4, 0x92a3, 0x92a2, 0x92a1, 0x92a0, 0x929f, // 20216
-    0x929e, 0x929d, 0x929c, 0x929b, 0x929a, 0x9299, 0x9298, 0x9297, // 20224
-    0x9296, 0x9295, 0x9294, 0x9293, 0x9292, 0x9291, 0x9290, 0x928f, // 20232
-    0x928e, 0x928d, 0x928c, 0x928b, 0x928a, 0x9289, 0x9288, 0x9287, // 20240
-    0x9287, 0x9286, 0x9285, 0x9284, 0x9283, 0x9282, 0x9281, 0x9280, // 20248
-    0x927f, 0x927e, 0x927d, 0x927c, 0x927b, 0x927a, 0x9279, 0x9278, // 20256
-    0x9277, 0x9276, 0x9275, 0x9274, 0x9273, 0x9272, 0x9271, 0x9270, // 20264
-    0x926f, 0x926e, 0x926d, 0x926c, 0x926b, 0x926a, 0x9269, 0x9268, // 20272
-    0x9267, 0x9266, 0x9265, 0x9264, 0x9263, 0x9262, 0x9261, 0x9260, // 20280
-    0x925f, 0x925e, 0x925d, 0x925c, 0x925b, 0x925a, 0x925a, 0x9259, // 20288
-    0x9258, 0x9257, 0x9256, 0x9255, 0x9254, 0x9253, 0x9252, 0x9251, // 20296
-    0x9250, 0x924f, 0x924e, 0x924d, 0x924c, 0x924b, 0x924a, 0x9249, // 20304
-    0x9248, 0x9247, 0x9246, 0x9245, 0x9244, 0x9243, 0x9242, 0x9241, // 20312
-    0x9240, 0x923f, 0x923e, 0x923d, 0x923c, 0x923b, 0x923a, 0x9239, // 20320
-    0x9238, 0x9237, 0x9236, 0x9235, 0x9234, 0x9233, 0x9232, 0x9231, // 20328
-    0x9230, 0x922f, 0x922e, 0x922d, 0x922c, 0x922c, 0x922b, 0x922a, // 20336
-    0x9229, 0x9228, 0x9227, 0x9226, 0x9225, 0x9224, 0x9223, 0x9222, // 20344
-    0x9221, 0x9220, 0x921f, 0x921e, 0x921d, 0x921c, 0x921b, 0x921a, // 20352
-    0x9219, 0x9218, 0x9217, 0x9216, 0x9215, 0x9214, 0x9213, 0x9212, // 20360
-    0x9211, 0x9210, 0x920f, 0x920e, 0x920d, 0x920c, 0x920b, 0x920a, // 20368
-    0x9209, 0x9208, 0x9207, 0x9206, 0x9205, 0x9204, 0x9203, 0x9202, // 20376
-    0x9201, 0x9200, 0x91ff, 0x91ff, 0x91fe, 0x91fd, 0x91fc, 0x91fb, // 20384
-    0x91fa, 0x91f9, 0x91f8, 0x91f7, 0x91f6, 0x91f5, 0x91f4, 0x91f3, // 20392
-    0x91f2, 0x91f1, 0x91f0, 0x91ef, 0x91ee, 0x91ed, 0x91ec, 0x91eb, // 20400
-    0x91ea, 0x91e9, 0x91e8, 0x91e7, 0x91e6, 0x91e5, 0x91e4, 0x91e3, // 20408
-    0x91e2, 0x91e1, 0x91e0, 0x91df, 0x91de, 0x91dd, 0x91dc, 0x91db, // 20416
-    0x91da, 0x91d9, 0x91d8, 0x91d7, 0x91d6, 0x91d5, 0x91d4, 0x91d3, // 20424
-    0x91d2, 0x91d1, 0x91d1, 0x91d0, 0x91cf, 0x91ce, 0x91cd, 0x91cc, // 20432
-    0x91cb, 0x91ca, 0x91c9, 0x91c8, 0x91c7, 0x91c6, 0x91c5, 0x91c4, // 20440
-    0x91c3, 0x91c2, 0x91c1, 0x91c0, 0x91bf, 0x91be, 0x91bd, 0x91bc, // 20448
-    0x91bb, 0x91ba, 0x91b9, 0x91b8, 0x91b7, 0x91b6, 0x91b5, 0x91b4, // 20456
-    0x91b3, 0x91b2, 0x91b1, 0x91b0, 0x91af, 0x91ae, 0x91ad, 0x91ac, // 20464
-    0x91ab, 0x91aa, 0x91a9, 0x91a8, 0x91a7, 0x91a6, 0x91a5, 0x91a4, // 20472
-    0x91a3, 0x91a2, 0x91a1, 0x91a0, 0x919f, 0x919e, 0x919d, 0x919c, // 20480
-    0x919b, 0x919a, 0x9199, 0x9198, 0x9197, 0x9196, 0x9195, 0x9194, // 20488
-    0x9194, 0x9193, 0x9192, 0x9191, 0x9190, 0x918f, 0x918e, 0x918d, // 20496
-    0x918c, 0x918b, 0x918a, 0x9189, 0x9188, 0x9187, 0x9186, 0x9185, // 20504
-    0x9184, 0x9183, 0x9182, 0x9181, 0x9181, 0x9180, 0x917f, 0x917e, // 20512
-    0x917d, 0x917c, 0x917b, 0x917a, 0x9179, 0x9178, 0x9177, 0x9176, // 20520
-    0x9175, 0x9174, 0x9173, 0x9172, 0x9171, 0x9170, 0x916f, 0x916e, // 20528
-    0x916d, 0x916d, 0x916c, 0x916b, 0x916a, 0x9169, 0x9168, 0x9167, // 20536
-    0x9166, 0x9165, 0x9164, 0x9163, 0x9162, 0x9161, 0x9160, 0x915f, // 20544
-    0x915e, 0x915d, 0x915c, 0x915b, 0x915a, 0x915a, 0x9159, 0x9158, // 20552
-    0x9157, 0x9156, 0x9155, 0x9154, 0x9153, 0x9152, 0x9151, 0x9150, // 20560
-    0x914f, 0x914e, 0x914d, 0x914c, 0x914b, 0x914a, 0x9149, 0x9148, // 20568
-    0x9147, 0x9146, 0x9146, 0x9145, 0x9144, 0x9143, 0x9142, 0x9141, // 20576
-    0x9140, 0x913f, 0x913e, 0x913d, 0x913c, 0x913b, 0x913a, 0x9139, // 20584
-    0x9138, 0x9137, 0x9136, 0x9135, 0x9134, 0x9133, 0x9133, 0x9132, // 20592
-    0x9131, 0x9130, 0x912f, 0x912e, 0x912d, 0x912c, 0x912b, 0x912a, // 20600
-    0x9129, 0x9128, 0x9127, 0x9126, 0x9125, 0x9124, 0x9123, 0x9122, // 20608
-    0x9121, 0x9120, 0x911f, 0x911f, 0x911e, 0x911d, 0x911c, 0x911b, // 20616
-    0x911a, 0x9119, 0x9118, 0x9117, 0x9116, 0x9115, 0x9114, 0x9113, // 20624
-    0x9112, 0x9111, 0x9110, 0x910f, 0x910e, 0x910d, 0x910c, 0x910c, // 20632
-    0x910b, 0x910a, 0x9109, 0x9108, 0x9107, 0x9106, 0x9105, 0x9104, // 20640
-    0x9103, 0x9102, 0x9101, 0x9100, 0x90ff, 0x90fe, 0x90fd, 0x90fc, // 20648
-    0x90fb, 0x90fa, 0x90f9, 0x90f8, 0x90f8, 0x90f7, 0x90f6, 0x90f5, // 20656
-    0x90f4, 0x90f3, 0x90f2, 0x90f1, 0x90f0, 0x90ef, 0x90ee, 0x90ed, // 20664
-    0x90ec, 0x90eb, 0x90ea, 0x90e9, 0x90e8, 0x90e7, 0x90e6, 0x90e5, // 20672
-    0x90e5, 0x90e4, 0x90e3, 0x90e2, 0x90e1, 0x90e0, 0x90df, 0x90de, // 20680
-    0x90dd, 0x90dc, 0x90db, 0x90da, 0x90d9, 0x90d8, 0x90d7, 0x90d6, // 20688
-    0x90d5, 0x90d4, 0x90d3, 0x90d2, 0x90d1, 0x90d1, 0x90d0, 0x90cf, // 20696
-    0x90ce, 0x90cd, 0x90cc, 0x90cb, 0x90ca, 0x90c9, 0x90c8, 0x90c7, // 20704
-    0x90c6, 0x90c5, 0x90c4, 0x90c3, 0x90c2, 0x90c1, 0x90c0, 0x90bf, // 20712
-    0x90be, 0x90be, 0x90bd, 0x90bc, 0x90bb, 0x90ba, 0x90b9, 0x90b8, // 20720
-    0x90b7, 0x90b6, 0x90b5, 0x90b4, 0x90b3, 0x90b2, 0x90b1, 0x90b0, // 20728
-    0x90af, 0x90ae, 0x90ad, 0x90ac, 0x90ab, 0x90aa, 0x90aa, 0x90a9, // 20736
-    0x90a8, 0x90a7, 0x90a6, 0x90a5, 0x90a4, 0x90a3, 0x90a2, 0x90a1, // 20744
-    0x90a0, 0x909f, 0x909e, 0x909d, 0x909c, 0x909b, 0x909a, 0x9099, // 20752
-    0x9098, 0x9097, 0x9097, 0x9096, 0x9095, 0x9094, 0x9093, 0x9092, // 20760
-    0x9091, 0x9090, 0x908f, 0x908e, 0x908d, 0x908c, 0x908b, 0x908a, // 20768
-    0x9089, 0x9088, 0x9087, 0x9086, 0x9085, 0x9084, 0x9083, 0x9083, // 20776
-    0x9082, 0x9081, 0x9080, 0x907f, 0x907e, 0x907d, 0x907c, 0x907b, // 20784
-    0x907a, 0x9079, 0x9078, 0x9077, 0x9076, 0x9075, 0x9074, 0x9073, // 20792
-    0x9072, 0x9071, 0x9070, 0x9070, 0x906f, 0x906e, 0x906d, 0x906c, // 20800
-    0x906b, 0x906a, 0x9069, 0x9068, 0x9067, 0x9066, 0x9065, 0x9064, // 20808
-    0x9063, 0x9062, 0x9061, 0x9060, 0x905f, 0x905e, 0x905d, 0x905c, // 20816
-    0x905c, 0x905b, 0x905a, 0x9059, 0x9058, 0x9057, 0x9056, 0x9055, // 20824
-    0x9054, 0x9053, 0x9052, 0x9051, 0x9050, 0x904f, 0x904e, 0x904d, // 20832
-    0x904c, 0x904b, 0x904a, 0x9049, 0x9049, 0x9048, 0x9047, 0x9046, // 20840
-    0x9045, 0x9044, 0x9043, 0x9042, 0x9041, 0x9040, 0x903f, 0x903e, // 20848
-    0x903d, 0x903c, 0x903b, 0x903a, 0x9039, 0x9038, 0x9037, 0x9036, // 20856
-    0x9036, 0x9035, 0x9034, 0x9033, 0x9032, 0x9031, 0x9030, 0x902f, // 20864
-    0x902e, 0x902d, 0x902c, 0x902b, 0x902a, 0x9029, 0x9028, 0x9027, // 20872
-    0x9026, 0x9025, 0x9024, 0x9023, 0x9022, 0x9022, 0x9021, 0x9020, // 20880
-    0x901f, 0x901e, 0x901d, 0x901c, 0x901b, 0x901a, 0x9019, 0x9018, // 20888
-    0x9017, 0x9016, 0x9015, 0x9014, 0x9013, 0x9012, 0x9011, 0x9010, // 20896
-    0x900f, 0x900f, 0x900e, 0x900d, 0x900c, 0x900b, 0x900a, 0x9009, // 20904
-    0x9008, 0x9007, 0x9006, 0x9005, 0x9004, 0x9003, 0x9002, 0x9001, // 20912
-    0x9000, 0x8fff, 0x8ffe, 0x8ffd, 0x8ffc, 0x8ffb, 0x8ffb, 0x8ffa, // 20920
-    0x8ff9, 0x8ff8, 0x8ff7, 0x8ff6, 0x8ff5, 0x8ff4, 0x8ff3, 0x8ff2, // 20928
-    0x8ff1, 0x8ff0, 0x8fef, 0x8fee, 0x8fed, 0x8fec, 0x8feb, 0x8fea, // 20936
-    0x8fe9, 0x8fe8, 0x8fe8, 0x8fe7, 0x8fe6, 0x8fe5, 0x8fe4, 0x8fe3, // 20944
-    0x8fe2, 0x8fe1, 0x8fe0, 0x8fdf, 0x8fde, 0x8fdd, 0x8fdc, 0x8fdb, // 20952
-    0x8fda, 0x8fd9, 0x8fd8, 0x8fd7, 0x8fd6, 0x8fd5, 0x8fd4, 0x8fd4, // 20960
-    0x8fd3, 0x8fd2, 0x8fd1, 0x8fd0, 0x8fcf, 0x8fce, 0x8fcd, 0x8fcc, // 20968
-    0x8fcb, 0x8fca, 0x8fc9, 0x8fc8, 0x8fc7, 0x8fc6, 0x8fc5, 0x8fc4, // 20976
-    0x8fc3, 0x8fc2, 0x8fc1, 0x8fc1, 0x8fc0, 0x8fbf, 0x8fbe, 0x8fbd, // 20984
-    0x8fbc, 0x8fbb, 0x8fba, 0x8fb9, 0x8fb8, 0x8fb7, 0x8fb6, 0x8fb5, // 20992
-    0x8fb4, 0x8fb3, 0x8fb2, 0x8fb1, 0x8fb0, 0x8faf, 0x8fae, 0x8fad, // 21000
-    0x8fad, 0x8fac, 0x8fab, 0x8faa, 0x8fa9, 0x8fa8, 0x8fa7, 0x8fa6, // 21008
-    0x8fa5, 0x8fa4, 0x8fa3, 0x8fa2, 0x8fa1, 0x8fa0, 0x8f9f, 0x8f9e, // 21016
-    0x8f9d, 0x8f9c, 0x8f9b, 0x8f9a, 0x8f9a, 0x8f99, 0x8f98, 0x8f97, // 21024
-    0x8f96, 0x8f95, 0x8f94, 0x8f93, 0x8f92, 0x8f91, 0x8f90, 0x8f8f, // 21032
-    0x8f8e, 0x8f8d, 0x8f8c, 0x8f8b, 0x8f8a, 0x8f89, 0x8f88, 0x8f87, // 21040
-    0x8f86, 0x8f86, 0x8f85, 0x8f84, 0x8f83, 0x8f82, 0x8f81, 0x8f80, // 21048
-    0x8f7f, 0x8f7e, 0x8f7d, 0x8f7c, 0x8f7b, 0x8f7a, 0x8f79, 0x8f78, // 21056
-    0x8f77, 0x8f76, 0x8f75, 0x8f74, 0x8f73, 0x8f73, 0x8f72, 0x8f71, // 21064
-    0x8f70, 0x8f6f, 0x8f6e, 0x8f6d, 0x8f6c, 0x8f6b, 0x8f6a, 0x8f69, // 21072
-    0x8f68, 0x8f67, 0x8f66, 0x8f65, 0x8f64, 0x8f63, 0x8f62, 0x8f61, // 21080
-    0x8f60, 0x8f5f, 0x8f5f, 0x8f5e, 0x8f5d, 0x8f5c, 0x8f5b, 0x8f5a, // 21088
-    0x8f59, 0x8f58, 0x8f57, 0x8f56, 0x8f55, 0x8f54, 0x8f53, 0x8f52, // 21096
-    0x8f51, 0x8f50, 0x8f4f, 0x8f4e, 0x8f4d, 0x8f4c, 0x8f4c, 0x8f4b, // 21104
-    0x8f4a, 0x8f49, 0x8f48, 0x8f47, 0x8f46, 0x8f45, 0x8f44, 0x8f43, // 21112
-    0x8f42, 0x8f41, 0x8f40, 0x8f3f, 0x8f3e, 0x8f3d, 0x8f3c, 0x8f3b, // 21120
-    0x8f3a, 0x8f39, 0x8f38, 0x8f38, 0x8f37, 0x8f36, 0x8f35, 0x8f34, // 21128
-    0x8f33, 0x8f32, 0x8f31, 0x8f30, 0x8f2f, 0x8f2e, 0x8f2d, 0x8f2c, // 21136
-    0x8f2b, 0x8f2a, 0x8f29, 0x8f28, 0x8f27, 0x8f26, 0x8f25, 0x8f25, // 21144
-    0x8f24, 0x8f23, 0x8f22, 0x8f21, 0x8f20, 0x8f1f, 0x8f1e, 0x8f1d, // 21152
-    0x8f1c, 0x8f1b, 0x8f1a, 0x8f19, 0x8f18, 0x8f17, 0x8f16, 0x8f15, // 21160
-    0x8f14, 0x8f13, 0x8f12, 0x8f11, 0x8f11, 0x8f10, 0x8f0f, 0x8f0e, // 21168
-    0x8f0d, 0x8f0c, 0x8f0b, 0x8f0a, 0x8f09, 0x8f08, 0x8f07, 0x8f06, // 21176
-    0x8f05, 0x8f04, 0x8f03, 0x8f02, 0x8f01, 0x8f00, 0x8eff, 0x8efe, // 21184
-    0x8efe, 0x8efd, 0x8efc, 0x8efb, 0x8efa, 0x8ef9, 0x8ef8, 0x8ef7, // 21192
-    0x8ef6, 0x8ef5, 0x8ef4, 0x8ef3, 0x8ef2, 0x8ef1, 0x8ef0, 0x8eef, // 21200
-    0x8eee, 0x8eed, 0x8eec, 0x8eeb, 0x8eea, 0x8eea, 0x8ee9, 0x8ee8, // 21208
-    0x8ee7, 0x8ee6, 0x8ee5, 0x8ee4, 0x8ee3, 0x8ee2, 0x8ee1, 0x8ee0, // 21216
-    0x8edf, 0x8ede, 0x8edd, 0x8edc, 0x8edb, 0x8eda, 0x8ed9, 0x8ed8, // 21224
-    0x8ed7, 0x8ed7, 0x8ed6, 0x8ed5, 0x8ed4, 0x8ed3, 0x8ed2, 0x8ed1, // 21232
-    0x8ed0, 0x8ecf, 0x8ece, 0x8ecd, 0x8ecc, 0x8ecb, 0x8eca, 0x8ec9, // 21240
-    0x8ec8, 0x8ec7, 0x8ec6, 0x8ec5, 0x8ec4, 0x8ec3, 0x8ec3, 0x8ec2, // 21248
-    0x8ec1, 0x8ec0, 0x8ebf, 0x8ebe, 0x8ebd, 0x8ebc, 0x8ebb, 0x8eba, // 21256
-    0x8eb9, 0x8eb8, 0x8eb7, 0x8eb6, 0x8eb5, 0x8eb4, 0x8eb3, 0x8eb2, // 21264
-    0x8eb1, 0x8eb0, 0x8eb0, 0x8eaf, 0x8eae, 0x8ead, 0x8eac, 0x8eab, // 21272
-    0x8eaa, 0x8ea9, 0x8ea8, 0x8ea7, 0x8ea6, 0x8ea5, 0x8ea4, 0x8ea3, // 21280
-    0x8ea2, 0x8ea1, 0x8ea0, 0x8e9f, 0x8e9e, 0x8e9d, 0x8e9c, 0x8e9c, // 21288
-    0x8e9b, 0x8e9a, 0x8e99, 0x8e98, 0x8e97, 0x8e96, 0x8e95, 0x8e94, // 21296
-    0x8e93, 0x8e92, 0x8e91, 0x8e90, 0x8e8f, 0x8e8e, 0x8e8d, 0x8e8c, // 21304
-    0x8e8b, 0x8e8a, 0x8e89, 0x8e89, 0x8e88, 0x8e87, 0x8e86, 0x8e85, // 21312
-    0x8e84, 0x8e83, 0x8e82, 0x8e81, 0x8e80, 0x8e7f, 0x8e7e, 0x8e7d, // 21320
-    0x8e7c, 0x8e7b, 0x8e7a, 0x8e79, 0x8e78, 0x8e77, 0x8e76, 0x8e75, // 21328
-    0x8e75, 0x8e74, 0x8e73, 0x8e72, 0x8e71, 0x8e70, 0x8e6f, 0x8e6e, // 21336
-    0x8e6d, 0x8e6c, 0x8e6b, 0x8e6a, 0x8e69, 0x8e68, 0x8e67, 0x8e66, // 21344
-    0x8e65, 0x8e64, 0x8e63, 0x8e62, 0x8e62, 0x8e61, 0x8e60, 0x8e5f, // 21352
-    0x8e5e, 0x8e5d, 0x8e5c, 0x8e5b, 0x8e5a, 0x8e59, 0x8e58, 0x8e57, // 21360
-    0x8e56, 0x8e55, 0x8e54, 0x8e53, 0x8e52, 0x8e51, 0x8e50, 0x8e4f, // 21368
-    0x8e4f, 0x8e4e, 0x8e4d, 0x8e4c, 0x8e4b, 0x8e4a, 0x8e49, 0x8e48, // 21376
-    0x8e47, 0x8e46, 0x8e45, 0x8e44, 0x8e43, 0x8e42, 0x8e41, 0x8e40, // 21384
-    0x8e3f, 0x8e3e, 0x8e3d, 0x8e3c, 0x8e3b, 0x8e3b, 0x8e3a, 0x8e39, // 21392
-    0x8e38, 0x8e37, 0x8e36, 0x8e35, 0x8e34, 0x8e33, 0x8e32, 0x8e31, // 21400
-    0x8e30, 0x8e2f, 0x8e2e, 0x8e2d, 0x8e2c, 0x8e2b, 0x8e2a, 0x8e29, // 21408
-    0x8e28, 0x8e28, 0x8e27, 0x8e26, 0x8e25, 0x8e24, 0x8e23, 0x8e22, // 21416
-    0x8e21, 0x8e20, 0x8e1f, 0x8e1e, 0x8e1d, 0x8e1c, 0x8e1b, 0x8e1a, // 21424
-    0x8e19, 0x8e18, 0x8e17, 0x8e16, 0x8e15, 0x8e14, 0x8e14, 0x8e13, // 21432
-    0x8e12, 0x8e11, 0x8e10, 0x8e0f, 0x8e0e, 0x8e0d, 0x8e0c, 0x8e0b, // 21440
-    0x8e0a, 0x8e09, 0x8e08, 0x8e07, 0x8e06, 0x8e05, 0x8e04, 0x8e03, // 21448
-    0x8e02, 0x8e01, 0x8e01, 0x8e00, 0x8dff, 0x8dfe, 0x8dfd, 0x8dfc, // 21456
-    0x8dfb, 0x8dfa, 0x8df9, 0x8df8, 0x8df7, 0x8df6, 0x8df5, 0x8df4, // 21464
-    0x8df3, 0x8df2, 0x8df1, 0x8df0, 0x8def, 0x8dee, 0x8ded, 0x8ded, // 21472
-    0x8dec, 0x8deb, 0x8dea, 0x8de9, 0x8de8, 0x8de7, 0x8de6, 0x8de5, // 21480
-    0x8de4, 0x8de3, 0x8de2, 0x8de1, 0x8de0, 0x8ddf, 0x8dde, 0x8ddd, // 21488
-    0x8ddc, 0x8ddb, 0x8dda, 0x8dda, 0x8dd9, 0x8dd8, 0x8dd7, 0x8dd6, // 21496
-    0x8dd4, 0x8dd3, 0x8dd2, 0x8dd1, 0x8dd1, 0x8dd0, 0x8dcf, 0x8dce, // 21504
-    0x8dcd, 0x8dcc, 0x8dcb, 0x8dca, 0x8dc9, 0x8dc8, 0x8dc7, 0x8dc6, // 21512
-    0x8dc5, 0x8dc5, 0x8dc4, 0x8dc3, 0x8dc2, 0x8dc1, 0x8dc0, 0x8dbf, // 21520
-    0x8dbe, 0x8dbd, 0x8dbc, 0x8dbb, 0x8dba, 0x8db9, 0x8db9, 0x8db8, // 21528
-    0x8db7, 0x8db6, 0x8db5, 0x8db4, 0x8db3, 0x8db2, 0x8db1, 0x8db0, // 21536
-    0x8daf, 0x8dae, 0x8dad, 0x8dad, 0x8dac, 0x8dab, 0x8daa, 0x8da9, // 21544
-    0x8da8, 0x8da7, 0x8da6, 0x8da5, 0x8da4, 0x8da3, 0x8da2, 0x8da1, // 21552
-    0x8da1, 0x8da0, 0x8d9f, 0x8d9e, 0x8d9d, 0x8d9c, 0x8d9b, 0x8d9a, // 21560
-    0x8d99, 0x8d98, 0x8d97, 0x8d96, 0x8d95, 0x8d95, 0x8d94, 0x8d93, // 21568
-    0x8d92, 0x8d91, 0x8d90, 0x8d8f, 0x8d8e, 0x8d8d, 0x8d8c, 0x8d8b, // 21576
-    0x8d8a, 0x8d89, 0x8d88, 0x8d88, 0x8d87, 0x8d86, 0x8d85, 0x8d84, // 21584
-    0x8d83, 0x8d82, 0x8d81, 0x8d80, 0x8d7f, 0x8d7e, 0x8d7d, 0x8d7c, // 21592
-    0x8d7c, 0x8d7b, 0x8d7a, 0x8d79, 0x8d78, 0x8d77, 0x8d76, 0x8d75, // 21600
-    0x8d74, 0x8d73, 0x8d72, 0x8d71, 0x8d70, 0x8d70, 0x8d6f, 0x8d6e, // 21608
-    0x8d6d, 0x8d6c, 0x8d6b, 0x8d6a, 0x8d69, 0x8d68, 0x8d67, 0x8d66, // 21616
-    0x8d65, 0x8d64, 0x8d64, 0x8d63, 0x8d62, 0x8d61, 0x8d60, 0x8d5f, // 21624
-    0x8d5e, 0x8d5d, 0x8d5c, 0x8d5b, 0x8d5a, 0x8d59, 0x8d58, 0x8d58, // 21632
-    0x8d57, 0x8d56, 0x8d55, 0x8d54, 0x8d53, 0x8d52, 0x8d51, 0x8d50, // 21640
-    0x8d4f, 0x8d4e, 0x8d4d, 0x8d4c, 0x8d4c, 0x8d4b, 0x8d4a, 0x8d49, // 21648
-    0x8d48, 0x8d47, 0x8d46, 0x8d45, 0x8d44, 0x8d43, 0x8d42, 0x8d41, // 21656
-    0x8d40, 0x8d40, 0x8d3f, 0x8d3e, 0x8d3d, 0x8d3c, 0x8d3b, 0x8d3a, // 21664
-    0x8d39, 0x8d38, 0x8d37, 0x8d36, 0x8d35, 0x8d34, 0x8d34, 0x8d33, // 21672
-    0x8d32, 0x8d31, 0x8d30, 0x8d2f, 0x8d2e, 0x8d2d, 0x8d2c, 0x8d2b, // 21680
-    0x8d2a, 0x8d29, 0x8d28, 0x8d27, 0x8d27, 0x8d26, 0x8d25, 0x8d24, // 21688
-    0x8d23, 0x8d22, 0x8d21, 0x8d20, 0x8d1f, 0x8d1e, 0x8d1d, 0x8d1c, // 21696
-    0x8d1b, 0x8d1b, 0x8d1a, 0x8d19, 0x8d18, 0x8d17, 0x8d16, 0x8d15, // 21704
-    0x8d14, 0x8d13, 0x8d12, 0x8d11, 0x8d10, 0x8d0f, 0x8d0f, 0x8d0e, // 21712
-    0x8d0d, 0x8d0c, 0x8d0b, 0x8d0a, 0x8d09, 0x8d08, 0x8d07, 0x8d06, // 21720
-    0x8d05, 0x8d04, 0x8d03, 0x8d03, 0x8d02, 0x8d01, 0x8d00, 0x8cff, // 21728
-    0x8cfe, 0x8cfd, 0x8cfc, 0x8cfb, 0x8cfa, 0x8cf9, 0x8cf8, 0x8cf7, // 21736
-    0x8cf7, 0x8cf6, 0x8cf5, 0x8cf4, 0x8cf3, 0x8cf2, 0x8cf1, 0x8cf0, // 21744
-    0x8cef, 0x8cee, 0x8ced, 0x8cec, 0x8ceb, 0x8ceb, 0x8cea, 0x8ce9, // 21752
-    0x8ce8, 0x8ce7, 0x8ce6, 0x8ce5, 0x8ce4, 0x8ce3, 0x8ce2, 0x8ce1, // 21760
-    0x8ce0, 0x8cdf, 0x8cdf, 0x8cde, 0x8cdd, 0x8cdc, 0x8cdb, 0x8cda, // 21768
-    0x8cd9, 0x8cd8, 0x8cd7, 0x8cd6, 0x8cd5, 0x8cd4, 0x8cd3, 0x8cd3, // 21776
-    0x8cd2, 0x8cd1, 0x8cd0, 0x8ccf, 0x8cce, 0x8ccd, 0x8ccc, 0x8ccb, // 21784
-    0x8cca, 0x8cc9, 0x8cc8, 0x8cc7, 0x8cc6, 0x8cc6, 0x8cc5, 0x8cc4, // 21792
-    0x8cc3, 0x8cc2, 0x8cc1, 0x8cc0, 0x8cbf, 0x8cbe, 0x8cbd, 0x8cbc, // 21800
-    0x8cbb, 0x8cba, 0x8cba, 0x8cb9, 0x8cb8, 0x8cb7, 0x8cb6, 0x8cb5, // 21808
-    0x8cb4, 0x8cb3, 0x8cb2, 0x8cb1, 0x8cb0, 0x8caf, 0x8cae, 0x8cae, // 21816
-    0x8cad, 0x8cac, 0x8cab, 0x8caa, 0x8ca9, 0x8ca8, 0x8ca7, 0x8ca6, // 21824
-    0x8ca5, 0x8ca4, 0x8ca3, 0x8ca2, 0x8ca2, 0x8ca1, 0x8ca0, 0x8c9f, // 21832
-    0x8c9e, 0x8c9d, 0x8c9c, 0x8c9b, 0x8c9a, 0x8c99, 0x8c98, 0x8c97, // 21840
-    0x8c96, 0x8c96, 0x8c95, 0x8c94, 0x8c93, 0x8c92, 0x8c91, 0x8c90, // 21848
-    0x8c8f, 0x8c8e, 0x8c8d, 0x8c8c, 0x8c8b, 0x8c8a, 0x8c8a, 0x8c89, // 21856
-    0x8c88, 0x8c87, 0x8c86, 0x8c85, 0x8c84, 0x8c83, 0x8c82, 0x8c81, // 21864
-    0x8c80, 0x8c7f, 0x8c7e, 0x8c7e, 0x8c7d, 0x8c7c, 0x8c7b, 0x8c7a, // 21872
-    0x8c79, 0x8c78, 0x8c77, 0x8c76, 0x8c75, 0x8c74, 0x8c73, 0x8c72, // 21880
-    0x8c72, 0x8c71, 0x8c70, 0x8c6f, 0x8c6e, 0x8c6d, 0x8c6c, 0x8c6b, // 21888
-    0x8c6a, 0x8c69, 0x8c68, 0x8c67, 0x8c66, 0x8c65, 0x8c65, 0x8c64, // 21896
-    0x8c63, 0x8c62, 0x8c61, 0x8c60, 0x8c5f, 0x8c5e, 0x8c5d, 0x8c5c, // 21904
-    0x8c5b, 0x8c5a, 0x8c59, 0x8c59, 0x8c58, 0x8c57, 0x8c56, 0x8c55, // 21912
-    0x8c54, 0x8c53, 0x8c52, 0x8c51, 0x8c50, 0x8c4f, 0x8c4e, 0x8c4d, // 21920
-    0x8c4d, 0x8c4c, 0x8c4b, 0x8c4a, 0x8c49, 0x8c48, 0x8c47, 0x8c46, // 21928
-    0x8c45, 0x8c44, 0x8c43, 0x8c42, 0x8c41, 0x8c41, 0x8c40, 0x8c3f, // 21936
-    0x8c3e, 0x8c3d, 0x8c3c, 0x8c3b, 0x8c3a, 0x8c39, 0x8c38, 0x8c37, // 21944
-    0x8c36, 0x8c35, 0x8c35, 0x8c34, 0x8c33, 0x8c32, 0x8c31, 0x8c30, // 21952
-    0x8c2f, 0x8c2e, 0x8c2d, 0x8c2c, 0x8c2b, 0x8c2a, 0x8c29, 0x8c29, // 21960
-    0x8c28, 0x8c27, 0x8c26, 0x8c25, 0x8c24, 0x8c23, 0x8c22, 0x8c21, // 21968
-    0x8c20, 0x8c1f, 0x8c1e, 0x8c1d, 0x8c1d, 0x8c1c, 0x8c1b, 0x8c1a, // 21976
-    0x8c19, 0x8c18, 0x8c17, 0x8c16, 0x8c15, 0x8c14, 0x8c13, 0x8c12, // 21984
-    0x8c11, 0x8c10, 0x8c10, 0x8c0f, 0x8c0e, 0x8c0d, 0x8c0c, 0x8c0b, // 21992
-    0x8c0a, 0x8c09, 0x8c08, 0x8c07, 0x8c06, 0x8c05, 0x8c04, 0x8c04, // 22000
-    0x8c03, 0x8c02, 0x8c01, 0x8c00, 0x8bff, 0x8bfe, 0x8bfd, 0x8bfc, // 22008
-    0x8bfb, 0x8bfa, 0x8bf9, 0x8bf8, 0x8bf8, 0x8bf7, 0x8bf6, 0x8bf5, // 22016
-    0x8bf4, 0x8bf3, 0x8bf2, 0x8bf1, 0x8bf0, 0x8bef, 0x8bee, 0x8bed, // 22024
-    0x8bec, 0x8bec, 0x8beb, 0x8bea, 0x8be9, 0x8be8, 0x8be7, 0x8be6, // 22032
-    0x8be5, 0x8be4, 0x8be3, 0x8be2, 0x8be1, 0x8be0, 0x8be0, 0x8bdf, // 22040
-    0x8bde, 0x8bdd, 0x8bdc, 0x8bdb, 0x8bda, 0x8bd9, 0x8bd8, 0x8bd7, // 22048
-    0x8bd6, 0x8bd5, 0x8bd4, 0x8bd4, 0x8bd3, 0x8bd2, 0x8bd1, 0x8bd0, // 22056
-    0x8bcf, 0x8bce, 0x8bcd, 0x8bcc, 0x8bcb, 0x8bca, 0x8bc9, 0x8bc8, // 22064
-    0x8bc8, 0x8bc7, 0x8bc6, 0x8bc5, 0x8bc4, 0x8bc3, 0x8bc2, 0x8bc1, // 22072
-    0x8bc0, 0x8bbf, 0x8bbe, 0x8bbd, 0x8bbc, 0x8bbc, 0x8bbb, 0x8bba, // 22080
-    0x8bb9, 0x8bb8, 0x8bb7, 0x8bb6, 0x8bb5, 0x8bb4, 0x8bb3, 0x8bb2, // 22088
-    0x8bb1, 0x8bb0, 0x8baf, 0x8baf, 0x8bae, 0x8bad, 0x8bac, 0x8bab, // 22096
-    0x8baa, 0x8ba9, 0x8ba8, 0x8ba7, 0x8ba6, 0x8ba5, 0x8ba4, 0x8ba3, // 22104
-    0x8ba3, 0x8ba2, 0x8ba1, 0x8ba0, 0x8b9f, 0x8b9e, 0x8b9d, 0x8b9c, // 22112
-    0x8b9b, 0x8b9a, 0x8b99, 0x8b98, 0x8b97, 0x8b97, 0x8b96, 0x8b95, // 22120
-    0x8b94, 0x8b93, 0x8b92, 0x8b91, 0x8b90, 0x8b8f, 0x8b8e, 0x8b8d, // 22128
-    0x8b8c, 0x8b8b, 0x8b8b, 0x8b8a, 0x8b89, 0x8b88, 0x8b87, 0x8b86, // 22136
-    0x8b85, 0x8b84, 0x8b83, 0x8b82, 0x8b81, 0x8b80, 0x8b7f, 0x8b7f, // 22144
-    0x8b7e, 0x8b7d, 0x8b7c, 0x8b7b, 0x8b7a, 0x8b79, 0x8b78, 0x8b77, // 22152
-    0x8b76, 0x8b75, 0x8b74, 0x8b73, 0x8b73, 0x8b72, 0x8b71, 0x8b70, // 22160
-    0x8b6f, 0x8b6e, 0x8b6d, 0x8b6c, 0x8b6b, 0x8b6a, 0x8b69, 0x8b68, // 22168
-    0x8b67, 0x8b67, 0x8b66, 0x8b65, 0x8b64, 0x8b63, 0x8b62, 0x8b61, // 22176
-    0x8b60, 0x8b5f, 0x8b5e, 0x8b5d, 0x8b5c, 0x8b5b, 0x8b5b, 0x8b5a, // 22184
-    0x8b59, 0x8b58, 0x8b57, 0x8b56, 0x8b55, 0x8b54, 0x8b53, 0x8b52, // 22192
-    0x8b51, 0x8b50, 0x8b4f, 0x8b4e, 0x8b4e, 0x8b4d, 0x8b4c, 0x8b4b, // 22200
-    0x8b4a, 0x8b49, 0x8b48, 0x8b47, 0x8b46, 0x8b45, 0x8b44, 0x8b43, // 22208
-    0x8b42, 0x8b42, 0x8b41, 0x8b40, 0x8b3f, 0x8b3e, 0x8b3d, 0x8b3c, // 22216
-    0x8b3b, 0x8b3a, 0x8b39, 0x8b38, 0x8b37, 0x8b36, 0x8b36, 0x8b35, // 22224
-    0x8b34, 0x8b33, 0x8b32, 0x8b31, 0x8b30, 0x8b2f, 0x8b2e, 0x8b2d, // 22232
-    0x8b2c, 0x8b2b, 0x8b2a, 0x8b2a, 0x8b29, 0x8b28, 0x8b27, 0x8b26, // 22240
-    0x8b25, 0x8b24, 0x8b23, 0x8b22, 0x8b21, 0x8b20, 0x8b1f, 0x8b1e, // 22248
-    0x8b1e, 0x8b1d, 0x8b1c, 0x8b1b, 0x8b1a, 0x8b19, 0x8b18, 0x8b17, // 22256
-    0x8b16, 0x8b15, 0x8b14, 0x8b13, 0x8b12, 0x8b12, 0x8b11, 0x8b10, // 22264
-    0x8b0f, 0x8b0e, 0x8b0d, 0x8b0c, 0x8b0b, 0x8b0a, 0x8b09, 0x8b08, // 22272
-    0x8b07, 0x8b06, 0x8b06, 0x8b05, 0x8b04, 0x8b03, 0x8b02, 0x8b01, // 22280
-    0x8b00, 0x8aff, 0x8afe, 0x8afd, 0x8afc, 0x8afb, 0x8afa, 0x8afa, // 22288
-    0x8af9, 0x8af8, 0x8af7, 0x8af6, 0x8af5, 0x8af4, 0x8af3, 0x8af2, // 22296
-    0x8af1, 0x8af0, 0x8aef, 0x8aee, 0x8aed, 0x8aed, 0x8aec, 0x8aeb, // 22304
-    0x8aea, 0x8ae9, 0x8ae8, 0x8ae7, 0x8ae6, 0x8ae5, 0x8ae4, 0x8ae3, // 22312
-    0x8ae2, 0x8ae1, 0x8ae1, 0x8ae0, 0x8adf, 0x8ade, 0x8add, 0x8adc, // 22320
-    0x8adb, 0x8ada, 0x8ad9, 0x8ad8, 0x8ad7, 0x8ad6, 0x8ad5, 0x8ad5, // 22328
-    0x8ad4, 0x8ad3, 0x8ad2, 0x8ad1, 0x8ad0, 0x8acf, 0x8ace, 0x8acd, // 22336
-    0x8acc, 0x8acb, 0x8aca, 0x8ac9, 0x8ac9, 0x8ac8, 0x8ac7, 0x8ac6, // 22344
-    0x8ac5, 0x8ac4, 0x8ac3, 0x8ac2, 0x8ac1, 0x8ac0, 0x8abf, 0x8abe, // 22352
-    0x8abd, 0x8abd, 0x8abc, 0x8abb, 0x8aba, 0x8ab9, 0x8ab8, 0x8ab7, // 22360
-    0x8ab6, 0x8ab5, 0x8ab4, 0x8ab3, 0x8ab2, 0x8ab1, 0x8ab1, 0x8ab0, // 22368
-    0x8aaf, 0x8aae, 0x8aad, 0x8aac, 0x8aab, 0x8aaa, 0x8aa9, 0x8aa8, // 22376
-    0x8aa7, 0x8aa6, 0x8aa5, 0x8aa5, 0x8aa4, 0x8aa3, 0x8aa2, 0x8aa1, // 22384
-    0x8aa0, 0x8a9f, 0x8a9e, 0x8a9d, 0x8a9c, 0x8a9b, 0x8a9a, 0x8a99, // 22392
-    0x8a99, 0x8a98, 0x8a97, 0x8a96, 0x8a95, 0x8a94, 0x8a93, 0x8a92, // 22400
-    0x8a91, 0x8a90, 0x8a8f, 0x8a8e, 0x8a8d, 0x8a8c, 0x8a8c, 0x8a8b, // 22408
-    0x8a8a, 0x8a89, 0x8a88, 0x8a87, 0x8a86, 0x8a85, 0x8a84, 0x8a83, // 22416
-    0x8a82, 0x8a81, 0x8a80, 0x8a80, 0x8a7f, 0x8a7e, 0x8a7d, 0x8a7c, // 22424
-    0x8a7b, 0x8a7a, 0x8a79, 0x8a78, 0x8a77, 0x8a76, 0x8a75, 0x8a74, // 22432
-    0x8a74, 0x8a73, 0x8a72, 0x8a71, 0x8a70, 0x8a6f, 0x8a6e, 0x8a6d, // 22440
-    0x8a6c, 0x8a6b, 0x8a6a, 0x8a69, 0x8a68, 0x8a68, 0x8a67, 0x8a66, // 22448
-    0x8a65, 0x8a64, 0x8a63, 0x8a62, 0x8a61, 0x8a60, 0x8a5f, 0x8a5e, // 22456
-    0x8a5d, 0x8a5c, 0x8a5c, 0x8a5b, 0x8a5a, 0x8a59, 0x8a58, 0x8a57, // 22464
-    0x8a56, 0x8a55, 0x8a54, 0x8a53, 0x8a52, 0x8a51, 0x8a50, 0x8a50, // 22472
-    0x8a4f, 0x8a4e, 0x8a4d, 0x8a4c, 0x8a4b, 0x8a4a, 0x8a49, 0x8a48, // 22480
-    0x8a47, 0x8a46, 0x8a45, 0x8a44, 0x8a44, 0x8a43, 0x8a42, 0x8a41, // 22488
-    0x8a40, 0x8a3f, 0x8a3e, 0x8a3d, 0x8a3c, 0x8a3b, 0x8a3a, 0x8a39, // 22496
-    0x8a38, 0x8a37, 0x8a37, 0x8a36, 0x8a35, 0x8a34, 0x8a33, 0x8a32, // 22504
-    0x8a31, 0x8a30, 0x8a2f, 0x8a2e, 0x8a2d, 0x8a2c, 0x8a2b, 0x8a2b, // 22512
-    0x8a2a, 0x8a29, 0x8a28, 0x8a27, 0x8a26, 0x8a25, 0x8a24, 0x8a23, // 22520
-    0x8a22, 0x8a21, 0x8a20, 0x8a1f, 0x8a1e, 0x8a1d, 0x8a1c, 0x8a1b, // 22528
-    0x8a1a, 0x8a19, 0x8a18, 0x8a18, 0x8a17, 0x8a16, 0x8a15, 0x8a14, // 22536
-    0x8a13, 0x8a12, 0x8a11, 0x8a10, 0x8a0f, 0x8a0f, 0x8a0e, 0x8a0d, // 22544
-    0x8a0c, 0x8a0b, 0x8a0a, 0x8a09, 0x8a08, 0x8a07, 0x8a06, 0x8a06, // 22552
-    0x8a05, 0x8a04, 0x8a03, 0x8a02, 0x8a01, 0x8a00, 0x89ff, 0x89fe, // 22560
-    0x89fd, 0x89fd, 0x89fc, 0x89fb, 0x89fa, 0x89f9, 0x89f8, 0x89f7, // 22568
-    0x89f6, 0x89f5, 0x89f4, 0x89f4, 0x89f3, 0x89f2, 0x89f1, 0x89f0, // 22576
-    0x89ef, 0x89ee, 0x89ed, 0x89ec, 0x89eb, 0x89eb, 0x89ea, 0x89e9, // 22584
-    0x89e8, 0x89e7, 0x89e6, 0x89e5, 0x89e4, 0x89e3, 0x89e2, 0x89e2, // 22592
-    0x89e1, 0x89e0, 0x89df, 0x89de, 0x89dd, 0x89dc, 0x89db, 0x89da, // 22600
-    0x89d9, 0x89d9, 0x89d8, 0x89d7, 0x89d6, 0x89d5, 0x89d4, 0x89d3, // 22608
-    0x89d2, 0x89d1, 0x89d0, 0x89d0, 0x89cf, 0x89ce, 0x89cd, 0x89cc, // 22616
-    0x89cb, 0x89ca, 0x89c9, 0x89c8, 0x89c7, 0x89c7, 0x89c6, 0x89c5, // 22624
-    0x89c4, 0x89c3, 0x89c2, 0x89c1, 0x89c0, 0x89bf, 0x89be, 0x89be, // 22632
-    0x89bd, 0x89bc, 0x89bb, 0x89ba, 0x89b9, 0x89b8, 0x89b7, 0x89b6, // 22640
-    0x89b5, 0x89b5, 0x89b4, 0x89b3, 0x89b2, 0x89b1, 0x89b0, 0x89af, // 22648
-    0x89ae, 0x89ad, 0x89ac, 0x89ac, 0x89ab, 0x89aa, 0x89a9, 0x89a8, // 22656
-    0x89a7, 0x89a6, 0x89a5, 0x89a4, 0x89a3, 0x89a3, 0x89a2, 0x89a1, // 22664
-    0x89a0, 0x899f, 0x899e, 0x899d, 0x899c, 0x899b, 0x899a, 0x899a, // 22672
-    0x8999, 0x8998, 0x8997, 0x8996, 0x8995, 0x8994, 0x8993, 0x8992, // 22680
-    0x8991, 0x8991, 0x8990, 0x898f, 0x898e, 0x898d, 0x898c, 0x898b, // 22688
-    0x898a, 0x8989, 0x8988, 0x8988, 0x8987, 0x8986, 0x8985, 0x8984, // 22696
-    0x8983, 0x8982, 0x8981, 0x8980, 0x897f, 0x897f, 0x897e, 0x897d, // 22704
-    0x897c, 0x897b, 0x897a, 0x8979, 0x8978, 0x8977, 0x8976, 0x8976, // 22712
-    0x8975, 0x8974, 0x8973, 0x8972, 0x8971, 0x8970, 0x896f, 0x896e, // 22720
-    0x896d, 0x896d, 0x896c, 0x896b, 0x896a, 0x8969, 0x8968, 0x8967, // 22728
-    0x8966, 0x8965, 0x8964, 0x8964, 0x8963, 0x8962, 0x8961, 0x8960, // 22736
-    0x895f, 0x895e, 0x895d, 0x895c, 0x895b, 0x895b, 0x895a, 0x8959, // 22744
-    0x8958, 0x8957, 0x8956, 0x8955, 0x8954, 0x8953, 0x8952, 0x8952, // 22752
-    0x8951, 0x8950, 0x894f, 0x894e, 0x894d, 0x894c, 0x894b, 0x894a, // 22760
-    0x8949, 0x8949, 0x8948, 0x8947, 0x8946, 0x8945, 0x8944, 0x8943, // 22768
-    0x8942, 0x8941, 0x8940, 0x8940, 0x893f, 0x893e, 0x893d, 0x893c, // 22776
-    0x893b, 0x893a, 0x8939, 0x8938, 0x8937, 0x8936, 0x8936, 0x8935, // 22784
-    0x8934, 0x8933, 0x8932, 0x8931, 0x8930, 0x892f, 0x892e, 0x892d, // 22792
-    0x892d, 0x892c, 0x892b, 0x892a, 0x8929, 0x8928, 0x8927, 0x8926, // 22800
-    0x8925, 0x8924, 0x8924, 0x8923, 0x8922, 0x8921, 0x8920, 0x891f, // 22808
-    0x891e, 0x891d, 0x891c, 0x891b, 0x891b, 0x891a, 0x8919, 0x8918, // 22816
-    0x8917, 0x8916, 0x8915, 0x8914, 0x8913, 0x8912, 0x8912, 0x8911, // 22824
-    0x8910, 0x890f, 0x890e, 0x890d, 0x890c, 0x890b, 0x890a, 0x8909, // 22832
-    0x8909, 0x8908, 0x8907, 0x8906, 0x8905, 0x8904, 0x8903, 0x8902, // 22840
-    0x8901, 0x8900, 0x8900, 0x88ff, 0x88fe, 0x88fd, 0x88fc, 0x88fb, // 22848
-    0x88fa, 0x88f9, 0x88f8, 0x88f7, 0x88f7, 0x88f6, 0x88f5, 0x88f4, // 22856
-    0x88f3, 0x88f2, 0x88f1, 0x88f0, 0x88ef, 0x88ee, 0x88ee, 0x88ed, // 22864
-    0x88ec, 0x88eb, 0x88ea, 0x88e9, 0x88e8, 0x88e7, 0x88e6, 0x88e5, // 22872
-    0x88e5, 0x88e4, 0x88e3, 0x88e2, 0x88e1, 0x88e0, 0x88df, 0x88de, // 22880
-    0x88dd, 0x88dc, 0x88dc, 0x88db, 0x88da, 0x88d9, 0x88d8, 0x88d7, // 22888
-    0x88d6, 0x88d5, 0x88d4, 0x88d3, 0x88d3, 0x88d2, 0x88d1, 0x88d0, // 22896
-    0x88cf, 0x88ce, 0x88cd, 0x88cc, 0x88cb, 0x88ca, 0x88ca, 0x88c9, // 22904
-    0x88c8, 0x88c7, 0x88c6, 0x88c5, 0x88c4, 0x88c3, 0x88c2, 0x88c1, // 22912
-    0x88c1, 0x88c0, 0x88bf, 0x88be, 0x88bd, 0x88bc, 0x88bb, 0x88ba, // 22920
-    0x88b9, 0x88b8, 0x88b8, 0x88b7, 0x88b6, 0x88b5, 0x88b4, 0x88b3, // 22928
-    0x88b2, 0x88b1, 0x88b0, 0x88af, 0x88af, 0x88ae, 0x88ad, 0x88ac, // 22936
-    0x88ab, 0x88aa, 0x88a9, 0x88a8, 0x88a7, 0x88a6, 0x88a6, 0x88a5, // 22944
-    0x88a4, 0x88a3, 0x88a2, 0x88a1, 0x88a0, 0x889f, 0x889e, 0x889d, // 22952
-    0x889d, 0x889c, 0x889b, 0x889a, 0x8899, 0x8898, 0x8897, 0x8896, // 22960
-    0x8895, 0x8894, 0x8894, 0x8893, 0x8892, 0x8891, 0x8890, 0x888f, // 22968
-    0x888e, 0x888d, 0x888c, 0x888b, 0x888b, 0x888a, 0x8889, 0x8888, // 22976
-    0x8887, 0x8886, 0x8885, 0x8884, 0x8883, 0x8882, 0x8882, 0x8881, // 22984
-    0x8880, 0x887f, 0x887e, 0x887d, 0x887c, 0x887b, 0x887a, 0x8879, // 22992
-    0x8879, 0x8878, 0x8877, 0x8876, 0x8875, 0x8874, 0x8873, 0x8872, // 23000
-    0x8871, 0x8870, 0x8870, 0x886f, 0x886e, 0x886d, 0x886c, 0x886b, // 23008
-    0x886a, 0x8869, 0x8868, 0x8867, 0x8867, 0x8866, 0x8865, 0x8864, // 23016
-    0x8863, 0x8862, 0x8861, 0x8860, 0x885f, 0x885e, 0x885e, 0x885d, // 23024
-    0x885c, 0x885b, 0x885a, 0x8859, 0x8858, 0x8857, 0x8856, 0x8855, // 23032
-    0x8855, 0x8854, 0x8853, 0x8852, 0x8851, 0x8850, 0x884f, 0x884e, // 23040
-    0x884d, 0x884c, 0x884b, 0x884b, 0x884a, 0x8849, 0x8848, 0x8847, // 23048
-    0x8846, 0x8845, 0x8844, 0x8843, 0x8842, 0x8842, 0x8841, 0x8840, // 23056
-    0x883f, 0x883e, 0x883d, 0x883c, 0x883b, 0x883a, 0x8839, 0x8839, // 23064
-    0x8838, 0x8837, 0x8836, 0x8835, 0x8834, 0x8833, 0x8832, 0x8831, // 23072
-    0x8830, 0x8830, 0x882f, 0x882e, 0x882d, 0x882c, 0x882b, 0x882a, // 23080
-    0x8829, 0x8828, 0x8827, 0x8827, 0x8826, 0x8825, 0x8824, 0x8823, // 23088
-    0x8822, 0x8821, 0x8820, 0x881f, 0x881e, 0x881e, 0x881d, 0x881c, // 23096
-    0x881b, 0x881a, 0x8819, 0x8818, 0x8817, 0x8816, 0x8815, 0x8815, // 23104
-    0x8814, 0x8813, 0x8812, 0x8811, 0x8810, 0x880f, 0x880e, 0x880d, // 23112
-    0x880c, 0x880c, 0x880b, 0x880a, 0x8809, 0x8808, 0x8807, 0x8806, // 23120
-    0x8805, 0x8804, 0x8803, 0x8803, 0x8802, 0x8801, 0x8800, 0x87ff, // 23128
-    0x87fe, 0x87fd, 0x87fc, 0x87fb, 0x87fa, 0x87fa, 0x87f9, 0x87f8, // 23136
-    0x87f7, 0x87f6, 0x87f5, 0x87f4, 0x87f3, 0x87f2, 0x87f1, 0x87f1, // 23144
-    0x87f0, 0x87ef, 0x87ee, 0x87ed, 0x87ec, 0x87eb, 0x87ea, 0x87e9, // 23152
-    0x87e8, 0x87e8, 0x87e7, 0x87e6, 0x87e5, 0x87e4, 0x87e3, 0x87e2, // 23160
-    0x87e1, 0x87e0, 0x87df, 0x87df, 0x87de, 0x87dd, 0x87dc, 0x87db, // 23168
-    0x87da, 0x87d9, 0x87d8, 0x87d7, 0x87d6, 0x87d6, 0x87d5, 0x87d4, // 23176
-    0x87d3, 0x87d2, 0x87d1, 0x87d0, 0x87cf, 0x87ce, 0x87cd, 0x87cd, // 23184
-    0x87cc, 0x87cb, 0x87ca, 0x87c9, 0x87c8, 0x87c7, 0x87c6, 0x87c5, // 23192
-    0x87c4, 0x87c4, 0x87c3, 0x87c2, 0x87c1, 0x87c0, 0x87bf, 0x87be, // 23200
-    0x87bd, 0x87bc, 0x87bb, 0x87bb, 0x87ba, 0x87b9, 0x87b8, 0x87b7, // 23208
-    0x87b6, 0x87b5, 0x87b4, 0x87b3, 0x87b2, 0x87b2, 0x87b1, 0x87b0, // 23216
-    0x87af, 0x87ae, 0x87ad, 0x87ac, 0x87ab, 0x87aa, 0x87a9, 0x87a9, // 23224
-    0x87a8, 0x87a7, 0x87a6, 0x87a5, 0x87a4, 0x87a3, 0x87a2, 0x87a1, // 23232
-    0x87a0, 0x87a0, 0x879f, 0x879e, 0x879d, 0x879c, 0x879b, 0x879a, // 23240
-    0x8799, 0x8798, 0x8797, 0x8797, 0x8796, 0x8795, 0x8794, 0x8793, // 23248
-    0x8792, 0x8791, 0x8790, 0x878f, 0x878e, 0x878e, 0x878d, 0x878c, // 23256
-    0x878b, 0x878a, 0x8789, 0x8788, 0x8787, 0x8786, 0x8785, 0x8785, // 23264
-    0x8784, 0x8783, 0x8782, 0x8781, 0x8780, 0x877f, 0x877e, 0x877d, // 23272
-    0x877c, 0x877c, 0x877b, 0x877a, 0x8779, 0x8778, 0x8777, 0x8776, // 23280
-    0x8775, 0x8774, 0x8773, 0x8773, 0x8772, 0x8771, 0x8770, 0x876f, // 23288
-    0x876e, 0x876d, 0x876c, 0x876b, 0x876a, 0x8769, 0x8769, 0x8768, // 23296
-    0x8767, 0x8766, 0x8765, 0x8764, 0x8763, 0x8762, 0x8761, 0x8760, // 23304
-    0x8760, 0x875f, 0x875e, 0x875d, 0x875c, 0x875b, 0x875a, 0x8759, // 23312
-    0x8758, 0x8757, 0x8757, 0x8756, 0x8755, 0x8754, 0x8753, 0x8752, // 23320
-    0x8751, 0x8750, 0x874f, 0x874e, 0x874e, 0x874d, 0x874c, 0x874b, // 23328
-    0x874a, 0x8749, 0x8748, 0x8747, 0x8746, 0x8745, 0x8745, 0x8744, // 23336
-    0x8743, 0x8742, 0x8741, 0x8740, 0x873f, 0x873e, 0x873d, 0x873c, // 23344
-    0x873c, 0x873b, 0x873a, 0x8739, 0x8738, 0x8737, 0x8736, 0x8735, // 23352
-    0x8734, 0x8733, 0x8733, 0x8732, 0x8731, 0x8730, 0x872f, 0x872e, // 23360
-    0x872d, 0x872c, 0x872b, 0x872a, 0x872a, 0x8729, 0x8728, 0x8727, // 23368
-    0x8726, 0x8725, 0x8724, 0x8723, 0x8722, 0x8721, 0x8721, 0x8720, // 23376
-    0x871f, 0x871e, 0x871d, 0x871c, 0x871b, 0x871a, 0x8719, 0x8718, // 23384
-    0x8718, 0x8717, 0x8716, 0x8715, 0x8714, 0x8713, 0x8712, 0x8711, // 23392
-    0x8710, 0x870f, 0x870f, 0x870e, 0x870d, 0x870c, 0x870b, 0x870a, // 23400
-    0x8709, 0x8708, 0x8707, 0x8706, 0x8706, 0x8705, 0x8704, 0x8703, // 23408
-    0x8702, 0x8701, 0x8700, 0x86ff, 0x86fe, 0x86fd, 0x86fd, 0x86fc, // 23416
-    0x86fb, 0x86fa, 0x86f9, 0x86f8, 0x86f7, 0x86f6, 0x86f5, 0x86f4, // 23424
-    0x86f4, 0x86f3, 0x86f2, 0x86f1, 0x86f0, 0x86ef, 0x86ee, 0x86ed, // 23432
-    0x86ec, 0x86eb, 0x86eb, 0x86ea, 0x86e9, 0x86e8, 0x86e7, 0x86e6, // 23440
-    0x86e5, 0x86e4, 0x86e3, 0x86e2, 0x86e2, 0x86e1, 0x86e0, 0x86df, // 23448
-    0x86de, 0x86dd, 0x86dc, 0x86db, 0x86da, 0x86d9, 0x86d9, 0x86d8, // 23456
-    0x86d7, 0x86d6, 0x86d5, 0x86d4, 0x86d3, 0x86d2, 0x86d1, 0x86d0, // 23464
-    0x86d0, 0x86cf, 0x86ce, 0x86cd, 0x86cc, 0x86cb, 0x86ca, 0x86c9, // 23472
-    0x86c8, 0x86c7, 0x86c7, 0x86c6, 0x86c5, 0x86c4, 0x86c3, 0x86c2, // 23480
-    0x86c1, 0x86c0, 0x86bf, 0x86be, 0x86be, 0x86bd, 0x86bc, 0x86bb, // 23488
-    0x86ba, 0x86b9, 0x86b8, 0x86b7, 0x86b6, 0x86b5, 0x86b5, 0x86b4, // 23496
-    0x86b3, 0x86b2, 0x86b1, 0x86b0, 0x86af, 0x86ae, 0x86ad, 0x86ac, // 23504
-    0x86ac, 0x86ab, 0x86aa, 0x86a9, 0x86a8, 0x86a7, 0x86a6, 0x86a5, // 23512
-    0x86a4, 0x86a3, 0x86a3, 0x86a2, 0x86a1, 0x86a0, 0x869f, 0x869e, // 23520
-    0x869d, 0x869c, 0x869b, 0x869a, 0x869a, 0x8699, 0x8698, 0x8697, // 23528
-    0x8696, 0x8695, 0x8694, 0x8693, 0x8692, 0x8691, 0x8691, 0x8690, // 23536
-    0x868f, 0x868e, 0x868d, 0x868c, 0x868b, 0x868a, 0x8689, 0x8688, // 23544
-    0x8688, 0x8687, 0x8686, 0x8686, 0x8685, 0x8684, 0x8683, 0x8682, // 23552
-    0x8681, 0x8680, 0x867f, 0x867f, 0x867e, 0x867d, 0x867c, 0x867b, // 23560
-    0x867a, 0x8679, 0x8678, 0x8678, 0x8677, 0x8676, 0x8675, 0x8674, // 23568
-    0x8673, 0x8672, 0x8671, 0x8671, 0x8670, 0x866f, 0x866e, 0x866d, // 23576
-    0x866c, 0x866b, 0x866a, 0x866a, 0x8669, 0x8668, 0x8667, 0x8666, // 23584
-    0x8665, 0x8664, 0x8663, 0x8663, 0x8662, 0x8661, 0x8660, 0x865f, // 23592
-    0x865e, 0x865d, 0x865c, 0x865c, 0x865b, 0x865a, 0x8659, 0x8658, // 23600
-    0x8657, 0x8656, 0x8655, 0x8655, 0x8654, 0x8653, 0x8652, 0x8651, // 23608
-    0x8650, 0x864f, 0x864e, 0x864d, 0x864d, 0x864c, 0x864b, 0x864a, // 23616
-    0x8649, 0x8648, 0x8647, 0x8646, 0x8646, 0x8645, 0x8644, 0x8643, // 23624
-    0x8642, 0x8641, 0x8640, 0x863f, 0x863f, 0x863e, 0x863d, 0x863c, // 23632
-    0x863b, 0x863a, 0x8639, 0x8638, 0x8638, 0x8637, 0x8636, 0x8635, // 23640
-    0x8634, 0x8633, 0x8632, 0x8631, 0x8631, 0x8630, 0x862f, 0x862e, // 23648
-    0x862d, 0x862c, 0x862b, 0x862a, 0x862a, 0x8629, 0x8628, 0x8627, // 23656
-    0x8626, 0x8625, 0x8624, 0x8623, 0x8623, 0x8622, 0x8621, 0x8620, // 23664
-    0x861f, 0x861e, 0x861d, 0x861c, 0x861c, 0x861b, 0x861a, 0x8619, // 23672
-    0x8618, 0x8617, 0x8616, 0x8615, 0x8614, 0x8614, 0x8613, 0x8612, // 23680
-    0x8611, 0x8610, 0x860f, 0x860e, 0x860d, 0x860d, 0x860c, 0x860b, // 23688
-    0x860a, 0x8609, 0x8608, 0x8607, 0x8606, 0x8606, 0x8605, 0x8604, // 23696
-    0x8603, 0x8602, 0x8601, 0x8600, 0x85ff, 0x85ff, 0x85fe, 0x85fd, // 23704
-    0x85fc, 0x85fb, 0x85fa, 0x85f9, 0x85f8, 0x85f8, 0x85f7, 0x85f6, // 23712
-    0x85f5, 0x85f4, 0x85f3, 0x85f2, 0x85f1, 0x85f1, 0x85f0, 0x85ef, // 23720
-    0x85ee, 0x85ed, 0x85ec, 0x85eb, 0x85ea, 0x85ea, 0x85e9, 0x85e8, // 23728
-    0x85e7, 0x85e6, 0x85e5, 0x85e4, 0x85e3, 0x85e3, 0x85e2, 0x85e1, // 23736
-    0x85e0, 0x85df, 0x85de, 0x85dd, 0x85dc, 0x85db, 0x85db, 0x85da, // 23744
-    0x85d9, 0x85d8, 0x85d7, 0x85d6, 0x85d5, 0x85d4, 0x85d4, 0x85d3, // 23752
-    0x85d2, 0x85d1, 0x85d0, 0x85cf, 0x85ce, 0x85cd, 0x85cd, 0x85cc, // 23760
-    0x85cb, 0x85ca, 0x85c9, 0x85c8, 0x85c7, 0x85c6, 0x85c6, 0x85c5, // 23768
-    0x85c4, 0x85c3, 0x85c2, 0x85c1, 0x85c0, 0x85bf, 0x85bf, 0x85be, // 23776
-    0x85bd, 0x85bc, 0x85bb, 0x85ba, 0x85b9, 0x85b8, 0x85b8, 0x85b7, // 23784
-    0x85b6, 0x85b5, 0x85b4, 0x85b3, 0x85b2, 0x85b1, 0x85b1, 0x85b0, // 23792
-    0x85af, 0x85ae, 0x85ad, 0x85ac, 0x85ab, 0x85aa, 0x85aa, 0x85a9, // 23800
-    0x85a8, 0x85a7, 0x85a6, 0x85a5, 0x85a4, 0x85a3, 0x85a2, 0x85a2, // 23808
-    0x85a1, 0x85a0, 0x859f, 0x859e, 0x859d, 0x859c, 0x859b, 0x859b, // 23816
-    0x859a, 0x8599, 0x8598, 0x8597, 0x8596, 0x8595, 0x8594, 0x8594, // 23824
-    0x8593, 0x8592, 0x8591, 0x8590, 0x858f, 0x858e, 0x858d, 0x858d, // 23832
-    0x858c, 0x858b, 0x858a, 0x8589, 0x8588, 0x8587, 0x8586, 0x8586, // 23840
-    0x8585, 0x8584, 0x8583, 0x8582, 0x8581, 0x8580, 0x857f, 0x857f, // 23848
-    0x857e, 0x857d, 0x857c, 0x857b, 0x857a, 0x8579, 0x8578, 0x8578, // 23856
-    0x8577, 0x8576, 0x8575, 0x8574, 0x8573, 0x8572, 0x8571, 0x8571, // 23864
-    0x8570, 0x856f, 0x856e, 0x856d, 0x856c, 0x856b, 0x856a, 0x8569, // 23872
-    0x8569, 0x8568, 0x8567, 0x8566, 0x8565, 0x8564, 0x8563, 0x8562, // 23880
-    0x8562, 0x8561, 0x8560, 0x855f, 0x855e, 0x855d, 0x855c, 0x855b, // 23888
-    0x855b, 0x855a, 0x8559, 0x8558, 0x8557, 0x8556, 0x8555, 0x8554, // 23896
-    0x8554, 0x8553, 0x8552, 0x8551, 0x8550, 0x854f, 0x854e, 0x854d, // 23904
-    0x854d, 0x854c, 0x854b, 0x854a, 0x8549, 0x8548, 0x8547, 0x8546, // 23912
-    0x8546, 0x8545, 0x8544, 0x8543, 0x8542, 0x8541, 0x8540, 0x853f, // 23920
-    0x853f, 0x853e, 0x853d, 0x853c, 0x853b, 0x853a, 0x8539, 0x8538, // 23928
-    0x8538, 0x8537, 0x8536, 0x8535, 0x8534, 0x8533, 0x8532, 0x8531, // 23936
-    0x8530, 0x8530, 0x852f, 0x852e, 0x852d, 0x852c, 0x852b, 0x852a, // 23944
-    0x8529, 0x8529, 0x8528, 0x8527, 0x8526, 0x8525, 0x8524, 0x8523, // 23952
-    0x8522, 0x8522, 0x8521, 0x8520, 0x851f, 0x851e, 0x851d, 0x851c, // 23960
-    0x851b, 0x851b, 0x851a, 0x8519, 0x8518, 0x8517, 0x8516, 0x8515, // 23968
-    0x8514, 0x8514, 0x8513, 0x8512, 0x8511, 0x8510, 0x850f, 0x850e, // 23976
-    0x850d, 0x850d, 0x850c, 0x850b, 0x850a, 0x8509, 0x8508, 0x8507, // 23984
-    0x8506, 0x8506, 0x8505, 0x8504, 0x8503, 0x8502, 0x8501, 0x8500, // 23992
-    0x84ff, 0x84fe, 0x84fe, 0x84fd, 0x84fc, 0x84fb, 0x84fa, 0x84f9, // 24000
-    0x84f8, 0x84f7, 0x84f7, 0x84f6, 0x84f5, 0x84f4, 0x84f3, 0x84f2, // 24008
-    0x84f1, 0x84f0, 0x84f0, 0x84ef, 0x84ee, 0x84ed, 0x84ec, 0x84eb, // 24016
-    0x84ea, 0x84e9, 0x84e9, 0x84e8, 0x84e7, 0x84e6, 0x84e5, 0x84e4, // 24024
-    0x84e3, 0x84e2, 0x84e2, 0x84e1, 0x84e0, 0x84df, 0x84de, 0x84dd, // 24032
-    0x84dc, 0x84db, 0x84db, 0x84da, 0x84d9, 0x84d8, 0x84d7, 0x84d6, // 24040
-    0x84d5, 0x84d4, 0x84d4, 0x84d3, 0x84d2, 0x84d1, 0x84d0, 0x84cf, // 24048
-    0x84ce, 0x84cd, 0x84cd, 0x84cc, 0x84cb, 0x84ca, 0x84c9, 0x84c8, // 24056
-    0x84c7, 0x84c6, 0x84c5, 0x84c5, 0x84c4, 0x84c3, 0x84c2, 0x84c1, // 24064
-    0x84c0, 0x84bf, 0x84be, 0x84be, 0x84bd, 0x84bc, 0x84bb, 0x84ba, // 24072
-    0x84b9, 0x84b8, 0x84b7, 0x84b7, 0x84b6, 0x84b5, 0x84b4, 0x84b3, // 24080
-    0x84b2, 0x84b1, 0x84b0, 0x84b0, 0x84af, 0x84ae, 0x84ad, 0x84ac, // 24088
-    0x84ab, 0x84aa, 0x84a9, 0x84a9, 0x84a8, 0x84a7, 0x84a6, 0x84a5, // 24096
-    0x84a4, 0x84a3, 0x84a2, 0x84a2, 0x84a1, 0x84a0, 0x849f, 0x849e, // 24104
-    0x849d, 0x849c, 0x849b, 0x849b, 0x849a, 0x8499, 0x8498, 0x8497, // 24112
-    0x8496, 0x8495, 0x8494, 0x8494, 0x8493, 0x8492, 0x8491, 0x8490, // 24120
-    0x848f, 0x848e, 0x848d, 0x848c, 0x848c, 0x848b, 0x848a, 0x8489, // 24128
-    0x8488, 0x8487, 0x8486, 0x8485, 0x8485, 0x8484, 0x8483, 0x8482, // 24136
-    0x8481, 0x8480, 0x847f, 0x847e, 0x847e, 0x847d, 0x847c, 0x847b, // 24144
-    0x847a, 0x8479, 0x8478, 0x8477, 0x8477, 0x8476, 0x8475, 0x8474, // 24152
-    0x8473, 0x8472, 0x8471, 0x8470, 0x8470, 0x846f, 0x846e, 0x846d, // 24160
-    0x846c, 0x846b, 0x846a, 0x8469, 0x8469, 0x8468, 0x8467, 0x8466, // 24168
-    0x8465, 0x8464, 0x8463, 0x8462, 0x8462, 0x8461, 0x8460, 0x845f, // 24176
-    0x845e, 0x845d, 0x845c, 0x845b, 0x845b, 0x845a, 0x8459, 0x8458, // 24184
-    0x8457, 0x8456, 0x8455, 0x8454, 0x8453, 0x8453, 0x8452, 0x8451, // 24192
-    0x8450, 0x844f, 0x844e, 0x844d, 0x844c, 0x844c, 0x844b, 0x844a, // 24200
-    0x8449, 0x8448, 0x8447, 0x8446, 0x8445, 0x8445, 0x8444, 0x8443, // 24208
-    0x8442, 0x8441, 0x8440, 0x843f, 0x843e, 0x843e, 0x843d, 0x843c, // 24216
-    0x843b, 0x843a, 0x8439, 0x8438, 0x8437, 0x8437, 0x8436, 0x8435, // 24224
-    0x8434, 0x8433, 0x8432, 0x8431, 0x8430, 0x8430, 0x842f, 0x842e, // 24232
-    0x842d, 0x842c, 0x842b, 0x842a, 0x8429, 0x8429, 0x8428, 0x8427, // 24240
-    0x8426, 0x8425, 0x8424, 0x8423, 0x8422, 0x8422, 0x8421, 0x8420, // 24248
-    0x841f, 0x841e, 0x841d, 0x841c, 0x841b, 0x841a, 0x841a, 0x8419, // 24256
-    0x8418, 0x8417, 0x8416, 0x8415, 0x8414, 0x8413, 0x8413, 0x8412, // 24264
-    0x8411, 0x8410, 0x840f, 0x840e, 0x840d, 0x840c, 0x840c, 0x840b, // 24272
-    0x840a, 0x8409, 0x8408, 0x8407, 0x8406, 0x8405, 0x8405, 0x8404, // 24280
-    0x8403, 0x8402, 0x8401, 0x8400, 0x83ff, 0x83fe, 0x83fe, 0x83fd, // 24288
-    0x83fc, 0x83fb, 0x83fa, 0x83f9, 0x83f8, 0x83f7, 0x83f7, 0x83f6, // 24296
-    0x83f5, 0x83f4, 0x83f3, 0x83f2, 0x83f1, 0x83f0, 0x83f0, 0x83ef, // 24304
-    0x83ee, 0x83ed, 0x83ec, 0x83eb, 0x83ea, 0x83e9, 0x83e9, 0x83e8, // 24312
-    0x83e7, 0x83e6, 0x83e5, 0x83e4, 0x83e3, 0x83e2, 0x83e1, 0x83e1, // 24320
-    0x83e0, 0x83df, 0x83de, 0x83dd, 0x83dc, 0x83db, 0x83da, 0x83da, // 24328
-    0x83d9, 0x83d8, 0x83d7, 0x83d6, 0x83d5, 0x83d4, 0x83d3, 0x83d3, // 24336
-    0x83d2, 0x83d1, 0x83d0, 0x83cf, 0x83ce, 0x83cd, 0x83cc, 0x83cc, // 24344
-    0x83cb, 0x83ca, 0x83c9, 0x83c8, 0x83c7, 0x83c6, 0x83c5, 0x83c5, // 24352
-    0x83c4, 0x83c3, 0x83c2, 0x83c1, 0x83c0, 0x83bf, 0x83be, 0x83be, // 24360
-    0x83bd, 0x83bc, 0x83bb, 0x83ba, 0x83b9, 0x83b8, 0x83b7, 0x83b7, // 24368
-    0x83b6, 0x83b5, 0x83b4, 0x83b3, 0x83b2, 0x83b1, 0x83b0, 0x83b0, // 24376
-    0x83af, 0x83ae, 0x83ad, 0x83ac, 0x83ab, 0x83aa, 0x83a9, 0x83a8, // 24384
-    0x83a8, 0x83a7, 0x83a6, 0x83a5, 0x83a4, 0x83a3, 0x83a2, 0x83a1, // 24392
-    0x83a1, 0x83a0, 0x839f, 0x839e, 0x839d, 0x839c, 0x839b, 0x839a, // 24400
-    0x839a, 0x8399, 0x8398, 0x8397, 0x8396, 0x8395, 0x8394, 0x8393, // 24408
-    0x8393, 0x8392, 0x8391, 0x8390, 0x838f, 0x838e, 0x838d, 0x838c, // 24416
-    0x838c, 0x838b, 0x838a, 0x8389, 0x8388, 0x8387, 0x8386, 0x8385, // 24424
-    0x8385, 0x8384, 0x8383, 0x8382, 0x8381, 0x8380, 0x837f, 0x837e, // 24432
-    0x837e, 0x837d, 0x837c, 0x837b, 0x837a, 0x8379, 0x8378, 0x8377, // 24440
-    0x8377, 0x8376, 0x8375, 0x8374, 0x8373, 0x8372, 0x8371, 0x8370, // 24448
-    0x836f, 0x836f, 0x836e, 0x836d, 0x836c, 0x836b, 0x836a, 0x8369, // 24456
-    0x8368, 0x8368, 0x8367, 0x8366, 0x8365, 0x8364, 0x8363, 0x8362, // 24464
-    0x8361, 0x8361, 0x8360, 0x835f, 0x835e, 0x835d, 0x835c, 0x835b, // 24472
-    0x835a, 0x835a, 0x8359, 0x8358, 0x8357, 0x8356, 0x8355, 0x8354, // 24480
-    0x8353, 0x8353, 0x8352, 0x8351, 0x8350, 0x834f, 0x834e, 0x834d, // 24488
-    0x834c, 0x834c, 0x834b, 0x834a, 0x8349, 0x8348, 0x8347, 0x8346, // 24496
-    0x8345, 0x8345, 0x8344, 0x8343, 0x8342, 0x8341, 0x8340, 0x833f, // 24504
-    0x833e, 0x833d, 0x833d, 0x833c, 0x833b, 0x833a, 0x8339, 0x8338, // 24512
-    0x8337, 0x8336, 0x8336, 0x8335, 0x8334, 0x8333, 0x8332, 0x8331, // 24520
-    0x8330, 0x832f, 0x832f, 0x832e, 0x832d, 0x832c, 0x832b, 0x832a, // 24528
-    0x8329, 0x8328, 0x8328, 0x8327, 0x8326, 0x8325, 0x8324, 0x8323, // 24536
-    0x8322, 0x8321, 0x8321, 0x8320, 0x831f, 0x831e, 0x831d, 0x831c, // 24544
-    0x831b, 0x831a, 0x831a, 0x8319, 0x8318, 0x8317, 0x8316, 0x8315, // 24552
-    0x8314, 0x8313, 0x8313, 0x8312, 0x8311, 0x8310, 0x830f, 0x830e, // 24560
-    0x830d, 0x830c, 0x830c, 0x830b, 0x830a, 0x8309, 0x8308, 0x8307, // 24568
-    0x8307, 0x8306, 0x8306, 0x8305, 0x8304, 0x8303, 0x8302, 0x8301, // 24576
-    0x8300, 0x8300, 0x82ff, 0x82fe, 0x82fd, 0x82fc, 0x82fb, 0x82fa, // 24584
-    0x82fa, 0x82f9, 0x82f8, 0x82f7, 0x82f6, 0x82f5, 0x82f4, 0x82f4, // 24592
-    0x82f3, 0x82f2, 0x82f1, 0x82f0, 0x82ef, 0x82ee, 0x82ee, 0x82ed, // 24600
-    0x82ec, 0x82eb, 0x82ea, 0x82e9, 0x82e9, 0x82e8, 0x82e7, 0x82e6, // 24608
-    0x82e5, 0x82e4, 0x82e3, 0x82e3, 0x82e2, 0x82e1, 0x82e0, 0x82df, // 24616
-    0x82de, 0x82dd, 0x82dd, 0x82dc, 0x82db, 0x82da, 0x82d9, 0x82d8, // 24624
-    0x82d7, 0x82d7, 0x82d6, 0x82d5, 0x82d4, 0x82d3, 0x82d2, 0x82d1, // 24632
-    0x82d1, 0x82d0, 0x82cf, 0x82ce, 0x82cd, 0x82cc, 0x82cc, 0x82cb, // 24640
-    0x82ca, 0x82c9, 0x82c8, 0x82c7, 0x82c6, 0x82c6, 0x82c5, 0x82c4, // 24648
-    0x82c3, 0x82c2, 0x82c1, 0x82c0, 0x82c0, 0x82bf, 0x82be, 0x82bd, // 24656
-    0x82bc, 0x82bb, 0x82ba, 0x82ba, 0x82b9, 0x82b8, 0x82b7, 0x82b6, // 24664
-    0x82b5, 0x82b4, 0x82b4, 0x82b3, 0x82b2, 0x82b1, 0x82b0, 0x82af, // 24672
-    0x82ae, 0x82ae, 0x82ad, 0x82ac, 0x82ab, 0x82aa, 0x82a9, 0x82a9, // 24680
-    0x82a8, 0x82a7, 0x82a6, 0x82a5, 0x82a4, 0x82a3, 0x82a3, 0x82a2, // 24688
-    0x82a1, 0x82a0, 0x829f, 0x829e, 0x829d, 0x829d, 0x829c, 0x829b, // 24696
-    0x829a, 0x8299, 0x8298, 0x8297, 0x8297, 0x8296, 0x8295, 0x8294, // 24704
-    0x8293, 0x8292, 0x8291, 0x8291, 0x8290, 0x828f, 0x828e, 0x828d, // 24712
-    0x828c, 0x828b, 0x828b, 0x828a, 0x8289, 0x8288, 0x8287, 0x8286, // 24720
-    0x8286, 0x8285, 0x8284, 0x8283, 0x8282, 0x8281, 0x8280, 0x8280, // 24728
-    0x827f, 0x827e, 0x827d, 0x827c, 0x827b, 0x827a, 0x827a, 0x8279, // 24736
-    0x8278, 0x8277, 0x8276, 0x8275, 0x8274, 0x8274, 0x8273, 0x8272, // 24744
-    0x8271, 0x8270, 0x826f, 0x826e, 0x826e, 0x826d, 0x826c, 0x826b, // 24752
-    0x826a, 0x8269, 0x8268, 0x8268, 0x8267, 0x8266, 0x8265, 0x8264, // 24760
-    0x8263, 0x8263, 0x8262, 0x8261, 0x8260, 0x825f, 0x825e, 0x825d, // 24768
-    0x825d, 0x825c, 0x825b, 0x825a, 0x8259, 0x8258, 0x8257, 0x8257, // 24776
-    0x8256, 0x8255, 0x8254, 0x8253, 0x8252, 0x8251, 0x8251, 0x8250, // 24784
-    0x824f, 0x824e, 0x824d, 0x824c, 0x824b, 0x824b, 0x824a, 0x8249, // 24792
-    0x8248, 0x8247, 0x8246, 0x8246, 0x8245, 0x8244, 0x8243, 0x8242, // 24800
-    0x8241, 0x8240, 0x8240, 0x823f, 0x823e, 0x823d, 0x823c, 0x823b, // 24808
-    0x823a, 0x823a, 0x8239, 0x8238, 0x8237, 0x8236, 0x8235, 0x8234, // 24816
-    0x8234, 0x8233, 0x8232, 0x8231, 0x8230, 0x822f, 0x822e, 0x822e, // 24824
-    0x822d, 0x822c, 0x822b, 0x822a, 0x8229, 0x8228, 0x8228, 0x8227, // 24832
-    0x8226, 0x8225, 0x8224, 0x8223, 0x8223, 0x8222, 0x8221, 0x8220, // 24840
-    0x821f, 0x821e, 0x821d, 0x821d, 0x821c, 0x821b, 0x821a, 0x8219, // 24848
-    0x8218, 0x8217, 0x8217, 0x8216, 0x8215, 0x8214, 0x8213, 0x8212, // 24856
-    0x8211, 0x8211, 0x8210, 0x820f, 0x820e, 0x820d, 0x820c, 0x820b, // 24864
-    0x820b, 0x820a, 0x8209, 0x8208, 0x8207, 0x8206, 0x8205, 0x8205, // 24872
-    0x8204, 0x8203, 0x8202, 0x8201, 0x8200, 0x8200, 0x81ff, 0x81fe, // 24880
-    0x81fd, 0x81fc, 0x81fb, 0x81fa, 0x81fa, 0x81f9, 0x81f8, 0x81f7, // 24888
-    0x81f6, 0x81f5, 0x81f4, 0x81f4, 0x81f3, 0x81f2, 0x81f1, 0x81f0, // 24896
-    0x81ef, 0x81ee, 0x81ee, 0x81ed, 0x81ec, 0x81eb, 0x81ea, 0x81e9, // 24904
-    0x81e8, 0x81e8, 0x81e7, 0x81e6, 0x81e5, 0x81e4, 0x81e3, 0x81e2, // 24912
-    0x81e2, 0x81e1, 0x81e0, 0x81df, 0x81de, 0x81dd, 0x81dd, 0x81dc, // 24920
-    0x81db, 0x81da, 0x81d9, 0x81d8, 0x81d7, 0x81d7, 0x81d6, 0x81d5, // 24928
-    0x81d4, 0x81d3, 0x81d2, 0x81d1, 0x81d1, 0x81d0, 0x81cf, 0x81ce, // 24936
-    0x81cd, 0x81cc, 0x81cb, 0x81cb, 0x81ca, 0x81c9, 0x81c8, 0x81c7, // 24944
-    0x81c6, 0x81c5, 0x81c5, 0x81c4, 0x81c3, 0x81c2, 0x81c1, 0x81c0, // 24952
-    0x81c0, 0x81bf, 0x81be, 0x81bd, 0x81bc, 0x81bb, 0x81ba, 0x81ba, // 24960
-    0x81b9, 0x81b8, 0x81b7, 0x81b6, 0x81b5, 0x81b4, 0x81b4, 0x81b3, // 24968
-    0x81b2, 0x81b1, 0x81b0, 0x81af, 0x81ae, 0x81ae, 0x81ad, 0x81ac, // 24976
-    0x81ab, 0x81aa, 0x81a9, 0x81a8, 0x81a8, 0x81a7, 0x81a6, 0x81a5, // 24984
-    0x81a4, 0x81a3, 0x81a2, 0x81a2, 0x81a1, 0x81a0, 0x819f, 0x819e, // 24992
-    0x819d, 0x819d, 0x819c, 0x819b, 0x819a, 0x8199, 0x8198, 0x8197, // 25000
-    0x8197, 0x8196, 0x8195, 0x8194, 0x8193, 0x8192, 0x8191, 0x8191, // 25008
-    0x8190, 0x818f, 0x818e, 0x818d, 0x818c, 0x818b, 0x818b, 0x818a, // 25016
-    0x8189, 0x8188, 0x8187, 0x8186, 0x8185, 0x8185, 0x8184, 0x8183, // 25024
-    0x8182, 0x8181, 0x8180, 0x817f, 0x817f, 0x817e, 0x817d, 0x817c, // 25032
-    0x817b, 0x817a, 0x817a, 0x8179, 0x8178, 0x8177, 0x8176, 0x8175, // 25040
-    0x8174, 0x8174, 0x8173, 0x8172, 0x8171, 0x8170, 0x816f, 0x816e, // 25048
-    0x816e, 0x816d, 0x816c, 0x816b, 0x816a, 0x8169, 0x8168, 0x8168, // 25056
-    0x8167, 0x8166, 0x8165, 0x8164, 0x8163, 0x8162, 0x8162, 0x8161, // 25064
-    0x8160, 0x815f, 0x815e, 0x815d, 0x815c, 0x815c, 0x815b, 0x815a, // 25072
-    0x8159, 0x8158, 0x8157, 0x8157, 0x8156, 0x8155, 0x8154, 0x8153, // 25080
-    0x8152, 0x8151, 0x8151, 0x8150, 0x814f, 0x814e, 0x814d, 0x814c, // 25088
-    0x814b, 0x814b, 0x814a, 0x8149, 0x8148, 0x8147, 0x8146, 0x8145, // 25096
-    0x8145, 0x8144, 0x8143, 0x8142, 0x8141, 0x8140, 0x813f, 0x813f, // 25104
-    0x813e, 0x813d, 0x813c, 0x813b, 0x813a, 0x8139, 0x8139, 0x8138, // 25112
-    0x8137, 0x8136, 0x8135, 0x8134, 0x8134, 0x8133, 0x8132, 0x8131, // 25120
-    0x8130, 0x812f, 0x812e, 0x812e, 0x812d, 0x812c, 0x812b, 0x812a, // 25128
-    0x8129, 0x8128, 0x8128, 0x8127, 0x8126, 0x8125, 0x8124, 0x8123, // 25136
-    0x8122, 0x8122, 0x8121, 0x8120, 0x811f, 0x811e, 0x811d, 0x811c, // 25144
-    0x811c, 0x811b, 0x811a, 0x8119, 0x8118, 0x8117, 0x8117, 0x8116, // 25152
-    0x8115, 0x8114, 0x8113, 0x8112, 0x8111, 0x8111, 0x8110, 0x810f, // 25160
-    0x810e, 0x810d, 0x810c, 0x810b, 0x810b, 0x810a, 0x8109, 0x8108, // 25168
-    0x8107, 0x8106, 0x8105, 0x8105, 0x8104, 0x8103, 0x8102, 0x8101, // 25176
-    0x8100, 0x80ff, 0x80ff, 0x80fe, 0x80fd, 0x80fc, 0x80fb, 0x80fa, // 25184
-    0x80f9, 0x80f9, 0x80f8, 0x80f7, 0x80f6, 0x80f5, 0x80f4, 0x80f4, // 25192
-    0x80f3, 0x80f2, 0x80f1, 0x80f0, 0x80ef, 0x80ee, 0x80ee, 0x80ed, // 25200
-    0x80ec, 0x80eb, 0x80ea, 0x80e9, 0x80e8, 0x80e8, 0x80e7, 0x80e6, // 25208
-    0x80e5, 0x80e4, 0x80e3, 0x80e2, 0x80e2, 0x80e1, 0x80e0, 0x80df, // 25216
-    0x80de, 0x80dd, 0x80dc, 0x80dc, 0x80db, 0x80da, 0x80d9, 0x80d8, // 25224
-    0x80d7, 0x80d6, 0x80d6, 0x80d5, 0x80d4, 0x80d3, 0x80d2, 0x80d1, // 25232
-    0x80d1, 0x80d0, 0x80cf, 0x80ce, 0x80cd, 0x80cc, 0x80cb, 0x80cb, // 25240
-    0x80ca, 0x80c9, 0x80c8, 0x80c7, 0x80c6, 0x80c5, 0x80c5, 0x80c4, // 25248
-    0x80c3, 0x80c2, 0x80c1, 0x80c0, 0x80bf, 0x80bf, 0x80be, 0x80bd, // 25256
-    0x80bc, 0x80bb, 0x80ba, 0x80b9, 0x80b9, 0x80b8, 0x80b7, 0x80b6, // 25264
-    0x80b5, 0x80b4, 0x80b3, 0x80b3, 0x80b2, 0x80b1, 0x80b0, 0x80af, // 25272
-    0x80ae, 0x80ae, 0x80ad, 0x80ac, 0x80ab, 0x80aa, 0x80a9, 0x80a8, // 25280
-    0x80a8, 0x80a7, 0x80a6, 0x80a5, 0x80a4, 0x80a3, 0x80a2, 0x80a2, // 25288
-    0x80a1, 0x80a0, 0x809f, 0x809e, 0x809d, 0x809c, 0x809c, 0x809b, // 25296
-    0x809a, 0x8099, 0x8098, 0x8097, 0x8096, 0x8096, 0x8095, 0x8094, // 25304
-    0x8093, 0x8092, 0x8091, 0x8091, 0x8090, 0x808f, 0x808e, 0x808d, // 25312
-    0x808c, 0x808b, 0x808b, 0x808a, 0x8089, 0x8088, 0x8087, 0x8086, // 25320
-    0x8085, 0x8085, 0x8084, 0x8083, 0x8082, 0x8081, 0x8080, 0x807f, // 25328
-    0x807f, 0x807e, 0x807d, 0x807c, 0x807b, 0x807a, 0x8079, 0x8079, // 25336
-    0x8078, 0x8077, 0x8076, 0x8075, 0x8074, 0x8073, 0x8073, 0x8072, // 25344
-    0x8071, 0x8070, 0x806f, 0x806e, 0x806e, 0x806d, 0x806c, 0x806b, // 25352
-    0x806a, 0x8069, 0x8068, 0x8068, 0x8067, 0x8066, 0x8065, 0x8064, // 25360
-    0x8063, 0x8062, 0x8062, 0x8061, 0x8060, 0x805f, 0x805e, 0x805d, // 25368
-    0x805c, 0x805c, 0x805b, 0x805a, 0x8059, 0x8058, 0x8057, 0x8056, // 25376
-    0x8056, 0x8055, 0x8054, 0x8053, 0x8052, 0x8051, 0x8050, 0x8050, // 25384
-    0x804f, 0x804e, 0x804d, 0x804c, 0x804b, 0x804b, 0x804a, 0x8049, // 25392
-    0x8048, 0x8047, 0x8046, 0x8045, 0x8045, 0x8044, 0x8043, 0x8042, // 25400
-    0x8041, 0x8040, 0x803f, 0x803f, 0x803e, 0x803d, 0x803c, 0x803b, // 25408
-    0x803a, 0x8039, 0x8039, 0x8038, 0x8037, 0x8036, 0x8035, 0x8034, // 25416
-    0x8033, 0x8033, 0x8032, 0x8031, 0x8030, 0x802f, 0x802e, 0x802d, // 25424
-    0x802d, 0x802c, 0x802b, 0x802a, 0x8029, 0x8028, 0x8028, 0x8027, // 25432
-    0x8026, 0x8025, 0x8024, 0x8023, 0x8022, 0x8022, 0x8021, 0x8020, // 25440
-    0x801f, 0x801e, 0x801d, 0x801c, 0x801c, 0x801b, 0x801a, 0x8019, // 25448
-    0x8018, 0x8017, 0x8016, 0x8016, 0x8015, 0x8014, 0x8013, 0x8012, // 25456
-    0x8011, 0x8010, 0x8010, 0x800f, 0x800e, 0x800d, 0x800c, 0x800b, // 25464
-    0x800b, 0x800a, 0x8009, 0x8008, 0x8007, 0x8006, 0x8005, 0x8005, // 25472
-    0x8004, 0x8003, 0x8002, 0x8001, 0x8000, 0x7fff, 0x7fff, 0x7ffe, // 25480
-    0x7ffd, 0x7ffc, 0x7ffb, 0x7ffa, 0x7ff9, 0x7ff9, 0x7ff8, 0x7ff7, // 25488
-    0x7ff6, 0x7ff5, 0x7ff4, 0x7ff3, 0x7ff3, 0x7ff2, 0x7ff1, 0x7ff0, // 25496
-    0x7fef, 0x7fee, 0x7fed, 0x7fed, 0x7fec, 0x7feb, 0x7fea, 0x7fe9, // 25504
-    0x7fe8, 0x7fe8, 0x7fe7, 0x7fe6, 0x7fe5, 0x7fe4, 0x7fe3, 0x7fe2, // 25512
-    0x7fe2, 0x7fe1, 0x7fe0, 0x7fdf, 0x7fde, 0x7fdd, 0x7fdc, 0x7fdc, // 25520
-    0x7fdb, 0x7fda, 0x7fd9, 0x7fd8, 0x7fd7, 0x7fd6, 0x7fd6, 0x7fd5, // 25528
-    0x7fd4, 0x7fd3, 0x7fd2, 0x7fd1, 0x7fd0, 0x7fd0, 0x7fcf, 0x7fce, // 25536
-    0x7fcd, 0x7fcc, 0x7fcb, 0x7fca, 0x7fca, 0x7fc9, 0x7fc8, 0x7fc7, // 25544
-    0x7fc6, 0x7fc5, 0x7fc5, 0x7fc4, 0x7fc3, 0x7fc2, 0x7fc1, 0x7fc0, // 25552
-    0x7fbf, 0x7fbf, 0x7fbe, 0x7fbd, 0x7fbc, 0x7fbb, 0x7fba, 0x7fb9, // 25560
-    0x7fb9, 0x7fb8, 0x7fb7, 0x7fb6, 0x7fb5, 0x7fb4, 0x7fb3, 0x7fb3, // 25568
-    0x7fb2, 0x7fb1, 0x7fb0, 0x7faf, 0x7fae, 0x7fad, 0x7fad, 0x7fac, // 25576
-    0x7fab, 0x7faa, 0x7fa9, 0x7fa8, 0x7fa7, 0x7fa7, 0x7fa6, 0x7fa5, // 25584
-    0x7fa4, 0x7fa3, 0x7fa2, 0x7fa2, 0x7fa1, 0x7fa0, 0x7f9f, 0x7f9e, // 25592
-    0x7f9e, 0x7f9d, 0x7f9d, 0x7f9c, 0x7f9b, 0x7f9a, 0x7f99, 0x7f98, // 25600
-    0x7f98, 0x7f97, 0x7f96, 0x7f95, 0x7f94, 0x7f93, 0x7f93, 0x7f92, // 25608
-    0x7f91, 0x7f90, 0x7f8f, 0x7f8e, 0x7f8e, 0x7f8d, 0x7f8c, 0x7f8b, // 25616
-    0x7f8a, 0x7f89, 0x7f89, 0x7f88, 0x7f87, 0x7f86, 0x7f85, 0x7f85, // 25624
-    0x7f84, 0x7f83, 0x7f82, 0x7f81, 0x7f80, 0x7f80, 0x7f7f, 0x7f7e, // 25632
-    0x7f7d, 0x7f7c, 0x7f7b, 0x7f7b, 0x7f7a, 0x7f79, 0x7f78, 0x7f77, // 25640
-    0x7f76, 0x7f76, 0x7f75, 0x7f74, 0x7f73, 0x7f72, 0x7f71, 0x7f71, // 25648
-    0x7f70, 0x7f6f, 0x7f6e, 0x7f6d, 0x7f6c, 0x7f6c, 0x7f6b, 0x7f6a, // 25656
-    0x7f69, 0x7f68, 0x7f67, 0x7f67, 0x7f66, 0x7f65, 0x7f64, 0x7f63, // 25664
-    0x7f62, 0x7f62, 0x7f61, 0x7f60, 0x7f5f, 0x7f5e, 0x7f5e, 0x7f5d, // 25672
-    0x7f5c, 0x7f5b, 0x7f5a, 0x7f59, 0x7f59, 0x7f58, 0x7f57, 0x7f56, // 25680
-    0x7f55, 0x7f54, 0x7f54, 0x7f53, 0x7f52, 0x7f51, 0x7f50, 0x7f4f, // 25688
-    0x7f4f, 0x7f4e, 0x7f4d, 0x7f4c, 0x7f4b, 0x7f4a, 0x7f4a, 0x7f49, // 25696
-    0x7f48, 0x7f47, 0x7f46, 0x7f45, 0x7f45, 0x7f44, 0x7f43, 0x7f42, // 25704
-    0x7f41, 0x7f40, 0x7f40, 0x7f3f, 0x7f3e, 0x7f3d, 0x7f3c, 0x7f3b, // 25712
-    0x7f3b, 0x7f3a, 0x7f39, 0x7f38, 0x7f37, 0x7f36, 0x7f36, 0x7f35, // 25720
-    0x7f34, 0x7f33, 0x7f32, 0x7f32, 0x7f31, 0x7f30, 0x7f2f, 0x7f2e, // 25728
-    0x7f2d, 0x7f2d, 0x7f2c, 0x7f2b, 0x7f2a, 0x7f29, 0x7f28, 0x7f28, // 25736
-    0x7f27, 0x7f26, 0x7f25, 0x7f24, 0x7f23, 0x7f23, 0x7f22, 0x7f21, // 25744
-    0x7f20, 0x7f1f, 0x7f1e, 0x7f1e, 0x7f1d, 0x7f1c, 0x7f1b, 0x7f1a, // 25752
-    0x7f19, 0x7f19, 0x7f18, 0x7f17, 0x7f16, 0x7f15, 0x7f14, 0x7f14, // 25760
-    0x7f13, 0x7f12, 0x7f11, 0x7f10, 0x7f0f, 0x7f0f, 0x7f0e, 0x7f0d, // 25768
-    0x7f0c, 0x7f0b, 0x7f0a, 0x7f0a, 0x7f09, 0x7f08, 0x7f07, 0x7f06, // 25776
-    0x7f06, 0x7f05, 0x7f04, 0x7f03, 0x7f02, 0x7f01, 0x7f01, 0x7f00, // 25784
-    0x7eff, 0x7efe, 0x7efd, 0x7efc, 0x7efc, 0x7efb, 0x7efa, 0x7ef9, // 25792
-    0x7ef8, 0x7ef7, 0x7ef7, 0x7ef6, 0x7ef5, 0x7ef4, 0x7ef3, 0x7ef2, // 25800
-    0x7ef2, 0x7ef1, 0x7ef0, 0x7eef, 0x7eee, 0x7eed, 0x7eed, 0x7eec, // 25808
-    0x7eeb, 0x7eea, 0x7ee9, 0x7ee8, 0x7ee8, 0x7ee7, 0x7ee6, 0x7ee5, // 25816
-    0x7ee4, 0x7ee3, 0x7ee3, 0x7ee2, 0x7ee1, 0x7ee0, 0x7edf, 0x7edf, // 25824
-    0x7ede, 0x7edd, 0x7edc, 0x7edb, 0x7eda, 0x7eda, 0x7ed9, 0x7ed8, // 25832
-    0x7ed7, 0x7ed6, 0x7ed5, 0x7ed5, 0x7ed4, 0x7ed3, 0x7ed2, 0x7ed1, // 25840
-    0x7ed0, 0x7ed0, 0x7ecf, 0x7ece, 0x7ecd, 0x7ecc, 0x7ecb, 0x7ecb, // 25848
-    0x7eca, 0x7ec9, 0x7ec8, 0x7ec7, 0x7ec6, 0x7ec6, 0x7ec5, 0x7ec4, // 25856
-    0x7ec3, 0x7ec2, 0x7ec1, 0x7ec1, 0x7ec0, 0x7ebf, 0x7ebe, 0x7ebd, // 25864
-    0x7ebc, 0x7ebc, 0x7ebb, 0x7eba, 0x7eb9, 0x7eb8, 0x7eb7, 0x7eb7, // 25872
-    0x7eb6, 0x7eb5, 0x7eb4, 0x7eb3, 0x7eb3, 0x7eb2, 0x7eb1, 0x7eb0, // 25880
-    0x7eaf, 0x7eae, 0x7eae, 0x7ead, 0x7eac, 0x7eab, 0x7eaa, 0x7ea9, // 25888
-    0x7ea9, 0x7ea8, 0x7ea7, 0x7ea6, 0x7ea5, 0x7ea4, 0x7ea4, 0x7ea3, // 25896
-    0x7ea2, 0x7ea1, 0x7ea0, 0x7e9f, 0x7e9f, 0x7e9e, 0x7e9d, 0x7e9c, // 25904
-    0x7e9b, 0x7e9a, 0x7e9a, 0x7e99, 0x7e98, 0x7e97, 0x7e96, 0x7e95, // 25912
-    0x7e95, 0x7e94, 0x7e93, 0x7e92, 0x7e91, 0x7e90, 0x7e90, 0x7e8f, // 25920
-    0x7e8e, 0x7e8d, 0x7e8c, 0x7e8b, 0x7e8b, 0x7e8a, 0x7e89, 0x7e88, // 25928
-    0x7e87, 0x7e87, 0x7e86, 0x7e85, 0x7e84, 0x7e83, 0x7e82, 0x7e82, // 25936
-    0x7e81, 0x7e80, 0x7e7f, 0x7e7e, 0x7e7d, 0x7e7d, 0x7e7c, 0x7e7b, // 25944
-    0x7e7a, 0x7e79, 0x7e78, 0x7e78, 0x7e77, 0x7e76, 0x7e75, 0x7e74, // 25952
-    0x7e73, 0x7e73, 0x7e72, 0x7e71, 0x7e70, 0x7e6f, 0x7e6e, 0x7e6e, // 25960
-    0x7e6d, 0x7e6c, 0x7e6b, 0x7e6a, 0x7e69, 0x7e69, 0x7e68, 0x7e67, // 25968
-    0x7e66, 0x7e65, 0x7e64, 0x7e64, 0x7e63, 0x7e62, 0x7e61, 0x7e60, // 25976
-    0x7e60, 0x7e5f, 0x7e5e, 0x7e5d, 0x7e5c, 0x7e5b, 0x7e5b, 0x7e5a, // 25984
-    0x7e59, 0x7e58, 0x7e57, 0x7e56, 0x7e56, 0x7e55, 0x7e54, 0x7e53, // 25992
-    0x7e52, 0x7e51, 0x7e51, 0x7e50, 0x7e4f, 0x7e4e, 0x7e4d, 0x7e4c, // 26000
-    0x7e4c, 0x7e4b, 0x7e4a, 0x7e49, 0x7e48, 0x7e47, 0x7e47, 0x7e46, // 26008
-    0x7e45, 0x7e44, 0x7e43, 0x7e42, 0x7e42, 0x7e41, 0x7e40, 0x7e3f, // 26016
-    0x7e3e, 0x7e3d, 0x7e3d, 0x7e3c, 0x7e3b, 0x7e3a, 0x7e39, 0x7e38, // 26024
-    0x7e38, 0x7e37, 0x7e36, 0x7e35, 0x7e34, 0x7e34, 0x7e33, 0x7e32, // 26032
-    0x7e31, 0x7e30, 0x7e2f, 0x7e2f, 0x7e2e, 0x7e2d, 0x7e2c, 0x7e2b, // 26040
-    0x7e2a, 0x7e2a, 0x7e29, 0x7e28, 0x7e27, 0x7e26, 0x7e25, 0x7e25, // 26048
-    0x7e24, 0x7e23, 0x7e22, 0x7e21, 0x7e20, 0x7e20, 0x7e1f, 0x7e1e, // 26056
-    0x7e1d, 0x7e1c, 0x7e1b, 0x7e1b, 0x7e1a, 0x7e19, 0x7e18, 0x7e17, // 26064
-    0x7e16, 0x7e16, 0x7e15, 0x7e14, 0x7e13, 0x7e12, 0x7e11, 0x7e11, // 26072
-    0x7e10, 0x7e0f, 0x7e0e, 0x7e0d, 0x7e0c, 0x7e0c, 0x7e0b, 0x7e0a, // 26080
-    0x7e09, 0x7e08, 0x7e08, 0x7e07, 0x7e06, 0x7e05, 0x7e04, 0x7e03, // 26088
-    0x7e03, 0x7e02, 0x7e01, 0x7e00, 0x7dff, 0x7dfe, 0x7dfe, 0x7dfd, // 26096
-    0x7dfc, 0x7dfb, 0x7dfa, 0x7df9, 0x7df9, 0x7df8, 0x7df7, 0x7df6, // 26104
-    0x7df5, 0x7df4, 0x7df4, 0x7df3, 0x7df2, 0x7df1, 0x7df0, 0x7def, // 26112
-    0x7def, 0x7dee, 0x7ded, 0x7dec, 0x7deb, 0x7dea, 0x7dea, 0x7de9, // 26120
-    0x7de8, 0x7de7, 0x7de6, 0x7de5, 0x7de5, 0x7de4, 0x7de3, 0x7de2, // 26128
-    0x7de1, 0x7de0, 0x7de0, 0x7ddf, 0x7dde, 0x7ddd, 0x7ddc, 0x7ddc, // 26136
-    0x7ddb, 0x7dda, 0x7dd9, 0x7dd8, 0x7dd7, 0x7dd7, 0x7dd6, 0x7dd5, // 26144
-    0x7dd4, 0x7dd3, 0x7dd2, 0x7dd2, 0x7dd1, 0x7dd0, 0x7dcf, 0x7dce, // 26152
-    0x7dcd, 0x7dcd, 0x7dcc, 0x7dcb, 0x7dca, 0x7dc9, 0x7dc8, 0x7dc8, // 26160
-    0x7dc7, 0x7dc6, 0x7dc5, 0x7dc4, 0x7dc3, 0x7dc3, 0x7dc2, 0x7dc1, // 26168
-    0x7dc0, 0x7dbf, 0x7dbe, 0x7dbe, 0x7dbd, 0x7dbc, 0x7dbb, 0x7dba, // 26176
-    0x7db9, 0x7db9, 0x7db8, 0x7db7, 0x7db6, 0x7db5, 0x7db5, 0x7db4, // 26184
-    0x7db3, 0x7db2, 0x7db1, 0x7db0, 0x7db0, 0x7daf, 0x7dae, 0x7dad, // 26192
-    0x7dac, 0x7dab, 0x7dab, 0x7daa, 0x7da9, 0x7da8, 0x7da7, 0x7da6, // 26200
-    0x7da6, 0x7da5, 0x7da4, 0x7da3, 0x7da2, 0x7da1, 0x7da1, 0x7da0, // 26208
-    0x7d9f, 0x7d9e, 0x7d9d, 0x7d9c, 0x7d9c, 0x7d9b, 0x7d9a, 0x7d99, // 26216
-    0x7d98, 0x7d97, 0x7d97, 0x7d96, 0x7d95, 0x7d94, 0x7d93, 0x7d92, // 26224
-    0x7d92, 0x7d91, 0x7d90, 0x7d8f, 0x7d8e, 0x7d8d, 0x7d8d, 0x7d8c, // 26232
-    0x7d8b, 0x7d8a, 0x7d89, 0x7d89, 0x7d88, 0x7d87, 0x7d86, 0x7d85, // 26240
-    0x7d84, 0x7d84, 0x7d83, 0x7d82, 0x7d81, 0x7d80, 0x7d7f, 0x7d7f, // 26248
-    0x7d7e, 0x7d7d, 0x7d7c, 0x7d7b, 0x7d7a, 0x7d7a, 0x7d79, 0x7d78, // 26256
-    0x7d77, 0x7d76, 0x7d75, 0x7d75, 0x7d74, 0x7d73, 0x7d72, 0x7d71, // 26264
-    0x7d70, 0x7d70, 0x7d6f, 0x7d6e, 0x7d6d, 0x7d6c, 0x7d6b, 0x7d6b, // 26272
-    0x7d6a, 0x7d69, 0x7d68, 0x7d67, 0x7d66, 0x7d66, 0x7d65, 0x7d64, // 26280
-    0x7d63, 0x7d62, 0x7d61, 0x7d61, 0x7d60, 0x7d5f, 0x7d5e, 0x7d5d, // 26288
-    0x7d5d, 0x7d5c, 0x7d5b, 0x7d5a, 0x7d59, 0x7d58, 0x7d58, 0x7d57, // 26296
-    0x7d56, 0x7d55, 0x7d54, 0x7d53, 0x7d53, 0x7d52, 0x7d51, 0x7d50, // 26304
-    0x7d4f, 0x7d4e, 0x7d4e, 0x7d4d, 0x7d4c, 0x7d4b, 0x7d4a, 0x7d49, // 26312
-    0x7d49, 0x7d48, 0x7d47, 0x7d46, 0x7d45, 0x7d44, 0x7d44, 0x7d43, // 26320
-    0x7d42, 0x7d41, 0x7d40, 0x7d3f, 0x7d3f, 0x7d3e, 0x7d3d, 0x7d3c, // 26328
-    0x7d3b, 0x7d3a, 0x7d3a, 0x7d39, 0x7d38, 0x7d37, 0x7d36, 0x7d36, // 26336
-    0x7d35, 0x7d34, 0x7d33, 0x7d32, 0x7d31, 0x7d31, 0x7d30, 0x7d2f, // 26344
-    0x7d2e, 0x7d2d, 0x7d2c, 0x7d2c, 0x7d2b, 0x7d2a, 0x7d29, 0x7d28, // 26352
-    0x7d27, 0x7d27, 0x7d26, 0x7d25, 0x7d24, 0x7d23, 0x7d22, 0x7d22, // 26360
-    0x7d21, 0x7d20, 0x7d1f, 0x7d1e, 0x7d1d, 0x7d1d, 0x7d1c, 0x7d1b, // 26368
-    0x7d1a, 0x7d19, 0x7d18, 0x7d18, 0x7d17, 0x7d16, 0x7d15, 0x7d14, // 26376
-    0x7d13, 0x7d13, 0x7d12, 0x7d11, 0x7d10, 0x7d0f, 0x7d0e, 0x7d0e, // 26384
-    0x7d0d, 0x7d0c, 0x7d0b, 0x7d0a, 0x7d0a, 0x7d09, 0x7d08, 0x7d07, // 26392
-    0x7d06, 0x7d05, 0x7d05, 0x7d04, 0x7d03, 0x7d02, 0x7d01, 0x7d00, // 26400
-    0x7d00, 0x7cff, 0x7cfe, 0x7cfd, 0x7cfc, 0x7cfb, 0x7cfb, 0x7cfa, // 26408
-    0x7cf9, 0x7cf8, 0x7cf7, 0x7cf6, 0x7cf6, 0x7cf5, 0x7cf4, 0x7cf3, // 26416
-    0x7cf2, 0x7cf1, 0x7cf1, 0x7cf0, 0x7cef, 0x7cee, 0x7ced, 0x7cec, // 26424
-    0x7cec, 0x7ceb, 0x7cea, 0x7ce9, 0x7ce8, 0x7ce7, 0x7ce7, 0x7ce6, // 26432
-    0x7ce5, 0x7ce4, 0x7ce3, 0x7ce2, 0x7ce2, 0x7ce1, 0x7ce0, 0x7cdf, // 26440
-    0x7cde, 0x7cde, 0x7cdd, 0x7cdc, 0x7cdb, 0x7cda, 0x7cd9, 0x7cd9, // 26448
-    0x7cd8, 0x7cd7, 0x7cd6, 0x7cd5, 0x7cd4, 0x7cd4, 0x7cd3, 0x7cd2, // 26456
-    0x7cd1, 0x7cd0, 0x7ccf, 0x7ccf, 0x7cce, 0x7ccd, 0x7ccc, 0x7ccb, // 26464
-    0x7cca, 0x7cca, 0x7cc9, 0x7cc8, 0x7cc7, 0x7cc6, 0x7cc5, 0x7cc5, // 26472
-    0x7cc4, 0x7cc3, 0x7cc2, 0x7cc1, 0x7cc0, 0x7cc0, 0x7cbf, 0x7cbe, // 26480
-    0x7cbd, 0x7cbc, 0x7cbb, 0x7cbb, 0x7cba, 0x7cb9, 0x7cb8, 0x7cb7, // 26488
-    0x7cb7, 0x7cb6, 0x7cb5, 0x7cb4, 0x7cb3, 0x7cb2, 0x7cb2, 0x7cb1, // 26496
-    0x7cb0, 0x7caf, 0x7cae, 0x7cad, 0x7cad, 0x7cac, 0x7cab, 0x7caa, // 26504
-    0x7ca9, 0x7ca8, 0x7ca8, 0x7ca7, 0x7ca6, 0x7ca5, 0x7ca4, 0x7ca3, // 26512
-    0x7ca3, 0x7ca2, 0x7ca1, 0x7ca0, 0x7c9f, 0x7c9e, 0x7c9e, 0x7c9d, // 26520
-    0x7c9c, 0x7c9b, 0x7c9a, 0x7c99, 0x7c99, 0x7c98, 0x7c97, 0x7c96, // 26528
-    0x7c95, 0x7c94, 0x7c94, 0x7c93, 0x7c92, 0x7c91, 0x7c90, 0x7c8f, // 26536
-    0x7c8f, 0x7c8e, 0x7c8d, 0x7c8c, 0x7c8b, 0x7c8b, 0x7c8a, 0x7c89, // 26544
-    0x7c88, 0x7c87, 0x7c86, 0x7c86, 0x7c85, 0x7c84, 0x7c83, 0x7c82, // 26552
-    0x7c81, 0x7c81, 0x7c80, 0x7c7f, 0x7c7e, 0x7c7d, 0x7c7c, 0x7c7c, // 26560
-    0x7c7b, 0x7c7a, 0x7c79, 0x7c78, 0x7c77, 0x7c77, 0x7c76, 0x7c75, // 26568
-    0x7c74, 0x7c73, 0x7c72, 0x7c72, 0x7c71, 0x7c70, 0x7c6f, 0x7c6e, // 26576
-    0x7c6d, 0x7c6d, 0x7c6c, 0x7c6b, 0x7c6a, 0x7c69, 0x7c68, 0x7c68, // 26584
-    0x7c67, 0x7c66, 0x7c65, 0x7c64, 0x7c63, 0x7c63, 0x7c62, 0x7c61, // 26592
-    0x7c60, 0x7c5f, 0x7c5f, 0x7c5e, 0x7c5d, 0x7c5c, 0x7c5b, 0x7c5a, // 26600
-    0x7c5a, 0x7c59, 0x7c58, 0x7c57, 0x7c56, 0x7c55, 0x7c55, 0x7c54, // 26608
-    0x7c53, 0x7c52, 0x7c51, 0x7c50, 0x7c50, 0x7c4f, 0x7c4e, 0x7c4d, // 26616
-    0x7c4d, 0x7c4c, 0x7c4b, 0x7c4b, 0x7c4a, 0x7c49, 0x7c48, 0x7c47, // 26624
-    0x7c47, 0x7c46, 0x7c45, 0x7c44, 0x7c43, 0x7c42, 0x7c42, 0x7c41, // 26632
-    0x7c40, 0x7c3f, 0x7c3e, 0x7c3e, 0x7c3d, 0x7c3c, 0x7c3b, 0x7c3a, // 26640
-    0x7c3a, 0x7c39, 0x7c38, 0x7c37, 0x7c36, 0x7c35, 0x7c35, 0x7c34, // 26648
-    0x7c33, 0x7c32, 0x7c31, 0x7c31, 0x7c30, 0x7c2f, 0x7c2e, 0x7c2d, // 26656
-    0x7c2d, 0x7c2c, 0x7c2b, 0x7c2a, 0x7c29, 0x7c29, 0x7c28, 0x7c27, // 26664
-    0x7c26, 0x7c25, 0x7c24, 0x7c24, 0x7c23, 0x7c22, 0x7c21, 0x7c20, // 26672
-    0x7c20, 0x7c1f, 0x7c1e, 0x7c1d, 0x7c1c, 0x7c1c, 0x7c1b, 0x7c1a, // 26680
-    0x7c19, 0x7c18, 0x7c18, 0x7c17, 0x7c16, 0x7c15, 0x7c14, 0x7c13, // 26688
-    0x7c13, 0x7c12, 0x7c11, 0x7c10, 0x7c0f, 0x7c0f, 0x7c0e, 0x7c0d, // 26696
-    0x7c0c, 0x7c0b, 0x7c0b, 0x7c0a, 0x7c09, 0x7c08, 0x7c07, 0x7c06, // 26704
-    0x7c06, 0x7c05, 0x7c04, 0x7c03, 0x7c02, 0x7c02, 0x7c01, 0x7c00, // 26712
-    0x7bff, 0x7bfe, 0x7bfe, 0x7bfd, 0x7bfc, 0x7bfb, 0x7bfa, 0x7bfa, // 26720
-    0x7bf9, 0x7bf8, 0x7bf7, 0x7bf6, 0x7bf5, 0x7bf5, 0x7bf4, 0x7bf3, // 26728
-    0x7bf2, 0x7bf1, 0x7bf1, 0x7bf0, 0x7bef, 0x7bee, 0x7bed, 0x7bed, // 26736
-    0x7bec, 0x7beb, 0x7bea, 0x7be9, 0x7be8, 0x7be8, 0x7be7, 0x7be6, // 26744
-    0x7be5, 0x7be4, 0x7be4, 0x7be3, 0x7be2, 0x7be1, 0x7be0, 0x7be0, // 26752
-    0x7bdf, 0x7bde, 0x7bdd, 0x7bdc, 0x7bdc, 0x7bdb, 0x7bda, 0x7bd9, // 26760
-    0x7bd8, 0x7bd7, 0x7bd7, 0x7bd6, 0x7bd5, 0x7bd4, 0x7bd3, 0x7bd3, // 26768
-    0x7bd2, 0x7bd1, 0x7bd0, 0x7bcf, 0x7bcf, 0x7bce, 0x7bcd, 0x7bcc, // 26776
-    0x7bcb, 0x7bcb, 0x7bca, 0x7bc9, 0x7bc8, 0x7bc7, 0x7bc6, 0x7bc6, // 26784
-    0x7bc5, 0x7bc4, 0x7bc3, 0x7bc2, 0x7bc2, 0x7bc1, 0x7bc0, 0x7bbf, // 26792
-    0x7bbe, 0x7bbe, 0x7bbd, 0x7bbc, 0x7bbb, 0x7bba, 0x7bb9, 0x7bb9, // 26800
-    0x7bb8, 0x7bb7, 0x7bb6, 0x7bb5, 0x7bb5, 0x7bb4, 0x7bb3, 0x7bb2, // 26808
-    0x7bb1, 0x7bb1, 0x7bb0, 0x7baf, 0x7bae, 0x7bad, 0x7bad, 0x7bac, // 26816
-    0x7bab, 0x7baa, 0x7ba9, 0x7ba8, 0x7ba8, 0x7ba7, 0x7ba6, 0x7ba5, // 26824
-    0x7ba4, 0x7ba4, 0x7ba3, 0x7ba2, 0x7ba1, 0x7ba0, 0x7ba0, 0x7b9f, // 26832
-    0x7b9e, 0x7b9d, 0x7b9c, 0x7b9b, 0x7b9b, 0x7b9a, 0x7b99, 0x7b98, // 26840
-    0x7b97, 0x7b97, 0x7b96, 0x7b95, 0x7b94, 0x7b93, 0x7b93, 0x7b92, // 26848
-    0x7b91, 0x7b90, 0x7b8f, 0x7b8f, 0x7b8e, 0x7b8d, 0x7b8c, 0x7b8b, // 26856
-    0x7b8a, 0x7b8a, 0x7b89, 0x7b88, 0x7b87, 0x7b86, 0x7b86, 0x7b85, // 26864
-    0x7b84, 0x7b83, 0x7b82, 0x7b82, 0x7b81, 0x7b80, 0x7b7f, 0x7b7e, // 26872
-    0x7b7e, 0x7b7d, 0x7b7c, 0x7b7b, 0x7b7a, 0x7b79, 0x7b79, 0x7b78, // 26880
-    0x7b77, 0x7b76, 0x7b75, 0x7b75, 0x7b74, 0x7b73, 0x7b72, 0x7b71, // 26888
-    0x7b71, 0x7b70, 0x7b6f, 0x7b6e, 0x7b6d, 0x7b6c, 0x7b6c, 0x7b6b, // 26896
-    0x7b6a, 0x7b69, 0x7b68, 0x7b68, 0x7b67, 0x7b66, 0x7b65, 0x7b64, // 26904
-    0x7b64, 0x7b63, 0x7b62, 0x7b61, 0x7b60, 0x7b60, 0x7b5f, 0x7b5e, // 26912
-    0x7b5d, 0x7b5c, 0x7b5b, 0x7b5b, 0x7b5a, 0x7b59, 0x7b58, 0x7b57, // 26920
-    0x7b57, 0x7b56, 0x7b55, 0x7b54, 0x7b53, 0x7b53, 0x7b52, 0x7b51, // 26928
-    0x7b50, 0x7b4f, 0x7b4e, 0x7b4e, 0x7b4d, 0x7b4c, 0x7b4b, 0x7b4a, // 26936
-    0x7b4a, 0x7b49, 0x7b48, 0x7b47, 0x7b46, 0x7b46, 0x7b45, 0x7b44, // 26944
-    0x7b43, 0x7b42, 0x7b42, 0x7b41, 0x7b40, 0x7b3f, 0x7b3e, 0x7b3d, // 26952
-    0x7b3d, 0x7b3c, 0x7b3b, 0x7b3a, 0x7b39, 0x7b39, 0x7b38, 0x7b37, // 26960
-    0x7b36, 0x7b35, 0x7b35, 0x7b34, 0x7b33, 0x7b32, 0x7b31, 0x7b30, // 26968
-    0x7b30, 0x7b2f, 0x7b2e, 0x7b2d, 0x7b2c, 0x7b2c, 0x7b2b, 0x7b2a, // 26976
-    0x7b29, 0x7b28, 0x7b28, 0x7b27, 0x7b26, 0x7b25, 0x7b24, 0x7b24, // 26984
-    0x7b23, 0x7b22, 0x7b21, 0x7b20, 0x7b1f, 0x7b1f, 0x7b1e, 0x7b1d, // 26992
-    0x7b1c, 0x7b1b, 0x7b1b, 0x7b1a, 0x7b19, 0x7b18, 0x7b17, 0x7b17, // 27000
-    0x7b16, 0x7b15, 0x7b14, 0x7b13, 0x7b13, 0x7b12, 0x7b11, 0x7b10, // 27008
-    0x7b0f, 0x7b0e, 0x7b0e, 0x7b0d, 0x7b0c, 0x7b0b, 0x7b0a, 0x7b0a, // 27016
-    0x7b09, 0x7b08, 0x7b07, 0x7b06, 0x7b06, 0x7b05, 0x7b04, 0x7b03, // 27024
-    0x7b02, 0x7b01, 0x7b01, 0x7b00, 0x7aff, 0x7afe, 0x7afd, 0x7afd, // 27032
-    0x7afc, 0x7afb, 0x7afa, 0x7af9, 0x7af9, 0x7af8, 0x7af7, 0x7af6, // 27040
-    0x7af5, 0x7af5, 0x7af4, 0x7af3, 0x7af2, 0x7af1, 0x7af0, 0x7af0, // 27048
-    0x7aef, 0x7aee, 0x7aed, 0x7aec, 0x7aec, 0x7aeb, 0x7aea, 0x7ae9, // 27056
-    0x7ae8, 0x7ae8, 0x7ae7, 0x7ae6, 0x7ae5, 0x7ae4, 0x7ae3, 0x7ae3, // 27064
-    0x7ae2, 0x7ae1, 0x7ae0, 0x7adf, 0x7adf, 0x7ade, 0x7add, 0x7adc, // 27072
-    0x7adb, 0x7adb, 0x7ada, 0x7ad9, 0x7ad8, 0x7ad7, 0x7ad7, 0x7ad6, // 27080
-    0x7ad5, 0x7ad4, 0x7ad3, 0x7ad2, 0x7ad2, 0x7ad1, 0x7ad0, 0x7acf, // 27088
-    0x7ace, 0x7ace, 0x7acd, 0x7acc, 0x7acb, 0x7aca, 0x7aca, 0x7ac9, // 27096
-    0x7ac8, 0x7ac7, 0x7ac6, 0x7ac6, 0x7ac5, 0x7ac4, 0x7ac3, 0x7ac2, // 27104
-    0x7ac1, 0x7ac1, 0x7ac0, 0x7abf, 0x7abe, 0x7abd, 0x7abd, 0x7abc, // 27112
-    0x7abb, 0x7aba, 0x7ab9, 0x7ab9, 0x7ab8, 0x7ab7, 0x7ab6, 0x7ab5, // 27120
-    0x7ab4, 0x7ab4, 0x7ab3, 0x7ab2, 0x7ab1, 0x7ab0, 0x7ab0, 0x7aaf, // 27128
-    0x7aae, 0x7aad, 0x7aac, 0x7aac, 0x7aab, 0x7aaa, 0x7aa9, 0x7aa8, // 27136
-    0x7aa8, 0x7aa7, 0x7aa6, 0x7aa5, 0x7aa4, 0x7aa3, 0x7aa3, 0x7aa2, // 27144
-    0x7aa1, 0x7aa0, 0x7a9f, 0x7a9f, 0x7a9e, 0x7a9d, 0x7a9c, 0x7a9b, // 27152
-    0x7a9b, 0x7a9a, 0x7a99, 0x7a98, 0x7a97, 0x7a96, 0x7a96, 0x7a95, // 27160
-    0x7a94, 0x7a93, 0x7a92, 0x7a92, 0x7a91, 0x7a90, 0x7a8f, 0x7a8e, // 27168
-    0x7a8e, 0x7a8d, 0x7a8c, 0x7a8b, 0x7a8a, 0x7a8a, 0x7a89, 0x7a88, // 27176
-    0x7a87, 0x7a86, 0x7a85, 0x7a85, 0x7a84, 0x7a83, 0x7a82, 0x7a81, // 27184
-    0x7a81, 0x7a80, 0x7a7f, 0x7a7e, 0x7a7d, 0x7a7d, 0x7a7c, 0x7a7b, // 27192
-    0x7a7a, 0x7a79, 0x7a79, 0x7a78, 0x7a77, 0x7a76, 0x7a75, 0x7a74, // 27200
-    0x7a74, 0x7a73, 0x7a72, 0x7a71, 0x7a70, 0x7a70, 0x7a6f, 0x7a6e, // 27208
-    0x7a6d, 0x7a6c, 0x7a6c, 0x7a6b, 0x7a6a, 0x7a69, 0x7a68, 0x7a67, // 27216
-    0x7a67, 0x7a66, 0x7a65, 0x7a64, 0x7a63, 0x7a63, 0x7a62, 0x7a61, // 27224
-    0x7a60, 0x7a5f, 0x7a5f, 0x7a5e, 0x7a5d, 0x7a5c, 0x7a5b, 0x7a5b, // 27232
-    0x7a5a, 0x7a59, 0x7a58, 0x7a57, 0x7a56, 0x7a56, 0x7a55, 0x7a54, // 27240
-    0x7a53, 0x7a52, 0x7a52, 0x7a51, 0x7a50, 0x7a4f, 0x7a4e, 0x7a4e, // 27248
-    0x7a4d, 0x7a4c, 0x7a4b, 0x7a4a, 0x7a49, 0x7a49, 0x7a48, 0x7a47, // 27256
-    0x7a46, 0x7a45, 0x7a45, 0x7a44, 0x7a43, 0x7a42, 0x7a41, 0x7a41, // 27264
-    0x7a40, 0x7a3f, 0x7a3e, 0x7a3d, 0x7a3d, 0x7a3c, 0x7a3b, 0x7a3a, // 27272
-    0x7a39, 0x7a38, 0x7a38, 0x7a37, 0x7a36, 0x7a35, 0x7a34, 0x7a34, // 27280
-    0x7a33, 0x7a32, 0x7a31, 0x7a30, 0x7a30, 0x7a2f, 0x7a2e, 0x7a2d, // 27288
-    0x7a2c, 0x7a2c, 0x7a2b, 0x7a2a, 0x7a29, 0x7a28, 0x7a27, 0x7a27, // 27296
-    0x7a26, 0x7a25, 0x7a24, 0x7a23, 0x7a23, 0x7a22, 0x7a21, 0x7a20, // 27304
-    0x7a1f, 0x7a1f, 0x7a1e, 0x7a1d, 0x7a1c, 0x7a1b, 0x7a1a, 0x7a1a, // 27312
-    0x7a19, 0x7a18, 0x7a17, 0x7a16, 0x7a16, 0x7a15, 0x7a14, 0x7a13, // 27320
-    0x7a12, 0x7a12, 0x7a11, 0x7a10, 0x7a0f, 0x7a0e, 0x7a0e, 0x7a0d, // 27328
-    0x7a0c, 0x7a0b, 0x7a0a, 0x7a09, 0x7a09, 0x7a08, 0x7a07, 0x7a06, // 27336
-    0x7a05, 0x7a05, 0x7a04, 0x7a03, 0x7a02, 0x7a01, 0x7a01, 0x7a00, // 27344
-    0x79ff, 0x79fe, 0x79fd, 0x79fc, 0x79fc, 0x79fb, 0x79fa, 0x79f9, // 27352
-    0x79f8, 0x79f8, 0x79f7, 0x79f6, 0x79f5, 0x79f4, 0x79f4, 0x79f3, // 27360
-    0x79f2, 0x79f1, 0x79f0, 0x79f0, 0x79ef, 0x79ee, 0x79ed, 0x79ec, // 27368
-    0x79eb, 0x79eb, 0x79ea, 0x79e9, 0x79e8, 0x79e7, 0x79e7, 0x79e6, // 27376
-    0x79e5, 0x79e4, 0x79e3, 0x79e3, 0x79e2, 0x79e1, 0x79e0, 0x79df, // 27384
-    0x79df, 0x79de, 0x79dd, 0x79dc, 0x79db, 0x79da, 0x79da, 0x79d9, // 27392
-    0x79d8, 0x79d7, 0x79d6, 0x79d6, 0x79d5, 0x79d4, 0x79d3, 0x79d2, // 27400
-    0x79d2, 0x79d1, 0x79d0, 0x79cf, 0x79ce, 0x79cd, 0x79cd, 0x79cc, // 27408
-    0x79cb, 0x79ca, 0x79c9, 0x79c9, 0x79c8, 0x79c7, 0x79c6, 0x79c5, // 27416
-    0x79c5, 0x79c4, 0x79c3, 0x79c2, 0x79c1, 0x79c1, 0x79c0, 0x79bf, // 27424
-    0x79be, 0x79bd, 0x79bc, 0x79bc, 0x79bb, 0x79ba, 0x79b9, 0x79b8, // 27432
-    0x79b8, 0x79b7, 0x79b6, 0x79b5, 0x79b4, 0x79b4, 0x79b3, 0x79b2, // 27440
-    0x79b1, 0x79b0, 0x79af, 0x79af, 0x79ae, 0x79ad, 0x79ac, 0x79ab, // 27448
-    0x79ab, 0x79aa, 0x79a9, 0x79a8, 0x79a7, 0x79a7, 0x79a6, 0x79a5, // 27456
-    0x79a4, 0x79a3, 0x79a3, 0x79a2, 0x79a1, 0x79a0, 0x799f, 0x799e, // 27464
-    0x799e, 0x799d, 0x799c, 0x799b, 0x799a, 0x799a, 0x7999, 0x7998, // 27472
-    0x7997, 0x7996, 0x7996, 0x7995, 0x7994, 0x7993, 0x7992, 0x7991, // 27480
-    0x7991, 0x7990, 0x798f, 0x798e, 0x798d, 0x798d, 0x798c, 0x798b, // 27488
-    0x798a, 0x7989, 0x7989, 0x7988, 0x7987, 0x7986, 0x7985, 0x7985, // 27496
-    0x7984, 0x7983, 0x7982, 0x7981, 0x7980, 0x7980, 0x797f, 0x797e, // 27504
-    0x797d, 0x797c, 0x797c, 0x797b, 0x797a, 0x7979, 0x7978, 0x7978, // 27512
-    0x7977, 0x7976, 0x7975, 0x7974, 0x7974, 0x7973, 0x7972, 0x7971, // 27520
-    0x7970, 0x796f, 0x796f, 0x796e, 0x796d, 0x796c, 0x796b, 0x796b, // 27528
-    0x796a, 0x7969, 0x7968, 0x7967, 0x7967, 0x7966, 0x7965, 0x7964, // 27536
-    0x7963, 0x7962, 0x7962, 0x7961, 0x7960, 0x795f, 0x795e, 0x795e, // 27544
-    0x795d, 0x795c, 0x795b, 0x795a, 0x795a, 0x7959, 0x7958, 0x7957, // 27552
-    0x7956, 0x7956, 0x7955, 0x7954, 0x7953, 0x7952, 0x7951, 0x7951, // 27560
-    0x7950, 0x794f, 0x794e, 0x794d, 0x794d, 0x794c, 0x794b, 0x794a, // 27568
-    0x7949, 0x7949, 0x7948, 0x7947, 0x7946, 0x7945, 0x7944, 0x7944, // 27576
-    0x7943, 0x7942, 0x7941, 0x7940, 0x7940, 0x793f, 0x793e, 0x793d, // 27584
-    0x793c, 0x793c, 0x793b, 0x793a, 0x7939, 0x7938, 0x7938, 0x7937, // 27592
-    0x7936, 0x7935, 0x7934, 0x7933, 0x7933, 0x7932, 0x7931, 0x7930, // 27600
-    0x792f, 0x792f, 0x792e, 0x792d, 0x792c, 0x792b, 0x792b, 0x792a, // 27608
-    0x7929, 0x7928, 0x7927, 0x7927, 0x7926, 0x7925, 0x7924, 0x7923, // 27616
-    0x7922, 0x7922, 0x7921, 0x7920, 0x791f, 0x791e, 0x791e, 0x791d, // 27624
-    0x791c, 0x791b, 0x791a, 0x791a, 0x7919, 0x7918, 0x7917, 0x7916, // 27632
-    0x7915, 0x7915, 0x7914, 0x7913, 0x7912, 0x7911, 0x7911, 0x7910, // 27640
-    0x790f, 0x790e, 0x790d, 0x790d, 0x790c, 0x790b, 0x790a, 0x7909, // 27648
-    0x7909, 0x7908, 0x7907, 0x7906, 0x7906, 0x7905, 0x7904, 0x7903, // 27656
-    0x7902, 0x7902, 0x7901, 0x7900, 0x78ff, 0x78fe, 0x78fe, 0x78fd, // 27664
-    0x78fc, 0x78fb, 0x78fb, 0x78fa, 0x78f9, 0x78f8, 0x78f7, 0x78f7, // 27672
-    0x78f6, 0x78f5, 0x78f4, 0x78f3, 0x78f3, 0x78f2, 0x78f1, 0x78f0, // 27680
-    0x78f0, 0x78ef, 0x78ee, 0x78ed, 0x78ec, 0x78ec, 0x78eb, 0x78ea, // 27688
-    0x78e9, 0x78e8, 0x78e8, 0x78e7, 0x78e6, 0x78e5, 0x78e4, 0x78e4, // 27696
-    0x78e3, 0x78e2, 0x78e1, 0x78e1, 0x78e0, 0x78df, 0x78de, 0x78dd, // 27704
-    0x78dd, 0x78dc, 0x78db, 0x78da, 0x78d9, 0x78d9, 0x78d8, 0x78d7, // 27712
-    0x78d6, 0x78d6, 0x78d5, 0x78d4, 0x78d3, 0x78d2, 0x78d2, 0x78d1, // 27720
-    0x78d0, 0x78cf, 0x78ce, 0x78ce, 0x78cd, 0x78cc, 0x78cb, 0x78cb, // 27728
-    0x78ca, 0x78c9, 0x78c8, 0x78c7, 0x78c7, 0x78c6, 0x78c5, 0x78c4, // 27736
-    0x78c3, 0x78c3, 0x78c2, 0x78c1, 0x78c0, 0x78c0, 0x78bf, 0x78be, // 27744
-    0x78bd, 0x78bc, 0x78bc, 0x78bb, 0x78ba, 0x78b9, 0x78b8, 0x78b8, // 27752
-    0x78b7, 0x78b6, 0x78b5, 0x78b4, 0x78b4, 0x78b3, 0x78b2, 0x78b1, // 27760
-    0x78b1, 0x78b0, 0x78af, 0x78ae, 0x78ad, 0x78ad, 0x78ac, 0x78ab, // 27768
-    0x78aa, 0x78a9, 0x78a9, 0x78a8, 0x78a7, 0x78a6, 0x78a6, 0x78a5, // 27776
-    0x78a4, 0x78a3, 0x78a2, 0x78a2, 0x78a1, 0x78a0, 0x789f, 0x789e, // 27784
-    0x789e, 0x789d, 0x789c, 0x789b, 0x789b, 0x789a, 0x7899, 0x7898, // 27792
-    0x7897, 0x7897, 0x7896, 0x7895, 0x7894, 0x7893, 0x7893, 0x7892, // 27800
-    0x7891, 0x7890, 0x788f, 0x788f, 0x788e, 0x788d, 0x788c, 0x788c, // 27808
-    0x788b, 0x788a, 0x7889, 0x7888, 0x7888, 0x7887, 0x7886, 0x7885, // 27816
-    0x7884, 0x7884, 0x7883, 0x7882, 0x7881, 0x7881, 0x7880, 0x787f, // 27824
-    0x787e, 0x787d, 0x787d, 0x787c, 0x787b, 0x787a, 0x7879, 0x7879, // 27832
-    0x7878, 0x7877, 0x7876, 0x7876, 0x7875, 0x7874, 0x7873, 0x7872, // 27840
-    0x7872, 0x7871, 0x7870, 0x786f, 0x786e, 0x786e, 0x786d, 0x786c, // 27848
-    0x786b, 0x786a, 0x786a, 0x7869, 0x7868, 0x7867, 0x7867, 0x7866, // 27856
-    0x7865, 0x7864, 0x7863, 0x7863, 0x7862, 0x7861, 0x7860, 0x785f, // 27864
-    0x785f, 0x785e, 0x785d, 0x785c, 0x785c, 0x785b, 0x785a, 0x7859, // 27872
-    0x7858, 0x7858, 0x7857, 0x7856, 0x7855, 0x7854, 0x7854, 0x7853, // 27880
-    0x7852, 0x7851, 0x7851, 0x7850, 0x784f, 0x784e, 0x784d, 0x784d, // 27888
-    0x784c, 0x784b, 0x784a, 0x7849, 0x7849, 0x7848, 0x7847, 0x7846, // 27896
-    0x7846, 0x7845, 0x7844, 0x7843, 0x7842, 0x7842, 0x7841, 0x7840, // 27904
-    0x783f, 0x783e, 0x783e, 0x783d, 0x783c, 0x783b, 0x783a, 0x783a, // 27912
-    0x7839, 0x7838, 0x7837, 0x7837, 0x7836, 0x7835, 0x7834, 0x7833, // 27920
-    0x7833, 0x7832, 0x7831, 0x7830, 0x782f, 0x782f, 0x782e, 0x782d, // 27928
-    0x782c, 0x782c, 0x782b, 0x782a, 0x7829, 0x7828, 0x7828, 0x7827, // 27936
-    0x7826, 0x7825, 0x7824, 0x7824, 0x7823, 0x7822, 0x7821, 0x7821, // 27944
-    0x7820, 0x781f, 0x781e, 0x781d, 0x781d, 0x781c, 0x781b, 0x781a, // 27952
-    0x7819, 0x7819, 0x7818, 0x7817, 0x7816, 0x7815, 0x7815, 0x7814, // 27960
-    0x7813, 0x7812, 0x7812, 0x7811, 0x7810, 0x780f, 0x780e, 0x780e, // 27968
-    0x780d, 0x780c, 0x780b, 0x780a, 0x780a, 0x7809, 0x7808, 0x7807, // 27976
-    0x7807, 0x7806, 0x7805, 0x7804, 0x7803, 0x7803, 0x7802, 0x7801, // 27984
-    0x7800, 0x77ff, 0x77ff, 0x77fe, 0x77fd, 0x77fc, 0x77fc, 0x77fb, // 27992
-    0x77fa, 0x77f9, 0x77f8, 0x77f8, 0x77f7, 0x77f6, 0x77f5, 0x77f4, // 28000
-    0x77f4, 0x77f3, 0x77f2, 0x77f1, 0x77f0, 0x77f0, 0x77ef, 0x77ee, // 28008
-    0x77ed, 0x77ed, 0x77ec, 0x77eb, 0x77ea, 0x77e9, 0x77e9, 0x77e8, // 28016
-    0x77e7, 0x77e6, 0x77e5, 0x77e5, 0x77e4, 0x77e3, 0x77e2, 0x77e2, // 28024
-    0x77e1, 0x77e0, 0x77df, 0x77de, 0x77de, 0x77dd, 0x77dc, 0x77db, // 28032
-    0x77da, 0x77da, 0x77d9, 0x77d8, 0x77d7, 0x77d7, 0x77d6, 0x77d5, // 28040
-    0x77d4, 0x77d3, 0x77d3, 0x77d2, 0x77d1, 0x77d0, 0x77cf, 0x77cf, // 28048
-    0x77ce, 0x77cd, 0x77cc, 0x77cb, 0x77cb, 0x77ca, 0x77c9, 0x77c8, // 28056
-    0x77c8, 0x77c7, 0x77c6, 0x77c5, 0x77c4, 0x77c4, 0x77c3, 0x77c2, // 28064
-    0x77c1, 0x77c0, 0x77c0, 0x77bf, 0x77be, 0x77bd, 0x77bd, 0x77bc, // 28072
-    0x77bb, 0x77ba, 0x77b9, 0x77b9, 0x77b8, 0x77b7, 0x77b6, 0x77b5, // 28080
-    0x77b5, 0x77b4, 0x77b3, 0x77b2, 0x77b2, 0x77b1, 0x77b0, 0x77af, // 28088
-    0x77ae, 0x77ae, 0x77ad, 0x77ac, 0x77ab, 0x77aa, 0x77aa, 0x77a9, // 28096
-    0x77a8, 0x77a7, 0x77a7, 0x77a6, 0x77a5, 0x77a4, 0x77a3, 0x77a3, // 28104
-    0x77a2, 0x77a1, 0x77a0, 0x779f, 0x779f, 0x779e, 0x779d, 0x779c, // 28112
-    0x779b, 0x779b, 0x779a, 0x7799, 0x7798, 0x7798, 0x7797, 0x7796, // 28120
-    0x7795, 0x7794, 0x7794, 0x7793, 0x7792, 0x7791, 0x7790, 0x7790, // 28128
-    0x778f, 0x778e, 0x778d, 0x778d, 0x778c, 0x778b, 0x778a, 0x7789, // 28136
-    0x7789, 0x7788, 0x7787, 0x7786, 0x7785, 0x7785, 0x7784, 0x7783, // 28144
-    0x7782, 0x7782, 0x7781, 0x7780, 0x777f, 0x777e, 0x777e, 0x777d, // 28152
-    0x777c, 0x777b, 0x777a, 0x777a, 0x7779, 0x7778, 0x7777, 0x7776, // 28160
-    0x7776, 0x7775, 0x7774, 0x7773, 0x7773, 0x7772, 0x7771, 0x7770, // 28168
-    0x776f, 0x776f, 0x776e, 0x776d, 0x776c, 0x776b, 0x776b, 0x776a, // 28176
-    0x7769, 0x7768, 0x7768, 0x7767, 0x7766, 0x7765, 0x7764, 0x7764, // 28184
-    0x7763, 0x7762, 0x7761, 0x7760, 0x7760, 0x775f, 0x775e, 0x775d, // 28192
-    0x775d, 0x775c, 0x775b, 0x775a, 0x7759, 0x7759, 0x7758, 0x7757, // 28200
-    0x7756, 0x7755, 0x7755, 0x7754, 0x7753, 0x7752, 0x7751, 0x7751, // 28208
-    0x7750, 0x774f, 0x774e, 0x774e, 0x774d, 0x774c, 0x774b, 0x774a, // 28216
-    0x774a, 0x7749, 0x7748, 0x7747, 0x7746, 0x7746, 0x7745, 0x7744, // 28224
-    0x7743, 0x7743, 0x7742, 0x7741, 0x7740, 0x773f, 0x773f, 0x773e, // 28232
-    0x773d, 0x773c, 0x773b, 0x773b, 0x773a, 0x7739, 0x7738, 0x7738, // 28240
-    0x7737, 0x7736, 0x7735, 0x7734, 0x7734, 0x7733, 0x7732, 0x7731, // 28248
-    0x7730, 0x7730, 0x772f, 0x772e, 0x772d, 0x772d, 0x772c, 0x772b, // 28256
-    0x772a, 0x7729, 0x7729, 0x7728, 0x7727, 0x7726, 0x7725, 0x7725, // 28264
-    0x7724, 0x7723, 0x7722, 0x7721, 0x7721, 0x7720, 0x771f, 0x771e, // 28272
-    0x771e, 0x771d, 0x771c, 0x771b, 0x771a, 0x771a, 0x7719, 0x7718, // 28280
-    0x7717, 0x7716, 0x7716, 0x7715, 0x7714, 0x7713, 0x7713, 0x7712, // 28288
-    0x7711, 0x7710, 0x770f, 0x770f, 0x770e, 0x770d, 0x770c, 0x770b, // 28296
-    0x770b, 0x770a, 0x7709, 0x7708, 0x7708, 0x7707, 0x7706, 0x7705, // 28304
-    0x7704, 0x7704, 0x7703, 0x7702, 0x7701, 0x7700, 0x7700, 0x76ff, // 28312
-    0x76fe, 0x76fd, 0x76fc, 0x76fc, 0x76fb, 0x76fa, 0x76f9, 0x76f9, // 28320
-    0x76f8, 0x76f7, 0x76f6, 0x76f5, 0x76f5, 0x76f4, 0x76f3, 0x76f2, // 28328
-    0x76f1, 0x76f1, 0x76f0, 0x76ef, 0x76ee, 0x76ee, 0x76ed, 0x76ec, // 28336
-    0x76eb, 0x76ea, 0x76ea, 0x76e9, 0x76e8, 0x76e7, 0x76e6, 0x76e6, // 28344
-    0x76e5, 0x76e4, 0x76e3, 0x76e3, 0x76e2, 0x76e1, 0x76e0, 0x76df, // 28352
-    0x76df, 0x76de, 0x76dd, 0x76dc, 0x76db, 0x76db, 0x76da, 0x76d9, // 28360
-    0x76d8, 0x76d7, 0x76d7, 0x76d6, 0x76d5, 0x76d4, 0x76d4, 0x76d3, // 28368
-    0x76d2, 0x76d1, 0x76d0, 0x76d0, 0x76cf, 0x76ce, 0x76cd, 0x76cc, // 28376
-    0x76cc, 0x76cb, 0x76ca, 0x76c9, 0x76c9, 0x76c8, 0x76c7, 0x76c6, // 28384
-    0x76c5, 0x76c5, 0x76c4, 0x76c3, 0x76c2, 0x76c1, 0x76c1, 0x76c0, // 28392
-    0x76bf, 0x76be, 0x76be, 0x76bd, 0x76bc, 0x76bb, 0x76ba, 0x76ba, // 28400
-    0x76b9, 0x76b8, 0x76b7, 0x76b6, 0x76b6, 0x76b5, 0x76b4, 0x76b3, // 28408
-    0x76b3, 0x76b2, 0x76b1, 0x76b0, 0x76af, 0x76af, 0x76ae, 0x76ad, // 28416
-    0x76ac, 0x76ab, 0x76ab, 0x76aa, 0x76a9, 0x76a8, 0x76a7, 0x76a7, // 28424
-    0x76a6, 0x76a5, 0x76a4, 0x76a4, 0x76a3, 0x76a2, 0x76a1, 0x76a0, // 28432
-    0x76a0, 0x769f, 0x769e, 0x769d, 0x769c, 0x769c, 0x769b, 0x769a, // 28440
-    0x7699, 0x7699, 0x7698, 0x7697, 0x7696, 0x7695, 0x7695, 0x7694, // 28448
-    0x7693, 0x7692, 0x7691, 0x7691, 0x7690, 0x768f, 0x768e, 0x768e, // 28456
-    0x768d, 0x768c, 0x768b, 0x768a, 0x768a, 0x7689, 0x7688, 0x7687, // 28464
-    0x7686, 0x7686, 0x7685, 0x7684, 0x7683, 0x7682, 0x7682, 0x7681, // 28472
-    0x7680, 0x767f, 0x767f, 0x767e, 0x767d, 0x767c, 0x767b, 0x767b, // 28480
-    0x767a, 0x7679, 0x7678, 0x7677, 0x7677, 0x7676, 0x7675, 0x7674, // 28488
-    0x7674, 0x7673, 0x7672, 0x7671, 0x7670, 0x7670, 0x766f, 0x766e, // 28496
-    0x766d, 0x766c, 0x766c, 0x766b, 0x766a, 0x7669, 0x7669, 0x7668, // 28504
-    0x7667, 0x7666, 0x7665, 0x7665, 0x7664, 0x7663, 0x7662, 0x7661, // 28512
-    0x7661, 0x7660, 0x765f, 0x765e, 0x765d, 0x765d, 0x765c, 0x765b, // 28520
-    0x765a, 0x765a, 0x7659, 0x7658, 0x7657, 0x7656, 0x7656, 0x7655, // 28528
-    0x7654, 0x7653, 0x7652, 0x7652, 0x7651, 0x7650, 0x764f, 0x764f, // 28536
-    0x764e, 0x764d, 0x764c, 0x764b, 0x764b, 0x764a, 0x7649, 0x7648, // 28544
-    0x7647, 0x7647, 0x7646, 0x7645, 0x7644, 0x7644, 0x7643, 0x7642, // 28552
-    0x7641, 0x7640, 0x7640, 0x763f, 0x763e, 0x763d, 0x763c, 0x763c, // 28560
-    0x763b, 0x763a, 0x7639, 0x7638, 0x7638, 0x7637, 0x7636, 0x7635, // 28568
-    0x7635, 0x7634, 0x7633, 0x7632, 0x7631, 0x7631, 0x7630, 0x762f, // 28576
-    0x762e, 0x762d, 0x762d, 0x762c, 0x762b, 0x762a, 0x762a, 0x7629, // 28584
-    0x7628, 0x7627, 0x7626, 0x7626, 0x7625, 0x7624, 0x7623, 0x7622, // 28592
-    0x7622, 0x7621, 0x7620, 0x761f, 0x761f, 0x761e, 0x761d, 0x761c, // 28600
-    0x761b, 0x761b, 0x761a, 0x7619, 0x7618, 0x7617, 0x7617, 0x7616, // 28608
-    0x7615, 0x7614, 0x7614, 0x7613, 0x7612, 0x7611, 0x7610, 0x7610, // 28616
-    0x760f, 0x760e, 0x760d, 0x760c, 0x760c, 0x760b, 0x760a, 0x7609, // 28624
-    0x7608, 0x7608, 0x7607, 0x7606, 0x7605, 0x7605, 0x7604, 0x7603, // 28632
-    0x7602, 0x7601, 0x7601, 0x7600, 0x75ff, 0x75fe, 0x75fd, 0x75fd, // 28640
-    0x75fc, 0x75fb, 0x75fa, 0x75fa, 0x75f9, 0x75f8, 0x75f7, 0x75f6, // 28648
-    0x75f6, 0x75f5, 0x75f4, 0x75f3, 0x75f2, 0x75f2, 0x75f1, 0x75f0, // 28656
-    0x75ef, 0x75ef, 0x75ee, 0x75ed, 0x75ec, 0x75eb, 0x75eb, 0x75ea, // 28664
-    0x75e7, 0x75e6, 0x75e6, 0x75e5, 0x75e4, 0x75e3, 0x75e3, 0x75e2, // 28672
-    0x75e1, 0x75e0, 0x75e0, 0x75df, 0x75de, 0x75dd, 0x75dd, 0x75dc, // 28680
-    0x75db, 0x75da, 0x75d9, 0x75d9, 0x75d8, 0x75d7, 0x75d6, 0x75d6, // 28688
-    0x75d5, 0x75d4, 0x75d3, 0x75d3, 0x75d2, 0x75d1, 0x75d0, 0x75cf, // 28696
-    0x75cf, 0x75ce, 0x75cd, 0x75cc, 0x75cc, 0x75cb, 0x75ca, 0x75c9, // 28704
-    0x75c9, 0x75c8, 0x75c7, 0x75c6, 0x75c5, 0x75c5, 0x75c4, 0x75c3, // 28712
-    0x75c2, 0x75c2, 0x75c1, 0x75c0, 0x75bf, 0x75bf, 0x75be, 0x75bd, // 28720
-    0x75bc, 0x75bb, 0x75bb, 0x75ba, 0x75b9, 0x75b8, 0x75b8, 0x75b7, // 28728
-    0x75b6, 0x75b5, 0x75b5, 0x75b4, 0x75b3, 0x75b2, 0x75b2, 0x75b1, // 28736
-    0x75b0, 0x75af, 0x75ae, 0x75ae, 0x75ad, 0x75ac, 0x75ab, 0x75ab, // 28744
-    0x75aa, 0x75a9, 0x75a8, 0x75a8, 0x75a7, 0x75a6, 0x75a5, 0x75a4, // 28752
-    0x75a4, 0x75a3, 0x75a2, 0x75a1, 0x75a1, 0x75a0, 0x759f, 0x759e, // 28760
-    0x759e, 0x759d, 0x759c, 0x759b, 0x759a, 0x759a, 0x7599, 0x7598, // 28768
-    0x7597, 0x7597, 0x7596, 0x7595, 0x7594, 0x7594, 0x7593, 0x7592, // 28776
-    0x7591, 0x7591, 0x7590, 0x758f, 0x758e, 0x758d, 0x758d, 0x758c, // 28784
-    0x758b, 0x758a, 0x758a, 0x7589, 0x7588, 0x7587, 0x7587, 0x7586, // 28792
-    0x7585, 0x7584, 0x7583, 0x7583, 0x7582, 0x7581, 0x7580, 0x7580, // 28800
-    0x757f, 0x757e, 0x757d, 0x757d, 0x757c, 0x757b, 0x757a, 0x7579, // 28808
-    0x7579, 0x7578, 0x7577, 0x7576, 0x7576, 0x7575, 0x7574, 0x7573, // 28816
-    0x7573, 0x7572, 0x7571, 0x7570, 0x7570, 0x756f, 0x756e, 0x756d, // 28824
-    0x756c, 0x756c, 0x756b, 0x756a, 0x7569, 0x7569, 0x7568, 0x7567, // 28832
-    0x7566, 0x7566, 0x7565, 0x7564, 0x7563, 0x7562, 0x7562, 0x7561, // 28840
-    0x7560, 0x755f, 0x755f, 0x755e, 0x755d, 0x755c, 0x755c, 0x755b, // 28848
-    0x755a, 0x7559, 0x7558, 0x7558, 0x7557, 0x7556, 0x7555, 0x7555, // 28856
-    0x7554, 0x7553, 0x7552, 0x7552, 0x7551, 0x7550, 0x754f, 0x754f, // 28864
-    0x754e, 0x754d, 0x754c, 0x754b, 0x754b, 0x754a, 0x7549, 0x7548, // 28872
-    0x7548, 0x7547, 0x7546, 0x7545, 0x7545, 0x7544, 0x7543, 0x7542, // 28880
-    0x7541, 0x7541, 0x7540, 0x753f, 0x753e, 0x753e, 0x753d, 0x753c, // 28888
-    0x753b, 0x753b, 0x753a, 0x7539, 0x7538, 0x7537, 0x7537, 0x7536, // 28896
-    0x7535, 0x7534, 0x7534, 0x7533, 0x7532, 0x7531, 0x7531, 0x7530, // 28904
-    0x752f, 0x752e, 0x752d, 0x752d, 0x752c, 0x752b, 0x752a, 0x752a, // 28912
-    0x7529, 0x7528, 0x7527, 0x7527, 0x7526, 0x7525, 0x7524, 0x7524, // 28920
-    0x7523, 0x7522, 0x7521, 0x7520, 0x7520, 0x751f, 0x751e, 0x751d, // 28928
-    0x751d, 0x751c, 0x751b, 0x751a, 0x751a, 0x7519, 0x7518, 0x7517, // 28936
-    0x7516, 0x7516, 0x7515, 0x7514, 0x7513, 0x7513, 0x7512, 0x7511, // 28944
-    0x7510, 0x7510, 0x750f, 0x750e, 0x750d, 0x750c, 0x750c, 0x750b, // 28952
-    0x750a, 0x7509, 0x7509, 0x7508, 0x7507, 0x7506, 0x7506, 0x7505, // 28960
-    0x7504, 0x7503, 0x7503, 0x7502, 0x7501, 0x7500, 0x74ff, 0x74ff, // 28968
-    0x74fe, 0x74fd, 0x74fc, 0x74fc, 0x74fb, 0x74fa, 0x74f9, 0x74f9, // 28976
-    0x74f8, 0x74f7, 0x74f6, 0x74f5, 0x74f5, 0x74f4, 0x74f3, 0x74f2, // 28984
-    0x74f2, 0x74f1, 0x74f0, 0x74ef, 0x74ef, 0x74ee, 0x74ed, 0x74ec, // 28992
-    0x74eb, 0x74eb, 0x74ea, 0x74e9, 0x74e8, 0x74e8, 0x74e7, 0x74e6, // 29000
-    0x74e5, 0x74e5, 0x74e4, 0x74e3, 0x74e2, 0x74e2, 0x74e1, 0x74e0, // 29008
-    0x74df, 0x74de, 0x74de, 0x74dd, 0x74dc, 0x74db, 0x74db, 0x74da, // 29016
-    0x74d9, 0x74d8, 0x74d8, 0x74d7, 0x74d6, 0x74d5, 0x74d4, 0x74d4, // 29024
-    0x74d3, 0x74d2, 0x74d1, 0x74d1, 0x74d0, 0x74cf, 0x74ce, 0x74ce, // 29032
-    0x74cd, 0x74cc, 0x74cb, 0x74ca, 0x74ca, 0x74c9, 0x74c8, 0x74c7, // 29040
-    0x74c7, 0x74c6, 0x74c5, 0x74c4, 0x74c4, 0x74c3, 0x74c2, 0x74c1, // 29048
-    0x74c1, 0x74c0, 0x74bf, 0x74be, 0x74bd, 0x74bd, 0x74bc, 0x74bb, // 29056
-    0x74ba, 0x74ba, 0x74b9, 0x74b8, 0x74b7, 0x74b7, 0x74b6, 0x74b5, // 29064
-    0x74b4, 0x74b3, 0x74b3, 0x74b2, 0x74b1, 0x74b0, 0x74b0, 0x74af, // 29072
-    0x74ae, 0x74ad, 0x74ad, 0x74ac, 0x74ab, 0x74aa, 0x74a9, 0x74a9, // 29080
-    0x74a8, 0x74a7, 0x74a6, 0x74a6, 0x74a5, 0x74a4, 0x74a3, 0x74a3, // 29088
-    0x74a2, 0x74a1, 0x74a0, 0x749f, 0x749f, 0x749e, 0x749d, 0x749c, // 29096
-    0x749c, 0x749b, 0x749a, 0x7499, 0x7499, 0x7498, 0x7497, 0x7496, // 29104
-    0x7496, 0x7495, 0x7494, 0x7493, 0x7492, 0x7492, 0x7491, 0x7490, // 29112
-    0x748f, 0x748f, 0x748e, 0x748d, 0x748c, 0x748c, 0x748b, 0x748a, // 29120
-    0x7489, 0x7488, 0x7488, 0x7487, 0x7486, 0x7485, 0x7485, 0x7484, // 29128
-    0x7483, 0x7482, 0x7482, 0x7481, 0x7480, 0x747f, 0x747e, 0x747e, // 29136
-    0x747d, 0x747c, 0x747b, 0x747b, 0x747a, 0x7479, 0x7478, 0x7478, // 29144
-    0x7477, 0x7476, 0x7475, 0x7475, 0x7474, 0x7473, 0x7472, 0x7471, // 29152
-    0x7471, 0x7470, 0x746f, 0x746e, 0x746e, 0x746d, 0x746c, 0x746b, // 29160
-    0x746b, 0x746a, 0x7469, 0x7468, 0x7467, 0x7467, 0x7466, 0x7465, // 29168
-    0x7464, 0x7464, 0x7463, 0x7462, 0x7461, 0x7461, 0x7460, 0x745f, // 29176
-    0x745e, 0x745d, 0x745d, 0x745c, 0x745b, 0x745a, 0x745a, 0x7459, // 29184
-    0x7458, 0x7457, 0x7457, 0x7456, 0x7455, 0x7454, 0x7454, 0x7453, // 29192
-    0x7452, 0x7451, 0x7450, 0x7450, 0x744f, 0x744e, 0x744d, 0x744d, // 29200
-    0x744c, 0x744b, 0x744a, 0x744a, 0x7449, 0x7448, 0x7447, 0x7446, // 29208
-    0x7446, 0x7445, 0x7444, 0x7443, 0x7443, 0x7442, 0x7441, 0x7440, // 29216
-    0x7440, 0x743f, 0x743e, 0x743d, 0x743c, 0x743c, 0x743b, 0x743a, // 29224
-    0x7439, 0x7439, 0x7438, 0x7437, 0x7436, 0x7436, 0x7435, 0x7434, // 29232
-    0x7433, 0x7432, 0x7432, 0x7431, 0x7430, 0x742f, 0x742f, 0x742e, // 29240
-    0x742d, 0x742c, 0x742c, 0x742b, 0x742a, 0x7429, 0x7429, 0x7428, // 29248
-    0x7427, 0x7426, 0x7425, 0x7425, 0x7424, 0x7423, 0x7422, 0x7422, // 29256
-    0x7421, 0x7420, 0x741f, 0x741f, 0x741e, 0x741d, 0x741c, 0x741b, // 29264
-    0x741b, 0x741a, 0x7419, 0x7418, 0x7418, 0x7417, 0x7416, 0x7415, // 29272
-    0x7415, 0x7414, 0x7413, 0x7412, 0x7411, 0x7411, 0x7410, 0x740f, // 29280
-    0x740e, 0x740e, 0x740d, 0x740c, 0x740b, 0x740b, 0x740a, 0x7409, // 29288
-    0x7408, 0x7408, 0x7407, 0x7406, 0x7405, 0x7404, 0x7404, 0x7403, // 29296
-    0x7402, 0x7401, 0x7401, 0x7400, 0x73ff, 0x73fe, 0x73fe, 0x73fd, // 29304
-    0x73fc, 0x73fb, 0x73fa, 0x73fa, 0x73f9, 0x73f8, 0x73f7, 0x73f7, // 29312
-    0x73f6, 0x73f5, 0x73f4, 0x73f4, 0x73f3, 0x73f2, 0x73f1, 0x73f0, // 29320
-    0x73f0, 0x73ef, 0x73ee, 0x73ed, 0x73ed, 0x73ec, 0x73eb, 0x73ea, // 29328
-    0x73ea, 0x73e9, 0x73e8, 0x73e7, 0x73e7, 0x73e6, 0x73e5, 0x73e4, // 29336
-    0x73e3, 0x73e3, 0x73e2, 0x73e1, 0x73e0, 0x73e0, 0x73df, 0x73de, // 29344
-    0x73dd, 0x73dd, 0x73dc, 0x73db, 0x73da, 0x73d9, 0x73d9, 0x73d8, // 29352
-    0x73d7, 0x73d6, 0x73d6, 0x73d5, 0x73d4, 0x73d3, 0x73d3, 0x73d2, // 29360
-    0x73d1, 0x73d0, 0x73cf, 0x73cf, 0x73ce, 0x73cd, 0x73cc, 0x73cc, // 29368
-    0x73cb, 0x73ca, 0x73c9, 0x73c9, 0x73c8, 0x73c7, 0x73c6, 0x73c6, // 29376
-    0x73c5, 0x73c4, 0x73c3, 0x73c2, 0x73c2, 0x73c1, 0x73c0, 0x73bf, // 29384
-    0x73bf, 0x73be, 0x73bd, 0x73bc, 0x73bc, 0x73bb, 0x73ba, 0x73b9, // 29392
-    0x73b8, 0x73b8, 0x73b7, 0x73b6, 0x73b5, 0x73b5, 0x73b4, 0x73b3, // 29400
-    0x73b2, 0x73b2, 0x73b1, 0x73b0, 0x73af, 0x73ae, 0x73ae, 0x73ad, // 29408
-    0x73ac, 0x73ab, 0x73ab, 0x73aa, 0x73a9, 0x73a8, 0x73a8, 0x73a7, // 29416
-    0x73a6, 0x73a5, 0x73a4, 0x73a4, 0x73a3, 0x73a2, 0x73a1, 0x73a1, // 29424
-    0x73a0, 0x739f, 0x739e, 0x739e, 0x739d, 0x739c, 0x739b, 0x739b, // 29432
-    0x739a, 0x7399, 0x7398, 0x7397, 0x7397, 0x7396, 0x7395, 0x7394, // 29440
-    0x7394, 0x7393, 0x7392, 0x7391, 0x7391, 0x7390, 0x738f, 0x738e, // 29448
-    0x738d, 0x738d, 0x738c, 0x738b, 0x738a, 0x738a, 0x7389, 0x7388, // 29456
-    0x7387, 0x7387, 0x7386, 0x7385, 0x7384, 0x7383, 0x7383, 0x7382, // 29464
-    0x7381, 0x7380, 0x7380, 0x737f, 0x737e, 0x737d, 0x737d, 0x737c, // 29472
-    0x737b, 0x737a, 0x737a, 0x7379, 0x7378, 0x7377, 0x7376, 0x7376, // 29480
-    0x7375, 0x7374, 0x7373, 0x7373, 0x7372, 0x7371, 0x7370, 0x7370, // 29488
-    0x736f, 0x736e, 0x736d, 0x736c, 0x736c, 0x736b, 0x736a, 0x7369, // 29496
-    0x7369, 0x7368, 0x7367, 0x7366, 0x7366, 0x7365, 0x7364, 0x7363, // 29504
-    0x7362, 0x7362, 0x7361, 0x7360, 0x735f, 0x735f, 0x735e, 0x735d, // 29512
-    0x735c, 0x735c, 0x735b, 0x735a, 0x7359, 0x7359, 0x7358, 0x7357, // 29520
-    0x7356, 0x7355, 0x7355, 0x7354, 0x7353, 0x7352, 0x7352, 0x7351, // 29528
-    0x7350, 0x734f, 0x734f, 0x734e, 0x734d, 0x734c, 0x734b, 0x734b, // 29536
-    0x734a, 0x7349, 0x7348, 0x7348, 0x7347, 0x7346, 0x7345, 0x7345, // 29544
-    0x7344, 0x7343, 0x7342, 0x7341, 0x7341, 0x7340, 0x733f, 0x733e, // 29552
-    0x733e, 0x733d, 0x733c, 0x733b, 0x733b, 0x733a, 0x7339, 0x7338, // 29560
-    0x7338, 0x7337, 0x7336, 0x7335, 0x7334, 0x7334, 0x7333, 0x7332, // 29568
-    0x7331, 0x7331, 0x7330, 0x732f, 0x732e, 0x732e, 0x732d, 0x732c, // 29576
-    0x732b, 0x732a, 0x732a, 0x7329, 0x7328, 0x7327, 0x7327, 0x7326, // 29584
-    0x7325, 0x7324, 0x7324, 0x7323, 0x7322, 0x7321, 0x7320, 0x7320, // 29592
-    0x731f, 0x731e, 0x731d, 0x731d, 0x731c, 0x731b, 0x731a, 0x731a, // 29600
-    0x7319, 0x7318, 0x7317, 0x7316, 0x7316, 0x7315, 0x7314, 0x7313, // 29608
-    0x7313, 0x7312, 0x7311, 0x7310, 0x7310, 0x730f, 0x730e, 0x730d, // 29616
-    0x730d, 0x730c, 0x730b, 0x730a, 0x7309, 0x7309, 0x7308, 0x7307, // 29624
-    0x7306, 0x7306, 0x7305, 0x7304, 0x7303, 0x7303, 0x7302, 0x7301, // 29632
-    0x7300, 0x72ff, 0x72ff, 0x72fe, 0x72fd, 0x72fc, 0x72fc, 0x72fb, // 29640
-    0x72fa, 0x72f9, 0x72f9, 0x72f8, 0x72f7, 0x72f6, 0x72f5, 0x72f5, // 29648
-    0x72f4, 0x72f3, 0x72f2, 0x72f2, 0x72f1, 0x72f0, 0x72ef, 0x72ef, // 29656
-    0x72ee, 0x72ed, 0x72ec, 0x72ec, 0x72eb, 0x72ea, 0x72e9, 0x72e8, // 29664
-    0x72e8, 0x72e7, 0x72e6, 0x72e5, 0x72e5, 0x72e4, 0x72e3, 0x72e2, // 29672
-    0x72e2, 0x72e1, 0x72e0, 0x72df, 0x72de, 0x72de, 0x72dd, 0x72dc, // 29680
-    0x72db, 0x72db, 0x72da, 0x72d9, 0x72d8, 0x72d8, 0x72d7, 0x72d6, // 29688
-    0x72d5, 0x72d4, 0x72d3, 0x72d3, 0x72d2, 0x72d1, 0x72d0, 0x72d0, // 29696
-    0x72cf, 0x72ce, 0x72cd, 0x72cd, 0x72cc, 0x72cb, 0x72ca, 0x72ca, // 29704
-    0x72c9, 0x72c8, 0x72c7, 0x72c7, 0x72c6, 0x72c5, 0x72c4, 0x72c4, // 29712
-    0x72c3, 0x72c2, 0x72c1, 0x72c1, 0x72c0, 0x72bf, 0x72be, 0x72be, // 29720
-    0x72bd, 0x72bc, 0x72bb, 0x72bb, 0x72ba, 0x72b9, 0x72b8, 0x72b8, // 29728
-    0x72b7, 0x72b6, 0x72b5, 0x72b5, 0x72b4, 0x72b3, 0x72b2, 0x72b2, // 29736
-    0x72b1, 0x72b0, 0x72af, 0x72af, 0x72ae, 0x72ad, 0x72ac, 0x72ac, // 29744
-    0x72ab, 0x72aa, 0x72a9, 0x72a9, 0x72a8, 0x72a7, 0x72a6, 0x72a6, // 29752
-    0x72a5, 0x72a4, 0x72a3, 0x72a3, 0x72a2, 0x72a1, 0x72a0, 0x72a0, // 29760
-    0x729f, 0x729e, 0x729d, 0x729d, 0x729c, 0x729b, 0x729a, 0x729a, // 29768
-    0x7299, 0x7298, 0x7297, 0x7297, 0x7296, 0x7295, 0x7294, 0x7294, // 29776
-    0x7293, 0x7292, 0x7291, 0x7291, 0x7290, 0x728f, 0x728e, 0x728e, // 29784
-    0x728d, 0x728c, 0x728b, 0x728b, 0x728a, 0x7289, 0x7288, 0x7288, // 29792
-    0x7287, 0x7286, 0x7285, 0x7285, 0x7284, 0x7283, 0x7282, 0x7282, // 29800
-    0x7281, 0x7280, 0x727f, 0x727f, 0x727e, 0x727d, 0x727c, 0x727c, // 29808
-    0x727b, 0x727a, 0x7279, 0x7279, 0x7278, 0x7277, 0x7276, 0x7276, // 29816
-    0x7275, 0x7274, 0x7273, 0x7272, 0x7272, 0x7271, 0x7270, 0x726f, // 29824
-    0x726f, 0x726e, 0x726d, 0x726c, 0x726c, 0x726b, 0x726a, 0x7269, // 29832
-    0x7269, 0x7268, 0x7267, 0x7266, 0x7266, 0x7265, 0x7264, 0x7263, // 29840
-    0x7263, 0x7262, 0x7261, 0x7260, 0x7260, 0x725f, 0x725e, 0x725d, // 29848
-    0x725d, 0x725c, 0x725b, 0x725a, 0x725a, 0x7259, 0x7258, 0x7257, // 29856
-    0x7257, 0x7256, 0x7255, 0x7254, 0x7254, 0x7253, 0x7252, 0x7251, // 29864
-    0x7251, 0x7250, 0x724f, 0x724e, 0x724e, 0x724d, 0x724c, 0x724b, // 29872
-    0x724b, 0x724a, 0x7249, 0x7248, 0x7248, 0x7247, 0x7246, 0x7245, // 29880
-    0x7245, 0x7244, 0x7243, 0x7242, 0x7242, 0x7241, 0x7240, 0x723f, // 29888
-    0x723f, 0x723e, 0x723d, 0x723c, 0x723c, 0x723b, 0x723a, 0x7239, // 29896
-    0x7239, 0x7238, 0x7237, 0x7236, 0x7236, 0x7235, 0x7234, 0x7233, // 29904
-    0x7233, 0x7232, 0x7231, 0x7230, 0x7230, 0x722f, 0x722e, 0x722d, // 29912
-    0x722d, 0x722c, 0x722b, 0x722a, 0x722a, 0x7229, 0x7228, 0x7227, // 29920
-    0x7227, 0x7226, 0x7225, 0x7224, 0x7224, 0x7223, 0x7222, 0x7221, // 29928
-    0x7221, 0x7220, 0x721f, 0x721e, 0x721e, 0x721d, 0x721c, 0x721b, // 29936
-    0x721b, 0x721a, 0x7219, 0x7218, 0x7218, 0x7217, 0x7216, 0x7215, // 29944
-    0x7215, 0x7214, 0x7213, 0x7212, 0x7211, 0x7211, 0x7210, 0x720f, // 29952
-    0x720e, 0x720e, 0x720d, 0x720c, 0x720b, 0x720b, 0x720a, 0x7209, // 29960
-    0x7208, 0x7208, 0x7207, 0x7206, 0x7205, 0x7205, 0x7204, 0x7203, // 29968
-    0x7202, 0x7202, 0x7201, 0x7200, 0x71ff, 0x71ff, 0x71fe, 0x71fd, // 29976
-    0x71fc, 0x71fc, 0x71fb, 0x71fa, 0x71f9, 0x71f9, 0x71f8, 0x71f7, // 29984
-    0x71f6, 0x71f6, 0x71f5, 0x71f4, 0x71f3, 0x71f3, 0x71f2, 0x71f1, // 29992
-    0x71f0, 0x71f0, 0x71ef, 0x71ee, 0x71ed, 0x71ed, 0x71ec, 0x71eb, // 30000
-    0x71ea, 0x71ea, 0x71e9, 0x71e8, 0x71e7, 0x71e7, 0x71e6, 0x71e5, // 30008
-    0x71e4, 0x71e4, 0x71e3, 0x71e2, 0x71e1, 0x71e1, 0x71e0, 0x71df, // 30016
-    0x71de, 0x71de, 0x71dd, 0x71dc, 0x71db, 0x71db, 0x71da, 0x71d9, // 30024
-    0x71d8, 0x71d8, 0x71d7, 0x71d6, 0x71d5, 0x71d5, 0x71d4, 0x71d3, // 30032
-    0x71d2, 0x71d2, 0x71d1, 0x71d0, 0x71cf, 0x71cf, 0x71ce, 0x71cd, // 30040
-    0x71cc, 0x71cc, 0x71cb, 0x71ca, 0x71c9, 0x71c9, 0x71c8, 0x71c7, // 30048
-    0x71c6, 0x71c6, 0x71c5, 0x71c4, 0x71c3, 0x71c3, 0x71c2, 0x71c1, // 30056
-    0x71c0, 0x71c0, 0x71bf, 0x71be, 0x71bd, 0x71bd, 0x71bc, 0x71bb, // 30064
-    0x71ba, 0x71ba, 0x71b9, 0x71b8, 0x71b7, 0x71b7, 0x71b6, 0x71b5, // 30072
-    0x71b4, 0x71b3, 0x71b3, 0x71b2, 0x71b1, 0x71b0, 0x71b0, 0x71af, // 30080
-    0x71ae, 0x71ad, 0x71ad, 0x71ac, 0x71ab, 0x71aa, 0x71aa, 0x71a9, // 30088
-    0x71a8, 0x71a7, 0x71a7, 0x71a6, 0x71a5, 0x71a4, 0x71a4, 0x71a3, // 30096
-    0x71a2, 0x71a1, 0x71a1, 0x71a0, 0x719f, 0x719e, 0x719e, 0x719d, // 30104
-    0x719c, 0x719b, 0x719b, 0x719a, 0x7199, 0x7198, 0x7198, 0x7197, // 30112
-    0x7196, 0x7195, 0x7195, 0x7194, 0x7193, 0x7192, 0x7192, 0x7191, // 30120
-    0x7190, 0x718f, 0x718f, 0x718e, 0x718d, 0x718c, 0x718c, 0x718b, // 30128
-    0x718a, 0x7189, 0x7189, 0x7188, 0x7187, 0x7186, 0x7186, 0x7185, // 30136
-    0x7184, 0x7183, 0x7183, 0x7182, 0x7181, 0x7180, 0x7180, 0x717f, // 30144
-    0x717e, 0x717d, 0x717d, 0x717c, 0x717b, 0x717a, 0x717a, 0x7179, // 30152
-    0x7178, 0x7177, 0x7177, 0x7176, 0x7175, 0x7174, 0x7174, 0x7173, // 30160
-    0x7172, 0x7171, 0x7171, 0x7170, 0x716f, 0x716e, 0x716e, 0x716d, // 30168
-    0x716c, 0x716b, 0x716b, 0x716a, 0x7169, 0x7168, 0x7168, 0x7167, // 30176
-    0x7166, 0x7165, 0x7165, 0x7164, 0x7163, 0x7162, 0x7162, 0x7161, // 30184
-    0x7160, 0x715f, 0x715f, 0x715e, 0x715d, 0x715c, 0x715c, 0x715b, // 30192
-    0x715a, 0x7159, 0x7159, 0x7158, 0x7157, 0x7156, 0x7156, 0x7155, // 30200
-    0x7154, 0x7153, 0x7152, 0x7152, 0x7151, 0x7150, 0x714f, 0x714f, // 30208
-    0x714e, 0x714d, 0x714c, 0x714c, 0x714b, 0x714a, 0x7149, 0x7149, // 30216
-    0x7148, 0x7147, 0x7146, 0x7146, 0x7145, 0x7144, 0x7143, 0x7143, // 30224
-    0x7142, 0x7141, 0x7140, 0x7140, 0x713f, 0x713e, 0x713d, 0x713d, // 30232
-    0x713c, 0x713b, 0x713a, 0x713a, 0x7139, 0x7138, 0x7137, 0x7137, // 30240
-    0x7136, 0x7135, 0x7134, 0x7134, 0x7133, 0x7132, 0x7131, 0x7131, // 30248
-    0x7130, 0x712f, 0x712e, 0x712e, 0x712d, 0x712c, 0x712b, 0x712b, // 30256
-    0x712a, 0x7129, 0x7128, 0x7128, 0x7127, 0x7126, 0x7125, 0x7125, // 30264
-    0x7124, 0x7123, 0x7122, 0x7122, 0x7121, 0x7120, 0x711f, 0x711f, // 30272
-    0x711e, 0x711d, 0x711c, 0x711c, 0x711b, 0x711a, 0x7119, 0x7119, // 30280
-    0x7118, 0x7117, 0x7116, 0x7116, 0x7115, 0x7114, 0x7113, 0x7113, // 30288
-    0x7112, 0x7111, 0x7110, 0x7110, 0x710f, 0x710e, 0x710d, 0x710d, // 30296
-    0x710c, 0x710b, 0x710a, 0x710a, 0x7109, 0x7108, 0x7107, 0x7107, // 30304
-    0x7106, 0x7105, 0x7104, 0x7104, 0x7103, 0x7102, 0x7101, 0x7101, // 30312
-    0x7100, 0x70ff, 0x70fe, 0x70fe, 0x70fd, 0x70fc, 0x70fb, 0x70fb, // 30320
-    0x70fa, 0x70f9, 0x70f8, 0x70f8, 0x70f7, 0x70f6, 0x70f5, 0x70f5, // 30328
-    0x70f4, 0x70f3, 0x70f2, 0x70f1, 0x70f1, 0x70f0, 0x70ef, 0x70ee, // 30336
-    0x70ee, 0x70ed, 0x70ec, 0x70eb, 0x70eb, 0x70ea, 0x70e9, 0x70e8, // 30344
-    0x70e8, 0x70e7, 0x70e6, 0x70e5, 0x70e5, 0x70e4, 0x70e3, 0x70e2, // 30352
-    0x70e2, 0x70e1, 0x70e0, 0x70df, 0x70df, 0x70de, 0x70dd, 0x70dc, // 30360
-    0x70dc, 0x70db, 0x70da, 0x70d9, 0x70d9, 0x70d8, 0x70d7, 0x70d6, // 30368
-    0x70d6, 0x70d5, 0x70d4, 0x70d3, 0x70d3, 0x70d2, 0x70d1, 0x70d0, // 30376
-    0x70d0, 0x70cf, 0x70ce, 0x70cd, 0x70cd, 0x70cc, 0x70cb, 0x70ca, // 30384
-    0x70ca, 0x70c9, 0x70c8, 0x70c7, 0x70c7, 0x70c6, 0x70c5, 0x70c4, // 30392
-    0x70c4, 0x70c3, 0x70c2, 0x70c1, 0x70c1, 0x70c0, 0x70bf, 0x70be, // 30400
-    0x70be, 0x70bd, 0x70bc, 0x70bb, 0x70bb, 0x70ba, 0x70b9, 0x70b8, // 30408
-    0x70b8, 0x70b7, 0x70b6, 0x70b5, 0x70b5, 0x70b4, 0x70b3, 0x70b2, // 30416
-    0x70b2, 0x70b1, 0x70b0, 0x70af, 0x70af, 0x70ae, 0x70ad, 0x70ac, // 30424
-    0x70ac, 0x70ab, 0x70aa, 0x70a9, 0x70a9, 0x70a8, 0x70a7, 0x70a6, // 30432
-    0x70a6, 0x70a5, 0x70a4, 0x70a3, 0x70a3, 0x70a2, 0x70a1, 0x70a0, // 30440
-    0x70a0, 0x709f, 0x709e, 0x709d, 0x709d, 0x709c, 0x709b, 0x709a, // 30448
-    0x709a, 0x7099, 0x7098, 0x7097, 0x7097, 0x7096, 0x7095, 0x7094, // 30456
-    0x7094, 0x7093, 0x7092, 0x7091, 0x7090, 0x7090, 0x708f, 0x708e, // 30464
-    0x708d, 0x708d, 0x708c, 0x708b, 0x708a, 0x708a, 0x7089, 0x7088, // 30472
-    0x7087, 0x7087, 0x7086, 0x7085, 0x7084, 0x7084, 0x7083, 0x7082, // 30480
-    0x7081, 0x7081, 0x7080, 0x707f, 0x707e, 0x707e, 0x707d, 0x707c, // 30488
-    0x707b, 0x707b, 0x707a, 0x7079, 0x7078, 0x7078, 0x7077, 0x7076, // 30496
-    0x7075, 0x7075, 0x7074, 0x7073, 0x7072, 0x7072, 0x7071, 0x7070, // 30504
-    0x706f, 0x706f, 0x706e, 0x706d, 0x706c, 0x706c, 0x706b, 0x706a, // 30512
-    0x7069, 0x7069, 0x7068, 0x7067, 0x7066, 0x7066, 0x7065, 0x7064, // 30520
-    0x7063, 0x7063, 0x7062, 0x7061, 0x7060, 0x7060, 0x705f, 0x705e, // 30528
-    0x705d, 0x705d, 0x705c, 0x705b, 0x705a, 0x705a, 0x7059, 0x7058, // 30536
-    0x7057, 0x7057, 0x7056, 0x7055, 0x7054, 0x7054, 0x7053, 0x7052, // 30544
-    0x7051, 0x7051, 0x7050, 0x704f, 0x704e, 0x704e, 0x704d, 0x704c, // 30552
-    0x704b, 0x704b, 0x704a, 0x7049, 0x7048, 0x7048, 0x7047, 0x7046, // 30560
-    0x7045, 0x7045, 0x7044, 0x7043, 0x7042, 0x7042, 0x7041, 0x7040, // 30568
-    0x703f, 0x703f, 0x703e, 0x703d, 0x703c, 0x703c, 0x703b, 0x703a, // 30576
-    0x7039, 0x7039, 0x7038, 0x7037, 0x7036, 0x7036, 0x7035, 0x7034, // 30584
-    0x7033, 0x7032, 0x7032, 0x7031, 0x7030, 0x702f, 0x702f, 0x702e, // 30592
-    0x702d, 0x702c, 0x702c, 0x702b, 0x702a, 0x7029, 0x7029, 0x7028, // 30600
-    0x7027, 0x7026, 0x7026, 0x7025, 0x7024, 0x7023, 0x7023, 0x7022, // 30608
-    0x7021, 0x7020, 0x7020, 0x701f, 0x701e, 0x701d, 0x701d, 0x701c, // 30616
-    0x701b, 0x701a, 0x701a, 0x7019, 0x7018, 0x7017, 0x7017, 0x7016, // 30624
-    0x7015, 0x7014, 0x7014, 0x7013, 0x7012, 0x7011, 0x7011, 0x7010, // 30632
-    0x700f, 0x700e, 0x700e, 0x700d, 0x700c, 0x700b, 0x700b, 0x700a, // 30640
-    0x7009, 0x7008, 0x7008, 0x7007, 0x7006, 0x7005, 0x7005, 0x7004, // 30648
-    0x7003, 0x7002, 0x7002, 0x7001, 0x7000, 0x6fff, 0x6fff, 0x6ffe, // 30656
-    0x6ffd, 0x6ffc, 0x6ffc, 0x6ffb, 0x6ffa, 0x6ff9, 0x6ff9, 0x6ff8, // 30664
-    0x6ff7, 0x6ff6, 0x6ff6, 0x6ff5, 0x6ff4, 0x6ff3, 0x6ff3, 0x6ff2, // 30672
-    0x6ff1, 0x6ff0, 0x6ff0, 0x6fef, 0x6fee, 0x6fed, 0x6fed, 0x6fec, // 30680
-    0x6feb, 0x6fea, 0x6fea, 0x6fe9, 0x6fe8, 0x6fe7, 0x6fe7, 0x6fe6, // 30688
-    0x6fe5, 0x6fe4, 0x6fe4, 0x6fe3, 0x6fe2, 0x6fe1, 0x6fe1, 0x6fe0, // 30696
-    0x6fdf, 0x6fde, 0x6fde, 0x6fdd, 0x6fdc, 0x6fdb, 0x6fdb, 0x6fda, // 30704
-    0x6fd9, 0x6fd8, 0x6fd8, 0x6fd7, 0x6fd6, 0x6fd5, 0x6fd5, 0x6fd4, // 30712
-    0x6fd3, 0x6fd3, 0x6fd2, 0x6fd1, 0x6fd0, 0x6fd0, 0x6fcf, 0x6fce, // 30720
-    0x6fcd, 0x6fcd, 0x6fcc, 0x6fcb, 0x6fca, 0x6fca, 0x6fc9, 0x6fc8, // 30728
-    0x6fc8, 0x6fc7, 0x6fc6, 0x6fc5, 0x6fc5, 0x6fc4, 0x6fc3, 0x6fc2, // 30736
-    0x6fc2, 0x6fc1, 0x6fc0, 0x6fbf, 0x6fbf, 0x6fbe, 0x6fbd, 0x6fbd, // 30744
-    0x6fbc, 0x6fbb, 0x6fba, 0x6fba, 0x6fb9, 0x6fb8, 0x6fb7, 0x6fb7, // 30752
-    0x6fb6, 0x6fb5, 0x6fb4, 0x6fb4, 0x6fb3, 0x6fb2, 0x6fb2, 0x6fb1, // 30760
-    0x6fb0, 0x6faf, 0x6faf, 0x6fae, 0x6fad, 0x6fac, 0x6fac, 0x6fab, // 30768
-    0x6faa, 0x6faa, 0x6fa9, 0x6fa8, 0x6fa7, 0x6fa7, 0x6fa6, 0x6fa5, // 30776
-    0x6fa4, 0x6fa4, 0x6fa3, 0x6fa2, 0x6fa1, 0x6fa1, 0x6fa0, 0x6f9f, // 30784
-    0x6f9f, 0x6f9e, 0x6f9d, 0x6f9c, 0x6f9c, 0x6f9b, 0x6f9a, 0x6f99, // 30792
-    0x6f99, 0x6f98, 0x6f97, 0x6f96, 0x6f96, 0x6f95, 0x6f94, 0x6f94, // 30800
-    0x6f93, 0x6f92, 0x6f91, 0x6f91, 0x6f90, 0x6f8f, 0x6f8e, 0x6f8e, // 30808
-    0x6f8d, 0x6f8c, 0x6f8b, 0x6f8b, 0x6f8a, 0x6f89, 0x6f89, 0x6f88, // 30816
-    0x6f87, 0x6f86, 0x6f86, 0x6f85, 0x6f84, 0x6f83, 0x6f83, 0x6f82, // 30824
-    0x6f81, 0x6f80, 0x6f80, 0x6f7f, 0x6f7e, 0x6f7e, 0x6f7d, 0x6f7c, // 30832
-    0x6f7b, 0x6f7b, 0x6f7a, 0x6f79, 0x6f78, 0x6f78, 0x6f77, 0x6f76, // 30840
-    0x6f76, 0x6f75, 0x6f74, 0x6f73, 0x6f73, 0x6f72, 0x6f71, 0x6f70, // 30848
-    0x6f70, 0x6f6f, 0x6f6e, 0x6f6d, 0x6f6d, 0x6f6c, 0x6f6b, 0x6f6b, // 30856
-    0x6f6a, 0x6f69, 0x6f68, 0x6f68, 0x6f67, 0x6f66, 0x6f65, 0x6f65, // 30864
-    0x6f64, 0x6f63, 0x6f62, 0x6f62, 0x6f61, 0x6f60, 0x6f60, 0x6f5f, // 30872
-    0x6f5e, 0x6f5d, 0x6f5d, 0x6f5c, 0x6f5b, 0x6f5a, 0x6f5a, 0x6f59, // 30880
-    0x6f58, 0x6f57, 0x6f57, 0x6f56, 0x6f55, 0x6f55, 0x6f54, 0x6f53, // 30888
-    0x6f52, 0x6f52, 0x6f51, 0x6f50, 0x6f4f, 0x6f4f, 0x6f4e, 0x6f4d, // 30896
-    0x6f4c, 0x6f4c, 0x6f4b, 0x6f4a, 0x6f4a, 0x6f49, 0x6f48, 0x6f47, // 30904
-    0x6f47, 0x6f46, 0x6f45, 0x6f44, 0x6f44, 0x6f43, 0x6f42, 0x6f41, // 30912
-    0x6f41, 0x6f40, 0x6f3f, 0x6f3f, 0x6f3e, 0x6f3d, 0x6f3c, 0x6f3c, // 30920
-    0x6f3b, 0x6f3a, 0x6f39, 0x6f39, 0x6f38, 0x6f37, 0x6f37, 0x6f36, // 30928
-    0x6f35, 0x6f34, 0x6f34, 0x6f33, 0x6f32, 0x6f31, 0x6f31, 0x6f30, // 30936
-    0x6f2f, 0x6f2e, 0x6f2e, 0x6f2d, 0x6f2c, 0x6f2c, 0x6f2b, 0x6f2a, // 30944
-    0x6f29, 0x6f29, 0x6f28, 0x6f27, 0x6f26, 0x6f26, 0x6f25, 0x6f24, // 30952
-    0x6f23, 0x6f23, 0x6f22, 0x6f21, 0x6f21, 0x6f20, 0x6f1f, 0x6f1e, // 30960
-    0x6f1e, 0x6f1d, 0x6f1c, 0x6f1b, 0x6f1b, 0x6f1a, 0x6f19, 0x6f18, // 30968
-    0x6f18, 0x6f17, 0x6f16, 0x6f16, 0x6f15, 0x6f14, 0x6f13, 0x6f13, // 30976
-    0x6f12, 0x6f11, 0x6f10, 0x6f10, 0x6f0f, 0x6f0e, 0x6f0d, 0x6f0d, // 30984
-    0x6f0c, 0x6f0b, 0x6f0b, 0x6f0a, 0x6f09, 0x6f08, 0x6f08, 0x6f07, // 30992
-    0x6f06, 0x6f05, 0x6f05, 0x6f04, 0x6f03, 0x6f03, 0x6f02, 0x6f01, // 31000
-    0x6f00, 0x6f00, 0x6eff, 0x6efe, 0x6efd, 0x6efd, 0x6efc, 0x6efb, // 31008
-    0x6efa, 0x6efa, 0x6ef9, 0x6ef8, 0x6ef8, 0x6ef7, 0x6ef6, 0x6ef5, // 31016
-    0x6ef5, 0x6ef4, 0x6ef3, 0x6ef2, 0x6ef2, 0x6ef1, 0x6ef0, 0x6eef, // 31024
-    0x6eef, 0x6eee, 0x6eed, 0x6eed, 0x6eec, 0x6eeb, 0x6eea, 0x6eea, // 31032
-    0x6ee9, 0x6ee8, 0x6ee7, 0x6ee7, 0x6ee6, 0x6ee5, 0x6ee4, 0x6ee4, // 31040
-    0x6ee3, 0x6ee2, 0x6ee2, 0x6ee1, 0x6ee0, 0x6edf, 0x6edf, 0x6ede, // 31048
-    0x6edd, 0x6edc, 0x6edc, 0x6edb, 0x6eda, 0x6ed9, 0x6ed9, 0x6ed8, // 31056
-    0x6ed7, 0x6ed7, 0x6ed6, 0x6ed5, 0x6ed4, 0x6ed4, 0x6ed3, 0x6ed2, // 31064
-    0x6ed1, 0x6ed1, 0x6ed0, 0x6ecf, 0x6ecf, 0x6ece, 0x6ecd, 0x6ecc, // 31072
-    0x6ecc, 0x6ecb, 0x6eca, 0x6ec9, 0x6ec9, 0x6ec8, 0x6ec7, 0x6ec6, // 31080
-    0x6ec6, 0x6ec5, 0x6ec4, 0x6ec4, 0x6ec3, 0x6ec2, 0x6ec1, 0x6ec1, // 31088
-    0x6ec0, 0x6ebf, 0x6ebe, 0x6ebe, 0x6ebd, 0x6ebc, 0x6ebb, 0x6ebb, // 31096
-    0x6eba, 0x6eb9, 0x6eb9, 0x6eb8, 0x6eb7, 0x6eb6, 0x6eb6, 0x6eb5, // 31104
-    0x6eb4, 0x6eb3, 0x6eb3, 0x6eb2, 0x6eb1, 0x6eb0, 0x6eb0, 0x6eaf, // 31112
-    0x6eae, 0x6eae, 0x6ead, 0x6eac, 0x6eab, 0x6eab, 0x6eaa, 0x6ea9, // 31120
-    0x6ea8, 0x6ea8, 0x6ea7, 0x6ea6, 0x6ea5, 0x6ea5, 0x6ea4, 0x6ea3, // 31128
-    0x6ea3, 0x6ea2, 0x6ea1, 0x6ea0, 0x6ea0, 0x6e9f, 0x6e9e, 0x6e9d, // 31136
-    0x6e9d, 0x6e9c, 0x6e9b, 0x6e9b, 0x6e9a, 0x6e99, 0x6e98, 0x6e98, // 31144
-    0x6e97, 0x6e96, 0x6e95, 0x6e95, 0x6e94, 0x6e93, 0x6e92, 0x6e92, // 31152
-    0x6e91, 0x6e90, 0x6e90, 0x6e8f, 0x6e8e, 0x6e8d, 0x6e8d, 0x6e8c, // 31160
-    0x6e8b, 0x6e8a, 0x6e8a, 0x6e89, 0x6e88, 0x6e87, 0x6e87, 0x6e86, // 31168
-    0x6e85, 0x6e85, 0x6e84, 0x6e83, 0x6e82, 0x6e82, 0x6e81, 0x6e80, // 31176
-    0x6e7f, 0x6e7f, 0x6e7e, 0x6e7d, 0x6e7c, 0x6e7c, 0x6e7b, 0x6e7a, // 31184
-    0x6e7a, 0x6e79, 0x6e78, 0x6e77, 0x6e77, 0x6e76, 0x6e75, 0x6e74, // 31192
-    0x6e74, 0x6e73, 0x6e72, 0x6e71, 0x6e71, 0x6e70, 0x6e6f, 0x6e6f, // 31200
-    0x6e6e, 0x6e6d, 0x6e6c, 0x6e6c, 0x6e6b, 0x6e6a, 0x6e69, 0x6e69, // 31208
-    0x6e68, 0x6e67, 0x6e67, 0x6e66, 0x6e65, 0x6e64, 0x6e64, 0x6e63, // 31216
-    0x6e62, 0x6e61, 0x6e61, 0x6e60, 0x6e5f, 0x6e5e, 0x6e5e, 0x6e5d, // 31224
-    0x6e5c, 0x6e5c, 0x6e5b, 0x6e5a, 0x6e59, 0x6e59, 0x6e58, 0x6e57, // 31232
-    0x6e56, 0x6e56, 0x6e55, 0x6e54, 0x6e53, 0x6e53, 0x6e52, 0x6e51, // 31240
-    0x6e51, 0x6e50, 0x6e4f, 0x6e4e, 0x6e4e, 0x6e4d, 0x6e4c, 0x6e4b, // 31248
-    0x6e4b, 0x6e4a, 0x6e49, 0x6e48, 0x6e48, 0x6e47, 0x6e46, 0x6e46, // 31256
-    0x6e45, 0x6e44, 0x6e43, 0x6e43, 0x6e42, 0x6e41, 0x6e40, 0x6e40, // 31264
-    0x6e3f, 0x6e3e, 0x6e3d, 0x6e3d, 0x6e3c, 0x6e3b, 0x6e3b, 0x6e3a, // 31272
-    0x6e39, 0x6e38, 0x6e38, 0x6e37, 0x6e36, 0x6e35, 0x6e35, 0x6e34, // 31280
-    0x6e33, 0x6e33, 0x6e32, 0x6e31, 0x6e30, 0x6e30, 0x6e2f, 0x6e2e, // 31288
-    0x6e2d, 0x6e2d, 0x6e2c, 0x6e2b, 0x6e2a, 0x6e2a, 0x6e29, 0x6e28, // 31296
-    0x6e28, 0x6e27, 0x6e26, 0x6e25, 0x6e25, 0x6e24, 0x6e23, 0x6e22, // 31304
-    0x6e22, 0x6e21, 0x6e20, 0x6e1f, 0x6e1f, 0x6e1e, 0x6e1d, 0x6e1d, // 31312
-    0x6e1c, 0x6e1b, 0x6e1a, 0x6e1a, 0x6e19, 0x6e18, 0x6e17, 0x6e17, // 31320
-    0x6e16, 0x6e15, 0x6e14, 0x6e14, 0x6e13, 0x6e12, 0x6e12, 0x6e11, // 31328
-    0x6e10, 0x6e0f, 0x6e0f, 0x6e0e, 0x6e0d, 0x6e0c, 0x6e0c, 0x6e0b, // 31336
-    0x6e0a, 0x6e09, 0x6e09, 0x6e08, 0x6e07, 0x6e07, 0x6e06, 0x6e05, // 31344
-    0x6e04, 0x6e04, 0x6e03, 0x6e02, 0x6e01, 0x6e01, 0x6e00, 0x6dff, // 31352
-    0x6dff, 0x6dfe, 0x6dfd, 0x6dfc, 0x6dfc, 0x6dfb, 0x6dfa, 0x6df9, // 31360
-    0x6df9, 0x6df8, 0x6df7, 0x6df6, 0x6df6, 0x6df5, 0x6df4, 0x6df4, // 31368
-    0x6df3, 0x6df2, 0x6df1, 0x6df1, 0x6df0, 0x6def, 0x6dee, 0x6dee, // 31376
-    0x6ded, 0x6dec, 0x6deb, 0x6deb, 0x6dea, 0x6de9, 0x6de9, 0x6de8, // 31384
-    0x6de7, 0x6de6, 0x6de6, 0x6de5, 0x6de4, 0x6de3, 0x6de3, 0x6de2, // 31392
-    0x6de1, 0x6de0, 0x6de0, 0x6ddf, 0x6dde, 0x6dde, 0x6ddd, 0x6ddc, // 31400
-    0x6ddb, 0x6ddb, 0x6dda, 0x6dd9, 0x6dd8, 0x6dd8, 0x6dd7, 0x6dd6, // 31408
-    0x6dd5, 0x6dd5, 0x6dd4, 0x6dd3, 0x6dd3, 0x6dd2, 0x6dd1, 0x6dd0, // 31416
-    0x6dd0, 0x6dcf, 0x6dce, 0x6dcd, 0x6dcd, 0x6dcc, 0x6dcb, 0x6dca, // 31424
-    0x6dca, 0x6dc9, 0x6dc8, 0x6dc8, 0x6dc7, 0x6dc6, 0x6dc5, 0x6dc5, // 31432
-    0x6dc4, 0x6dc3, 0x6dc2, 0x6dc2, 0x6dc1, 0x6dc0, 0x6dc0, 0x6dbf, // 31440
-    0x6dbe, 0x6dbd, 0x6dbd, 0x6dbc, 0x6dbb, 0x6dba, 0x6dba, 0x6db9, // 31448
-    0x6db8, 0x6db7, 0x6db7, 0x6db6, 0x6db5, 0x6db5, 0x6db4, 0x6db3, // 31456
-    0x6db2, 0x6db2, 0x6db1, 0x6db0, 0x6daf, 0x6daf, 0x6dae, 0x6dad, // 31464
-    0x6dac, 0x6dac, 0x6dab, 0x6daa, 0x6daa, 0x6da9, 0x6da8, 0x6da7, // 31472
-    0x6da7, 0x6da6, 0x6da5, 0x6da4, 0x6da4, 0x6da3, 0x6da2, 0x6da1, // 31480
-    0x6da1, 0x6da0, 0x6d9f, 0x6d9f, 0x6d9e, 0x6d9d, 0x6d9c, 0x6d9c, // 31488
-    0x6d9b, 0x6d9a, 0x6d99, 0x6d99, 0x6d98, 0x6d97, 0x6d96, 0x6d96, // 31496
-    0x6d95, 0x6d94, 0x6d94, 0x6d93, 0x6d92, 0x6d91, 0x6d91, 0x6d90, // 31504
-    0x6d8f, 0x6d8e, 0x6d8e, 0x6d8d, 0x6d8c, 0x6d8c, 0x6d8b, 0x6d8a, // 31512
-    0x6d89, 0x6d89, 0x6d88, 0x6d87, 0x6d86, 0x6d86, 0x6d85, 0x6d84, // 31520
-    0x6d83, 0x6d83, 0x6d82, 0x6d81, 0x6d81, 0x6d80, 0x6d7f, 0x6d7e, // 31528
-    0x6d7e, 0x6d7d, 0x6d7c, 0x6d7b, 0x6d7b, 0x6d7a, 0x6d79, 0x6d78, // 31536
-    0x6d78, 0x6d77, 0x6d76, 0x6d76, 0x6d75, 0x6d74, 0x6d73, 0x6d73, // 31544
-    0x6d72, 0x6d71, 0x6d70, 0x6d70, 0x6d6f, 0x6d6e, 0x6d6d, 0x6d6d, // 31552
-    0x6d6c, 0x6d6b, 0x6d6b, 0x6d6a, 0x6d69, 0x6d68, 0x6d68, 0x6d67, // 31560
-    0x6d66, 0x6d65, 0x6d65, 0x6d64, 0x6d63, 0x6d62, 0x6d62, 0x6d61, // 31568
-    0x6d60, 0x6d60, 0x6d5f, 0x6d5e, 0x6d5d, 0x6d5d, 0x6d5c, 0x6d5b, // 31576
-    0x6d5a, 0x6d5a, 0x6d59, 0x6d58, 0x6d58, 0x6d57, 0x6d56, 0x6d55, // 31584
-    0x6d55, 0x6d54, 0x6d53, 0x6d52, 0x6d52, 0x6d51, 0x6d50, 0x6d4f, // 31592
-    0x6d4f, 0x6d4e, 0x6d4d, 0x6d4d, 0x6d4c, 0x6d4b, 0x6d4a, 0x6d4a, // 31600
-    0x6d49, 0x6d48, 0x6d47, 0x6d47, 0x6d46, 0x6d45, 0x6d44, 0x6d44, // 31608
-    0x6d43, 0x6d42, 0x6d42, 0x6d41, 0x6d40, 0x6d3f, 0x6d3f, 0x6d3e, // 31616
-    0x6d3d, 0x6d3c, 0x6d3c, 0x6d3b, 0x6d3a, 0x6d39, 0x6d39, 0x6d38, // 31624
-    0x6d37, 0x6d37, 0x6d36, 0x6d35, 0x6d34, 0x6d34, 0x6d33, 0x6d32, // 31632
-    0x6d31, 0x6d31, 0x6d30, 0x6d2f, 0x6d2e, 0x6d2e, 0x6d2d, 0x6d2c, // 31640
-    0x6d2c, 0x6d2b, 0x6d2a, 0x6d29, 0x6d29, 0x6d28, 0x6d27, 0x6d26, // 31648
-    0x6d26, 0x6d25, 0x6d24, 0x6d24, 0x6d23, 0x6d22, 0x6d21, 0x6d21, // 31656
-    0x6d20, 0x6d1f, 0x6d1e, 0x6d1e, 0x6d1d, 0x6d1c, 0x6d1b, 0x6d1b, // 31664
-    0x6d1a, 0x6d19, 0x6d19, 0x6d18, 0x6d17, 0x6d16, 0x6d16, 0x6d15, // 31672
-    0x6d14, 0x6d13, 0x6d13, 0x6d12, 0x6d11, 0x6d10, 0x6d10, 0x6d0f, // 31680
-    0x6d0e, 0x6d0e, 0x6d0d, 0x6d0c, 0x6d0b, 0x6d0b, 0x6d0a, 0x6d09, // 31688
-    0x6d08, 0x6d08, 0x6d07, 0x6d06, 0x6d05, 0x6d05, 0x6d04, 0x6d03, // 31696
-    0x6d03, 0x6d02, 0x6d01, 0x6d00, 0x6d00, 0x6cff, 0x6cfe, 0x6cfd, // 31704
-    0x6cfd, 0x6cfc, 0x6cfb, 0x6cfa, 0x6cfa, 0x6cf9, 0x6cf8, 0x6cf8, // 31712
-    0x6cf7, 0x6cf6, 0x6cf5, 0x6cf5, 0x6cf4, 0x6cf3, 0x6cf2, 0x6cf2, // 31720
-    0x6cf1, 0x6cf0, 0x6cf0, 0x6cef, 0x6cee, 0x6ced, 0x6ced, 0x6cec, // 31728
-    0x6ceb, 0x6cea, 0x6cea, 0x6ce9, 0x6ce8, 0x6ce7, 0x6ce7, 0x6ce6, // 31736
-    0x6ce6, 0x6ce5, 0x6ce5, 0x6ce4, 0x6ce3, 0x6ce2, 0x6ce2, 0x6ce1, // 31744
-    0x6ce0, 0x6ce0, 0x6cdf, 0x6cde, 0x6cdd, 0x6cdd, 0x6cdc, 0x6cdb, // 31752
-    0x6cdb, 0x6cda, 0x6cd9, 0x6cd8, 0x6cd8, 0x6cd7, 0x6cd6, 0x6cd6, // 31760
-    0x6cd5, 0x6cd4, 0x6cd3, 0x6cd3, 0x6cd2, 0x6cd1, 0x6cd0, 0x6cd0, // 31768
-    0x6ccf, 0x6cce, 0x6cce, 0x6ccd, 0x6ccc, 0x6ccb, 0x6ccb, 0x6cca, // 31776
-    0x6cc9, 0x6cc9, 0x6cc8, 0x6cc7, 0x6cc6, 0x6cc6, 0x6cc5, 0x6cc4, // 31784
-    0x6cc4, 0x6cc3, 0x6cc2, 0x6cc1, 0x6cc1, 0x6cc0, 0x6cbf, 0x6cbf, // 31792
-    0x6cbe, 0x6cbd, 0x6cbc, 0x6cbc, 0x6cbb, 0x6cba, 0x6cba, 0x6cb9, // 31800
-    0x6cb8, 0x6cb7, 0x6cb7, 0x6cb6, 0x6cb5, 0x6cb5, 0x6cb4, 0x6cb3, // 31808
-    0x6cb2, 0x6cb2, 0x6cb1, 0x6cb0, 0x6cb0, 0x6caf, 0x6cae, 0x6cad, // 31816
-    0x6cad, 0x6cac, 0x6cab, 0x6cab, 0x6caa, 0x6ca9, 0x6ca8, 0x6ca8, // 31824
-    0x6ca7, 0x6ca6, 0x6ca5, 0x6ca5, 0x6ca4, 0x6ca3, 0x6ca3, 0x6ca2, // 31832
-    0x6ca1, 0x6ca0, 0x6ca0, 0x6c9f, 0x6c9e, 0x6c9e, 0x6c9d, 0x6c9c, // 31840
-    0x6c9b, 0x6c9b, 0x6c9a, 0x6c99, 0x6c99, 0x6c98, 0x6c97, 0x6c96, // 31848
-    0x6c96, 0x6c95, 0x6c94, 0x6c94, 0x6c93, 0x6c92, 0x6c91, 0x6c91, // 31856
-    0x6c90, 0x6c8f, 0x6c8f, 0x6c8e, 0x6c8d, 0x6c8c, 0x6c8c, 0x6c8b, // 31864
-    0x6c8a, 0x6c8a, 0x6c89, 0x6c88, 0x6c87, 0x6c87, 0x6c86, 0x6c85, // 31872
-    0x6c85, 0x6c84, 0x6c83, 0x6c82, 0x6c82, 0x6c81, 0x6c80, 0x6c7f, // 31880
-    0x6c7f, 0x6c7e, 0x6c7d, 0x6c7d, 0x6c7c, 0x6c7b, 0x6c7a, 0x6c7a, // 31888
-    0x6c79, 0x6c78, 0x6c78, 0x6c77, 0x6c76, 0x6c75, 0x6c75, 0x6c74, // 31896
-    0x6c73, 0x6c73, 0x6c72, 0x6c71, 0x6c70, 0x6c70, 0x6c6f, 0x6c6e, // 31904
-    0x6c6e, 0x6c6d, 0x6c6c, 0x6c6b, 0x6c6b, 0x6c6a, 0x6c69, 0x6c69, // 31912
-    0x6c68, 0x6c67, 0x6c66, 0x6c66, 0x6c65, 0x6c64, 0x6c64, 0x6c63, // 31920
-    0x6c62, 0x6c61, 0x6c61, 0x6c60, 0x6c5f, 0x6c5f, 0x6c5e, 0x6c5d, // 31928
-    0x6c5c, 0x6c5c, 0x6c5b, 0x6c5a, 0x6c5a, 0x6c59, 0x6c58, 0x6c57, // 31936
-    0x6c57, 0x6c56, 0x6c55, 0x6c54, 0x6c54, 0x6c53, 0x6c52, 0x6c52, // 31944
-    0x6c51, 0x6c50, 0x6c4f, 0x6c4f, 0x6c4e, 0x6c4d, 0x6c4d, 0x6c4c, // 31952
-    0x6c4b, 0x6c4a, 0x6c4a, 0x6c49, 0x6c48, 0x6c48, 0x6c47, 0x6c46, // 31960
-    0x6c45, 0x6c45, 0x6c44, 0x6c43, 0x6c43, 0x6c42, 0x6c41, 0x6c40, // 31968
-    0x6c40, 0x6c3f, 0x6c3e, 0x6c3e, 0x6c3d, 0x6c3c, 0x6c3b, 0x6c3b, // 31976
-    0x6c3a, 0x6c39, 0x6c39, 0x6c38, 0x6c37, 0x6c36, 0x6c36, 0x6c35, // 31984
-    0x6c34, 0x6c34, 0x6c33, 0x6c32, 0x6c31, 0x6c31, 0x6c30, 0x6c2f, // 31992
-    0x6c2f, 0x6c2e, 0x6c2d, 0x6c2c, 0x6c2c, 0x6c2b, 0x6c2a, 0x6c29, // 32000
-    0x6c29, 0x6c28, 0x6c27, 0x6c27, 0x6c26, 0x6c25, 0x6c24, 0x6c24, // 32008
-    0x6c23, 0x6c22, 0x6c22, 0x6c21, 0x6c20, 0x6c1f, 0x6c1f, 0x6c1e, // 32016
-    0x6c1d, 0x6c1d, 0x6c1c, 0x6c1b, 0x6c1a, 0x6c1a, 0x6c19, 0x6c18, // 32024
-    0x6c18, 0x6c17, 0x6c16, 0x6c15, 0x6c15, 0x6c14, 0x6c13, 0x6c13, // 32032
-    0x6c12, 0x6c11, 0x6c10, 0x6c10, 0x6c0f, 0x6c0e, 0x6c0e, 0x6c0d, // 32040
-    0x6c0c, 0x6c0b, 0x6c0b, 0x6c0a, 0x6c09, 0x6c09, 0x6c08, 0x6c07, // 32048
-    0x6c06, 0x6c06, 0x6c05, 0x6c04, 0x6c03, 0x6c03, 0x6c02, 0x6c01, // 32056
-    0x6c01, 0x6c00, 0x6bff, 0x6bfe, 0x6bfe, 0x6bfd, 0x6bfc, 0x6bfc, // 32064
-    0x6bfb, 0x6bfa, 0x6bf9, 0x6bf9, 0x6bf8, 0x6bf7, 0x6bf7, 0x6bf6, // 32072
-    0x6bf5, 0x6bf4, 0x6bf4, 0x6bf3, 0x6bf2, 0x6bf2, 0x6bf1, 0x6bf0, // 32080
-    0x6bef, 0x6bef, 0x6bee, 0x6bed, 0x6bed, 0x6bec, 0x6beb, 0x6bea, // 32088
-    0x6bea, 0x6be9, 0x6be8, 0x6be8, 0x6be7, 0x6be6, 0x6be5, 0x6be5, // 32096
-    0x6be4, 0x6be3, 0x6be3, 0x6be2, 0x6be1, 0x6be0, 0x6be0, 0x6bdf, // 32104
-    0x6bde, 0x6bde, 0x6bdd, 0x6bdc, 0x6bdb, 0x6bdb, 0x6bda, 0x6bd9, // 32112
-    0x6bd8, 0x6bd8, 0x6bd7, 0x6bd6, 0x6bd6, 0x6bd5, 0x6bd4, 0x6bd3, // 32120
-    0x6bd3, 0x6bd2, 0x6bd1, 0x6bd1, 0x6bd0, 0x6bcf, 0x6bce, 0x6bce, // 32128
-    0x6bcd, 0x6bcc, 0x6bcc, 0x6bcb, 0x6bca, 0x6bc9, 0x6bc9, 0x6bc8, // 32136
-    0x6bc7, 0x6bc7, 0x6bc6, 0x6bc5, 0x6bc4, 0x6bc4, 0x6bc3, 0x6bc2, // 32144
-    0x6bc2, 0x6bc1, 0x6bc0, 0x6bbf, 0x6bbf, 0x6bbe, 0x6bbd, 0x6bbd, // 32152
-    0x6bbc, 0x6bbb, 0x6bba, 0x6bba, 0x6bb9, 0x6bb8, 0x6bb8, 0x6bb7, // 32160
-    0x6bb6, 0x6bb5, 0x6bb5, 0x6bb4, 0x6bb3, 0x6bb2, 0x6bb2, 0x6bb1, // 32168
-    0x6bb0, 0x6bb0, 0x6baf, 0x6bae, 0x6bad, 0x6bad, 0x6bac, 0x6bab, // 32176
-    0x6bab, 0x6baa, 0x6ba9, 0x6ba8, 0x6ba8, 0x6ba7, 0x6ba6, 0x6ba6, // 32184
-    0x6ba5, 0x6ba4, 0x6ba3, 0x6ba3, 0x6ba2, 0x6ba1, 0x6ba1, 0x6ba0, // 32192
-    0x6b9f, 0x6b9e, 0x6b9e, 0x6b9d, 0x6b9c, 0x6b9c, 0x6b9b, 0x6b9a, // 32200
-    0x6b99, 0x6b99, 0x6b98, 0x6b97, 0x6b97, 0x6b96, 0x6b95, 0x6b94, // 32208
-    0x6b94, 0x6b93, 0x6b92, 0x6b92, 0x6b91, 0x6b90, 0x6b8f, 0x6b8f, // 32216
-    0x6b8e, 0x6b8d, 0x6b8d, 0x6b8c, 0x6b8b, 0x6b8a, 0x6b8a, 0x6b89, // 32224
-    0x6b88, 0x6b87, 0x6b87, 0x6b86, 0x6b85, 0x6b85, 0x6b84, 0x6b83, // 32232
-    0x6b82, 0x6b82, 0x6b81, 0x6b80, 0x6b80, 0x6b7f, 0x6b7e, 0x6b7d, // 32240
-    0x6b7d, 0x6b7c, 0x6b7b, 0x6b7b, 0x6b7a, 0x6b79, 0x6b78, 0x6b78, // 32248
-    0x6b77, 0x6b76, 0x6b76, 0x6b75, 0x6b74, 0x6b73, 0x6b73, 0x6b72, // 32256
-    0x6b71, 0x6b71, 0x6b70, 0x6b6f, 0x6b6e, 0x6b6e, 0x6b6d, 0x6b6c, // 32264
-    0x6b6c, 0x6b6b, 0x6b6a, 0x6b69, 0x6b69, 0x6b68, 0x6b67, 0x6b67, // 32272
-    0x6b66, 0x6b65, 0x6b64, 0x6b64, 0x6b63, 0x6b62, 0x6b61, 0x6b61, // 32280
-    0x6b60, 0x6b5f, 0x6b5f, 0x6b5e, 0x6b5d, 0x6b5c, 0x6b5c, 0x6b5b, // 32288
-    0x6b5a, 0x6b5a, 0x6b59, 0x6b58, 0x6b57, 0x6b57, 0x6b56, 0x6b55, // 32296
-    0x6b55, 0x6b54, 0x6b53, 0x6b52, 0x6b52, 0x6b51, 0x6b50, 0x6b50, // 32304
-    0x6b4f, 0x6b4e, 0x6b4d, 0x6b4d, 0x6b4c, 0x6b4b, 0x6b4b, 0x6b4a, // 32312
-    0x6b49, 0x6b48, 0x6b48, 0x6b47, 0x6b46, 0x6b46, 0x6b45, 0x6b44, // 32320
-    0x6b43, 0x6b43, 0x6b42, 0x6b41, 0x6b41, 0x6b40, 0x6b3f, 0x6b3e, // 32328
-    0x6b3e, 0x6b3d, 0x6b3c, 0x6b3c, 0x6b3b, 0x6b3a, 0x6b39, 0x6b39, // 32336
-    0x6b38, 0x6b37, 0x6b36, 0x6b36, 0x6b35, 0x6b34, 0x6b34, 0x6b33, // 32344
-    0x6b32, 0x6b31, 0x6b31, 0x6b30, 0x6b2f, 0x6b2f, 0x6b2e, 0x6b2d, // 32352
-    0x6b2c, 0x6b2c, 0x6b2b, 0x6b2a, 0x6b2a, 0x6b29, 0x6b28, 0x6b27, // 32360
-    0x6b27, 0x6b26, 0x6b25, 0x6b25, 0x6b24, 0x6b23, 0x6b22, 0x6b22, // 32368
-    0x6b21, 0x6b20, 0x6b20, 0x6b1f, 0x6b1e, 0x6b1d, 0x6b1d, 0x6b1c, // 32376
-    0x6b1b, 0x6b1b, 0x6b1a, 0x6b19, 0x6b18, 0x6b18, 0x6b17, 0x6b16, // 32384
-    0x6b16, 0x6b15, 0x6b14, 0x6b13, 0x6b13, 0x6b12, 0x6b11, 0x6b10, // 32392
-    0x6b10, 0x6b0f, 0x6b0e, 0x6b0e, 0x6b0d, 0x6b0c, 0x6b0b, 0x6b0b, // 32400
-    0x6b0a, 0x6b09, 0x6b09, 0x6b08, 0x6b07, 0x6b06, 0x6b06, 0x6b05, // 32408
-    0x6b04, 0x6b04, 0x6b03, 0x6b02, 0x6b01, 0x6b01, 0x6b00, 0x6aff, // 32416
-    0x6aff, 0x6afe, 0x6afd, 0x6afc, 0x6afc, 0x6afb, 0x6afa, 0x6afa, // 32424
-    0x6af9, 0x6af8, 0x6af7, 0x6af7, 0x6af6, 0x6af5, 0x6af5, 0x6af4, // 32432
-    0x6af3, 0x6af2, 0x6af2, 0x6af1, 0x6af0, 0x6af0, 0x6aef, 0x6aee, // 32440
-    0x6aed, 0x6aed, 0x6aec, 0x6aeb, 0x6aeb, 0x6aea, 0x6ae9, 0x6ae8, // 32448
-    0x6ae8, 0x6ae7, 0x6ae6, 0x6ae5, 0x6ae5, 0x6ae4, 0x6ae3, 0x6ae3, // 32456
-    0x6ae2, 0x6ae1, 0x6ae0, 0x6ae0, 0x6adf, 0x6ade, 0x6ade, 0x6add, // 32464
-    0x6adc, 0x6adb, 0x6adb, 0x6ada, 0x6ad9, 0x6ad9, 0x6ad8, 0x6ad7, // 32472
-    0x6ad6, 0x6ad6, 0x6ad5, 0x6ad4, 0x6ad4, 0x6ad3, 0x6ad2, 0x6ad1, // 32480
-    0x6ad1, 0x6ad0, 0x6acf, 0x6acf, 0x6ace, 0x6acd, 0x6acc, 0x6acc, // 32488
-    0x6acb, 0x6aca, 0x6aca, 0x6ac9, 0x6ac8, 0x6ac7, 0x6ac7, 0x6ac6, // 32496
-    0x6ac5, 0x6ac5, 0x6ac4, 0x6ac3, 0x6ac2, 0x6ac2, 0x6ac1, 0x6ac0, // 32504
-    0x6ac0, 0x6abf, 0x6abe, 0x6abd, 0x6abd, 0x6abc, 0x6abb, 0x6aba, // 32512
-    0x6aba, 0x6ab9, 0x6ab8, 0x6ab8, 0x6ab7, 0x6ab6, 0x6ab5, 0x6ab5, // 32520
-    0x6ab4, 0x6ab3, 0x6ab3, 0x6ab2, 0x6ab1, 0x6ab0, 0x6ab0, 0x6aaf, // 32528
-    0x6aae, 0x6aae, 0x6aad, 0x6aac, 0x6aab, 0x6aab, 0x6aaa, 0x6aa9, // 32536
-    0x6aa9, 0x6aa8, 0x6aa7, 0x6aa6, 0x6aa6, 0x6aa5, 0x6aa4, 0x6aa4, // 32544
-    0x6aa3, 0x6aa2, 0x6aa1, 0x6aa1, 0x6aa0, 0x6a9f, 0x6a9f, 0x6a9e, // 32552
-    0x6a9d, 0x6a9c, 0x6a9c, 0x6a9b, 0x6a9a, 0x6a9a, 0x6a99, 0x6a98, // 32560
-    0x6a97, 0x6a97, 0x6a96, 0x6a95, 0x6a94, 0x6a94, 0x6a93, 0x6a92, // 32568
-    0x6a92, 0x6a91, 0x6a90, 0x6a8f, 0x6a8f, 0x6a8e, 0x6a8d, 0x6a8d, // 32576
-    0x6a8c, 0x6a8b, 0x6a8a, 0x6a8a, 0x6a89, 0x6a88, 0x6a88, 0x6a87, // 32584
-    0x6a86, 0x6a85, 0x6a85, 0x6a84, 0x6a83, 0x6a83, 0x6a82, 0x6a81, // 32592
-    0x6a80, 0x6a80, 0x6a7f, 0x6a7e, 0x6a7e, 0x6a7d, 0x6a7c, 0x6a7b, // 32600
-    0x6a7b, 0x6a7a, 0x6a79, 0x6a79, 0x6a78, 0x6a77, 0x6a76, 0x6a76, // 32608
-    0x6a75, 0x6a74, 0x6a74, 0x6a73, 0x6a72, 0x6a71, 0x6a71, 0x6a70, // 32616
-    0x6a6f, 0x6a6f, 0x6a6e, 0x6a6d, 0x6a6c, 0x6a6c, 0x6a6b, 0x6a6a, // 32624
-    0x6a69, 0x6a69, 0x6a68, 0x6a67, 0x6a67, 0x6a66, 0x6a65, 0x6a64, // 32632
-    0x6a64, 0x6a63, 0x6a62, 0x6a62, 0x6a61, 0x6a60, 0x6a5f, 0x6a5f, // 32640
-    0x6a5e, 0x6a5d, 0x6a5d, 0x6a5c, 0x6a5b, 0x6a5a, 0x6a5a, 0x6a59, // 32648
-    0x6a58, 0x6a58, 0x6a57, 0x6a56, 0x6a55, 0x6a55, 0x6a54, 0x6a53, // 32656
-    0x6a53, 0x6a52, 0x6a51, 0x6a50, 0x6a50, 0x6a4f, 0x6a4e, 0x6a4e, // 32664
-    0x6a4d, 0x6a4c, 0x6a4b, 0x6a4b, 0x6a4a, 0x6a49, 0x6a49, 0x6a48, // 32672
-    0x6a47, 0x6a46, 0x6a46, 0x6a45, 0x6a44, 0x6a43, 0x6a43, 0x6a42, // 32680
-    0x6a41, 0x6a41, 0x6a40, 0x6a3f, 0x6a3e, 0x6a3e, 0x6a3d, 0x6a3c, // 32688
-    0x6a3c, 0x6a3b, 0x6a3a, 0x6a39, 0x6a39, 0x6a38, 0x6a37, 0x6a37, // 32696
-    0x6a36, 0x6a35, 0x6a34, 0x6a34, 0x6a33, 0x6a32, 0x6a32, 0x6a31, // 32704
-    0x6a30, 0x6a2f, 0x6a2f, 0x6a2e, 0x6a2d, 0x6a2d, 0x6a2c, 0x6a2b, // 32712
-    0x6a2a, 0x6a2a, 0x6a29, 0x6a28, 0x6a28, 0x6a27, 0x6a26, 0x6a25, // 32720
-    0x6a25, 0x6a24, 0x6a23, 0x6a23, 0x6a22, 0x6a21, 0x6a20, 0x6a20, // 32728
-    0x6a1f, 0x6a1e, 0x6a1e, 0x6a1d, 0x6a1c, 0x6a1b, 0x6a1b, 0x6a1a, // 32736
-    0x6a19, 0x6a18, 0x6a18, 0x6a17, 0x6a16, 0x6a16, 0x6a15, 0x6a14, // 32744
-    0x6a13, 0x6a13, 0x6a12, 0x6a11, 0x6a11, 0x6a10, 0x6a0f, 0x6a0e, // 32752
-    0x6a0e, 0x6a0d, 0x6a0c, 0x6a0c, 0x6a0b, 0x6a0a, 0x6a09, 0x6a09  // 32760
-};
+#include "avx512_rcp14.h"
 
 #include "fpu/softfloat-specialize.h"
 #include "fpu/softfloat-round-pack.h"
@@ -8281,14 +77,14 @@ float32 approximate_rsqrt14(float32 op, bx_bool daz)
    * 14th bit after the decimal point by round-to-nearest, regardless
    * of the current rounding mode.
    *
-   * Using two precalculated 32K-entry tables.
+   * Using piecewise linear approximation of the 16-bit result.
    */
 
-  const Bit16u *rsqrt_table = (exp & 1) ? rsqrt14_table1 : rsqrt14_table0;
+  unsigned odd_exp = exp & 1;
 
   exp = 0x7E - ((exp - 0x7F) >> 1);
   if (fraction)
-    fraction = rsqrt_table[fraction >> 8];
+    fraction = rsqrt14_table(odd_exp, fraction >> 8);
   else
     exp++;
 
@@ -8338,11 +134,11 @@ float64 approximate_rsqrt14(float64 op, bx_bool daz)
   // for the shifted off bits.
   fraction = (fraction >> 29) | ((fraction & 0x1fffffff) != 0);
 
-  const Bit16u *rsqrt_table = (exp & 1) ? rsqrt14_table1 : rsqrt14_table0;
+  unsigned odd_exp = exp & 1;
 
   exp = 0x3FE - ((exp - 0x3FF) >> 1);
   if (fraction)
-    fraction = rsqrt_table[(Bit32u)fraction >> 8];
+    fraction = rsqrt14_table(odd_exp, (Bit32u)fraction >> 8);
   else
     exp++;
 
@@ -1282,10 +1282,29 @@ public: // for now...
   struct {
     bx_TLB_entry entry[BX_TLB_SIZE] BX_CPP_AlignN(16);
 #if BX_CPU_LEVEL >= 5
-    bx_bool split_large;
+    bx_bool split_large;  // large page entry present in TLB or ITLB
 #endif
   } TLB;
 
+  struct {
+    bx_TLB_entry entry[BX_ITLB_SIZE] BX_CPP_AlignN(16);
+  } ITLB;
+
+  struct {
+    bx_TLB_L2_entry entry[BX_TLB_L2_SIZE];
+    bx_TLB_L2_entry large[BX_TLB_L2_LARGE_SIZE];
+    Bit8u victim[BX_TLB_L2_SETS];
+    unsigned large_victim;
+    unsigned large_entries; // number of valid entries in large[] array
+  } TLB_L2;
+
+#if BX_SUPPORT_X86_64
+  // paging-structure caches, indexed by [level-1][], for long mode page
+  // walks and for nested (EPT / NPT) walks of guest physical addresses
+  bx_PSC_entry PSC[3][BX_PSC_SIZE];
+  bx_PSC_entry PSC_nested[3][BX_PSC_SIZE];
+#endif
+
 #if BX_CPU_LEVEL >= 6
   struct {
     Bit64u entry[4];
@@ -1574,6 +1593,12 @@ public: // for now...
   BX_SMF BX_INSF_TYPE CALL_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JMP_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JMP_Jw(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF BX_INSF_TYPE CALL_Jw_Superblock(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE CALL_Jd_Superblock(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE JMP_Jd_Superblock(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE JMP_Jw_Superblock(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
   BX_SMF BX_INSF_TYPE JMP_Ap(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE IN_ALDX(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE IN_AXDX(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
@@ -1643,6 +1668,12 @@ public: // for now...
   BX_SMF BX_INSF_TYPE JNL_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JLE_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JNLE_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF BX_INSF_TYPE CMP_GdEdR_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE CMP_EdIdR_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE TEST_EdGdR_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE TEST_EdIdR_Jd(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
 
   BX_SMF BX_INSF_TYPE SETO_EbR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE SETNO_EbR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
@@ -1985,6 +2016,21 @@ public: // for now...
   BX_SMF BX_INSF_TYPE DEC_EwR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE DEC_EdR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF BX_INSF_TYPE ADD_GdEdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE ADD_EdIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE SUB_GdEdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE SUB_EdIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE AND_GdEdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE AND_EdIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE OR_GdEdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE OR_EdIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE XOR_GdEdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE XOR_EdIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE INC_EdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE DEC_EdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
+
   BX_SMF BX_INSF_TYPE INC_EbM(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE INC_EwM(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE INC_EdM(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
@@ -4073,6 +4119,10 @@ public: // for now...
 
   BX_SMF BX_INSF_TYPE CALL_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JMP_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF BX_INSF_TYPE CALL_Jq_Superblock(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE JMP_Jq_Superblock(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
 
   BX_SMF BX_INSF_TYPE JO_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JNO_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
@@ -4090,6 +4140,16 @@ public: // for now...
   BX_SMF BX_INSF_TYPE JNL_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JLE_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JNLE_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF BX_INSF_TYPE CMP_GdEdR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE CMP_EdIdR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE TEST_EdGdR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE TEST_EdIdR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE CMP_GqEqR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE CMP_EqIdR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE TEST_EqGqR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE TEST_EqIdR_Jq(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
 
   BX_SMF BX_INSF_TYPE ENTER64_IwIb(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE LEAVE64(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
@@ -4186,6 +4246,20 @@ public: // for now...
   BX_SMF BX_INSF_TYPE DEC_EqM(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE INC_EqR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE DEC_EqR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF BX_INSF_TYPE ADD_GqEqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE ADD_EqIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE SUB_GqEqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE SUB_EqIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE AND_GqEqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE AND_EqIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE OR_GqEqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE OR_EqIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE XOR_GqEqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE XOR_EqIdR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE INC_EqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_INSF_TYPE DEC_EqR_DeadFlags(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
   BX_SMF BX_INSF_TYPE CALL_EqR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE CALL64_Ep(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
   BX_SMF BX_INSF_TYPE JMP_EqR(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
@@ -4361,6 +4435,11 @@ public: // for now...
   BX_SMF bxICacheEntry_c *serveICacheMiss(Bit32u eipBiased, bx_phy_address pAddr);
   BX_SMF bxICacheEntry_c* getICacheEntry(void);
   BX_SMF bx_bool mergeTraces(bxICacheEntry_c *entry, bxInstruction_c *i, bx_phy_address pAddr);
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+  BX_SMF bx_bool followSuperblockBranch(bxInstruction_c *i, Bit32u *eipBiased);
+  BX_SMF void eliminateDeadFlags(bxICacheEntry_c *entry);
+  BX_SMF void fuseCompareAndBranch(bxICacheEntry_c *entry);
+#endif
 #if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS && BX_ENABLE_TRACE_LINKING
   BX_SMF BX_INSF_TYPE linkTrace(bxInstruction_c *i) BX_CPP_AttrRegparmN(1);
 #endif
@@ -4545,11 +4624,23 @@ public: // for now...
 
   BX_SMF Bit8u* v2h_read_byte(bx_address laddr, bx_bool user) BX_CPP_AttrRegparmN(2);
   BX_SMF Bit8u* v2h_write_byte(bx_address laddr, bx_bool user) BX_CPP_AttrRegparmN(2);
+#if BX_SUPPORT_AVX
+  BX_SMF BX_CPP_INLINE bx_TLB_entry* v2h_read_tlb_entry(bx_address laddr, unsigned len) BX_CPP_AttrRegparmN(2);
+  BX_SMF BX_CPP_INLINE bx_TLB_entry* v2h_write_tlb_entry(bx_address laddr, unsigned len) BX_CPP_AttrRegparmN(2);
+#endif
 
   BX_SMF void branch_near16(Bit16u new_IP) BX_CPP_AttrRegparmN(1);
   BX_SMF void branch_near32(Bit32u new_EIP) BX_CPP_AttrRegparmN(1);
 #if BX_SUPPORT_X86_64
   BX_SMF void branch_near64(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#endif
+  BX_SMF BX_CPP_INLINE void call_near_rel16(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_CPP_INLINE void call_near_rel32(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_CPP_INLINE void jmp_near_rel16(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_CPP_INLINE void jmp_near_rel32(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+#if BX_SUPPORT_X86_64
+  BX_SMF BX_CPP_INLINE void call_near_rel64(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
+  BX_SMF BX_CPP_INLINE void jmp_near_rel64(bxInstruction_c *) BX_CPP_AttrRegparmN(1);
 #endif
   BX_SMF void branch_far32(bx_selector_t *selector,
        bx_descriptor_t *descriptor, Bit32u eip, Bit8u cpl);
@@ -4557,19 +4648,13 @@ public: // for now...
        bx_descriptor_t *descriptor, bx_address rip, Bit8u cpl);
 
 #if BX_SUPPORT_REPEAT_SPEEDUPS
-  BX_SMF Bit32u FastRepMOVSB(bxInstruction_c *i, unsigned srcSeg, Bit32u srcOff,
-       unsigned dstSeg, Bit32u dstOff, Bit32u  byteCount);
-  BX_SMF Bit32u FastRepMOVSW(bxInstruction_c *i, unsigned srcSeg, Bit32u srcOff,
-       unsigned dstSeg, Bit32u dstOff, Bit32u  wordCount);
-  BX_SMF Bit32u FastRepMOVSD(bxInstruction_c *i, unsigned srcSeg, Bit32u srcOff,
-       unsigned dstSeg, Bit32u dstOff, Bit32u dwordCount);
-
-  BX_SMF Bit32u FastRepSTOSB(bxInstruction_c *i, unsigned dstSeg, Bit32u dstOff,
-       Bit8u  val, Bit32u  byteCount);
-  BX_SMF Bit32u FastRepSTOSW(bxInstruction_c *i, unsigned dstSeg, Bit32u dstOff,
-       Bit16u val, Bit32u  wordCount);
-  BX_SMF Bit32u FastRepSTOSD(bxInstruction_c *i, unsigned dstSeg, Bit32u dstOff,
-       Bit32u val, Bit32u dwordCount);
+  BX_SMF Bit8u* FastRepHostAddr(unsigned seg, bx_address offset, unsigned rw, bx_address *laddr);
+  BX_SMF Bit32u FastRepCount(bxInstruction_c *i);
+  BX_SMF void FastRepUpdate(bxInstruction_c *i, Bit32u count, unsigned len, bx_bool src);
+  BX_SMF void FastRepMOVS(bxInstruction_c *i, unsigned len);
+  BX_SMF void FastRepSTOS(bxInstruction_c *i, unsigned len);
+  BX_SMF void FastRepSCAS(bxInstruction_c *i, unsigned len);
+  BX_SMF void FastRepCMPS(bxInstruction_c *i, unsigned len);
 
   BX_SMF Bit32u FastRepINSW(bxInstruction_c *i, Bit32u dstOff,
        Bit16u port, Bit32u wordCount);
@@ -4625,9 +4710,19 @@ public: // for now...
 
 #if BX_CPU_LEVEL >= 6
   BX_SMF void TLB_flushNonGlobal(void);
+  BX_SMF void TLB_flushFirstLevelNonGlobal(void);
+#endif
+#if BX_SUPPORT_X86_64
+  BX_SMF void TLB_flushPCID(Bit32u pcid, bx_bool invalidate);
+  BX_SMF void TLB_L2_flushPCID(Bit32u pcid);
+  BX_SMF BX_CPP_INLINE Bit32u current_PCID(void);
 #endif
   BX_SMF void TLB_flush(void);
   BX_SMF void TLB_invlpg(bx_address laddr);
+  BX_SMF bx_TLB_L2_entry *TLB_L2_lookup(bx_address laddr, unsigned user, unsigned rw);
+  BX_SMF void TLB_L2_fill(bx_address laddr, bx_phy_address paddress, Bit32u lpf_mask, Bit32u combined_access, Bit32u accessBits, Bit32u pkey);
+  BX_SMF void TLB_L2_flush(bx_bool keep_global);
+  BX_SMF void TLB_L2_invlpg(bx_address laddr);
   BX_SMF void inhibit_interrupts(unsigned mask);
   BX_SMF bx_bool interrupts_inhibited(unsigned mask);
   BX_SMF const char *strseg(bx_segment_reg_t *seg);
@@ -4692,6 +4787,7 @@ public: // for now...
   BX_SMF void avx_masked_store16(bxInstruction_c *i, bx_address eaddr, const BxPackedAvxRegister *op, Bit32u mask);
   BX_SMF void avx_masked_store32(bxInstruction_c *i, bx_address eaddr, const BxPackedAvxRegister *op, Bit32u mask);
   BX_SMF void avx_masked_store64(bxInstruction_c *i, bx_address eaddr, const BxPackedAvxRegister *op, Bit32u mask);
+  BX_SMF BX_CPP_INLINE bx_TLB_entry* avx_masked_tlb_entry(bxInstruction_c *i, bx_address eaddr, unsigned rw, bx_address *laddr);
 #endif
 
 #if BX_SUPPORT_EVEX
@@ -5590,6 +5686,13 @@ BX_CPP_INLINE unsigned BX_CPU_C::get_cpu_mode(void)
   return (BX_CPU_THIS_PTR cpu_mode);
 }
 
+#if BX_SUPPORT_X86_64
+BX_CPP_INLINE Bit32u BX_CPU_C::current_PCID(void)
+{
+  return BX_CPU_THIS_PTR cr4.get_PCIDE() ? (Bit32u)(BX_CPU_THIS_PTR cr3 & 0xfff) : 0;
+}
+#endif
+
 #if BX_SUPPORT_ALIGNMENT_CHECK && BX_CPU_LEVEL >= 4
 BX_CPP_INLINE bx_bool BX_CPU_C::alignment_check(void)
 {
@@ -5699,6 +5802,125 @@ class bxInstruction_c;
   BX_EXECUTE_INSTRUCTION(i);                           \
 }
 
+// The arithmetic flags are overwritten by the next instruction of the trace
+// and have to be computed only when the trace stops after this instruction
+#define BX_NEXT_INSTR_DEAD_FLAGS(i, set_flags) {       \
+  if (BX_CPU_THIS_PTR async_event) set_flags;          \
+  BX_NEXT_INSTR(i);                                    \
+}
+
+// Jcc condition (low nibble of the Jcc opcode) computed directly from the
+// operands of CMP op1,op2 without going through the lazy flags, TEST is
+// evaluated as CMP of its result with zero
+BX_CPP_INLINE bx_bool jcc_condition32(unsigned cond, Bit32u op1, Bit32u op2)
+{
+  Bit32u diff = op1 - op2;
+  bx_bool taken;
+
+  switch(cond >> 1) {
+  case 0: /* O */
+    taken = ((op1 ^ op2) & (op1 ^ diff)) >> 31;
+    break;
+  case 1: /* B */
+    taken = (op1 < op2);
+    break;
+  case 2: /* Z */
+    taken = (op1 == op2);
+    break;
+  case 3: /* BE */
+    taken = (op1 <= op2);
+    break;
+  case 4: /* S */
+    taken = diff >> 31;
+    break;
+  case 5: /* P */
+    diff = (diff ^ (diff >> 4)) & 0x0F;
+    taken = (0x9669U >> diff) & 1;
+    break;
+  case 6: /* L */
+    taken = ((Bit32s) op1 < (Bit32s) op2);
+    break;
+  default: /* LE */
+    taken = ((Bit32s) op1 <= (Bit32s) op2);
+    break;
+  }
+
+  return taken ^ (cond & 1);
+}
+
+#if BX_SUPPORT_X86_64
+BX_CPP_INLINE bx_bool jcc_condition64(unsigned cond, Bit64u op1, Bit64u op2)
+{
+  Bit64u diff = op1 - op2;
+  bx_bool taken;
+
+  switch(cond >> 1) {
+  case 0: /* O */
+    taken = (bx_bool)(((op1 ^ op2) & (op1 ^ diff)) >> 63);
+    break;
+  case 1: /* B */
+    taken = (op1 < op2);
+    break;
+  case 2: /* Z */
+    taken = (op1 == op2);
+    break;
+  case 3: /* BE */
+    taken = (op1 <= op2);
+    break;
+  case 4: /* S */
+    taken = (bx_bool)(diff >> 63);
+    break;
+  case 5: /* P */
+    diff = (diff ^ (diff >> 4)) & 0x0F;
+    taken = (0x9669U >> diff) & 1;
+    break;
+  case 6: /* L */
+    taken = ((Bit64s) op1 < (Bit64s) op2);
+    break;
+  default: /* LE */
+    taken = ((Bit64s) op1 <= (Bit64s) op2);
+    break;
+  }
+
+  return taken ^ (cond & 1);
+}
+#endif
+
+// CMP/TEST fused with the Jcc following it in the trace: the Jcc is
+// executed by the compare handler without another dispatch. The compare
+// still updates the lazy flags and is committed on its own, the Jcc runs
+// through its regular handler if the trace stops in between.
+#define BX_NEXT_INSTR_FUSED_JD(i, taken) {                    \
+  BX_COMMIT_INSTRUCTION(i);                                   \
+  if (BX_CPU_THIS_PTR async_event) return;                    \
+  ++i;                                                        \
+  BX_INSTR_BEFORE_EXECUTION(BX_CPU_ID, (i));                  \
+  RIP += (i)->ilen();                                         \
+  if (taken) {                                                \
+    Bit32u new_EIP = EIP + (Bit32s) i->Id();                  \
+    branch_near32(new_EIP);                                   \
+    BX_INSTR_CNEAR_BRANCH_TAKEN(BX_CPU_ID, PREV_RIP, new_EIP); \
+    BX_LINK_TRACE(i);                                         \
+  }                                                           \
+  BX_INSTR_CNEAR_BRANCH_NOT_TAKEN(BX_CPU_ID, PREV_RIP);       \
+  BX_NEXT_INSTR(i);                                           \
+}
+
+#define BX_NEXT_INSTR_FUSED_JQ(i, taken) {                    \
+  BX_COMMIT_INSTRUCTION(i);                                   \
+  if (BX_CPU_THIS_PTR async_event) return;                    \
+  ++i;                                                        \
+  BX_INSTR_BEFORE_EXECUTION(BX_CPU_ID, (i));                  \
+  RIP += (i)->ilen();                                         \
+  if (taken) {                                                \
+    branch_near64(i);                                         \
+    BX_INSTR_CNEAR_BRANCH_TAKEN(BX_CPU_ID, PREV_RIP, RIP);    \
+    BX_LINK_TRACE(i);                                         \
+  }                                                           \
+  BX_INSTR_CNEAR_BRANCH_NOT_TAKEN(BX_CPU_ID, PREV_RIP);       \
+  BX_NEXT_INSTR(i);                                           \
+}
+
 #else // BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
 
 #define BX_NEXT_TRACE(i) { return; }
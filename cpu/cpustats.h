@@ -39,6 +39,8 @@ struct bx_cpu_statistics
   Bit64u iCacheLookups;
   Bit64u iCachePrefetch;
   Bit64u iCacheMisses;
+  Bit64u iCacheEvictions;
+  Bit64u iCacheSuperblockBranches;
 
   // tlb lookup statistics
   Bit64u tlbLookups;
@@ -47,10 +49,12 @@ struct bx_cpu_statistics
   Bit64u tlbMisses;
   Bit64u tlbExecuteMisses;
   Bit64u tlbWriteMisses;
+  Bit64u tlbL2Misses;
 
   // tlb flush statistics
   Bit64u tlbGlobalFlushes;
   Bit64u tlbNonGlobalFlushes;
+  Bit64u tlbPcidFlushes;
 
   // stack prefetch statistics
   Bit64u stackPrefetch;
@@ -59,10 +63,10 @@ struct bx_cpu_statistics
   Bit64u smc;
 
   bx_cpu_statistics():
-      iCacheLookups(0), iCachePrefetch(0), iCacheMisses(0),
+      iCacheLookups(0), iCachePrefetch(0), iCacheMisses(0), iCacheEvictions(0), iCacheSuperblockBranches(0),
       tlbLookups(0), tlbExecuteLookups(0), tlbWriteLookups(0),
-      tlbMisses(0), tlbExecuteMisses(0), tlbWriteMisses(0),
-      tlbGlobalFlushes(0), tlbNonGlobalFlushes(0),
+      tlbMisses(0), tlbExecuteMisses(0), tlbWriteMisses(0), tlbL2Misses(0),
+      tlbGlobalFlushes(0), tlbNonGlobalFlushes(0), tlbPcidFlushes(0),
       stackPrefetch(0), smc(0) {}
   
 };
@@ -28,95 +28,123 @@
 
 #if BX_CPU_LEVEL >= 6
 
-// 3-byte opcodes
+#include "simd_int.h"
 
-#define CRC32_POLYNOMIAL BX_CONST64(0x11edc6f41)
+// The CRC32 instruction computes CRC-32C (polynomial 0x11EDC6F41) in the
+// bit-reflected form. No preload or final complement is applied, the
+// running CRC value is passed in like the instruction does. The host CRC32
+// instruction is used when the host supports it, otherwise a slicing-by-8
+// table kernel.
 
-// primitives for CRC32 usage
-BX_CPP_INLINE Bit8u BitReflect8(Bit8u val8)
-{
-  return ((val8 & 0x80) >> 7) |
-         ((val8 & 0x40) >> 5) |
-         ((val8 & 0x20) >> 3) |
-         ((val8 & 0x10) >> 1) |
-         ((val8 & 0x08) << 1) |
-         ((val8 & 0x04) << 3) |
-         ((val8 & 0x02) << 5) |
-         ((val8 & 0x01) << 7);
-}
+#define CRC32C_POLY 0x82f63b78    /* Castagnoli, bit-reflected */
 
-BX_CPP_INLINE Bit16u BitReflect16(Bit16u val16)
+static Bit32u crc32c_table[8][256];
+static bx_bool crc32c_table_ready = 0;
+
+static void init_crc32c_table(void)
 {
-  return ((Bit16u)(BitReflect8(val16 & 0xff)) << 8) | BitReflect8(val16 >> 8);
+  for (unsigned i = 0; i < 256; ++i) {
+    Bit32u c = i;
+    for (unsigned j = 0; j < 8; ++j)
+      c = c & 1 ? (c >> 1) ^ CRC32C_POLY : (c >> 1);
+    crc32c_table[0][i] = c;
+  }
+
+  for (unsigned i = 0; i < 256; ++i) {
+    Bit32u c = crc32c_table[0][i];
+    for (unsigned j = 1; j < 8; ++j) {
+      c = (c >> 8) ^ crc32c_table[0][c & 0xff];
+      crc32c_table[j][i] = c;
+    }
+  }
+
+  crc32c_table_ready = 1;
 }
 
-BX_CPP_INLINE Bit32u BitReflect32(Bit32u val32)
+#if BX_HOST_CRYPTO
+BX_HOST_TARGET("sse4.2") static Bit32u crc32c_host_value(Bit32u crc, Bit64u data, unsigned len)
 {
-  return ((Bit32u)(BitReflect16(val32 & 0xffff)) << 16) | BitReflect16(val32 >> 16);
+  switch(len) {
+    case 1: return _mm_crc32_u8(crc, (Bit8u) data);
+    case 2: return _mm_crc32_u16(crc, (Bit16u) data);
+    case 4: return _mm_crc32_u32(crc, (Bit32u) data);
+    default:
+#if defined(__x86_64__)
+      return (Bit32u) _mm_crc32_u64(crc, data);
+#else
+      crc = _mm_crc32_u32(crc, (Bit32u) data);
+      return _mm_crc32_u32(crc, (Bit32u)(data >> 32));
+#endif
+  }
 }
+#endif
 
-static Bit32u mod2_64bit(Bit64u divisor, Bit64u dividend)
+// CRC-32C of a 1, 2, 4 or 8 byte value taken in little endian byte order
+static Bit32u crc32c_value(Bit32u crc, Bit64u data, unsigned len)
 {
-  Bit64u remainder = dividend >> 32;
-
-  for (int bitpos=31; bitpos>=0; bitpos--) {
-    // copy one more bit from the dividend
-    remainder = (remainder << 1) | ((dividend >> bitpos) & 1);
-
-    // if MSB is set, then XOR divisor and get new remainder
-    if (((remainder >> 32) & 1) == 1) {
-      remainder ^= divisor;
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_CRC32)
+    return crc32c_host_value(crc, data, len);
+#endif
+
+  if (! crc32c_table_ready)
+    init_crc32c_table();
+
+  Bit32u one = crc ^ (Bit32u) data;
+
+  switch(len) {
+    case 1:
+      return (crc >> 8) ^ crc32c_table[0][one & 0xff];
+    case 2:
+      return (crc >> 16) ^ crc32c_table[1][one & 0xff] ^ crc32c_table[0][(one >> 8) & 0xff];
+    case 4:
+      return crc32c_table[3][one & 0xff] ^ crc32c_table[2][(one >> 8) & 0xff] ^
+             crc32c_table[1][(one >> 16) & 0xff] ^ crc32c_table[0][one >> 24];
+    default:
+    {
+      Bit32u two = (Bit32u)(data >> 32);
+      return crc32c_table[7][one & 0xff] ^ crc32c_table[6][(one >> 8) & 0xff] ^
+             crc32c_table[5][(one >> 16) & 0xff] ^ crc32c_table[4][one >> 24] ^
+             crc32c_table[3][two & 0xff] ^ crc32c_table[2][(two >> 8) & 0xff] ^
+             crc32c_table[1][(two >> 16) & 0xff] ^ crc32c_table[0][two >> 24];
     }
   }
-
-  return (Bit32u) remainder;
 }
 
+// 3-byte opcodes
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CRC32_GdEbR(bxInstruction_c *i)
 {
   Bit8u op1 = BX_READ_8BIT_REGx(i->src(), i->extend8bitL());
-
   Bit32u op2 = BX_READ_32BIT_REG(i->dst());
-  op2 = BitReflect32(op2);
 
-  Bit64u tmp1 = ((Bit64u) BitReflect8 (op1)) << 32;
-  Bit64u tmp2 = ((Bit64u) op2) <<  8;
-  Bit64u tmp3 = tmp1 ^ tmp2;
-  op2 = mod2_64bit(CRC32_POLYNOMIAL, tmp3);
+  op2 = crc32c_value(op2, op1, 1);
 
-  BX_WRITE_32BIT_REGZ(i->dst(), BitReflect32(op2));
+  BX_WRITE_32BIT_REGZ(i->dst(), op2);
 
   BX_NEXT_INSTR(i);
 }
 
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CRC32_GdEwR(bxInstruction_c *i)
 {
-  Bit32u op2 = BX_READ_32BIT_REG(i->dst());
-  op2 = BitReflect32(op2);
   Bit16u op1 = BX_READ_16BIT_REG(i->src());
+  Bit32u op2 = BX_READ_32BIT_REG(i->dst());
 
-  Bit64u tmp1 = ((Bit64u) BitReflect16(op1)) << 32;
-  Bit64u tmp2 = ((Bit64u) op2) << 16;
-  Bit64u tmp3 = tmp1 ^ tmp2;
-  op2 = mod2_64bit(CRC32_POLYNOMIAL, tmp3);
+  op2 = crc32c_value(op2, op1, 2);
 
-  BX_WRITE_32BIT_REGZ(i->dst(), BitReflect32(op2));
+  BX_WRITE_32BIT_REGZ(i->dst(), op2);
 
   BX_NEXT_INSTR(i);
 }
 
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CRC32_GdEdR(bxInstruction_c *i)
 {
-  Bit32u op2 = BX_READ_32BIT_REG(i->dst());
-  op2 = BitReflect32(op2);
   Bit32u op1 = BX_READ_32BIT_REG(i->src());
+  Bit32u op2 = BX_READ_32BIT_REG(i->dst());
 
-  Bit64u tmp1 = ((Bit64u) BitReflect32(op1)) << 32;
-  Bit64u tmp2 = ((Bit64u) op2) << 32;
-  Bit64u tmp3 = tmp1 ^ tmp2;
-  op2 = mod2_64bit(CRC32_POLYNOMIAL, tmp3);
+  op2 = crc32c_value(op2, op1, 4);
 
-  BX_WRITE_32BIT_REGZ(i->dst(), BitReflect32(op2));
+  BX_WRITE_32BIT_REGZ(i->dst(), op2);
 
   BX_NEXT_INSTR(i);
 }
@@ -125,20 +153,12 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CRC32_GdEdR(bxInstruction_c *i)
 
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CRC32_GdEqR(bxInstruction_c *i)
 {
-  Bit32u op2 = BX_READ_32BIT_REG(i->dst());
-  op2 = BitReflect32(op2);
   Bit64u op1 = BX_READ_64BIT_REG(i->src());
+  Bit32u op2 = BX_READ_32BIT_REG(i->dst());
 
-  Bit64u tmp1 = ((Bit64u) BitReflect32(op1 & 0xffffffff)) << 32;
-  Bit64u tmp2 = ((Bit64u) op2) << 32;
-  Bit64u tmp3 = tmp1 ^ tmp2;
-  op2  = mod2_64bit(CRC32_POLYNOMIAL, tmp3);
-  tmp1 = ((Bit64u) BitReflect32(op1 >> 32)) << 32;
-  tmp2 = ((Bit64u) op2) << 32;
-  tmp3 = tmp1 ^ tmp2;
-  op2  = mod2_64bit(CRC32_POLYNOMIAL, tmp3);
+  op2 = crc32c_value(op2, op1, 8);
 
-  BX_WRITE_32BIT_REGZ(i->dst(), BitReflect32(op2));
+  BX_WRITE_32BIT_REGZ(i->dst(), op2);
 
   BX_NEXT_INSTR(i);
 }
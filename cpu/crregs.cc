@@ -705,12 +705,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::MOV_CR3Rq(bxInstruction_c *i)
   }
 #endif
 
-  // allow bit 63 (hint that TLB doesn't need to be cleared) to be set when
-  // PCIDE is set, but ignore the hint if given
-  if (BX_CPU_THIS_PTR cr4.get_PCIDE()) {
-    val_64 &= ~(BX_CONST64(1)<<63);
-  }
-
+  // bit 63 (hint that TLB doesn't need to be cleared) is handled by SetCR3
   if (! SetCR3(val_64))
     exception(BX_GP_EXCEPTION, 0);
 
@@ -1348,6 +1343,15 @@ bx_bool BX_CPU_C::SetCR4(bxInstruction_c *i, bx_address val)
 bx_bool BX_CPP_AttrRegparmN(1) BX_CPU_C::SetCR3(bx_address val)
 {
 #if BX_SUPPORT_X86_64
+  bx_bool noflush = 0;
+
+  // allow bit 63 (hint that TLB doesn't need to be cleared) to be set when
+  // PCIDE is set, TLB entries tagged with the new PCID are kept if given
+  if (BX_CPU_THIS_PTR cr4.get_PCIDE()) {
+    noflush = (val >> 63) & 1;
+    val &= ~(BX_CONST64(1)<<63);
+  }
+
   if (long_mode()) {
     if (! IsValidPhyAddr(val)) {
       BX_ERROR(("SetCR3(): Attempt to write to reserved bits of CR3 !"));
@@ -1358,6 +1362,14 @@ bx_bool BX_CPP_AttrRegparmN(1) BX_CPU_C::SetCR3(bx_address val)
 
   BX_CPU_THIS_PTR cr3 = val;
 
+#if BX_SUPPORT_X86_64
+  // TLB entries of other PCIDs survive the switch
+  if (BX_CPU_THIS_PTR cr4.get_PCIDE()) {
+    TLB_flushPCID(current_PCID(), !noflush);
+    return 1;
+  }
+#endif
+
   // flush TLB even if value does not change
 #if BX_CPU_LEVEL >= 6
   if (BX_CPU_THIS_PTR cr4.get_PGE())
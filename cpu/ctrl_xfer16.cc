@@ -215,7 +215,8 @@ done:
   BX_NEXT_TRACE(i);
 }
 
-BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jw(bxInstruction_c *i)
+// CALL_Jw and CALL_Jw_Superblock only differ in the way the trace continues
+BX_CPP_INLINE void BX_CPP_AttrRegparmN(1) BX_CPU_C::call_near_rel16(bxInstruction_c *i)
 {
 #if BX_DEBUGGER
   BX_CPU_THIS_PTR show_flag |= Flag_call;
@@ -232,10 +233,26 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jw(bxInstruction_c *i)
   RSP_COMMIT;
 
   BX_INSTR_UCNEAR_BRANCH(BX_CPU_ID, BX_INSTR_IS_CALL, PREV_RIP, EIP);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jw(bxInstruction_c *i)
+{
+  call_near_rel16(i);
 
   BX_LINK_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+// Superblock version: the trace builder appended instructions from the
+// branch target, continue with them instead of linking to another trace
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jw_Superblock(bxInstruction_c *i)
+{
+  call_near_rel16(i);
+
+  BX_NEXT_INSTR(i);
+}
+#endif
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL16_Ap(bxInstruction_c *i)
 {
   BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
@@ -282,15 +299,30 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL16_Ep(bxInstruction_c *i)
   BX_NEXT_TRACE(i);
 }
 
-BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jw(bxInstruction_c *i)
+// JMP_Jw and JMP_Jw_Superblock only differ in the way the trace continues
+BX_CPP_INLINE void BX_CPP_AttrRegparmN(1) BX_CPU_C::jmp_near_rel16(bxInstruction_c *i)
 {
   Bit16u new_IP = IP + i->Iw();
   branch_near16(new_IP);
   BX_INSTR_UCNEAR_BRANCH(BX_CPU_ID, BX_INSTR_IS_JMP, PREV_RIP, new_IP);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jw(bxInstruction_c *i)
+{
+  jmp_near_rel16(i);
 
   BX_LINK_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jw_Superblock(bxInstruction_c *i)
+{
+  jmp_near_rel16(i);
+
+  BX_NEXT_INSTR(i); // trace continues at the branch target
+}
+#endif
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JO_Jw(bxInstruction_c *i)
 {
   if (get_OF()) {
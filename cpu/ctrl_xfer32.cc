@@ -212,7 +212,8 @@ done:
   BX_NEXT_TRACE(i);
 }
 
-BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jd(bxInstruction_c *i)
+// CALL_Jd and CALL_Jd_Superblock only differ in the way the trace continues
+BX_CPP_INLINE void BX_CPP_AttrRegparmN(1) BX_CPU_C::call_near_rel32(bxInstruction_c *i)
 {
 #if BX_DEBUGGER
   BX_CPU_THIS_PTR show_flag |= Flag_call;
@@ -230,10 +231,26 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jd(bxInstruction_c *i)
   RSP_COMMIT;
 
   BX_INSTR_UCNEAR_BRANCH(BX_CPU_ID, BX_INSTR_IS_CALL, PREV_RIP, EIP);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jd(bxInstruction_c *i)
+{
+  call_near_rel32(i);
 
   BX_LINK_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+// Superblock version: the trace builder appended instructions from the
+// branch target, continue with them instead of linking to another trace
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jd_Superblock(bxInstruction_c *i)
+{
+  call_near_rel32(i);
+
+  BX_NEXT_INSTR(i);
+}
+#endif
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL32_Ap(bxInstruction_c *i)
 {
   BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
@@ -280,15 +297,30 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL32_Ep(bxInstruction_c *i)
   BX_NEXT_TRACE(i);
 }
 
-BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jd(bxInstruction_c *i)
+// JMP_Jd and JMP_Jd_Superblock only differ in the way the trace continues
+BX_CPP_INLINE void BX_CPP_AttrRegparmN(1) BX_CPU_C::jmp_near_rel32(bxInstruction_c *i)
 {
   Bit32u new_EIP = EIP + (Bit32s) i->Id();
   branch_near32(new_EIP);
   BX_INSTR_UCNEAR_BRANCH(BX_CPU_ID, BX_INSTR_IS_JMP, PREV_RIP, new_EIP);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jd(bxInstruction_c *i)
+{
+  jmp_near_rel32(i);
 
   BX_LINK_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jd_Superblock(bxInstruction_c *i)
+{
+  jmp_near_rel32(i);
+
+  BX_NEXT_INSTR(i); // trace continues at the branch target
+}
+#endif
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JO_Jd(bxInstruction_c *i)
 {
   if (get_OF()) {
@@ -774,3 +806,56 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::LOOP32_Jb(bxInstruction_c *i)
 }
 
 #endif
+
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Register form CMP/TEST fused with the following Jcc by the trace builder,
+// see BX_CPU_C::fuseCompareAndBranch
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMP_GdEdR_Jd(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  Bit32u op2_32 = BX_READ_32BIT_REG(i->src());
+  Bit32u diff_32 = op1_32 - op2_32;
+
+  SET_FLAGS_OSZAPC_SUB_32(op1_32, op2_32, diff_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, op2_32);
+  BX_NEXT_INSTR_FUSED_JD(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMP_EdIdR_Jd(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  Bit32u op2_32 = i->Id();
+  Bit32u diff_32 = op1_32 - op2_32;
+
+  SET_FLAGS_OSZAPC_SUB_32(op1_32, op2_32, diff_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, op2_32);
+  BX_NEXT_INSTR_FUSED_JD(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EdGdR_Jd(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 &= BX_READ_32BIT_REG(i->src());
+
+  SET_FLAGS_OSZAPC_LOGIC_32(op1_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, 0);
+  BX_NEXT_INSTR_FUSED_JD(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EdIdR_Jd(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 &= i->Id();
+
+  SET_FLAGS_OSZAPC_LOGIC_32(op1_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, 0);
+  BX_NEXT_INSTR_FUSED_JD(i, taken);
+}
+
+#endif
@@ -107,7 +107,8 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::RETfar64_Iw(bxInstruction_c *i)
   BX_NEXT_TRACE(i);
 }
 
-BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jq(bxInstruction_c *i)
+// CALL_Jq and CALL_Jq_Superblock only differ in the way the trace continues
+BX_CPP_INLINE void BX_CPP_AttrRegparmN(1) BX_CPU_C::call_near_rel64(bxInstruction_c *i)
 {
   Bit64u new_RIP = RIP + (Bit32s) i->Id();
 
@@ -127,10 +128,26 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jq(bxInstruction_c *i)
   RSP -= 8;
 
   BX_INSTR_UCNEAR_BRANCH(BX_CPU_ID, BX_INSTR_IS_CALL, PREV_RIP, RIP);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jq(bxInstruction_c *i)
+{
+  call_near_rel64(i);
 
   BX_LINK_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+// Superblock version: the trace builder appended instructions from the
+// branch target, continue with them instead of linking to another trace
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_Jq_Superblock(bxInstruction_c *i)
+{
+  call_near_rel64(i);
+
+  BX_NEXT_INSTR(i);
+}
+#endif
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL_EqR(bxInstruction_c *i)
 {
 #if BX_DEBUGGER
@@ -184,7 +201,8 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CALL64_Ep(bxInstruction_c *i)
   BX_NEXT_TRACE(i);
 }
 
-BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jq(bxInstruction_c *i)
+// JMP_Jq and JMP_Jq_Superblock only differ in the way the trace continues
+BX_CPP_INLINE void BX_CPP_AttrRegparmN(1) BX_CPU_C::jmp_near_rel64(bxInstruction_c *i)
 {
   Bit64u new_RIP = RIP + (Bit32s) i->Id();
 
@@ -196,10 +214,24 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jq(bxInstruction_c *i)
   RIP = new_RIP;
 
   BX_INSTR_UCNEAR_BRANCH(BX_CPU_ID, BX_INSTR_IS_JMP, PREV_RIP, RIP);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jq(bxInstruction_c *i)
+{
+  jmp_near_rel64(i);
 
   BX_LINK_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JMP_Jq_Superblock(bxInstruction_c *i)
+{
+  jmp_near_rel64(i);
+
+  BX_NEXT_INSTR(i); // trace continues at the branch target
+}
+#endif
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::JO_Jq(bxInstruction_c *i)
 {
   if (get_OF()) {
@@ -611,4 +643,103 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::LOOP64_Jb(bxInstruction_c *i)
   BX_NEXT_TRACE(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Register form CMP/TEST fused with the following Jcc by the trace builder,
+// see BX_CPU_C::fuseCompareAndBranch
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMP_GdEdR_Jq(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  Bit32u op2_32 = BX_READ_32BIT_REG(i->src());
+  Bit32u diff_32 = op1_32 - op2_32;
+
+  SET_FLAGS_OSZAPC_SUB_32(op1_32, op2_32, diff_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, op2_32);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMP_EdIdR_Jq(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  Bit32u op2_32 = i->Id();
+  Bit32u diff_32 = op1_32 - op2_32;
+
+  SET_FLAGS_OSZAPC_SUB_32(op1_32, op2_32, diff_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, op2_32);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EdGdR_Jq(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 &= BX_READ_32BIT_REG(i->src());
+
+  SET_FLAGS_OSZAPC_LOGIC_32(op1_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, 0);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EdIdR_Jq(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 &= i->Id();
+
+  SET_FLAGS_OSZAPC_LOGIC_32(op1_32);
+
+  bx_bool taken = jcc_condition32(i->fusedCond(), op1_32, 0);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMP_GqEqR_Jq(bxInstruction_c *i)
+{
+  Bit64u op1_64 = BX_READ_64BIT_REG(i->dst());
+  Bit64u op2_64 = BX_READ_64BIT_REG(i->src());
+  Bit64u diff_64 = op1_64 - op2_64;
+
+  SET_FLAGS_OSZAPC_SUB_64(op1_64, op2_64, diff_64);
+
+  bx_bool taken = jcc_condition64(i->fusedCond(), op1_64, op2_64);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::CMP_EqIdR_Jq(bxInstruction_c *i)
+{
+  Bit64u op1_64 = BX_READ_64BIT_REG(i->dst());
+  Bit64u op2_64 = (Bit32s) i->Id();
+  Bit64u diff_64 = op1_64 - op2_64;
+
+  SET_FLAGS_OSZAPC_SUB_64(op1_64, op2_64, diff_64);
+
+  bx_bool taken = jcc_condition64(i->fusedCond(), op1_64, op2_64);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EqGqR_Jq(bxInstruction_c *i)
+{
+  Bit64u op1_64 = BX_READ_64BIT_REG(i->dst());
+  op1_64 &= BX_READ_64BIT_REG(i->src());
+
+  SET_FLAGS_OSZAPC_LOGIC_64(op1_64);
+
+  bx_bool taken = jcc_condition64(i->fusedCond(), op1_64, 0);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EqIdR_Jq(bxInstruction_c *i)
+{
+  Bit64u op1_64 = BX_READ_64BIT_REG(i->dst());
+  op1_64 &= (Bit32s) i->Id();
+
+  SET_FLAGS_OSZAPC_LOGIC_64(op1_64);
+
+  bx_bool taken = jcc_condition64(i->fusedCond(), op1_64, 0);
+  BX_NEXT_INSTR_FUSED_JQ(i, taken);
+}
+
+#endif
+
 #endif /* if BX_SUPPORT_X86_64 */
@@ -295,6 +295,37 @@ enum {
 #define BX_DISASM_SRC_ORIGIN(desc) (desc & 0xf)
 #define BX_DISASM_SRC_TYPE(desc) (desc >> 4)
 
+// register assigned to the source by legacy (non VEX/EVEX/XOP) decoders,
+// computed at compile time for every opcode from ia_opcodes.def
+enum {
+  BX_SRC_ASSIGN_NONE = 0,   // keep the source as is
+  BX_SRC_ASSIGN_EAX = 1,    // register 0
+  BX_SRC_ASSIGN_NNN = 2,    // modrm.nnn
+  BX_SRC_ASSIGN_RM = 3,     // modrm.rm or BX_TMP_REGISTER for memory form
+  BX_SRC_ASSIGN_VEC_RM = 4, // modrm.rm or BX_VECTOR_TMP_REGISTER for memory form
+  BX_SRC_ASSIGN_INVALID = 7 // source origin not supported by legacy decoders
+};
+
+#if BX_SUPPORT_FPU
+#define BX_SRC_ASSIGN_RM_TYPE(desc) \
+  (BX_DISASM_SRC_TYPE(desc) == BX_VMM_REG ? BX_SRC_ASSIGN_VEC_RM : BX_SRC_ASSIGN_RM)
+#else
+#define BX_SRC_ASSIGN_RM_TYPE(desc) BX_SRC_ASSIGN_RM
+#endif
+
+#define BX_SRC_ASSIGN(desc) \
+  (BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_EAX ? BX_SRC_ASSIGN_EAX : \
+   BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_NNN ? BX_SRC_ASSIGN_NNN : \
+   BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_RM  ? BX_SRC_ASSIGN_RM_TYPE(desc) : \
+   BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_VECTOR_RM ? BX_SRC_ASSIGN_VEC_RM : \
+   BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_NONE ? BX_SRC_ASSIGN_NONE : \
+   BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_IMM  ? BX_SRC_ASSIGN_NONE : \
+   BX_DISASM_SRC_ORIGIN(desc) == BX_SRC_IMPLICIT ? BX_SRC_ASSIGN_NONE : BX_SRC_ASSIGN_INVALID)
+
+// 3 bits for every one of the 4 sources
+#define BX_FORM_SRC_ASSIGN(s1, s2, s3, s4) \
+  (BX_SRC_ASSIGN(s1) | (BX_SRC_ASSIGN(s2) << 3) | (BX_SRC_ASSIGN(s3) << 6) | (BX_SRC_ASSIGN(s4) << 9))
+
 const Bit8u OP_NONE = BX_SRC_NONE;
 
 const Bit8u OP_Eb = BX_FORM_SRC(BX_GPR8, BX_SRC_RM);
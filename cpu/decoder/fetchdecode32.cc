@@ -83,6 +83,18 @@ bxIAOpcodeTable BxOpcodesTable[] = {
 };
 #undef  bx_define_opcode
 
+// source register assignment for legacy decoders, see assign_srcs()
+static const Bit16u BxOpcodeSrcAssign[] = {
+#define bx_define_opcode(a, b, c, d, s1, s2, s3, s4, e) BX_FORM_SRC_ASSIGN(s1, s2, s3, s4),
+#include "ia_opcodes.def"
+};
+#undef  bx_define_opcode
+
+#ifndef BX_STANDALONE_DECODER
+// copy of BxOpcodesTable[].execute2 used by bxInstruction_c::execute2()
+BxExecutePtr_tR BxOpcodeExecute2[BX_IA_LAST];
+#endif
+
 // Some info on the opcodes at {0F A6} and {0F A7}
 //
 // On 386 steps A0-B0:
@@ -1573,45 +1585,27 @@ unsigned evex_displ8_compression(const bxInstruction_c *i, unsigned ia_opcode, u
 
 bx_bool assign_srcs(bxInstruction_c *i, unsigned ia_opcode, unsigned nnn, unsigned rm)
 {
-  for (unsigned n = 0; n <= 3; n++) {
-    unsigned src = (unsigned) BxOpcodesTable[ia_opcode].src[n];
-    unsigned type = BX_DISASM_SRC_TYPE(src);
-    unsigned index = BX_DISASM_SRC_ORIGIN(src);
-    switch(index) {
-    case BX_SRC_NONE:
-    case BX_SRC_IMM:
-    case BX_SRC_IMPLICIT:
-      break;
-    case BX_SRC_EAX:
-      i->setSrcReg(n, 0);
-      break;
-    case BX_SRC_NNN:
-      i->setSrcReg(n, nnn);
-      break;
-    case BX_SRC_RM:
-      if (i->modC0()) {
-        i->setSrcReg(n, rm);
-      }
-      else {
-        unsigned tmpreg = BX_TMP_REGISTER;
-#if BX_SUPPORT_FPU
-        if (type == BX_VMM_REG) tmpreg = BX_VECTOR_TMP_REGISTER;
-#endif
-        i->setSrcReg(n, tmpreg);
-      }
-      break;
-    case BX_SRC_VECTOR_RM:
-      if (i->modC0()) {
-        i->setSrcReg(n, rm);
-      }
-      else {
-        i->setSrcReg(n, BX_VECTOR_TMP_REGISTER);
-      }
-      break;
-    default:
-      BX_FATAL(("assign_srcs: unknown definition %d for src %d", src, n));
-      break;
-    }
+  // register for every BX_SRC_ASSIGN_xxx form, looked up without a switch
+  // on the source definition
+  Bit8u regs[8];
+  regs[BX_SRC_ASSIGN_EAX] = 0;
+  regs[BX_SRC_ASSIGN_NNN] = nnn;
+  if (i->modC0()) {
+    regs[BX_SRC_ASSIGN_RM] = rm;
+    regs[BX_SRC_ASSIGN_VEC_RM] = rm;
+  }
+  else {
+    regs[BX_SRC_ASSIGN_RM] = BX_TMP_REGISTER;
+    regs[BX_SRC_ASSIGN_VEC_RM] = BX_VECTOR_TMP_REGISTER;
+  }
+
+  unsigned assign = BxOpcodeSrcAssign[ia_opcode];
+  for (unsigned n = 0; n <= 3; n++, assign >>= 3) {
+    unsigned form = assign & 0x7;
+    if (form == BX_SRC_ASSIGN_INVALID)
+      BX_FATAL(("assign_srcs: unknown definition %d for src %d", BxOpcodesTable[ia_opcode].src[n], n));
+    regs[BX_SRC_ASSIGN_NONE] = i->getSrcReg(n);
+    i->setSrcReg(n, regs[form]);
   }
 
   return BX_TRUE;
@@ -2772,7 +2766,6 @@ int assignHandler(bxInstruction_c *i, Bit32u fetchModeMask)
 
   if (! i->modC0()) {
     i->execute1 = BxOpcodesTable[ia_opcode].execute1;
-    i->handlers.execute2 = BxOpcodesTable[ia_opcode].execute2;
 
     if (ia_opcode == BX_IA_MOV_Op32_GdEd) {
       if (i->seg() == BX_SEG_REG_SS)
@@ -2785,7 +2778,13 @@ int assignHandler(bxInstruction_c *i, Bit32u fetchModeMask)
   }
   else {
     i->execute1 = BxOpcodesTable[ia_opcode].execute2;
-    i->handlers.execute2 = NULL;
+
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS && BX_ENABLE_TRACE_LINKING
+    // direct branches keep the link to the next trace in place of operands
+    unsigned src_type = BX_DISASM_SRC_TYPE(BxOpcodesTable[ia_opcode].src[0]);
+    if (src_type >= BX_IMM_BrOff16 && src_type <= BX_IMM_BrOff64)
+      i->setNextTrace(NULL, 0);
+#endif
   }
 
   BX_ASSERT(i->execute1);
@@ -2917,6 +2916,9 @@ void BX_CPU_C::init_FetchDecodeTables(void)
     BxOpcodesTable[BX_IA_MOV_RqCR0].opflags |= BX_LOCKABLE;
 #endif
   }
+
+  for (unsigned n=0; n < BX_IA_LAST; n++)
+    BxOpcodeExecute2[n] = BxOpcodesTable[n].execute2;
 }
 
 #endif
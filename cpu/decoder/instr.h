@@ -43,6 +43,12 @@ typedef BX_INSF_TYPE (BX_CPU_C::*BxExecutePtr_tR)(bxInstruction_c *) BX_CPP_Attr
 #endif
 // <TAG-TYPE-EXECUTEPTR-END>
 
+// Second stage execution functions of memory form instructions (called
+// after resolving the modRM address), indexed by ia_opcode. Keeping them
+// here instead of in every decoded instruction saves a method pointer
+// (16 bytes on most 64-bit hosts) per bxInstruction_c.
+extern BxExecutePtr_tR BxOpcodeExecute2[];
+
 #endif
 
 // <TAG-CLASS-INSTRUCTION-START>
@@ -50,17 +56,32 @@ class bxInstruction_c {
 public:
 
 #ifndef BX_STANDALONE_DECODER
-  // Function pointers; a function to resolve the modRM address
-  // given the current state of the CPU and the instruction data,
-  // and a function to execute the instruction after resolving
-  // the memory address (if any).
+  // Function pointer; a function to execute the instruction or for memory
+  // form instructions a function to resolve the modRM address given the
+  // current state of the CPU and the instruction data, which then calls
+  // execute2() to execute the instruction after resolving the memory address.
   BxExecutePtr_tR execute1;
+#endif
+
+#define BX_INSTR_METADATA_DST   0
+#define BX_INSTR_METADATA_SRC1  1
+#define BX_INSTR_METADATA_SRC2  2
+#define BX_INSTR_METADATA_SRC3  3
+#define BX_INSTR_METADATA_SEG   4
+#define BX_INSTR_METADATA_BASE  5
+#define BX_INSTR_METADATA_INDEX 6
+#define BX_INSTR_METADATA_SCALE 7
 
   union {
-    BxExecutePtr_tR execute2;
+    // using 5-bit field for registers (16 regs in 64-bit, RIP, NIL)
+    Bit8u metaData[8];
+
+#ifndef BX_STANDALONE_DECODER
+    // direct branches (the only instructions linking traces) have no
+    // register or memory operands, link to the next trace is kept instead
     bxInstruction_c *next;
-  } handlers;
 #endif
+  };
 
   struct {
     // 15...0 opcode
@@ -80,18 +101,6 @@ public:
     Bit8u metaInfo1;
   } metaInfo;
 
-#define BX_INSTR_METADATA_DST   0
-#define BX_INSTR_METADATA_SRC1  1
-#define BX_INSTR_METADATA_SRC2  2
-#define BX_INSTR_METADATA_SRC3  3
-#define BX_INSTR_METADATA_SEG   4
-#define BX_INSTR_METADATA_BASE  5
-#define BX_INSTR_METADATA_INDEX 6
-#define BX_INSTR_METADATA_SCALE 7
-
-  // using 5-bit field for registers (16 regs in 64-bit, RIP, NIL)
-  Bit8u metaData[8];
-
   union {
     // Form (longest case): [opcode+modrm+sib/displacement32/immediate32]
     struct {
@@ -139,7 +148,7 @@ public:
 
 #ifndef BX_STANDALONE_DECODER
   BX_CPP_INLINE BxExecutePtr_tR execute2(void) const {
-    return handlers.execute2;
+    return BxOpcodeExecute2[getIaOpcode()];
   }
 #endif
 
@@ -382,15 +391,26 @@ public:
 
 #if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS && BX_ENABLE_TRACE_LINKING && !defined(BX_STANDALONE_DECODER)
   BX_CPP_INLINE bxInstruction_c* getNextTrace(Bit32u currTraceLinkTimeStamp) {
-    if (currTraceLinkTimeStamp > modRMForm.Id2) handlers.next = NULL;
-    return handlers.next;
+    if (currTraceLinkTimeStamp > modRMForm.Id2) next = NULL;
+    return next;
   }
   BX_CPP_INLINE void setNextTrace(bxInstruction_c* iptr, Bit32u traceLinkTimeStamp) {
-    handlers.next = iptr;
+    next = iptr;
     modRMForm.Id2 = traceLinkTimeStamp;
   }
 #endif
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS && !defined(BX_STANDALONE_DECODER)
+  // register form CMP/TEST fused with the following Jcc keep the Jcc
+  // condition code in the (unused) second immediate
+  BX_CPP_INLINE unsigned fusedCond() const {
+    return modRMForm.Ib2[0];
+  }
+  BX_CPP_INLINE void setFusedCond(unsigned cond) {
+    modRMForm.Ib2[0] = cond;
+  }
+#endif
+
 };
 // <TAG-CLASS-INSTRUCTION-END>
 
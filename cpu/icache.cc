@@ -39,6 +39,54 @@ extern int fetchDecode64(const Bit8u *fetchPtr, bxInstruction_c *i, unsigned rem
 #endif
 extern int assignHandler(bxInstruction_c *i, Bit32u fetchModeMask);
 
+bxICache_c::~bxICache_c()
+{
+  delete [] entry;
+  delete [] lruOrder;
+  delete [] mpool;
+}
+
+void bxICache_c::init(unsigned entries)
+{
+  // handleSMC() expects all the traces from single 4K page to map to
+  // different sets
+  unsigned sets = 4096;
+  while (sets * BX_ICACHE_WAYS * 2 <= entries) sets <<= 1;
+
+  delete [] entry;
+  delete [] lruOrder;
+  delete [] mpool;
+
+  numSets = sets;
+  entry = new bxICacheEntry_c[numSets * BX_ICACHE_WAYS];
+  lruOrder = new Bit8u[numSets];
+
+  mpoolSize = numSets * BX_ICACHE_WAYS * (BxICacheMemPool / BxICacheEntries);
+  mpoolGenerationSize = mpoolSize / BX_ICACHE_MPOOL_GENERATIONS;
+  mpool = new bxInstruction_c[mpoolSize];
+
+  flushICacheEntries();
+}
+
+// Reclaim the next generation of the trace cache memory pool instead of
+// flushing the whole trace cache when the memory pool is exhausted.
+void bxICache_c::nextMemPoolGeneration(void)
+{
+  // traces from other generations might be linked into reclaimed traces
+  if (breakLinks()) return;
+
+  mpoolGeneration = (mpoolGeneration + 1) & (BX_ICACHE_MPOOL_GENERATIONS-1);
+  mpindex = mpoolGeneration * mpoolGenerationSize;
+
+  bxInstruction_c *start = &mpool[mpindex], *end = start + mpoolGenerationSize;
+
+  bxICacheEntry_c* e = entry;
+  for (unsigned n=0; n < numSets*BX_ICACHE_WAYS; n++, e++) {
+    if (e->pAddr != BX_ICACHE_INVALID_PHY_ADDRESS && e->i >= start && e->i < end)
+      e->pAddr = BX_ICACHE_INVALID_PHY_ADDRESS;
+  }
+}
+
 void flushICaches(void)
 {
   for (unsigned i=0; i<BX_SMP_PROCESSORS; i++) {
@@ -78,6 +126,9 @@ void genDummyICacheEntry(bxInstruction_c *i)
 bxICacheEntry_c* BX_CPU_C::serveICacheMiss(Bit32u eipBiased, bx_phy_address pAddr)
 {
   bxICacheEntry_c *entry = BX_CPU_THIS_PTR iCache.get_entry(pAddr, BX_CPU_THIS_PTR fetchModeMask);
+  if (entry->pAddr != BX_ICACHE_INVALID_PHY_ADDRESS) {
+    INC_ICACHE_STAT(iCacheEvictions);
+  }
 
   BX_CPU_THIS_PTR iCache.alloc_trace(entry);
 
@@ -164,15 +215,36 @@ bxICacheEntry_c* BX_CPU_C::serveICacheMiss(Bit32u eipBiased, bx_phy_address pAdd
 
     // continue to the next instruction
     remainingInPage -= iLen;
-    if (ret != 0 /* stop trace indication */ || remainingInPage == 0) break;
-    pAddr += iLen;
-    pageOffset += iLen;
-    fetchPtr += iLen;
+    eipBiased += iLen;
+    if (ret != 0 /* stop trace indication */) {
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+      // build superblock: follow unconditional direct jump or call when
+      // the branch target is in the same page
+      if ((n+1) >= quantum || ! followSuperblockBranch(i-1, &eipBiased)) break;
+      INC_ICACHE_STAT(iCacheSuperblockBranches);
+      remainingInPage = BX_CPU_THIS_PTR eipPageWindowSize - eipBiased;
+      pAddr = BX_CPU_THIS_PTR pAddrFetchPage + eipBiased;
+      pageOffset = PAGE_OFFSET((Bit32u) pAddr);
+      fetchPtr = BX_CPU_THIS_PTR eipFetchPtr + eipBiased;
+#else
+      break;
+#endif
+    }
+    else {
+      if (remainingInPage == 0) break;
+      pAddr += iLen;
+      pageOffset += iLen;
+      fetchPtr += iLen;
+    }
 
     // try to find a trace starting from current pAddr and merge
     if (remainingInPage >= 15) { // avoid merging with page split trace
       if (mergeTraces(entry, i, pAddr)) {
           entry->traceMask |= traceMask;
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+          eliminateDeadFlags(entry);
+          fuseCompareAndBranch(entry);
+#endif
           pageWriteStampTable.markICacheMask(pAddr, entry->traceMask);
           BX_CPU_THIS_PTR iCache.commit_trace(entry->tlen);
           return entry;
@@ -189,6 +261,9 @@ bxICacheEntry_c* BX_CPU_C::serveICacheMiss(Bit32u eipBiased, bx_phy_address pAdd
 #if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
   entry->tlen++; /* Add the inserted end of trace opcode */
   genDummyICacheEntry(i);
+
+  eliminateDeadFlags(entry);
+  fuseCompareAndBranch(entry);
 #endif
 
   BX_CPU_THIS_PTR iCache.commit_trace(entry->tlen);
@@ -196,10 +271,321 @@ bxICacheEntry_c* BX_CPU_C::serveICacheMiss(Bit32u eipBiased, bx_phy_address pAdd
   return entry;
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Check if the trace could continue at the target of unconditional direct
+// jump or call. Only targets inside of the current fetch page window are
+// followed, this way SMC detection of the trace is still covered by the
+// trace mask of a single page and the trace doesn't depend on translation
+// of another linear page. On success switch the branch to the handler
+// which doesn't end the trace and update eipBiased to the branch target.
+bx_bool BX_CPU_C::followSuperblockBranch(bxInstruction_c *i, Bit32u *eipBiased)
+{
+  // EIP of the next instruction
+  bx_address eip = (bx_address)(*eipBiased) - BX_CPU_THIS_PTR eipPageBias;
+  bx_address target;
+  BxExecutePtr_tR execute;
+
+  switch(i->getIaOpcode()) {
+  case BX_IA_JMP_Jw:
+    target = (Bit16u)(eip + i->Iw());
+    execute = &BX_CPU_C::JMP_Jw_Superblock;
+    break;
+  case BX_IA_CALL_Jw:
+    target = (Bit16u)(eip + i->Iw());
+    execute = &BX_CPU_C::CALL_Jw_Superblock;
+    break;
+  case BX_IA_JMP_Jd:
+    target = (Bit32u)(eip + (Bit32s) i->Id());
+    execute = &BX_CPU_C::JMP_Jd_Superblock;
+    break;
+  case BX_IA_CALL_Jd:
+    target = (Bit32u)(eip + (Bit32s) i->Id());
+    execute = &BX_CPU_C::CALL_Jd_Superblock;
+    break;
+#if BX_SUPPORT_X86_64
+  case BX_IA_JMP_Jq:
+    target = eip + (Bit32s) i->Id();
+    execute = &BX_CPU_C::JMP_Jq_Superblock;
+    break;
+  case BX_IA_CALL_Jq:
+    target = eip + (Bit32s) i->Id();
+    execute = &BX_CPU_C::CALL_Jq_Superblock;
+    break;
+#endif
+  default:
+    return 0;
+  }
+
+  // the fetch window is already limited by the CS segment limit
+  bx_address targetBiased = target + BX_CPU_THIS_PTR eipPageBias;
+  if (targetBiased >= BX_CPU_THIS_PTR eipPageWindowSize)
+    return 0;
+
+  i->execute1 = execute;
+  *eipBiased = (Bit32u) targetBiased;
+  return 1;
+}
+
+#endif
+
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Register forms of the instructions which overwrite all arithmetic flags
+// without reading any of them and cannot fault
+static bx_bool writesAllFlags(const bxInstruction_c *i)
+{
+  if (! i->modC0()) return 0;
+
+  switch(i->getIaOpcode()) {
+  case BX_IA_ADD_EbGb: case BX_IA_ADD_GbEb: case BX_IA_ADD_ALIb:
+  case BX_IA_ADD_EbIb: case BX_IA_OR_EbGb: case BX_IA_OR_GbEb:
+  case BX_IA_OR_ALIb: case BX_IA_OR_EbIb: case BX_IA_AND_EbGb:
+  case BX_IA_AND_GbEb: case BX_IA_AND_ALIb: case BX_IA_AND_EbIb:
+  case BX_IA_SUB_EbGb: case BX_IA_SUB_GbEb: case BX_IA_SUB_ALIb:
+  case BX_IA_SUB_EbIb: case BX_IA_XOR_EbGb: case BX_IA_XOR_GbEb:
+  case BX_IA_XOR_ALIb: case BX_IA_XOR_EbIb: case BX_IA_CMP_EbGb:
+  case BX_IA_CMP_GbEb: case BX_IA_CMP_ALIb: case BX_IA_CMP_EbIb:
+  case BX_IA_TEST_EbGb: case BX_IA_TEST_ALIb: case BX_IA_TEST_EbIb:
+  case BX_IA_NEG_Eb:
+  case BX_IA_ADD_EwGw: case BX_IA_ADD_GwEw: case BX_IA_ADD_AXIw:
+  case BX_IA_ADD_EwIw: case BX_IA_OR_EwGw: case BX_IA_OR_GwEw:
+  case BX_IA_OR_AXIw: case BX_IA_OR_EwIw: case BX_IA_AND_EwGw:
+  case BX_IA_AND_GwEw: case BX_IA_AND_AXIw: case BX_IA_AND_EwIw:
+  case BX_IA_SUB_EwGw: case BX_IA_SUB_GwEw: case BX_IA_SUB_AXIw:
+  case BX_IA_SUB_EwIw: case BX_IA_XOR_EwGw: case BX_IA_XOR_GwEw:
+  case BX_IA_XOR_AXIw: case BX_IA_XOR_EwIw: case BX_IA_CMP_EwGw:
+  case BX_IA_CMP_GwEw: case BX_IA_CMP_AXIw: case BX_IA_CMP_EwIw:
+  case BX_IA_TEST_EwGw: case BX_IA_TEST_AXIw: case BX_IA_TEST_EwIw:
+  case BX_IA_NEG_Ew:
+  case BX_IA_ADD_EdGd: case BX_IA_ADD_GdEd: case BX_IA_ADD_EAXId:
+  case BX_IA_ADD_EdId: case BX_IA_OR_EdGd: case BX_IA_OR_GdEd:
+  case BX_IA_OR_EAXId: case BX_IA_OR_EdId: case BX_IA_AND_EdGd:
+  case BX_IA_AND_GdEd: case BX_IA_AND_EAXId: case BX_IA_AND_EdId:
+  case BX_IA_SUB_EdGd: case BX_IA_SUB_GdEd: case BX_IA_SUB_EAXId:
+  case BX_IA_SUB_EdId: case BX_IA_XOR_EdGd: case BX_IA_XOR_GdEd:
+  case BX_IA_XOR_EAXId: case BX_IA_XOR_EdId: case BX_IA_CMP_EdGd:
+  case BX_IA_CMP_GdEd: case BX_IA_CMP_EAXId: case BX_IA_CMP_EdId:
+  case BX_IA_TEST_EdGd: case BX_IA_TEST_EAXId: case BX_IA_TEST_EdId:
+  case BX_IA_NEG_Ed:
+#if BX_SUPPORT_X86_64
+  case BX_IA_ADD_EqGq: case BX_IA_ADD_GqEq: case BX_IA_ADD_RAXId:
+  case BX_IA_ADD_EqId: case BX_IA_OR_EqGq: case BX_IA_OR_GqEq:
+  case BX_IA_OR_RAXId: case BX_IA_OR_EqId: case BX_IA_AND_EqGq:
+  case BX_IA_AND_GqEq: case BX_IA_AND_RAXId: case BX_IA_AND_EqId:
+  case BX_IA_SUB_EqGq: case BX_IA_SUB_GqEq: case BX_IA_SUB_RAXId:
+  case BX_IA_SUB_EqId: case BX_IA_XOR_EqGq: case BX_IA_XOR_GqEq:
+  case BX_IA_XOR_RAXId: case BX_IA_XOR_EqId: case BX_IA_CMP_EqGq:
+  case BX_IA_CMP_GqEq: case BX_IA_CMP_RAXId: case BX_IA_CMP_EqId:
+  case BX_IA_TEST_EqGq: case BX_IA_TEST_RAXId: case BX_IA_TEST_EqId:
+  case BX_IA_NEG_Eq:
+#endif
+    return 1;
+
+  default:
+    return 0;
+  }
+}
+
+// Flags liveness pass over a complete trace: an instruction followed by one
+// which overwrites all arithmetic flags gets the handler which computes its
+// own flags only when the trace is interrupted between the two. Flags stay
+// precise for interrupts and for faults because the next instruction cannot
+// fault and is always executed right after unless async_event is set.
+void BX_CPU_C::eliminateDeadFlags(bxICacheEntry_c *entry)
+{
+#if BX_INSTRUMENTATION == 0
+  bxInstruction_c *i = entry->i;
+
+  for (unsigned n=1; n < entry->tlen; n++, i++) {
+    if (! i->modC0() || ! writesAllFlags(i+1)) continue;
+
+    switch(i->getIaOpcode()) {
+    case BX_IA_ADD_EdGd: case BX_IA_ADD_GdEd:
+      i->execute1 = &BX_CPU_C::ADD_GdEdR_DeadFlags;
+      break;
+    case BX_IA_ADD_EAXId: case BX_IA_ADD_EdId:
+      i->execute1 = &BX_CPU_C::ADD_EdIdR_DeadFlags;
+      break;
+    case BX_IA_SUB_EdGd: case BX_IA_SUB_GdEd:
+      i->execute1 = &BX_CPU_C::SUB_GdEdR_DeadFlags;
+      break;
+    case BX_IA_SUB_EAXId: case BX_IA_SUB_EdId:
+      i->execute1 = &BX_CPU_C::SUB_EdIdR_DeadFlags;
+      break;
+    case BX_IA_AND_EdGd: case BX_IA_AND_GdEd:
+      i->execute1 = &BX_CPU_C::AND_GdEdR_DeadFlags;
+      break;
+    case BX_IA_AND_EAXId: case BX_IA_AND_EdId:
+      i->execute1 = &BX_CPU_C::AND_EdIdR_DeadFlags;
+      break;
+    case BX_IA_OR_EdGd: case BX_IA_OR_GdEd:
+      i->execute1 = &BX_CPU_C::OR_GdEdR_DeadFlags;
+      break;
+    case BX_IA_OR_EAXId: case BX_IA_OR_EdId:
+      i->execute1 = &BX_CPU_C::OR_EdIdR_DeadFlags;
+      break;
+    case BX_IA_XOR_EdGd: case BX_IA_XOR_GdEd:
+      i->execute1 = &BX_CPU_C::XOR_GdEdR_DeadFlags;
+      break;
+    case BX_IA_XOR_EAXId: case BX_IA_XOR_EdId:
+      i->execute1 = &BX_CPU_C::XOR_EdIdR_DeadFlags;
+      break;
+    case BX_IA_INC_Ed:
+      i->execute1 = &BX_CPU_C::INC_EdR_DeadFlags;
+      break;
+    case BX_IA_DEC_Ed:
+      i->execute1 = &BX_CPU_C::DEC_EdR_DeadFlags;
+      break;
+#if BX_SUPPORT_X86_64
+    case BX_IA_ADD_EqGq: case BX_IA_ADD_GqEq:
+      i->execute1 = &BX_CPU_C::ADD_GqEqR_DeadFlags;
+      break;
+    case BX_IA_ADD_RAXId: case BX_IA_ADD_EqId:
+      i->execute1 = &BX_CPU_C::ADD_EqIdR_DeadFlags;
+      break;
+    case BX_IA_SUB_EqGq: case BX_IA_SUB_GqEq:
+      i->execute1 = &BX_CPU_C::SUB_GqEqR_DeadFlags;
+      break;
+    case BX_IA_SUB_RAXId: case BX_IA_SUB_EqId:
+      i->execute1 = &BX_CPU_C::SUB_EqIdR_DeadFlags;
+      break;
+    case BX_IA_AND_EqGq: case BX_IA_AND_GqEq:
+      i->execute1 = &BX_CPU_C::AND_GqEqR_DeadFlags;
+      break;
+    case BX_IA_AND_RAXId: case BX_IA_AND_EqId:
+      i->execute1 = &BX_CPU_C::AND_EqIdR_DeadFlags;
+      break;
+    case BX_IA_OR_EqGq: case BX_IA_OR_GqEq:
+      i->execute1 = &BX_CPU_C::OR_GqEqR_DeadFlags;
+      break;
+    case BX_IA_OR_RAXId: case BX_IA_OR_EqId:
+      i->execute1 = &BX_CPU_C::OR_EqIdR_DeadFlags;
+      break;
+    case BX_IA_XOR_EqGq: case BX_IA_XOR_GqEq:
+      i->execute1 = &BX_CPU_C::XOR_GqEqR_DeadFlags;
+      break;
+    case BX_IA_XOR_RAXId: case BX_IA_XOR_EqId:
+      i->execute1 = &BX_CPU_C::XOR_EqIdR_DeadFlags;
+      break;
+    case BX_IA_INC_Eq:
+      i->execute1 = &BX_CPU_C::INC_EqR_DeadFlags;
+      break;
+    case BX_IA_DEC_Eq:
+      i->execute1 = &BX_CPU_C::DEC_EqR_DeadFlags;
+      break;
+#endif
+    default:
+      break;
+    }
+  }
+#endif
+}
+
+// Condition code (low nibble of the opcode) of a near Jcc which can be
+// fused with the preceding compare or -1 for any other instruction
+static int fusableJccCondition(const bxInstruction_c *i, bx_bool *jq)
+{
+  *jq = 0;
+
+  switch(i->getIaOpcode()) {
+  case BX_IA_JO_Jd:   return 0x0;
+  case BX_IA_JNO_Jd:  return 0x1;
+  case BX_IA_JB_Jd:   return 0x2;
+  case BX_IA_JNB_Jd:  return 0x3;
+  case BX_IA_JZ_Jd:   return 0x4;
+  case BX_IA_JNZ_Jd:  return 0x5;
+  case BX_IA_JBE_Jd:  return 0x6;
+  case BX_IA_JNBE_Jd: return 0x7;
+  case BX_IA_JS_Jd:   return 0x8;
+  case BX_IA_JNS_Jd:  return 0x9;
+  case BX_IA_JP_Jd:   return 0xA;
+  case BX_IA_JNP_Jd:  return 0xB;
+  case BX_IA_JL_Jd:   return 0xC;
+  case BX_IA_JNL_Jd:  return 0xD;
+  case BX_IA_JLE_Jd:  return 0xE;
+  case BX_IA_JNLE_Jd: return 0xF;
+#if BX_SUPPORT_X86_64
+  case BX_IA_JO_Jq: case BX_IA_JNO_Jq: case BX_IA_JB_Jq: case BX_IA_JNB_Jq:
+  case BX_IA_JZ_Jq: case BX_IA_JNZ_Jq: case BX_IA_JBE_Jq: case BX_IA_JNBE_Jq:
+  case BX_IA_JS_Jq: case BX_IA_JNS_Jq: case BX_IA_JP_Jq: case BX_IA_JNP_Jq:
+  case BX_IA_JL_Jq: case BX_IA_JNL_Jq: case BX_IA_JLE_Jq: case BX_IA_JNLE_Jq:
+    // Jq opcodes are defined in condition code order
+    *jq = 1;
+    return i->getIaOpcode() - BX_IA_JO_Jq;
+#endif
+  default:
+    return -1;
+  }
+}
+
+// Macro-op fusion of a register form CMP or TEST with the Jcc following it
+// in the trace: the compare gets a handler which evaluates the branch
+// condition from its operands and executes the Jcc itself, saving one
+// handler dispatch and the lazy flags evaluation. Runs after the flags
+// liveness pass as a CMP or TEST never gets a _DeadFlags handler.
+void BX_CPU_C::fuseCompareAndBranch(bxICacheEntry_c *entry)
+{
+#if BX_INSTRUMENTATION == 0
+  bxInstruction_c *i = entry->i;
+
+  for (unsigned n=1; n < entry->tlen; n++, i++) {
+    if (! i->modC0()) continue;
+
+    bx_bool jq;
+    int cond = fusableJccCondition(i+1, &jq);
+    if (cond < 0) continue;
+
+    BxExecutePtr_tR execute = NULL;
+
+    switch(i->getIaOpcode()) {
+    case BX_IA_CMP_EdGd: case BX_IA_CMP_GdEd:
+      execute = jq ? &BX_CPU_C::CMP_GdEdR_Jq : &BX_CPU_C::CMP_GdEdR_Jd;
+      break;
+    case BX_IA_CMP_EAXId: case BX_IA_CMP_EdId:
+      execute = jq ? &BX_CPU_C::CMP_EdIdR_Jq : &BX_CPU_C::CMP_EdIdR_Jd;
+      break;
+    case BX_IA_TEST_EdGd:
+      execute = jq ? &BX_CPU_C::TEST_EdGdR_Jq : &BX_CPU_C::TEST_EdGdR_Jd;
+      break;
+    case BX_IA_TEST_EAXId: case BX_IA_TEST_EdId:
+      execute = jq ? &BX_CPU_C::TEST_EdIdR_Jq : &BX_CPU_C::TEST_EdIdR_Jd;
+      break;
+#if BX_SUPPORT_X86_64
+    case BX_IA_CMP_EqGq: case BX_IA_CMP_GqEq:
+      execute = &BX_CPU_C::CMP_GqEqR_Jq;
+      break;
+    case BX_IA_CMP_RAXId: case BX_IA_CMP_EqId:
+      execute = &BX_CPU_C::CMP_EqIdR_Jq;
+      break;
+    case BX_IA_TEST_EqGq:
+      execute = &BX_CPU_C::TEST_EqGqR_Jq;
+      break;
+    case BX_IA_TEST_RAXId: case BX_IA_TEST_EqId:
+      execute = &BX_CPU_C::TEST_EqIdR_Jq;
+      break;
+#endif
+    default:
+      break;
+    }
+
+    if (execute) {
+      i->setFusedCond(cond);
+      i->execute1 = execute;
+    }
+  }
+#endif
+}
+
+#endif // BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
 bx_bool BX_CPU_C::mergeTraces(bxICacheEntry_c *entry, bxInstruction_c *i, bx_phy_address pAddr)
 {
   bxICacheEntry_c *e = BX_CPU_THIS_PTR iCache.find_entry(pAddr, BX_CPU_THIS_PTR fetchModeMask);
 
+  // superblock branch back to the start of the trace which is being built
+  if (e == entry) return 0;
+
   if (e != NULL)
   {
     // determine max amount of instruction to take from another entry
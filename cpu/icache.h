@@ -101,8 +101,13 @@ BX_CPP_INLINE void bxPageWriteStampTable::resetWriteStamps(void)
 
 extern bxPageWriteStampTable pageWriteStampTable;
 
-#define BxICacheEntries (64  * 1024)  // Must be a power of 2.
-#define BxICacheMemPool (576 * 1024)
+#define BxICacheEntries (64  * 1024)  // Default, must be a power of 2.
+#define BxICacheMemPool (576 * 1024)  // Default, 9 instructions per entry.
+
+// Trace cache is 4-way set associative with true LRU replacement in every set
+#define BX_ICACHE_WAYS 4
+// Trace cache memory pool is reclaimed one generation at a time
+#define BX_ICACHE_MPOOL_GENERATIONS 8 /* must be power of two */
 
 struct bxICacheEntry_c
 {
@@ -132,10 +137,16 @@ BX_CPP_INLINE void flushSMC(bxICacheEntry_c *e)
 
 class BOCHSAPI bxICache_c {
 public:
-  bxICacheEntry_c entry[BxICacheEntries];
-  bxInstruction_c mpool[BxICacheMemPool];
+  bxICacheEntry_c *entry;   // BX_ICACHE_WAYS entries per set
+  Bit8u *lruOrder;          // per set LRU order, 2 bits per way, MRU first
+  bxInstruction_c *mpool;
   unsigned mpindex;
 
+  unsigned numSets;         // must be a power of 2
+  unsigned mpoolSize;
+  unsigned mpoolGenerationSize;
+  unsigned mpoolGeneration; // generation mpindex is allocating from
+
   Bit32u traceLinkTimeStamp;
 
 #define BX_ICACHE_PAGE_SPLIT_ENTRIES 8 /* must be power of two */
@@ -146,19 +157,35 @@ public:
   int nextPageSplitIndex;
 
 public:
-  bxICache_c() { flushICacheEntries(); }
+  bxICache_c(): entry(NULL), lruOrder(NULL), mpool(NULL), numSets(0), mpoolSize(0) {}
+ ~bxICache_c();
+
+  void init(unsigned entries);
 
-  BX_CPP_INLINE static unsigned hash(bx_phy_address pAddr, unsigned fetchModeMask)
+  BX_CPP_INLINE unsigned hash(bx_phy_address pAddr, unsigned fetchModeMask) const
   {
-//  return ((pAddr + (pAddr << 2) + (pAddr>>6)) & (BxICacheEntries-1)) ^ fetchModeMask;
-    return ((pAddr) & (BxICacheEntries-1)) ^ fetchModeMask;
+//  return ((pAddr + (pAddr << 2) + (pAddr>>6)) & (numSets-1)) ^ fetchModeMask;
+    return ((pAddr) & (numSets-1)) ^ fetchModeMask;
+  }
+
+  // move way to the MRU position of the set LRU order
+  BX_CPP_INLINE static Bit8u lruTouch(Bit8u order, unsigned way)
+  {
+    if ((order & 0x3) == way) return order;
+
+    unsigned shift = 2;
+    while (((order >> shift) & 0x3) != way) shift += 2;
+
+    Bit32u above = order & ((1 << shift) - 1);
+    Bit32u below = (order >> (shift + 2)) << (shift + 2);
+    return (Bit8u)(below | (above << 2) | way);
   }
 
   BX_CPP_INLINE void alloc_trace(bxICacheEntry_c *e)
   {
     // took +1 garbend for instruction chaining speedup (end-of-trace opcode)
-    if ((mpindex + BX_MAX_TRACE_LENGTH + 1) > BxICacheMemPool) {
-      flushICacheEntries();
+    if ((mpindex + BX_MAX_TRACE_LENGTH + 1) > mpoolGenerationSize * (mpoolGeneration+1)) {
+      nextMemPoolGeneration();
     }
     e->i = &mpool[mpindex];
     e->tlen = 0;
@@ -180,22 +207,42 @@ public:
     nextPageSplitIndex = (nextPageSplitIndex+1) & (BX_ICACHE_PAGE_SPLIT_ENTRIES-1);
   }
 
+  void nextMemPoolGeneration(void);
+
   BX_CPP_INLINE void handleSMC(bx_phy_address pAddr, Bit32u mask);
 
   BX_CPP_INLINE void flushICacheEntries(void);
 
+  // select entry for a new trace: an invalid way if any, otherwise the LRU way
   BX_CPP_INLINE bxICacheEntry_c* get_entry(bx_phy_address pAddr, unsigned fetchModeMask)
   {
-    return &(entry[hash(pAddr, fetchModeMask)]);
+    unsigned set = hash(pAddr, fetchModeMask);
+    bxICacheEntry_c *e = &entry[set * BX_ICACHE_WAYS];
+    unsigned way;
+
+    for (way=0; way < BX_ICACHE_WAYS; way++) {
+      if (e[way].pAddr == BX_ICACHE_INVALID_PHY_ADDRESS) break;
+    }
+    if (way == BX_ICACHE_WAYS)
+      way = lruOrder[set] >> 6;
+
+    lruOrder[set] = lruTouch(lruOrder[set], way);
+    return &e[way];
   }
 
   BX_CPP_INLINE bxICacheEntry_c* find_entry(bx_phy_address pAddr, unsigned fetchModeMask)
   {
-    bxICacheEntry_c* e = get_entry(pAddr, fetchModeMask);
-    if (e->pAddr != pAddr)
-       return NULL;
+    unsigned set = hash(pAddr, fetchModeMask);
+    bxICacheEntry_c *e = &entry[set * BX_ICACHE_WAYS];
 
-    return e;
+    for (unsigned way=0; way < BX_ICACHE_WAYS; way++) {
+      if (e[way].pAddr == pAddr) {
+        lruOrder[set] = lruTouch(lruOrder[set], way);
+        return &e[way];
+      }
+    }
+
+    return NULL;
   }
 
   BX_CPP_INLINE bx_bool breakLinks()
@@ -214,16 +261,20 @@ BX_CPP_INLINE void bxICache_c::flushICacheEntries(void)
   bxICacheEntry_c* e = entry;
   unsigned i;
 
-  for (i=0; i<BxICacheEntries; i++, e++) {
+  for (i=0; i<numSets*BX_ICACHE_WAYS; i++, e++) {
     e->pAddr = BX_ICACHE_INVALID_PHY_ADDRESS;
     e->traceMask = 0;
   }
 
+  for (i=0; i<numSets; i++)
+    lruOrder[i] = 0xE4; /* ways 0,1,2,3 in MRU to LRU order */
+
   nextPageSplitIndex = 0;
   for (i=0;i<BX_ICACHE_PAGE_SPLIT_ENTRIES;i++)
     pageSplitIndex[i].ppf = BX_ICACHE_INVALID_PHY_ADDRESS;
 
   mpindex = 0;
+  mpoolGeneration = 0;
 
   traceLinkTimeStamp = 0;
 }
@@ -258,13 +309,13 @@ BX_CPP_INLINE void bxICache_c::handleSMC(bx_phy_address pAddr, Bit32u mask)
     }
   }
 
-  bxICacheEntry_c *e = get_entry(LPFOf(pAddr), 0);
+  bxICacheEntry_c *e = &entry[hash(LPFOf(pAddr), 0) * BX_ICACHE_WAYS];
 
   // go over 32 "cache lines" of 128 byte each
   for (unsigned n=0; n < 32; n++) {
     Bit32u line_mask = (1 << n);
     if (line_mask > mask) break;
-    for (unsigned index=0; index < 128; index++, e++) {
+    for (unsigned index=0; index < 128*BX_ICACHE_WAYS; index++, e++) {
       if (pAddrIndex == bxPageWriteStampTable::hash(e->pAddr) && (e->traceMask & mask) != 0) {
         flushSMC(e);
       }
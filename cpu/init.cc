@@ -114,6 +114,12 @@ void BX_CPU_C::initialize(void)
 
   init_FetchDecodeTables(); // must be called after init_isa_features_bitmask()
 
+  BX_CPU_THIS_PTR iCache.init(SIM->get_param_num(BXPN_ICACHE_SIZE)->get() * 1024);
+
+  // the CPU object might be heap allocated, start the second level TLB
+  // with invalid entries and a defined replacement state
+  TLB_L2_flush(0);
+
 #if BX_CONFIGURE_MSRS
   for (unsigned n=0; n < BX_MSR_MAX_INDEX; n++) {
     BX_CPU_THIS_PTR msrs[n] = 0;
@@ -148,6 +154,8 @@ void BX_CPU_C::init_statistics(void)
   new bx_shadow_num_c(cpu, "iCacheLookups", &stats->iCacheLookups);
   new bx_shadow_num_c(cpu, "iCachePrefetch", &stats->iCachePrefetch);
   new bx_shadow_num_c(cpu, "iCacheMisses", &stats->iCacheMisses);
+  new bx_shadow_num_c(cpu, "iCacheEvictions", &stats->iCacheEvictions);
+  new bx_shadow_num_c(cpu, "iCacheSuperblockBranches", &stats->iCacheSuperblockBranches);
 #endif
 
 #if InstrumentTLB
@@ -157,11 +165,13 @@ void BX_CPU_C::init_statistics(void)
   new bx_shadow_num_c(cpu, "tlbMisses", &stats->tlbMisses);
   new bx_shadow_num_c(cpu, "tlbExecuteMisses", &stats->tlbExecuteMisses);
   new bx_shadow_num_c(cpu, "tlbWriteMisses", &stats->tlbWriteMisses);
+  new bx_shadow_num_c(cpu, "tlbL2Misses", &stats->tlbL2Misses);
 #endif
 
 #if InstrumentTLBFlush
   new bx_shadow_num_c(cpu, "tlbGlobalFlushes", &stats->tlbGlobalFlushes);
   new bx_shadow_num_c(cpu, "tlbNonGlobalFlushes", &stats->tlbNonGlobalFlushes);
+  new bx_shadow_num_c(cpu, "tlbPcidFlushes", &stats->tlbPcidFlushes);
 #endif
 
 #if InstrumentStackPrefetch
@@ -307,3 +307,73 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EdIdM(bxInstruction_c *i)
 
   BX_NEXT_INSTR(i);
 }
+
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Versions of the register form handlers selected by the trace builder when
+// the next instruction in the trace overwrites all arithmetic flags
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AND_GdEdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  op2_32 = BX_READ_32BIT_REG(i->src());
+  op1_32 &= op2_32;
+  BX_WRITE_32BIT_REGZ(i->dst(), op1_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_32(op1_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AND_EdIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 &= i->Id();
+  BX_WRITE_32BIT_REGZ(i->dst(), op1_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_32(op1_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::OR_GdEdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  op2_32 = BX_READ_32BIT_REG(i->src());
+  op1_32 |= op2_32;
+  BX_WRITE_32BIT_REGZ(i->dst(), op1_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_32(op1_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::OR_EdIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 |= i->Id();
+  BX_WRITE_32BIT_REGZ(i->dst(), op1_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_32(op1_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::XOR_GdEdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32, op2_32;
+
+  op1_32 = BX_READ_32BIT_REG(i->dst());
+  op2_32 = BX_READ_32BIT_REG(i->src());
+  op1_32 ^= op2_32;
+  BX_WRITE_32BIT_REGZ(i->dst(), op1_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_32(op1_32));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::XOR_EdIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit32u op1_32 = BX_READ_32BIT_REG(i->dst());
+  op1_32 ^= i->Id();
+  BX_WRITE_32BIT_REGZ(i->dst(), op1_32);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_32(op1_32));
+}
+
+#endif
@@ -330,4 +330,83 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::TEST_EqIdM(bxInstruction_c *i)
   BX_NEXT_INSTR(i);
 }
 
+#if BX_SUPPORT_HANDLERS_CHAINING_SPEEDUPS
+
+// Versions of the register form handlers selected by the trace builder when
+// the next instruction in the trace overwrites all arithmetic flags
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AND_GqEqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = BX_READ_64BIT_REG(i->src());
+  op1_64 &= op2_64;
+
+  BX_WRITE_64BIT_REG(i->dst(), op1_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_64(op1_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::AND_EqIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64 = (Bit32s) i->Id();
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op1_64 &= op2_64;
+  BX_WRITE_64BIT_REG(i->dst(), op1_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_64(op1_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::OR_GqEqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = BX_READ_64BIT_REG(i->src());
+  op1_64 |= op2_64;
+
+  BX_WRITE_64BIT_REG(i->dst(), op1_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_64(op1_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::OR_EqIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64 = (Bit32s) i->Id();
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op1_64 |= op2_64;
+  BX_WRITE_64BIT_REG(i->dst(), op1_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_64(op1_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::XOR_GqEqR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64;
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op2_64 = BX_READ_64BIT_REG(i->src());
+  op1_64 ^= op2_64;
+
+  BX_WRITE_64BIT_REG(i->dst(), op1_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_64(op1_64));
+}
+
+BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::XOR_EqIdR_DeadFlags(bxInstruction_c *i)
+{
+  Bit64u op1_64, op2_64 = (Bit32s) i->Id();
+
+  op1_64 = BX_READ_64BIT_REG(i->dst());
+  op1_64 ^= op2_64;
+  BX_WRITE_64BIT_REG(i->dst(), op1_64);
+
+  BX_NEXT_INSTR_DEAD_FLAGS(i, SET_FLAGS_OSZAPC_LOGIC_64(op1_64));
+}
+
+#endif
+
 #endif /* if BX_SUPPORT_X86_64 */
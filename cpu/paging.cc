@@ -351,6 +351,58 @@ static const Bit8u priv_check[BX_PRIV_CHECK_SIZE] =
 
 // ==============================================================
 
+#if BX_SUPPORT_X86_64
+
+// Paging-structure caches
+//
+// A cache entry of level N (1=PDE, 2=PDPTE, 3=PML4E) holds the result of
+// walking the paging structure levels above and including level N for all
+// addresses with the same bits [47:12+9*N]. Page walk hitting the cache
+// continues directly at level N-1. Only entries for successful walks are
+// cached, so the accessed bits of the cached entries are already set.
+
+#define BX_PSC_ATTR_NX (0x80000000)
+
+BX_CPP_INLINE Bit64u PSC_tag(Bit64u addr, unsigned level)
+{
+  return (addr & BX_CONST64(0x0000ffffffffffff)) >> (12 + 9*level);
+}
+
+// Find the deepest cached level for the address, return NULL if none
+static bx_PSC_entry *PSC_lookup(bx_PSC_entry psc[3][BX_PSC_SIZE], Bit64u addr, int &level)
+{
+  for (unsigned n=1; n<=3; n++) {
+    Bit64u tag = PSC_tag(addr, n);
+    bx_PSC_entry *entry = &psc[n-1][tag & (BX_PSC_SIZE-1)];
+    if (entry->tag == tag) {
+      level = n;
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+static void PSC_fill(bx_PSC_entry psc[3][BX_PSC_SIZE], Bit64u addr, unsigned level, bx_phy_address ppf, Bit32u combined_access, Bit32u attr)
+{
+  Bit64u tag = PSC_tag(addr, level);
+  bx_PSC_entry *entry = &psc[level-1][tag & (BX_PSC_SIZE-1)];
+
+  entry->tag = tag;
+  entry->ppf = ppf;
+  entry->combined_access = combined_access;
+  entry->attr = attr;
+}
+
+static void PSC_flush(bx_PSC_entry psc[3][BX_PSC_SIZE])
+{
+  for (unsigned level=0; level<3; level++)
+    for (unsigned n=0; n<BX_PSC_SIZE; n++)
+      psc[level][n].invalidate();
+}
+
+#endif
+
 void BX_CPU_C::TLB_flush(void)
 {
   INC_TLBFLUSH_STAT(tlbGlobalFlushes);
@@ -359,9 +411,20 @@ void BX_CPU_C::TLB_flush(void)
 
   invalidate_stack_cache();
 
-  for (unsigned n=0; n < BX_TLB_SIZE; n++) {
+  unsigned n;
+  for (n=0; n < BX_TLB_SIZE; n++) {
     BX_CPU_THIS_PTR TLB.entry[n].invalidate();
   }
+  for (n=0; n < BX_ITLB_SIZE; n++) {
+    BX_CPU_THIS_PTR ITLB.entry[n].invalidate();
+  }
+
+  TLB_L2_flush(0);
+
+#if BX_SUPPORT_X86_64
+  PSC_flush(BX_CPU_THIS_PTR PSC);
+  PSC_flush(BX_CPU_THIS_PTR PSC_nested);
+#endif
 
 #if BX_CPU_LEVEL >= 5
   BX_CPU_THIS_PTR TLB.split_large = 0;  // flush whole TLB
@@ -382,14 +445,38 @@ void BX_CPU_C::TLB_flushNonGlobal(void)
 {
   INC_TLBFLUSH_STAT(tlbNonGlobalFlushes);
 
+  TLB_flushFirstLevelNonGlobal();
+
+  TLB_L2_flush(1);
+}
+
+#if BX_SUPPORT_X86_64
+// The first level TLBs are not tagged and always lose their non-global
+// entries on address space switch. Second level TLB entries tagged with
+// other PCIDs are kept and entries of the given PCID are invalidated only
+// when requested (MOV to CR3 without no-flush hint, INVPCID).
+void BX_CPU_C::TLB_flushPCID(Bit32u pcid, bx_bool invalidate)
+{
+  INC_TLBFLUSH_STAT(tlbPcidFlushes);
+
+  TLB_flushFirstLevelNonGlobal();
+
+  if (invalidate)
+    TLB_L2_flushPCID(pcid);
+}
+#endif
+
+void BX_CPU_C::TLB_flushFirstLevelNonGlobal(void)
+{
   invalidate_prefetch_q();
 
   invalidate_stack_cache();
 
   BX_CPU_THIS_PTR TLB.split_large = 0;
   Bit32u lpf_mask = 0;
+  unsigned n;
 
-  for (unsigned n=0; n<BX_TLB_SIZE; n++) {
+  for (n=0; n<BX_TLB_SIZE; n++) {
     bx_TLB_entry *tlbEntry = &BX_CPU_THIS_PTR TLB.entry[n];
     if (tlbEntry->valid()) {
       if (!(tlbEntry->accessBits & TLB_GlobalPage)) {
@@ -401,6 +488,23 @@ void BX_CPU_C::TLB_flushNonGlobal(void)
     }
   }
 
+  for (n=0; n<BX_ITLB_SIZE; n++) {
+    bx_TLB_entry *tlbEntry = &BX_CPU_THIS_PTR ITLB.entry[n];
+    if (tlbEntry->valid()) {
+      if (!(tlbEntry->accessBits & TLB_GlobalPage)) {
+        tlbEntry->invalidate();
+      }
+      else {
+        lpf_mask |= tlbEntry->lpf_mask;
+      }
+    }
+  }
+
+  // nested translations are not affected by the guest CR3
+#if BX_SUPPORT_X86_64
+  PSC_flush(BX_CPU_THIS_PTR PSC);
+#endif
+
   if (lpf_mask > 0xfff)
     BX_CPU_THIS_PTR TLB.split_large = 1;
 
@@ -430,8 +534,9 @@ void BX_CPU_C::TLB_invlpg(bx_address laddr)
     BX_CPU_THIS_PTR TLB.split_large = 0;
 
     // make sure INVLPG handles correctly large pages
-    for (unsigned n=0; n<BX_TLB_SIZE; n++) {
-      bx_TLB_entry *tlbEntry = &BX_CPU_THIS_PTR TLB.entry[n];
+    for (unsigned n=0; n<BX_TLB_SIZE+BX_ITLB_SIZE; n++) {
+      bx_TLB_entry *tlbEntry = (n < BX_TLB_SIZE) ?
+        &BX_CPU_THIS_PTR TLB.entry[n] : &BX_CPU_THIS_PTR ITLB.entry[n - BX_TLB_SIZE];
       if (tlbEntry->valid()) {
         bx_address entry_lpf_mask = tlbEntry->lpf_mask;
         if ((laddr & ~entry_lpf_mask) == (tlbEntry->lpf & ~entry_lpf_mask)) {
@@ -454,8 +559,19 @@ void BX_CPU_C::TLB_invlpg(bx_address laddr)
     if (TLB_LPFOf(tlbEntry->lpf) == lpf) {
       tlbEntry->invalidate();
     }
+    tlbEntry = BX_ITLB_ENTRY_OF(laddr);
+    if (TLB_LPFOf(tlbEntry->lpf) == lpf) {
+      tlbEntry->invalidate();
+    }
   }
 
+  TLB_L2_invlpg(laddr);
+
+  // INVLPG invalidates all entries of the paging-structure caches
+#if BX_SUPPORT_X86_64
+  PSC_flush(BX_CPU_THIS_PTR PSC);
+#endif
+
 #if BX_SUPPORT_MONITOR_MWAIT
   // invalidating of the TLB entry might change translation for monitored
   // page and cause subsequent MWAIT instruction to wait forever
@@ -466,6 +582,178 @@ void BX_CPU_C::TLB_invlpg(bx_address laddr)
   BX_CPU_THIS_PTR iCache.breakLinks();
 }
 
+void BX_CPU_C::TLB_L2_flush(bx_bool keep_global)
+{
+  unsigned n;
+
+  for (n=0; n<BX_TLB_L2_SIZE; n++) {
+    bx_TLB_L2_entry *l2Entry = &BX_CPU_THIS_PTR TLB_L2.entry[n];
+    if (! keep_global || !(l2Entry->accessBits & TLB_GlobalPage))
+      l2Entry->invalidate();
+  }
+
+  BX_CPU_THIS_PTR TLB_L2.large_entries = 0;
+  if (! keep_global) {
+    for (n=0; n<BX_TLB_L2_SETS; n++)
+      BX_CPU_THIS_PTR TLB_L2.victim[n] = 0;
+    BX_CPU_THIS_PTR TLB_L2.large_victim = 0;
+  }
+
+  for (n=0; n<BX_TLB_L2_LARGE_SIZE; n++) {
+    bx_TLB_L2_entry *l2Entry = &BX_CPU_THIS_PTR TLB_L2.large[n];
+    if (! keep_global || !(l2Entry->accessBits & TLB_GlobalPage))
+      l2Entry->invalidate();
+    if (l2Entry->valid())
+      BX_CPU_THIS_PTR TLB_L2.large_entries++;
+  }
+}
+
+// second level TLB entries are tagged with PCID, global entries are shared
+#if BX_SUPPORT_X86_64
+  #define BX_CURRENT_PCID (BX_CPU_THIS_PTR current_PCID())
+#else
+  #define BX_CURRENT_PCID (0)
+#endif
+
+#define TLB_L2_MATCH_PCID(l2Entry, pcid) \
+  ((l2Entry)->pcid == (pcid) || ((l2Entry)->accessBits & TLB_GlobalPage))
+
+#if BX_SUPPORT_X86_64
+void BX_CPU_C::TLB_L2_flushPCID(Bit32u pcid)
+{
+  unsigned n;
+
+  for (n=0; n<BX_TLB_L2_SIZE; n++) {
+    bx_TLB_L2_entry *l2Entry = &BX_CPU_THIS_PTR TLB_L2.entry[n];
+    if (l2Entry->pcid == pcid && !(l2Entry->accessBits & TLB_GlobalPage))
+      l2Entry->invalidate();
+  }
+
+  for (n=0; n<BX_TLB_L2_LARGE_SIZE; n++) {
+    bx_TLB_L2_entry *l2Entry = &BX_CPU_THIS_PTR TLB_L2.large[n];
+    if (l2Entry->valid() && l2Entry->pcid == pcid && !(l2Entry->accessBits & TLB_GlobalPage)) {
+      l2Entry->invalidate();
+      BX_CPU_THIS_PTR TLB_L2.large_entries--;
+    }
+  }
+}
+#endif
+
+void BX_CPU_C::TLB_L2_invlpg(bx_address laddr)
+{
+  bx_address lpf = LPFOf(laddr);
+  bx_TLB_L2_entry *l2Entry = &BX_CPU_THIS_PTR TLB_L2.entry[BX_TLB_L2_INDEX_OF(lpf) * BX_TLB_L2_WAYS];
+
+  for (unsigned way=0; way < BX_TLB_L2_WAYS; way++, l2Entry++) {
+    if (l2Entry->lpf == lpf)
+      l2Entry->invalidate();
+  }
+
+  if (BX_CPU_THIS_PTR TLB_L2.large_entries) {
+    for (unsigned n=0; n<BX_TLB_L2_LARGE_SIZE; n++) {
+      l2Entry = &BX_CPU_THIS_PTR TLB_L2.large[n];
+      if (l2Entry->valid() && (laddr & ~((bx_address) l2Entry->lpf_mask)) == l2Entry->lpf) {
+        l2Entry->invalidate();
+        BX_CPU_THIS_PTR TLB_L2.large_entries--;
+      }
+    }
+  }
+}
+
+// Look up the second level TLB, return the entry only if it already has
+// been validated for the requested access by a previous page walk
+bx_TLB_L2_entry *BX_CPU_C::TLB_L2_lookup(bx_address laddr, unsigned user, unsigned rw)
+{
+  unsigned isWrite = rw & 1; // write or r-m-w
+  unsigned isExecute = (rw == BX_EXECUTE);
+  Bit32u accessMask = 1 << ((isExecute<<2) | (isWrite<<1) | user);
+
+  bx_address lpf = LPFOf(laddr);
+  bx_TLB_L2_entry *l2Entry = &BX_CPU_THIS_PTR TLB_L2.entry[BX_TLB_L2_INDEX_OF(lpf) * BX_TLB_L2_WAYS];
+  Bit32u pcid = BX_CURRENT_PCID;
+  unsigned n;
+
+  for (n=0; n < BX_TLB_L2_WAYS; n++, l2Entry++) {
+    if (l2Entry->lpf == lpf && TLB_L2_MATCH_PCID(l2Entry, pcid)) break;
+  }
+
+  if (n == BX_TLB_L2_WAYS) {
+    l2Entry = NULL;
+    if (BX_CPU_THIS_PTR TLB_L2.large_entries) {
+      for (n=0; n<BX_TLB_L2_LARGE_SIZE; n++) {
+        bx_TLB_L2_entry *e = &BX_CPU_THIS_PTR TLB_L2.large[n];
+        if (e->valid() && (laddr & ~((bx_address) e->lpf_mask)) == e->lpf && TLB_L2_MATCH_PCID(e, pcid)) {
+          l2Entry = e;
+          break;
+        }
+      }
+    }
+    if (! l2Entry) return NULL;
+  }
+
+  if (! (l2Entry->accessBits & accessMask))
+    return NULL;
+
+#if BX_SUPPORT_PKEYS
+  if (! isExecute) {
+    if (isWrite) {
+      if (! (accessMask & BX_CPU_THIS_PTR wr_pkey[l2Entry->pkey])) return NULL;
+    }
+    else {
+      if (! (accessMask & BX_CPU_THIS_PTR rd_pkey[l2Entry->pkey])) return NULL;
+    }
+  }
+#endif
+
+  return l2Entry;
+}
+
+void BX_CPU_C::TLB_L2_fill(bx_address laddr, bx_phy_address paddress, Bit32u lpf_mask, Bit32u combined_access, Bit32u accessBits, Bit32u pkey)
+{
+  bx_TLB_L2_entry *l2Entry;
+  bx_address lpf = laddr & ~((bx_address) lpf_mask);
+  Bit32u pcid = BX_CURRENT_PCID;
+
+  if (lpf_mask > 0xfff) {
+    unsigned n;
+    // replace stale entry for the same page if present
+    for (n=0; n<BX_TLB_L2_LARGE_SIZE; n++) {
+      l2Entry = &BX_CPU_THIS_PTR TLB_L2.large[n];
+      if (l2Entry->lpf == lpf && TLB_L2_MATCH_PCID(l2Entry, pcid)) break;
+    }
+    if (n == BX_TLB_L2_LARGE_SIZE) {
+      n = BX_CPU_THIS_PTR TLB_L2.large_victim;
+      BX_CPU_THIS_PTR TLB_L2.large_victim = (n + 1) % BX_TLB_L2_LARGE_SIZE;
+      if (! BX_CPU_THIS_PTR TLB_L2.large[n].valid())
+        BX_CPU_THIS_PTR TLB_L2.large_entries++;
+    }
+    l2Entry = &BX_CPU_THIS_PTR TLB_L2.large[n];
+  }
+  else {
+    unsigned set = BX_TLB_L2_INDEX_OF(lpf), way;
+    l2Entry = &BX_CPU_THIS_PTR TLB_L2.entry[set * BX_TLB_L2_WAYS];
+    for (way=0; way < BX_TLB_L2_WAYS; way++) {
+      if (l2Entry[way].lpf == lpf && TLB_L2_MATCH_PCID(&l2Entry[way], pcid)) break;
+    }
+    if (way == BX_TLB_L2_WAYS) {
+      // round robin replacement
+      way = BX_CPU_THIS_PTR TLB_L2.victim[set] & (BX_TLB_L2_WAYS-1);
+      BX_CPU_THIS_PTR TLB_L2.victim[set] = way + 1;
+    }
+    l2Entry += way;
+  }
+
+  l2Entry->lpf = lpf;
+  l2Entry->ppf = paddress & ~((bx_phy_address) lpf_mask);
+  l2Entry->lpf_mask = lpf_mask;
+  l2Entry->combined_access = combined_access;
+  l2Entry->accessBits = accessBits;
+#if BX_SUPPORT_PKEYS
+  l2Entry->pkey = pkey;
+#endif
+  l2Entry->pcid = pcid;
+}
+
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::INVLPG(bxInstruction_c* i)
 {
   // CPL is always 0 in real mode
@@ -690,7 +978,7 @@ bx_phy_address BX_CPU_C::translate_linear_long_mode(bx_address laddr, Bit32u &lp
   BxMemtype entry_memtype[4] = { 0 };
 
   bx_bool nx_fault = 0;
-  int leaf;
+  int leaf, start_level = BX_LEVEL_PML4;
 
   Bit64u offset_mask = BX_CONST64(0x0000ffffffffffff);
   lpf_mask = 0xfff;
@@ -701,7 +989,31 @@ bx_phy_address BX_CPU_C::translate_linear_long_mode(bx_address laddr, Bit32u &lp
   if (! BX_CPU_THIS_PTR efer.get_NXE())
     reserved |= PAGE_DIRECTORY_NX_BIT;
 
-  for (leaf = BX_LEVEL_PML4;; --leaf) {
+  bx_PSC_entry *psc = PSC_lookup(BX_CPU_THIS_PTR PSC, laddr, start_level);
+  // execute disable bit is reserved when EFER.NXE=0, walk again to fault
+  if (psc && (psc->attr & BX_PSC_ATTR_NX) && ! BX_CPU_THIS_PTR efer.get_NXE())
+    psc = NULL;
+
+  if (psc) {
+    ppf = psc->ppf;
+    combined_access = psc->combined_access;
+    curr_entry = psc->attr; // PCD/PWT for memory type of the next level
+    if ((psc->attr & BX_PSC_ATTR_NX) && rw == BX_EXECUTE)
+      nx_fault = 1;
+    for (leaf = BX_LEVEL_PML4; leaf >= start_level; --leaf) {
+      entry[leaf] = 0x20; // cached levels have the accessed bit set
+      offset_mask >>= 9;
+    }
+    start_level--;
+  }
+  else {
+    start_level = BX_LEVEL_PML4;
+  }
+
+  // combined access rights after each level, for PSC fill
+  Bit32u level_access[4];
+
+  for (leaf = start_level;; --leaf) {
     entry_addr[leaf] = ppf + ((laddr >> (9 + 9*leaf)) & 0xff8);
 #if BX_SUPPORT_VMX >= 2
     if (BX_CPU_THIS_PTR in_vmx_guest) {
@@ -730,6 +1042,7 @@ bx_phy_address BX_CPU_C::translate_linear_long_mode(bx_address laddr, Bit32u &lp
 
     combined_access &= curr_entry; // U/S and R/W
     ppf = curr_entry & BX_CONST64(0x000ffffffffff000);
+    level_access[leaf] = combined_access;
 
     if (leaf == BX_LEVEL_PTE) break;
 
@@ -798,6 +1111,14 @@ bx_phy_address BX_CPU_C::translate_linear_long_mode(bx_address laddr, Bit32u &lp
   // Update A/D bits if needed
   update_access_dirty_PAE(entry_addr, entry, entry_memtype, BX_LEVEL_PML4, leaf, isWrite);
 
+  // Remember the non-leaf entries read by this walk
+  Bit32u nx = psc ? (psc->attr & BX_PSC_ATTR_NX) : 0;
+  for (int level = start_level; level > leaf; level--) {
+    if (entry[level] & PAGE_DIRECTORY_NX_BIT) nx = BX_PSC_ATTR_NX;
+    PSC_fill(BX_CPU_THIS_PTR PSC, laddr, level, entry[level] & BX_CONST64(0x000ffffffffff000),
+         level_access[level], nx | ((Bit32u) entry[level] & 0x18));
+  }
+
   return (ppf | combined_access);
 }
 
@@ -1216,12 +1537,41 @@ bx_phy_address BX_CPU_C::translate_linear(bx_TLB_entry *tlbEntry, bx_address lad
 
   Bit32u lpf_mask = 0xfff; // 4K pages
   Bit32u combined_access = 0x06;
-#if BX_SUPPORT_X86_64
   Bit32u pkey = 0;
+  bx_bool nested_paging = 0;
+#if BX_SUPPORT_VMX >= 2
+  if (BX_CPU_THIS_PTR in_vmx_guest && SECONDARY_VMEXEC_CONTROL(VMX_VM_EXEC_CTRL3_EPT_ENABLE))
+    nested_paging = 1;
+#endif
+#if BX_SUPPORT_SVM
+  if (BX_CPU_THIS_PTR in_svm_guest && SVM_NESTED_PAGING_ENABLED)
+    nested_paging = 1;
 #endif
 
-  if(BX_CPU_THIS_PTR cr0.get_PG())
+  bx_TLB_L2_entry *l2Entry = NULL;
+
+  // Second level TLB holds translations of the guest page tables only,
+  // nested (EPT/NPT) translations always go through the full page walk
+  if (BX_CPU_THIS_PTR cr0.get_PG() && ! nested_paging)
+    l2Entry = TLB_L2_lookup(laddr, user, rw);
+
+  if (l2Entry) {
+    lpf_mask = l2Entry->lpf_mask;
+    combined_access = l2Entry->combined_access;
+#if BX_SUPPORT_PKEYS
+    pkey = l2Entry->pkey;
+#endif
+    paddress = l2Entry->ppf | (laddr & lpf_mask);
+
+#if BX_CPU_LEVEL >= 5
+    if (lpf_mask > 0xfff)
+      BX_CPU_THIS_PTR TLB.split_large = 1;
+#endif
+  }
+  else if(BX_CPU_THIS_PTR cr0.get_PG())
   {
+    INC_TLB_STAT(tlbL2Misses);
+
     BX_DEBUG(("page walk for address 0x" FMT_LIN_ADDRX, laddr));
 
 #if BX_CPU_LEVEL >= 6
@@ -1255,19 +1605,19 @@ bx_phy_address BX_CPU_C::translate_linear(bx_TLB_entry *tlbEntry, bx_address lad
     combined_access |= (BX_MEMTYPE_WB << 9); // act as memory type by paging is WB
   }
 
+  bx_phy_address guest_paddress = paddress;
+
   // Calculate physical memory address and fill in TLB cache entry
+  if (nested_paging) {
 #if BX_SUPPORT_VMX >= 2
-  if (BX_CPU_THIS_PTR in_vmx_guest) {
-    if (SECONDARY_VMEXEC_CONTROL(VMX_VM_EXEC_CTRL3_EPT_ENABLE)) {
+    if (BX_CPU_THIS_PTR in_vmx_guest)
       paddress = translate_guest_physical(paddress, laddr, 1, 0, rw);
-    }
-  }
 #endif
 #if BX_SUPPORT_SVM
-  if (BX_CPU_THIS_PTR in_svm_guest && SVM_NESTED_PAGING_ENABLED) {
-    paddress = nested_walk(paddress, rw, 0);
-  }
+    if (BX_CPU_THIS_PTR in_svm_guest)
+      paddress = nested_walk(paddress, rw, 0);
 #endif
+  }
   paddress = A20ADDR(paddress);
   ppf = PPFOf(paddress);
 
@@ -1278,53 +1628,66 @@ bx_phy_address BX_CPU_C::translate_linear(bx_TLB_entry *tlbEntry, bx_address lad
   tlbEntry->pkey = pkey;
 #endif
   tlbEntry->ppf = ppf;
-  tlbEntry->accessBits = 0;
 
-  tlbEntry->accessBits |= TLB_SysReadOK;
-  if (isWrite)
-    tlbEntry->accessBits |= TLB_SysWriteOK;
-  if (isExecute)
-    tlbEntry->accessBits |= TLB_SysExecuteOK;
+  Bit32u accessBits;
 
-  if (! BX_CPU_THIS_PTR cr0.get_PG()
-#if BX_SUPPORT_VMX >= 2
-        && ! (BX_CPU_THIS_PTR in_vmx_guest && SECONDARY_VMEXEC_CONTROL(VMX_VM_EXEC_CTRL3_EPT_ENABLE))
-#endif
-#if BX_SUPPORT_SVM
-        && ! (BX_CPU_THIS_PTR in_svm_guest && SVM_NESTED_PAGING_ENABLED)
-#endif
-    ) {
-    tlbEntry->accessBits |= TLB_UserReadOK |
-                            TLB_UserWriteOK |
-                            TLB_UserExecuteOK;
+  if (l2Entry) {
+    // the first level entry is only granted the permissions of the current
+    // access type, host pointer returned by getHostMemAddr depends on it
+    Bit32u accessMask = TLB_SysReadOK | TLB_UserReadOK | TLB_GlobalPage;
+    if (isWrite)
+      accessMask |= TLB_SysWriteOK | TLB_UserWriteOK;
+    if (isExecute)
+      accessMask |= TLB_SysExecuteOK | TLB_UserExecuteOK;
+    accessBits = l2Entry->accessBits & accessMask;
   }
   else {
-    if ((combined_access & 4) != 0) { // User Page
-
-      if (user) {
-        tlbEntry->accessBits |= TLB_UserReadOK;
-        if (isWrite)
-          tlbEntry->accessBits |= TLB_UserWriteOK;
-        if (isExecute)
-          tlbEntry->accessBits |= TLB_UserExecuteOK;
-      }
+    accessBits = TLB_SysReadOK;
+    if (isWrite)
+      accessBits |= TLB_SysWriteOK;
+    if (isExecute)
+      accessBits |= TLB_SysExecuteOK;
+
+    if (! BX_CPU_THIS_PTR cr0.get_PG() && ! nested_paging) {
+      accessBits |= TLB_UserReadOK | TLB_UserExecuteOK;
+      // like for the supervisor, write access through the host pointer is
+      // only granted on a write fill which marks the memory block dirty
+      if (isWrite)
+        accessBits |= TLB_UserWriteOK;
+    }
+    else {
+      if ((combined_access & 4) != 0) { // User Page
+
+        if (user) {
+          accessBits |= TLB_UserReadOK;
+          if (isWrite)
+            accessBits |= TLB_UserWriteOK;
+          if (isExecute)
+            accessBits |= TLB_UserExecuteOK;
+        }
 
 #if BX_CPU_LEVEL >= 6
-      if (BX_CPU_THIS_PTR cr4.get_SMEP())
-        tlbEntry->accessBits &= ~TLB_SysExecuteOK;
+        if (BX_CPU_THIS_PTR cr4.get_SMEP())
+          accessBits &= ~TLB_SysExecuteOK;
 
-      if (BX_CPU_THIS_PTR cr4.get_SMAP())
-        tlbEntry->accessBits &= ~(TLB_SysReadOK | TLB_SysWriteOK);
+        if (BX_CPU_THIS_PTR cr4.get_SMAP())
+          accessBits &= ~(TLB_SysReadOK | TLB_SysWriteOK);
 #endif
 
+      }
     }
-  }
 
 #if BX_CPU_LEVEL >= 6
-  if (combined_access & 0x100) // Global bit
-    tlbEntry->accessBits |= TLB_GlobalPage;
+    if (combined_access & 0x100) // Global bit
+      accessBits |= TLB_GlobalPage;
 #endif
 
+    if (BX_CPU_THIS_PTR cr0.get_PG() && ! nested_paging)
+      TLB_L2_fill(laddr, guest_paddress, lpf_mask, combined_access, accessBits, pkey);
+  }
+
+  tlbEntry->accessBits = accessBits;
+
   // Attempt to get a host pointer to this physical page. Put that
   // pointer in the TLB cache. Note if the request is vetoed, NULL
   // will be returned, and it's OK to OR zero in anyways.
@@ -1489,7 +1852,7 @@ bx_phy_address BX_CPU_C::nested_walk_long_mode(bx_phy_address guest_paddr, unsig
   Bit64u entry[4];
   BxMemtype entry_memtype[4] = { BX_MEMTYPE_INVALID };
   bx_bool nx_fault = 0;
-  int leaf;
+  int leaf, start_level = BX_LEVEL_PML4;
 
   SVM_CONTROLS *ctrls = &BX_CPU_THIS_PTR vmcb.ctrls;
   SVM_HOST_STATE *host_state = &BX_CPU_THIS_PTR vmcb.host_state;
@@ -1501,7 +1864,28 @@ bx_phy_address BX_CPU_C::nested_walk_long_mode(bx_phy_address guest_paddr, unsig
   if (! host_state->efer.get_NXE())
     reserved |= PAGE_DIRECTORY_NX_BIT;
 
-  for (leaf = BX_LEVEL_PML4;; --leaf) {
+  bx_PSC_entry *psc = PSC_lookup(BX_CPU_THIS_PTR PSC_nested, guest_paddr, start_level);
+  if (psc && (psc->attr & BX_PSC_ATTR_NX) && ! host_state->efer.get_NXE())
+    psc = NULL;
+
+  if (psc) {
+    ppf = psc->ppf;
+    combined_access = psc->combined_access;
+    if ((psc->attr & BX_PSC_ATTR_NX) && rw == BX_EXECUTE)
+      nx_fault = 1;
+    for (leaf = BX_LEVEL_PML4; leaf >= start_level; --leaf) {
+      entry[leaf] = 0x20; // cached levels have the accessed bit set
+      offset_mask >>= 9;
+    }
+    start_level--;
+  }
+  else {
+    start_level = BX_LEVEL_PML4;
+  }
+
+  Bit32u level_access[4];
+
+  for (leaf = start_level;; --leaf) {
     entry_addr[leaf] = ppf + ((guest_paddr >> (9 + 9*leaf)) & 0xff8);
     access_read_physical(entry_addr[leaf], 8, &entry[leaf]);
     BX_NOTIFY_PHY_MEMORY_ACCESS(entry_addr[leaf], 8, BX_MEMTYPE_INVALID, BX_READ, (BX_PTE_ACCESS + leaf), (Bit8u*)(&entry[leaf]));
@@ -1514,6 +1898,7 @@ bx_phy_address BX_CPU_C::nested_walk_long_mode(bx_phy_address guest_paddr, unsig
 
     combined_access &= curr_entry; // U/S and R/W
     ppf = curr_entry & BX_CONST64(0x000ffffffffff000);
+    level_access[leaf] = combined_access;
 
     if (leaf == BX_LEVEL_PTE) break;
 
@@ -1543,6 +1928,13 @@ bx_phy_address BX_CPU_C::nested_walk_long_mode(bx_phy_address guest_paddr, unsig
   // Update A/D bits if needed
   update_access_dirty_PAE(entry_addr, entry, entry_memtype, BX_LEVEL_PML4, leaf, isWrite);
 
+  Bit32u nx = psc ? (psc->attr & BX_PSC_ATTR_NX) : 0;
+  for (int level = start_level; level > leaf; level--) {
+    if (entry[level] & PAGE_DIRECTORY_NX_BIT) nx = BX_PSC_ATTR_NX;
+    PSC_fill(BX_CPU_THIS_PTR PSC_nested, guest_paddr, level, entry[level] & BX_CONST64(0x000ffffffffff000),
+         level_access[level], nx);
+  }
+
   // Make up the physical page frame address
   return ppf | (bx_phy_address)(guest_paddr & offset_mask);	
 }
@@ -1742,7 +2134,7 @@ bx_phy_address BX_CPU_C::translate_guest_physical(bx_phy_address guest_paddr, bx
   VMCS_CACHE *vm = &BX_CPU_THIS_PTR vmcs;
   bx_phy_address entry_addr[4], ppf = LPFOf(vm->eptptr);
   Bit64u entry[4];
-  int leaf;
+  int leaf, start_level = BX_LEVEL_PML4;
 
 #if BX_SUPPORT_MEMTYPE
   // The MTRRs have no effect on the memory type used for an access to an EPT paging structures.
@@ -1764,7 +2156,23 @@ bx_phy_address BX_CPU_C::translate_guest_physical(bx_phy_address guest_paddr, bx
 
   Bit32u vmexit_reason = 0;
 
-  for (leaf = BX_LEVEL_PML4;; --leaf) {
+  bx_PSC_entry *psc = PSC_lookup(BX_CPU_THIS_PTR PSC_nested, guest_paddr, start_level);
+  if (psc) {
+    ppf = psc->ppf;
+    combined_access = psc->combined_access;
+    for (leaf = BX_LEVEL_PML4; leaf >= start_level; --leaf) {
+      entry[leaf] = 0x100; // cached levels have the accessed bit set
+      offset_mask >>= 9;
+    }
+    start_level--;
+  }
+  else {
+    start_level = BX_LEVEL_PML4;
+  }
+
+  Bit32u level_access[4];
+
+  for (leaf = start_level;; --leaf) {
     entry_addr[leaf] = ppf + ((guest_paddr >> (9 + 9*leaf)) & 0xff8);
     access_read_physical(entry_addr[leaf], 8, &entry[leaf]);
     BX_NOTIFY_PHY_MEMORY_ACCESS(entry_addr[leaf], 8, MEMTYPE(eptptr_memtype), BX_READ, (BX_EPT_PTE_ACCESS + leaf), (Bit8u*)(&entry[leaf]));
@@ -1774,6 +2182,7 @@ bx_phy_address BX_CPU_C::translate_guest_physical(bx_phy_address guest_paddr, bx
     Bit32u curr_access_mask = curr_entry & 0x7;
 
     combined_access &= curr_access_mask;
+    level_access[leaf] = combined_access;
 
     if (curr_access_mask == BX_EPT_ENTRY_NOT_PRESENT) {
       BX_DEBUG(("EPT %s: not present", bx_paging_level[leaf]));
@@ -1872,6 +2281,11 @@ bx_phy_address BX_CPU_C::translate_guest_physical(bx_phy_address guest_paddr, bx
     update_ept_access_dirty(entry_addr, entry, MEMTYPE(eptptr_memtype), leaf, rw & 1);
   }
 
+  for (int level = start_level; level > leaf; level--) {
+    PSC_fill(BX_CPU_THIS_PTR PSC_nested, guest_paddr, level, entry[level] & BX_CONST64(0x000ffffffffff000),
+         level_access[level], 0);
+  }
+
   Bit32u page_offset = PAGE_OFFSET(guest_paddr);
   return ppf | page_offset;
 }
@@ -2386,8 +2800,26 @@ bx_hostpageaddr_t BX_CPU_C::getHostMemAddr(bx_phy_address paddr, unsigned rw)
 #if BX_LARGE_RAMFILE
 bx_bool BX_CPU_C::check_addr_in_tlb_buffers(const Bit8u *addr, const Bit8u *end)
 {
-  for (unsigned tlb_entry_num=0; tlb_entry_num < BX_TLB_SIZE; tlb_entry_num++) {
-    bx_TLB_entry *tlbEntry = &BX_CPU_THIS_PTR TLB.entry[tlb_entry_num];
+  // host pointers cached outside of the TLB must stay valid as well
+  if ((BX_CPU_THIS_PTR eipFetchPtr >= addr && BX_CPU_THIS_PTR eipFetchPtr < end) ||
+      (BX_CPU_THIS_PTR espHostPtr >= addr && BX_CPU_THIS_PTR espHostPtr < end))
+    return true;
+
+#if BX_SUPPORT_VMX
+  if (((BX_CPU_THIS_PTR vmcshostptr) >= (bx_hostpageaddr_t)addr) &&
+      ((BX_CPU_THIS_PTR vmcshostptr)  < (bx_hostpageaddr_t)end))
+    return true;
+#endif
+
+#if BX_SUPPORT_SVM
+  if (((BX_CPU_THIS_PTR vmcbhostptr) >= (bx_hostpageaddr_t)addr) &&
+      ((BX_CPU_THIS_PTR vmcbhostptr)  < (bx_hostpageaddr_t)end))
+    return true;
+#endif
+
+  for (unsigned tlb_entry_num=0; tlb_entry_num < BX_TLB_SIZE+BX_ITLB_SIZE; tlb_entry_num++) {
+    bx_TLB_entry *tlbEntry = (tlb_entry_num < BX_TLB_SIZE) ?
+      &BX_CPU_THIS_PTR TLB.entry[tlb_entry_num] : &BX_CPU_THIS_PTR ITLB.entry[tlb_entry_num - BX_TLB_SIZE];
     if (tlbEntry->valid()) {
       if (((tlbEntry->hostPageAddr) >= (const bx_hostpageaddr_t)addr) &&
           ((tlbEntry->hostPageAddr)  < (const bx_hostpageaddr_t)end))
@@ -28,6 +28,8 @@
 
 #if BX_CPU_LEVEL >= 6
 
+#include "simd_int.h"
+
 //
 // sha_f0(): A bit oriented logical operation that derives a new dword from three SHA1 state variables (dword).
 // This function is used in SHA1 round 1 to 20 processing:
@@ -120,12 +122,75 @@ BX_CPP_INLINE Bit32u sha256_transformation(Bit32u val_32, unsigned rotate1, unsi
   return rotate_r(val_32, rotate1) ^ rotate_r(val_32, rotate2) ^ (val_32 >> shr);
 }
 
+// SHA256 round function transformations (Sigma0 and Sigma1) use three rotates
+BX_CPP_INLINE Bit32u sha256_transformation_rrr(Bit32u val_32, unsigned rotate1, unsigned rotate2, unsigned rotate3)
+{
+  return rotate_r(val_32, rotate1) ^ rotate_r(val_32, rotate2) ^ rotate_r(val_32, rotate3);
+}
+
+#if BX_HOST_CRYPTO
+
+// Host SHA instructions, used when the host supports them
+
+BX_HOST_TARGET("sha") static void xmm_host_sha1nexte(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
+{
+  xmm_host_store(r, _mm_sha1nexte_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+}
+
+BX_HOST_TARGET("sha") static void xmm_host_sha1msg1(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
+{
+  xmm_host_store(r, _mm_sha1msg1_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+}
+
+BX_HOST_TARGET("sha") static void xmm_host_sha1msg2(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
+{
+  xmm_host_store(r, _mm_sha1msg2_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+}
+
+BX_HOST_TARGET("sha") static void xmm_host_sha1rnds4(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, unsigned imm)
+{
+  __m128i a = xmm_host_load(op1), b = xmm_host_load(op2);
+
+  // the round function selector has to be an immediate
+  switch(imm) {
+    case 0: a = _mm_sha1rnds4_epu32(a, b, 0); break;
+    case 1: a = _mm_sha1rnds4_epu32(a, b, 1); break;
+    case 2: a = _mm_sha1rnds4_epu32(a, b, 2); break;
+    default:
+            a = _mm_sha1rnds4_epu32(a, b, 3); break;
+  }
+
+  xmm_host_store(r, a);
+}
+
+BX_HOST_TARGET("sha") static void xmm_host_sha256rnds2(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, const BxPackedXmmRegister *wk)
+{
+  xmm_host_store(r, _mm_sha256rnds2_epu32(xmm_host_load(op1), xmm_host_load(op2), xmm_host_load(wk)));
+}
+
+BX_HOST_TARGET("sha") static void xmm_host_sha256msg1(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
+{
+  xmm_host_store(r, _mm_sha256msg1_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+}
+
+BX_HOST_TARGET("sha") static void xmm_host_sha256msg2(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
+{
+  xmm_host_store(r, _mm_sha256msg2_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+}
+
+#endif
+
 /* 0F 38 C8 */
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA1NEXTE_VdqWdqR(bxInstruction_c *i)
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  op2.xmm32u(3) += rotate_l(op1.xmm32u(3), 30);
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA)
+    xmm_host_sha1nexte(&op2, &op1, &op2);
+  else
+#endif
+    op2.xmm32u(3) += rotate_l(op1.xmm32u(3), 30);
 
   BX_WRITE_XMM_REG(i->dst(), op2);
 
@@ -137,10 +202,18 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA1MSG1_VdqWdqR(bxInstruction_c *
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  op1.xmm32u(3) ^= op1.xmm32u(1);
-  op1.xmm32u(2) ^= op1.xmm32u(0);
-  op1.xmm32u(1) ^= op2.xmm32u(3);
-  op1.xmm32u(0) ^= op2.xmm32u(2);
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA) {
+    xmm_host_sha1msg1(&op1, &op1, &op2);
+  }
+  else
+#endif
+  {
+    op1.xmm32u(3) ^= op1.xmm32u(1);
+    op1.xmm32u(2) ^= op1.xmm32u(0);
+    op1.xmm32u(1) ^= op2.xmm32u(3);
+    op1.xmm32u(0) ^= op2.xmm32u(2);
+  }
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -152,10 +225,18 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA1MSG2_VdqWdqR(bxInstruction_c *
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  op1.xmm32u(3) = rotate_l(op1.xmm32u(3) ^ op2.xmm32u(2), 1);
-  op1.xmm32u(2) = rotate_l(op1.xmm32u(2) ^ op2.xmm32u(1), 1);
-  op1.xmm32u(1) = rotate_l(op1.xmm32u(1) ^ op2.xmm32u(0), 1);
-  op1.xmm32u(0) = rotate_l(op1.xmm32u(0) ^ op1.xmm32u(3), 1);
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA) {
+    xmm_host_sha1msg2(&op1, &op1, &op2);
+  }
+  else
+#endif
+  {
+    op1.xmm32u(3) = rotate_l(op1.xmm32u(3) ^ op2.xmm32u(2), 1);
+    op1.xmm32u(2) = rotate_l(op1.xmm32u(2) ^ op2.xmm32u(1), 1);
+    op1.xmm32u(1) = rotate_l(op1.xmm32u(1) ^ op2.xmm32u(0), 1);
+    op1.xmm32u(0) = rotate_l(op1.xmm32u(0) ^ op1.xmm32u(3), 1);
+  }
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -167,6 +248,14 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA256RNDS2_VdqWdqR(bxInstruction_
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src()), wk = BX_READ_XMM_REG(0);
 
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA) {
+    xmm_host_sha256rnds2(&op1, &op1, &op2, &wk);
+    BX_WRITE_XMM_REG(i->dst(), op1);
+    BX_NEXT_INSTR(i);
+  }
+#endif
+
   Bit32u A[3], B[3], C[3], D[3], E[3], F[3], G[3], H[3];
 
   A[0] = op2.xmm32u(3);
@@ -180,8 +269,8 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA256RNDS2_VdqWdqR(bxInstruction_
   H[0] = op1.xmm32u(0);
 
   for (unsigned n=0; n < 2; n++) {
-    Bit32u   tmp = sha_ch (E[n], F[n], G[n]) + sha256_transformation(E[n], 6, 11, 25) + wk.xmm32u(n) + H[n];
-    A[n+1] = tmp + sha_maj(A[n], B[n], C[n]) + sha256_transformation(A[n], 2, 13, 22);
+    Bit32u   tmp = sha_ch (E[n], F[n], G[n]) + sha256_transformation_rrr(E[n], 6, 11, 25) + wk.xmm32u(n) + H[n];
+    A[n+1] = tmp + sha_maj(A[n], B[n], C[n]) + sha256_transformation_rrr(A[n], 2, 13, 22);
     B[n+1] = A[n];
     C[n+1] = B[n];
     D[n+1] = C[n];
@@ -191,10 +280,10 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA256RNDS2_VdqWdqR(bxInstruction_
     H[n+1] = G[n];
   }
 
-  op1.xmm32u(0) = A[2];
-  op1.xmm32u(1) = B[2];
-  op1.xmm32u(2) = E[2];
-  op1.xmm32u(3) = F[2];
+  op1.xmm32u(3) = A[2];
+  op1.xmm32u(2) = B[2];
+  op1.xmm32u(1) = E[2];
+  op1.xmm32u(0) = F[2];
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -205,12 +294,21 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA256RNDS2_VdqWdqR(bxInstruction_
 BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA256MSG1_VdqWdqR(bxInstruction_c *i)
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst());
-  Bit32u op2 = BX_READ_XMM_REG_LO_DWORD(i->src());
 
-  op1.xmm32u(0) += sha256_transformation(op1.xmm32u(1), 7, 18, 3);
-  op1.xmm32u(1) += sha256_transformation(op1.xmm32u(2), 7, 18, 3);
-  op1.xmm32u(2) += sha256_transformation(op1.xmm32u(3), 7, 18, 3);
-  op1.xmm32u(3) += sha256_transformation(op2,           7, 18, 3);
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA) {
+    xmm_host_sha256msg1(&op1, &op1, &BX_READ_XMM_REG(i->src()));
+  }
+  else
+#endif
+  {
+    Bit32u op2 = BX_READ_XMM_REG_LO_DWORD(i->src());
+
+    op1.xmm32u(0) += sha256_transformation(op1.xmm32u(1), 7, 18, 3);
+    op1.xmm32u(1) += sha256_transformation(op1.xmm32u(2), 7, 18, 3);
+    op1.xmm32u(2) += sha256_transformation(op1.xmm32u(3), 7, 18, 3);
+    op1.xmm32u(3) += sha256_transformation(op2,           7, 18, 3);
+  }
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -222,10 +320,18 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA256MSG2_VdqWdqR(bxInstruction_c
 {
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
 
-  op1.xmm32u(0) += sha256_transformation(op2.xmm32u(2), 17, 19, 10);
-  op1.xmm32u(1) += sha256_transformation(op2.xmm32u(3), 17, 19, 10);
-  op1.xmm32u(2) += sha256_transformation(op1.xmm32u(0), 17, 19, 10);
-  op1.xmm32u(3) += sha256_transformation(op1.xmm32u(1), 17, 19, 10);
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA) {
+    xmm_host_sha256msg2(&op1, &op1, &op2);
+  }
+  else
+#endif
+  {
+    op1.xmm32u(0) += sha256_transformation(op2.xmm32u(2), 17, 19, 10);
+    op1.xmm32u(1) += sha256_transformation(op2.xmm32u(3), 17, 19, 10);
+    op1.xmm32u(2) += sha256_transformation(op1.xmm32u(0), 17, 19, 10);
+    op1.xmm32u(3) += sha256_transformation(op1.xmm32u(1), 17, 19, 10);
+  }
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
@@ -240,6 +346,15 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA1RNDS4_VdqWdqIbR(bxInstruction_
   
   BxPackedXmmRegister op1 = BX_READ_XMM_REG(i->dst()), op2 = BX_READ_XMM_REG(i->src());
   unsigned imm = i->Ib() & 0x3;
+
+#if BX_HOST_CRYPTO
+  if (host_crypto_features() & BX_HOST_CRYPTO_SHA) {
+    xmm_host_sha1rnds4(&op1, &op1, &op2, imm);
+    BX_WRITE_XMM_REG(i->dst(), op1);
+    BX_NEXT_INSTR(i);
+  }
+#endif
+
   Bit32u K = sha_Ki[imm];
 
   Bit32u W[4] = { op2.xmm32u(3), op2.xmm32u(2), op2.xmm32u(1), op2.xmm32u(0) };
@@ -259,10 +374,10 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SHA1RNDS4_VdqWdqIbR(bxInstruction_
     E[n+1] = D[n];
   }
 
-  op1.xmm32u(0) = A[4];
-  op1.xmm32u(1) = B[4];
-  op1.xmm32u(2) = C[4];
-  op1.xmm32u(3) = D[4];
+  op1.xmm32u(3) = A[4];
+  op1.xmm32u(2) = B[4];
+  op1.xmm32u(1) = C[4];
+  op1.xmm32u(0) = D[4];
 
   BX_WRITE_XMM_REG(i->dst(), op1);
 
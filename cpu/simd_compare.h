@@ -292,50 +292,74 @@ BX_CPP_INLINE Bit32u xmm_pcmpleuq_mask(const BxPackedXmmRegister *op1, const BxP
 
 BX_CPP_INLINE void xmm_pcmpgtb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_cmpgt_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmubyte(n) = (op1->xmmsbyte(n) > op2->xmmsbyte(n)) ? 0xff : 0;
   }
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pcmpgtb_mask(const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   Bit32u mask = 0;
   for(unsigned n=0; n<16; n++) {
     if (op1->xmmsbyte(n) > op2->xmmsbyte(n)) mask |= (1 << n);
   }
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pcmpgtw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_cmpgt_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) = (op1->xmm16s(n) > op2->xmm16s(n)) ? 0xffff : 0;
   }
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pcmpgtw_mask(const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_epi8(_mm_packs_epi16(_mm_cmpgt_epi16(xmm_host_load(op1), xmm_host_load(op2)), _mm_setzero_si128()));
+#else
   Bit32u mask = 0;
   for(unsigned n=0; n<8; n++) {
     if (op1->xmm16s(n) > op2->xmm16s(n)) mask |= (1 << n);
   }
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pcmpgtd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_cmpgt_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     op1->xmm32u(n) = (op1->xmm32s(n) > op2->xmm32s(n)) ? 0xffffffff : 0;
   }
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pcmpgtd_mask(const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(xmm_host_load(op1), xmm_host_load(op2))));
+#else
   Bit32u mask = 0;
   for(unsigned n=0; n<4; n++) {
     if (op1->xmm32s(n) > op2->xmm32s(n)) mask |= (1 << n);
   }
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pcmpgtq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
@@ -556,50 +580,74 @@ BX_CPP_INLINE Bit32u xmm_pcmpgeuq_mask(const BxPackedXmmRegister *op1, const BxP
 
 BX_CPP_INLINE void xmm_pcmpeqb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_cmpeq_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmubyte(n) = (op1->xmmubyte(n) == op2->xmmubyte(n)) ? 0xff : 0;
   }
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pcmpeqb_mask(const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   Bit32u mask = 0;
   for(unsigned n=0; n<16; n++) {
     if (op1->xmmubyte(n) == op2->xmmubyte(n)) mask |= (1 << n);
   }
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pcmpeqw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_cmpeq_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) = (op1->xmm16u(n) == op2->xmm16u(n)) ? 0xffff : 0;
   }
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pcmpeqw_mask(const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(xmm_host_load(op1), xmm_host_load(op2)), _mm_setzero_si128()));
+#else
   Bit32u mask = 0;
   for(unsigned n=0; n<8; n++) {
     if (op1->xmm16u(n) == op2->xmm16u(n)) mask |= (1 << n);
   }
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pcmpeqd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_cmpeq_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     op1->xmm32u(n) = (op1->xmm32u(n) == op2->xmm32u(n)) ? 0xffffffff : 0;
   }
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pcmpeqd_mask(const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(xmm_host_load(op1), xmm_host_load(op2))));
+#else
   Bit32u mask = 0;
   for(unsigned n=0; n<4; n++) {
     if (op1->xmm32u(n) == op2->xmm32u(n)) mask |= (1 << n);
   }
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pcmpeqq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
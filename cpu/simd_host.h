@@ -0,0 +1,134 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (C) 2017  The Bochs Project
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef BX_SIMD_HOST_H
+#define BX_SIMD_HOST_H
+
+// On x86 hosts the hot SIMD helpers are implemented with host SIMD
+// instructions. SSE2 is part of the x86-64 baseline, SSSE3 and SSE4.1
+// forms are used only when the compiler targets them (e.g. -march=native).
+// The portable code is kept as the reference implementation for all other
+// hosts and for helpers without a direct host equivalent. Define
+// BX_NO_HOST_SIMD to always use the portable code.
+
+#if defined(BX_LITTLE_ENDIAN) && defined(__SSE2__) && !defined(BX_NO_HOST_SIMD)
+  #include <emmintrin.h>
+  #define BX_HOST_SSE2 1
+#else
+  #define BX_HOST_SSE2 0
+#endif
+
+#if BX_HOST_SSE2 && defined(__SSSE3__)
+  #include <tmmintrin.h>
+  #define BX_HOST_SSSE3 1
+#else
+  #define BX_HOST_SSSE3 0
+#endif
+
+#if BX_HOST_SSE2 && defined(__SSE4_1__)
+  #include <smmintrin.h>
+  #define BX_HOST_SSE4_1 1
+#else
+  #define BX_HOST_SSE4_1 0
+#endif
+
+#if BX_HOST_SSE2
+BX_CPP_INLINE __m128i xmm_host_load(const BxPackedXmmRegister *op)
+{
+  return _mm_loadu_si128((const __m128i *) op);
+}
+
+BX_CPP_INLINE void xmm_host_store(BxPackedXmmRegister *op, __m128i val)
+{
+  _mm_storeu_si128((__m128i *) op, val);
+}
+#endif
+
+// Host floating point arithmetic relies on doubles being computed in SSE
+// registers, which is always the case on x86-64. The host MXCSR is only
+// read to make sure it still has the default control bits.
+#if BX_HOST_SSE2 && defined(__x86_64__)
+  #define BX_HOST_SSE_FP 1
+  #if defined(__FMA__)
+    #include <immintrin.h>
+  #endif
+
+// all exceptions masked, round to nearest, no DAZ/FTZ
+  #define BX_HOST_MXCSR_DEFAULT 0x1f80
+
+BX_CPP_INLINE bx_bool host_mxcsr_is_default(void)
+{
+  return (_mm_getcsr() & ~0x3f) == BX_HOST_MXCSR_DEFAULT;
+}
+#else
+  #define BX_HOST_SSE_FP 0
+#endif
+
+// Host AES-NI, PCLMULQDQ, SHA and SSE4.2 CRC32 instructions are not part of
+// any baseline the compiler can assume, so the helpers using them are
+// compiled with a per-function target attribute and selected at runtime
+// using CPUID.
+#if BX_HOST_SSE2 && (defined(__x86_64__) || defined(__i386__)) && \
+   ((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+  #include <wmmintrin.h>
+  #include <immintrin.h>
+  #define BX_HOST_CRYPTO 1
+  #define BX_HOST_TARGET(isa) __attribute__((target(isa)))
+
+  #define BX_HOST_CRYPTO_AES    (1 << 0)
+  #define BX_HOST_CRYPTO_PCLMUL (1 << 1)
+  #define BX_HOST_CRYPTO_SHA    (1 << 2)
+  #define BX_HOST_CRYPTO_CRC32  (1 << 3)
+
+BX_CPP_INLINE void host_cpuid(Bit32u leaf, Bit32u subleaf, Bit32u *eax, Bit32u *ebx, Bit32u *ecx, Bit32u *edx)
+{
+  __asm__ ("cpuid" : "=a" (*eax), "=b" (*ebx), "=c" (*ecx), "=d" (*edx) : "a" (leaf), "c" (subleaf));
+}
+
+BX_CPP_INLINE unsigned host_crypto_features(void)
+{
+  static int features = -1;
+
+  if (features < 0) {
+    Bit32u max_leaf, eax, ebx, ecx, edx;
+    unsigned f = 0;
+    host_cpuid(0, 0, &max_leaf, &ebx, &ecx, &edx);
+    if (max_leaf >= 1) {
+      host_cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+      if (ecx & (1 << 25)) f |= BX_HOST_CRYPTO_AES;
+      if (ecx & (1 <<  1)) f |= BX_HOST_CRYPTO_PCLMUL;
+      if (ecx & (1 << 20)) f |= BX_HOST_CRYPTO_CRC32;
+    }
+    if (max_leaf >= 7) {
+      host_cpuid(7, 0, &eax, &ebx, &ecx, &edx);
+      if (ebx & (1 << 29)) f |= BX_HOST_CRYPTO_SHA;
+    }
+    features = f;
+  }
+
+  return features;
+}
+#else
+  #define BX_HOST_CRYPTO 0
+#endif
+
+#endif
@@ -24,27 +24,41 @@
 #ifndef BX_SIMD_INT_FUNCTIONS_H
 #define BX_SIMD_INT_FUNCTIONS_H
 
+#include "simd_host.h"
+
 // absolute value
 
 BX_CPP_INLINE void xmm_pabsb(BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op, _mm_abs_epi8(xmm_host_load(op)));
+#else
   for(unsigned n=0; n<16; n++) {
     if(op->xmmsbyte(n) < 0) op->xmmubyte(n) = -op->xmmsbyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pabsw(BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op, _mm_abs_epi16(xmm_host_load(op)));
+#else
   for(unsigned n=0; n<8; n++) {
     if(op->xmm16s(n) < 0) op->xmm16u(n) = -op->xmm16s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pabsd(BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op, _mm_abs_epi32(xmm_host_load(op)));
+#else
   for(unsigned n=0; n<4; n++) {
     if(op->xmm32s(n) < 0) op->xmm32u(n) = -op->xmm32s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pabsq(BxPackedXmmRegister *op)
@@ -58,44 +72,68 @@ BX_CPP_INLINE void xmm_pabsq(BxPackedXmmRegister *op)
 
 BX_CPP_INLINE void xmm_pminsb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_min_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     if(op2->xmmsbyte(n) < op1->xmmsbyte(n)) op1->xmmubyte(n) = op2->xmmubyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pminub(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_min_epu8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     if(op2->xmmubyte(n) < op1->xmmubyte(n)) op1->xmmubyte(n) = op2->xmmubyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pminsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_min_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     if(op2->xmm16s(n) < op1->xmm16s(n)) op1->xmm16s(n) = op2->xmm16s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pminuw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_min_epu16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     if(op2->xmm16u(n) < op1->xmm16u(n)) op1->xmm16s(n) = op2->xmm16s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pminsd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_min_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     if(op2->xmm32s(n) < op1->xmm32s(n)) op1->xmm32u(n) = op2->xmm32u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pminud(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_min_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     if(op2->xmm32u(n) < op1->xmm32u(n)) op1->xmm32u(n) = op2->xmm32u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pminsq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
@@ -114,44 +152,68 @@ BX_CPP_INLINE void xmm_pminuq(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
 
 BX_CPP_INLINE void xmm_pmaxsb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_max_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     if(op2->xmmsbyte(n) > op1->xmmsbyte(n)) op1->xmmubyte(n) = op2->xmmubyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaxub(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_max_epu8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     if(op2->xmmubyte(n) > op1->xmmubyte(n)) op1->xmmubyte(n) = op2->xmmubyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaxsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_max_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     if(op2->xmm16s(n) > op1->xmm16s(n)) op1->xmm16s(n) = op2->xmm16s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaxuw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_max_epu16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     if(op2->xmm16u(n) > op1->xmm16u(n)) op1->xmm16s(n) = op2->xmm16s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaxsd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_max_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     if(op2->xmm32s(n) > op1->xmm32s(n)) op1->xmm32u(n) = op2->xmm32u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaxud(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_max_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     if(op2->xmm32u(n) > op1->xmm32u(n)) op1->xmm32u(n) = op2->xmm32u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaxsq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
@@ -172,34 +234,53 @@ BX_CPP_INLINE void xmm_pmaxuq(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
 
 BX_CPP_INLINE void xmm_unpcklps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpacklo_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm32u(3) = op2->xmm32u(1);
   op1->xmm32u(2) = op1->xmm32u(1);
   op1->xmm32u(1) = op2->xmm32u(0);
 //op1->xmm32u(0) = op1->xmm32u(0);
+#endif
 }
 
 BX_CPP_INLINE void xmm_unpckhps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpackhi_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm32u(0) = op1->xmm32u(2);
   op1->xmm32u(1) = op2->xmm32u(2);
   op1->xmm32u(2) = op1->xmm32u(3);
   op1->xmm32u(3) = op2->xmm32u(3);
+#endif
 }
 
 BX_CPP_INLINE void xmm_unpcklpd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpacklo_epi64(xmm_host_load(op1), xmm_host_load(op2)));
+#else
 //op1->xmm64u(0) = op1->xmm64u(0);
   op1->xmm64u(1) = op2->xmm64u(0);
+#endif
 }
 
 BX_CPP_INLINE void xmm_unpckhpd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpackhi_epi64(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm64u(0) = op1->xmm64u(1);
   op1->xmm64u(1) = op2->xmm64u(1);
+#endif
 }
 
 BX_CPP_INLINE void xmm_punpcklbw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpacklo_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmmubyte(0xF) = op2->xmmubyte(7);
   op1->xmmubyte(0xE) = op1->xmmubyte(7);
   op1->xmmubyte(0xD) = op2->xmmubyte(6);
@@ -216,10 +297,14 @@ BX_CPP_INLINE void xmm_punpcklbw(BxPackedXmmRegister *op1, const BxPackedXmmRegi
   op1->xmmubyte(0x2) = op1->xmmubyte(1);
   op1->xmmubyte(0x1) = op2->xmmubyte(0);
 //op1->xmmubyte(0x0) = op1->xmmubyte(0);
+#endif
 }
 
 BX_CPP_INLINE void xmm_punpckhbw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpackhi_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmmubyte(0x0) = op1->xmmubyte(0x8);
   op1->xmmubyte(0x1) = op2->xmmubyte(0x8);
   op1->xmmubyte(0x2) = op1->xmmubyte(0x9);
@@ -236,10 +321,14 @@ BX_CPP_INLINE void xmm_punpckhbw(BxPackedXmmRegister *op1, const BxPackedXmmRegi
   op1->xmmubyte(0xD) = op2->xmmubyte(0xE);
   op1->xmmubyte(0xE) = op1->xmmubyte(0xF);
   op1->xmmubyte(0xF) = op2->xmmubyte(0xF);
+#endif
 }
 
 BX_CPP_INLINE void xmm_punpcklwd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpacklo_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16u(7) = op2->xmm16u(3);
   op1->xmm16u(6) = op1->xmm16u(3);
   op1->xmm16u(5) = op2->xmm16u(2);
@@ -248,10 +337,14 @@ BX_CPP_INLINE void xmm_punpcklwd(BxPackedXmmRegister *op1, const BxPackedXmmRegi
   op1->xmm16u(2) = op1->xmm16u(1);
   op1->xmm16u(1) = op2->xmm16u(0);
 //op1->xmm16u(0) = op1->xmm16u(0);
+#endif
 }
 
 BX_CPP_INLINE void xmm_punpckhwd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_unpackhi_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16u(0) = op1->xmm16u(4);
   op1->xmm16u(1) = op2->xmm16u(4);
   op1->xmm16u(2) = op1->xmm16u(5);
@@ -260,12 +353,16 @@ BX_CPP_INLINE void xmm_punpckhwd(BxPackedXmmRegister *op1, const BxPackedXmmRegi
   op1->xmm16u(5) = op2->xmm16u(6);
   op1->xmm16u(6) = op1->xmm16u(7);
   op1->xmm16u(7) = op2->xmm16u(7);
+#endif
 }
  
 // pack
 
 BX_CPP_INLINE void xmm_packuswb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_packus_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmmubyte(0x0) = SaturateWordSToByteU(op1->xmm16s(0));
   op1->xmmubyte(0x1) = SaturateWordSToByteU(op1->xmm16s(1));
   op1->xmmubyte(0x2) = SaturateWordSToByteU(op1->xmm16s(2));
@@ -283,10 +380,14 @@ BX_CPP_INLINE void xmm_packuswb(BxPackedXmmRegister *op1, const BxPackedXmmRegis
   op1->xmmubyte(0xD) = SaturateWordSToByteU(op2->xmm16s(5));
   op1->xmmubyte(0xE) = SaturateWordSToByteU(op2->xmm16s(6));
   op1->xmmubyte(0xF) = SaturateWordSToByteU(op2->xmm16s(7));
+#endif
 }
 
 BX_CPP_INLINE void xmm_packsswb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_packs_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmmsbyte(0x0) = SaturateWordSToByteS(op1->xmm16s(0));
   op1->xmmsbyte(0x1) = SaturateWordSToByteS(op1->xmm16s(1));
   op1->xmmsbyte(0x2) = SaturateWordSToByteS(op1->xmm16s(2));
@@ -304,10 +405,14 @@ BX_CPP_INLINE void xmm_packsswb(BxPackedXmmRegister *op1, const BxPackedXmmRegis
   op1->xmmsbyte(0xD) = SaturateWordSToByteS(op2->xmm16s(5));
   op1->xmmsbyte(0xE) = SaturateWordSToByteS(op2->xmm16s(6));
   op1->xmmsbyte(0xF) = SaturateWordSToByteS(op2->xmm16s(7));
+#endif
 }
 
 BX_CPP_INLINE void xmm_packusdw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_packus_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16u(0) = SaturateDwordSToWordU(op1->xmm32s(0));
   op1->xmm16u(1) = SaturateDwordSToWordU(op1->xmm32s(1));
   op1->xmm16u(2) = SaturateDwordSToWordU(op1->xmm32s(2));
@@ -317,10 +422,14 @@ BX_CPP_INLINE void xmm_packusdw(BxPackedXmmRegister *op1, const BxPackedXmmRegis
   op1->xmm16u(5) = SaturateDwordSToWordU(op2->xmm32s(1));
   op1->xmm16u(6) = SaturateDwordSToWordU(op2->xmm32s(2));
   op1->xmm16u(7) = SaturateDwordSToWordU(op2->xmm32s(3));
+#endif
 }
 
 BX_CPP_INLINE void xmm_packssdw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_packs_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16s(0) = SaturateDwordSToWordS(op1->xmm32s(0));
   op1->xmm16s(1) = SaturateDwordSToWordS(op1->xmm32s(1));
   op1->xmm16s(2) = SaturateDwordSToWordS(op1->xmm32s(2));
@@ -330,12 +439,16 @@ BX_CPP_INLINE void xmm_packssdw(BxPackedXmmRegister *op1, const BxPackedXmmRegis
   op1->xmm16s(5) = SaturateDwordSToWordS(op2->xmm32s(1));
   op1->xmm16s(6) = SaturateDwordSToWordS(op2->xmm32s(2));
   op1->xmm16s(7) = SaturateDwordSToWordS(op2->xmm32s(3));
+#endif
 }
 
 // shuffle
 
 BX_CPP_INLINE void xmm_pshufb(BxPackedXmmRegister *r, const BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(r, _mm_shuffle_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++)
   {
     unsigned mask = op2->xmmubyte(n);
@@ -344,6 +457,7 @@ BX_CPP_INLINE void xmm_pshufb(BxPackedXmmRegister *r, const BxPackedXmmRegister
     else
       r->xmmubyte(n) = op1->xmmubyte(mask & 0xf);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pshufhw(BxPackedXmmRegister *r, const BxPackedXmmRegister *op, Bit8u order)
@@ -428,32 +542,47 @@ BX_CPP_INLINE void ymm_vpermq(BxPackedYmmRegister *r, const BxPackedYmmRegister
 
 BX_CPP_INLINE void xmm_psignb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_sign_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     int sign = (op2->xmmsbyte(n) > 0) - (op2->xmmsbyte(n) < 0);
     op1->xmmsbyte(n) *= sign;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psignw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_sign_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     int sign = (op2->xmm16s(n) > 0) - (op2->xmm16s(n) < 0);
     op1->xmm16s(n) *= sign;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psignd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_sign_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     int sign = (op2->xmm32s(n) > 0) - (op2->xmm32s(n) < 0);
     op1->xmm32s(n) *= sign;
   }
+#endif
 }
 
 // mask creation
 
 BX_CPP_INLINE Bit32u xmm_pmovmskb(const BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_epi8(xmm_host_load(op));
+#else
   Bit32u mask = 0;
 
   if(op->xmmsbyte(0x0) < 0) mask |= 0x0001;
@@ -474,10 +603,14 @@ BX_CPP_INLINE Bit32u xmm_pmovmskb(const BxPackedXmmRegister *op)
   if(op->xmmsbyte(0xF) < 0) mask |= 0x8000;
 
   return mask;
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pmovmskw(const BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_epi8(_mm_packs_epi16(xmm_host_load(op), _mm_setzero_si128()));
+#else
   Bit32u mask = 0;
 
   if(op->xmm16s(0) < 0) mask |= 0x01;
@@ -490,10 +623,14 @@ BX_CPP_INLINE Bit32u xmm_pmovmskw(const BxPackedXmmRegister *op)
   if(op->xmm16s(7) < 0) mask |= 0x80;
 
   return mask;
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pmovmskd(const BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_ps(_mm_castsi128_ps(xmm_host_load(op)));
+#else
   Bit32u mask = 0;
 
   if(op->xmm32s(0) < 0) mask |= 0x1;
@@ -502,16 +639,21 @@ BX_CPP_INLINE Bit32u xmm_pmovmskd(const BxPackedXmmRegister *op)
   if(op->xmm32s(3) < 0) mask |= 0x8;
 
   return mask;
+#endif
 }
 
 BX_CPP_INLINE Bit32u xmm_pmovmskq(const BxPackedXmmRegister *op)
 {
+#if BX_HOST_SSE2
+  return _mm_movemask_pd(_mm_castsi128_pd(xmm_host_load(op)));
+#else
   Bit32u mask = 0;
 
   if(op->xmm32s(1) < 0) mask |= 0x1;
   if(op->xmm32s(3) < 0) mask |= 0x2;
 
   return mask;
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmovm2b(BxPackedXmmRegister *dst, Bit32u mask)
@@ -702,132 +844,207 @@ BX_CPP_INLINE void xmm_blendvpd(BxPackedXmmRegister *op1, const BxPackedXmmRegis
 
 BX_CPP_INLINE void xmm_andps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_and_si128(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for (unsigned n=0; n < 2; n++)
     op1->xmm64u(n) &= op2->xmm64u(n);
+#endif
 }
 
 BX_CPP_INLINE void xmm_andnps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_andnot_si128(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for (unsigned n=0; n < 2; n++)
     op1->xmm64u(n) = ~(op1->xmm64u(n)) & op2->xmm64u(n);
+#endif
 }
 
 BX_CPP_INLINE void xmm_orps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_or_si128(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for (unsigned n=0; n < 2; n++)
     op1->xmm64u(n) |= op2->xmm64u(n);
+#endif
 }
 
 BX_CPP_INLINE void xmm_xorps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_xor_si128(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for (unsigned n=0; n < 2; n++)
     op1->xmm64u(n) ^= op2->xmm64u(n);
+#endif
 }
 
 // arithmetic (add/sub)
 
 BX_CPP_INLINE void xmm_paddb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_add_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmubyte(n) += op2->xmmubyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_paddw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_add_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) += op2->xmm16u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_paddd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_add_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     op1->xmm32u(n) += op2->xmm32u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_paddq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_add_epi64(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<2; n++) {
     op1->xmm64u(n) += op2->xmm64u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_sub_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmubyte(n) -= op2->xmmubyte(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_sub_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) -= op2->xmm16u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_sub_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     op1->xmm32u(n) -= op2->xmm32u(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_sub_epi64(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<2; n++) {
     op1->xmm64u(n) -= op2->xmm64u(n);
   }
+#endif
 }
 
 // arithmetic (add/sub with saturation)
 
 BX_CPP_INLINE void xmm_paddsb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_adds_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmsbyte(n) = SaturateWordSToByteS(Bit16s(op1->xmmsbyte(n)) + Bit16s(op2->xmmsbyte(n)));
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_paddsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_adds_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16s(n) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(n)) + Bit32s(op2->xmm16s(n)));
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_paddusb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_adds_epu8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmubyte(n) = SaturateWordSToByteU(Bit16s(op1->xmmubyte(n)) + Bit16s(op2->xmmubyte(n)));
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_paddusw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_adds_epu16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) = SaturateDwordSToWordU(Bit32s(op1->xmm16u(n)) + Bit32s(op2->xmm16u(n)));
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubsb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_subs_epi8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmsbyte(n) = SaturateWordSToByteS(Bit16s(op1->xmmsbyte(n)) - Bit16s(op2->xmmsbyte(n)));
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_subs_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16s(n) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(n)) - Bit32s(op2->xmm16s(n)));
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubusb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_subs_epu8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++)
   {
     if(op1->xmmubyte(n) > op2->xmmubyte(n))
@@ -835,10 +1052,14 @@ BX_CPP_INLINE void xmm_psubusb(BxPackedXmmRegister *op1, const BxPackedXmmRegist
     else
       op1->xmmubyte(n) = 0;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psubusw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_subs_epu16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++)
   {
     if(op1->xmm16u(n) > op2->xmm16u(n))
@@ -846,12 +1067,16 @@ BX_CPP_INLINE void xmm_psubusw(BxPackedXmmRegister *op1, const BxPackedXmmRegist
     else
       op1->xmm16u(n) = 0;
   }
+#endif
 }
 
 // arithmetic (horizontal add/sub)
 
 BX_CPP_INLINE void xmm_phaddw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_hadd_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16u(0) = op1->xmm16u(0) + op1->xmm16u(1);
   op1->xmm16u(1) = op1->xmm16u(2) + op1->xmm16u(3);
   op1->xmm16u(2) = op1->xmm16u(4) + op1->xmm16u(5);
@@ -861,18 +1086,26 @@ BX_CPP_INLINE void xmm_phaddw(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
   op1->xmm16u(5) = op2->xmm16u(2) + op2->xmm16u(3);
   op1->xmm16u(6) = op2->xmm16u(4) + op2->xmm16u(5);
   op1->xmm16u(7) = op2->xmm16u(6) + op2->xmm16u(7);
+#endif
 }
 
 BX_CPP_INLINE void xmm_phaddd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_hadd_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm32u(0) = op1->xmm32u(0) + op1->xmm32u(1);
   op1->xmm32u(1) = op1->xmm32u(2) + op1->xmm32u(3);
   op1->xmm32u(2) = op2->xmm32u(0) + op2->xmm32u(1);
   op1->xmm32u(3) = op2->xmm32u(2) + op2->xmm32u(3);
+#endif
 }
 
 BX_CPP_INLINE void xmm_phaddsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_hadds_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16s(0) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(0)) + Bit32s(op1->xmm16s(1)));
   op1->xmm16s(1) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(2)) + Bit32s(op1->xmm16s(3)));
   op1->xmm16s(2) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(4)) + Bit32s(op1->xmm16s(5)));
@@ -882,10 +1115,14 @@ BX_CPP_INLINE void xmm_phaddsw(BxPackedXmmRegister *op1, const BxPackedXmmRegist
   op1->xmm16s(5) = SaturateDwordSToWordS(Bit32s(op2->xmm16s(2)) + Bit32s(op2->xmm16s(3)));
   op1->xmm16s(6) = SaturateDwordSToWordS(Bit32s(op2->xmm16s(4)) + Bit32s(op2->xmm16s(5)));
   op1->xmm16s(7) = SaturateDwordSToWordS(Bit32s(op2->xmm16s(6)) + Bit32s(op2->xmm16s(7)));
+#endif
 }
 
 BX_CPP_INLINE void xmm_phsubw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_hsub_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16u(0) = op1->xmm16u(0) - op1->xmm16u(1);
   op1->xmm16u(1) = op1->xmm16u(2) - op1->xmm16u(3);
   op1->xmm16u(2) = op1->xmm16u(4) - op1->xmm16u(5);
@@ -895,18 +1132,26 @@ BX_CPP_INLINE void xmm_phsubw(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
   op1->xmm16u(5) = op2->xmm16u(2) - op2->xmm16u(3);
   op1->xmm16u(6) = op2->xmm16u(4) - op2->xmm16u(5);
   op1->xmm16u(7) = op2->xmm16u(6) - op2->xmm16u(7);
+#endif
 }
 
 BX_CPP_INLINE void xmm_phsubd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_hsub_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm32u(0) = op1->xmm32u(0) - op1->xmm32u(1);
   op1->xmm32u(1) = op1->xmm32u(2) - op1->xmm32u(3);
   op1->xmm32u(2) = op2->xmm32u(0) - op2->xmm32u(1);
   op1->xmm32u(3) = op2->xmm32u(2) - op2->xmm32u(3);
+#endif
 }
 
 BX_CPP_INLINE void xmm_phsubsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_hsubs_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm16s(0) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(0)) - Bit32s(op1->xmm16s(1)));
   op1->xmm16s(1) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(2)) - Bit32s(op1->xmm16s(3)));
   op1->xmm16s(2) = SaturateDwordSToWordS(Bit32s(op1->xmm16s(4)) - Bit32s(op1->xmm16s(5)));
@@ -916,54 +1161,79 @@ BX_CPP_INLINE void xmm_phsubsw(BxPackedXmmRegister *op1, const BxPackedXmmRegist
   op1->xmm16s(5) = SaturateDwordSToWordS(Bit32s(op2->xmm16s(2)) - Bit32s(op2->xmm16s(3)));
   op1->xmm16s(6) = SaturateDwordSToWordS(Bit32s(op2->xmm16s(4)) - Bit32s(op2->xmm16s(5)));
   op1->xmm16s(7) = SaturateDwordSToWordS(Bit32s(op2->xmm16s(6)) - Bit32s(op2->xmm16s(7)));
+#endif
 }
 
 // average
 
 BX_CPP_INLINE void xmm_pavgb(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_avg_epu8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<16; n++) {
     op1->xmmubyte(n) = (op1->xmmubyte(n) + op2->xmmubyte(n) + 1) >> 1;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pavgw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_avg_epu16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) = (op1->xmm16u(n) + op2->xmm16u(n) + 1) >> 1;
   }
+#endif
 }
 
 // multiply
 
 BX_CPP_INLINE void xmm_pmullw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_mullo_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16s(n) *= op2->xmm16s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmulhw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_mulhi_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     Bit32s product = Bit32s(op1->xmm16s(n)) * Bit32s(op2->xmm16s(n));
     op1->xmm16u(n) = (Bit16u)(product >> 16);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmulhuw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_mulhi_epu16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     Bit32u product = Bit32u(op1->xmm16u(n)) * Bit32u(op2->xmm16u(n));
     op1->xmm16u(n) = (Bit16u)(product >> 16);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmulld(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_mullo_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++) {
     op1->xmm32s(n) *= op2->xmm32s(n);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmullq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
@@ -975,27 +1245,42 @@ BX_CPP_INLINE void xmm_pmullq(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
 
 BX_CPP_INLINE void xmm_pmuldq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE4_1
+  xmm_host_store(op1, _mm_mul_epi32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm64s(0) = Bit64s(op1->xmm32s(0)) * Bit64s(op2->xmm32s(0));
   op1->xmm64s(1) = Bit64s(op1->xmm32s(2)) * Bit64s(op2->xmm32s(2));
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmuludq(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_mul_epu32(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   op1->xmm64u(0) = Bit64u(op1->xmm32u(0)) * Bit64u(op2->xmm32u(0));
   op1->xmm64u(1) = Bit64u(op1->xmm32u(2)) * Bit64u(op2->xmm32u(2));
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmulhrsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_mulhrs_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++) {
     op1->xmm16u(n) = (((Bit32s(op1->xmm16s(n)) * Bit32s(op2->xmm16s(n))) >> 14) + 1) >> 1;
   }
+#endif
 }
 
 // multiply/add
 
 BX_CPP_INLINE void xmm_pmaddubsw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSSE3
+  xmm_host_store(op1, _mm_maddubs_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<8; n++)
   {
     Bit32s temp = Bit32s(op1->xmmubyte(n*2))   * Bit32s(op2->xmmsbyte(n*2)) +
@@ -1003,15 +1288,20 @@ BX_CPP_INLINE void xmm_pmaddubsw(BxPackedXmmRegister *op1, const BxPackedXmmRegi
 
     op1->xmm16s(n) = SaturateDwordSToWordS(temp);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pmaddwd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_madd_epi16(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   for(unsigned n=0; n<4; n++)
   {
     op1->xmm32u(n) = Bit32s(op1->xmm16s(n*2))   * Bit32s(op2->xmm16s(n*2)) + 
                      Bit32s(op1->xmm16s(n*2+1)) * Bit32s(op2->xmm16s(n*2+1));
   }
+#endif
 }
 
 // broadcast
@@ -1078,6 +1368,9 @@ BX_CPP_INLINE void simd_pbroadcastq(BxPackedAvxRegister *op, Bit64u val_64, unsi
 
 BX_CPP_INLINE void xmm_psadbw(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op1, _mm_sad_epu8(xmm_host_load(op1), xmm_host_load(op2)));
+#else
   unsigned temp = 0;
   for (unsigned n=0; n < 8; n++)
     temp += abs(op1->xmmubyte(n) - op2->xmmubyte(n));
@@ -1089,6 +1382,7 @@ BX_CPP_INLINE void xmm_psadbw(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
     temp += abs(op1->xmmubyte(n) - op2->xmmubyte(n));
 
   op1->xmm64u(1) = Bit64u(temp);
+#endif
 }
 
 // multiple sum of absolute differences (MSAD)
@@ -1268,6 +1562,9 @@ BX_CPP_INLINE void xmm_psrlvq(BxPackedXmmRegister *op1, const BxPackedXmmRegiste
 
 BX_CPP_INLINE void xmm_psraw(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_sra_epi16(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 15) {
     for (unsigned n=0; n < 8; n++)
       op->xmm16u(n) = (op->xmm16s(n) < 0) ? 0xffff : 0;
@@ -1279,10 +1576,14 @@ BX_CPP_INLINE void xmm_psraw(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 8; n++)
       op->xmm16u(n) = (Bit16u)(op->xmm16s(n) >> shift);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psrad(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_sra_epi32(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 31) {
     for (unsigned n=0; n < 4; n++)
       op->xmm32u(n) = (op->xmm32s(n) < 0) ? 0xffffffff : 0;
@@ -1294,6 +1595,7 @@ BX_CPP_INLINE void xmm_psrad(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 4; n++)
       op->xmm32u(n) = (Bit32u)(op->xmm32s(n) >> shift);
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psraq(BxPackedXmmRegister *op, Bit64u shift_64)
@@ -1313,6 +1615,9 @@ BX_CPP_INLINE void xmm_psraq(BxPackedXmmRegister *op, Bit64u shift_64)
 
 BX_CPP_INLINE void xmm_psrlw(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_srl_epi16(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 15) op->clear();
   else
   {
@@ -1321,10 +1626,14 @@ BX_CPP_INLINE void xmm_psrlw(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 8; n++)
       op->xmm16u(n) >>= shift;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psrld(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_srl_epi32(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 31) op->clear();
   else
   {
@@ -1333,11 +1642,15 @@ BX_CPP_INLINE void xmm_psrld(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 4; n++)
       op->xmm32u(n) >>= shift;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psrlq(BxPackedXmmRegister *op, Bit64u shift_64)
 {
-  if(shift_64 > 64) op->clear();
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_srl_epi64(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
+  if(shift_64 > 63) op->clear();
   else
   {
     Bit8u shift = (Bit8u) shift_64;
@@ -1345,10 +1658,14 @@ BX_CPP_INLINE void xmm_psrlq(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 2; n++)
       op->xmm64u(n) >>= shift;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psllw(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_sll_epi16(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 15) op->clear();
   else
   {
@@ -1357,10 +1674,14 @@ BX_CPP_INLINE void xmm_psllw(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 8; n++)
       op->xmm16u(n) <<= shift;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_pslld(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_sll_epi32(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 31) op->clear();
   else
   {
@@ -1369,10 +1690,14 @@ BX_CPP_INLINE void xmm_pslld(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 4; n++)
       op->xmm32u(n) <<= shift;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psllq(BxPackedXmmRegister *op, Bit64u shift_64)
 {
+#if BX_HOST_SSE2
+  xmm_host_store(op, _mm_sll_epi64(xmm_host_load(op), _mm_set_epi64x(0, (Bit64s) shift_64)));
+#else
   if(shift_64 > 63) op->clear();
   else
   {
@@ -1381,6 +1706,7 @@ BX_CPP_INLINE void xmm_psllq(BxPackedXmmRegister *op, Bit64u shift_64)
     for (unsigned n=0; n < 2; n++)
       op->xmm64u(n) <<= shift;
   }
+#endif
 }
 
 BX_CPP_INLINE void xmm_psrldq(BxPackedXmmRegister *op, Bit8u shift)
@@ -24,10 +24,280 @@
 #ifndef BX_SIMD_PFP_FUNCTIONS_H
 #define BX_SIMD_PFP_FUNCTIONS_H
 
+#include "simd_host.h"
+
+#if BX_HOST_SSE_FP
+
+// Host SSE arithmetic is used when it provably gives the softfloat result
+// and flags: round to nearest, normal or zero operands and a normal result
+// away from the overflow and underflow thresholds. No exception except #P
+// is possible then, and #P is computed exactly from the rounding error, so
+// the host MXCSR never has to be written (LDMXCSR serializes the host FP
+// pipeline and costs more than the softfloat operation). NaNs, infinities,
+// denormals, DAZ/FTZ, overflow and underflow are left to softfloat, which
+// stays the reference implementation.
+//
+// Single precision is computed in double precision: the result rounded to
+// single precision is correctly rounded for add/sub/mul/div/sqrt (53 >=
+// 2*24+2) and products of two single precision values are exact. Double
+// precision uses the exact product error from FMA or Veltkamp/Dekker
+// splitting and the exact sum error from TwoSum.
+
+BX_CPP_INLINE double float64_to_host(float64 a) { double d; memcpy(&d, &a, 8); return d; }
+BX_CPP_INLINE float64 float64_from_host(double d) { float64 a; memcpy(&a, &d, 8); return a; }
+BX_CPP_INLINE float float32_to_host(float32 a) { float f; memcpy(&f, &a, 4); return f; }
+BX_CPP_INLINE float32 float32_from_host(float f) { float32 a; memcpy(&a, &f, 4); return a; }
+
+BX_CPP_INLINE int host_fp_enabled(const float_status_t &status)
+{
+  return get_float_rounding_mode(status) == float_round_nearest_even && host_mxcsr_is_default();
+}
+
+// biased exponent limits of operands and results accepted by the host path
+const unsigned BX_HOST_FP32_EXP_MIN = 0x002, BX_HOST_FP32_EXP_MAX = 0x0fe;
+const unsigned BX_HOST_FP64_EXP_MIN = 0x080, BX_HOST_FP64_EXP_MAX = 0x77f;
+
+BX_CPP_INLINE int float32_host_normal(float32 a)
+{
+  unsigned exp = (a >> 23) & 0xff;
+  return exp >= BX_HOST_FP32_EXP_MIN && exp <= BX_HOST_FP32_EXP_MAX;
+}
+
+BX_CPP_INLINE int float64_host_normal(float64 a)
+{
+  unsigned exp = (unsigned)(a >> 52) & 0x7ff;
+  return exp >= BX_HOST_FP64_EXP_MIN && exp <= BX_HOST_FP64_EXP_MAX;
+}
+
+BX_CPP_INLINE int float32_host_zero(float32 a) { return (a << 1) == 0; }
+BX_CPP_INLINE int float64_host_zero(float64 a) { return (a << 1) == 0; }
+
+// exact error of the rounded sum s = a + b
+BX_CPP_INLINE double host_two_sum_error(double a, double b, double s)
+{
+  double bv = s - a, av = s - bv;
+  return (a - av) + (b - bv);
+}
+
+// exact error of the rounded product p = a * b
+BX_CPP_INLINE double host_two_product_error(double a, double b, double p)
+{
+#if defined(__FMA__)
+  return _mm_cvtsd_f64(_mm_fmsub_sd(_mm_set_sd(a), _mm_set_sd(b), _mm_set_sd(p)));
+#else
+  const double split = 134217729.0; // 2^27 + 1
+  double t = split * a, ah = t - (t - a), al = a - ah;
+  t = split * b;
+  double bh = t - (t - b), bl = b - bh;
+  return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+}
+
+// Each host primitive returns 0 when the result has to be computed by
+// softfloat, otherwise it stores the result and accumulates #P.
+
+BX_CPP_INLINE int float32_host_add(float32 &r, float32 a, float32 b, int &inexact)
+{
+  if (! ((float32_host_normal(a) || float32_host_zero(a)) &&
+         (float32_host_normal(b) || float32_host_zero(b)))) return 0;
+
+  double da = float32_to_host(a), db = float32_to_host(b), d = da + db;
+  float f = (float) d;
+  r = float32_from_host(f);
+  if (! (float32_host_normal(r) || float32_host_zero(r))) return 0;
+  inexact |= (double) f != d || host_two_sum_error(da, db, d) != 0;
+  return 1;
+}
+
+BX_CPP_INLINE int float32_host_mul(float32 &r, float32 a, float32 b, int &inexact)
+{
+  if (float32_host_zero(a) || float32_host_zero(b)) {
+    if (! (float32_host_normal(a) || float32_host_zero(a)) ||
+        ! (float32_host_normal(b) || float32_host_zero(b))) return 0;
+    r = (a ^ b) & 0x80000000;
+    return 1;
+  }
+  if (! float32_host_normal(a) || ! float32_host_normal(b)) return 0;
+
+  double d = (double) float32_to_host(a) * (double) float32_to_host(b);
+  float f = (float) d;
+  r = float32_from_host(f);
+  if (! float32_host_normal(r)) return 0;
+  inexact |= (double) f != d;
+  return 1;
+}
+
+BX_CPP_INLINE int float32_host_div(float32 &r, float32 a, float32 b, int &inexact)
+{
+  if (! float32_host_normal(b)) return 0;
+  if (float32_host_zero(a)) {
+    r = (a ^ b) & 0x80000000;
+    return 1;
+  }
+  if (! float32_host_normal(a)) return 0;
+
+  double da = float32_to_host(a), db = float32_to_host(b);
+  float f = (float) (da / db);
+  r = float32_from_host(f);
+  if (! float32_host_normal(r)) return 0;
+  inexact |= (double) f * db != da;
+  return 1;
+}
+
+BX_CPP_INLINE int float32_host_sqrt(float32 &r, float32 a, int &inexact)
+{
+  if (float32_host_zero(a)) {
+    r = a;
+    return 1;
+  }
+  if (! float32_host_normal(a) || (a & 0x80000000)) return 0;
+
+  double da = float32_to_host(a);
+  float f = (float) _mm_cvtsd_f64(_mm_sqrt_sd(_mm_setzero_pd(), _mm_set_sd(da)));
+  r = float32_from_host(f);
+  inexact |= (double) f * (double) f != da;
+  return 1;
+}
+
+BX_CPP_INLINE int float64_host_add(float64 &r, float64 a, float64 b, int &inexact)
+{
+  if (! ((float64_host_normal(a) || float64_host_zero(a)) &&
+         (float64_host_normal(b) || float64_host_zero(b)))) return 0;
+
+  double da = float64_to_host(a), db = float64_to_host(b), d = da + db;
+  r = float64_from_host(d);
+  if (! (float64_host_normal(r) || float64_host_zero(r))) return 0;
+  inexact |= host_two_sum_error(da, db, d) != 0;
+  return 1;
+}
+
+BX_CPP_INLINE int float64_host_mul(float64 &r, float64 a, float64 b, int &inexact)
+{
+  if (float64_host_zero(a) || float64_host_zero(b)) {
+    if (! (float64_host_normal(a) || float64_host_zero(a)) ||
+        ! (float64_host_normal(b) || float64_host_zero(b))) return 0;
+    r = (a ^ b) & BX_CONST64(0x8000000000000000);
+    return 1;
+  }
+  if (! float64_host_normal(a) || ! float64_host_normal(b)) return 0;
+
+  double da = float64_to_host(a), db = float64_to_host(b), d = da * db;
+  r = float64_from_host(d);
+  if (! float64_host_normal(r)) return 0;
+  inexact |= host_two_product_error(da, db, d) != 0;
+  return 1;
+}
+
+BX_CPP_INLINE int float64_host_div(float64 &r, float64 a, float64 b, int &inexact)
+{
+  if (! float64_host_normal(b)) return 0;
+  if (float64_host_zero(a)) {
+    r = (a ^ b) & BX_CONST64(0x8000000000000000);
+    return 1;
+  }
+  if (! float64_host_normal(a)) return 0;
+
+  double da = float64_to_host(a), db = float64_to_host(b), q = da / db;
+  r = float64_from_host(q);
+  if (! float64_host_normal(r)) return 0;
+  // a - q*b = (a - p) - e, where p + e = q*b exactly and a - p is exact
+  double p = q * db;
+  inexact |= (da - p) != host_two_product_error(q, db, p);
+  return 1;
+}
+
+BX_CPP_INLINE int float64_host_sqrt(float64 &r, float64 a, int &inexact)
+{
+  if (float64_host_zero(a)) {
+    r = a;
+    return 1;
+  }
+  if (! float64_host_normal(a) || (a & BX_CONST64(0x8000000000000000))) return 0;
+
+  double da = float64_to_host(a);
+  double s = _mm_cvtsd_f64(_mm_sqrt_sd(_mm_setzero_pd(), _mm_set_sd(da)));
+  r = float64_from_host(s);
+  double p = s * s;
+  inexact |= (da - p) != host_two_product_error(s, s, p);
+  return 1;
+}
+
+BX_CPP_INLINE int float32_host_sub(float32 &r, float32 a, float32 b, int &inexact)
+{
+  return float32_host_add(r, a, b ^ 0x80000000, inexact);
+}
+
+BX_CPP_INLINE int float64_host_sub(float64 &r, float64 a, float64 b, int &inexact)
+{
+  return float64_host_add(r, a, b ^ BX_CONST64(0x8000000000000000), inexact);
+}
+
+#define BX_HOST_SSE_FP_PACKED(func, host_op, elements, element)               \
+BX_CPP_INLINE int func(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status) \
+{                                                                             \
+  if (! host_fp_enabled(status)) return 0;                                    \
+                                                                              \
+  BxPackedXmmRegister result;                                                 \
+  int inexact = 0;                                                            \
+  for (unsigned n=0; n < elements; n++) {                                     \
+    if (! host_op(result.element(n), op1->element(n), op2->element(n), inexact)) \
+      return 0;                                                               \
+  }                                                                           \
+                                                                              \
+  if (inexact) float_raise(status, float_flag_inexact);                       \
+  *op1 = result;                                                              \
+  return 1;                                                                   \
+}
+
+BX_HOST_SSE_FP_PACKED(xmm_host_addps, float32_host_add, 4, xmm32u)
+BX_HOST_SSE_FP_PACKED(xmm_host_addpd, float64_host_add, 2, xmm64u)
+BX_HOST_SSE_FP_PACKED(xmm_host_subps, float32_host_sub, 4, xmm32u)
+BX_HOST_SSE_FP_PACKED(xmm_host_subpd, float64_host_sub, 2, xmm64u)
+BX_HOST_SSE_FP_PACKED(xmm_host_mulps, float32_host_mul, 4, xmm32u)
+BX_HOST_SSE_FP_PACKED(xmm_host_mulpd, float64_host_mul, 2, xmm64u)
+BX_HOST_SSE_FP_PACKED(xmm_host_divps, float32_host_div, 4, xmm32u)
+BX_HOST_SSE_FP_PACKED(xmm_host_divpd, float64_host_div, 2, xmm64u)
+
+BX_CPP_INLINE int xmm_host_sqrtps(BxPackedXmmRegister *op, float_status_t &status)
+{
+  if (! host_fp_enabled(status)) return 0;
+
+  BxPackedXmmRegister result;
+  int inexact = 0;
+  for (unsigned n=0; n < 4; n++) {
+    if (! float32_host_sqrt(result.xmm32u(n), op->xmm32u(n), inexact)) return 0;
+  }
+
+  if (inexact) float_raise(status, float_flag_inexact);
+  *op = result;
+  return 1;
+}
+
+BX_CPP_INLINE int xmm_host_sqrtpd(BxPackedXmmRegister *op, float_status_t &status)
+{
+  if (! host_fp_enabled(status)) return 0;
+
+  BxPackedXmmRegister result;
+  int inexact = 0;
+  for (unsigned n=0; n < 2; n++) {
+    if (! float64_host_sqrt(result.xmm64u(n), op->xmm64u(n), inexact)) return 0;
+  }
+
+  if (inexact) float_raise(status, float_flag_inexact);
+  *op = result;
+  return 1;
+}
+
+#endif // BX_HOST_SSE_FP
+
 // arithmetic add/sub/mul/div
 
 BX_CPP_INLINE void xmm_addps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_addps(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<4;n++) {
     op1->xmm32u(n) = float32_add(op1->xmm32u(n), op2->xmm32u(n), status);
   }
@@ -45,6 +315,10 @@ BX_CPP_INLINE void xmm_addps_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_addpd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_addpd(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<2;n++) {
     op1->xmm64u(n) = float64_add(op1->xmm64u(n), op2->xmm64u(n), status);
   }
@@ -62,6 +336,10 @@ BX_CPP_INLINE void xmm_addpd_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_subps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_subps(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<4;n++) {
     op1->xmm32u(n) = float32_sub(op1->xmm32u(n), op2->xmm32u(n), status);
   }
@@ -79,6 +357,10 @@ BX_CPP_INLINE void xmm_subps_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_subpd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_subpd(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<2;n++) {
     op1->xmm64u(n) = float64_sub(op1->xmm64u(n), op2->xmm64u(n), status);
   }
@@ -96,6 +378,10 @@ BX_CPP_INLINE void xmm_subpd_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_mulps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_mulps(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<4;n++) {
     op1->xmm32u(n) = float32_mul(op1->xmm32u(n), op2->xmm32u(n), status);
   }
@@ -113,6 +399,10 @@ BX_CPP_INLINE void xmm_mulps_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_mulpd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_mulpd(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<2;n++) {
     op1->xmm64u(n) = float64_mul(op1->xmm64u(n), op2->xmm64u(n), status);
   }
@@ -130,6 +420,10 @@ BX_CPP_INLINE void xmm_mulpd_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_divps(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_divps(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<4;n++) {
     op1->xmm32u(n) = float32_div(op1->xmm32u(n), op2->xmm32u(n), status);
   }
@@ -147,6 +441,10 @@ BX_CPP_INLINE void xmm_divps_mask(BxPackedXmmRegister *op1, const BxPackedXmmReg
 
 BX_CPP_INLINE void xmm_divpd(BxPackedXmmRegister *op1, const BxPackedXmmRegister *op2, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_divpd(op1, op2, status)) return;
+#endif
+
   for (unsigned n=0;n<2;n++) {
     op1->xmm64u(n) = float64_div(op1->xmm64u(n), op2->xmm64u(n), status);
   }
@@ -626,6 +924,10 @@ BX_CPP_INLINE void xmm_fnmsubpd_mask(BxPackedXmmRegister *op1, const BxPackedXmm
 
 BX_CPP_INLINE void xmm_sqrtps(BxPackedXmmRegister *op, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_sqrtps(op, status)) return;
+#endif
+
   for (unsigned n=0; n < 4; n++) {
     op->xmm32u(n) = float32_sqrt(op->xmm32u(n), status);
   }
@@ -643,6 +945,10 @@ BX_CPP_INLINE void xmm_sqrtps_mask(BxPackedXmmRegister *op, float_status_t &stat
 
 BX_CPP_INLINE void xmm_sqrtpd(BxPackedXmmRegister *op, float_status_t &status)
 {
+#if BX_HOST_SSE_FP
+  if (xmm_host_sqrtpd(op, status)) return;
+#endif
+
   for (unsigned n=0; n < 2; n++) {
     op->xmm64u(n) = float64_sqrt(op->xmm64u(n), status);
   }
@@ -658,6 +964,138 @@ BX_CPP_INLINE void xmm_sqrtpd_mask(BxPackedXmmRegister *op, float_status_t &stat
   }
 }
 
+// scalar arithmetic add/sub/mul/div/sqrt
+
+BX_CPP_INLINE float32 xmm_addss(float32 op1, float32 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float32 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float32_host_add(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float32_add(op1, op2, status);
+}
+
+BX_CPP_INLINE float64 xmm_addsd(float64 op1, float64 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float64 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float64_host_add(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float64_add(op1, op2, status);
+}
+
+BX_CPP_INLINE float32 xmm_subss(float32 op1, float32 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float32 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float32_host_sub(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float32_sub(op1, op2, status);
+}
+
+BX_CPP_INLINE float64 xmm_subsd(float64 op1, float64 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float64 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float64_host_sub(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float64_sub(op1, op2, status);
+}
+
+BX_CPP_INLINE float32 xmm_mulss(float32 op1, float32 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float32 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float32_host_mul(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float32_mul(op1, op2, status);
+}
+
+BX_CPP_INLINE float64 xmm_mulsd(float64 op1, float64 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float64 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float64_host_mul(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float64_mul(op1, op2, status);
+}
+
+BX_CPP_INLINE float32 xmm_divss(float32 op1, float32 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float32 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float32_host_div(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float32_div(op1, op2, status);
+}
+
+BX_CPP_INLINE float64 xmm_divsd(float64 op1, float64 op2, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float64 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float64_host_div(result, op1, op2, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float64_div(op1, op2, status);
+}
+
+BX_CPP_INLINE float32 xmm_sqrtss(float32 op, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float32 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float32_host_sqrt(result, op, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float32_sqrt(op, status);
+}
+
+BX_CPP_INLINE float64 xmm_sqrtsd(float64 op, float_status_t &status)
+{
+#if BX_HOST_SSE_FP
+  float64 result;
+  int inexact = 0;
+  if (host_fp_enabled(status) && float64_host_sqrt(result, op, inexact)) {
+    if (inexact) float_raise(status, float_flag_inexact);
+    return result;
+  }
+#endif
+  return float64_sqrt(op, status);
+}
+
 // getexp
 
 BX_CPP_INLINE void xmm_getexpps(BxPackedXmmRegister *op, float_status_t &status)
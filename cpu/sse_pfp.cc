@@ -920,7 +920,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SQRTSD_VsdWsdR(bxInstruction_c *i)
   float64 op = BX_READ_XMM_REG_LO_QWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op = float64_sqrt(op, status);
+  op = xmm_sqrtsd(op, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_QWORD(i->dst(), op);
 #endif
@@ -939,7 +939,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SQRTSS_VssWssR(bxInstruction_c *i)
   float32 op = BX_READ_XMM_REG_LO_DWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op = float32_sqrt(op, status);
+  op = xmm_sqrtss(op, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_DWORD(i->dst(), op);
 #endif
@@ -998,7 +998,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::ADDSD_VsdWsdR(bxInstruction_c *i)
   float64 op1 = BX_READ_XMM_REG_LO_QWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_QWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float64_add(op1, op2, status);
+  op1 = xmm_addsd(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_QWORD(i->dst(), op1);
 #endif
@@ -1017,7 +1017,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::ADDSS_VssWssR(bxInstruction_c *i)
   float32 op1 = BX_READ_XMM_REG_LO_DWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_DWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float32_add(op1, op2, status);
+  op1 = xmm_addss(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_DWORD(i->dst(), op1);
 #endif
@@ -1076,7 +1076,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::MULSD_VsdWsdR(bxInstruction_c *i)
   float64 op1 = BX_READ_XMM_REG_LO_QWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_QWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float64_mul(op1, op2, status);
+  op1 = xmm_mulsd(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_QWORD(i->dst(), op1);
 #endif
@@ -1095,7 +1095,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::MULSS_VssWssR(bxInstruction_c *i)
   float32 op1 = BX_READ_XMM_REG_LO_DWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_DWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float32_mul(op1, op2, status);
+  op1 = xmm_mulss(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_DWORD(i->dst(), op1);
 #endif
@@ -1154,7 +1154,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SUBSD_VsdWsdR(bxInstruction_c *i)
   float64 op1 = BX_READ_XMM_REG_LO_QWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_QWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float64_sub(op1, op2, status);
+  op1 = xmm_subsd(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_QWORD(i->dst(), op1);
 #endif
@@ -1173,7 +1173,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::SUBSS_VssWssR(bxInstruction_c *i)
   float32 op1 = BX_READ_XMM_REG_LO_DWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_DWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float32_sub(op1, op2, status);
+  op1 = xmm_subss(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_DWORD(i->dst(), op1);
 #endif
@@ -1310,7 +1310,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::DIVSD_VsdWsdR(bxInstruction_c *i)
   float64 op1 = BX_READ_XMM_REG_LO_QWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_QWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float64_div(op1, op2, status);
+  op1 = xmm_divsd(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_QWORD(i->dst(), op1);
 #endif
@@ -1329,7 +1329,7 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::DIVSS_VssWssR(bxInstruction_c *i)
   float32 op1 = BX_READ_XMM_REG_LO_DWORD(i->dst()), op2 = BX_READ_XMM_REG_LO_DWORD(i->src());
 
   float_status_t status = mxcsr_to_softfloat_status_word(MXCSR);
-  op1 = float32_div(op1, op2, status);
+  op1 = xmm_divss(op1, op2, status);
   check_exceptionsSSE(get_exception_flags(status));
   BX_WRITE_XMM_REG_LO_DWORD(i->dst(), op1);
 #endif
@@ -29,435 +29,327 @@
 //
 
 #if BX_SUPPORT_REPEAT_SPEEDUPS
-Bit32u BX_CPU_C::FastRepMOVSB(bxInstruction_c *i, unsigned srcSeg, Bit32u srcOff, unsigned dstSeg, Bit32u dstOff, Bit32u count)
-{
-  Bit32u bytesFitSrc, bytesFitDst;
-  signed int pointerDelta;
-  bx_address laddrDst, laddrSrc;
-  Bit8u *hostAddrSrc, *hostAddrDst;
-
-  BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
-
-  bx_segment_reg_t *srcSegPtr = &BX_CPU_THIS_PTR sregs[srcSeg];
-  if (srcSegPtr->cache.valid & SegAccessROK4G) {
-    laddrSrc = srcOff;
-  }
-  else {
-    if (!(srcSegPtr->cache.valid & SegAccessROK))
-      return 0;
-    if ((srcOff | 0xfff) > srcSegPtr->cache.u.segment.limit_scaled)
-      return 0;
 
-    laddrSrc = get_laddr32(srcSeg, srcOff);
-  }
-
-  hostAddrSrc = v2h_read_byte(laddrSrc, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (! hostAddrSrc) return 0;
-
-  bx_segment_reg_t *dstSegPtr = &BX_CPU_THIS_PTR sregs[dstSeg];
-  if (dstSegPtr->cache.valid & SegAccessWOK4G) {
-    laddrDst = dstOff;
-  }
-  else {
-    if (!(dstSegPtr->cache.valid & SegAccessWOK))
-      return 0;
-    if ((dstOff | 0xfff) > dstSegPtr->cache.u.segment.limit_scaled)
-      return 0;
-
-    laddrDst = get_laddr32(dstSeg, dstOff);
-  }
-
-  hostAddrDst = v2h_write_byte(laddrDst, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (!hostAddrDst) return 0;
-
-  // See how many bytes can fit in the rest of this page.
-  if (BX_CPU_THIS_PTR get_DF()) {
-    // Counting downward.
-    bytesFitSrc = 1 + PAGE_OFFSET(laddrSrc);
-    bytesFitDst = 1 + PAGE_OFFSET(laddrDst);
-    pointerDelta = (signed int) -1;
-  }
-  else {
-    // Counting upward.
-    bytesFitSrc = 0x1000 - PAGE_OFFSET(laddrSrc);
-    bytesFitDst = 0x1000 - PAGE_OFFSET(laddrDst);
-    pointerDelta = (signed int)  1;
+// Translate seg:offset of a string instruction element to host address.
+// NULL is returned when the rest of the page cannot be accessed directly.
+Bit8u* BX_CPU_C::FastRepHostAddr(unsigned s, bx_address offset, unsigned rw, bx_address *laddr)
+{
+#if BX_SUPPORT_X86_64
+  if (BX_CPU_THIS_PTR cpu_mode == BX_MODE_LONG_64) {
+    *laddr = get_laddr64(s, offset);
+    if (! IsCanonical(*laddr)) return 0;
   }
+  else
+#endif
+  {
+    bx_segment_reg_t *seg = &BX_CPU_THIS_PTR sregs[s];
+    unsigned accessOK4G = (rw == BX_READ) ? SegAccessROK4G : SegAccessWOK4G;
+    unsigned accessOK   = (rw == BX_READ) ? SegAccessROK   : SegAccessWOK;
 
-  // Restrict word count to the number that will fit in either
-  // source or dest pages.
-  if (count > bytesFitSrc)
-    count = bytesFitSrc;
-  if (count > bytesFitDst)
-    count = bytesFitDst;
-  if (count > bx_pc_system.getNumCpuTicksLeftNextEvent())
-    count = bx_pc_system.getNumCpuTicksLeftNextEvent();
-
-  // If after all the restrictions, there is anything left to do...
-  if (count) {
-    // Transfer data directly using host addresses
-    for (unsigned j=0; j<count; j++) {
-      * (Bit8u *) hostAddrDst = * (Bit8u *) hostAddrSrc;
-      hostAddrDst += pointerDelta;
-      hostAddrSrc += pointerDelta;
+    if (seg->cache.valid & accessOK4G) {
+      *laddr = (Bit32u) offset;
     }
+    else {
+      if (!(seg->cache.valid & accessOK))
+        return 0;
+      if ((offset | 0xfff) > seg->cache.u.segment.limit_scaled)
+        return 0;
 
-    return count;
+      *laddr = get_laddr32(s, (Bit32u) offset);
+    }
   }
 
-  return 0;
+  // Check that native host access was not vetoed for that page,
+  // v2h_write_byte also updates SMC write stamps of the page
+  if (rw == BX_READ)
+    return v2h_read_byte(*laddr, USER_PL);
+  else
+    return v2h_write_byte(*laddr, USER_PL);
 }
 
-Bit32u BX_CPU_C::FastRepMOVSW(bxInstruction_c *i, unsigned srcSeg, Bit32u srcOff, unsigned dstSeg, Bit32u dstOff, Bit32u count)
+// See how many elements of 'len' bytes fit in the rest of the page
+BX_CPP_INLINE Bit32u FastRepElementsFit(bx_address laddr, unsigned len, bx_bool df)
 {
-  Bit32u wordsFitSrc, wordsFitDst;
-  signed int pointerDelta;
-  bx_address laddrDst, laddrSrc;
-  Bit8u *hostAddrSrc, *hostAddrDst;
+  Bit32u pageOffset = PAGE_OFFSET(laddr);
 
-  BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
+  // Note: 1st element must not cross page boundary.
+  if (pageOffset > (0x1000 - len)) return 0;
 
-  bx_segment_reg_t *srcSegPtr = &BX_CPU_THIS_PTR sregs[srcSeg];
-  if (srcSegPtr->cache.valid & SegAccessROK4G) {
-    laddrSrc = srcOff;
-  }
-  else {
-    if (!(srcSegPtr->cache.valid & SegAccessROK))
-      return 0;
-    if ((srcOff | 0xfff) > srcSegPtr->cache.u.segment.limit_scaled)
-      return 0;
+  if (df)
+    return (pageOffset + len) / len; // counting downward
+  else
+    return (0x1000 - pageOffset) / len; // counting upward
+}
 
-    laddrSrc = get_laddr32(srcSeg, srcOff);
+BX_CPP_INLINE Bit64u FastRepReadHostElement(const Bit8u *hostAddr, unsigned len)
+{
+  switch(len) {
+  case 1:
+    return *hostAddr;
+  case 2:
+    {
+      Bit16u val16;
+      ReadHostWordFromLittleEndian((Bit16u*) hostAddr, val16);
+      return val16;
+    }
+  case 4:
+    {
+      Bit32u val32;
+      ReadHostDWordFromLittleEndian((Bit32u*) hostAddr, val32);
+      return val32;
+    }
+  default:
+    {
+      Bit64u val64;
+      ReadHostQWordFromLittleEndian((Bit64u*) hostAddr, val64);
+      return val64;
+    }
   }
+}
 
-  hostAddrSrc = v2h_read_byte(laddrSrc, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (! hostAddrSrc) return 0;
+// The fast string methods below process in a batch all but the last
+// iteration of a repeated string instruction, as long as the elements are
+// located in a single page (for each of the operands) with direct host
+// access. RSI/RDI/RCX and the system time are updated for the iterations
+// done, the instruction handler executes the next iteration as usual.
+// This way flags and termination conditions are always computed by the
+// regular code, and the batch never ends the repeat loop by itself.
 
-  bx_segment_reg_t *dstSegPtr = &BX_CPU_THIS_PTR sregs[dstSeg];
-  if (dstSegPtr->cache.valid & SegAccessWOK4G) {
-    laddrDst = dstOff;
-  }
-  else {
-    if (!(dstSegPtr->cache.valid & SegAccessWOK))
-      return 0;
-    if ((dstOff | 0xfff) > dstSegPtr->cache.u.segment.limit_scaled)
-      return 0;
-
-    laddrDst = get_laddr32(dstSeg, dstOff);
-  }
+Bit32u BX_CPU_C::FastRepCount(bxInstruction_c *i)
+{
+  bx_address count;
 
-  hostAddrDst = v2h_write_byte(laddrDst, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (!hostAddrDst) return 0;
+#if BX_SUPPORT_X86_64
+  if (i->as64L())
+    count = RCX;
+  else
+#endif
+    count = ECX;
 
-  // See how many words can fit in the rest of this page.
-  if (BX_CPU_THIS_PTR get_DF()) {
-    // Counting downward.
-    // Note: 1st word must not cross page boundary.
-    if (((laddrSrc & 0xfff) > 0xffe) || ((laddrDst & 0xfff) > 0xffe))
-       return 0;
-    wordsFitSrc = (2 + PAGE_OFFSET(laddrSrc)) >> 1;
-    wordsFitDst = (2 + PAGE_OFFSET(laddrDst)) >> 1;
-    pointerDelta = (signed int) -2;
-  }
-  else {
-    // Counting upward.
-    wordsFitSrc = (0x1000 - PAGE_OFFSET(laddrSrc)) >> 1;
-    wordsFitDst = (0x1000 - PAGE_OFFSET(laddrDst)) >> 1;
-    pointerDelta = (signed int)  2;
-  }
+  // keep the last iteration for the instruction handler
+  if (count <= 1) return 0;
+  count--;
 
-  // Restrict word count to the number that will fit in either
-  // source or dest pages.
-  if (count > wordsFitSrc)
-    count = wordsFitSrc;
-  if (count > wordsFitDst)
-    count = wordsFitDst;
-  if (count > bx_pc_system.getNumCpuTicksLeftNextEvent())
-    count = bx_pc_system.getNumCpuTicksLeftNextEvent();
-
-  // If after all the restrictions, there is anything left to do...
-  if (count) {
-    // Transfer data directly using host addresses
-    for (unsigned j=0; j<count; j++) {
-      CopyHostWordLittleEndian(hostAddrDst, hostAddrSrc);
-      hostAddrDst += pointerDelta;
-      hostAddrSrc += pointerDelta;
-    }
+  // the timer event must not be crossed by the batch
+  Bit32u ticksLeft = bx_pc_system.getNumCpuTicksLeftNextEvent();
+  if (ticksLeft <= 1) return 0;
+  if (count > ticksLeft - 1)
+    count = ticksLeft - 1;
 
-    return count;
-  }
+  // page at a time
+  if (count > 0x1000)
+    count = 0x1000;
 
-  return 0;
+  return (Bit32u) count;
 }
 
-Bit32u BX_CPU_C::FastRepMOVSD(bxInstruction_c *i, unsigned srcSeg, Bit32u srcOff, unsigned dstSeg, Bit32u dstOff, Bit32u count)
+void BX_CPU_C::FastRepUpdate(bxInstruction_c *i, Bit32u count, unsigned len, bx_bool src)
 {
-  Bit32u dwordsFitSrc, dwordsFitDst;
-  signed int pointerDelta;
-  bx_address laddrDst, laddrSrc;
-  Bit8u *hostAddrSrc, *hostAddrDst;
+  // Decrement the ticks count and rCX by the number of iterations done,
+  // the main repeat loop will account for the last one
+  BX_TICKN(count);
 
-  BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
+  bx_address delta = (bx_address) count * len;
+  if (BX_CPU_THIS_PTR get_DF())
+    delta = 0 - delta;
 
-  bx_segment_reg_t *srcSegPtr = &BX_CPU_THIS_PTR sregs[srcSeg];
-  if (srcSegPtr->cache.valid & SegAccessROK4G) {
-    laddrSrc = srcOff;
+#if BX_SUPPORT_X86_64
+  if (i->as64L()) {
+    RCX -= count;
+    RDI += delta;
+    if (src) RSI += delta;
   }
-  else {
-    if (!(srcSegPtr->cache.valid & SegAccessROK))
-      return 0;
-    if ((srcOff | 0xfff) > srcSegPtr->cache.u.segment.limit_scaled)
-      return 0;
-
-    laddrSrc = get_laddr32(srcSeg, srcOff);
+  else
+#endif
+  {
+    // zero extension of RSI/RDI/RCX
+    RCX = ECX - count;
+    RDI = (Bit32u) (EDI + delta);
+    if (src) RSI = (Bit32u) (ESI + delta);
   }
+}
 
-  hostAddrSrc = v2h_read_byte(laddrSrc, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (! hostAddrSrc) return 0;
+void BX_CPU_C::FastRepMOVS(bxInstruction_c *i, unsigned len)
+{
+  Bit32u count = FastRepCount(i);
+  if (! count) return;
 
-  bx_segment_reg_t *dstSegPtr = &BX_CPU_THIS_PTR sregs[dstSeg];
-  if (dstSegPtr->cache.valid & SegAccessWOK4G) {
-    laddrDst = dstOff;
-  }
-  else {
-    if (!(dstSegPtr->cache.valid & SegAccessWOK))
-      return 0;
-    if ((dstOff | 0xfff) > dstSegPtr->cache.u.segment.limit_scaled)
-      return 0;
+  bx_address laddrSrc, laddrDst;
+  bx_bool df = BX_CPU_THIS_PTR get_DF();
 
-    laddrDst = get_laddr32(dstSeg, dstOff);
-  }
+  Bit8u *hostAddrSrc = FastRepHostAddr(i->seg(), i->as64L() ? RSI : ESI, BX_READ, &laddrSrc);
+  if (! hostAddrSrc) return;
 
-  hostAddrDst = v2h_write_byte(laddrDst, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (!hostAddrDst) return 0;
+  Bit8u *hostAddrDst = FastRepHostAddr(BX_SEG_REG_ES, i->as64L() ? RDI : EDI, BX_WRITE, &laddrDst);
+  if (! hostAddrDst) return;
 
-  // See how many dwords can fit in the rest of this page.
-  if (BX_CPU_THIS_PTR get_DF()) {
-    // Counting downward.
-    // Note: 1st dword must not cross page boundary.
-    if (((laddrSrc & 0xfff) > 0xffc) || ((laddrDst & 0xfff) > 0xffc))
-      return 0;
-    dwordsFitSrc = (4 + PAGE_OFFSET(laddrSrc)) >> 2;
-    dwordsFitDst = (4 + PAGE_OFFSET(laddrDst)) >> 2;
-    pointerDelta = (signed int) -4;
+  // Restrict element count to the number that will fit in either
+  // source or dest pages.
+  count = BX_MIN(count, FastRepElementsFit(laddrSrc, len, df));
+  count = BX_MIN(count, FastRepElementsFit(laddrDst, len, df));
+  if (! count) return;
+
+  Bit32u bytes = count * len;
+  if (df) {
+    // counting downward, point to the lowest element
+    hostAddrSrc -= bytes - len;
+    hostAddrDst -= bytes - len;
+  }
+
+  // Copying the whole block at once gives the same result as element by
+  // element copy unless the destination overlaps part of the source
+  // which is not copied yet.
+  if (df ? (hostAddrDst >= hostAddrSrc || hostAddrDst + bytes <= hostAddrSrc)
+         : (hostAddrDst <= hostAddrSrc || hostAddrDst >= hostAddrSrc + bytes))
+  {
+    memmove(hostAddrDst, hostAddrSrc, bytes);
   }
   else {
-    // Counting upward.
-    dwordsFitSrc = (0x1000 - PAGE_OFFSET(laddrSrc)) >> 2;
-    dwordsFitDst = (0x1000 - PAGE_OFFSET(laddrDst)) >> 2;
-    pointerDelta = (signed int)  4;
-  }
-
-  // Restrict dword count to the number that will fit in either
-  // source or dest pages.
-  if (count > dwordsFitSrc)
-    count = dwordsFitSrc;
-  if (count > dwordsFitDst)
-    count = dwordsFitDst;
-  if (count > bx_pc_system.getNumCpuTicksLeftNextEvent())
-    count = bx_pc_system.getNumCpuTicksLeftNextEvent();
-
-  // If after all the restrictions, there is anything left to do...
-  if (count) {
-    // Transfer data directly using host addresses
-    for (unsigned j=0; j<count; j++) {
-      CopyHostDWordLittleEndian(hostAddrDst, hostAddrSrc);
-      hostAddrDst += pointerDelta;
-      hostAddrSrc += pointerDelta;
+    // overlapping forward copy used to replicate a pattern (or backward
+    // equivalent), transfer element by element in the right order
+    if (df) {
+      for (int j=count-1; j>=0; j--)
+        memmove(hostAddrDst + j*len, hostAddrSrc + j*len, len);
+    }
+    else {
+      for (unsigned j=0; j<count; j++)
+        memmove(hostAddrDst + j*len, hostAddrSrc + j*len, len);
     }
-
-    return count;
   }
 
-  return 0;
+  FastRepUpdate(i, count, len, 1);
 }
 
-Bit32u BX_CPU_C::FastRepSTOSB(bxInstruction_c *i, unsigned dstSeg, Bit32u dstOff, Bit8u val, Bit32u count)
+void BX_CPU_C::FastRepSTOS(bxInstruction_c *i, unsigned len)
 {
-  Bit32u bytesFitDst;
-  signed int pointerDelta;
+  Bit32u count = FastRepCount(i);
+  if (! count) return;
+
   bx_address laddrDst;
-  Bit8u *hostAddrDst;
+  bx_bool df = BX_CPU_THIS_PTR get_DF();
 
-  BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
+  Bit8u *hostAddrDst = FastRepHostAddr(BX_SEG_REG_ES, i->as64L() ? RDI : EDI, BX_WRITE, &laddrDst);
+  if (! hostAddrDst) return;
 
-  bx_segment_reg_t *dstSegPtr = &BX_CPU_THIS_PTR sregs[dstSeg];
-  if (dstSegPtr->cache.valid & SegAccessWOK4G) {
-    laddrDst = dstOff;
-  }
-  else {
-    if (!(dstSegPtr->cache.valid & SegAccessWOK))
-      return 0;
-    if ((dstOff | 0xfff) > dstSegPtr->cache.u.segment.limit_scaled)
-      return 0;
+  count = BX_MIN(count, FastRepElementsFit(laddrDst, len, df));
+  if (! count) return;
 
-    laddrDst = get_laddr32(dstSeg, dstOff);
+  Bit32u bytes = count * len;
+  if (df) {
+    // counting downward, point to the lowest element
+    hostAddrDst -= bytes - len;
   }
 
-  hostAddrDst = v2h_write_byte(laddrDst, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (!hostAddrDst) return 0;
+  Bit64u val = RAX, pattern = BX_CONST64(0x0101010101010101) * (Bit8u) val;
+  if (len < 8) {
+    val     &= (BX_CONST64(1) << (len*8)) - 1;
+    pattern &= (BX_CONST64(1) << (len*8)) - 1;
+  }
 
-  // See how many bytes can fit in the rest of this page.
-  if (BX_CPU_THIS_PTR get_DF()) {
-    // Counting downward.
-    bytesFitDst = 1 + PAGE_OFFSET(laddrDst);
-    pointerDelta = (signed int) -1;
+  if (val == pattern) {
+    // all bytes of the stored value are equal (always true for STOSB)
+    memset(hostAddrDst, (Bit8u) val, bytes);
   }
   else {
-    // Counting upward.
-    bytesFitDst = 0x1000 - PAGE_OFFSET(laddrDst);
-    pointerDelta = (signed int)  1;
-  }
-
-  // Restrict word count to the number that will fit in either
-  // source or dest pages.
-  if (count > bytesFitDst)
-    count = bytesFitDst;
-  if (count > bx_pc_system.getNumCpuTicksLeftNextEvent())
-    count = bx_pc_system.getNumCpuTicksLeftNextEvent();
-
-  // If after all the restrictions, there is anything left to do...
-  if (count) {
-    // Transfer data directly using host addresses
-    for (unsigned j=0; j<count; j++) {
-      * (Bit8u *) hostAddrDst = val;
-      hostAddrDst += pointerDelta;
+    for (unsigned j=0; j<bytes; j+=len) {
+      switch(len) {
+      case 2:
+        WriteHostWordToLittleEndian((Bit16u*)(hostAddrDst + j), (Bit16u) val);
+        break;
+      case 4:
+        WriteHostDWordToLittleEndian((Bit32u*)(hostAddrDst + j), (Bit32u) val);
+        break;
+      default:
+        WriteHostQWordToLittleEndian((Bit64u*)(hostAddrDst + j), val);
+        break;
+      }
     }
-
-    return count;
   }
 
-  return 0;
+  FastRepUpdate(i, count, len, 0);
 }
 
-Bit32u BX_CPU_C::FastRepSTOSW(bxInstruction_c *i, unsigned dstSeg, Bit32u dstOff, Bit16u val, Bit32u count)
+void BX_CPU_C::FastRepSCAS(bxInstruction_c *i, unsigned len)
 {
-  Bit32u wordsFitDst;
-  signed int pointerDelta;
+  Bit32u count = FastRepCount(i);
+  if (! count) return;
+
   bx_address laddrDst;
-  Bit8u *hostAddrDst;
+  bx_bool df = BX_CPU_THIS_PTR get_DF();
 
-  BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
+  Bit8u *hostAddrDst = FastRepHostAddr(BX_SEG_REG_ES, i->as64L() ? RDI : EDI, BX_READ, &laddrDst);
+  if (! hostAddrDst) return;
 
-  bx_segment_reg_t *dstSegPtr = &BX_CPU_THIS_PTR sregs[dstSeg];
-  if (dstSegPtr->cache.valid & SegAccessWOK4G) {
-    laddrDst = dstOff;
-  }
-  else {
-    if (!(dstSegPtr->cache.valid & SegAccessWOK))
-      return 0;
-    if ((dstOff | 0xfff) > dstSegPtr->cache.u.segment.limit_scaled)
-      return 0;
+  count = BX_MIN(count, FastRepElementsFit(laddrDst, len, df));
+  if (! count) return;
 
-    laddrDst = get_laddr32(dstSeg, dstOff);
-  }
+  Bit64u val = RAX;
+  if (len < 8) val &= (BX_CONST64(1) << (len*8)) - 1;
 
-  hostAddrDst = v2h_write_byte(laddrDst, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (!hostAddrDst) return 0;
+  // REPE continues while the element is equal to rAX, REPNE while not
+  bx_bool repe = (i->lockRepUsedValue() == 3);
+  Bit32u n;
 
-  // See how many words can fit in the rest of this page.
-  if (BX_CPU_THIS_PTR get_DF()) {
-    // Counting downward.
-    // Note: 1st word must not cross page boundary.
-    if ((laddrDst & 0xfff) > 0xffe) return 0;
-    wordsFitDst = (2 + PAGE_OFFSET(laddrDst)) >> 1;
-    pointerDelta = (signed int) -2;
+  if (len == 1 && !df && !repe) {
+    // REPNE SCASB is strlen/memchr
+    Bit8u *match = (Bit8u*) memchr(hostAddrDst, (Bit8u) val, count);
+    n = match ? (Bit32u)(match - hostAddrDst) : count;
   }
   else {
-    // Counting upward.
-    wordsFitDst = (0x1000 - PAGE_OFFSET(laddrDst)) >> 1;
-    pointerDelta = (signed int)  2;
-  }
-
-  // Restrict word count to the number that will fit in either
-  // source or dest pages.
-  if (count > wordsFitDst)
-    count = wordsFitDst;
-  if (count > bx_pc_system.getNumCpuTicksLeftNextEvent())
-    count = bx_pc_system.getNumCpuTicksLeftNextEvent();
-
-  // If after all the restrictions, there is anything left to do...
-  if (count) {
-    // Transfer data directly using host addresses
-    for (unsigned j=0; j<count; j++) {
-      WriteHostWordToLittleEndian(hostAddrDst, val);
-      hostAddrDst += pointerDelta;
+    int delta = df ? -(int)len : (int)len;
+    for (n=0; n<count; n++, hostAddrDst += delta) {
+      if ((FastRepReadHostElement(hostAddrDst, len) == val) != repe) break;
     }
-
-    return count;
   }
 
-  return 0;
+  // elements which do not terminate the loop, the next one is compared
+  // by the instruction handler
+  if (n) FastRepUpdate(i, n, len, 0);
 }
 
-Bit32u BX_CPU_C::FastRepSTOSD(bxInstruction_c *i, unsigned dstSeg, Bit32u dstOff, Bit32u val, Bit32u count)
+void BX_CPU_C::FastRepCMPS(bxInstruction_c *i, unsigned len)
 {
-  Bit32u dwordsFitDst;
-  signed int pointerDelta;
-  bx_address laddrDst;
-  Bit8u *hostAddrDst;
+  Bit32u count = FastRepCount(i);
+  if (! count) return;
 
-  BX_ASSERT(BX_CPU_THIS_PTR cpu_mode != BX_MODE_LONG_64);
+  bx_address laddrSrc, laddrDst;
+  bx_bool df = BX_CPU_THIS_PTR get_DF();
 
-  bx_segment_reg_t *dstSegPtr = &BX_CPU_THIS_PTR sregs[dstSeg];
-  if (dstSegPtr->cache.valid & SegAccessWOK4G) {
-    laddrDst = dstOff;
-  }
-  else {
-    if (!(dstSegPtr->cache.valid & SegAccessWOK))
-      return 0;
-    if ((dstOff | 0xfff) > dstSegPtr->cache.u.segment.limit_scaled)
-      return 0;
+  Bit8u *hostAddrSrc = FastRepHostAddr(i->seg(), i->as64L() ? RSI : ESI, BX_READ, &laddrSrc);
+  if (! hostAddrSrc) return;
 
-    laddrDst = get_laddr32(dstSeg, dstOff);
-  }
+  Bit8u *hostAddrDst = FastRepHostAddr(BX_SEG_REG_ES, i->as64L() ? RDI : EDI, BX_READ, &laddrDst);
+  if (! hostAddrDst) return;
 
-  hostAddrDst = v2h_write_byte(laddrDst, USER_PL);
-  // Check that native host access was not vetoed for that page
-  if (!hostAddrDst) return 0;
+  count = BX_MIN(count, FastRepElementsFit(laddrSrc, len, df));
+  count = BX_MIN(count, FastRepElementsFit(laddrDst, len, df));
+  if (! count) return;
 
-  // See how many dwords can fit in the rest of this page.
-  if (BX_CPU_THIS_PTR get_DF()) {
-    // Counting downward.
-    // Note: 1st dword must not cross page boundary.
-    if ((laddrDst & 0xfff) > 0xffc) return 0;
-    dwordsFitDst = (4 + PAGE_OFFSET(laddrDst)) >> 2;
-    pointerDelta = (signed int) -4;
-  }
-  else {
-    // Counting upward.
-    dwordsFitDst = (0x1000 - PAGE_OFFSET(laddrDst)) >> 2;
-    pointerDelta = (signed int)  4;
+  // REPE continues while the elements are equal, REPNE while not
+  bx_bool repe = (i->lockRepUsedValue() == 3);
+  Bit32u n = 0;
+
+  if (repe) {
+    // REPE CMPS is memcmp, check the whole block for the common case
+    Bit32u bytes = count * len;
+    if (! memcmp(df ? hostAddrSrc - (bytes - len) : hostAddrSrc,
+                 df ? hostAddrDst - (bytes - len) : hostAddrDst, bytes))
+      n = count;
   }
 
-  // Restrict dword count to the number that will fit in either
-  // source or dest pages.
-  if (count > dwordsFitDst)
-    count = dwordsFitDst;
-  if (count > bx_pc_system.getNumCpuTicksLeftNextEvent())
-    count = bx_pc_system.getNumCpuTicksLeftNextEvent();
-
-  // If after all the restrictions, there is anything left to do...
-  if (count) {
-    // Transfer data directly using host addresses
-    for (unsigned j=0; j<count; j++) {
-      WriteHostDWordToLittleEndian(hostAddrDst, val);
-      hostAddrDst += pointerDelta;
+  if (! n) {
+    int delta = df ? -(int)len : (int)len;
+    for (; n<count; n++, hostAddrSrc += delta, hostAddrDst += delta) {
+      bx_bool equal = ! memcmp(hostAddrSrc, hostAddrDst, len);
+      if (equal != repe) break;
     }
-
-    return count;
   }
 
-  return 0;
+  // elements which do not terminate the loop, the next one is compared
+  // by the instruction handler
+  if (n) FastRepUpdate(i, n, len, 1);
 }
+
 #endif
 
 //
@@ -564,47 +456,31 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSB32_YbXb(bxInstruction_c *i)
 {
   Bit8u temp8;
 
-  Bit32u incr = 1;
-
 #if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
-  /* If conditions are right, we can transfer IO to physical memory
-   * in a batch, rather than one instruction at a time */
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
   if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
-  {
-    Bit32u byteCount = FastRepMOVSB(i, i->seg(), ESI, BX_SEG_REG_ES, EDI, ECX);
-    if (byteCount) {
-      // Decrement the ticks count by the number of iterations, minus
-      // one, since the main cpu loop will decrement one.  Also,
-      // the count is predecremented before examined, so defintely
-      // don't roll it under zero.
-      BX_TICKN(byteCount-1);
-
-      // Decrement eCX. Note, the main loop will decrement 1 also, so
-      // decrement by one less than expected, like the case above.
-      RCX = ECX - (byteCount-1);
-
-      incr = byteCount;
-    }
-    else {
-      temp8 = read_virtual_byte(i->seg(), ESI);
-      write_virtual_byte(BX_SEG_REG_ES, EDI, temp8);
-    }
-  }
-  else
+    FastRepMOVS(i, 1);
 #endif
-  {
-    temp8 = read_virtual_byte(i->seg(), ESI);
-    write_virtual_byte(BX_SEG_REG_ES, EDI, temp8);
-  }
+
+  Bit32u esi = ESI;
+  Bit32u edi = EDI;
+
+  temp8 = read_virtual_byte(i->seg(), esi);
+  write_virtual_byte(BX_SEG_REG_ES, edi, temp8);
 
   if (BX_CPU_THIS_PTR get_DF()) {
-    RSI = ESI - incr;
-    RDI = EDI - incr;
+    esi--;
+    edi--;
   }
   else {
-    RSI = ESI + incr;
-    RDI = EDI + incr;
+    esi++;
+    edi++;
   }
+
+  // zero extension of RSI/RDI
+  RSI = esi;
+  RDI = edi;
 }
 
 #if BX_SUPPORT_X86_64
@@ -613,6 +489,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSB64_YbXb(bxInstruction_c *i)
 {
   Bit8u temp8;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 1);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -664,6 +547,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSW32_YwXw(bxInstruction_c *i)
 {
   Bit16u temp16;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 2);
+#endif
+
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
@@ -690,6 +580,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSW64_YwXw(bxInstruction_c *i)
 {
   Bit16u temp16;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 2);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -739,50 +636,26 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSD32_YdXd(bxInstruction_c *i)
 {
   Bit32u temp32;
 
-  Bit32u incr = 4;
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 4);
+#endif
 
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
-#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
-  /* If conditions are right, we can transfer IO to physical memory
-   * in a batch, rather than one instruction at a time.
-   */
-  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
-  {
-    Bit32u dwordCount = FastRepMOVSD(i, i->seg(), esi, BX_SEG_REG_ES, edi, ECX);
-    if (dwordCount) {
-      // Decrement the ticks count by the number of iterations, minus
-      // one, since the main cpu loop will decrement one.  Also,
-      // the count is predecremented before examined, so defintely
-      // don't roll it under zero.
-      BX_TICKN(dwordCount-1);
-
-      // Decrement eCX. Note, the main loop will decrement 1 also, so
-      // decrement by one less than expected, like the case above.
-      RCX = ECX - (dwordCount-1);
-
-      incr = dwordCount << 2; // count * 4
-    }
-    else {
-      temp32 = read_virtual_dword(i->seg(), esi);
-      write_virtual_dword(BX_SEG_REG_ES, edi, temp32);
-    }
-  }
-  else
-#endif
-  {
-    temp32 = read_virtual_dword(i->seg(), esi);
-    write_virtual_dword(BX_SEG_REG_ES, edi, temp32);
-  }
+  temp32 = read_virtual_dword(i->seg(), esi);
+  write_virtual_dword(BX_SEG_REG_ES, edi, temp32);
 
   if (BX_CPU_THIS_PTR get_DF()) {
-    esi -= incr;
-    edi -= incr;
+    esi -= 4;
+    edi -= 4;
   }
   else {
-    esi += incr;
-    edi += incr;
+    esi += 4;
+    edi += 4;
   }
 
   // zero extension of RSI/RDI
@@ -797,6 +670,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSD64_YdXd(bxInstruction_c *i)
 {
   Bit32u temp32;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 4);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -821,6 +701,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSQ32_YqXq(bxInstruction_c *i)
 {
   Bit64u temp64;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 8);
+#endif
+
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
@@ -846,6 +733,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::MOVSQ64_YqXq(bxInstruction_c *i)
 {
   Bit64u temp64;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepMOVS(i, 8);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -984,6 +878,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSB32_XbYb(bxInstruction_c *i)
 {
   Bit8u op1_8, op2_8, diff_8;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 1);
+#endif
+
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
@@ -1014,6 +915,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSB64_XbYb(bxInstruction_c *i)
 {
   Bit8u op1_8, op2_8, diff_8;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 1);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -1071,6 +979,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSW32_XwYw(bxInstruction_c *i)
 {
   Bit16u op1_16, op2_16, diff_16;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 2);
+#endif
+
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
@@ -1101,6 +1016,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSW64_XwYw(bxInstruction_c *i)
 {
   Bit16u op1_16, op2_16, diff_16;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 2);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -1158,6 +1080,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSD32_XdYd(bxInstruction_c *i)
 {
   Bit32u op1_32, op2_32, diff_32;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 4);
+#endif
+
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
@@ -1189,6 +1118,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSD64_XdYd(bxInstruction_c *i)
 {
   Bit32u op1_32, op2_32, diff_32;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 4);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -1217,6 +1153,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSQ32_XqYq(bxInstruction_c *i)
 {
   Bit64u op1_64, op2_64, diff_64;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 8);
+#endif
+
   Bit32u esi = ESI;
   Bit32u edi = EDI;
 
@@ -1246,6 +1189,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::CMPSQ64_XqYq(bxInstruction_c *i)
 {
   Bit64u op1_64, op2_64, diff_64;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepCMPS(i, 8);
+#endif
+
   Bit64u rsi = RSI;
   Bit64u rdi = RDI;
 
@@ -1379,6 +1329,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASB32_ALYb(bxInstruction_c *i)
 {
   Bit8u op1_8 = AL, op2_8, diff_8;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 1);
+#endif
+
   Bit32u edi = EDI;
 
   op2_8 = read_virtual_byte(BX_SEG_REG_ES, edi);
@@ -1403,6 +1360,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASB64_ALYb(bxInstruction_c *i)
 {
   Bit8u op1_8 = AL, op2_8, diff_8;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 1);
+#endif
+
   Bit64u rdi = RDI;
 
   op2_8 = read_virtual_byte(BX_SEG_REG_ES, rdi);
@@ -1449,6 +1413,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASW32_AXYw(bxInstruction_c *i)
 {
   Bit16u op1_16 = AX, op2_16, diff_16;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 2);
+#endif
+
   Bit32u edi = EDI;
 
   op2_16 = read_virtual_word(BX_SEG_REG_ES, edi);
@@ -1473,6 +1444,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASW64_AXYw(bxInstruction_c *i)
 {
   Bit16u op1_16 = AX, op2_16, diff_16;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 2);
+#endif
+
   Bit64u rdi = RDI;
 
   op2_16 = read_virtual_word(BX_SEG_REG_ES, rdi);
@@ -1519,6 +1497,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASD32_EAXYd(bxInstruction_c *i)
 {
   Bit32u op1_32 = EAX, op2_32, diff_32;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 4);
+#endif
+
   Bit32u edi = EDI;
 
   op2_32 = read_virtual_dword(BX_SEG_REG_ES, edi);
@@ -1544,6 +1529,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASD64_EAXYd(bxInstruction_c *i)
 {
   Bit32u op1_32 = EAX, op2_32, diff_32;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 4);
+#endif
+
   Bit64u rdi = RDI;
 
   op2_32 = read_virtual_dword(BX_SEG_REG_ES, rdi);
@@ -1567,6 +1559,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASQ32_RAXYq(bxInstruction_c *i)
 {
   Bit64u op1_64 = RAX, op2_64, diff_64;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 8);
+#endif
+
   Bit32u edi = EDI;
 
   op2_64 = read_virtual_qword(BX_SEG_REG_ES, edi);
@@ -1591,6 +1590,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::SCASQ64_RAXYq(bxInstruction_c *i)
 {
   Bit64u op1_64 = RAX, op2_64, diff_64;
 
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSCAS(i, 8);
+#endif
+
   Bit64u rdi = RDI;
 
   op2_64 = read_virtual_qword(BX_SEG_REG_ES, rdi);
@@ -1708,44 +1714,22 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSB16_YbAL(bxInstruction_c *i)
 // 32 bit address size
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSB32_YbAL(bxInstruction_c *i)
 {
-  Bit32u incr = 1;
-  Bit32u edi = EDI;
-
 #if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
-  /* If conditions are right, we can transfer IO to physical memory
-   * in a batch, rather than one instruction at a time.
-   */
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
   if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
-  {
-    Bit32u byteCount = FastRepSTOSB(i, BX_SEG_REG_ES, edi, AL, ECX);
-    if (byteCount) {
-      // Decrement the ticks count by the number of iterations, minus
-      // one, since the main cpu loop will decrement one.  Also,
-      // the count is predecremented before examined, so defintely
-      // don't roll it under zero.
-      BX_TICKN(byteCount-1);
-
-      // Decrement eCX.  Note, the main loop will decrement 1 also, so
-      // decrement by one less than expected, like the case above.
-      RCX = ECX - (byteCount-1);
-
-      incr = byteCount;
-    }
-    else {
-      write_virtual_byte(BX_SEG_REG_ES, edi, AL);
-    }
-  }
-  else
+    FastRepSTOS(i, 1);
 #endif
-  {
-    write_virtual_byte(BX_SEG_REG_ES, edi, AL);
-  }
+
+  Bit32u edi = EDI;
+
+  write_virtual_byte(BX_SEG_REG_ES, edi, AL);
 
   if (BX_CPU_THIS_PTR get_DF()) {
-    edi -= incr;
+    edi--;
   }
   else {
-    edi += incr;
+    edi++;
   }
 
   // zero extension of RDI
@@ -1756,6 +1740,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSB32_YbAL(bxInstruction_c *i)
 // 64 bit address size
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSB64_YbAL(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 1);
+#endif
+
   Bit64u rdi = RDI;
 
   write_linear_byte(BX_SEG_REG_ES, rdi, AL);
@@ -1791,6 +1782,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSW16_YwAX(bxInstruction_c *i)
 /* 16 bit opsize mode, 32 bit address size */
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSW32_YwAX(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 2);
+#endif
+
   Bit32u edi = EDI;
 
   write_virtual_word(BX_SEG_REG_ES, edi, AX);
@@ -1810,6 +1808,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSW32_YwAX(bxInstruction_c *i)
 /* 16 bit opsize mode, 32 bit address size */
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSW64_YwAX(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 2);
+#endif
+
   Bit64u rdi = RDI;
 
   write_linear_word(BX_SEG_REG_ES, rdi, AX);
@@ -1845,6 +1850,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSD16_YdEAX(bxInstruction_c *i)
 /* 32 bit opsize mode, 32 bit address size */
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSD32_YdEAX(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 4);
+#endif
+
   Bit32u edi = EDI;
 
   write_virtual_dword(BX_SEG_REG_ES, edi, EAX);
@@ -1865,6 +1877,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSD32_YdEAX(bxInstruction_c *i)
 /* 32 bit opsize mode, 32 bit address size */
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSD64_YdEAX(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 4);
+#endif
+
   Bit64u rdi = RDI;
 
   write_linear_dword(BX_SEG_REG_ES, rdi, EAX);
@@ -1882,6 +1901,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSD64_YdEAX(bxInstruction_c *i)
 /* 64 bit opsize mode, 32 bit address size */
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSQ32_YqRAX(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 8);
+#endif
+
   Bit32u edi = EDI;
 
   write_linear_qword(BX_SEG_REG_ES, edi, RAX);
@@ -1900,6 +1926,13 @@ void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSQ32_YqRAX(bxInstruction_c *i)
 /* 64 bit opsize mode, 64 bit address size */
 void BX_CPP_AttrRegparmN(1) BX_CPU_C::STOSQ64_YqRAX(bxInstruction_c *i)
 {
+#if (BX_SUPPORT_REPEAT_SPEEDUPS) && (BX_DEBUGGER == 0)
+  /* If conditions are right, we can process all but the last
+   * iteration in a batch, rather than one instruction at a time */
+  if (i->repUsedL() && !BX_CPU_THIS_PTR async_event)
+    FastRepSTOS(i, 8);
+#endif
+
   Bit64u rdi = RDI;
 
   write_linear_qword(BX_SEG_REG_ES, rdi, RAX);
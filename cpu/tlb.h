@@ -36,6 +36,34 @@
 #define BX_TLB_MASK ((BX_TLB_SIZE-1) << 12)
 #define BX_TLB_INDEX_OF(lpf, len) ((((unsigned)(lpf) + (len)) & BX_TLB_MASK) >> 12)
 
+// BX_ITLB_SIZE: Number of entries in the instruction TLB, used only by
+//   prefetch(). Code and data translations don't evict each other.
+
+#define BX_ITLB_SIZE 512
+#define BX_ITLB_MASK ((BX_ITLB_SIZE-1) << 12)
+#define BX_ITLB_INDEX_OF(lpf) ((((unsigned)(lpf)) & BX_ITLB_MASK) >> 12)
+
+// BX_TLB_L2_SIZE: Number of 4K entries in the second level TLB, which is
+//   looked up by translate_linear() before walking the page tables.
+//   The L2 TLB is BX_TLB_L2_WAYS set associative, shared between code and
+//   data and holds translation results only (no host pointers).
+// BX_TLB_L2_LARGE_SIZE: Number of fully associative L2 TLB entries for
+//   large (2M/4M/1G) pages, each entry covers the whole large page.
+
+#define BX_TLB_L2_SIZE 4096
+#define BX_TLB_L2_WAYS 4
+#define BX_TLB_L2_SETS (BX_TLB_L2_SIZE / BX_TLB_L2_WAYS)
+#define BX_TLB_L2_INDEX_OF(lpf) ((((unsigned)(lpf)) >> 12) & (BX_TLB_L2_SETS-1))
+
+#define BX_TLB_L2_LARGE_SIZE 32
+
+// BX_PSC_SIZE: Number of entries in each of the paging-structure caches
+//   (PML4E, PDPTE and PDE caches) used by the long mode page walk to skip
+//   reading of the upper paging structure levels. The caches are direct
+//   mapped and hold non-leaf entries only.
+
+#define BX_PSC_SIZE 32
+
 typedef bx_ptr_equiv_t bx_hostpageaddr_t;
 
 #if BX_SUPPORT_X86_64
@@ -120,6 +148,38 @@ typedef struct {
 
 } bx_TLB_entry;
 
+typedef struct {
+  bx_address lpf;       // linear page frame, aligned to the page size
+  bx_phy_address ppf;   // physical page frame, aligned to the page size
+  Bit32u accessBits;    // access rights already validated by page walk
+  Bit32u lpf_mask;      // linear address mask of the page size
+  Bit32u combined_access; // as returned by the page walk (memtype bits)
+  Bit32u pcid;          // PCID of the address space, ignored for global pages
+#if BX_SUPPORT_PKEYS
+  Bit32u pkey;
+#endif
+
+  BX_CPP_INLINE bx_bool valid() const { return lpf != BX_INVALID_TLB_ENTRY; }
+
+  BX_CPP_INLINE void invalidate() {
+    lpf = BX_INVALID_TLB_ENTRY;
+    accessBits = 0;
+  }
+
+} bx_TLB_L2_entry;
+
+#define BX_PSC_INVALID_TAG BX_CONST64(0xffffffffffffffff)
+
+typedef struct {
+  Bit64u tag;             // address bits translated by the cached entries
+  bx_phy_address ppf;     // physical address of the next level paging structure
+  Bit32u combined_access; // combined access rights of the cached entries
+  Bit32u attr;            // PCD/PWT of the cached entry and execute disable
+
+  BX_CPP_INLINE void invalidate() { tag = BX_PSC_INVALID_TAG; }
+
+} bx_PSC_entry;
+
 #if BX_SUPPORT_X86_64
   #define LPF_MASK BX_CONST64(0xfffffffffffff000)
 #else
@@ -146,5 +206,6 @@ BX_CPP_INLINE bx_address AlignedAccessLPFOf(bx_address laddr, unsigned alignment
 }
 
 #define BX_TLB_ENTRY_OF(lpf, len) (&BX_CPU_THIS_PTR TLB.entry[BX_TLB_INDEX_OF((lpf), (len))])
+#define BX_ITLB_ENTRY_OF(lpf) (&BX_CPU_THIS_PTR ITLB.entry[BX_ITLB_INDEX_OF(lpf)])
 
 #endif
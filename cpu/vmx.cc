@@ -3673,7 +3673,15 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::INVPCID(bxInstruction_c *i)
       BX_ERROR(("INVPCID: invalid PCID"));
       exception(BX_GP_EXCEPTION, 0);
     }
+#if BX_SUPPORT_X86_64
+    // Invalidate mappings for LADDR tagged with PCID except globals
+    if (pcid == current_PCID())
+      TLB_invlpg((bx_address) invpcid_desc.xmm64u(1));
+    else
+      TLB_L2_invlpg((bx_address) invpcid_desc.xmm64u(1));
+#else
     TLB_flushNonGlobal(); // Invalidate all mappings for LADDR tagged with PCID except globals
+#endif
     break;
 
   case BX_INVPCID_SINGLE_CONTEXT_NON_GLOBAL_INVALIDATION:
@@ -3681,7 +3689,11 @@ BX_INSF_TYPE BX_CPP_AttrRegparmN(1) BX_CPU_C::INVPCID(bxInstruction_c *i)
       BX_ERROR(("INVPCID: invalid PCID"));
       exception(BX_GP_EXCEPTION, 0);
     }
+#if BX_SUPPORT_X86_64
+    TLB_flushPCID(pcid, 1); // Invalidate all mappings tagged with PCID except globals
+#else
     TLB_flushNonGlobal(); // Invalidate all mappings tagged with PCID except globals
+#endif
     break;
 
   case BX_INVPCID_ALL_CONTEXT_INVALIDATION:
@@ -30,8 +30,11 @@
 
 /* Initialized first time "crc32()" is called. If you prefer, you can
  * statically initialize it at compile time. [Another exercise.]
+ *
+ * crc32_table[0] is the classic byte-at-a-time table, crc32_table[1..7]
+ * extend it to process 8 bytes per step ("slicing-by-8").
  */
-static Bit32u crc32_table[256];
+static Bit32u crc32_table[8][256];
 
 /*
  * Build auxiliary table for parallel byte-at-a-time CRC-32.
@@ -46,20 +49,36 @@ static void init_crc32(void)
   for (i = 0; i < 256; ++i) {
     for (c = i << 24, j = 8; j > 0; --j)
       c = c & 0x80000000 ? (c << 1) ^ CRC32_POLY : (c << 1);
-    crc32_table[i] = c;
+    crc32_table[0][i] = c;
+  }
+
+  for (i = 0; i < 256; ++i) {
+    c = crc32_table[0][i];
+    for (j = 1; j < 8; ++j) {
+      c = (c << 8) ^ crc32_table[0][c >> 24];
+      crc32_table[j][i] = c;
+    }
   }
 }
 
 Bit32u crc32(const Bit8u *buf, int len)
 {
-  const Bit8u *p;
+  const Bit8u *p = buf;
   Bit32u crc;
 
-  if (!crc32_table[1])    /* if not already done, */
+  if (!crc32_table[0][1])    /* if not already done, */
     init_crc32();   /* build table */
 
   crc = 0xffffffff;       /* preload shift register, per CRC-32 spec */
-  for (p = buf; len > 0; ++p, --len)
-    crc = (crc << 8) ^ crc32_table[(crc >> 24) ^ *p];
+  for (; len >= 8; p += 8, len -= 8) {
+    Bit32u one = crc ^ (((Bit32u) p[0] << 24) | ((Bit32u) p[1] << 16) | ((Bit32u) p[2] << 8) | p[3]);
+    Bit32u two =        (((Bit32u) p[4] << 24) | ((Bit32u) p[5] << 16) | ((Bit32u) p[6] << 8) | p[7]);
+    crc = crc32_table[7][one >> 24] ^ crc32_table[6][(one >> 16) & 0xff] ^
+          crc32_table[5][(one >> 8) & 0xff] ^ crc32_table[4][one & 0xff] ^
+          crc32_table[3][two >> 24] ^ crc32_table[2][(two >> 16) & 0xff] ^
+          crc32_table[1][(two >> 8) & 0xff] ^ crc32_table[0][two & 0xff];
+  }
+  for (; len > 0; ++p, --len)
+    crc = (crc << 8) ^ crc32_table[0][(crc >> 24) ^ *p];
   return ~crc;            /* transmit complement, per CRC-32 spec */
 }
@@ -1042,6 +1042,8 @@ bx_shadow_data_c::bx_shadow_data_c(bx_param_c *parent,
   this->data_ptr = ptr_to_data;
   this->data_size = data_size;
   this->is_text = is_text;
+  this->sr_devptr = NULL;
+  this->file_restore_handler = NULL;
   if (parent) {
     BX_ASSERT(parent->get_type() == BXT_LIST);
     this->parent = (bx_list_c *)parent;
@@ -1065,14 +1067,32 @@ void bx_shadow_data_c::set(Bit32u index, Bit8u value)
   }
 }
 
+// File restore handler: called with the path of the saved data file, returns 1
+// if the data was restored by the handler and the file should not be read
+void bx_shadow_data_c::set_file_restore_handler(void *devptr, data_file_restore_handler restore)
+{
+  this->sr_devptr = devptr;
+  this->file_restore_handler = restore;
+}
+
+bx_bool bx_shadow_data_c::restore_file(const char *path)
+{
+  if (file_restore_handler)
+    return (*file_restore_handler)(sr_devptr, path);
+
+  return 0;
+}
+
 bx_shadow_filedata_c::bx_shadow_filedata_c(bx_param_c *parent,
     const char *name, FILE **scratch_file_ptr_ptr)
   : bx_param_c(SIM->gen_param_id(), name, "")
 {
   set_type(BXT_PARAM_FILEDATA);
   this->scratch_fpp = scratch_file_ptr_ptr;
+  this->sr_devptr = NULL;
   this->save_handler = NULL;
   this->restore_handler = NULL;
+  this->file_restore_handler = NULL;
   if (parent) {
     BX_ASSERT(parent->get_type() == BXT_LIST);
     this->parent = (bx_list_c *)parent;
@@ -1100,6 +1120,21 @@ void bx_shadow_filedata_c::restore(FILE *save_fp)
     (*restore_handler)(sr_devptr, save_fp);
 }
 
+// File restore handler: see bx_shadow_data_c
+void bx_shadow_filedata_c::set_file_restore_handler(void *devptr, data_file_restore_handler restore)
+{
+  this->sr_devptr = devptr;
+  this->file_restore_handler = restore;
+}
+
+bx_bool bx_shadow_filedata_c::restore_file(const char *path)
+{
+  if (file_restore_handler)
+    return (*file_restore_handler)(sr_devptr, path);
+
+  return 0;
+}
+
 bx_list_c::bx_list_c(bx_param_c *parent)
   : bx_param_c(SIM->gen_param_id(), "list", "")
 {
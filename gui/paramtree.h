@@ -474,10 +474,14 @@ public:
   void set_extension(const char *newext) {ext = newext;}
 };
 
+typedef bx_bool (*data_file_restore_handler)(void *devptr, const char *path);
+
 class BOCHSAPI bx_shadow_data_c : public bx_param_c {
   Bit32u data_size;
   Bit8u *data_ptr;
   bx_bool is_text;
+  void *sr_devptr;
+  data_file_restore_handler file_restore_handler;
 public:
   bx_shadow_data_c(bx_param_c *parent,
       const char *name,
@@ -489,6 +493,8 @@ public:
   bx_bool is_text_format() const {return is_text;}
   Bit8u get(Bit32u index);
   void set(Bit32u index, Bit8u value);
+  void set_file_restore_handler(void *devptr, data_file_restore_handler restore);
+  bx_bool restore_file(const char *path);
 };
 
 typedef void (*filedata_save_handler)(void *devptr, FILE *save_fp);
@@ -500,14 +506,17 @@ protected:
   void *sr_devptr;
   filedata_save_handler    save_handler;
   filedata_restore_handler restore_handler;
+  data_file_restore_handler file_restore_handler;
 
 public:
   bx_shadow_filedata_c(bx_param_c *parent,
       const char *name, FILE **scratch_file_ptr_ptr);
   void set_sr_handlers(void *devptr, filedata_save_handler save, filedata_restore_handler restore);
+  void set_file_restore_handler(void *devptr, data_file_restore_handler restore);
   FILE **get_fpp() {return scratch_fpp;}
   void save(FILE *save_file);
   void restore(FILE *save_file);
+  bx_bool restore_file(const char *path);
 };
 
 typedef struct _bx_listitem_t {
@@ -1270,10 +1270,12 @@ bx_bool bx_real_sim_c::restore_bochs_param(bx_list_c *root, const char *sr_path,
                     bx_shadow_data_c *dparam = (bx_shadow_data_c*)param;
                     if (!dparam->is_text_format()) {
                       sprintf(devdata, "%s/%s", sr_path, ptr);
-                      fp2 = fopen(devdata, "rb");
-                      if (fp2 != NULL) {
-                        fread(dparam->getptr(), 1, dparam->get_size(), fp2);
-                        fclose(fp2);
+                      if (!dparam->restore_file(devdata)) {
+                        fp2 = fopen(devdata, "rb");
+                        if (fp2 != NULL) {
+                          fread(dparam->getptr(), 1, dparam->get_size(), fp2);
+                          fclose(fp2);
+                        }
                       }
                     } else if (!strcmp(ptr, "{")) {
                       i = 0;
@@ -1297,6 +1299,8 @@ bx_bool bx_real_sim_c::restore_bochs_param(bx_list_c *root, const char *sr_path,
                   break;
                 case BXT_PARAM_FILEDATA:
                   sprintf(devdata, "%s/%s", sr_path, ptr);
+                  if (((bx_shadow_filedata_c*)param)->restore_file(devdata))
+                    break;
                   fp2 = fopen(devdata, "rb");
                   if (fp2 != NULL) {
                     FILE **fpp = ((bx_shadow_filedata_c*)param)->get_fpp();
@@ -1383,6 +1387,8 @@ bx_bool bx_real_sim_c::save_sr_param(FILE *fp, bx_param_c *node, const char *sr_
             sprintf(tmpstr, "%s/%s", sr_path, pname);
           else
             strcpy(tmpstr, pname);
+          // the data may still be mapped from the old file (see file restore handler)
+          remove(tmpstr);
           fp2 = fopen(tmpstr, "wb");
           if (fp2 != NULL) {
             fwrite(dparam->getptr(), 1, dparam->get_size(), fp2);
@@ -1416,6 +1422,8 @@ bx_bool bx_real_sim_c::save_sr_param(FILE *fp, bx_param_c *node, const char *sr_
         sprintf(tmpstr, "%s/%s.%s", sr_path, node->get_parent()->get_name(), node->get_name());
       else
         sprintf(tmpstr, "%s.%s", node->get_parent()->get_name(), node->get_name());
+      // the data may still be mapped from the old file (see file restore handler)
+      remove(tmpstr);
       fp2 = fopen(tmpstr, "wb");
       if (fp2 != NULL) {
         FILE **fpp = ((bx_shadow_filedata_c*)node)->get_fpp();
@@ -569,6 +569,11 @@ enum {
 };
 #define BX_CLOCK_SYNC_LAST       BX_CLOCK_SYNC_BOTH
 
+enum {
+  BX_SMP_SCHED_ADAPTIVE,
+  BX_SMP_SCHED_STRICT
+};
+
 enum {
   BX_PCI_CHIPSET_I430FX,
   BX_PCI_CHIPSET_I440FX
@@ -975,6 +975,7 @@ bx_devices_c::inp(Bit16u addr, unsigned io_len)
   Bit32u ret;
 
   BX_INSTR_INP(addr, io_len);
+  bx_pc_system.request_cpu_yield();
 
   io_read_handler = read_port_to_handler[addr];
   if (io_read_handler->mask & io_len) {
@@ -1008,6 +1009,7 @@ bx_devices_c::outp(Bit16u addr, Bit32u value, unsigned io_len)
 
   BX_INSTR_OUTP(addr, io_len, value);
   BX_DBG_IO_REPORT(addr, io_len, BX_WRITE, value);
+  bx_pc_system.request_cpu_yield();
 
   io_write_handler = write_port_to_handler[addr];
   if (io_write_handler->mask & io_len) {
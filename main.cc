@@ -1050,21 +1050,41 @@ int bx_begin_simulation(int argc, char *argv[])
       // SMP simulation: do a few instructions on each processor, then switch
       // to another.  Increasing quantum speeds up overall performance, but
       // reduces granularity of synchronization between processors.
-      // Current implementation uses dynamic quantum, each processor will
-      // execute exactly one trace then quit the cpu_loop and switch to
-      // the next processor.
+      // In strict mode each processor will execute exactly one trace then
+      // quit the cpu_loop and switch to the next processor. In adaptive mode
+      // each processor keeps running traces for up to timeslice instructions
+      // and switches earlier on I/O, MMIO or IPI access, a halted processor
+      // gives up its slice right away.
 
       static int quantum = SIM->get_param_num(BXPN_SMP_QUANTUM)->get();
+      static Bit32u timeslice =
+        (SIM->get_param_enum(BXPN_SMP_SCHED)->get() == BX_SMP_SCHED_STRICT) ?
+          0 : SIM->get_param_num(BXPN_SMP_TIMESLICE)->get();
       Bit32u executed = 0, processor = 0;
 
       while (1) {
          // do some instructions in each processor
-         Bit64u icount = BX_CPU(processor)->icount_last_sync = BX_CPU(processor)->get_icount();
-         BX_CPU(processor)->cpu_run_trace();
+         BX_CPU_C *cpu = BX_CPU(processor);
+         Bit64u icount = cpu->icount_last_sync = cpu->get_icount();
+         bx_pc_system.cpu_yield_request = 0;
+         cpu->cpu_run_trace();
 
          // see how many instruction it was able to run
-         Bit32u n = (Bit32u)(BX_CPU(processor)->get_icount() - icount);
-         if (n == 0) n = quantum; // the CPU was halted
+         Bit32u n = (Bit32u)(cpu->get_icount() - icount);
+         if (timeslice) {
+           // don't run past the next timer event, time is advanced only
+           // when all processors had their slice
+           Bit32u limit = bx_pc_system.getNumCpuTicksLeftNextEvent();
+           if (limit > timeslice) limit = timeslice;
+           if (n == 0) n = limit; // the CPU was halted
+           while (n < limit && ! bx_pc_system.cpu_yield_request && ! bx_pc_system.kill_bochs_request) {
+             cpu->cpu_run_trace();
+             Bit32u total = (Bit32u)(cpu->get_icount() - icount);
+             if (total == n) break; // the CPU went to sleep
+             n = total;
+           }
+         }
+         else if (n == 0) n = quantum; // the CPU was halted
          executed += n;
 
          if (++processor == BX_SMP_PROCESSORS) {
@@ -1097,6 +1117,7 @@ void bx_stop_simulation(void)
 
 void bx_sr_after_restore_state(void)
 {
+  bx_pc_system.after_restore_state();
 #if BX_SUPPORT_SMP == 0
   BX_CPU(0)->after_restore_state();
 #else
@@ -82,6 +82,7 @@ struct memory_handler_struct {
 class BOCHSAPI BX_MEM_C : public logfunctions {
 private:
   struct memory_handler_struct **memory_handlers;
+  struct memory_handler_struct **last_handler; // per CPU handler lookup cache
   bx_bool pci_enabled;
   bx_bool bios_write_enabled;
   bx_bool smram_available;
@@ -90,6 +91,7 @@ private:
 
   Bit64u  len, allocated;  // could be > 4G
   Bit8u   *actual_vector;
+  size_t   actual_vector_len; // non-zero when reserved with mmap()
   Bit8u   *vector;   // aligned correctly
   Bit8u  **blocks;
   Bit8u   *rom;      // 512k BIOS rom space + 128k expansion rom space
@@ -100,8 +102,10 @@ private:
   Bit32u used_blocks;
 #if BX_LARGE_RAMFILE
   static Bit8u * const swapped_out; // NULL; // (NULL - sizeof(Bit8u));
-  Bit32u  next_swapout_idx;
+  Bit32u  next_swapout_idx; // clock hand of the block replacement
   FILE    *overflow_file;
+  Bit8u   *block_state;     // BX_MEM_BLOCK_REFERENCED/DIRTY bits of each block
+  bx_bool  ram_file_mapped; // saved RAM image is mapped linearly on restore
 
   BX_MEM_SMF void   read_block(Bit32u block);
 #endif
@@ -110,7 +114,9 @@ public:
   BX_MEM_C();
  ~BX_MEM_C();
 
-  BX_MEM_SMF Bit8u*  get_vector(bx_phy_address addr);
+  BX_MEM_SMF Bit8u*  get_vector(bx_phy_address addr, unsigned rw = BX_RW);
+  BX_MEM_SMF BX_CPP_INLINE struct memory_handler_struct *get_memory_handler(unsigned slot, bx_phy_address a20addr);
+  BX_MEM_SMF void    flush_memory_handler_cache(void);
   BX_MEM_SMF void    init_memory(Bit64u guest, Bit64u host);
   BX_MEM_SMF void    cleanup_memory(void);
 
@@ -157,6 +163,7 @@ public:
   BX_MEM_SMF Bit64u  get_memory_len(void);
   BX_MEM_SMF void allocate_block(Bit32u index);
   BX_MEM_SMF Bit8u* alloc_vector_aligned(Bit32u bytes, Bit32u alignment);
+  BX_MEM_SMF void   free_vector(void);
 
 #if BX_SUPPORT_MONITOR_MWAIT
   BX_MEM_SMF bx_bool is_monitor(bx_phy_address begin_addr, unsigned len);
@@ -168,6 +175,7 @@ public:
   friend void ramfile_save_handler(void *devptr, FILE *fp);
   friend Bit64s memory_param_save_handler(void *devptr, bx_param_c *param);
   friend void memory_param_restore_handler(void *devptr, bx_param_c *param, Bit64s val);
+  friend bx_bool ram_restore_handler(void *devptr, const char *path);
 };
 
 BOCHSAPI extern BX_MEM_C bx_mem;
@@ -175,6 +183,12 @@ BOCHSAPI extern BX_MEM_C bx_mem;
 // must be power of two
 #define BX_MEM_BLOCK_LEN (128*1024) /* 128K blocks */
 
+#if BX_LARGE_RAMFILE
+// block_state bits
+#define BX_MEM_BLOCK_REFERENCED 0x01 /* accessed since last seen by the clock hand */
+#define BX_MEM_BLOCK_DIRTY      0x02 /* differs from the overflow file contents */
+#endif
+
 /*
 BX_CPP_INLINE Bit8u* BX_MEM_C::get_vector(bx_phy_address addr)
 {
@@ -182,7 +196,7 @@ BX_CPP_INLINE Bit8u* BX_MEM_C::get_vector(bx_phy_address addr)
 }
 */
 
-BX_CPP_INLINE Bit8u* BX_MEM_C::get_vector(bx_phy_address addr)
+BX_CPP_INLINE Bit8u* BX_MEM_C::get_vector(bx_phy_address addr, unsigned rw)
 {
   Bit32u block = (Bit32u)(addr / BX_MEM_BLOCK_LEN);
 #if (BX_LARGE_RAMFILE)
@@ -192,9 +206,38 @@ BX_CPP_INLINE Bit8u* BX_MEM_C::get_vector(bx_phy_address addr)
 #endif
     allocate_block(block);
 
+#if (BX_LARGE_RAMFILE)
+  BX_MEM_THIS block_state[block] |= (rw & 1) ?
+      (BX_MEM_BLOCK_REFERENCED | BX_MEM_BLOCK_DIRTY) : BX_MEM_BLOCK_REFERENCED;
+#endif
+
   return BX_MEM_THIS blocks[block] + (Bit32u)(addr & (BX_MEM_BLOCK_LEN-1));
 }
 
+// handler lookup cache slot of the CPU, DMA accesses use the last one
+#define BX_MEM_HANDLER_SLOT(cpu) ((cpu) != NULL ? (cpu)->which_cpu() : BX_SMP_PROCESSORS)
+
+// Memory handlers never share a 64K chunk (see registerMemoryHandlers), so
+// the first handler containing <a20addr> is the only one. The last handler
+// found is remembered per CPU (slot) as MMIO accesses tend to hit the same
+// device window again and again.
+BX_CPP_INLINE struct memory_handler_struct* BX_MEM_C::get_memory_handler(unsigned slot, bx_phy_address a20addr)
+{
+  struct memory_handler_struct *memory_handler = BX_MEM_THIS last_handler[slot];
+  if (memory_handler && memory_handler->begin <= a20addr && memory_handler->end >= a20addr)
+    return memory_handler;
+
+  memory_handler = BX_MEM_THIS memory_handlers[a20addr >> 20];
+  while (memory_handler) {
+    if (memory_handler->begin <= a20addr && memory_handler->end >= a20addr) {
+      BX_MEM_THIS last_handler[slot] = memory_handler;
+      break;
+    }
+    memory_handler = memory_handler->next;
+  }
+  return memory_handler;
+}
+
 BX_CPP_INLINE Bit64u BX_MEM_C::get_memory_len(void)
 {
   return (BX_MEM_THIS len);
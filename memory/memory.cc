@@ -69,17 +69,12 @@ void BX_MEM_C::writePhysicalPage(BX_CPU_C *cpu, bx_phy_address addr, unsigned le
     }
   }
 
-  memory_handler = BX_MEM_THIS memory_handlers[a20addr >> 20];
-  while (memory_handler) {
-    if (memory_handler->write_handler != NULL) {
-      if (memory_handler->begin <= a20addr &&
-          memory_handler->end >= a20addr &&
-          memory_handler->write_handler(a20addr, len, data, memory_handler->param))
-      {
-        return;
-      }
-    }
-    memory_handler = memory_handler->next;
+  memory_handler = BX_MEM_THIS get_memory_handler(BX_MEM_HANDLER_SLOT(cpu), a20addr);
+  if (memory_handler && memory_handler->write_handler != NULL &&
+      memory_handler->write_handler(a20addr, len, data, memory_handler->param))
+  {
+    bx_pc_system.request_cpu_yield();
+    return;
   }
 
 mem_write:
@@ -229,15 +224,12 @@ void BX_MEM_C::readPhysicalPage(BX_CPU_C *cpu, bx_phy_address addr, unsigned len
     }
   }
 
-  memory_handler = BX_MEM_THIS memory_handlers[a20addr >> 20];
-  while (memory_handler) {
-    if (memory_handler->begin <= a20addr &&
-          memory_handler->end >= a20addr &&
-          memory_handler->read_handler(a20addr, len, data, memory_handler->param))
-    {
-      return;
-    }
-    memory_handler = memory_handler->next;
+  memory_handler = BX_MEM_THIS get_memory_handler(BX_MEM_HANDLER_SLOT(cpu), a20addr);
+  if (memory_handler &&
+      memory_handler->read_handler(a20addr, len, data, memory_handler->param))
+  {
+    bx_pc_system.request_cpu_yield();
+    return;
   }
 
 mem_read:
@@ -247,19 +239,19 @@ mem_read:
     if (a20addr < 0x000a0000 || a20addr >= 0x00100000)
     {
       if (len == 8) {
-        ReadHostQWordFromLittleEndian(BX_MEM_THIS get_vector(a20addr), * (Bit64u*) data);
+        ReadHostQWordFromLittleEndian(BX_MEM_THIS get_vector(a20addr, BX_READ), * (Bit64u*) data);
         return;
       }
       if (len == 4) {
-        ReadHostDWordFromLittleEndian(BX_MEM_THIS get_vector(a20addr), * (Bit32u*) data);
+        ReadHostDWordFromLittleEndian(BX_MEM_THIS get_vector(a20addr, BX_READ), * (Bit32u*) data);
         return;
       }
       if (len == 2) {
-        ReadHostWordFromLittleEndian(BX_MEM_THIS get_vector(a20addr), * (Bit16u*) data);
+        ReadHostWordFromLittleEndian(BX_MEM_THIS get_vector(a20addr, BX_READ), * (Bit16u*) data);
         return;
       }
       if (len == 1) {
-        * (Bit8u *) data = * (BX_MEM_THIS get_vector(a20addr));
+        * (Bit8u *) data = * (BX_MEM_THIS get_vector(a20addr, BX_READ));
         return;
       }
       // len == other case can just fall thru to special cases handling
@@ -275,7 +267,7 @@ mem_read:
     {
       // addr *not* in range 000A0000 .. 000FFFFF
       while(1) {
-        *data_ptr = *(BX_MEM_THIS get_vector(a20addr));
+        *data_ptr = *(BX_MEM_THIS get_vector(a20addr, BX_READ));
         if (len == 1) return;
         len--;
         a20addr++;
@@ -294,7 +286,7 @@ mem_read:
       // SMMRAM
       if (a20addr < 0x000c0000) {
         // devices are not allowed to access SMMRAM under VGA memory
-        if (cpu) *data_ptr = *(BX_MEM_THIS get_vector(a20addr));
+        if (cpu) *data_ptr = *(BX_MEM_THIS get_vector(a20addr, BX_READ));
         goto inc_one;
       }
 
@@ -312,14 +304,14 @@ mem_read:
           }
         } else {
           // Read from ShadowRAM
-          *data_ptr = *(BX_MEM_THIS get_vector(a20addr));
+          *data_ptr = *(BX_MEM_THIS get_vector(a20addr, BX_READ));
         }
       }
       else
 #endif  // #if BX_SUPPORT_PCI
       {
         if ((a20addr & 0xfffc0000) != 0x000c0000) {
-          *data_ptr = *(BX_MEM_THIS get_vector(a20addr));
+          *data_ptr = *(BX_MEM_THIS get_vector(a20addr, BX_READ));
         }
         else if ((a20addr & 0xfffe0000) == 0x000e0000) {
           // last 128K of BIOS ROM mapped to 0xE0000-0xFFFFF
@@ -28,6 +28,23 @@
 #include "iodev/iodev.h"
 #define LOG_THIS BX_MEM(0)->
 
+#if BX_HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(MAP_ANONYMOUS) && defined(MAP_NORESERVE)
+#define BX_MEM_MMAP_VECTOR 1
+#endif
+#endif
+
+#ifndef BX_MEM_MMAP_VECTOR
+#define BX_MEM_MMAP_VECTOR 0
+#endif
+
+// alignment of memory vector reserved with mmap(), the host huge page size
+#define BX_MEM_HUGEPAGE_ALIGN (2*1024*1024)
+
 // alignment of memory vector, must be a power of 2
 #define BX_MEM_VECTOR_ALIGN 4096
 #define BX_MEM_HANDLERS   ((BX_CONST64(1) << BX_PHY_ADDRESS_WIDTH) >> 20) /* one per megabyte */
@@ -42,21 +59,50 @@ BX_MEM_C::BX_MEM_C()
 
   vector = NULL;
   actual_vector = NULL;
+  actual_vector_len = 0;
   blocks = NULL;
   len    = 0;
   used_blocks = 0;
 
   memory_handlers = NULL;
+  last_handler = NULL;
 
 #if BX_LARGE_RAMFILE
   next_swapout_idx = 0;
   overflow_file = NULL;
+  block_state = NULL;
+  ram_file_mapped = 0;
 #endif
 }
 
 Bit8u* BX_MEM_C::alloc_vector_aligned(Bit32u bytes, Bit32u alignment)
 {
+#if BX_MEM_MMAP_VECTOR
+  // Only reserve the address space, the host kernel allocates the pages on
+  // first access (and swaps them out if needed). The vector is aligned to
+  // the huge page size and the host is asked to back it with transparent
+  // huge pages, so that guest RAM is contiguous in host memory.
+  if (alignment <= BX_MEM_HUGEPAGE_ALIGN) {
+    size_t map_len = (size_t) bytes + BX_MEM_HUGEPAGE_ALIGN;
+    void *ptr = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (ptr != MAP_FAILED) {
+      BX_MEM_THIS actual_vector = (Bit8u *) ptr;
+      BX_MEM_THIS actual_vector_len = map_len;
+      Bit8u *vector = (Bit8u *)(((bx_ptr_equiv_t) ptr + BX_MEM_HUGEPAGE_ALIGN - 1) &
+                                 ~((bx_ptr_equiv_t) BX_MEM_HUGEPAGE_ALIGN - 1));
+#ifdef MADV_HUGEPAGE
+      if (madvise(vector, bytes, MADV_HUGEPAGE) != 0)
+        BX_INFO(("host transparent huge pages are not available for guest RAM"));
+#endif
+      return vector;
+    }
+    BX_INFO(("alloc_vector_aligned: mmap() failed, allocating host RAM from heap"));
+  }
+#endif
+
   Bit64u test_mask = alignment - 1;
+  BX_MEM_THIS actual_vector_len = 0;
   BX_MEM_THIS actual_vector = new Bit8u [(Bit32u)(bytes + test_mask)];
   if (BX_MEM_THIS actual_vector == 0) {
     BX_PANIC(("alloc_vector_aligned: unable to allocate host RAM !"));
@@ -83,6 +129,19 @@ BX_MEM_C::~BX_MEM_C()
   cleanup_memory();
 }
 
+void BX_MEM_C::free_vector(void)
+{
+#if BX_MEM_MMAP_VECTOR
+  if (BX_MEM_THIS actual_vector_len != 0)
+    munmap(BX_MEM_THIS actual_vector, BX_MEM_THIS actual_vector_len);
+  else
+#endif
+    delete [] BX_MEM_THIS actual_vector;
+
+  BX_MEM_THIS actual_vector = NULL;
+  BX_MEM_THIS actual_vector_len = 0;
+}
+
 void BX_MEM_C::init_memory(Bit64u guest, Bit64u host)
 {
   unsigned i, idx;
@@ -95,10 +154,13 @@ void BX_MEM_C::init_memory(Bit64u guest, Bit64u host)
 
   if (BX_MEM_THIS actual_vector != NULL) {
     BX_INFO(("freeing existing memory vector"));
-    delete [] BX_MEM_THIS actual_vector;
-    BX_MEM_THIS actual_vector = NULL;
+    free_vector();
     BX_MEM_THIS vector = NULL;
     BX_MEM_THIS blocks = NULL;
+#if BX_LARGE_RAMFILE
+    delete [] BX_MEM_THIS block_state;
+    BX_MEM_THIS block_state = NULL;
+#endif
   }
   BX_MEM_THIS vector = alloc_vector_aligned(host + BIOSROMSZ + EXROMSIZE + 4096, BX_MEM_VECTOR_ALIGN);
   BX_INFO(("allocated memory at %p. after alignment, vector=%p",
@@ -117,8 +179,10 @@ void BX_MEM_C::init_memory(Bit64u guest, Bit64u host)
   BX_INFO(("%.2fMB", (float)(BX_MEM_THIS len / (1024.0*1024.0))));
   BX_INFO(("mem block size = 0x%08x, blocks=%u", BX_MEM_BLOCK_LEN, num_blocks));
   BX_MEM_THIS blocks = new Bit8u* [num_blocks];
-  if (0) {
-    // all guest memory is allocated, just map it
+  if (BX_MEM_THIS actual_vector_len != 0 && host >= guest) {
+    // all guest memory is reserved with mmap(), just map it, the host
+    // allocates the pages on demand
+    BX_INFO(("guest RAM is reserved in host virtual memory"));
     for (idx = 0; idx < num_blocks; idx++) {
       BX_MEM_THIS blocks[idx] = BX_MEM_THIS vector + (idx * BX_MEM_BLOCK_LEN);
     }
@@ -131,10 +195,18 @@ void BX_MEM_C::init_memory(Bit64u guest, Bit64u host)
     }
     BX_MEM_THIS used_blocks = 0;
   }
+#if BX_LARGE_RAMFILE
+  BX_MEM_THIS block_state = new Bit8u [num_blocks];
+  memset(BX_MEM_THIS block_state, 0, num_blocks);
+#endif
 
   BX_MEM_THIS memory_handlers = new struct memory_handler_struct *[BX_MEM_HANDLERS];
   for (idx = 0; idx < BX_MEM_HANDLERS; idx++)
     BX_MEM_THIS memory_handlers[idx] = NULL;
+  delete [] BX_MEM_THIS last_handler;
+  // one slot per CPU and one for DMA
+  BX_MEM_THIS last_handler = new struct memory_handler_struct *[BX_SMP_PROCESSORS + 1];
+  flush_memory_handler_cache();
 
   BX_MEM_THIS pci_enabled = SIM->get_param_bool(BXPN_PCI_ENABLED)->get();
   BX_MEM_THIS bios_write_enabled = 0;
@@ -161,9 +233,16 @@ void BX_MEM_C::read_block(Bit32u block)
     BX_PANIC(("FATAL ERROR: Could not seek to 0x" FMT_LL "x in memory overflow file!", block_address));
 
   // We could legitimately get an EOF condition if we are reading the last bit of memory.ram
-  if ((fread(BX_MEM_THIS blocks[block], BX_MEM_BLOCK_LEN, 1, BX_MEM_THIS overflow_file) != 1) && 
-      (!feof(BX_MEM_THIS overflow_file))) 
-    BX_PANIC(("FATAL ERROR: Could not read from 0x" FMT_LL "x in memory overflow file!", block_address)); 
+  size_t count = fread(BX_MEM_THIS blocks[block], 1, BX_MEM_BLOCK_LEN, BX_MEM_THIS overflow_file);
+  if (count != BX_MEM_BLOCK_LEN) {
+    if (!feof(BX_MEM_THIS overflow_file))
+      BX_PANIC(("FATAL ERROR: Could not read from 0x" FMT_LL "x in memory overflow file!", block_address));
+    // not written yet, must read as zeroes to match the file contents
+    memset(BX_MEM_THIS blocks[block] + count, 0, BX_MEM_BLOCK_LEN - count);
+  }
+
+  // the block is clean until written
+  BX_MEM_THIS block_state[block] = BX_MEM_BLOCK_REFERENCED;
 }
 #endif
 
@@ -177,18 +256,28 @@ void BX_MEM_C::allocate_block(Bit32u block)
    * First, see if there is any spare host memory blocks we can still freely allocate
    */
   if (BX_MEM_THIS used_blocks >= max_blocks) {
+    const Bit32u num_blocks = (Bit32u)(BX_MEM_THIS len / BX_MEM_BLOCK_LEN);
     Bit32u original_replacement_block = BX_MEM_THIS next_swapout_idx;
-    // Find a block to replace
+    unsigned rounds = 0;
+    // Find a block to replace (clock algorithm): blocks referenced since
+    // the last round of the clock hand get a second chance
     bx_bool used_for_tlb;
     Bit8u *buffer;
     do {
       do {
         // Wrap if necessary
-        if (++(BX_MEM_THIS next_swapout_idx)==((BX_MEM_THIS len)/BX_MEM_BLOCK_LEN))
+        if (++(BX_MEM_THIS next_swapout_idx) == num_blocks)
           BX_MEM_THIS next_swapout_idx = 0;
-        if (BX_MEM_THIS next_swapout_idx == original_replacement_block)
+        // the first round may only clear the referenced bits
+        if (BX_MEM_THIS next_swapout_idx == original_replacement_block && ++rounds > 2)
           BX_PANIC(("FATAL ERROR: Insufficient working RAM, all blocks are currently used for TLB entries!"));
         buffer = BX_MEM_THIS blocks[BX_MEM_THIS next_swapout_idx];
+        if (buffer && (buffer != BX_MEM_C::swapped_out) &&
+           (BX_MEM_THIS block_state[BX_MEM_THIS next_swapout_idx] & BX_MEM_BLOCK_REFERENCED))
+        {
+          BX_MEM_THIS block_state[BX_MEM_THIS next_swapout_idx] &= ~BX_MEM_BLOCK_REFERENCED;
+          buffer = NULL;
+        }
       } while ((!buffer) || (buffer == BX_MEM_C::swapped_out));
 
       used_for_tlb = false;
@@ -206,19 +295,32 @@ void BX_MEM_C::allocate_block(Bit32u block)
       if (!BX_MEM_THIS overflow_file)
         BX_PANIC(("Unable to allocate memory overflow file"));
     }
-    // Write swapped out block
-    if (fseeko64(BX_MEM_THIS overflow_file, address, SEEK_SET))
-      BX_PANIC(("FATAL ERROR: Could not seek to 0x" FMT_PHY_ADDRX " in overflow file!", address)); 
-    if (1 != fwrite (BX_MEM_THIS blocks[BX_MEM_THIS next_swapout_idx], BX_MEM_BLOCK_LEN, 1, BX_MEM_THIS overflow_file))
-      BX_PANIC(("FATAL ERROR: Could not write at 0x" FMT_PHY_ADDRX " in overflow file!", address));
+    // Write swapped out block, clean blocks are already in the overflow file
+    if (BX_MEM_THIS block_state[BX_MEM_THIS next_swapout_idx] & BX_MEM_BLOCK_DIRTY) {
+      if (fseeko64(BX_MEM_THIS overflow_file, address, SEEK_SET))
+        BX_PANIC(("FATAL ERROR: Could not seek to 0x" FMT_PHY_ADDRX " in overflow file!", address)); 
+      if (1 != fwrite (BX_MEM_THIS blocks[BX_MEM_THIS next_swapout_idx], BX_MEM_BLOCK_LEN, 1, BX_MEM_THIS overflow_file))
+        BX_PANIC(("FATAL ERROR: Could not write at 0x" FMT_PHY_ADDRX " in overflow file!", address));
+    }
     // Mark swapped out block
     BX_MEM_THIS blocks[BX_MEM_THIS next_swapout_idx] = BX_MEM_C::swapped_out;
+    BX_MEM_THIS block_state[BX_MEM_THIS next_swapout_idx] = 0;
     BX_MEM_THIS blocks[block] = buffer;
     read_block(block);
+#ifdef POSIX_FADV_WILLNEED
+    // Guest memory is often accessed sequentially, let the host start reading
+    // the next swapped out block in background
+    if ((block + 1) < num_blocks && BX_MEM_THIS blocks[block + 1] == BX_MEM_C::swapped_out) {
+      posix_fadvise(fileno(BX_MEM_THIS overflow_file), (off_t)(block + 1) * BX_MEM_BLOCK_LEN,
+                    BX_MEM_BLOCK_LEN, POSIX_FADV_WILLNEED);
+    }
+#endif
     BX_DEBUG(("allocate_block: block=0x%x, replaced 0x%x", block, BX_MEM_THIS next_swapout_idx));
   }
   else {
     BX_MEM_THIS blocks[block] = BX_MEM_THIS vector + (BX_MEM_THIS used_blocks++ * BX_MEM_BLOCK_LEN);
+    // not in the overflow file yet
+    BX_MEM_THIS block_state[block] = BX_MEM_BLOCK_DIRTY;
     BX_DEBUG(("allocate_block: block=0x%x used 0x%x of 0x%x",
           block, BX_MEM_THIS used_blocks, max_blocks));
   }
@@ -279,6 +381,11 @@ void memory_param_restore_handler(void *devptr, bx_param_c *param, Bit64s val)
   if (! strncmp(pname, "blk", 3)) {
     Bit32u blk_index = atoi(pname + 3);
 #if BX_LARGE_RAMFILE
+    if (BX_MEM(0)->ram_file_mapped) {
+      // the block is already mapped from the saved RAM image
+      BX_MEM(0)->blocks[blk_index] = BX_MEM(0)->vector + blk_index * BX_MEM_BLOCK_LEN;
+      return;
+    }
     if ((Bit32s) val == -2) {
       BX_MEM(0)->blocks[blk_index] = BX_MEM(0)->swapped_out;
       return;
@@ -295,6 +402,63 @@ void memory_param_restore_handler(void *devptr, bx_param_c *param, Bit64s val)
   }
 }
 
+#if BX_MEM_MMAP_VECTOR
+// Map the saved RAM image copy-on-write over the memory vector instead of
+// reading it. The unmodified pages are shared with all other instances
+// restored from the same image through the host page cache.
+bx_bool ram_restore_handler(void *devptr, const char *path)
+{
+  struct stat stat_buf;
+
+  if (BX_MEM(0)->actual_vector_len == 0)
+    return 0;
+
+#if BX_LARGE_RAMFILE
+  // the image is indexed by guest physical address and may be shorter than
+  // guest RAM, all guest RAM blocks must fit into the vector
+  if (BX_MEM(0)->allocated < BX_MEM(0)->len)
+    return 0;
+  Bit64u max_size = BX_MEM(0)->len;
+#else
+  // the image is a copy of the memory vector
+  Bit64u max_size = BX_MEM(0)->allocated;
+#endif
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return 0;
+
+  if ((fstat(fd, &stat_buf) != 0) || ((Bit64u) stat_buf.st_size > max_size) ||
+#if !BX_LARGE_RAMFILE
+      ((Bit64u) stat_buf.st_size != max_size) ||
+#endif
+      (stat_buf.st_size & (BX_MEM_VECTOR_ALIGN-1)) != 0)
+  {
+    BX_ERROR(("cannot map RAM image '%s', unexpected size", path));
+    close(fd);
+    return 0;
+  }
+
+  if (stat_buf.st_size > 0) {
+    void *ptr = mmap(BX_MEM(0)->vector, (size_t) stat_buf.st_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      // the old pages may have been already unmapped
+      BX_PANIC(("cannot map RAM image '%s'", path));
+      close(fd);
+      return 0;
+    }
+  }
+  close(fd);
+
+#if BX_LARGE_RAMFILE
+  BX_MEM(0)->ram_file_mapped = 1;
+#endif
+  BX_INFO(("mapped RAM image '%s'", path));
+  return 1;
+}
+#endif
+
 void BX_MEM_C::register_state()
 {
   char param_name[15];
@@ -305,7 +469,11 @@ void BX_MEM_C::register_state()
   bx_shadow_filedata_c *ramfile = new bx_shadow_filedata_c(list, "ram", &(BX_MEM_THIS overflow_file));
   ramfile->set_sr_handlers(this, ramfile_save_handler, (filedata_restore_handler)NULL);
 #else
-  new bx_shadow_data_c(list, "ram", BX_MEM_THIS vector, BX_MEM_THIS allocated);
+  bx_shadow_data_c *ramfile = new bx_shadow_data_c(list, "ram", BX_MEM_THIS vector, BX_MEM_THIS allocated);
+#endif
+#if BX_MEM_MMAP_VECTOR
+  if (SIM->get_param_bool(BXPN_MEM_RESTORE_MAP)->get())
+    ramfile->set_file_restore_handler(this, ram_restore_handler);
 #endif
   BXRS_DEC_PARAM_FIELD(list, len, BX_MEM_THIS len);
   BXRS_DEC_PARAM_FIELD(list, allocated, BX_MEM_THIS allocated);
@@ -332,14 +500,17 @@ void BX_MEM_C::cleanup_memory()
   unsigned idx;
 
   if (BX_MEM_THIS vector != NULL) {
-    delete [] BX_MEM_THIS actual_vector;
-    BX_MEM_THIS actual_vector = NULL;
+    free_vector();
     BX_MEM_THIS vector = NULL;
     BX_MEM_THIS rom = NULL;
     BX_MEM_THIS bogus = NULL;
     delete [] BX_MEM_THIS blocks;
     BX_MEM_THIS blocks = 0;
     BX_MEM_THIS used_blocks = 0;
+#if BX_LARGE_RAMFILE
+    delete [] BX_MEM_THIS block_state;
+    BX_MEM_THIS block_state = NULL;
+#endif
     if (BX_MEM_THIS memory_handlers != NULL) {
       for (idx = 0; idx < BX_MEM_HANDLERS; idx++) {
         struct memory_handler_struct *memory_handler = BX_MEM_THIS memory_handlers[idx];
@@ -352,6 +523,8 @@ void BX_MEM_C::cleanup_memory()
       }
       delete [] BX_MEM_THIS memory_handlers;
       BX_MEM_THIS memory_handlers = NULL;
+      delete [] BX_MEM_THIS last_handler;
+      BX_MEM_THIS last_handler = NULL;
     }
   }
 }
@@ -556,7 +729,7 @@ bx_bool BX_MEM_C::dbg_fetch_mem(BX_CPU_C *cpu, bx_phy_address addr, unsigned len
     // Reading standard PCI/ISA Video Mem / SMMRAM
     if (addr >= 0x000a0000 && addr < 0x000c0000) {
       if (BX_MEM_THIS smram_enable || cpu->smm_mode())
-        *buf = *(BX_MEM_THIS get_vector(addr));
+        *buf = *(BX_MEM_THIS get_vector(addr, BX_READ));
       else
         *buf = DEV_vga_mem_read(addr);
     }
@@ -574,14 +747,14 @@ bx_bool BX_MEM_C::dbg_fetch_mem(BX_CPU_C *cpu, bx_phy_address addr, unsigned len
         }
       } else {
         // Read from ShadowRAM
-        *buf = *(BX_MEM_THIS get_vector(addr));
+        *buf = *(BX_MEM_THIS get_vector(addr, BX_READ));
       }
     }
 #endif  // #if BX_SUPPORT_PCI
     else if (addr < BX_MEM_THIS len)
     {
       if (addr < 0x000c0000 || addr >= 0x00100000) {
-        *buf = *(BX_MEM_THIS get_vector(addr));
+        *buf = *(BX_MEM_THIS get_vector(addr, BX_READ));
       }
       // must be in C0000 - FFFFF range
       else if ((addr & 0xfffe0000) == 0x000e0000) {
@@ -665,7 +838,7 @@ bx_bool BX_MEM_C::dbg_crc32(bx_phy_address addr1, bx_phy_address addr2, Bit32u *
   while(1) { 
     unsigned remainsInPage = 0x1000 - (addr1 & 0xfff);
     unsigned access_length = (len < remainsInPage) ? len : remainsInPage;
-    *crc = crc32(BX_MEM_THIS get_vector(addr1), access_length);
+    *crc = crc32(BX_MEM_THIS get_vector(addr1, BX_READ), access_length);
     addr1 += access_length;
     len -= access_length;
   }
@@ -713,7 +886,7 @@ Bit8u *BX_MEM_C::getHostMemAddr(BX_CPU_C *cpu, bx_phy_address addr, unsigned rw)
     if ((a20addr >= 0x000a0000 && a20addr < 0x000c0000) && (BX_MEM_THIS smram_available))
     {
       if (BX_MEM_THIS smram_enable || cpu->smm_mode())
-        return BX_MEM_THIS get_vector(a20addr);
+        return BX_MEM_THIS get_vector(a20addr, rw);
     }
   }
 
@@ -724,16 +897,12 @@ Bit8u *BX_MEM_C::getHostMemAddr(BX_CPU_C *cpu, bx_phy_address addr, unsigned rw)
   }
 #endif
 
-  struct memory_handler_struct *memory_handler = BX_MEM_THIS memory_handlers[a20addr >> 20];
-  while (memory_handler) {
-    if (memory_handler->begin <= a20addr &&
-        memory_handler->end >= a20addr) {
-      if (memory_handler->da_handler)
-        return memory_handler->da_handler(a20addr, rw, memory_handler->param);
-      else
-        return(NULL); // Vetoed! memory handler for i/o apic, vram, mmio and PCI PnP
-    }
-    memory_handler = memory_handler->next;
+  struct memory_handler_struct *memory_handler = BX_MEM_THIS get_memory_handler(BX_MEM_HANDLER_SLOT(cpu), a20addr);
+  if (memory_handler) {
+    if (memory_handler->da_handler)
+      return memory_handler->da_handler(a20addr, rw, memory_handler->param);
+    else
+      return(NULL); // Vetoed! memory handler for i/o apic, vram, mmio and PCI PnP
   }
 
   if (! write) {
@@ -753,14 +922,14 @@ Bit8u *BX_MEM_C::getHostMemAddr(BX_CPU_C *cpu, bx_phy_address addr, unsigned rw)
         }
       } else {
         // Read from ShadowRAM
-        return BX_MEM_THIS get_vector(a20addr);
+        return BX_MEM_THIS get_vector(a20addr, rw);
       }
     }
 #endif
     else if(a20addr < BX_MEM_THIS len && ! is_bios)
     {
       if (a20addr < 0x000c0000 || a20addr >= 0x00100000) {
-        return BX_MEM_THIS get_vector(a20addr);
+        return BX_MEM_THIS get_vector(a20addr, rw);
       }
       // must be in C0000 - FFFFF range
       else if ((a20addr & 0xfffe0000) == 0x000e0000) {
@@ -805,7 +974,7 @@ Bit8u *BX_MEM_C::getHostMemAddr(BX_CPU_C *cpu, bx_phy_address addr, unsigned rw)
     else
     {
       if (a20addr < 0x000c0000 || a20addr >= 0x00100000) {
-        return BX_MEM_THIS get_vector(a20addr);
+        return BX_MEM_THIS get_vector(a20addr, rw);
       }
       else {
         return(NULL);  // Vetoed!  ROMs
@@ -854,6 +1023,7 @@ BX_MEM_C::registerMemoryHandlers(void *param, memory_handler_t read_handler,
     memory_handler->end = end_addr;
     memory_handler->bitmap = bitmap;
   }
+  flush_memory_handler_cache();
   return 1;
 }
 
@@ -891,9 +1061,18 @@ BX_MEM_C::unregisterMemoryHandlers(void *param, bx_phy_address begin_addr, bx_ph
       BX_MEM_THIS memory_handlers[page_idx] = memory_handler->next;
     delete memory_handler;
   }
+  flush_memory_handler_cache();
   return ret;
 }
 
+void BX_MEM_C::flush_memory_handler_cache(void)
+{
+  if (BX_MEM_THIS last_handler != NULL) {
+    for (unsigned n = 0; n <= BX_SMP_PROCESSORS; n++)
+      BX_MEM_THIS last_handler[n] = NULL;
+  }
+}
+
 void BX_MEM_C::enable_smram(bx_bool enable, bx_bool restricted)
 {
   BX_MEM_THIS smram_available = 1;
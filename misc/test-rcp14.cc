@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+// test-rcp14.cc
+//
+// Checks that the piecewise linear VRCP14 and VRSQRT14 mantissa tables
+// in cpu/avx/avx512_rcp14.h reproduce the original 64K-entry (VRCP14) and
+// 2x32K-entry (VRSQRT14) lookup tables bit for bit. The original tables
+// are no longer in the tree, every table is compared against the FNV-1a
+// hash of its original contents (16-bit entries, little endian).
+//
+// Compile with (from a configured tree, config.h is needed):
+//   c++ -I. -Iinstrument/stubs -o test-rcp14 misc/test-rcp14.cc
+// Then run "test-rcp14", it exits with 0 if all tables match.
+//
+/////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+
+#include "config.h"
+#include "cpu/avx/avx512_rcp14.h"
+
+struct table_hash {
+  const char *name;
+  unsigned size;
+  Bit64u hash;
+};
+
+// hashes of the original tables
+static const table_hash original[3] = {
+  { "rcp14_table",    65536, BX_CONST64(0x94e740510e0e712f) },
+  { "rsqrt14_table0", 32768, BX_CONST64(0xe8788810c68c9355) },  // even exponent
+  { "rsqrt14_table1", 32768, BX_CONST64(0x2f610c2406da7545) }   // odd exponent
+};
+
+static Bit64u fnv1a_entry(Bit64u hash, Bit32u entry)
+{
+  hash = (hash ^ (entry & 0xff)) * BX_CONST64(0x100000001b3);
+  hash = (hash ^ ((entry >> 8) & 0xff)) * BX_CONST64(0x100000001b3);
+  return hash;
+}
+
+int main()
+{
+  int failures = 0;
+
+  for (unsigned t=0; t < 3; t++) {
+    Bit64u hash = BX_CONST64(0xcbf29ce484222325);
+    int out_of_range = 0;
+
+    for (unsigned index=0; index < original[t].size; index++) {
+      Bit32u entry = (t == 0) ? rcp14_table(index) : rsqrt14_table(t - 1, index);
+      if (entry > 0xffff) out_of_range++;
+      hash = fnv1a_entry(hash, entry);
+    }
+
+    bx_bool ok = (hash == original[t].hash) && !out_of_range;
+    printf("%-16s %5u entries, hash %08x%08x: %s\n", original[t].name, original[t].size,
+      (Bit32u)(hash >> 32), (Bit32u) hash, ok ? "ok" : "MISMATCH");
+    if (! ok) failures++;
+  }
+
+  printf("mismatches=%d\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,290 @@
+/////////////////////////////////////////////////////////////////////////
+// $Id$
+/////////////////////////////////////////////////////////////////////////
+//
+// test-simd-int.cc
+//
+// Conformance test and micro-benchmark for the packed integer helpers in
+// cpu/simd_int.h and cpu/simd_compare.h which are implemented with host
+// SIMD instructions on x86 hosts. The headers are compiled twice: once
+// with BX_NO_HOST_SIMD (the portable reference code) and once as Bochs
+// builds them. Every helper with a host implementation is run with random
+// inputs biased towards edge values and both results are compared.
+//
+// Compile with (from a configured tree, config.h is needed):
+//   c++ -O2 -I. -Iinstrument/stubs -o test-simd-int misc/test-simd-int.cc
+// for the SSE2 forms, add -mssse3 or -msse4.1 (or -march=native) to test
+// the SSSE3 and SSE4.1 forms as well. Then run "test-simd-int", it exits
+// with 0 if there were no mismatches. "test-simd-int -b" also prints the
+// time per call of the reference and the host form of every helper.
+//
+/////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "bochs.h"
+#include "cpu/cpu.h"
+
+// the intrinsics headers must be included at global scope, the inclusions
+// from simd_host.h inside the namespaces below are no-ops then
+#if defined(__SSE2__)
+#include <immintrin.h>
+#include <wmmintrin.h>
+#endif
+
+#define BX_NO_HOST_SIMD
+namespace ref {
+#include "cpu/simd_int.h"
+#include "cpu/simd_compare.h"
+}
+#undef BX_NO_HOST_SIMD
+
+// forget the reference build of the headers
+#undef BX_SIMD_HOST_H
+#undef BX_SIMD_INT_FUNCTIONS_H
+#undef BX_SIMD_INT_COMPARE_FUNCTIONS_H
+#undef BX_HOST_SSE2
+#undef BX_HOST_SSSE3
+#undef BX_HOST_SSE4_1
+#undef BX_HOST_SSE_FP
+#undef BX_HOST_MXCSR_DEFAULT
+#undef BX_HOST_CRYPTO
+#undef BX_HOST_TARGET
+#undef BX_HOST_CRYPTO_AES
+#undef BX_HOST_CRYPTO_PCLMUL
+#undef BX_HOST_CRYPTO_SHA
+
+namespace host {
+#include "cpu/simd_int.h"
+#include "cpu/simd_compare.h"
+}
+
+// all the helpers with a host implementation, grouped by signature
+
+#define UNARY_HELPERS(X) \
+  X(pabsb) X(pabsw) X(pabsd)
+
+#define BINARY_HELPERS(X) \
+  X(pminsb) X(pminub) X(pminsw) X(pminuw) X(pminsd) X(pminud) \
+  X(pmaxsb) X(pmaxub) X(pmaxsw) X(pmaxuw) X(pmaxsd) X(pmaxud) \
+  X(unpcklps) X(unpckhps) X(unpcklpd) X(unpckhpd) \
+  X(punpcklbw) X(punpckhbw) X(punpcklwd) X(punpckhwd) \
+  X(packuswb) X(packsswb) X(packusdw) X(packssdw) \
+  X(psignb) X(psignw) X(psignd) \
+  X(andps) X(andnps) X(orps) X(xorps) \
+  X(paddb) X(paddw) X(paddd) X(paddq) X(psubb) X(psubw) X(psubd) X(psubq) \
+  X(paddsb) X(paddsw) X(paddusb) X(paddusw) \
+  X(psubsb) X(psubsw) X(psubusb) X(psubusw) \
+  X(phaddw) X(phaddd) X(phaddsw) X(phsubw) X(phsubd) X(phsubsw) \
+  X(pavgb) X(pavgw) \
+  X(pmullw) X(pmulhw) X(pmulhuw) X(pmulld) X(pmuldq) X(pmuludq) \
+  X(pmulhrsw) X(pmaddubsw) X(pmaddwd) X(psadbw) \
+  X(pcmpgtb) X(pcmpgtw) X(pcmpgtd) X(pcmpeqb) X(pcmpeqw) X(pcmpeqd)
+
+#define TERNARY_HELPERS(X) \
+  X(pshufb)
+
+#define MOVMSK_HELPERS(X) \
+  X(pmovmskb) X(pmovmskw) X(pmovmskd) X(pmovmskq)
+
+#define SHIFT_HELPERS(X) \
+  X(psraw) X(psrad) X(psrlw) X(psrld) X(psrlq) X(psllw) X(pslld) X(psllq)
+
+#define MASK_HELPERS(X) \
+  X(pcmpgtb_mask) X(pcmpgtw_mask) X(pcmpgtd_mask) \
+  X(pcmpeqb_mask) X(pcmpeqw_mask) X(pcmpeqd_mask)
+
+static const unsigned ITERATIONS = 200000;
+
+static Bit64u rng_state = BX_CONST64(0x9e3779b97f4a7c15);
+
+static Bit64u rnd(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return rng_state;
+}
+
+// random lanes with a good share of 0, -1, MIN, MAX and small values
+static void random_xmm(BxPackedXmmRegister *op)
+{
+  static const Bit64u edge[8] = {
+    0, BX_CONST64(0xffffffffffffffff),
+    BX_CONST64(0x8080808080808080), BX_CONST64(0x7f7f7f7f7f7f7f7f),
+    BX_CONST64(0x8000800080008000), BX_CONST64(0x7fff7fff7fff7fff),
+    BX_CONST64(0x8000000080000000), BX_CONST64(0x0000000100000001)
+  };
+
+  for (unsigned n=0; n < 2; n++) {
+    Bit64u r = rnd();
+    switch (r & 3) {
+      case 0:
+        op->xmm64u(n) = edge[(r >> 2) & 7];
+        break;
+      case 1:
+        op->xmm64u(n) = rnd() & BX_CONST64(0x0303030303030303);
+        break;
+      default:
+        op->xmm64u(n) = rnd();
+    }
+  }
+
+  // mix in single edge bytes as well
+  if (rnd() & 1)
+    op->xmmubyte(rnd() & 15) = (rnd() & 1) ? 0x80 : 0x7f;
+}
+
+static Bit64u random_shift(void)
+{
+  Bit64u r = rnd();
+  switch (r & 3) {
+    case 0:  return (r >> 2) % 72;      // around the lane widths
+    case 1:  return r >> 2;             // huge counts
+    default: return (r >> 2) & 0x3f;
+  }
+}
+
+static int failures = 0;
+
+static void report(const char *name, unsigned mismatches, const BxPackedXmmRegister *in1,
+    const BxPackedXmmRegister *in2, Bit64u r, Bit64u h)
+{
+  if (mismatches) {
+    printf("%-14s MISMATCH (%u), first for %08x%08x%08x%08x %08x%08x%08x%08x: ref=%08x%08x host=%08x%08x\n",
+      name, mismatches,
+      in1->xmm32u(3), in1->xmm32u(2), in1->xmm32u(1), in1->xmm32u(0),
+      in2->xmm32u(3), in2->xmm32u(2), in2->xmm32u(1), in2->xmm32u(0),
+      (Bit32u)(r >> 32), (Bit32u) r, (Bit32u)(h >> 32), (Bit32u) h);
+    failures++;
+  }
+}
+
+// reported for mismatching register results
+static Bit64u xmm_hash(const BxPackedXmmRegister *op)
+{
+  return op->xmm64u(0) ^ (op->xmm64u(1) * BX_CONST64(0x100000001b3));
+}
+
+// every check remembers the first mismatching input
+#define CHECK_BEGIN \
+  BxPackedXmmRegister a, b, c, bad_a, bad_b; \
+  Bit64u bad_r = 0, bad_h = 0; \
+  unsigned mismatches = 0; \
+  bad_a.clear(); bad_b.clear(); c.clear(); \
+  for (unsigned iter=0; iter < ITERATIONS; iter++) { \
+    random_xmm(&a); random_xmm(&b); random_xmm(&c);
+
+#define CHECK_END(name, differ, rv, hv) \
+    if (differ) { \
+      if (! mismatches++) { bad_a = a; bad_b = b; bad_r = (rv); bad_h = (hv); } \
+    } \
+  } \
+  report(name, mismatches, &bad_a, &bad_b, bad_r, bad_h);
+
+#define CHECK_UNARY(op) { CHECK_BEGIN \
+    BxPackedXmmRegister r = a, h = a; \
+    ref::xmm_##op(&r); host::xmm_##op(&h); \
+    CHECK_END(#op, memcmp(&r, &h, sizeof(r)) != 0, xmm_hash(&r), xmm_hash(&h)) }
+
+#define CHECK_BINARY(op) { CHECK_BEGIN \
+    BxPackedXmmRegister r = a, h = a; \
+    ref::xmm_##op(&r, &b); host::xmm_##op(&h, &b); \
+    CHECK_END(#op, memcmp(&r, &h, sizeof(r)) != 0, xmm_hash(&r), xmm_hash(&h)) }
+
+#define CHECK_TERNARY(op) { CHECK_BEGIN \
+    BxPackedXmmRegister r = c, h = c; \
+    ref::xmm_##op(&r, &a, &b); host::xmm_##op(&h, &a, &b); \
+    CHECK_END(#op, memcmp(&r, &h, sizeof(r)) != 0, xmm_hash(&r), xmm_hash(&h)) }
+
+#define CHECK_MOVMSK(op) { CHECK_BEGIN \
+    Bit32u r = ref::xmm_##op(&a), h = host::xmm_##op(&a); \
+    CHECK_END(#op, r != h, r, h) }
+
+#define CHECK_SHIFT(op) { CHECK_BEGIN \
+    Bit64u count = random_shift(); b.xmm64u(0) = count; b.xmm64u(1) = 0; \
+    BxPackedXmmRegister r = a, h = a; \
+    ref::xmm_##op(&r, count); host::xmm_##op(&h, count); \
+    CHECK_END(#op, memcmp(&r, &h, sizeof(r)) != 0, xmm_hash(&r), xmm_hash(&h)) }
+
+#define CHECK_MASK(op) { CHECK_BEGIN \
+    Bit32u r = ref::xmm_##op(&a, &b), h = host::xmm_##op(&a, &b); \
+    CHECK_END(#op, r != h, r, h) }
+
+// micro-benchmark, the result is folded into a sink so the calls are kept
+
+static const unsigned BENCH_CALLS = 4000000;
+static volatile Bit64u sink;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#define BENCH_LOOP(ns, call, result) { \
+    BxPackedXmmRegister x, y, z; Bit64u acc = 0; \
+    random_xmm(&x); random_xmm(&y); random_xmm(&z); \
+    double start = now(); \
+    for (unsigned iter=0; iter < BENCH_CALLS; iter++) { \
+      call; acc += result; y.xmm64u(0) += acc; \
+    } \
+    sink = acc; \
+    ns = (now() - start) * 1e9 / BENCH_CALLS; \
+  }
+
+#define BENCH(op, ref_call, ref_result, host_call, host_result) { \
+    double ref_ns, host_ns; \
+    BENCH_LOOP(ref_ns, ref_call, ref_result) \
+    BENCH_LOOP(host_ns, host_call, host_result) \
+    printf("%-14s ref %6.2f ns  host %6.2f ns\n", #op, ref_ns, host_ns); \
+  }
+
+#define BENCH_UNARY(op) \
+  BENCH(op, ref::xmm_##op(&x), x.xmm64u(0), host::xmm_##op(&x), x.xmm64u(0))
+
+#define BENCH_BINARY(op) \
+  BENCH(op, ref::xmm_##op(&x, &y), x.xmm64u(0), host::xmm_##op(&x, &y), x.xmm64u(0))
+
+#define BENCH_TERNARY(op) \
+  BENCH(op, ref::xmm_##op(&z, &x, &y), z.xmm64u(0), host::xmm_##op(&z, &x, &y), z.xmm64u(0))
+
+#define BENCH_MOVMSK(op) \
+  BENCH(op, (void) 0, ref::xmm_##op(&y), (void) 0, host::xmm_##op(&y))
+
+#define BENCH_SHIFT(op) \
+  BENCH(op, ref::xmm_##op(&x, y.xmm64u(0) & 0x3f), x.xmm64u(0), \
+            host::xmm_##op(&x, y.xmm64u(0) & 0x3f), x.xmm64u(0))
+
+#define BENCH_MASK(op) \
+  BENCH(op, (void) 0, ref::xmm_##op(&x, &y), (void) 0, host::xmm_##op(&x, &y))
+
+int main(int argc, char *argv[])
+{
+  bx_bool bench = (argc > 1 && !strcmp(argv[1], "-b"));
+
+  printf("host forms: SSE2=%d SSSE3=%d SSE4.1=%d\n", BX_HOST_SSE2, BX_HOST_SSSE3, BX_HOST_SSE4_1);
+
+  UNARY_HELPERS(CHECK_UNARY)
+  BINARY_HELPERS(CHECK_BINARY)
+  TERNARY_HELPERS(CHECK_TERNARY)
+  MOVMSK_HELPERS(CHECK_MOVMSK)
+  SHIFT_HELPERS(CHECK_SHIFT)
+  MASK_HELPERS(CHECK_MASK)
+
+  printf("mismatches=%d\n", failures);
+
+  if (bench) {
+    UNARY_HELPERS(BENCH_UNARY)
+    BINARY_HELPERS(BENCH_BINARY)
+    TERNARY_HELPERS(BENCH_TERNARY)
+    MOVMSK_HELPERS(BENCH_MOVMSK)
+    SHIFT_HELPERS(BENCH_SHIFT)
+    MASK_HELPERS(BENCH_MASK)
+  }
+
+  return failures ? 1 : 0;
+}
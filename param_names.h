@@ -40,6 +40,9 @@
 #define BXPN_CPU_MODEL                   "cpu.model"
 #define BXPN_IPS                         "cpu.ips"
 #define BXPN_SMP_QUANTUM                 "cpu.quantum"
+#define BXPN_SMP_SCHED                   "cpu.smp_sched"
+#define BXPN_SMP_TIMESLICE               "cpu.timeslice"
+#define BXPN_ICACHE_SIZE                 "cpu.icache_size"
 #define BXPN_RESET_ON_TRIPLE_FAULT       "cpu.reset_on_triple_fault"
 #define BXPN_IGNORE_BAD_MSRS             "cpu.ignore_bad_msrs"
 #define BXPN_CONFIGURABLE_MSRS_PATH      "cpu.msrs"
@@ -80,6 +83,7 @@
 #define BXPN_CPUID_SMAP                  "cpuid.smap"
 #define BXPN_MEM_SIZE                    "memory.standard.ram.size"
 #define BXPN_HOST_MEM_SIZE               "memory.standard.ram.host_size"
+#define BXPN_MEM_RESTORE_MAP             "memory.standard.ram.restore_map"
 #define BXPN_ROMIMAGE                    "memory.standard.rom"
 #define BXPN_ROM_PATH                    "memory.standard.rom.file"
 #define BXPN_ROM_ADDRESS                 "memory.standard.rom.address"
@@ -54,13 +54,18 @@ bx_pc_system_c::bx_pc_system_c()
   timer[0].continuous = 1;
   timer[0].funct      = nullTimer;
   timer[0].this_ptr   = this;
+  timer[0].queuePos   = 0;
   numTimers = 1; // So far, only the nullTimer.
+
+  timerQueue[0] = 0;
+  timerQueueSize = 1;
 }
 
 void bx_pc_system_c::initialize(Bit32u ips)
 {
   ticksTotal = 0;
   timer[0].timeToFire = NullTimerInterval;
+  timerQueueRebuild();
   currCountdown       = NullTimerInterval;
   currCountdownPeriod = NullTimerInterval;
   lastTimeUsec = 0;
@@ -68,6 +73,7 @@ void bx_pc_system_c::initialize(Bit32u ips)
   triggeredTimer = 0;
   HRQ = 0;
   kill_bochs_request = 0;
+  cpu_yield_request = 0;
 
   // parameter 'ips' is the processor speed in Instructions-Per-Second
   m_ips = double(ips) / 1000000.0L;
@@ -212,6 +218,9 @@ void bx_pc_system_c::exit(void)
 {
   // delete all registered timers (exception: null timer and APIC timer)
   numTimers = 1 + BX_SUPPORT_APIC;
+  for (unsigned i = numTimers; i < BX_MAX_TIMERS; i++)
+    timer[i].active = 0;
+  timerQueueRebuild();
   bx_devices.exit();
   if (bx_gui) {
     bx_gui->cleanup();
@@ -245,6 +254,12 @@ void bx_pc_system_c::register_state(void)
   }
 }
 
+void bx_pc_system_c::after_restore_state(void)
+{
+  // the timer queue is not saved, rebuild it from the restored timers
+  timerQueueRebuild();
+}
+
 // ================================================
 // Bochs internal timer delivery framework features
 // ================================================
@@ -300,6 +315,7 @@ int bx_pc_system_c::register_timer_ticks(void* this_ptr, bx_timer_handler_t func
   timer[i].param      = 0;
 
   if (active) {
+    timerQueueInsert(i);
     if (ticks < Bit64u(currCountdown)) {
       // This new timer needs to fire before the current countdown.
       // Skew the current countdown and countdown period to be smaller
@@ -320,9 +336,8 @@ int bx_pc_system_c::register_timer_ticks(void* this_ptr, bx_timer_handler_t func
 
 void bx_pc_system_c::countdownEvent(void)
 {
-  unsigned i, first = numTimers, last = 0;
-  Bit64u   minTimeToFire;
-  bx_bool  triggered[BX_MAX_TIMERS];
+  unsigned i, n, numTriggered = 0;
+  unsigned triggered[BX_MAX_TIMERS];
 
   // The countdown decremented to 0.  We need to service all the active
   // timers, and invoke callbacks from those timers which have fired.
@@ -334,36 +349,30 @@ void bx_pc_system_c::countdownEvent(void)
   // Increment global ticks counter by number of ticks which have
   // elapsed since the last update.
   ticksTotal += Bit64u(currCountdownPeriod);
-  minTimeToFire = (Bit64u) -1;
 
-  for (i = 0; i < numTimers; i++) {
-    triggered[i] = 0; // Reset triggered flag.
-    if (timer[i].active) {
+  // All the timers ready to fire are at the top of the timer queue.
+  for (;;) {
+    i = timerQueue[0];
 #if BX_TIMER_DEBUG
-      if (ticksTotal > timer[i].timeToFire)
-        BX_PANIC(("countdownEvent: ticksTotal > timeToFire[%u], D " FMT_LL "u", i,
-                  timer[i].timeToFire-ticksTotal));
+    if (ticksTotal > timer[i].timeToFire)
+      BX_PANIC(("countdownEvent: ticksTotal > timeToFire[%u], D " FMT_LL "u", i,
+                timer[i].timeToFire-ticksTotal));
 #endif
-      if (ticksTotal == timer[i].timeToFire) {
-        // This timer is ready to fire.
-        triggered[i] = 1;
-
-        if (timer[i].continuous==0) {
-          // If triggered timer is one-shot, deactive.
-          timer[i].active = 0;
-        } else {
-          // Continuous timer, increment time-to-fire by period.
-          timer[i].timeToFire += timer[i].period;
-          if (timer[i].timeToFire < minTimeToFire)
-            minTimeToFire = timer[i].timeToFire;
-        }
-        if (i < first) first = i;
-        last = i;
-      } else {
-        // This timer is not ready to fire yet.
-        if (timer[i].timeToFire < minTimeToFire)
-          minTimeToFire = timer[i].timeToFire;
-      }
+    if (ticksTotal != timer[i].timeToFire) break;
+
+    // Callbacks are invoked in order of timer index.
+    for (n = numTriggered++; n > 0 && triggered[n-1] > i; n--)
+      triggered[n] = triggered[n-1];
+    triggered[n] = i;
+
+    if (timer[i].continuous==0) {
+      // If triggered timer is one-shot, deactive.
+      timer[i].active = 0;
+      timerQueueRemove(i);
+    } else {
+      // Continuous timer, increment time-to-fire by period.
+      timer[i].timeToFire += timer[i].period;
+      timerQueueSiftDown(0);
     }
   }
 
@@ -371,12 +380,13 @@ void bx_pc_system_c::countdownEvent(void)
   // any of the callbacks, as they may call timer features, which need
   // to be advanced to the next countdown cycle.
   currCountdown = currCountdownPeriod =
-      Bit32u(minTimeToFire - ticksTotal);
+      Bit32u(timer[timerQueue[0]].timeToFire - ticksTotal);
 
-  for (i = first; i <= last; i++) {
+  for (n = 0; n < numTriggered; n++) {
     // Call requested timer function.  It may request a different
     // timer period or deactivate etc.
-    if (triggered[i] && (timer[i].funct != NULL)) {
+    i = triggered[n];
+    if (timer[i].funct != NULL) {
       triggeredTimer = i;
       timer[i].funct(timer[i].this_ptr);
       triggeredTimer = 0;
@@ -384,6 +394,79 @@ void bx_pc_system_c::countdownEvent(void)
   }
 }
 
+void bx_pc_system_c::timerQueueSiftUp(unsigned pos)
+{
+  unsigned i = timerQueue[pos];
+
+  while (pos > 0) {
+    unsigned parent = (pos - 1) >> 1;
+    if (timer[timerQueue[parent]].timeToFire <= timer[i].timeToFire) break;
+    timerQueue[pos] = timerQueue[parent];
+    timer[timerQueue[pos]].queuePos = pos;
+    pos = parent;
+  }
+
+  timerQueue[pos] = i;
+  timer[i].queuePos = pos;
+}
+
+void bx_pc_system_c::timerQueueSiftDown(unsigned pos)
+{
+  unsigned i = timerQueue[pos];
+
+  for (;;) {
+    unsigned child = 2*pos + 1;
+    if (child >= timerQueueSize) break;
+    if (child + 1 < timerQueueSize &&
+        timer[timerQueue[child+1]].timeToFire < timer[timerQueue[child]].timeToFire)
+      child++;
+    if (timer[i].timeToFire <= timer[timerQueue[child]].timeToFire) break;
+    timerQueue[pos] = timerQueue[child];
+    timer[timerQueue[pos]].queuePos = pos;
+    pos = child;
+  }
+
+  timerQueue[pos] = i;
+  timer[i].queuePos = pos;
+}
+
+void bx_pc_system_c::timerQueueInsert(unsigned i)
+{
+  timerQueue[timerQueueSize] = i;
+  timerQueueSiftUp(timerQueueSize++);
+}
+
+void bx_pc_system_c::timerQueueRemove(unsigned i)
+{
+  unsigned pos = timer[i].queuePos;
+
+  if (pos != --timerQueueSize) {
+    unsigned last = timerQueue[timerQueueSize];
+    timerQueue[pos] = last;
+    timer[last].queuePos = pos;
+    timerQueueUpdate(last);
+  }
+}
+
+// restore the heap order after timeToFire of an active timer was changed
+void bx_pc_system_c::timerQueueUpdate(unsigned i)
+{
+  unsigned pos = timer[i].queuePos;
+
+  timerQueueSiftUp(pos);
+  if (timer[i].queuePos == pos)
+    timerQueueSiftDown(pos);
+}
+
+void bx_pc_system_c::timerQueueRebuild(void)
+{
+  timerQueueSize = 0;
+  for (unsigned i = 0; i < numTimers; i++) {
+    if (timer[i].active)
+      timerQueueInsert(i);
+  }
+}
+
 void bx_pc_system_c::nullTimer(void* this_ptr)
 {
   // This function is always inserted in timer[0].  It is sort of
@@ -492,9 +575,16 @@ void bx_pc_system_c::activate_timer_ticks(unsigned i, Bit64u ticks, bx_bool cont
 
   timer[i].period = ticks;
   timer[i].timeToFire = (ticksTotal + Bit64u(currCountdownPeriod-currCountdown)) + ticks;
-  timer[i].active     = 1;
   timer[i].continuous = continuous;
 
+  if (timer[i].active) {
+    timerQueueUpdate(i);
+  }
+  else {
+    timer[i].active = 1;
+    timerQueueInsert(i);
+  }
+
   if (ticks < Bit64u(currCountdown)) {
     // This new timer needs to fire before the current countdown.
     // Skew the current countdown and countdown period to be smaller
@@ -568,7 +658,10 @@ void bx_pc_system_c::deactivate_timer(unsigned i)
     BX_PANIC(("deactivate_timer: timer 0 is the nullTimer!"));
 #endif
 
-  timer[i].active = 0;
+  if (timer[i].active) {
+    timer[i].active = 0;
+    timerQueueRemove(i);
+  }
 }
 
 bx_bool bx_pc_system_c::unregisterTimer(unsigned timerIndex)
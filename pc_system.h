@@ -54,8 +54,15 @@ private:
 #define BxMaxTimerIDLen 32
     char id[BxMaxTimerIDLen];  // String ID of timer.
     Bit32u param;              // Device-specific value assigned to timer (optional)
+    unsigned queuePos;         // Position in timerQueue when active.
   } timer[BX_MAX_TIMERS];
 
+  // Active timers kept as binary min-heap ordered by timeToFire, the timer
+  // to fire next is always timerQueue[0].  The null timer is never
+  // deactivated so the queue is never empty.
+  unsigned   timerQueue[BX_MAX_TIMERS];
+  unsigned   timerQueueSize;
+
   unsigned   numTimers;  // Number of currently allocated timers.
   unsigned   triggeredTimer;  // ID of the actually triggered timer.
   Bit32u     currCountdown; // Current countdown ticks value (decrements to 0).
@@ -82,6 +89,13 @@ private:
   // ticks finds that an event has occurred.
   void   countdownEvent(void);
 
+  void   timerQueueSiftUp(unsigned pos);
+  void   timerQueueSiftDown(unsigned pos);
+  void   timerQueueInsert(unsigned timerIndex);
+  void   timerQueueRemove(unsigned timerIndex);
+  void   timerQueueUpdate(unsigned timerIndex);
+  void   timerQueueRebuild(void);
+
 public:
 
   // ==============================
@@ -167,6 +181,11 @@ public:
 
   volatile bx_bool kill_bochs_request;
 
+  // set by I/O, MMIO and IPI accesses which other processors may observe,
+  // ends the time slice of the running CPU in adaptive SMP scheduling
+  bx_bool cpu_yield_request;
+  BX_CPP_INLINE void request_cpu_yield(void) { cpu_yield_request = 1; }
+
   void set_HRQ(bx_bool val);  // set the Hold ReQuest line
 
   void raise_INTR(void);
@@ -186,6 +205,7 @@ public:
   void    invlpg(bx_address addr);    // flush TLB page in all CPUs
   void    exit(void);
   void    register_state(void);
+  void    after_restore_state(void);
 };
 
 #endif